@@ -32,6 +32,8 @@
 
 #include <ota-provider-common/BdxOtaSender.h>
 #include <ota-provider-common/OTAProviderExample.h>
+#include <ota-provider-common/OtaImageCache.h>
+#include <protocols/bdx/BdxSenderPool.h>
 
 #include <fstream>
 #include <iostream>
@@ -49,14 +51,21 @@ using chip::Messaging::ExchangeManager;
 // TODO: this should probably be done dynamically
 constexpr chip::EndpointId kOtaProviderEndpoint = 0;
 
-constexpr uint16_t kOptionFilepath             = 'f';
-constexpr uint16_t kOptionQueryImageBehavior   = 'q';
-constexpr uint16_t kOptionDelayedActionTimeSec = 'd';
+constexpr uint16_t kOptionFilepath                     = 'f';
+constexpr uint16_t kOptionQueryImageBehavior           = 'q';
+constexpr uint16_t kOptionDelayedActionTimeSec         = 'd';
+constexpr uint16_t kOptionMaxBytesPerSecond            = 'b';
+constexpr uint16_t kOptionMinBytesPerSecondPerTransfer = 'm';
 
 // Global variables used for passing the CLI arguments to the OTAProviderExample object
 OTAProviderExample::QueryImageBehaviorType gQueryImageBehavior = OTAProviderExample::kRespondWithUpdateAvailable;
 uint32_t gDelayedActionTimeSec                                 = 0;
 const char * gOtaFilepath                                      = nullptr;
+chip::bdx::SenderPoolParams gSenderPoolParams;
+
+// Serves the image to any number of Requestors at once, from a single mapping of the file
+OtaImageCache gOtaImageCache;
+chip::bdx::SenderPool gSenderPool;
 
 bool HandleOptions(const char * aProgram, OptionSet * aOptions, int aIdentifier, const char * aName, const char * aValue)
 {
@@ -102,6 +111,12 @@ bool HandleOptions(const char * aProgram, OptionSet * aOptions, int aIdentifier,
     case kOptionDelayedActionTimeSec:
         gDelayedActionTimeSec = static_cast<uint32_t>(strtol(aValue, NULL, 0));
         break;
+    case kOptionMaxBytesPerSecond:
+        gSenderPoolParams.maxBytesPerSecond = static_cast<uint32_t>(strtoul(aValue, NULL, 0));
+        break;
+    case kOptionMinBytesPerSecondPerTransfer:
+        gSenderPoolParams.minBytesPerSecondPerTransfer = static_cast<uint32_t>(strtoul(aValue, NULL, 0));
+        break;
     default:
         PrintArgError("%s: INTERNAL ERROR: Unhandled option: %s\n", aProgram, aName);
         retval = false;
@@ -115,6 +130,8 @@ OptionDef cmdLineOptionsDef[] = {
     { "filepath", chip::ArgParser::kArgumentRequired, kOptionFilepath },
     { "QueryImageBehavior", chip::ArgParser::kArgumentRequired, kOptionQueryImageBehavior },
     { "DelayedActionTimeSec", chip::ArgParser::kArgumentRequired, kOptionDelayedActionTimeSec },
+    { "MaxBytesPerSecond", chip::ArgParser::kArgumentRequired, kOptionMaxBytesPerSecond },
+    { "MinBytesPerSecondPerTransfer", chip::ArgParser::kArgumentRequired, kOptionMinBytesPerSecondPerTransfer },
     {},
 };
 
@@ -125,7 +142,12 @@ OptionSet cmdLineOptions = { HandleOptions, cmdLineOptionsDef, "PROGRAM OPTIONS"
                              "        Status value in the Query Image Response\n"
                              "  -d/--DelayedActionTimeSec <time>\n"
                              "        Value in seconds for the DelayedActionTime in the Query Image Response\n"
-                             "        and Apply Update Response\n" };
+                             "        and Apply Update Response\n"
+                             "  -b/--MaxBytesPerSecond <rate>\n"
+                             "        Bandwidth in bytes per second shared by all the image transfers\n"
+                             "  -m/--MinBytesPerSecondPerTransfer <rate>\n"
+                             "        Bandwidth in bytes per second each image transfer is guaranteed. Requestors\n"
+                             "        are answered Busy while another transfer would not get it\n" };
 
 HelpOptions helpOptions("ota-provider-app", "Usage: ota-provider-app [options]", "1.0");
 
@@ -159,22 +181,24 @@ int main(int argc, char * argv[])
     // Initialize device attestation config
     SetDeviceAttestationCredentialsProvider(chip::Credentials::Examples::GetExampleDACProvider());
 
-    BdxOtaSender * bdxOtaSender = otaProvider.GetBdxOtaSender();
-    VerifyOrReturnError(bdxOtaSender != nullptr, 1);
-    err = chip::Server::GetInstance().GetExchangeManager().RegisterUnsolicitedMessageHandlerForProtocol(chip::Protocols::BDX::Id,
-                                                                                                        bdxOtaSender);
+    err = gSenderPool.Init(&chip::DeviceLayer::SystemLayer(), &chip::Server::GetInstance().GetExchangeManager(), &gOtaImageCache,
+                           gSenderPoolParams);
     if (err != CHIP_NO_ERROR)
     {
-        ChipLogDetail(SoftwareUpdate, "RegisterUnsolicitedMessageHandler failed: %s", chip::ErrorStr(err));
+        ChipLogDetail(SoftwareUpdate, "SenderPool Init failed: %s", chip::ErrorStr(err));
         return 1;
     }
+    otaProvider.SetSenderPool(&gSenderPool);
 
     ChipLogDetail(SoftwareUpdate, "using OTA file: %s", gOtaFilepath ? gOtaFilepath : "(none)");
 
     if (gOtaFilepath != nullptr)
     {
         otaProvider.SetOTAFilePath(gOtaFilepath);
+        VerifyOrReturnError(gOtaImageCache.AddImage(gOtaFilepath) == CHIP_NO_ERROR, 1);
     }
+    ChipLogDetail(SoftwareUpdate, "serving up to %u transfers at once",
+                  static_cast<unsigned>(gSenderPool.GetTransferCapacity()));
 
     otaProvider.SetQueryImageBehavior(gQueryImageBehavior);
     otaProvider.SetDelayedActionTimeSec(gDelayedActionTimeSec);
@@ -24,8 +24,6 @@
 #include <messaging/Flags.h>
 #include <protocols/bdx/BdxTransferSession.h>
 
-#include <fstream>
-
 using chip::bdx::StatusCode;
 using chip::bdx::TransferControlFlags;
 using chip::bdx::TransferSession;
@@ -62,13 +60,14 @@ void BdxOtaSender::HandleTransferSessionOutput(TransferSession::OutputEvent & ev
         break;
     case TransferSession::OutputEventType::kMsgToSend: {
         chip::Messaging::SendFlags sendFlags;
-        if (!event.msgTypeData.HasMessageType(chip::Protocols::SecureChannel::MsgType::StatusReport))
+        VerifyOrReturn(mExchangeCtx != nullptr, ChipLogError(BDX, "%s: mExchangeCtx is null", __FUNCTION__));
+        if (!event.msgTypeData.HasMessageType(chip::Protocols::SecureChannel::MsgType::StatusReport) &&
+            !mExchangeCtx->IsResponseExpected())
         {
             // All messages sent from the Sender expect a response, except for a StatusReport which would indicate an error and the
-            // end of the transfer.
+            // end of the transfer. With a window of Blocks in flight, the exchange may already be waiting for the next one.
             sendFlags.Set(chip::Messaging::SendMessageFlags::kExpectResponse);
         }
-        VerifyOrReturn(mExchangeCtx != nullptr, ChipLogError(BDX, "%s: mExchangeCtx is null", __FUNCTION__));
         err = mExchangeCtx->SendMessage(event.msgTypeData.ProtocolId, event.msgTypeData.MessageType, std::move(event.MsgData),
                                         sendFlags);
         if (err != CHIP_NO_ERROR)
@@ -86,12 +85,30 @@ void BdxOtaSender::HandleTransferSessionOutput(TransferSession::OutputEvent & ev
         acceptData.MaxBlockSize = mTransfer.GetTransferBlockSize();
         acceptData.StartOffset  = mTransfer.GetStartOffset();
         acceptData.Length       = mTransfer.GetTransferLength();
-        VerifyOrReturn(mTransfer.AcceptTransfer(acceptData) == CHIP_NO_ERROR,
-                       ChipLogError(BDX, "%s: %s", __FUNCTION__, chip::ErrorStr(err)));
+
+        err = mOtaFile.Open(mFilepath);
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(BDX, "%s: cannot open %s: %s", __FUNCTION__, mFilepath, chip::ErrorStr(err));
+            mTransfer.AbortTransfer(StatusCode::kUnknown);
+            return;
+        }
+
+        // Keep several Blocks in flight if the Receiver asks for them. MRP only allows one unacknowledged message per exchange,
+        // so this is limited to sessions that do not use it.
+        VerifyOrReturn(mExchangeCtx != nullptr, ChipLogError(BDX, "%s: mExchangeCtx is null", __FUNCTION__));
+        if (!mExchangeCtx->GetSessionHandle()->RequireMRP())
+        {
+            mTransfer.SetWindowSize(CHIP_CONFIG_BDX_MAX_WINDOW_SIZE);
+        }
+
+        err = mTransfer.AcceptTransfer(acceptData);
+        VerifyOrReturn(err == CHIP_NO_ERROR, ChipLogError(BDX, "%s: %s", __FUNCTION__, chip::ErrorStr(err)));
         break;
     }
     case TransferSession::OutputEventType::kQueryReceived: {
         TransferSession::BlockData blockData;
+        chip::ByteSpan block;
         uint16_t blockSize   = mTransfer.GetTransferBlockSize();
         uint16_t bytesToRead = blockSize;
 
@@ -102,29 +119,27 @@ void BdxOtaSender::HandleTransferSessionOutput(TransferSession::OutputEvent & ev
             bytesToRead = static_cast<uint16_t>(mTransfer.GetTransferLength() - mNumBytesSent);
         }
 
-        chip::System::PacketBufferHandle blockBuf = chip::System::PacketBufferHandle::New(bytesToRead);
-        if (blockBuf.IsNull())
+        err = mOtaFile.ReadBlock(mNumBytesSent, bytesToRead, block);
+        if (err != CHIP_NO_ERROR)
         {
+            ChipLogError(BDX, "%s: file read failed: %s", __FUNCTION__, chip::ErrorStr(err));
             // TODO: AbortTransfer() needs to support GeneralStatusCode failures as well as BDX specific errors.
             mTransfer.AbortTransfer(StatusCode::kUnknown);
             return;
         }
 
-        std::ifstream otaFile(mFilepath, std::ifstream::in);
-        VerifyOrReturn(otaFile.good(), ChipLogError(BDX, "%s: file read failed", __FUNCTION__));
-        otaFile.seekg(mNumBytesSent);
-        otaFile.read(reinterpret_cast<char *>(blockBuf->Start()), bytesToRead);
-        VerifyOrReturn(otaFile.good() || otaFile.eof(), ChipLogError(BDX, "%s: file read failed", __FUNCTION__));
+        // Start loading the Blocks the Receiver will query next while this one is being sent.
+        mOtaFile.Prefetch(mNumBytesSent + block.size(), static_cast<uint64_t>(mTransfer.GetWindowSize()) * blockSize);
 
-        blockData.Data   = blockBuf->Start();
-        blockData.Length = static_cast<size_t>(otaFile.gcount());
+        blockData.Data   = block.data();
+        blockData.Length = block.size();
         blockData.IsEof  = (blockData.Length < blockSize) ||
-            (mNumBytesSent + static_cast<uint64_t>(blockData.Length) == mTransfer.GetTransferLength() || (otaFile.peek() == EOF));
+            (mNumBytesSent + static_cast<uint64_t>(blockData.Length) == mTransfer.GetTransferLength()) ||
+            (mNumBytesSent + static_cast<uint64_t>(blockData.Length) == mOtaFile.GetLength());
         mNumBytesSent = static_cast<uint32_t>(mNumBytesSent + blockData.Length);
-        otaFile.close();
 
-        VerifyOrReturn(CHIP_NO_ERROR == mTransfer.PrepareBlock(blockData),
-                       ChipLogError(BDX, "%s: PrepareBlock failed: %s", __FUNCTION__, chip::ErrorStr(err)));
+        err = mTransfer.PrepareBlock(blockData);
+        VerifyOrReturn(err == CHIP_NO_ERROR, ChipLogError(BDX, "%s: PrepareBlock failed: %s", __FUNCTION__, chip::ErrorStr(err)));
         break;
     }
     case TransferSession::OutputEventType::kAckReceived:
@@ -161,6 +176,7 @@ void BdxOtaSender::Reset()
         mExchangeCtx->Close();
     }
 
+    mOtaFile.Close();
     mNumBytesSent = 0;
     memset(mFilepath, 0, kFilepathMaxLength);
 }
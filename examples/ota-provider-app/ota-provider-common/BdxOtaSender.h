@@ -15,6 +15,7 @@
  *    limitations under the License.
  */
 
+#include <ota-provider-common/MappedFileBlockSource.h>
 #include <protocols/bdx/BdxTransferSession.h>
 #include <protocols/bdx/TransferFacilitator.h>
 
@@ -36,5 +37,6 @@ private:
     static constexpr size_t kFilepathMaxLength = 256;
     char mFilepath[kFilepathMaxLength];
 
+    MappedFileBlockSource mOtaFile;
     uint32_t mNumBytesSent = 0;
 };
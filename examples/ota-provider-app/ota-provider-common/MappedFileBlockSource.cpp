@@ -0,0 +1,101 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <ota-provider-common/MappedFileBlockSource.h>
+
+#include <lib/support/CodeUtils.h>
+#include <system/SystemError.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+CHIP_ERROR MappedFileBlockSource::Open(const char * path)
+{
+    struct stat fileStat;
+
+    VerifyOrReturnError(path != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    Close();
+
+    mFd = open(path, O_RDONLY | O_CLOEXEC);
+    VerifyOrReturnError(mFd >= 0, CHIP_ERROR_POSIX(errno));
+
+    if (fstat(mFd, &fileStat) != 0)
+    {
+        CHIP_ERROR err = CHIP_ERROR_POSIX(errno);
+        Close();
+        return err;
+    }
+    mLength = static_cast<uint64_t>(fileStat.st_size);
+
+    // mmap() refuses empty mappings; an empty file is read without one.
+    if (mLength > 0)
+    {
+        void * data = mmap(nullptr, static_cast<size_t>(mLength), PROT_READ, MAP_PRIVATE, mFd, 0);
+        if (data == MAP_FAILED)
+        {
+            CHIP_ERROR err = CHIP_ERROR_POSIX(errno);
+            Close();
+            return err;
+        }
+        mData = static_cast<uint8_t *>(data);
+
+        // Blocks are read in order, which lets the kernel read ahead more aggressively.
+        madvise(mData, static_cast<size_t>(mLength), MADV_SEQUENTIAL);
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+void MappedFileBlockSource::Close()
+{
+    if (mData != nullptr)
+    {
+        munmap(mData, static_cast<size_t>(mLength));
+        mData = nullptr;
+    }
+    if (mFd >= 0)
+    {
+        close(mFd);
+        mFd = -1;
+    }
+    mLength = 0;
+}
+
+CHIP_ERROR MappedFileBlockSource::ReadBlock(uint64_t offset, size_t maxLength, chip::ByteSpan & block)
+{
+    VerifyOrReturnError(IsOpen(), CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(offset <= mLength, CHIP_ERROR_INVALID_ARGUMENT);
+
+    const uint64_t remaining = mLength - offset;
+    block                    = chip::ByteSpan(mData + offset, (remaining < maxLength) ? static_cast<size_t>(remaining) : maxLength);
+    return CHIP_NO_ERROR;
+}
+
+void MappedFileBlockSource::Prefetch(uint64_t offset, uint64_t length)
+{
+    VerifyOrReturn(mData != nullptr && offset < mLength);
+
+    // madvise() takes a page-aligned address.
+    const uint64_t pageSize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    const uint64_t start    = offset - (offset % pageSize);
+    const uint64_t end      = (length < mLength - offset) ? offset + length : mLength;
+
+    madvise(mData + start, static_cast<size_t>(end - start), MADV_WILLNEED);
+}
@@ -0,0 +1,44 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <protocols/bdx/BdxBlockSource.h>
+
+#pragma once
+
+/**
+ * A BlockSource over a file mapped into memory. Blocks are read straight from the mapping, and Prefetch() asks the kernel to
+ * read the next pages ahead, so that reading a Block does not wait for the disk.
+ */
+class MappedFileBlockSource : public chip::bdx::BlockSource
+{
+public:
+    ~MappedFileBlockSource() override { Close(); }
+
+    CHIP_ERROR Open(const char * path);
+    void Close();
+    bool IsOpen() const { return mFd >= 0; }
+
+    // Inherited from bdx::BlockSource
+    uint64_t GetLength() const override { return mLength; }
+    CHIP_ERROR ReadBlock(uint64_t offset, size_t maxLength, chip::ByteSpan & block) override;
+    void Prefetch(uint64_t offset, uint64_t length) override;
+
+private:
+    int mFd          = -1;
+    uint8_t * mData  = nullptr;
+    uint64_t mLength = 0;
+};
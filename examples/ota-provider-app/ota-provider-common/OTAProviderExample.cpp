@@ -26,6 +26,7 @@
 #include <crypto/RandUtils.h>
 #include <lib/core/CHIPTLV.h>
 #include <lib/support/CHIPMemString.h>
+#include <protocols/bdx/BdxSenderPool.h>
 #include <protocols/bdx/BdxUri.h>
 
 #include <string.h>
@@ -54,6 +55,9 @@ constexpr uint32_t kMaxBdxBlockSize                 = 1024;
 constexpr chip::System::Clock::Timeout kBdxTimeout  = chip::System::Clock::Seconds16(5 * 60); // OTA Spec mandates >= 5 minutes
 constexpr chip::System::Clock::Timeout kBdxPollFreq = chip::System::Clock::Milliseconds32(500);
 
+// How long a Requestor is asked to wait before querying again while all the transfer slots are taken.
+constexpr uint32_t kBusyDelayedActionTimeSec = 120;
+
 void GetUpdateTokenString(const chip::ByteSpan & token, char * buf, size_t bufSize)
 {
     const uint8_t * tokenData = static_cast<const uint8_t *>(token.data());
@@ -125,10 +129,27 @@ EmberAfStatus OTAProviderExample::HandleQueryImage(chip::app::CommandHandler * c
     }
 
     // Set Status for the Query Image Response
+    uint32_t delayedActionTimeSec = mDelayedActionTimeSec;
+
     switch (mQueryImageBehavior)
     {
     case kRespondWithUpdateAvailable: {
-        if (strlen(mOTAFilePath) != 0)
+        if (strlen(mOTAFilePath) != 0 && mSenderPool != nullptr)
+        {
+            // The transfer itself is set up by the pool once the Requestor asks for it.
+            if (mSenderPool->CanAdmitTransfer())
+            {
+                queryStatus = OTAQueryStatus::kUpdateAvailable;
+            }
+            else
+            {
+                ChipLogProgress(SoftwareUpdate, "All %u transfer slots are taken, responding Busy",
+                                static_cast<unsigned>(mSenderPool->GetTransferCapacity()));
+                queryStatus          = OTAQueryStatus::kBusy;
+                delayedActionTimeSec = chip::max(delayedActionTimeSec, kBusyDelayedActionTimeSec);
+            }
+        }
+        else if (strlen(mOTAFilePath) != 0)
         {
             queryStatus = OTAQueryStatus::kUpdateAvailable;
 
@@ -165,7 +186,7 @@ EmberAfStatus OTAProviderExample::HandleQueryImage(chip::app::CommandHandler * c
 
     QueryImageResponse::Type response;
     response.status = queryStatus;
-    response.delayedActionTime.Emplace(mDelayedActionTimeSec);
+    response.delayedActionTime.Emplace(delayedActionTimeSec);
     response.imageURI.Emplace(chip::CharSpan(uriBuf, strlen(uriBuf)));
     response.softwareVersion.Emplace(newSoftwareVersion);
     response.softwareVersionString.Emplace(chip::CharSpan(kExampleSoftwareString, strlen(kExampleSoftwareString)));
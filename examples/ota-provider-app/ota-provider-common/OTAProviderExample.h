@@ -22,6 +22,12 @@
 #include <app/clusters/ota-provider/ota-provider-delegate.h>
 #include <ota-provider-common/BdxOtaSender.h>
 
+namespace chip {
+namespace bdx {
+class SenderPool;
+} // namespace bdx
+} // namespace chip
+
 /**
  * A reference implementation for an OTA Provider. Includes a method for providing a path to a local OTA file to serve.
  */
@@ -33,6 +39,12 @@ public:
     void SetOTAFilePath(const char * path);
     BdxOtaSender * GetBdxOtaSender() { return &mBdxOtaSender; }
 
+    /**
+     * Serve the image transfers from pool instead of the single BdxOtaSender. Requestors are then told to retry later while the
+     * pool has no room for another transfer.
+     */
+    void SetSenderPool(chip::bdx::SenderPool * pool) { mSenderPool = pool; }
+
     // Inherited from OTAProviderDelegate
     EmberAfStatus HandleQueryImage(
         chip::app::CommandHandler * commandObj, const chip::app::ConcreteCommandPath & commandPath,
@@ -55,6 +67,7 @@ public:
 
 private:
     BdxOtaSender mBdxOtaSender;
+    chip::bdx::SenderPool * mSenderPool = nullptr;
     static constexpr size_t kFilepathBufLen = 256;
     char mOTAFilePath[kFilepathBufLen]; // null-terminated
     QueryImageBehaviorType mQueryImageBehavior;
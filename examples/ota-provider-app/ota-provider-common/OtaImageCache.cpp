@@ -0,0 +1,82 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <ota-provider-common/OtaImageCache.h>
+
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+#include <string.h>
+
+using chip::ByteSpan;
+using chip::bdx::BlockSource;
+
+CHIP_ERROR OtaImageCache::AddImage(const char * path)
+{
+    VerifyOrReturnError(path != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(mNumImages < kMaxImages, CHIP_ERROR_NO_MEMORY);
+
+    mImages[mNumImages++].path = path;
+    return CHIP_NO_ERROR;
+}
+
+OtaImageCache::Image * OtaImageCache::FindImage(ByteSpan fileDesignator)
+{
+    VerifyOrReturnError(mNumImages > 0, nullptr);
+
+    for (size_t i = 0; i < mNumImages; i++)
+    {
+        if (fileDesignator.data_equal(ByteSpan(chip::Uint8::from_const_char(mImages[i].path), strlen(mImages[i].path))))
+        {
+            return &mImages[i];
+        }
+    }
+
+    // Requestors are not required to send the designator of the image URI back.
+    return &mImages[0];
+}
+
+BlockSource * OtaImageCache::AcquireBlockSource(ByteSpan fileDesignator)
+{
+    Image * image = FindImage(fileDesignator);
+    VerifyOrReturnError(image != nullptr, nullptr);
+
+    if (image->refCount == 0)
+    {
+        CHIP_ERROR err = image->source.Open(image->path);
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(BDX, "%s: cannot open %s: %s", __FUNCTION__, image->path, chip::ErrorStr(err));
+            return nullptr;
+        }
+    }
+
+    image->refCount++;
+    return &image->source;
+}
+
+void OtaImageCache::ReleaseBlockSource(BlockSource * source)
+{
+    for (size_t i = 0; i < mNumImages; i++)
+    {
+        Image & image = mImages[i];
+        if (&image.source == source && image.refCount > 0 && --image.refCount == 0)
+        {
+            image.source.Close();
+        }
+    }
+}
@@ -0,0 +1,54 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <ota-provider-common/MappedFileBlockSource.h>
+#include <protocols/bdx/BdxSenderPool.h>
+
+#pragma once
+
+/**
+ * The OTA images served by a bdx::SenderPool. Each image is mapped into memory once, when the first transfer of it starts, and
+ * shared read-only by all the transfers of it until the last one ends.
+ */
+class OtaImageCache : public chip::bdx::SenderPool::Delegate
+{
+public:
+    static constexpr size_t kMaxImages = 4;
+
+    /**
+     * Serve the file at path, which must outlive the cache. Transfers are matched to an image by their file designator, and
+     * those with an unknown designator get the first image added.
+     */
+    CHIP_ERROR AddImage(const char * path);
+
+    // Inherited from bdx::SenderPool::Delegate
+    chip::bdx::BlockSource * AcquireBlockSource(chip::ByteSpan fileDesignator) override;
+    void ReleaseBlockSource(chip::bdx::BlockSource * source) override;
+
+private:
+    struct Image
+    {
+        const char * path = nullptr;
+        MappedFileBlockSource source;
+        uint32_t refCount = 0;
+    };
+
+    Image * FindImage(chip::ByteSpan fileDesignator);
+
+    Image mImages[kMaxImages];
+    size_t mNumImages = 0;
+};
@@ -35,7 +35,8 @@ int main(int argc, char * argv[])
     err = chip::Platform::MemoryInit();
     SuccessOrExit(err);
 
-    chip::DeviceLayer::PersistedStorage::KeyValueStoreMgrImpl().Init("/tmp/chip_example_kvs");
+    err = chip::DeviceLayer::PersistedStorage::KeyValueStoreMgrImpl().Init("/tmp/chip_example_kvs");
+    SuccessOrExit(err);
 
     printf("=============================================\n");
     printf("chip-linux-persitent-storage-example starting\n");
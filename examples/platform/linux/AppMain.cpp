@@ -37,6 +37,7 @@
 #include <lib/support/ScopedBuffer.h>
 #include <setup_payload/QRCodeSetupPayloadGenerator.h>
 #include <setup_payload/SetupPayload.h>
+#include <trace/trace.h>
 
 #if CHIP_DEVICE_CONFIG_ENABLE_BOTH_COMMISSIONER_AND_COMMISSIONEE
 #include <ControllerShellCommands.h>
@@ -88,6 +89,25 @@ void EventHandler(const chip::DeviceLayer::ChipDeviceEvent * event, intptr_t arg
         ChipLogProgress(DeviceLayer, "Receive kCHIPoBLEConnectionEstablished");
     }
 }
+
+#if CHIP_TRACE_BUILTIN_BACKEND
+void WriteTraceFile(const char * path)
+{
+    chip::trace::SetTraceEnabled(false);
+
+    FILE * file    = fopen(path, "w");
+    CHIP_ERROR err = chip::trace::ExportChromeTrace(file);
+    if (file != nullptr)
+    {
+        fclose(file);
+    }
+
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(NotSpecified, "Failed to write trace to %s: %" CHIP_ERROR_FORMAT, path, err.Format());
+    }
+}
+#endif // CHIP_TRACE_BUILTIN_BACKEND
 } // namespace
 
 #if CHIP_DEVICE_CONFIG_ENABLE_WPA
@@ -132,6 +152,13 @@ int ChipLinuxAppInit(int argc, char ** argv)
     err = ParseArguments(argc, argv);
     SuccessOrExit(err);
 
+#if CHIP_TRACE_BUILTIN_BACKEND
+    if (LinuxDeviceOptions::GetInstance().traceFile != nullptr)
+    {
+        chip::trace::SetTraceEnabled(true);
+    }
+#endif // CHIP_TRACE_BUILTIN_BACKEND
+
     ConfigurationMgr().LogDeviceConfig();
 
     PrintOnboardingCodes(LinuxDeviceOptions::GetInstance().payload);
@@ -438,6 +465,13 @@ void ChipLinuxAppMainLoop()
     ShutdownCommissioner();
 #endif // CHIP_DEVICE_CONFIG_ENABLE_BOTH_COMMISSIONER_AND_COMMISSIONEE
 
+#if CHIP_TRACE_BUILTIN_BACKEND
+    if (LinuxDeviceOptions::GetInstance().traceFile != nullptr)
+    {
+        WriteTraceFile(LinuxDeviceOptions::GetInstance().traceFile);
+    }
+#endif // CHIP_TRACE_BUILTIN_BACKEND
+
 #if defined(ENABLE_CHIP_SHELL)
     shellThread.join();
 #endif
@@ -47,7 +47,8 @@ enum
     kDeviceOption_SecuredCommissionerPort   = 0x100b,
     kDeviceOption_UnsecuredCommissionerPort = 0x100c,
     kDeviceOption_Command                   = 0x100d,
-    kDeviceOption_PICS                      = 0x100e
+    kDeviceOption_PICS                      = 0x100e,
+    kDeviceOption_TraceFile                 = 0x100f
 };
 
 constexpr unsigned kAppUsageLength = 64;
@@ -74,6 +75,9 @@ OptionDef sDeviceOptionDefs[] = {
     { "unsecured-commissioner-port", kArgumentRequired, kDeviceOption_UnsecuredCommissionerPort },
     { "command", kArgumentRequired, kDeviceOption_Command },
     { "PICS", kArgumentRequired, kDeviceOption_PICS },
+#if CHIP_TRACE_BUILTIN_BACKEND
+    { "trace-file", kArgumentRequired, kDeviceOption_TraceFile },
+#endif // CHIP_TRACE_BUILTIN_BACKEND
     {}
 };
 
@@ -129,6 +133,11 @@ const char * sDeviceOptionHelp =
     "\n"
     "  --PICS <filepath>\n"
     "       A file containing PICS items.\n"
+#if CHIP_TRACE_BUILTIN_BACKEND
+    "\n"
+    "  --trace-file <filepath>\n"
+    "       Record trace events, and write them to the given file in the Chrome trace event format on exit.\n"
+#endif // CHIP_TRACE_BUILTIN_BACKEND
     "\n";
 
 bool HandleOption(const char * aProgram, OptionSet * aOptions, int aIdentifier, const char * aName, const char * aValue)
@@ -213,6 +222,10 @@ bool HandleOption(const char * aProgram, OptionSet * aOptions, int aIdentifier,
         LinuxDeviceOptions::GetInstance().PICS = aValue;
         break;
 
+    case kDeviceOption_TraceFile:
+        LinuxDeviceOptions::GetInstance().traceFile = aValue;
+        break;
+
     default:
         PrintArgError("%s: INTERNAL ERROR: Unhandled option: %s\n", aProgram, aName);
         retval = false;
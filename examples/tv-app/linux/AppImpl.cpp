@@ -147,6 +147,9 @@ DECLARE_DYNAMIC_CLUSTER(ZCL_DESCRIPTOR_CLUSTER_ID, descriptorAttrs),
 // Declare Content App endpoint
 DECLARE_DYNAMIC_ENDPOINT(contentAppEndpoint, contentAppClusters);
 
+// Data versions of the clusters of each Content App endpoint
+DataVersion gDataVersions[APP_LIBRARY_SIZE][ArraySize(contentAppClusters)];
+
 ContentAppImpl::ContentAppImpl(const char * szVendorName, uint16_t vendorId, const char * szApplicationName, uint16_t productId,
                                const char * szApplicationVersion)
 {
@@ -230,7 +233,8 @@ ContentApp * ContentAppFactoryImpl::LoadContentAppByVendorId(uint16_t vendorId)
         ContentAppImpl app = mContentApps[i];
         if (app.GetApplicationBasic()->GetVendorId() == vendorId)
         {
-            AppPlatform::GetInstance().AddContentApp(&mContentApps[i], &contentAppEndpoint, DEVICE_TYPE_CONTENT_APP);
+            AppPlatform::GetInstance().AddContentApp(&mContentApps[i], &contentAppEndpoint, Span<DataVersion>(gDataVersions[i]),
+                                                     DEVICE_TYPE_CONTENT_APP);
             return &mContentApps[i];
         }
     }
@@ -253,7 +257,8 @@ ContentApp * ContentAppFactoryImpl::LoadContentAppByAppId(ApplicationLauncherApp
         ChipLogProgress(DeviceLayer, " Looking next=%s ", app.GetApplicationBasic()->GetApplicationName());
         if (strcmp(app.GetApplicationBasic()->GetApplicationName(), appId.c_str()) == 0)
         {
-            AppPlatform::GetInstance().AddContentApp(&mContentApps[i], &contentAppEndpoint, DEVICE_TYPE_CONTENT_APP);
+            AppPlatform::GetInstance().AddContentApp(&mContentApps[i], &contentAppEndpoint, Span<DataVersion>(gDataVersions[i]),
+                                                     DEVICE_TYPE_CONTENT_APP);
             return &mContentApps[i];
         }
     }
@@ -18,6 +18,11 @@
 
 #include "AccessControl.h"
 
+#include <lib/support/TypeTraits.h>
+
+#include <algorithm>
+#include <string.h>
+
 namespace {
 
 using chip::CATValues;
@@ -61,6 +66,44 @@ bool CheckRequestPrivilegeAgainstEntryPrivilege(Privilege requestPrivilege, Priv
     return false;
 }
 
+#if CHIP_CONFIG_ACCESS_CONTROL_CACHE
+constexpr Privilege kRequestPrivileges[] = { Privilege::kView, Privilege::kProxyView, Privilege::kOperate, Privilege::kManage,
+                                             Privilege::kAdminister };
+
+// Whether the subject, being of its type, may appear in an entry with the auth mode.
+bool IsValidSubject(NodeId subject, AuthMode authMode)
+{
+    if (chip::IsOperationalNodeId(subject))
+    {
+        return true;
+    }
+    if (chip::IsGroupId(subject))
+    {
+        return authMode == AuthMode::kGroup;
+    }
+    if (chip::IsPAKEKeyId(subject))
+    {
+        return authMode == AuthMode::kPase;
+    }
+    if (chip::IsCASEAuthTag(subject))
+    {
+        return authMode == AuthMode::kCase;
+    }
+    return false;
+}
+
+bool IsSameSubject(const SubjectDescriptor & a, const SubjectDescriptor & b)
+{
+    return a.fabricIndex == b.fabricIndex && a.authMode == b.authMode && a.subject == b.subject &&
+        memcmp(a.cats.values, b.cats.values, sizeof(a.cats.values)) == 0;
+}
+
+constexpr uint64_t EndpointBit(chip::EndpointId endpoint)
+{
+    return uint64_t(1) << (endpoint % 64);
+}
+#endif // CHIP_CONFIG_ACCESS_CONTROL_CACHE
+
 } // namespace
 
 namespace chip {
@@ -73,13 +116,22 @@ AccessControl::Delegate AccessControl::mDefaultDelegate;
 CHIP_ERROR AccessControl::Init()
 {
     ChipLogDetail(DataManagement, "AccessControl::Init");
+#if CHIP_CONFIG_ACCESS_CONTROL_CACHE
+    mEntryCache.Invalidate();
+    mEntryCache.Register(mDelegate);
+#endif // CHIP_CONFIG_ACCESS_CONTROL_CACHE
     return mDelegate.Init();
 }
 
 CHIP_ERROR AccessControl::Finish()
 {
     ChipLogDetail(DataManagement, "AccessControl::Finish");
-    return mDelegate.Finish();
+    CHIP_ERROR err = mDelegate.Finish();
+#if CHIP_CONFIG_ACCESS_CONTROL_CACHE
+    mEntryCache.Unregister(mDelegate);
+    mEntryCache.Invalidate();
+#endif // CHIP_CONFIG_ACCESS_CONTROL_CACHE
+    return err;
 }
 
 CHIP_ERROR AccessControl::Check(const SubjectDescriptor & subjectDescriptor, const RequestPath & requestPath,
@@ -88,6 +140,25 @@ CHIP_ERROR AccessControl::Check(const SubjectDescriptor & subjectDescriptor, con
     // During development, allow access if delegate is transitional
     ReturnErrorCodeIf(mDelegate.IsTransitional(), CHIP_NO_ERROR);
 
+#if CHIP_CONFIG_ACCESS_CONTROL_CACHE
+    if (mEntryCache.IsStale())
+    {
+        mEntryCache.Build(*this);
+    }
+
+    bool allow = false;
+    if (mEntryCache.Check(subjectDescriptor, requestPath, requestPrivilege, allow))
+    {
+        return allow ? CHIP_NO_ERROR : CHIP_ERROR_ACCESS_DENIED;
+    }
+#endif // CHIP_CONFIG_ACCESS_CONTROL_CACHE
+
+    return CheckEntries(subjectDescriptor, requestPath, requestPrivilege);
+}
+
+CHIP_ERROR AccessControl::CheckEntries(const SubjectDescriptor & subjectDescriptor, const RequestPath & requestPath,
+                                       Privilege requestPrivilege)
+{
     EntryIterator iterator;
     ReturnErrorOnFailure(Entries(iterator, &subjectDescriptor.fabricIndex));
 
@@ -199,6 +270,262 @@ CHIP_ERROR AccessControl::Check(const SubjectDescriptor & subjectDescriptor, con
     return CHIP_ERROR_ACCESS_DENIED;
 }
 
+#if CHIP_CONFIG_ACCESS_CONTROL_CACHE
+void AccessControl::EntryCache::Register(Delegate & delegate)
+{
+    Listener * listener = delegate.GetListener();
+    VerifyOrReturn(listener != this);
+
+    mNextListener = listener;
+    delegate.SetListener(*this);
+}
+
+void AccessControl::EntryCache::Unregister(Delegate & delegate)
+{
+    // Hand the delegate back to the listener we replaced, unless someone else replaced us in turn.
+    if (delegate.GetListener() == this)
+    {
+        if (mNextListener != nullptr)
+        {
+            delegate.SetListener(*mNextListener);
+        }
+        else
+        {
+            delegate.ClearListener();
+        }
+    }
+    mNextListener = nullptr;
+}
+
+void AccessControl::EntryCache::Build(const AccessControl & accessControl)
+{
+    mDecisionCount = 0;
+
+    CHIP_ERROR err = Compile(accessControl);
+    if (err == CHIP_NO_ERROR)
+    {
+        mState = State::kValid;
+    }
+    else if (err == CHIP_ERROR_NO_MEMORY || err == CHIP_ERROR_INVALID_ARGUMENT)
+    {
+        // Only a change to the entries can fix these.
+        ChipLogProgress(DataManagement, "AccessControl: checking entries uncached: %" CHIP_ERROR_FORMAT, err.Format());
+        mState = State::kUnavailable;
+    }
+    else
+    {
+        // Retry on the next check, e.g. once the delegate has entry delegates available again.
+        mState = State::kStale;
+    }
+}
+
+CHIP_ERROR AccessControl::EntryCache::Compile(const AccessControl & accessControl)
+{
+    mEntryCount   = 0;
+    mTargetCount  = 0;
+    mSubjectCount = 0;
+
+    EntryIterator iterator;
+    ReturnErrorOnFailure(accessControl.Entries(iterator));
+
+    Entry entry;
+    CHIP_ERROR err;
+    while ((err = iterator.Next(entry)) == CHIP_NO_ERROR)
+    {
+        ReturnErrorOnFailure(CompileEntry(entry));
+    }
+    VerifyOrReturnError(err == CHIP_ERROR_SENTINEL, err);
+
+    std::sort(mSubjects, mSubjects + mSubjectCount);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR AccessControl::EntryCache::CompileEntry(const Entry & entry)
+{
+    VerifyOrReturnError(mEntryCount < kMaxEntries, CHIP_ERROR_NO_MEMORY);
+    CompiledEntry & compiled = mEntries[mEntryCount];
+
+    SubjectKey key = { kUndefinedNodeId, kUndefinedFabricIndex, AuthMode::kNone, static_cast<uint16_t>(mEntryCount) };
+    ReturnErrorOnFailure(entry.GetFabricIndex(key.fabricIndex));
+    ReturnErrorOnFailure(entry.GetAuthMode(key.authMode));
+
+    Privilege privilege = Privilege::kView;
+    ReturnErrorOnFailure(entry.GetPrivilege(privilege));
+    compiled.privileges = 0;
+    for (Privilege requestPrivilege : kRequestPrivileges)
+    {
+        if (CheckRequestPrivilegeAgainstEntryPrivilege(requestPrivilege, privilege))
+        {
+            compiled.privileges = static_cast<uint8_t>(compiled.privileges | to_underlying(requestPrivilege));
+        }
+    }
+
+    size_t subjectCount = 0;
+    ReturnErrorOnFailure(entry.GetSubjectCount(subjectCount));
+    VerifyOrReturnError(std::max<size_t>(subjectCount, 1) <= kMaxSubjects - mSubjectCount, CHIP_ERROR_NO_MEMORY);
+    if (subjectCount == 0)
+    {
+        mSubjects[mSubjectCount++] = key;
+    }
+    for (size_t i = 0; i < subjectCount; ++i)
+    {
+        ReturnErrorOnFailure(entry.GetSubject(i, key.subject));
+        VerifyOrReturnError(IsValidSubject(key.subject, key.authMode), CHIP_ERROR_INVALID_ARGUMENT);
+        mSubjects[mSubjectCount++] = key;
+    }
+
+    size_t targetCount = 0;
+    ReturnErrorOnFailure(entry.GetTargetCount(targetCount));
+    VerifyOrReturnError(targetCount <= kMaxTargets - mTargetCount, CHIP_ERROR_NO_MEMORY);
+    compiled.firstTarget  = static_cast<uint16_t>(mTargetCount);
+    compiled.targetCount  = static_cast<uint16_t>(targetCount);
+    compiled.endpointMask = (targetCount == 0) ? UINT64_MAX : 0;
+    for (size_t i = 0; i < targetCount; ++i)
+    {
+        Entry::Target target;
+        ReturnErrorOnFailure(entry.GetTarget(i, target));
+
+        // Device types are not checked yet, so a target with only a device type matches any path.
+        CompiledTarget & compiledTarget = mTargets[mTargetCount++];
+        compiledTarget.flags            = 0;
+        compiledTarget.cluster          = 0;
+        compiledTarget.endpoint         = 0;
+        if (target.flags & Entry::Target::kCluster)
+        {
+            compiledTarget.flags   = static_cast<uint8_t>(compiledTarget.flags | Entry::Target::kCluster);
+            compiledTarget.cluster = target.cluster;
+        }
+        if (target.flags & Entry::Target::kEndpoint)
+        {
+            compiledTarget.flags    = static_cast<uint8_t>(compiledTarget.flags | Entry::Target::kEndpoint);
+            compiledTarget.endpoint = target.endpoint;
+            compiled.endpointMask |= EndpointBit(target.endpoint);
+        }
+        else
+        {
+            compiled.endpointMask = UINT64_MAX;
+        }
+    }
+
+    mEntryCount++;
+    return CHIP_NO_ERROR;
+}
+
+bool AccessControl::EntryCache::Check(const SubjectDescriptor & subjectDescriptor, const RequestPath & requestPath,
+                                      Privilege requestPrivilege, bool & allow)
+{
+    if (mState != State::kValid)
+    {
+        return false;
+    }
+
+    if (FindDecision(subjectDescriptor, requestPath, requestPrivilege, allow))
+    {
+        return true;
+    }
+
+    // Entries with no subjects.
+    SubjectKey first = { kUndefinedNodeId, subjectDescriptor.fabricIndex, subjectDescriptor.authMode, 0 };
+    allow            = CheckSubjects(first, first, subjectDescriptor, requestPath, requestPrivilege);
+
+    // Entries naming the subject itself. CAT subjects only ever match the descriptor's CATs.
+    if (!allow && subjectDescriptor.subject != kUndefinedNodeId && !IsCASEAuthTag(subjectDescriptor.subject))
+    {
+        first.subject = subjectDescriptor.subject;
+        allow         = CheckSubjects(first, first, subjectDescriptor, requestPath, requestPrivilege);
+    }
+
+    // Entries naming any CAT, which sort together.
+    if (!allow && subjectDescriptor.authMode == AuthMode::kCase && subjectDescriptor.cats.values[0] != kUndefinedCAT)
+    {
+        SubjectKey last = first;
+        first.subject   = kMinCASEAuthTag;
+        last.subject    = kMaxCASEAuthTag;
+        allow           = CheckSubjects(first, last, subjectDescriptor, requestPath, requestPrivilege);
+    }
+
+    AddDecision(subjectDescriptor, requestPath, requestPrivilege, allow);
+    return true;
+}
+
+bool AccessControl::EntryCache::CheckSubjects(const SubjectKey & first, const SubjectKey & last,
+                                              const SubjectDescriptor & subjectDescriptor, const RequestPath & requestPath,
+                                              Privilege requestPrivilege) const
+{
+    const SubjectKey * end = mSubjects + mSubjectCount;
+    for (const SubjectKey * key = std::lower_bound(mSubjects, end, first); key != end && !(last < *key); ++key)
+    {
+        if (IsCASEAuthTag(key->subject) && !subjectDescriptor.cats.CheckSubjectAgainstCATs(key->subject))
+        {
+            continue;
+        }
+        if (CheckEntry(mEntries[key->entry], requestPath, requestPrivilege))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool AccessControl::EntryCache::CheckEntry(const CompiledEntry & entry, const RequestPath & requestPath,
+                                           Privilege requestPrivilege) const
+{
+    if ((entry.privileges & to_underlying(requestPrivilege)) == 0 || (entry.endpointMask & EndpointBit(requestPath.endpoint)) == 0)
+    {
+        return false;
+    }
+    if (entry.targetCount == 0)
+    {
+        return true;
+    }
+
+    const CompiledTarget * target = mTargets + entry.firstTarget;
+    for (const CompiledTarget * end = target + entry.targetCount; target != end; ++target)
+    {
+        if ((target->flags & Entry::Target::kCluster) && target->cluster != requestPath.cluster)
+        {
+            continue;
+        }
+        if ((target->flags & Entry::Target::kEndpoint) && target->endpoint != requestPath.endpoint)
+        {
+            continue;
+        }
+        return true;
+    }
+    return false;
+}
+
+bool AccessControl::EntryCache::FindDecision(const SubjectDescriptor & subjectDescriptor, const RequestPath & requestPath,
+                                             Privilege requestPrivilege, bool & allow)
+{
+    for (size_t i = 0; i < mDecisionCount; ++i)
+    {
+        const Decision & decision = mDecisions[i];
+        if (decision.privilege == requestPrivilege && decision.requestPath.cluster == requestPath.cluster &&
+            decision.requestPath.endpoint == requestPath.endpoint && IsSameSubject(decision.subjectDescriptor, subjectDescriptor))
+        {
+            allow = decision.allow;
+            // Move the decision to the front.
+            std::rotate(mDecisions, mDecisions + i, mDecisions + i + 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void AccessControl::EntryCache::AddDecision(const SubjectDescriptor & subjectDescriptor, const RequestPath & requestPath,
+                                            Privilege requestPrivilege, bool allow)
+{
+    // Drop the least recently used decision if full.
+    if (mDecisionCount < kDecisionCacheSize)
+    {
+        mDecisionCount++;
+    }
+    std::move_backward(mDecisions, mDecisions + mDecisionCount - 1, mDecisions + mDecisionCount);
+    mDecisions[0] = { subjectDescriptor, requestPath, requestPrivilege, allow };
+}
+#endif // CHIP_CONFIG_ACCESS_CONTROL_CACHE
+
 AccessControl & GetAccessControl()
 {
     return *globalAccessControl;
@@ -339,9 +339,22 @@ public:
         virtual bool IsTransitional() const { return true; }
 
         // Listening
+        // A listener that replaces another one should keep the result of GetListener() and forward the callbacks to it.
+        virtual Listener * GetListener() const { return mListener; }
         virtual void SetListener(Listener & listener) { mListener = &listener; }
         virtual void ClearListener() { mListener = nullptr; }
 
+    protected:
+        // Delegates must call this whenever entries change other than through CreateEntry, UpdateEntry or DeleteEntry
+        // (e.g. when loaded from storage), since AccessControl caches a compiled copy of them.
+        void NotifyEntryChanged()
+        {
+            if (mListener != nullptr)
+            {
+                mListener->OnEntryChanged();
+            }
+        }
+
     private:
         Listener * mListener = nullptr;
     };
@@ -391,6 +404,7 @@ public:
      */
     CHIP_ERROR CreateEntry(size_t * index, const Entry & entry, FabricIndex * fabricIndex = nullptr)
     {
+        InvalidateCache();
         return mDelegate.CreateEntry(index, entry, fabricIndex);
     }
 
@@ -415,6 +429,7 @@ public:
      */
     CHIP_ERROR UpdateEntry(size_t index, const Entry & entry, const FabricIndex * fabricIndex = nullptr)
     {
+        InvalidateCache();
         return mDelegate.UpdateEntry(index, entry, fabricIndex);
     }
 
@@ -426,6 +441,7 @@ public:
      */
     CHIP_ERROR DeleteEntry(size_t index, const FabricIndex * fabricIndex = nullptr)
     {
+        InvalidateCache();
         return mDelegate.DeleteEntry(index, fabricIndex);
     }
 
@@ -451,8 +467,156 @@ public:
     CHIP_ERROR Check(const SubjectDescriptor & subjectDescriptor, const RequestPath & requestPath, Privilege requestPrivilege);
 
 private:
+#if CHIP_CONFIG_ACCESS_CONTROL_CACHE
+    /**
+     * Compiled copy of the access control list, and the most recent decisions made with it.
+     *
+     * The copy is rebuilt by the first check after the delegate reports a change. Subjects are indexed by fabric, auth
+     * mode and subject, so a check only visits the entries naming its subject, the entries with no subjects, and for CASE
+     * the entries naming a CAT. Each entry keeps its targets in a contiguous range and a bitmap of the endpoints (modulo
+     * 64) they can match.
+     *
+     * If the access control list does not fit, or has a subject that is invalid for its auth mode, the cache is
+     * unavailable until the next change and checks iterate the delegate's entries instead.
+     *
+     * The cache is registered as the delegate's listener, and forwards every callback to the listener it replaced.
+     */
+    class EntryCache : public Listener
+    {
+    public:
+        void OnEntryChanged() override
+        {
+            Invalidate();
+            if (mNextListener != nullptr)
+            {
+                mNextListener->OnEntryChanged();
+            }
+        }
+        void OnExtensionChanged() override
+        {
+            if (mNextListener != nullptr)
+            {
+                mNextListener->OnExtensionChanged();
+            }
+        }
+
+        void Register(Delegate & delegate);
+        void Unregister(Delegate & delegate);
+
+        void Invalidate() { mState = State::kStale; }
+
+        bool IsStale() const { return mState == State::kStale; }
+
+        void Build(const AccessControl & accessControl);
+
+        /**
+         * Check against the compiled entries.
+         *
+         * @retval false if the cache is unavailable.
+         * @retval true if checked, with @a allow set to the decision.
+         */
+        bool Check(const SubjectDescriptor & subjectDescriptor, const RequestPath & requestPath, Privilege requestPrivilege,
+                   bool & allow);
+
+    private:
+        static constexpr size_t kMaxEntries        = CHIP_CONFIG_ACCESS_CONTROL_CACHE_MAX_ENTRIES;
+        static constexpr size_t kMaxSubjects       = CHIP_CONFIG_ACCESS_CONTROL_CACHE_MAX_SUBJECTS;
+        static constexpr size_t kMaxTargets        = CHIP_CONFIG_ACCESS_CONTROL_CACHE_MAX_TARGETS;
+        static constexpr size_t kDecisionCacheSize = CHIP_CONFIG_ACCESS_CONTROL_DECISION_CACHE_SIZE;
+
+        static_assert(kMaxEntries <= UINT16_MAX && kMaxTargets <= UINT16_MAX, "Compiled indexes are 16 bits");
+
+        enum class State : uint8_t
+        {
+            kStale,
+            kValid,
+            kUnavailable,
+        };
+
+        struct CompiledEntry
+        {
+            uint64_t endpointMask;
+            uint16_t firstTarget;
+            uint16_t targetCount; // 0 if the entry matches any target
+            uint8_t privileges;   // Request privileges granted by the entry's privilege
+        };
+
+        struct CompiledTarget
+        {
+            ClusterId cluster;
+            EndpointId endpoint;
+            uint8_t flags;
+        };
+
+        // Sorted by fabric index, auth mode and subject; an entry with no subjects is indexed under kUndefinedNodeId.
+        struct SubjectKey
+        {
+            NodeId subject;
+            FabricIndex fabricIndex;
+            AuthMode authMode;
+            uint16_t entry;
+
+            bool operator<(const SubjectKey & other) const
+            {
+                if (fabricIndex != other.fabricIndex)
+                {
+                    return fabricIndex < other.fabricIndex;
+                }
+                if (authMode != other.authMode)
+                {
+                    return authMode < other.authMode;
+                }
+                return subject < other.subject;
+            }
+        };
+
+        struct Decision
+        {
+            SubjectDescriptor subjectDescriptor;
+            RequestPath requestPath;
+            Privilege privilege;
+            bool allow;
+        };
+
+        CHIP_ERROR Compile(const AccessControl & accessControl);
+        CHIP_ERROR CompileEntry(const Entry & entry);
+        bool CheckSubjects(const SubjectKey & first, const SubjectKey & last, const SubjectDescriptor & subjectDescriptor,
+                           const RequestPath & requestPath, Privilege requestPrivilege) const;
+        bool CheckEntry(const CompiledEntry & entry, const RequestPath & requestPath, Privilege requestPrivilege) const;
+        bool FindDecision(const SubjectDescriptor & subjectDescriptor, const RequestPath & requestPath, Privilege requestPrivilege,
+                          bool & allow);
+        void AddDecision(const SubjectDescriptor & subjectDescriptor, const RequestPath & requestPath, Privilege requestPrivilege,
+                         bool allow);
+
+        CompiledEntry mEntries[kMaxEntries];
+        CompiledTarget mTargets[kMaxTargets];
+        SubjectKey mSubjects[kMaxSubjects];
+        size_t mEntryCount   = 0;
+        size_t mTargetCount  = 0;
+        size_t mSubjectCount = 0;
+
+        // Most recently used first.
+        Decision mDecisions[kDecisionCacheSize];
+        size_t mDecisionCount = 0;
+
+        Listener * mNextListener = nullptr;
+        State mState             = State::kStale;
+    };
+
+    void InvalidateCache() { mEntryCache.Invalidate(); }
+#else
+    void InvalidateCache() {}
+#endif // CHIP_CONFIG_ACCESS_CONTROL_CACHE
+
+    CHIP_ERROR CheckEntries(const SubjectDescriptor & subjectDescriptor, const RequestPath & requestPath,
+                            Privilege requestPrivilege);
+
     static Delegate mDefaultDelegate;
     Delegate & mDelegate = mDefaultDelegate;
+
+#if CHIP_CONFIG_ACCESS_CONTROL_CACHE
+    EntryCache mEntryCache;
+#endif // CHIP_CONFIG_ACCESS_CONTROL_CACHE
 };
 
 /**
@@ -959,6 +959,7 @@ public:
                 storage.Clear();
             }
         }
+        NotifyEntryChanged();
         return err;
     }
 
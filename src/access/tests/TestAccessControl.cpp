@@ -21,9 +21,13 @@
 
 #include <lib/core/CHIPCore.h>
 #include <lib/support/UnitTestRegistration.h>
+#include <system/SystemClock.h>
 
 #include <nlunit-test.h>
 
+#include <algorithm>
+#include <stdio.h>
+
 namespace {
 
 using namespace chip;
@@ -658,6 +662,162 @@ void TestCheck(nlTestSuite * inSuite, void * inContext)
     }
 }
 
+void TestCheckAfterChange(nlTestSuite * inSuite, void * inContext)
+{
+    const CheckData & checkData = checkData1[0];
+    auto check = [&]() { return accessControl.Check(checkData.subjectDescriptor, checkData.requestPath, checkData.privilege); };
+
+    NL_TEST_ASSERT(inSuite, check() == CHIP_ERROR_ACCESS_DENIED);
+    NL_TEST_ASSERT(inSuite, LoadAccessControl(accessControl, entryData1, entryData1Count) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, check() == CHIP_NO_ERROR);
+
+    // Decisions repeat while the entries are unchanged.
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        for (const auto & data : checkData1)
+        {
+            CHIP_ERROR expectedResult = data.allow ? CHIP_NO_ERROR : CHIP_ERROR_ACCESS_DENIED;
+            NL_TEST_ASSERT(inSuite,
+                           accessControl.Check(data.subjectDescriptor, data.requestPath, data.privilege) == expectedResult);
+        }
+    }
+
+    // Changing the privilege of entry 0 takes effect on the next check. Entries are released before checking, since
+    // the example delegate only has one entry delegate.
+    for (Privilege privilege : { Privilege::kManage, Privilege::kAdminister })
+    {
+        {
+            Entry entry;
+            NL_TEST_ASSERT(inSuite, accessControl.ReadEntry(0, entry) == CHIP_NO_ERROR);
+            NL_TEST_ASSERT(inSuite, entry.SetPrivilege(privilege) == CHIP_NO_ERROR);
+            NL_TEST_ASSERT(inSuite, accessControl.UpdateEntry(0, entry) == CHIP_NO_ERROR);
+        }
+        NL_TEST_ASSERT(inSuite, check() == (privilege == Privilege::kAdminister ? CHIP_NO_ERROR : CHIP_ERROR_ACCESS_DENIED));
+    }
+
+    NL_TEST_ASSERT(inSuite, accessControl.DeleteEntry(0) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, check() == CHIP_ERROR_ACCESS_DENIED);
+}
+
+class CountingListener : public AccessControl::Listener
+{
+public:
+    void OnEntryChanged() override { mEntryChanged++; }
+    void OnExtensionChanged() override {}
+
+    int mEntryChanged = 0;
+};
+
+void TestListener(nlTestSuite * inSuite, void * inContext)
+{
+    AccessControl::Delegate & delegate = Examples::GetAccessControlDelegate();
+    CountingListener listener;
+
+    // A listener set on the delegate still hears about changes while access control is initialized.
+    NL_TEST_ASSERT(inSuite, accessControl.Finish() == CHIP_NO_ERROR);
+    delegate.SetListener(listener);
+    NL_TEST_ASSERT(inSuite, accessControl.Init() == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, listener.mEntryChanged == 1);
+
+    NL_TEST_ASSERT(inSuite, accessControl.Finish() == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, delegate.GetListener() == &listener);
+
+    delegate.ClearListener();
+    NL_TEST_ASSERT(inSuite, accessControl.Init() == CHIP_NO_ERROR);
+}
+
+/**
+ * Time the checks of a wildcard read, one per attribute path, against an access control list filled to capacity over
+ * four fabrics with entries holding as many subjects and targets as they can. The reading subject is named only by the
+ * last entry. The same reads are then repeated with an entry the compiled cache rejects, so that Check() iterates the
+ * delegate's entries instead.
+ */
+void TestCheckWildcardReadBenchmark(nlTestSuite * inSuite, void * inContext)
+{
+    constexpr size_t kFabricCount   = 4;
+    constexpr size_t kMaxSubjects   = CHIP_CONFIG_EXAMPLE_ACCESS_CONTROL_MAX_SUBJECTS_PER_ENTRY;
+    constexpr size_t kMaxTargets    = CHIP_CONFIG_EXAMPLE_ACCESS_CONTROL_MAX_TARGETS_PER_ENTRY;
+    constexpr EndpointId kEndpoints = 4;
+    constexpr ClusterId kClusters   = 32;
+    constexpr size_t kAttributes    = 8;
+    constexpr size_t kReads         = 20;
+    constexpr NodeId kFirstSubject  = 0x0000'0001'0000'0000;
+    constexpr size_t kPathsPerRead  = kEndpoints * kClusters * kAttributes;
+
+    size_t maxEntryCount = 0;
+    NL_TEST_ASSERT(inSuite, accessControl.GetMaxEntryCount(maxEntryCount) == CHIP_NO_ERROR);
+    const size_t entryCount = maxEntryCount - 1;
+
+    SubjectDescriptor subjectDescriptor;
+    for (size_t i = 0; i < entryCount; ++i)
+    {
+        Entry entry;
+        NL_TEST_ASSERT(inSuite, accessControl.PrepareEntry(entry) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, entry.SetFabricIndex(static_cast<FabricIndex>(1 + i % kFabricCount)) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, entry.SetAuthMode(AuthMode::kCase) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, entry.SetPrivilege(Privilege::kView) == CHIP_NO_ERROR);
+        for (size_t j = 0; j < kMaxSubjects; ++j)
+        {
+            NL_TEST_ASSERT(inSuite, entry.AddSubject(nullptr, kFirstSubject + i * kMaxSubjects + j) == CHIP_NO_ERROR);
+        }
+        for (size_t j = 0; j < kMaxTargets; ++j)
+        {
+            Target target = { .flags = Target::kEndpoint, .endpoint = static_cast<EndpointId>(j) };
+            NL_TEST_ASSERT(inSuite, entry.AddTarget(nullptr, target) == CHIP_NO_ERROR);
+        }
+        NL_TEST_ASSERT(inSuite, accessControl.CreateEntry(nullptr, entry) == CHIP_NO_ERROR);
+    }
+    subjectDescriptor.fabricIndex = static_cast<FabricIndex>(1 + (entryCount - 1) % kFabricCount);
+    subjectDescriptor.authMode    = AuthMode::kCase;
+    subjectDescriptor.subject     = kFirstSubject + entryCount * kMaxSubjects - 1;
+
+    auto read = [&](size_t & allowed) {
+        allowed    = 0;
+        auto start = System::SystemClock().GetMonotonicMicroseconds64();
+        for (size_t n = 0; n < kReads; ++n)
+        {
+            for (EndpointId endpoint = 0; endpoint < kEndpoints; ++endpoint)
+            {
+                for (ClusterId cluster = 0; cluster < kClusters; ++cluster)
+                {
+                    for (size_t attribute = 0; attribute < kAttributes; ++attribute)
+                    {
+                        RequestPath requestPath = { .cluster = cluster, .endpoint = endpoint };
+                        if (accessControl.Check(subjectDescriptor, requestPath, Privilege::kView) == CHIP_NO_ERROR)
+                        {
+                            allowed++;
+                        }
+                    }
+                }
+            }
+        }
+        return (System::SystemClock().GetMonotonicMicroseconds64() - start).count();
+    };
+
+    size_t cachedAllowed = 0;
+    auto cachedMicros    = read(cachedAllowed);
+
+    // A group subject is invalid in a CASE entry. Being on another fabric, the entry changes no decision.
+    {
+        Entry entry;
+        NL_TEST_ASSERT(inSuite, accessControl.PrepareEntry(entry) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, entry.SetFabricIndex(static_cast<FabricIndex>(kFabricCount + 1)) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, entry.SetAuthMode(AuthMode::kCase) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, entry.AddSubject(nullptr, kGroup2) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, accessControl.CreateEntry(nullptr, entry) == CHIP_NO_ERROR);
+    }
+
+    size_t uncachedAllowed = 0;
+    auto uncachedMicros    = read(uncachedAllowed);
+
+    // Targets allow the first kMaxTargets endpoints.
+    NL_TEST_ASSERT(inSuite, cachedAllowed == kReads * kClusters * kAttributes * std::min<size_t>(kMaxTargets, kEndpoints));
+    NL_TEST_ASSERT(inSuite, uncachedAllowed == cachedAllowed);
+    printf("AccessControl: %u entries, wildcard read of %u paths: %.2f us cached, %.2f us uncached\n",
+           static_cast<unsigned>(maxEntryCount), static_cast<unsigned>(kPathsPerRead),
+           static_cast<double>(cachedMicros) / kReads, static_cast<double>(uncachedMicros) / kReads);
+}
+
 void TestCreateReadEntry(nlTestSuite * inSuite, void * inContext)
 {
     for (size_t i = 0; i < entryData1Count; ++i)
@@ -1122,6 +1282,9 @@ int TestAccessControl()
         NL_TEST_DEF("TestFabricFilteredReadEntry", TestFabricFilteredReadEntry),
         NL_TEST_DEF("TestFabricFilteredCreateEntry", TestFabricFilteredCreateEntry),
         NL_TEST_DEF("TestCheck", TestCheck),
+        NL_TEST_DEF("TestCheckAfterChange", TestCheckAfterChange),
+        NL_TEST_DEF("TestListener", TestListener),
+        NL_TEST_DEF("TestCheckWildcardReadBenchmark", TestCheckWildcardReadBenchmark),
         NL_TEST_SENTINEL()
     };
     // clang-format on
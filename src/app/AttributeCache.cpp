@@ -18,14 +18,40 @@
 
 #include "system/SystemPacketBuffer.h"
 #include <app/AttributeCache.h>
+#include <algorithm>
 #include <app/InteractionModelEngine.h>
 #include <tuple>
 
 namespace chip {
 namespace app {
 
+namespace {
+
+bool PathLess(const ConcreteAttributePath & aLeft, const ConcreteAttributePath & aRight)
+{
+    return std::tie(aLeft.mEndpointId, aLeft.mClusterId, aLeft.mAttributeId) <
+        std::tie(aRight.mEndpointId, aRight.mClusterId, aRight.mAttributeId);
+}
+
+} // namespace
+
 CHIP_ERROR AttributeCache::UpdateCache(const ConcreteDataAttributePath & aPath, TLV::TLVReader * apData, const StatusIB & aStatus)
 {
+    if (mStorageMode == StorageMode::kFlatArena)
+    {
+        //
+        // Track new endpoints so that we can inform our callback of them, as below.
+        //
+        if (!mFlatCache.HasEndpoint(aPath.mEndpointId))
+        {
+            mAddedEndpoints.push_back(aPath.mEndpointId);
+        }
+
+        ReturnErrorOnFailure(apData ? mFlatCache.SetData(aPath, *apData) : mFlatCache.SetStatus(aPath, aStatus));
+        mChangedAttributes.push_back(aPath);
+        return CHIP_NO_ERROR;
+    }
+
     AttributeState state;
     System::PacketBufferHandle handle;
     System::PacketBufferTLVWriter writer;
@@ -62,34 +88,73 @@ CHIP_ERROR AttributeCache::UpdateCache(const ConcreteDataAttributePath & aPath,
     }
 
     mCache[aPath.mEndpointId][aPath.mClusterId][aPath.mAttributeId] = std::move(state);
-    mChangedAttributeSet.insert(aPath);
+    mChangedAttributes.push_back(aPath);
     return CHIP_NO_ERROR;
 }
 
+void AttributeCache::UpdatePendingVersion(const ConcreteClusterPath & aCluster, const Optional<DataVersion> & aVersion)
+{
+    //
+    // Until the report is over, the cache holds a mix of the old and the new state of the cluster.
+    //
+    mClusterVersions.erase(aCluster);
+
+    auto pending = mPendingClusterVersions.find(aCluster);
+    if (pending == mPendingClusterVersions.end())
+    {
+        mPendingClusterVersions.emplace(aCluster, aVersion);
+    }
+    else if (pending->second != aVersion)
+    {
+        pending->second.ClearValue();
+    }
+}
+
 void AttributeCache::OnReportBegin(const ReadClient * apReadClient)
 {
-    mChangedAttributeSet.clear();
+    mChangedAttributes.clear();
     mAddedEndpoints.clear();
+    mPendingClusterVersions.clear();
+
+    //
+    // Values handed out during the previous report may move from here on.
+    //
+    mFlatCache.Compact();
+
     mCallback.OnReportBegin(apReadClient);
 }
 
 void AttributeCache::OnReportEnd(const ReadClient * apReadClient)
 {
-    std::set<std::tuple<EndpointId, ClusterId>> changedClusters;
+    for (auto & pending : mPendingClusterVersions)
+    {
+        if (pending.second.HasValue())
+        {
+            mClusterVersions[pending.first] = pending.second.Value();
+        }
+    }
+    mPendingClusterVersions.clear();
 
-    //
-    // Add the EndpointId and ClusterId into a set so that we only
-    // convey unique combinations in the subsequent OnClusterChanged callback.
-    //
-    for (auto & path : mChangedAttributeSet)
+    std::sort(mChangedAttributes.begin(), mChangedAttributes.end(), PathLess);
+    mChangedAttributes.erase(std::unique(mChangedAttributes.begin(), mChangedAttributes.end()), mChangedAttributes.end());
+
+    for (auto & path : mChangedAttributes)
     {
         mCallback.OnAttributeChanged(this, path);
-        changedClusters.insert(std::make_tuple(path.mEndpointId, path.mClusterId));
     }
 
-    for (auto & item : changedClusters)
+    //
+    // The paths are sorted, so the attributes of a cluster are next to each other: only convey the first of them in the
+    // OnClusterChanged callback.
+    //
+    for (size_t i = 0; i < mChangedAttributes.size(); i++)
     {
-        mCallback.OnClusterChanged(this, std::get<0>(item), std::get<1>(item));
+        const ConcreteAttributePath & path = mChangedAttributes[i];
+        if (i == 0 || path.mEndpointId != mChangedAttributes[i - 1].mEndpointId ||
+            path.mClusterId != mChangedAttributes[i - 1].mClusterId)
+        {
+            mCallback.OnClusterChanged(this, path.mEndpointId, path.mClusterId);
+        }
     }
 
     for (auto endpoint : mAddedEndpoints)
@@ -97,6 +162,12 @@ void AttributeCache::OnReportEnd(const ReadClient * apReadClient)
         mCallback.OnEndpointAdded(this, endpoint);
     }
 
+    //
+    // A report priming the cache may change thousands of paths: don't hold on to room for them in between reports.
+    //
+    mChangedAttributes.clear();
+    mChangedAttributes.shrink_to_fit();
+
     mCallback.OnReportEnd(apReadClient);
 }
 
@@ -116,7 +187,22 @@ void AttributeCache::OnAttributeData(const ReadClient * apReadClient, const Conc
     //
     VerifyOrDie(!aPath.IsListItemOperation());
 
-    UpdateCache(aPath, apData, aStatus);
+    CHIP_ERROR err = UpdateCache(aPath, apData, aStatus);
+    ConcreteClusterPath cluster(aPath.mEndpointId, aPath.mClusterId);
+
+    if (err != CHIP_NO_ERROR)
+    {
+        // The cache missed a value of the cluster, so it must not claim to hold any version of it.
+        UpdatePendingVersion(cluster, NullOptional);
+    }
+    else if (apData != nullptr)
+    {
+        UpdatePendingVersion(cluster, aPath.mDataVersion);
+    }
+    else
+    {
+        mClusterVersions.erase(cluster);
+    }
 
     //
     // Forward the call through.
@@ -124,10 +210,56 @@ void AttributeCache::OnAttributeData(const ReadClient * apReadClient, const Conc
     mCallback.OnAttributeData(apReadClient, aPath, apData, aStatus);
 }
 
+CHIP_ERROR AttributeCache::OnUpdateDataVersionFilterList(DataVersionFilterIBs::Builder & aDataVersionFilterIBsBuilder,
+                                                         const Span<AttributePathParams> & aAttributePaths,
+                                                         bool & aEncodedDataVersionList)
+{
+    aEncodedDataVersionList = false;
+
+    for (auto & clusterVersion : mClusterVersions)
+    {
+        const ConcreteClusterPath & cluster = clusterVersion.first;
+        if (std::none_of(aAttributePaths.begin(), aAttributePaths.end(),
+                         [&cluster](const AttributePathParams & path) { return path.IsClusterPathSupersetOf(cluster); }))
+        {
+            continue;
+        }
+
+        CHIP_ERROR err = aDataVersionFilterIBsBuilder.EncodeDataVersionFilterIB(
+            DataVersionFilter(cluster.mEndpointId, cluster.mClusterId, clusterVersion.second));
+        if (err == CHIP_ERROR_NO_MEMORY || err == CHIP_ERROR_BUFFER_TOO_SMALL)
+        {
+            // The request is full; the clusters left out are simply reported in full.
+            break;
+        }
+        ReturnErrorOnFailure(err);
+        aEncodedDataVersionList = true;
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+void AttributeCache::GetVersion(EndpointId endpointId, ClusterId clusterId, Optional<DataVersion> & aVersion) const
+{
+    auto clusterVersion = mClusterVersions.find(ConcreteClusterPath(endpointId, clusterId));
+    if (clusterVersion == mClusterVersions.end())
+    {
+        aVersion.ClearValue();
+        return;
+    }
+
+    aVersion.SetValue(clusterVersion->second);
+}
+
 CHIP_ERROR AttributeCache::Get(const ConcreteAttributePath & path, TLV::TLVReader & reader)
 {
     CHIP_ERROR err;
 
+    if (mStorageMode == StorageMode::kFlatArena)
+    {
+        return mFlatCache.GetData(path, reader);
+    }
+
     auto attributeState = GetAttributeState(path.mEndpointId, path.mClusterId, path.mAttributeId, err);
     ReturnErrorOnFailure(err);
 
@@ -201,6 +333,11 @@ CHIP_ERROR AttributeCache::GetStatus(const ConcreteAttributePath & path, StatusI
 {
     CHIP_ERROR err;
 
+    if (mStorageMode == StorageMode::kFlatArena)
+    {
+        return mFlatCache.GetStatus(path, status);
+    }
+
     auto attributeState = GetAttributeState(path.mEndpointId, path.mClusterId, path.mAttributeId, err);
     ReturnErrorOnFailure(err);
 
@@ -23,6 +23,8 @@
 #include "system/TLVPacketBufferBackingStore.h"
 #include <app/AttributePathParams.h>
 #include <app/BufferedReadCallback.h>
+#include <app/ConcreteClusterPath.h>
+#include <app/FlatAttributeStore.h>
 #include <app/ReadClient.h>
 #include <app/data-model/Decode.h>
 #include <lib/support/Variant.h>
@@ -58,6 +60,20 @@ namespace app {
  *
  * **NOTE** This already includes the BufferedReadCallback, so there is no need to add that to the ReadClient callback chain.
  *
+ * The cache keeps the data version of every cluster instance it holds a complete, consistent report of.  When a request on
+ * its ReadClient does not carry data version filters of its own, the cache adds filters for those clusters, so that a
+ * re-subscription or a repeated read only gets the clusters that changed.  This assumes that the request covers the same
+ * attributes as the ones the cache was filled with: the server skips a filtered cluster entirely, including the attributes
+ * the cache never received.
+ *
+ * The cache can store its data in one of two ways:
+ *
+ *      - StorageMode::kMaps keeps a map per endpoint and per cluster, and a packet buffer per attribute value.
+ *
+ *      - StorageMode::kFlatArena keeps a single array of attributes sorted by path, with the values packed into large arena
+ *        chunks (see FlatAttributeStore).  This takes a fraction of the memory, and is meant for controllers caching
+ *        wildcard subscriptions to many nodes.  Values whose encoded size doesn't change are updated in place.
+ *
  */
 class AttributeCache : protected ReadClient::Callback
 {
@@ -81,7 +97,15 @@ public:
         virtual void OnEndpointAdded(AttributeCache * cache, EndpointId endpointId){};
     };
 
-    AttributeCache(Callback & callback) : mCallback(callback), mBufferedReader(*this) {}
+    enum class StorageMode : uint8_t
+    {
+        kMaps,
+        kFlatArena,
+    };
+
+    AttributeCache(Callback & callback, StorageMode storageMode = StorageMode::kMaps) :
+        mCallback(callback), mStorageMode(storageMode), mBufferedReader(*this)
+    {}
 
     /*
      * When registering as a callback to the ReadClient, the AttributeCache cannot not be passed as a callback
@@ -96,8 +120,8 @@ public:
      *
      * For some types of attributes, the value for the attribute is directly backed by the underlying TLV buffer
      * and has pointers into that buffer. (e.g octet strings, char strings and lists).  This buffer only remains
-     * valid until the cached value for that path is updated, so it must not be held
-     * across any async call boundaries.
+     * valid until the cached value for that path is updated (with StorageMode::kFlatArena, until the next report
+     * begins), so it must not be held across any async call boundaries.
      *
      * The template parameter AttributeObjectTypeT is generally expected to be a
      * ClusterName::Attributes::AttributeName::DecodableType, but any
@@ -157,8 +181,8 @@ public:
      *
      * For some types of attributes, the value for the attribute is directly backed by the underlying TLV buffer
      * and has pointers into that buffer. (e.g octet strings, char strings and lists).  This buffer only remains
-     * valid until the cached value for that path is updated, so it must not be held
-     * across any async call boundaries.
+     * valid until the cached value for that path is updated (with StorageMode::kFlatArena, until the next report
+     * begins), so it must not be held across any async call boundaries.
      *
      * The template parameter ClusterObjectT is generally expected to be a
      * ClusterName::Attributes::DecodableType, but any
@@ -203,8 +227,8 @@ public:
      * Retrieve the value of an attribute by updating a in-out TLVReader to be positioned
      * right at the attribute value.
      *
-     * The underlying TLV buffer only remains valid until the cached value for that path is updated, so it must
-     * not be held across any async call boundaries.
+     * The underlying TLV buffer only remains valid until the cached value for that path is updated (with
+     * StorageMode::kFlatArena, until the next report begins), so it must not be held across any async call boundaries.
      *
      * Notable return values:
      *      - If neither data nor status for the specified path exist in the cache, CHIP_ERROR_KEY_NOT_FOUND
@@ -237,6 +261,11 @@ public:
     {
         CHIP_ERROR err;
 
+        if (mStorageMode == StorageMode::kFlatArena)
+        {
+            return mFlatCache.ForEachAttribute(endpointId, clusterId, func);
+        }
+
         auto clusterState = GetClusterState(endpointId, clusterId, err);
         ReturnErrorOnFailure(err);
 
@@ -265,6 +294,11 @@ public:
     template <typename IteratorFunc>
     CHIP_ERROR ForEachAttribute(ClusterId clusterId, IteratorFunc func)
     {
+        if (mStorageMode == StorageMode::kFlatArena)
+        {
+            return mFlatCache.ForEachAttribute(clusterId, func);
+        }
+
         for (auto & endpointIter : mCache)
         {
             for (auto & clusterIter : endpointIter.second)
@@ -279,6 +313,8 @@ public:
                 }
             }
         }
+
+        return CHIP_NO_ERROR;
     }
 
     /*
@@ -297,16 +333,35 @@ public:
     template <typename IteratorFunc>
     CHIP_ERROR ForEachCluster(EndpointId endpointId, IteratorFunc func)
     {
+        if (mStorageMode == StorageMode::kFlatArena)
+        {
+            return mFlatCache.ForEachCluster(endpointId, func);
+        }
+
         auto endpointIter = mCache.find(endpointId);
-        if (endpointIter->first == endpointId)
+        if (endpointIter != mCache.end())
         {
             for (auto & clusterIter : endpointIter->second)
             {
                 ReturnErrorOnFailure(func(clusterIter.first));
             }
         }
+
+        return CHIP_NO_ERROR;
     }
 
+    /*
+     * Returns the number of bytes held by the attribute data in the cache.  This is only tracked with
+     * StorageMode::kFlatArena, and is 0 otherwise.
+     */
+    size_t GetAllocatedBytes() const { return mFlatCache.GetAllocatedBytes(); }
+
+    /*
+     * Retrieve the data version of a cluster instance, as of the last report that completed.  The version is left empty if
+     * the cache has no consistent view of the cluster at a single version.
+     */
+    void GetVersion(EndpointId endpointId, ClusterId clusterId, Optional<DataVersion> & aVersion) const;
+
 private:
     using AttributeState = Variant<System::PacketBufferHandle, StatusIB>;
     using ClusterState   = std::map<AttributeId, AttributeState>;
@@ -335,6 +390,12 @@ private:
      */
     CHIP_ERROR UpdateCache(const ConcreteDataAttributePath & aPath, TLV::TLVReader * apData, const StatusIB & aStatus);
 
+    /*
+     * Track the data version that came along with attribute data of a cluster; the version of the cluster is only committed
+     * once the report is over.  An empty version keeps the cluster from being committed.
+     */
+    void UpdatePendingVersion(const ConcreteClusterPath & aCluster, const Optional<DataVersion> & aVersion);
+
 private:
     //
     // ReadClient::Callback
@@ -352,12 +413,21 @@ private:
 
     void OnDone(ReadClient * apReadClient) override { return mCallback.OnDone(apReadClient); }
     void OnSubscriptionEstablished(const ReadClient * apReadClient) override { mCallback.OnSubscriptionEstablished(apReadClient); }
+    CHIP_ERROR OnUpdateDataVersionFilterList(DataVersionFilterIBs::Builder & aDataVersionFilterIBsBuilder,
+                                             const Span<AttributePathParams> & aAttributePaths,
+                                             bool & aEncodedDataVersionList) override;
 
 private:
     Callback & mCallback;
+    StorageMode mStorageMode;
     NodeState mCache;
-    std::set<ConcreteAttributePath> mChangedAttributeSet;
+    FlatAttributeStore mFlatCache;
+    // Paths changed by the current report, possibly more than once.  Sorted and de-duplicated when the report ends.
+    std::vector<ConcreteAttributePath> mChangedAttributes;
     std::vector<EndpointId> mAddedEndpoints;
+    std::map<ConcreteClusterPath, DataVersion> mClusterVersions;
+    // Versions seen during the current report.  An empty version marks a cluster reported at more than one version.
+    std::map<ConcreteClusterPath, Optional<DataVersion>> mPendingClusterVersions;
     BufferedReadCallback mBufferedReader;
 };
 
@@ -19,7 +19,10 @@
 
 namespace chip {
 
-CASEClient::CASEClient(const CASEClientInitParams & params) : mInitParams(params) {}
+CASEClient::CASEClient(const CASEClientInitParams & params) : mInitParams(params)
+{
+    mCASESession.SetCryptoOffload(params.cryptoOffload);
+}
 
 void CASEClient::SetMRPIntervals(const ReliableMessageProtocolConfig & mrpConfig)
 {
@@ -37,6 +37,8 @@ struct CASEClientInitParams
     FabricInfo * fabricInfo                  = nullptr;
 
     Optional<ReliableMessageProtocolConfig> mrpLocalConfig = Optional<ReliableMessageProtocolConfig>::Missing();
+
+    CASECryptoOffload * cryptoOffload = nullptr;
 };
 
 class DLL_EXPORT CASEClient : public SessionEstablishmentDelegate
@@ -0,0 +1,127 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <app/CASEHandshakeLimiter.h>
+
+#include <app/OperationalDeviceProxy.h>
+#include <lib/support/CodeUtils.h>
+
+namespace chip {
+
+void CASEHandshakeLimiter::SetMaxHandshakes(uint16_t maxHandshakes)
+{
+    mMaxHandshakes = maxHandshakes;
+    StartQueuedHandshakes();
+}
+
+bool CASEHandshakeLimiter::Acquire(OperationalDeviceProxy & proxy)
+{
+    if (proxy.mHandshakeSlot != Slot::kNone)
+    {
+        return proxy.mHandshakeSlot == Slot::kHeld;
+    }
+
+    // Don't overtake the proxies already waiting.
+    if (mFirstWaiting == nullptr && HasFreeSlot())
+    {
+        proxy.mHandshakeSlot = Slot::kHeld;
+        mActiveHandshakes++;
+        return true;
+    }
+
+    proxy.mHandshakeSlot           = Slot::kWaiting;
+    proxy.mNextWaitingForHandshake = nullptr;
+    if (mLastWaiting == nullptr)
+    {
+        mFirstWaiting = &proxy;
+    }
+    else
+    {
+        mLastWaiting->mNextWaitingForHandshake = &proxy;
+    }
+    mLastWaiting = &proxy;
+    return false;
+}
+
+void CASEHandshakeLimiter::Release(OperationalDeviceProxy & proxy)
+{
+    switch (proxy.mHandshakeSlot)
+    {
+    case Slot::kNone:
+        return;
+
+    case Slot::kWaiting: {
+        OperationalDeviceProxy * previous = nullptr;
+        for (OperationalDeviceProxy * waiting = mFirstWaiting; waiting != &proxy; waiting = waiting->mNextWaitingForHandshake)
+        {
+            previous = waiting;
+        }
+
+        if (previous == nullptr)
+        {
+            mFirstWaiting = proxy.mNextWaitingForHandshake;
+        }
+        else
+        {
+            previous->mNextWaitingForHandshake = proxy.mNextWaitingForHandshake;
+        }
+        if (mLastWaiting == &proxy)
+        {
+            mLastWaiting = previous;
+        }
+        proxy.mNextWaitingForHandshake = nullptr;
+        break;
+    }
+
+    case Slot::kHeld:
+        mActiveHandshakes--;
+        break;
+    }
+
+    proxy.mHandshakeSlot = Slot::kNone;
+    StartQueuedHandshakes();
+}
+
+void CASEHandshakeLimiter::StartQueuedHandshakes()
+{
+    // A handshake failing to start releases its slot right away: let the outermost call carry on with the line rather than
+    // recursing once per proxy.
+    VerifyOrReturn(!mStartingHandshakes);
+    mStartingHandshakes = true;
+
+    while (mFirstWaiting != nullptr && HasFreeSlot())
+    {
+        OperationalDeviceProxy * proxy = mFirstWaiting;
+
+        mFirstWaiting = proxy->mNextWaitingForHandshake;
+        if (mFirstWaiting == nullptr)
+        {
+            mLastWaiting = nullptr;
+        }
+        proxy->mNextWaitingForHandshake = nullptr;
+        proxy->mHandshakeSlot           = Slot::kHeld;
+        mActiveHandshakes++;
+
+        // This may free proxy.
+        proxy->StartQueuedHandshake();
+    }
+
+    mStartingHandshakes = false;
+}
+
+} // namespace chip
@@ -0,0 +1,73 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+namespace chip {
+
+class OperationalDeviceProxy;
+
+/**
+ * Limits how many CASE handshakes the OperationalDeviceProxy objects sharing it run at once.  When no slot is free, the
+ * proxies wait in line, and start their handshake in turn as slots free up.
+ */
+class CASEHandshakeLimiter
+{
+public:
+    enum class Slot : uint8_t
+    {
+        kNone,
+        kWaiting,
+        kHeld,
+    };
+
+    /**
+     * @param maxHandshakes  How many handshakes may run at once, 0 meaning no limit.
+     */
+    explicit CASEHandshakeLimiter(uint16_t maxHandshakes = 0) : mMaxHandshakes(maxHandshakes) {}
+
+    void SetMaxHandshakes(uint16_t maxHandshakes);
+
+    uint16_t GetActiveHandshakes() const { return mActiveHandshakes; }
+
+    /**
+     * Take a slot for the handshake of proxy and return true if one is free.  Otherwise, put proxy in line and return false:
+     * the limiter calls proxy.StartQueuedHandshake() once a slot frees up for it.
+     */
+    bool Acquire(OperationalDeviceProxy & proxy);
+
+    /**
+     * Free the slot of proxy, or take it out of the line.
+     */
+    void Release(OperationalDeviceProxy & proxy);
+
+private:
+    bool HasFreeSlot() const { return mMaxHandshakes == 0 || mActiveHandshakes < mMaxHandshakes; }
+    void StartQueuedHandshakes();
+
+    uint16_t mMaxHandshakes;
+    uint16_t mActiveHandshakes = 0;
+
+    OperationalDeviceProxy * mFirstWaiting = nullptr;
+    OperationalDeviceProxy * mLastWaiting  = nullptr;
+    bool mStartingHandshakes               = false;
+};
+
+} // namespace chip
@@ -38,6 +38,9 @@ struct CASESessionManagerConfig
     Dnssd::DnssdCache<CHIP_CONFIG_MDNS_CACHE_SIZE> * dnsCache = nullptr;
     OperationalDeviceProxyPoolDelegate * devicePool           = nullptr;
     Dnssd::ResolverProxy * dnsResolver                        = nullptr;
+    // How many CASE handshakes may run at once, 0 meaning no limit.  Unless sessionInitParams has its own limiter, the
+    // manager's limiter applies.
+    uint16_t maxConcurrentHandshakes = CHIP_CONFIG_CASE_MAX_CONCURRENT_HANDSHAKES;
 };
 
 /**
@@ -53,11 +56,15 @@ class CASESessionManager : public Dnssd::ResolverDelegate
 public:
     CASESessionManager() = delete;
 
-    CASESessionManager(const CASESessionManagerConfig & params)
+    CASESessionManager(const CASESessionManagerConfig & params) : mHandshakeLimiter(params.maxConcurrentHandshakes)
     {
         VerifyOrDie(params.sessionInitParams.Validate() == CHIP_NO_ERROR);
 
         mConfig = params;
+        if (mConfig.sessionInitParams.handshakeLimiter == nullptr)
+        {
+            mConfig.sessionInitParams.handshakeLimiter = &mHandshakeLimiter;
+        }
     }
 
     CHIP_ERROR Init()
@@ -116,6 +123,7 @@ private:
 
     CASESessionManagerConfig mConfig;
     Dnssd::ResolverProxy mDNSResolver;
+    CASEHandshakeLimiter mHandshakeLimiter;
 };
 
 } // namespace chip
@@ -121,6 +121,11 @@ struct ConcreteDataAttributePath : public ConcreteAttributePath
     //
     uint16_t mListIndex   = 0;
     ListOperation mListOp = ListOperation::NotList;
+
+    //
+    // The data version of the cluster the data was read from, when it was reported along with it.
+    //
+    Optional<DataVersion> mDataVersion;
 };
 
 } // namespace app
@@ -0,0 +1,53 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <app/util/basic-types.h>
+
+namespace chip {
+namespace app {
+
+/**
+ * A representation of a concrete cluster instance, i.e. a cluster on a given endpoint.  Data versions are kept at this
+ * granularity.
+ */
+struct ConcreteClusterPath
+{
+    ConcreteClusterPath() {}
+
+    ConcreteClusterPath(EndpointId aEndpointId, ClusterId aClusterId) : mEndpointId(aEndpointId), mClusterId(aClusterId) {}
+
+    bool operator==(const ConcreteClusterPath & other) const
+    {
+        return (mEndpointId == other.mEndpointId) && (mClusterId == other.mClusterId);
+    }
+
+    bool operator!=(const ConcreteClusterPath & other) const { return !(*this == other); }
+
+    bool operator<(const ConcreteClusterPath & other) const
+    {
+        return (mEndpointId < other.mEndpointId) || ((mEndpointId == other.mEndpointId) && (mClusterId < other.mClusterId));
+    }
+
+    EndpointId mEndpointId = 0;
+    ClusterId mClusterId   = 0;
+};
+
+} // namespace app
+} // namespace chip
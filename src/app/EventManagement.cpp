@@ -31,6 +31,9 @@ namespace chip {
 namespace app {
 static EventManagement sInstance;
 
+static_assert(CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0 && CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE <= UINT8_MAX,
+              "CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE must be between 1 and 255");
+
 /**
  * @brief
  *   A TLVReader backed by CircularEventBuffer
@@ -63,6 +66,7 @@ struct ReclaimEventCtx
 {
     CircularEventBuffer * mpEventBuffer = nullptr;
     size_t mSpaceNeededForMovedEvent    = 0;
+    EventNumber mMovedEventNumber       = 0;
 };
 
 /**
@@ -172,7 +176,7 @@ void EventManagement::Init(Messaging::ExchangeManager * apExchangeManager, uint3
 #endif // !CHIP_SYSTEM_CONFIG_NO_LOCKING
 }
 
-CHIP_ERROR EventManagement::CopyToNextBuffer(CircularEventBuffer * apEventBuffer)
+CHIP_ERROR EventManagement::CopyToNextBuffer(CircularEventBuffer * apEventBuffer, EventNumber aEventNumber)
 {
     CircularTLVWriter writer;
     CircularTLVReader reader;
@@ -201,6 +205,8 @@ CHIP_ERROR EventManagement::CopyToNextBuffer(CircularEventBuffer * apEventBuffer
     err = writer.Finalize();
     SuccessOrExit(err);
 
+    nextBuffer->OnEventAppended(aEventNumber, writer.GetLengthWritten());
+
     ChipLogProgress(EventLogging, "Copy Event to next buffer with priority %u", static_cast<unsigned>(nextBuffer->GetPriority()));
 exit:
     if (err != CHIP_NO_ERROR)
@@ -232,7 +238,7 @@ CHIP_ERROR EventManagement::EnsureSpaceInCircularBuffer(size_t aRequiredSpace)
 
             eventBuffer->mProcessEvictedElement = EvictEvent;
             eventBuffer->mAppData               = &ctx;
-            err                                 = eventBuffer->EvictHead();
+            err                                 = eventBuffer->EvictHeadEvent();
 
             // one of two things happened: either the element was evicted immediately if the head's priority is same as current
             // buffer(final one), or we figured out how much space we need to evict it into the next buffer, the check happens in
@@ -250,11 +256,11 @@ CHIP_ERROR EventManagement::EnsureSpaceInCircularBuffer(size_t aRequiredSpace)
                     // Since we're calling CopyElement and we've checked
                     // that there is space in the next buffer, we don't expect
                     // this to fail.
-                    err = CopyToNextBuffer(eventBuffer);
+                    err = CopyToNextBuffer(eventBuffer, ctx.mMovedEventNumber);
                     SuccessOrExit(err);
                     // success; evict head unconditionally
                     eventBuffer->mProcessEvictedElement = nullptr;
-                    err                                 = eventBuffer->EvictHead();
+                    err                                 = eventBuffer->EvictHeadEvent();
                     // if unconditional eviction failed, this
                     // means that we have no way of further
                     // clearing the buffer.  fail out and let the
@@ -480,8 +486,6 @@ CHIP_ERROR EventManagement::LogEventPrivate(EventLoggingDelegate * apDelegate, c
 #endif
 
     opts = EventOptions(timestamp);
-    // Start the event container (anonymous structure) in the circular buffer
-    writer.Init(*mpEventBuffer);
 
     opts.mPriority = aEventOptions.mPriority;
     // Create all event specific data
@@ -500,6 +504,10 @@ CHIP_ERROR EventManagement::LogEventPrivate(EventLoggingDelegate * apDelegate, c
     err = EnsureSpaceInCircularBuffer(requestSize);
     SuccessOrExit(err);
 
+    // Start the event container (anonymous structure) in the circular buffer.  Only now, as making space moves the head of
+    // the buffer and the writer takes its first contiguous segment up to it.
+    writer.Init(*mpEventBuffer);
+
     err = ConstructEvent(&ctxt, apDelegate, &opts);
     SuccessOrExit(err);
 
@@ -522,6 +530,7 @@ CHIP_ERROR EventManagement::LogEventPrivate(EventLoggingDelegate * apDelegate, c
     }
 
     mBytesWritten += writer.GetLengthWritten();
+    mpEventBuffer->OnEventAppended(mLastEventNumber, writer.GetLengthWritten());
 
 exit:
     if (err != CHIP_NO_ERROR)
@@ -667,7 +676,10 @@ CHIP_ERROR EventManagement::FetchEventsSince(TLVWriter & aWriter, ClusterInfo *
     CHIP_ERROR err     = CHIP_NO_ERROR;
     const bool recurse = false;
     TLVReader reader;
+    CircularEventReader circularReader;
     CircularEventBufferWrapper bufWrapper;
+    CircularEventBuffer * oldestBuffer = nullptr;
+    CircularEventBuffer * buffer       = nullptr;
     EventLoadOutContext context(aWriter, PriorityLevel::Invalid, aEventMin);
 
 #if !CHIP_SYSTEM_CONFIG_NO_LOCKING
@@ -675,8 +687,28 @@ CHIP_ERROR EventManagement::FetchEventsSince(TLVWriter & aWriter, ClusterInfo *
 #endif // !CHIP_SYSTEM_CONFIG_NO_LOCKING
 
     context.mpInterestedEventPaths = apClusterInfolist;
-    err                            = GetEventReader(reader, PriorityLevel::Critical, &bufWrapper);
-    SuccessOrExit(err);
+
+    // Events are read from the critical buffer down to the debug one, oldest first: events only reach a buffer when
+    // evicted from the previous one.  Buffers, and runs of events within a buffer, that only hold events older than
+    // aEventMin are skipped rather than decoded.
+    oldestBuffer = GetPriorityBuffer(PriorityLevel::Critical);
+    VerifyOrExit(oldestBuffer != nullptr, err = CHIP_ERROR_INVALID_ARGUMENT);
+    buffer = oldestBuffer;
+    while (!buffer->HasEventsSince(aEventMin) && buffer->GetPreviousCircularEventBuffer() != nullptr)
+    {
+        buffer = buffer->GetPreviousCircularEventBuffer();
+    }
+
+    bufWrapper.mpCurrent   = buffer;
+    bufWrapper.mSkipLength = buffer->GetSkippableLength(aEventMin);
+    if ((aEventMin > 0) && ((buffer != oldestBuffer) || (bufWrapper.mSkipLength > 0)))
+    {
+        // Everything skipped is older than aEventMin
+        context.mCurrentEventNumber = aEventMin - 1;
+    }
+
+    circularReader.Init(&bufWrapper);
+    reader.Init(circularReader);
 
     err = TLV::Utilities::Iterate(reader, CopyEventsSince, &context, recurse);
     if (err == CHIP_END_OF_TLV)
@@ -789,6 +821,7 @@ CHIP_ERROR EventManagement::EvictEvent(CHIPCircularTLVBuffer & apBuffer, void *
 
     // event is not getting dropped. Note how much space it requires, and return.
     ctx->mSpaceNeededForMovedEvent = aReader.GetLengthRead();
+    ctx->mMovedEventNumber         = context.mEventNumber;
     return CHIP_END_OF_TLV;
 }
 
@@ -810,6 +843,72 @@ void CircularEventBuffer::Init(uint8_t * apBuffer, uint32_t aBufferLength, Circu
     mpNext               = apNext;
     mPriority            = aPriorityLevel;
     mpEventNumberCounter = nullptr;
+    mIndexFirst          = 0;
+    mIndexCount          = 0;
+    mHeadOffset          = 0;
+    mLastEventNumber     = 0;
+}
+
+void CircularEventBuffer::OnEventAppended(EventNumber aEventNumber, uint32_t aEventLength)
+{
+    constexpr uint8_t kIndexSize = CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE;
+    const uint32_t offset        = mHeadOffset + DataLength() - aEventLength;
+
+    mLastEventNumber = aEventNumber;
+
+    // Spread the entries out so that together they span the whole buffer.
+    if (mIndexCount > 0 &&
+        offset - mIndex[(mIndexFirst + mIndexCount - 1) % kIndexSize].mOffset < GetTotalDataLength() / kIndexSize)
+    {
+        return;
+    }
+
+    if (mIndexCount == kIndexSize)
+    {
+        mIndexFirst = static_cast<uint8_t>((mIndexFirst + 1) % kIndexSize);
+        mIndexCount--;
+    }
+
+    EventIndexEntry & entry = mIndex[(mIndexFirst + mIndexCount) % kIndexSize];
+    entry.mEventNumber      = aEventNumber;
+    entry.mOffset           = offset;
+    mIndexCount++;
+}
+
+CHIP_ERROR CircularEventBuffer::EvictHeadEvent()
+{
+    constexpr uint8_t kIndexSize = CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE;
+    const uint32_t dataLength    = DataLength();
+
+    ReturnErrorOnFailure(EvictHead());
+    mHeadOffset += dataLength - DataLength();
+
+    // Offsets wrap around, so compare distances to the head.
+    while (mIndexCount > 0 && static_cast<int32_t>(mIndex[mIndexFirst].mOffset - mHeadOffset) < 0)
+    {
+        mIndexFirst = static_cast<uint8_t>((mIndexFirst + 1) % kIndexSize);
+        mIndexCount--;
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+uint32_t CircularEventBuffer::GetSkippableLength(EventNumber aEventNumber) const
+{
+    constexpr uint8_t kIndexSize = CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE;
+    uint32_t skippableLength     = 0;
+
+    for (uint8_t i = 0; i < mIndexCount; i++)
+    {
+        const EventIndexEntry & entry = mIndex[(mIndexFirst + i) % kIndexSize];
+        if (entry.mEventNumber > aEventNumber)
+        {
+            break;
+        }
+        skippableLength = entry.mOffset - mHeadOffset;
+    }
+
+    return skippableLength;
 }
 
 bool CircularEventBuffer::IsFinalDestinationForPriority(PriorityLevel aPriority) const
@@ -824,8 +923,8 @@ void CircularEventReader::Init(CircularEventBufferWrapper * apBufWrapper)
     if (apBufWrapper->mpCurrent == nullptr)
         return;
 
-    TLVReader::Init(*apBufWrapper, apBufWrapper->mpCurrent->DataLength());
-    mMaxLen = apBufWrapper->mpCurrent->DataLength();
+    TLVReader::Init(*apBufWrapper, apBufWrapper->mpCurrent->DataLength() - apBufWrapper->mSkipLength);
+    mMaxLen = apBufWrapper->mpCurrent->DataLength() - apBufWrapper->mSkipLength;
     for (prev = apBufWrapper->mpCurrent->GetPreviousCircularEventBuffer(); prev != nullptr;
          prev = prev->GetPreviousCircularEventBuffer())
     {
@@ -841,6 +940,21 @@ CHIP_ERROR CircularEventBufferWrapper::GetNextBuffer(TLVReader & aReader, const
     mpCurrent->GetNextBuffer(aReader, aBufStart, aBufLen);
     SuccessOrExit(err);
 
+    // The data to skip may wrap around the end of the buffer
+    while ((mSkipLength > 0) && (aBufLen > 0))
+    {
+        if (mSkipLength < aBufLen)
+        {
+            aBufStart += mSkipLength;
+            aBufLen -= mSkipLength;
+            mSkipLength = 0;
+            break;
+        }
+        mSkipLength -= aBufLen;
+        aBufStart += aBufLen;
+        mpCurrent->GetNextBuffer(aReader, aBufStart, aBufLen);
+    }
+
     if ((aBufLen == 0) && (mpCurrent->GetPreviousCircularEventBuffer() != nullptr))
     {
         mpCurrent = mpCurrent->GetPreviousCircularEventBuffer();
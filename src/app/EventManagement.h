@@ -32,6 +32,7 @@
 #include <app/MessageDef/EventDataIB.h>
 #include <app/util/basic-types.h>
 #include <lib/core/CHIPCircularTLVBuffer.h>
+#include <lib/core/CHIPEventLoggingConfig.h>
 #include <lib/support/PersistedCounter.h>
 #include <messaging/ExchangeMgr.h>
 #include <system/SystemMutex.h>
@@ -96,9 +97,49 @@ public:
     void SetRequiredSpaceforEvicted(size_t aRequiredSpace) { mRequiredSpaceForEvicted = aRequiredSpace; }
     size_t GetRequiredSpaceforEvicted() { return mRequiredSpaceForEvicted; }
 
+    /**
+     * @brief
+     *   Record that an event was just appended to the buffer, adding it to
+     *   the event number index if it lies far enough from the last indexed
+     *   event.
+     *
+     * @param[in] aEventNumber  The number of the appended event.
+     *
+     * @param[in] aEventLength  The encoded length of the appended event.
+     */
+    void OnEventAppended(EventNumber aEventNumber, uint32_t aEventLength);
+
+    /**
+     * @brief
+     *   Evict the oldest event, as EvictHead does, and drop the index
+     *   entries pointing at it.
+     */
+    CHIP_ERROR EvictHeadEvent();
+
+    /**
+     * @brief
+     *   Whether the buffer holds any event numbered aEventNumber or higher.
+     */
+    bool HasEventsSince(EventNumber aEventNumber) const { return DataLength() != 0 && mLastEventNumber >= aEventNumber; }
+
+    /**
+     * @brief
+     *   Find how much of the buffer can be skipped when looking for the
+     *   events numbered aEventNumber or higher.
+     *
+     * @return The length, from the head of the buffer, of a run of whole
+     *         events that are all numbered below aEventNumber.
+     */
+    uint32_t GetSkippableLength(EventNumber aEventNumber) const;
+
     virtual ~CircularEventBuffer() = default;
 
 private:
+    struct EventIndexEntry
+    {
+        EventNumber mEventNumber;
+        uint32_t mOffset; ///< Position of the event, on the same scale as mHeadOffset
+    };
     CircularEventBuffer * mpPrev = nullptr; ///< A pointer CircularEventBuffer storing events less important events
     CircularEventBuffer * mpNext = nullptr; ///< A pointer CircularEventBuffer storing events more important events
 
@@ -112,6 +153,14 @@ private:
     MonotonicallyIncreasingCounter mNonPersistedCounter;
 
     size_t mRequiredSpaceForEvicted = 0; ///< Required space for previous buffer to evict event to new buffer
+
+    // Sparse index of the events in the buffer, oldest first, kept in a ring.  Offsets count the bytes ever written to the
+    // buffer, so that an entry stays valid while the buffer wraps around.
+    EventIndexEntry mIndex[CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE];
+    uint8_t mIndexFirst          = 0;
+    uint8_t mIndexCount          = 0;
+    uint32_t mHeadOffset         = 0; ///< Number of bytes ever evicted from the buffer
+    EventNumber mLastEventNumber = 0; ///< The number of the newest event in the buffer, if it is not empty
 };
 
 class CircularEventReader;
@@ -127,6 +176,8 @@ class CircularEventBufferWrapper : public TLV::CHIPCircularTLVBuffer
 public:
     CircularEventBufferWrapper() : CHIPCircularTLVBuffer(nullptr, 0), mpCurrent(nullptr){};
     CircularEventBuffer * mpCurrent;
+    // Length to skip at the head of mpCurrent before handing data to the reader.
+    uint32_t mSkipLength = 0;
 
 private:
     CHIP_ERROR GetNextBuffer(chip::TLV::TLVReader & aReader, const uint8_t *& aBufStart, uint32_t & aBufLen) override;
@@ -386,8 +437,10 @@ private:
      *
      * @param[in] apEventBuffer  CircularEventBuffer
      *
+     * @param[in] aEventNumber   The number of the event at the head of apEventBuffer
+     *
      */
-    CHIP_ERROR CopyToNextBuffer(CircularEventBuffer * apEventBuffer);
+    CHIP_ERROR CopyToNextBuffer(CircularEventBuffer * apEventBuffer, EventNumber aEventNumber);
 
     /**
      * @brief eusure current buffer has enough space, if not, when current buffer is final destination of last tail's event
@@ -0,0 +1,258 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <app/FlatAttributeStore.h>
+
+#include <algorithm>
+#include <app/StatusResponse.h>
+#include <lib/support/CHIPMem.h>
+#include <string.h>
+
+namespace chip {
+namespace app {
+
+CHIP_ERROR FlatAttributeStore::SetData(const ConcreteAttributePath & path, TLV::TLVReader & data)
+{
+    TLV::TLVWriter writer;
+
+    if (!mEncodeBuffer)
+    {
+        VerifyOrReturnError(mEncodeBuffer.Alloc(kMaxSecureSduLengthBytes), CHIP_ERROR_NO_MEMORY);
+    }
+
+    writer.Init(mEncodeBuffer.Get(), kMaxSecureSduLengthBytes);
+    ReturnErrorOnFailure(writer.CopyElement(TLV::AnonymousTag(), data));
+    ReturnErrorOnFailure(writer.Finalize());
+
+    static_assert(kMaxSecureSduLengthBytes <= UINT16_MAX, "Entry::mLength is too small");
+    const uint16_t length = static_cast<uint16_t>(writer.GetLengthWritten());
+    Entry * entry         = Find(path);
+
+    //
+    // Only take new arena space if the encoded size changed, and before inserting the path, so that running out of memory
+    // leaves the store as it was.
+    //
+    if (entry == nullptr || entry->mLength != length)
+    {
+        uint8_t * buffer = Allocate(length);
+        VerifyOrReturnError(buffer != nullptr, CHIP_ERROR_NO_MEMORY);
+
+        if (entry == nullptr)
+        {
+            entry = &FindOrInsert(path);
+        }
+        else
+        {
+            ReleaseData(*entry);
+        }
+
+        entry->mData   = buffer;
+        entry->mLength = length;
+        mLiveBytes += length;
+    }
+
+    memcpy(entry->mData, mEncodeBuffer.Get(), length);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR FlatAttributeStore::SetStatus(const ConcreteAttributePath & path, const StatusIB & status)
+{
+    Entry & entry = FindOrInsert(path);
+
+    ReleaseData(entry);
+    entry.mStatus = status;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR FlatAttributeStore::GetData(const ConcreteAttributePath & path, TLV::TLVReader & reader) const
+{
+    const Entry * entry = Find(path);
+
+    VerifyOrReturnError(entry != nullptr, CHIP_ERROR_KEY_NOT_FOUND);
+    VerifyOrReturnError(entry->mLength != 0, CHIP_ERROR_IM_STATUS_CODE_RECEIVED);
+
+    reader.Init(entry->mData, entry->mLength);
+    return reader.Next();
+}
+
+CHIP_ERROR FlatAttributeStore::GetStatus(const ConcreteAttributePath & path, StatusIB & status) const
+{
+    const Entry * entry = Find(path);
+
+    VerifyOrReturnError(entry != nullptr, CHIP_ERROR_KEY_NOT_FOUND);
+    VerifyOrReturnError(entry->mLength == 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    status = entry->mStatus;
+    return CHIP_NO_ERROR;
+}
+
+bool FlatAttributeStore::HasEndpoint(EndpointId endpointId) const
+{
+    auto iter = LowerBound(ClusterKey(endpointId, 0), 0);
+    return iter != mEntries.end() && iter->mEndpointId == endpointId;
+}
+
+void FlatAttributeStore::Compact()
+{
+    if (mEntries.capacity() - mEntries.size() > mEntries.size() / 8)
+    {
+        mEntries.shrink_to_fit();
+    }
+
+    //
+    // Leave small amounts of dead space alone: moving every value costs more than it saves.
+    //
+    const size_t deadBytes = mUsedBytes - mLiveBytes;
+    if (deadBytes <= mLiveBytes || deadBytes < kArenaChunkSize)
+    {
+        return;
+    }
+
+    const uint32_t size = static_cast<uint32_t>(std::max<size_t>(mLiveBytes, kArenaChunkSize));
+    Chunk chunk         = { static_cast<uint8_t *>(Platform::MemoryAlloc(size)), size, 0 };
+    VerifyOrReturn(chunk.mBuffer != nullptr);
+
+    for (auto & entry : mEntries)
+    {
+        if (entry.mLength != 0)
+        {
+            memcpy(chunk.mBuffer + chunk.mUsed, entry.mData, entry.mLength);
+            entry.mData = chunk.mBuffer + chunk.mUsed;
+            chunk.mUsed += entry.mLength;
+        }
+    }
+
+    for (auto & oldChunk : mChunks)
+    {
+        Platform::MemoryFree(oldChunk.mBuffer);
+    }
+
+    mChunks.clear();
+    mChunks.push_back(chunk);
+    mUsedBytes = mLiveBytes;
+}
+
+void FlatAttributeStore::Clear()
+{
+    for (auto & chunk : mChunks)
+    {
+        Platform::MemoryFree(chunk.mBuffer);
+    }
+
+    mEntries.clear();
+    mChunks.clear();
+    mUsedBytes = 0;
+    mLiveBytes = 0;
+}
+
+size_t FlatAttributeStore::GetAllocatedBytes() const
+{
+    size_t bytes = mEntries.capacity() * sizeof(Entry) + mChunks.capacity() * sizeof(Chunk);
+
+    for (auto & chunk : mChunks)
+    {
+        bytes += chunk.mSize;
+    }
+
+    return bytes + (mEncodeBuffer ? kMaxSecureSduLengthBytes : 0);
+}
+
+std::vector<FlatAttributeStore::Entry>::const_iterator FlatAttributeStore::LowerBound(uint64_t clusterKey,
+                                                                                      AttributeId attributeId) const
+{
+    return std::lower_bound(mEntries.begin(), mEntries.end(), std::make_pair(clusterKey, attributeId),
+                            [](const Entry & entry, const std::pair<uint64_t, AttributeId> & key) {
+                                return ClusterKey(entry) < key.first ||
+                                    (ClusterKey(entry) == key.first && entry.mAttributeId < key.second);
+                            });
+}
+
+const FlatAttributeStore::Entry * FlatAttributeStore::Find(const ConcreteAttributePath & path) const
+{
+    const uint64_t clusterKey = ClusterKey(path.mEndpointId, path.mClusterId);
+    auto iter                 = LowerBound(clusterKey, path.mAttributeId);
+
+    if (iter == mEntries.end() || ClusterKey(*iter) != clusterKey || iter->mAttributeId != path.mAttributeId)
+    {
+        return nullptr;
+    }
+
+    return &*iter;
+}
+
+FlatAttributeStore::Entry & FlatAttributeStore::FindOrInsert(const ConcreteAttributePath & path)
+{
+    const uint64_t clusterKey = ClusterKey(path.mEndpointId, path.mClusterId);
+    const Entry newEntry      = { nullptr, path.mClusterId, path.mAttributeId, path.mEndpointId, 0, StatusIB() };
+
+    //
+    // Reports list attributes in path order, so priming the store mostly appends.
+    //
+    if (mEntries.empty() || ClusterKey(mEntries.back()) < clusterKey ||
+        (ClusterKey(mEntries.back()) == clusterKey && mEntries.back().mAttributeId < path.mAttributeId))
+    {
+        mEntries.push_back(newEntry);
+        return mEntries.back();
+    }
+
+    auto iter = LowerBound(clusterKey, path.mAttributeId);
+    if (iter != mEntries.end() && ClusterKey(*iter) == clusterKey && iter->mAttributeId == path.mAttributeId)
+    {
+        return mEntries[static_cast<size_t>(iter - mEntries.begin())];
+    }
+
+    return *mEntries.insert(iter, newEntry);
+}
+
+uint8_t * FlatAttributeStore::Allocate(uint16_t length)
+{
+    if (mChunks.empty() || mChunks.back().mSize - mChunks.back().mUsed < length)
+    {
+        //
+        // Values bigger than a chunk get a chunk of their own.  Whatever is left at the end of the previous chunk is lost
+        // until the next Compact().
+        //
+        const uint32_t size = std::max<uint32_t>(length, kArenaChunkSize);
+        Chunk chunk         = { static_cast<uint8_t *>(Platform::MemoryAlloc(size)), size, 0 };
+        VerifyOrReturnError(chunk.mBuffer != nullptr, nullptr);
+
+        if (!mChunks.empty())
+        {
+            mUsedBytes += mChunks.back().mSize - mChunks.back().mUsed;
+            mChunks.back().mUsed = mChunks.back().mSize;
+        }
+        mChunks.push_back(chunk);
+    }
+
+    Chunk & chunk    = mChunks.back();
+    uint8_t * buffer = chunk.mBuffer + chunk.mUsed;
+
+    chunk.mUsed += length;
+    mUsedBytes += length;
+    return buffer;
+}
+
+void FlatAttributeStore::ReleaseData(Entry & entry)
+{
+    mLiveBytes -= entry.mLength;
+    entry.mLength = 0;
+    entry.mData   = nullptr;
+}
+
+} // namespace app
+} // namespace chip
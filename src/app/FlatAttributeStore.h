@@ -0,0 +1,194 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <app/ConcreteAttributePath.h>
+#include <app/MessageDef/StatusIB.h>
+#include <lib/core/CHIPError.h>
+#include <lib/core/CHIPTLV.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/ScopedBuffer.h>
+#include <vector>
+
+namespace chip {
+namespace app {
+
+/*
+ * Stores the attribute data and statuses of a single node for the AttributeCache.
+ *
+ * Attributes are kept in one array sorted by endpoint, cluster and attribute ID, so that looking up a path is a binary search
+ * and the attributes of an endpoint or cluster are contiguous.  The TLV of the values is packed into a few large arena chunks
+ * owned by the store rather than allocated per attribute.  A value whose encoded size doesn't change is updated in place;
+ * otherwise it is written anew to the arena, and the space it used is reclaimed by Compact().
+ */
+class FlatAttributeStore
+{
+public:
+    static constexpr uint32_t kArenaChunkSize = 4096;
+
+    FlatAttributeStore() = default;
+    ~FlatAttributeStore() { Clear(); }
+
+    FlatAttributeStore(const FlatAttributeStore &) = delete;
+    FlatAttributeStore & operator=(const FlatAttributeStore &) = delete;
+
+    /*
+     * Store a copy of the element data is positioned on as the value of path, replacing any value or status it had.
+     */
+    CHIP_ERROR SetData(const ConcreteAttributePath & path, TLV::TLVReader & data);
+
+    /*
+     * Store status for path, replacing any value or status it had.
+     */
+    CHIP_ERROR SetStatus(const ConcreteAttributePath & path, const StatusIB & status);
+
+    /*
+     * Position reader on the value of path.  The value stays valid until path is updated or Compact() is called.
+     *
+     * Returns CHIP_ERROR_KEY_NOT_FOUND if path isn't in the store, and CHIP_ERROR_IM_STATUS_CODE_RECEIVED if it has a status
+     * rather than a value.
+     */
+    CHIP_ERROR GetData(const ConcreteAttributePath & path, TLV::TLVReader & reader) const;
+
+    /*
+     * Returns CHIP_ERROR_KEY_NOT_FOUND if path isn't in the store, and CHIP_ERROR_INVALID_ARGUMENT if it has a value rather
+     * than a status.
+     */
+    CHIP_ERROR GetStatus(const ConcreteAttributePath & path, StatusIB & status) const;
+
+    bool HasEndpoint(EndpointId endpointId) const;
+
+    /*
+     * Call func for every attribute of the given cluster instance.  Returns CHIP_ERROR_KEY_NOT_FOUND if the store has no
+     * attributes for it, or the first error func returns.
+     */
+    template <typename IteratorFunc>
+    CHIP_ERROR ForEachAttribute(EndpointId endpointId, ClusterId clusterId, IteratorFunc func) const
+    {
+        const uint64_t clusterKey = ClusterKey(endpointId, clusterId);
+        auto iter                 = LowerBound(clusterKey, 0);
+
+        VerifyOrReturnError(iter != mEntries.end() && ClusterKey(*iter) == clusterKey, CHIP_ERROR_KEY_NOT_FOUND);
+        for (; iter != mEntries.end() && ClusterKey(*iter) == clusterKey; ++iter)
+        {
+            ReturnErrorOnFailure(func(ConcreteAttributePath(endpointId, clusterId, iter->mAttributeId)));
+        }
+
+        return CHIP_NO_ERROR;
+    }
+
+    /*
+     * Call func for every attribute of the given cluster on all endpoints.  Returns the first error func returns.
+     */
+    template <typename IteratorFunc>
+    CHIP_ERROR ForEachAttribute(ClusterId clusterId, IteratorFunc func) const
+    {
+        for (auto & entry : mEntries)
+        {
+            if (entry.mClusterId == clusterId)
+            {
+                ReturnErrorOnFailure(func(ConcreteAttributePath(entry.mEndpointId, clusterId, entry.mAttributeId)));
+            }
+        }
+
+        return CHIP_NO_ERROR;
+    }
+
+    /*
+     * Call func once for every cluster on the given endpoint.  Returns the first error func returns.
+     */
+    template <typename IteratorFunc>
+    CHIP_ERROR ForEachCluster(EndpointId endpointId, IteratorFunc func) const
+    {
+        for (auto iter = LowerBound(ClusterKey(endpointId, 0), 0); iter != mEntries.end() && iter->mEndpointId == endpointId;
+             ++iter)
+        {
+            if (iter == mEntries.begin() || ClusterKey(*(iter - 1)) != ClusterKey(*iter))
+            {
+                ReturnErrorOnFailure(func(iter->mClusterId));
+            }
+        }
+
+        return CHIP_NO_ERROR;
+    }
+
+    /*
+     * Move the values into fresh arena space if the space left behind by updates outgrows them, invalidating any reader
+     * positioned on a value.  Also gives back the spare capacity of the attribute array.
+     */
+    void Compact();
+
+    void Clear();
+
+    size_t GetAttributeCount() const { return mEntries.size(); }
+
+    /*
+     * Returns the number of bytes the store has allocated, for the attribute array, the arena and the encoding buffer.
+     */
+    size_t GetAllocatedBytes() const;
+
+private:
+    // Laid out to take 24 bytes on 64-bit targets.
+    struct Entry
+    {
+        uint8_t * mData;
+        ClusterId mClusterId;
+        AttributeId mAttributeId;
+        EndpointId mEndpointId;
+        // 0 when the attribute has a status rather than a value.
+        uint16_t mLength;
+        StatusIB mStatus;
+    };
+
+    struct Chunk
+    {
+        uint8_t * mBuffer;
+        uint32_t mSize;
+        uint32_t mUsed;
+    };
+
+    // Packs the endpoint and cluster IDs so that comparing keys orders by endpoint, then cluster.
+    static uint64_t ClusterKey(EndpointId endpointId, ClusterId clusterId)
+    {
+        return (static_cast<uint64_t>(endpointId) << 32) | clusterId;
+    }
+    static uint64_t ClusterKey(const Entry & entry) { return ClusterKey(entry.mEndpointId, entry.mClusterId); }
+
+    std::vector<Entry>::const_iterator LowerBound(uint64_t clusterKey, AttributeId attributeId) const;
+    const Entry * Find(const ConcreteAttributePath & path) const;
+    Entry * Find(const ConcreteAttributePath & path)
+    {
+        return const_cast<Entry *>(static_cast<const FlatAttributeStore *>(this)->Find(path));
+    }
+    Entry & FindOrInsert(const ConcreteAttributePath & path);
+
+    uint8_t * Allocate(uint16_t length);
+    void ReleaseData(Entry & entry);
+
+    // Sorted by endpoint, cluster and attribute ID.
+    std::vector<Entry> mEntries;
+    std::vector<Chunk> mChunks;
+    // Bytes of the chunks handed out to values, and the part of them still in use.
+    size_t mUsedBytes = 0;
+    size_t mLiveBytes = 0;
+    Platform::ScopedMemoryBuffer<uint8_t> mEncodeBuffer;
+};
+
+} // namespace app
+} // namespace chip
@@ -120,6 +120,7 @@ void InteractionModelEngine::Shutdown()
     mReportingEngine.Shutdown();
 
     mClusterInfoPool.ReleaseAll();
+    mDataVersionFilterPool.ReleaseAll();
 
     mpExchangeMgr->UnregisterUnsolicitedMessageHandlerForProtocol(Protocols::InteractionModel::Id);
 }
@@ -474,25 +475,29 @@ bool InteractionModelEngine::InActiveReadClientList(ReadClient * apReadClient)
     return false;
 }
 
-void InteractionModelEngine::ReleaseClusterInfoList(ClusterInfo *& aClusterInfo)
+namespace {
+
+template <size_t N>
+void ReleaseList(ClusterInfo *& aClusterInfoList, BitMapObjectPool<ClusterInfo, N> & aClusterInfoPool)
 {
-    ClusterInfo * current = aClusterInfo;
+    ClusterInfo * current = aClusterInfoList;
     while (current != nullptr)
     {
         ClusterInfo * next = current->mpNext;
-        mClusterInfoPool.ReleaseObject(current);
+        aClusterInfoPool.ReleaseObject(current);
         current = next;
     }
 
-    aClusterInfo = nullptr;
+    aClusterInfoList = nullptr;
 }
 
-CHIP_ERROR InteractionModelEngine::PushFront(ClusterInfo *& aClusterInfoList, ClusterInfo & aClusterInfo)
+template <size_t N>
+CHIP_ERROR PushFrontToList(ClusterInfo *& aClusterInfoList, ClusterInfo & aClusterInfo,
+                           BitMapObjectPool<ClusterInfo, N> & aClusterInfoPool)
 {
-    ClusterInfo * clusterInfo = mClusterInfoPool.CreateObject();
+    ClusterInfo * clusterInfo = aClusterInfoPool.CreateObject();
     if (clusterInfo == nullptr)
     {
-        ChipLogError(InteractionModel, "ClusterInfo pool full, cannot handle more entries!");
         return CHIP_ERROR_NO_MEMORY;
     }
     *clusterInfo        = aClusterInfo;
@@ -501,6 +506,34 @@ CHIP_ERROR InteractionModelEngine::PushFront(ClusterInfo *& aClusterInfoList, Cl
     return CHIP_NO_ERROR;
 }
 
+} // namespace
+
+void InteractionModelEngine::ReleaseClusterInfoList(ClusterInfo *& aClusterInfo)
+{
+    ReleaseList(aClusterInfo, mClusterInfoPool);
+}
+
+CHIP_ERROR InteractionModelEngine::PushFront(ClusterInfo *& aClusterInfoList, ClusterInfo & aClusterInfo)
+{
+    CHIP_ERROR err = PushFrontToList(aClusterInfoList, aClusterInfo, mClusterInfoPool);
+    if (err == CHIP_ERROR_NO_MEMORY)
+    {
+        ChipLogError(InteractionModel, "ClusterInfo pool full, cannot handle more entries!");
+    }
+    return err;
+}
+
+void InteractionModelEngine::ReleaseDataVersionFilterList(ClusterInfo *& aDataVersionFilterList)
+{
+    ReleaseList(aDataVersionFilterList, mDataVersionFilterPool);
+}
+
+CHIP_ERROR InteractionModelEngine::PushFrontDataVersionFilterList(ClusterInfo *& aDataVersionFilterList,
+                                                                  ClusterInfo & aDataVersionFilter)
+{
+    return PushFrontToList(aDataVersionFilterList, aDataVersionFilter, mDataVersionFilterPool);
+}
+
 bool InteractionModelEngine::IsOverlappedAttributePath(ClusterInfo & aAttributePath)
 {
     for (auto & handler : mReadHandlers)
@@ -45,6 +45,7 @@
 #include <app/CommandHandlerInterface.h>
 #include <app/CommandSender.h>
 #include <app/ConcreteAttributePath.h>
+#include <app/ConcreteClusterPath.h>
 #include <app/ConcreteCommandPath.h>
 #include <app/InteractionModelDelegate.h>
 #include <app/ReadClient.h>
@@ -125,6 +126,8 @@ public:
 
     void ReleaseClusterInfoList(ClusterInfo *& aClusterInfo);
     CHIP_ERROR PushFront(ClusterInfo *& aClusterInfoLisst, ClusterInfo & aClusterInfo);
+    void ReleaseDataVersionFilterList(ClusterInfo *& aDataVersionFilterList);
+    CHIP_ERROR PushFrontDataVersionFilterList(ClusterInfo *& aDataVersionFilterList, ClusterInfo & aDataVersionFilter);
     bool IsOverlappedAttributePath(ClusterInfo & aAttributePath);
 
     CHIP_ERROR RegisterCommandHandler(CommandHandlerInterface * handler);
@@ -246,6 +249,7 @@ private:
     WriteHandler mWriteHandlers[CHIP_IM_MAX_NUM_WRITE_HANDLER];
     reporting::Engine mReportingEngine;
     BitMapObjectPool<ClusterInfo, CHIP_IM_SERVER_MAX_NUM_PATH_GROUPS> mClusterInfoPool;
+    BitMapObjectPool<ClusterInfo, CHIP_IM_SERVER_MAX_NUM_DATA_VERSION_FILTERS> mDataVersionFilterPool;
 
     ReadClient * mpActiveReadClientList = nullptr;
 
@@ -286,17 +290,29 @@ bool ServerClusterCommandExists(const ConcreteCommandPath & aCommandPath);
  *  @param[in]    aSubjectDescriptor    The subject descriptor for the read.
  *  @param[in]    aPath                 The concrete path of the data being read.
  *  @param[in]    aAttributeReports      The TLV Builder for Cluter attribute builder.
+ *  @param[in]    apAccessCheckResult   The result of the access control check of aSubjectDescriptor for the read when the
+ *                                      caller has already made it, or nullptr to have the check made here.
  *
  *  @retval  CHIP_NO_ERROR on success
  */
 CHIP_ERROR ReadSingleClusterData(const Access::SubjectDescriptor & aSubjectDescriptor, bool aIsFabricFiltered,
                                  const ConcreteReadAttributePath & aPath, AttributeReportIBs::Builder & aAttributeReports,
-                                 AttributeValueEncoder::AttributeEncodeState * apEncoderState);
+                                 AttributeValueEncoder::AttributeEncodeState * apEncoderState,
+                                 const CHIP_ERROR * apAccessCheckResult = nullptr);
 
 /**
  * TODO: Document.
  */
 CHIP_ERROR WriteSingleClusterData(const Access::SubjectDescriptor & aSubjectDescriptor, ClusterInfo & aClusterInfo,
                                   TLV::TLVReader & aReader, WriteHandler * apWriteHandler);
+
+/**
+ *  Check whether the current data version of the given cluster instance is aRequiredVersion, which lets a read or subscribe
+ * request with a matching DataVersionFilter skip the attributes of that cluster.
+ *  This function is implemented by CHIP as a part of cluster data storage & management.
+ *
+ *  @retval  True if the cluster instance exists and is at aRequiredVersion, false otherwise.
+ */
+bool IsClusterDataVersionEqual(const ConcreteClusterPath & aConcreteClusterPath, DataVersion aRequiredVersion);
 } // namespace app
 } // namespace chip
@@ -138,5 +138,18 @@ DataVersionFilterIB::Builder & DataVersionFilterIB::Builder::EndOfDataVersionFil
     EndOfContainer();
     return *this;
 }
+
+CHIP_ERROR DataVersionFilterIB::Builder::Encode(const DataVersionFilter & aDataVersionFilter)
+{
+    VerifyOrReturnError(aDataVersionFilter.IsValidDataVersionFilter(), CHIP_ERROR_INVALID_ARGUMENT);
+
+    ClusterPathIB::Builder & path = CreatePath();
+    ReturnErrorOnFailure(GetError());
+    ReturnErrorOnFailure(path.Endpoint(aDataVersionFilter.mEndpointId)
+                             .Cluster(aDataVersionFilter.mClusterId)
+                             .EndOfClusterPathIB()
+                             .GetError());
+    return DataVersion(aDataVersionFilter.mDataVersion.Value()).EndOfDataVersionFilterIB().GetError();
+}
 } // namespace app
 } // namespace chip
@@ -21,6 +21,7 @@
 #include "StructBuilder.h"
 #include "StructParser.h"
 #include <app/AppBuildConfig.h>
+#include <app/DataVersionFilter.h>
 #include <app/util/basic-types.h>
 #include <lib/core/CHIPCore.h>
 #include <lib/core/CHIPTLV.h>
@@ -106,6 +107,11 @@ public:
      */
     DataVersionFilterIB::Builder & EndOfDataVersionFilterIB();
 
+    /**
+     *  @brief Encode a complete DataVersionFilterIB for the given filter, which must be valid.
+     */
+    CHIP_ERROR Encode(const DataVersionFilter & aDataVersionFilter);
+
 private:
     ClusterPathIB::Builder mPath;
 };
@@ -81,5 +81,24 @@ DataVersionFilterIBs::Builder & DataVersionFilterIBs::Builder::EndOfDataVersionF
     EndOfContainer();
     return *this;
 }
+
+CHIP_ERROR DataVersionFilterIBs::Builder::EncodeDataVersionFilterIB(const DataVersionFilter & aDataVersionFilter)
+{
+    TLV::TLVWriter backup;
+    Checkpoint(backup);
+
+    DataVersionFilterIB::Builder & filter = CreateDataVersionFilter();
+    CHIP_ERROR err                        = GetError();
+    if (err == CHIP_NO_ERROR)
+    {
+        err = filter.Encode(aDataVersionFilter);
+    }
+    if (err == CHIP_ERROR_NO_MEMORY || err == CHIP_ERROR_BUFFER_TOO_SMALL)
+    {
+        Rollback(backup);
+        ResetError();
+    }
+    return err;
+}
 } // namespace app
 } // namespace chip
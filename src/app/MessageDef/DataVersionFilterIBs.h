@@ -74,6 +74,14 @@ public:
      */
     DataVersionFilterIBs::Builder & EndOfDataVersionFilterIBs();
 
+    /**
+     *  @brief Encode a DataVersionFilterIB for the given filter.  A filter that does not fit is left out entirely, so that
+     *  the list can still be closed out.
+     *
+     *  @return CHIP_ERROR_NO_MEMORY or CHIP_ERROR_BUFFER_TOO_SMALL if the filter did not fit
+     */
+    CHIP_ERROR EncodeDataVersionFilterIB(const DataVersionFilter & aDataVersionFilter);
+
 private:
     DataVersionFilterIB::Builder mDataVersionFilter;
 };
@@ -147,8 +147,26 @@ bool OperationalDeviceProxy::GetAddress(Inet::IPAddress & addr, uint16_t & port)
 
 CHIP_ERROR OperationalDeviceProxy::EstablishConnection()
 {
-    mCASEClient = mInitParams.clientPool->Allocate(CASEClientInitParams{
-        mInitParams.sessionManager, mInitParams.exchangeMgr, mInitParams.idAllocator, mFabricInfo, mInitParams.mrpLocalConfig });
+    if (mInitParams.handshakeLimiter != nullptr && !mInitParams.handshakeLimiter->Acquire(*this))
+    {
+        // The handshake starts with StartQueuedHandshake once the limiter has a free slot.
+        mState = State::Connecting;
+        return CHIP_NO_ERROR;
+    }
+
+    CHIP_ERROR err = StartHandshake();
+    if (err != CHIP_NO_ERROR)
+    {
+        CloseCASESession();
+    }
+    return err;
+}
+
+CHIP_ERROR OperationalDeviceProxy::StartHandshake()
+{
+    mCASEClient = mInitParams.clientPool->Allocate(CASEClientInitParams{ mInitParams.sessionManager, mInitParams.exchangeMgr,
+                                                                         mInitParams.idAllocator, mFabricInfo,
+                                                                         mInitParams.mrpLocalConfig, mInitParams.cryptoOffload });
     ReturnErrorCodeIf(mCASEClient == nullptr, CHIP_ERROR_NO_MEMORY);
     CHIP_ERROR err =
         mCASEClient->EstablishSession(mPeerId, mDeviceAddress, mMRPConfig, HandleCASEConnected, HandleCASEConnectionFailure, this);
@@ -159,6 +177,23 @@ CHIP_ERROR OperationalDeviceProxy::EstablishConnection()
     return CHIP_NO_ERROR;
 }
 
+void OperationalDeviceProxy::StartQueuedHandshake()
+{
+    CHIP_ERROR err = StartHandshake();
+    if (err != CHIP_NO_ERROR)
+    {
+        HandleCASEConnectionFailure(this, mCASEClient, err);
+    }
+}
+
+void OperationalDeviceProxy::ReleaseHandshakeSlot()
+{
+    if (mInitParams.handshakeLimiter != nullptr)
+    {
+        mInitParams.handshakeLimiter->Release(*this);
+    }
+}
+
 void OperationalDeviceProxy::EnqueueConnectionCallbacks(Callback::Callback<OnDeviceConnected> * onConnection,
                                                         Callback::Callback<OnDeviceConnectionFailure> * onFailure)
 {
@@ -250,11 +285,7 @@ CHIP_ERROR OperationalDeviceProxy::Disconnect()
         mInitParams.sessionManager->ExpirePairing(mSecureSession.Get());
     }
     mState = State::Initialized;
-    if (mCASEClient)
-    {
-        mInitParams.clientPool->Release(mCASEClient);
-        mCASEClient = nullptr;
-    }
+    CloseCASESession();
     return CHIP_NO_ERROR;
 }
 
@@ -266,11 +297,7 @@ void OperationalDeviceProxy::SetConnectedSession(const SessionHandle & handle)
 
 void OperationalDeviceProxy::Clear()
 {
-    if (mCASEClient)
-    {
-        mInitParams.clientPool->Release(mCASEClient);
-        mCASEClient = nullptr;
-    }
+    CloseCASESession();
 
     mState      = State::Uninitialized;
     mInitParams = DeviceProxyInitParams();
@@ -283,6 +310,8 @@ void OperationalDeviceProxy::CloseCASESession()
         mInitParams.clientPool->Release(mCASEClient);
         mCASEClient = nullptr;
     }
+
+    ReleaseHandshakeSlot();
 }
 
 void OperationalDeviceProxy::OnSessionReleased()
@@ -295,6 +324,9 @@ CHIP_ERROR OperationalDeviceProxy::ShutdownSubscriptions()
     return app::InteractionModelEngine::GetInstance()->ShutdownSubscriptions(mFabricInfo->GetFabricIndex(), GetDeviceId());
 }
 
-OperationalDeviceProxy::~OperationalDeviceProxy() {}
+OperationalDeviceProxy::~OperationalDeviceProxy()
+{
+    ReleaseHandshakeSlot();
+}
 
 } // namespace chip
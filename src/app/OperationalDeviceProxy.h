@@ -28,6 +28,7 @@
 
 #include <app/CASEClient.h>
 #include <app/CASEClientPool.h>
+#include <app/CASEHandshakeLimiter.h>
 #include <app/DeviceProxy.h>
 #include <app/util/attribute-filter.h>
 #include <app/util/basic-types.h>
@@ -35,6 +36,7 @@
 #include <messaging/ExchangeDelegate.h>
 #include <messaging/ExchangeMgr.h>
 #include <messaging/Flags.h>
+#include <protocols/secure_channel/CASECryptoOffload.h>
 #include <protocols/secure_channel/CASESession.h>
 #include <protocols/secure_channel/SessionIDAllocator.h>
 #include <system/SystemLayer.h>
@@ -59,6 +61,11 @@ struct DeviceProxyInitParams
 
     Optional<ReliableMessageProtocolConfig> mrpLocalConfig = Optional<ReliableMessageProtocolConfig>::Missing();
 
+    // Optional: runs the expensive steps of CASE handshakes off the event loop.
+    CASECryptoOffload * cryptoOffload = nullptr;
+    // Optional: limits how many CASE handshakes run at once.
+    CASEHandshakeLimiter * handshakeLimiter = nullptr;
+
     CHIP_ERROR Validate() const
     {
         ReturnErrorCodeIf(sessionManager == nullptr, CHIP_ERROR_INCORRECT_STATE);
@@ -198,6 +205,8 @@ public:
     }
 
 private:
+    friend class CASEHandshakeLimiter;
+
     enum class State
     {
         Uninitialized,
@@ -226,7 +235,14 @@ private:
     Callback::CallbackDeque mConnectionSuccess;
     Callback::CallbackDeque mConnectionFailure;
 
+    // Managed by mInitParams.handshakeLimiter.
+    CASEHandshakeLimiter::Slot mHandshakeSlot         = CASEHandshakeLimiter::Slot::kNone;
+    OperationalDeviceProxy * mNextWaitingForHandshake = nullptr;
+
     CHIP_ERROR EstablishConnection();
+    CHIP_ERROR StartHandshake();
+    void StartQueuedHandshake();
+    void ReleaseHandshakeSlot();
 
     bool IsSecureConnected() const override { return mState == State::SecureConnected; }
 
@@ -178,6 +178,8 @@ CHIP_ERROR ReadClient::SendReadRequest(ReadPrepareParams & aReadPrepareParams)
             }
         }
 
+        ReturnErrorOnFailure(GenerateDataVersionFilters(request, aReadPrepareParams));
+
         ReturnErrorOnFailure(request.IsFabricFiltered(aReadPrepareParams.mIsFabricFiltered).EndOfReadRequestMessage().GetError());
         ReturnErrorOnFailure(writer.Finalize(&msgBuf));
     }
@@ -229,6 +231,89 @@ CHIP_ERROR ReadClient::GenerateAttributePathList(AttributePathIBs::Builder & aAt
     return aAttributePathIBsBuilder.GetError();
 }
 
+CHIP_ERROR ReadClient::GenerateDataVersionFilterList(DataVersionFilterIBs::Builder & aDataVersionFilterIBsBuilder,
+                                                     const Span<AttributePathParams> & aAttributePaths,
+                                                     const Span<DataVersionFilter> & aDataVersionFilters,
+                                                     bool & aEncodedDataVersionList)
+{
+    if (aDataVersionFilters.empty())
+    {
+        return mpCallback.OnUpdateDataVersionFilterList(aDataVersionFilterIBsBuilder, aAttributePaths, aEncodedDataVersionList);
+    }
+
+    aEncodedDataVersionList = false;
+    for (auto & filter : aDataVersionFilters)
+    {
+        VerifyOrReturnError(filter.IsValidDataVersionFilter(), CHIP_ERROR_INVALID_ARGUMENT);
+
+        // The server ignores the filters of the clusters that none of the paths cover; do not spend bytes on them.
+        bool intersected = false;
+        for (auto & path : aAttributePaths)
+        {
+            if (path.IsClusterPathSupersetOf(ConcreteClusterPath(filter.mEndpointId, filter.mClusterId)))
+            {
+                intersected = true;
+                break;
+            }
+        }
+        if (!intersected)
+        {
+            continue;
+        }
+
+        CHIP_ERROR err = aDataVersionFilterIBsBuilder.EncodeDataVersionFilterIB(filter);
+        if (err == CHIP_ERROR_NO_MEMORY || err == CHIP_ERROR_BUFFER_TOO_SMALL)
+        {
+            // The request is full; send it with the filters that fit.
+            break;
+        }
+        ReturnErrorOnFailure(err);
+        aEncodedDataVersionList = true;
+    }
+    return CHIP_NO_ERROR;
+}
+
+template <typename RequestBuilder>
+CHIP_ERROR ReadClient::GenerateDataVersionFilters(RequestBuilder & aRequest, ReadPrepareParams & aReadPrepareParams)
+{
+    // Keep room for closing out the filter list, the IsFabricFiltered flag and the request itself.
+    const uint32_t kReservedSizeForEndOfRequest = 4;
+
+    if (aReadPrepareParams.mAttributePathParamsListSize == 0 || aReadPrepareParams.mpAttributePathParamsList == nullptr)
+    {
+        return CHIP_NO_ERROR;
+    }
+
+    Span<AttributePathParams> attributePaths(aReadPrepareParams.mpAttributePathParamsList,
+                                             aReadPrepareParams.mAttributePathParamsListSize);
+    Span<DataVersionFilter> dataVersionFilters;
+    if (aReadPrepareParams.mpDataVersionFilterList != nullptr)
+    {
+        dataVersionFilters = Span<DataVersionFilter>(aReadPrepareParams.mpDataVersionFilterList,
+                                                     aReadPrepareParams.mDataVersionFilterListSize);
+    }
+
+    TLV::TLVWriter backup;
+    bool encodedDataVersionList = false;
+    aRequest.Checkpoint(backup);
+
+    DataVersionFilterIBs::Builder & dataVersionFilterListBuilder = aRequest.CreateDataVersionFilters();
+    ReturnErrorOnFailure(aRequest.GetError());
+    ReturnErrorOnFailure(dataVersionFilterListBuilder.GetWriter()->ReserveBuffer(kReservedSizeForEndOfRequest));
+    ReturnErrorOnFailure(
+        GenerateDataVersionFilterList(dataVersionFilterListBuilder, attributePaths, dataVersionFilters, encodedDataVersionList));
+    ReturnErrorOnFailure(dataVersionFilterListBuilder.GetWriter()->UnreserveBuffer(kReservedSizeForEndOfRequest));
+
+    if (!encodedDataVersionList)
+    {
+        // An empty filter list is allowed, but there is no point sending it.
+        aRequest.Rollback(backup);
+        return CHIP_NO_ERROR;
+    }
+
+    return dataVersionFilterListBuilder.EndOfDataVersionFilterIBs().GetError();
+}
+
 CHIP_ERROR ReadClient::OnMessageReceived(Messaging::ExchangeContext * apExchangeContext, const PayloadHeader & aPayloadHeader,
                                          System::PacketBufferHandle && aPayload)
 {
@@ -515,9 +600,14 @@ CHIP_ERROR ReadClient::ProcessAttributeReportIBs(TLV::TLVReader & aAttributeRepo
         }
         else if (CHIP_END_OF_TLV == err)
         {
+            DataVersion version = 0;
             ReturnErrorOnFailure(report.GetAttributeData(&data));
             ReturnErrorOnFailure(data.GetPath(&path));
             ReturnErrorOnFailure(ProcessAttributePath(path, attributePath));
+            if (data.GetDataVersion(&version) == CHIP_NO_ERROR)
+            {
+                attributePath.mDataVersion.SetValue(version);
+            }
             ReturnErrorOnFailure(data.GetData(&dataReader));
 
             // The element in an array may be another array -- so we should only set the list operation when we are handling the
@@ -698,6 +788,8 @@ CHIP_ERROR ReadClient::SendSubscribeRequest(ReadPrepareParams & aReadPreparePara
         ReturnErrorOnFailure(err = eventFilters.GetError());
     }
 
+    ReturnErrorOnFailure(err = GenerateDataVersionFilters(request, aReadPrepareParams));
+
     request.IsFabricFiltered(aReadPrepareParams.mIsFabricFiltered).EndOfSubscribeRequestMessage();
     ReturnErrorOnFailure(err = request.GetError());
 
@@ -25,6 +25,7 @@
 #pragma once
 #include <app/AttributePathParams.h>
 #include <app/ConcreteAttributePath.h>
+#include <app/DataVersionFilter.h>
 #include <app/EventHeader.h>
 #include <app/EventPathParams.h>
 #include <app/InteractionModelDelegate.h>
@@ -38,6 +39,7 @@
 #include <lib/core/CHIPTLVDebug.hpp>
 #include <lib/support/CodeUtils.h>
 #include <lib/support/DLLUtil.h>
+#include <lib/support/Span.h>
 #include <lib/support/logging/CHIPLogging.h>
 #include <messaging/ExchangeContext.h>
 #include <messaging/ExchangeMgr.h>
@@ -132,6 +134,25 @@ public:
          */
         virtual void OnSubscriptionEstablished(const ReadClient * apReadClient) {}
 
+        /**
+         * OnUpdateDataVersionFilterList will be called when a read or subscribe request carries no explicit data version
+         * filters, to let the callback add filters for the clusters it already holds data for.  The server then leaves the
+         * attributes of the clusters that are still at the filtered version out of its priming report.
+         *
+         * The filters that do not fit in the request may be left out: every filter only saves bytes on the reports.
+         *
+         * @param[in]  aDataVersionFilterIBsBuilder The builder for the DataVersionFilterIBs of the request.
+         * @param[in]  aAttributePaths              The attribute paths of the request.
+         * @param[out] aEncodedDataVersionList      Set to true if at least one filter was encoded.
+         */
+        virtual CHIP_ERROR OnUpdateDataVersionFilterList(DataVersionFilterIBs::Builder & aDataVersionFilterIBsBuilder,
+                                                         const Span<AttributePathParams> & aAttributePaths,
+                                                         bool & aEncodedDataVersionList)
+        {
+            aEncodedDataVersionList = false;
+            return CHIP_NO_ERROR;
+        }
+
         /**
          * OnError will be called when an error occurs *after* a successful call to SendRequest(). The following
          * errors will be delivered through this call in the aError field:
@@ -271,6 +292,11 @@ private:
                                   size_t aEventPathParamsListSize);
     CHIP_ERROR GenerateAttributePathList(AttributePathIBs::Builder & aAttributePathIBsBuilder,
                                          AttributePathParams * apAttributePathParamsList, size_t aAttributePathParamsListSize);
+    CHIP_ERROR GenerateDataVersionFilterList(DataVersionFilterIBs::Builder & aDataVersionFilterIBsBuilder,
+                                             const Span<AttributePathParams> & aAttributePaths,
+                                             const Span<DataVersionFilter> & aDataVersionFilters, bool & aEncodedDataVersionList);
+    template <typename RequestBuilder>
+    CHIP_ERROR GenerateDataVersionFilters(RequestBuilder & aRequest, ReadPrepareParams & aReadPrepareParams);
     CHIP_ERROR ProcessAttributeReportIBs(TLV::TLVReader & aAttributeDataIBsReader);
     CHIP_ERROR ProcessEventReportIBs(TLV::TLVReader & aEventReportIBsReader);
 
@@ -31,6 +31,7 @@
 
 #include <app/ReadHandler.h>
 #include <app/reporting/Engine.h>
+#include <trace/trace.h>
 
 namespace chip {
 namespace app {
@@ -46,6 +47,7 @@ CHIP_ERROR ReadHandler::Init(Messaging::ExchangeManager * apExchangeMgr, Interac
     mSuppressResponse          = true;
     mpAttributeClusterInfoList = nullptr;
     mpEventClusterInfoList     = nullptr;
+    mpDataVersionFilterList    = nullptr;
     mCurrentPriority           = PriorityLevel::Invalid;
     mEventMin                  = 0;
     mLastScheduledEventNumber  = 0;
@@ -95,8 +97,10 @@ void ReadHandler::Shutdown(ShutdownOptions aOptions)
     {
         InteractionModelEngine::GetInstance()->GetReportingEngine().OnReportConfirm();
     }
+    InteractionModelEngine::GetInstance()->GetReportingEngine().UnregisterReadHandlerPaths(*this);
     InteractionModelEngine::GetInstance()->ReleaseClusterInfoList(mpAttributeClusterInfoList);
     InteractionModelEngine::GetInstance()->ReleaseClusterInfoList(mpEventClusterInfoList);
+    InteractionModelEngine::GetInstance()->ReleaseDataVersionFilterList(mpDataVersionFilterList);
     mSubscriptionId            = 0;
     mMinIntervalFloorSeconds   = 0;
     mMaxIntervalCeilingSeconds = 0;
@@ -105,6 +109,7 @@ void ReadHandler::Shutdown(ShutdownOptions aOptions)
     MoveToState(HandlerState::Uninitialized);
     mpAttributeClusterInfoList = nullptr;
     mpEventClusterInfoList     = nullptr;
+    mpDataVersionFilterList    = nullptr;
     mCurrentPriority           = PriorityLevel::Invalid;
     mEventMin                  = 0;
     mLastScheduledEventNumber  = 0;
@@ -274,6 +279,7 @@ void ReadHandler::OnResponseTimeout(Messaging::ExchangeContext * apExchangeConte
 
 CHIP_ERROR ReadHandler::ProcessReadRequest(System::PacketBufferHandle && aPayload)
 {
+    TRACE_EVENT_SCOPE("ProcessReadRequest", "ReadHandler");
     CHIP_ERROR err = CHIP_NO_ERROR;
     System::PacketBufferTLVReader reader;
 
@@ -281,6 +287,7 @@ CHIP_ERROR ReadHandler::ProcessReadRequest(System::PacketBufferHandle && aPayloa
     EventPathIBs::Parser eventPathListParser;
     EventFilterIBs::Parser eventFilterIBsParser;
     AttributePathIBs::Parser attributePathListParser;
+    DataVersionFilterIBs::Parser dataVersionFilterListParser;
 
     reader.Init(std::move(aPayload));
 
@@ -298,6 +305,15 @@ CHIP_ERROR ReadHandler::ProcessReadRequest(System::PacketBufferHandle && aPayloa
     else if (err == CHIP_NO_ERROR)
     {
         ReturnErrorOnFailure(ProcessAttributePathList(attributePathListParser));
+        err = readRequestParser.GetDataVersionFilters(&dataVersionFilterListParser);
+        if (err == CHIP_END_OF_TLV)
+        {
+            err = CHIP_NO_ERROR;
+        }
+        else if (err == CHIP_NO_ERROR)
+        {
+            ReturnErrorOnFailure(ProcessDataVersionFilterList(dataVersionFilterListParser));
+        }
     }
     ReturnErrorOnFailure(err);
     err = readRequestParser.GetEventRequests(&eventPathListParser);
@@ -408,13 +424,62 @@ CHIP_ERROR ReadHandler::ProcessAttributePathList(AttributePathIBs::Parser & aAtt
     if (CHIP_END_OF_TLV == err)
     {
         mAttributePathExpandIterator = AttributePathExpandIterator(mpAttributeClusterInfoList);
-        err                          = CHIP_NO_ERROR;
+        err = InteractionModelEngine::GetInstance()->GetReportingEngine().RegisterReadHandlerPaths(*this);
     }
 
 exit:
     return err;
 }
 
+CHIP_ERROR ReadHandler::ProcessDataVersionFilterList(DataVersionFilterIBs::Parser & aDataVersionFilterListParser)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    TLV::TLVReader reader;
+    size_t filterCount = 0;
+    aDataVersionFilterListParser.GetReader(&reader);
+
+    while (CHIP_NO_ERROR == (err = reader.Next()))
+    {
+        VerifyOrReturnError(TLV::AnonymousTag() == reader.GetTag(), CHIP_ERROR_INVALID_TLV_TAG);
+        if (filterCount == CHIP_IM_SERVER_MAX_NUM_DATA_VERSION_FILTERS_PER_HANDLER)
+        {
+            ChipLogProgress(DataManagement, "Too many data version filters, reporting the remaining clusters in full");
+            return CHIP_NO_ERROR;
+        }
+
+        ClusterInfo clusterInfo;
+        ClusterPathIB::Parser path;
+        DataVersionFilterIB::Parser filter;
+        DataVersion version = 0;
+        ReturnErrorOnFailure(filter.Init(reader));
+        ReturnErrorOnFailure(filter.GetPath(&path));
+        ReturnErrorOnFailure(path.GetEndpoint(&(clusterInfo.mEndpointId)));
+        ReturnErrorOnFailure(path.GetCluster(&(clusterInfo.mClusterId)));
+        ReturnErrorOnFailure(filter.GetDataVersion(&version));
+        clusterInfo.mDataVersion.SetValue(version);
+
+        // A filter only ever saves bytes, so ignore the ones we cannot use rather than failing the request.
+        if (!clusterInfo.IsValidDataVersionFilter())
+        {
+            continue;
+        }
+        if (InteractionModelEngine::GetInstance()->PushFrontDataVersionFilterList(mpDataVersionFilterList, clusterInfo) !=
+            CHIP_NO_ERROR)
+        {
+            ChipLogProgress(DataManagement, "Data version filter pool full, reporting the remaining clusters in full");
+            return CHIP_NO_ERROR;
+        }
+        filterCount++;
+    }
+
+    // if we have exhausted this container
+    if (CHIP_END_OF_TLV == err)
+    {
+        err = CHIP_NO_ERROR;
+    }
+    return err;
+}
+
 CHIP_ERROR ReadHandler::ProcessEventPaths(EventPathIBs::Parser & aEventPathsParser)
 {
     CHIP_ERROR err = CHIP_NO_ERROR;
@@ -563,6 +628,8 @@ CHIP_ERROR ReadHandler::SendSubscribeResponse()
 
     ReturnErrorOnFailure(RefreshSubscribeSyncTimer());
     mIsPrimingReports = false;
+    // Data version filters only apply to the priming report.
+    InteractionModelEngine::GetInstance()->ReleaseDataVersionFilterList(mpDataVersionFilterList);
     MoveToState(HandlerState::GeneratingReports);
     if (mpDelegate != nullptr)
     {
@@ -573,6 +640,7 @@ CHIP_ERROR ReadHandler::SendSubscribeResponse()
 
 CHIP_ERROR ReadHandler::ProcessSubscribeRequest(System::PacketBufferHandle && aPayload)
 {
+    TRACE_EVENT_SCOPE("ProcessSubscribeRequest", "ReadHandler");
     System::PacketBufferTLVReader reader;
     reader.Init(std::move(aPayload));
 
@@ -592,6 +660,16 @@ CHIP_ERROR ReadHandler::ProcessSubscribeRequest(System::PacketBufferHandle && aP
     else if (err == CHIP_NO_ERROR)
     {
         ReturnErrorOnFailure(ProcessAttributePathList(attributePathListParser));
+        DataVersionFilterIBs::Parser dataVersionFilterListParser;
+        err = subscribeRequestParser.GetDataVersionFilters(&dataVersionFilterListParser);
+        if (err == CHIP_END_OF_TLV)
+        {
+            err = CHIP_NO_ERROR;
+        }
+        else if (err == CHIP_NO_ERROR)
+        {
+            ReturnErrorOnFailure(ProcessDataVersionFilterList(dataVersionFilterListParser));
+        }
     }
     ReturnErrorOnFailure(err);
 
@@ -19,6 +19,7 @@
 #pragma once
 
 #include <app/AttributePathParams.h>
+#include <app/DataVersionFilter.h>
 #include <app/EventPathParams.h>
 #include <app/util/basic-types.h>
 #include <lib/core/CHIPCore.h>
@@ -34,6 +35,8 @@ struct ReadPrepareParams
     size_t mEventPathParamsListSize                 = 0;
     AttributePathParams * mpAttributePathParamsList = nullptr;
     size_t mAttributePathParamsListSize             = 0;
+    DataVersionFilter * mpDataVersionFilterList     = nullptr;
+    size_t mDataVersionFilterListSize               = 0;
     EventNumber mEventNumber                        = 0;
     System::Clock::Timeout mTimeout                 = kImMessageTimeout;
     uint16_t mMinIntervalFloorSeconds               = 0;
@@ -49,6 +52,8 @@ struct ReadPrepareParams
         mEventPathParamsListSize           = other.mEventPathParamsListSize;
         mpAttributePathParamsList          = other.mpAttributePathParamsList;
         mAttributePathParamsListSize       = other.mAttributePathParamsListSize;
+        mpDataVersionFilterList            = other.mpDataVersionFilterList;
+        mDataVersionFilterListSize         = other.mDataVersionFilterListSize;
         mEventNumber                       = other.mEventNumber;
         mMinIntervalFloorSeconds           = other.mMinIntervalFloorSeconds;
         mMaxIntervalCeilingSeconds         = other.mMaxIntervalCeilingSeconds;
@@ -58,6 +63,8 @@ struct ReadPrepareParams
         other.mEventPathParamsListSize     = 0;
         other.mpAttributePathParamsList    = nullptr;
         other.mAttributePathParamsListSize = 0;
+        other.mpDataVersionFilterList      = nullptr;
+        other.mDataVersionFilterListSize   = 0;
     }
 
     ReadPrepareParams & operator=(ReadPrepareParams && other)
@@ -71,6 +78,8 @@ struct ReadPrepareParams
         mEventPathParamsListSize           = other.mEventPathParamsListSize;
         mpAttributePathParamsList          = other.mpAttributePathParamsList;
         mAttributePathParamsListSize       = other.mAttributePathParamsListSize;
+        mpDataVersionFilterList            = other.mpDataVersionFilterList;
+        mDataVersionFilterListSize         = other.mDataVersionFilterListSize;
         mEventNumber                       = other.mEventNumber;
         mMinIntervalFloorSeconds           = other.mMinIntervalFloorSeconds;
         mMaxIntervalCeilingSeconds         = other.mMaxIntervalCeilingSeconds;
@@ -80,6 +89,8 @@ struct ReadPrepareParams
         other.mEventPathParamsListSize     = 0;
         other.mpAttributePathParamsList    = nullptr;
         other.mAttributePathParamsListSize = 0;
+        other.mpDataVersionFilterList      = nullptr;
+        other.mDataVersionFilterListSize   = 0;
 
         return *this;
     }
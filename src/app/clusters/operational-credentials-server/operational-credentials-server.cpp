@@ -259,6 +259,13 @@ class OpCredsFabricTableDelegate : public FabricTableDelegate
     {
         emberAfPrintln(EMBER_AF_PRINT_DEBUG, "OpCreds: Fabric 0x%" PRIu8 " was deleted from fabric storage.", fabricId);
         fabricListChanged();
+#if CHIP_CONFIG_GROUP_MESSAGE_DECRYPTION
+        Server::GetInstance().GetGroupKeyCache().RemoveFabric(fabricId);
+#endif
+        if (Server::GetInstance().GetCASESessionCache().RemoveFabric(fabricId) != CHIP_NO_ERROR)
+        {
+            ChipLogError(Zcl, "OpCredsFabricTableDelegate: Failed to remove the CASE sessions of the fabric");
+        }
 
         // The Leave event SHOULD be emitted by a Node prior to permanently
         // leaving the Fabric.
@@ -284,6 +291,7 @@ class OpCredsFabricTableDelegate : public FabricTableDelegate
                        fabric->GetFabricIndex(), ChipLogValueX64(fabric->GetFabricId()),
                        ChipLogValueX64(fabric->GetPeerId().GetNodeId()), fabric->GetVendorId());
         fabricListChanged();
+        updateGroupKeyCache(fabric);
     }
 
     // Gets called when a fabric in FabricTable is persisted to KVS store.
@@ -295,6 +303,20 @@ class OpCredsFabricTableDelegate : public FabricTableDelegate
                        fabric->GetFabricIndex(), ChipLogValueX64(fabric->GetFabricId()),
                        ChipLogValueX64(fabric->GetPeerId().GetNodeId()), fabric->GetVendorId());
         fabricListChanged();
+        updateGroupKeyCache(fabric);
+    }
+
+    // Group keys are derived from the compressed fabric id, so they need to follow fabric changes.
+    void updateGroupKeyCache(FabricInfo * fabric)
+    {
+#if CHIP_CONFIG_GROUP_MESSAGE_DECRYPTION
+        CHIP_ERROR err = Server::GetInstance().GetGroupKeyCache().SetFabric(fabric->GetFabricIndex(),
+                                                                           fabric->GetPeerId().GetCompressedFabricId());
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(Zcl, "OpCredsFabricTableDelegate: Failed to update group keys: %" CHIP_ERROR_FORMAT, err.Format());
+        }
+#endif
     }
 };
 
@@ -62,8 +62,9 @@ public:
     void SetMessageDelegate(MessagingDelegate * delegate) { mMsgDelegate = delegate; }
     void SetStateDelegate(StateDelegate * delegate) { mStateDelegate = delegate; }
 
-    // Initialize a BDX transfer session but will not proceed until OnPreparedForDownload() is called.
-    CHIP_ERROR SetBDXParams(const chip::bdx::TransferSession::TransferInitData & bdxInitData);
+    // Initialize a BDX transfer session but will not proceed until OnPreparedForDownload() is called. windowSize is the number of
+    // Blocks queried ahead of the one being processed (see TransferSession::SetWindowSize()).
+    CHIP_ERROR SetBDXParams(const chip::bdx::TransferSession::TransferInitData & bdxInitData, uint8_t windowSize = 1);
 
     // OTADownloader Overrides
     CHIP_ERROR BeginPrepareDownload() override;
@@ -570,7 +570,8 @@ CHIP_ERROR OTARequestor::StartDownload(OperationalDeviceProxy & deviceProxy)
     mBdxDownloader->SetMessageDelegate(&mBdxMessenger);
     mBdxDownloader->SetStateDelegate(this);
 
-    ReturnErrorOnFailure(mBdxDownloader->SetBDXParams(initOptions));
+    uint8_t windowSize = session.Value()->RequireMRP() ? 1 : mOtaRequestorDriver->GetDownloadWindowSize();
+    ReturnErrorOnFailure(mBdxDownloader->SetBDXParams(initOptions, windowSize));
     return mBdxDownloader->BeginPrepareDownload();
 }
 
@@ -150,8 +150,10 @@ private:
             {
                 sendFlags.Set(chip::Messaging::SendMessageFlags::kFromInitiator);
             }
+            // With a window of queries in flight, the exchange may already be waiting for a response.
             if (!event.msgTypeData.HasMessageType(chip::bdx::MessageType::BlockAckEOF) &&
-                !event.msgTypeData.HasMessageType(chip::Protocols::SecureChannel::MsgType::StatusReport))
+                !event.msgTypeData.HasMessageType(chip::Protocols::SecureChannel::MsgType::StatusReport) &&
+                !mExchangeCtx->IsResponseExpected())
             {
                 sendFlags.Set(chip::Messaging::SendMessageFlags::kExpectResponse);
             }
@@ -0,0 +1,268 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines an inverted index from attribute paths to the read
+ *      handlers interested in them, used by the reporting engine.
+ *
+ */
+
+#pragma once
+
+#include <app/ClusterInfo.h>
+#include <lib/core/CHIPError.h>
+#include <lib/core/DataModelTypes.h>
+#include <lib/support/CodeUtils.h>
+
+#include <bitset>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace chip {
+namespace app {
+namespace reporting {
+
+/**
+ * Maps the (endpoint, cluster, attribute) of every attribute path requested by
+ * a read handler to the set of read handlers that requested it.
+ *
+ * Paths are stored as requested, with their wildcard fields kept as wildcards.
+ * A concrete dirty path can then be matched against at most eight keys (each
+ * field either concrete or wildcard) instead of against every path of every
+ * handler. Dirty paths that themselves contain wildcards fall back to a scan of
+ * the index, which is still bounded by the number of distinct paths rather than
+ * by handlers x paths.
+ *
+ * List indices are not part of the key, so a handler whose path differs from
+ * the dirty path only by list index is reported as interested. That is
+ * conservative: the handler is marked dirty and UpdateReadHandlerDirty() clears
+ * it again if nothing it reads actually changed.
+ *
+ * @tparam kMaxPaths    maximum number of distinct paths indexed at once.
+ * @tparam kMaxHandlers number of read handler slots; handlers are identified by slot index.
+ */
+template <size_t kMaxPaths, size_t kMaxHandlers>
+class AttributePathIndex
+{
+public:
+    using HandlerSet = std::bitset<kMaxHandlers>;
+
+    AttributePathIndex() { Clear(); }
+
+    void Clear()
+    {
+        for (auto & bucket : mBuckets)
+        {
+            bucket.handlers.reset();
+        }
+        mCount = 0;
+    }
+
+    /**
+     * Record that the handler in slot aHandlerIndex is interested in aPath.
+     *
+     * @retval CHIP_ERROR_INVALID_ARGUMENT if aHandlerIndex is out of range.
+     * @retval CHIP_ERROR_NO_MEMORY        if the path is new and the index is full.
+     */
+    CHIP_ERROR Add(const ClusterInfo & aPath, size_t aHandlerIndex)
+    {
+        VerifyOrReturnError(aHandlerIndex < kMaxHandlers, CHIP_ERROR_INVALID_ARGUMENT);
+
+        Key key{ aPath.mEndpointId, aPath.mClusterId, aPath.mAttributeId };
+        size_t bucket = HomeBucket(key);
+        while (mBuckets[bucket].handlers.any())
+        {
+            if (mBuckets[bucket].key == key)
+            {
+                mBuckets[bucket].handlers.set(aHandlerIndex);
+                return CHIP_NO_ERROR;
+            }
+            bucket = Next(bucket);
+        }
+
+        VerifyOrReturnError(mCount < kMaxPaths, CHIP_ERROR_NO_MEMORY);
+        mBuckets[bucket].key = key;
+        mBuckets[bucket].handlers.set(aHandlerIndex);
+        mCount++;
+        return CHIP_NO_ERROR;
+    }
+
+    /**
+     * Forget every path of the handler in slot aHandlerIndex. Paths no other
+     * handler is interested in are dropped from the index.
+     */
+    void RemoveHandler(size_t aHandlerIndex)
+    {
+        VerifyOrReturn(aHandlerIndex < kMaxHandlers);
+
+        size_t bucket = 0;
+        while (bucket < kBucketCount)
+        {
+            Bucket & entry = mBuckets[bucket];
+            if (entry.handlers.test(aHandlerIndex))
+            {
+                entry.handlers.reset(aHandlerIndex);
+                if (entry.handlers.none())
+                {
+                    // RemoveAt() may shift another entry into this bucket, so
+                    // look at it again before moving on.
+                    RemoveAt(bucket);
+                    continue;
+                }
+            }
+            bucket++;
+        }
+    }
+
+    /**
+     * @return the set of handlers with at least one path overlapping aPath, i.e.
+     *         where either path is a superset of the other.
+     */
+    HandlerSet GetInterestedHandlers(const ClusterInfo & aPath) const
+    {
+        HandlerSet result;
+
+        if (aPath.HasAttributeWildcard())
+        {
+            for (const auto & bucket : mBuckets)
+            {
+                if (bucket.handlers.any() && bucket.key.Overlaps(aPath))
+                {
+                    result |= bucket.handlers;
+                }
+            }
+            return result;
+        }
+
+        // A requested path overlaps a concrete path iff each of its fields is
+        // either a wildcard or equal to the concrete field.
+        for (uint8_t wildcards = 0; wildcards < 8; wildcards++)
+        {
+            Key key{ (wildcards & 1) ? kInvalidEndpointId : aPath.mEndpointId,
+                     (wildcards & 2) ? kInvalidClusterId : aPath.mClusterId,
+                     (wildcards & 4) ? kInvalidAttributeId : aPath.mAttributeId };
+            const Bucket * bucket = Find(key);
+            if (bucket != nullptr)
+            {
+                result |= bucket->handlers;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @return the number of distinct paths in the index.
+     */
+    size_t Count() const { return mCount; }
+
+private:
+    struct Key
+    {
+        EndpointId endpoint   = kInvalidEndpointId;
+        ClusterId cluster     = kInvalidClusterId;
+        AttributeId attribute = kInvalidAttributeId;
+
+        bool operator==(const Key & other) const
+        {
+            return endpoint == other.endpoint && cluster == other.cluster && attribute == other.attribute;
+        }
+
+        bool Overlaps(const ClusterInfo & aPath) const
+        {
+            return (endpoint == kInvalidEndpointId || aPath.HasWildcardEndpointId() || endpoint == aPath.mEndpointId) &&
+                (cluster == kInvalidClusterId || aPath.HasWildcardClusterId() || cluster == aPath.mClusterId) &&
+                (attribute == kInvalidAttributeId || aPath.HasWildcardAttributeId() || attribute == aPath.mAttributeId);
+        }
+    };
+
+    struct Bucket
+    {
+        Key key;
+        // An empty handler set marks a free bucket.
+        HandlerSet handlers;
+    };
+
+    static constexpr size_t ComputeBucketCount(size_t minimum)
+    {
+        size_t count = 1;
+        while (count < minimum)
+        {
+            count <<= 1;
+        }
+        return count;
+    }
+
+    // Keep the load factor at or below 1/2 so probe runs stay short.
+    static constexpr size_t kBucketCount = ComputeBucketCount(2 * kMaxPaths + 1);
+    static constexpr size_t kBucketMask  = kBucketCount - 1;
+
+    static size_t HomeBucket(const Key & key)
+    {
+        uint32_t hash = key.cluster * 0x9E3779B1u;
+        hash ^= key.attribute * 0x85EBCA77u;
+        hash ^= static_cast<uint32_t>(key.endpoint) * 40503u;
+        hash ^= hash >> 15;
+        return static_cast<size_t>(hash) & kBucketMask;
+    }
+
+    static size_t Next(size_t bucket) { return (bucket + 1) & kBucketMask; }
+
+    const Bucket * Find(const Key & key) const
+    {
+        size_t bucket = HomeBucket(key);
+        while (mBuckets[bucket].handlers.any())
+        {
+            if (mBuckets[bucket].key == key)
+            {
+                return &mBuckets[bucket];
+            }
+            bucket = Next(bucket);
+        }
+        return nullptr;
+    }
+
+    // Backward-shift deletion, so lookups never need tombstones.
+    void RemoveAt(size_t hole)
+    {
+        size_t bucket = Next(hole);
+        while (mBuckets[bucket].handlers.any())
+        {
+            size_t home = HomeBucket(mBuckets[bucket].key);
+            // Move the entry into the hole if its home bucket does not lie in
+            // the cyclic range (hole, bucket].
+            bool homeInRange = (hole <= bucket) ? (hole < home && home <= bucket) : (hole < home || home <= bucket);
+            if (!homeInRange)
+            {
+                mBuckets[hole] = mBuckets[bucket];
+                hole           = bucket;
+            }
+            bucket = Next(bucket);
+        }
+
+        mBuckets[hole].handlers.reset();
+        mCount--;
+    }
+
+    Bucket mBuckets[kBucketCount];
+    size_t mCount = 0;
+};
+
+} // namespace reporting
+} // namespace app
+} // namespace chip
@@ -0,0 +1,152 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines a cache of encoded attribute reports, shared by the
+ *      read handlers served within one run of the reporting engine.
+ *
+ */
+
+#pragma once
+
+#include <app/ConcreteAttributePath.h>
+#include <lib/core/CHIPError.h>
+#include <lib/core/DataModelTypes.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/Span.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace chip {
+namespace app {
+namespace reporting {
+
+/**
+ * Everything the encoding of one attribute depends on, besides the attribute value itself.
+ *
+ * Two read handlers with the same key get byte-identical AttributeReportIBs for the path, so the
+ * second one can copy the encoding of the first instead of reading and encoding the attribute again.
+ */
+struct AttributeReportCacheKey
+{
+    ConcreteAttributePath mPath;
+    /// Attribute access interfaces may encode differently depending on the accessing fabric.
+    FabricIndex mAccessingFabricIndex = kUndefinedFabricIndex;
+    bool mIsFabricFiltered            = false;
+    /// Result of the access control check for the path.
+    bool mAccessAllowed = false;
+
+    bool operator==(const AttributeReportCacheKey & other) const
+    {
+        // ConcreteAttributePath::operator== ignores mExpanded, which changes how errors are reported.
+        return mPath == other.mPath && mPath.mExpanded == other.mPath.mExpanded &&
+            mAccessingFabricIndex == other.mAccessingFabricIndex && mIsFabricFiltered == other.mIsFabricFiltered &&
+            mAccessAllowed == other.mAccessAllowed;
+    }
+};
+
+/**
+ * Holds the encoded AttributeReportIBs of up to kMaxEntries attribute reads, packed into a kBufferSize
+ * byte arena.
+ *
+ * The cache has no notion of attribute values changing: the owner must Clear() it whenever a cached
+ * encoding may have become stale. The reporting engine does so at the start and end of every run and
+ * whenever an attribute is marked dirty. Entries are never evicted; once the arena or entry table is
+ * full, further encodings are simply not cached until the next Clear().
+ *
+ * New encodings are written directly into the arena: the caller encodes into GetFreeSpace() and then
+ * calls Commit() with the number of bytes it used.
+ */
+template <size_t kBufferSize, size_t kMaxEntries>
+class AttributeReportCache
+{
+public:
+    void Clear()
+    {
+        mEntryCount = 0;
+        mUsed       = 0;
+    }
+
+    /**
+     * Look up the encoding cached for aKey.
+     *
+     * @return true and set aEncoded if the key is cached.
+     */
+    bool Find(const AttributeReportCacheKey & aKey, ByteSpan & aEncoded) const
+    {
+        for (size_t i = 0; i < mEntryCount; i++)
+        {
+            if (mEntries[i].key == aKey)
+            {
+                aEncoded = ByteSpan(&mBuffer[mEntries[i].offset], mEntries[i].length);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * The unused part of the arena, where the next encoding may be written. Empty once the entry
+     * table is full.
+     */
+    MutableByteSpan GetFreeSpace()
+    {
+        if (mEntryCount >= kMaxEntries)
+        {
+            return MutableByteSpan();
+        }
+        return MutableByteSpan(&mBuffer[mUsed], kBufferSize - mUsed);
+    }
+
+    /**
+     * Record the aLength bytes at the start of GetFreeSpace() as the encoding for aKey.
+     */
+    CHIP_ERROR Commit(const AttributeReportCacheKey & aKey, size_t aLength)
+    {
+        VerifyOrReturnError(mEntryCount < kMaxEntries, CHIP_ERROR_NO_MEMORY);
+        VerifyOrReturnError(aLength <= kBufferSize - mUsed, CHIP_ERROR_BUFFER_TOO_SMALL);
+
+        Entry & entry = mEntries[mEntryCount++];
+        entry.key     = aKey;
+        entry.offset  = mUsed;
+        entry.length  = aLength;
+        mUsed += aLength;
+        return CHIP_NO_ERROR;
+    }
+
+    size_t GetEntryCount() const { return mEntryCount; }
+
+private:
+    struct Entry
+    {
+        AttributeReportCacheKey key;
+        size_t offset;
+        size_t length;
+    };
+
+    uint8_t mBuffer[kBufferSize];
+    Entry mEntries[kMaxEntries];
+    size_t mEntryCount = 0;
+    size_t mUsed       = 0;
+};
+
+} // namespace reporting
+} // namespace app
+} // namespace chip
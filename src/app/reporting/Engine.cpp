@@ -27,6 +27,9 @@
 #include <app/InteractionModelEngine.h>
 #include <app/reporting/Engine.h>
 #include <app/util/MatterCallbacks.h>
+#include <trace/trace.h>
+
+#include <string.h>
 
 using namespace chip::Access;
 
@@ -45,25 +48,138 @@ void Engine::Shutdown()
     mNumReportsInFlight = 0;
     mCurReadHandlerIdx  = 0;
     mGlobalDirtySet.ReleaseAll();
+    mInterestedPaths.Clear();
+    mReportCache.Clear();
 }
 
 CHIP_ERROR
 Engine::RetrieveClusterData(const SubjectDescriptor & aSubjectDescriptor, bool aIsFabricFiltered,
                             AttributeReportIBs::Builder & aAttributeReportIBs, const ConcreteReadAttributePath & aPath,
-                            AttributeValueEncoder::AttributeEncodeState * aEncoderState)
+                            AttributeValueEncoder::AttributeEncodeState * aEncoderState,
+                            const CHIP_ERROR * apAccessCheckResult)
 {
     ChipLogDetail(DataManagement, "<RE:Run> Cluster %" PRIx32 ", Attribute %" PRIx32 " is dirty", aPath.mClusterId,
                   aPath.mAttributeId);
     MatterPreAttributeReadCallback(aPath);
-    ReturnErrorOnFailure(ReadSingleClusterData(aSubjectDescriptor, aIsFabricFiltered, aPath, aAttributeReportIBs, aEncoderState));
+    ReturnErrorOnFailure(ReadSingleClusterData(aSubjectDescriptor, aIsFabricFiltered, aPath, aAttributeReportIBs, aEncoderState,
+                                               apAccessCheckResult));
     MatterPostAttributeReadCallback(aPath);
     return CHIP_NO_ERROR;
 }
 
+namespace {
+
+CHIP_ERROR CopyAttributeReportIBs(const ByteSpan & aEncodedReportIBs, TLV::TLVWriter & aWriter)
+{
+    TLV::TLVReader reader;
+    reader.Init(aEncodedReportIBs);
+
+    CHIP_ERROR err;
+    while ((err = reader.Next()) == CHIP_NO_ERROR)
+    {
+        ReturnErrorOnFailure(aWriter.CopyElement(TLV::AnonymousTag(), reader));
+    }
+    return err == CHIP_END_OF_TLV ? CHIP_NO_ERROR : err;
+}
+
+} // namespace
+
+CHIP_ERROR Engine::EncodeAndCacheClusterData(ReadHandler & aReadHandler, const AttributeReportCacheKey & aKey,
+                                             CHIP_ERROR aAccessCheckResult, AttributeReportIBs::Builder & aAttributeReportIBs,
+                                             const ConcreteReadAttributePath & aPath,
+                                             AttributeValueEncoder::AttributeEncodeState * apEncoderState)
+{
+    TLV::TLVWriter * writer      = aAttributeReportIBs.GetWriter();
+    const uint8_t * encodedStart = writer->GetWritePoint();
+    uint32_t lengthBefore        = writer->GetLengthWritten();
+
+    ReturnErrorOnFailure(RetrieveClusterData(aReadHandler.GetSubjectDescriptor(), aReadHandler.IsFabricFiltered(),
+                                             aAttributeReportIBs, aPath, apEncoderState, &aAccessCheckResult));
+
+    // The report buffer holds the AttributeReportIBs of the attribute as a contiguous run of bytes unless the writer moved to
+    // another buffer on the way. Failing to cache is not an error: the next handler will simply encode the attribute again.
+    size_t encodedLength      = writer->GetLengthWritten() - lengthBefore;
+    MutableByteSpan freeSpace = mReportCache.GetFreeSpace();
+    if (writer->GetWritePoint() == encodedStart + encodedLength && encodedLength <= freeSpace.size())
+    {
+        memcpy(freeSpace.data(), encodedStart, encodedLength);
+        mReportCache.Commit(aKey, encodedLength);
+    }
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR Engine::RetrieveSharedClusterData(ReadHandler & aReadHandler, AttributeReportIBs::Builder & aAttributeReportIBs,
+                                             const ConcreteReadAttributePath & aPath,
+                                             AttributeValueEncoder::AttributeEncodeState * apEncoderState)
+{
+    // Sharing only pays off when several handlers may read the same attribute, or when an earlier handler of this run already
+    // cached some (it may have finished since), and only whole attributes are shared: a list being chunked keeps per-handler
+    // state.
+    bool shareable = !apEncoderState->AllowPartialData() && !aPath.mListIndex.HasValue() &&
+        (InteractionModelEngine::GetInstance()->GetNumActiveReadHandlers() > 1 || mReportCache.GetEntryCount() > 0);
+
+    if (shareable)
+    {
+        const Access::SubjectDescriptor & subjectDescriptor = aReadHandler.GetSubjectDescriptor();
+        Access::RequestPath requestPath{ .cluster = aPath.mClusterId, .endpoint = aPath.mEndpointId };
+        CHIP_ERROR accessErr = Access::GetAccessControl().Check(subjectDescriptor, requestPath, Access::Privilege::kView);
+
+        AttributeReportCacheKey key;
+        key.mPath                 = aPath;
+        key.mAccessingFabricIndex = subjectDescriptor.fabricIndex;
+        key.mIsFabricFiltered     = aReadHandler.IsFabricFiltered();
+        key.mAccessAllowed        = (accessErr == CHIP_NO_ERROR);
+
+        ByteSpan encoded;
+        if (!mReportCache.Find(key, encoded))
+        {
+            return EncodeAndCacheClusterData(aReadHandler, key, accessErr, aAttributeReportIBs, aPath, apEncoderState);
+        }
+
+        // The cached encoding stands in for the read, so the application sees the read callbacks just as on a miss.
+        MatterPreAttributeReadCallback(aPath);
+        TLV::TLVWriter backup;
+        aAttributeReportIBs.Checkpoint(backup);
+        CHIP_ERROR err = CopyAttributeReportIBs(encoded, *aAttributeReportIBs.GetWriter());
+        if (err == CHIP_ERROR_NO_MEMORY || err == CHIP_ERROR_BUFFER_TOO_SMALL)
+        {
+            // Not enough room left in this report: encode directly so that lists can still be chunked.
+            aAttributeReportIBs.Rollback(backup);
+            err = ReadSingleClusterData(subjectDescriptor, aReadHandler.IsFabricFiltered(), aPath, aAttributeReportIBs,
+                                        apEncoderState, &accessErr);
+        }
+        ReturnErrorOnFailure(err);
+        MatterPostAttributeReadCallback(aPath);
+        return CHIP_NO_ERROR;
+    }
+
+    return RetrieveClusterData(aReadHandler.GetSubjectDescriptor(), aReadHandler.IsFabricFiltered(), aAttributeReportIBs, aPath,
+                               apEncoderState);
+}
+
+bool Engine::IsClusterDataVersionMatch(ClusterInfo * aDataVersionFilterList, const ConcreteClusterPath & aPath)
+{
+    bool existPathMatch       = false;
+    bool existVersionMismatch = false;
+    for (auto filter = aDataVersionFilterList; filter != nullptr; filter = filter->mpNext)
+    {
+        if (aPath.mEndpointId == filter->mEndpointId && aPath.mClusterId == filter->mClusterId)
+        {
+            existPathMatch = true;
+            if (!IsClusterDataVersionEqual(aPath, filter->mDataVersion.Value()))
+            {
+                existVersionMismatch = true;
+            }
+        }
+    }
+    return existPathMatch && !existVersionMismatch;
+}
+
 CHIP_ERROR Engine::BuildSingleReportDataAttributeReportIBs(ReportDataMessage::Builder & aReportDataBuilder,
                                                            ReadHandler * apReadHandler, bool * apHasMoreChunks,
                                                            bool * apHasEncodedData)
 {
+    TRACE_EVENT_SCOPE("BuildSingleReportDataAttributeReportIBs", "Reporting");
     CHIP_ERROR err            = CHIP_NO_ERROR;
     bool attributeDataWritten = false;
     bool hasMoreChunks        = true;
@@ -87,6 +203,9 @@ CHIP_ERROR Engine::BuildSingleReportDataAttributeReportIBs(ReportDataMessage::Bu
         // TODO: Figure out how AttributePathExpandIterator should handle read
         // vs write paths.
         ConcreteAttributePath readPath;
+        // The iterator emits the paths of a cluster one after the other, so remember the filter decision for the last cluster.
+        ConcreteClusterPath lastClusterPath(kInvalidEndpointId, kInvalidClusterId);
+        bool lastClusterFiltered = false;
 
         // For each path included in the interested path of the read handler...
         for (; apReadHandler->GetAttributePathExpandIterator()->Get(readPath);
@@ -111,6 +230,21 @@ CHIP_ERROR Engine::BuildSingleReportDataAttributeReportIBs(ReportDataMessage::Bu
                     continue;
                 }
             }
+            else if (apReadHandler->GetDataVersionFilterlist() != nullptr)
+            {
+                ConcreteClusterPath clusterPath(readPath.mEndpointId, readPath.mClusterId);
+                if (clusterPath != lastClusterPath)
+                {
+                    lastClusterPath     = clusterPath;
+                    lastClusterFiltered = IsClusterDataVersionMatch(apReadHandler->GetDataVersionFilterlist(), clusterPath);
+                }
+
+                if (lastClusterFiltered)
+                {
+                    // The client already has this version of the cluster.
+                    continue;
+                }
+            }
 
             // If we are processing a read request, or the initial report of a subscription, just regard all paths as dirty paths.
             TLV::TLVWriter attributeBackup;
@@ -118,8 +252,7 @@ CHIP_ERROR Engine::BuildSingleReportDataAttributeReportIBs(ReportDataMessage::Bu
             ConcreteReadAttributePath pathForRetrieval(readPath);
             // Load the saved state from previous encoding session for chunking of one single attribute (list chunking).
             AttributeValueEncoder::AttributeEncodeState encodeState = apReadHandler->GetAttributeEncodeState();
-            err = RetrieveClusterData(apReadHandler->GetSubjectDescriptor(), apReadHandler->IsFabricFiltered(), attributeReportIBs,
-                                      pathForRetrieval, &encodeState);
+            err = RetrieveSharedClusterData(*apReadHandler, attributeReportIBs, pathForRetrieval, &encodeState);
             if (err != CHIP_NO_ERROR)
             {
                 ChipLogError(DataManagement,
@@ -219,6 +352,7 @@ exit:
 CHIP_ERROR Engine::BuildSingleReportDataEventReports(ReportDataMessage::Builder & aReportDataBuilder, ReadHandler * apReadHandler,
                                                      bool * apHasMoreChunks, bool * apHasEncodedData)
 {
+    TRACE_EVENT_SCOPE("BuildSingleReportDataEventReports", "Reporting");
     CHIP_ERROR err    = CHIP_NO_ERROR;
     size_t eventCount = 0;
     TLV::TLVWriter backup;
@@ -310,6 +444,7 @@ exit:
 
 CHIP_ERROR Engine::BuildAndSendSingleReportData(ReadHandler * apReadHandler)
 {
+    TRACE_EVENT_SCOPE("BuildAndSendSingleReportData", "Reporting");
     CHIP_ERROR err = CHIP_NO_ERROR;
     chip::System::PacketBufferTLVWriter reportDataWriter;
     ReportDataMessage::Builder reportDataBuilder;
@@ -461,6 +596,7 @@ void Engine::Run()
     ReadHandler * readHandler         = imEngine->mReadHandlers + mCurReadHandlerIdx;
 
     mRunScheduled = false;
+    mReportCache.Clear();
 
     while ((mNumReportsInFlight < CHIP_IM_MAX_REPORTS_IN_FLIGHT) && (numReadHandled < CHIP_IM_MAX_NUM_READ_HANDLER))
     {
@@ -492,6 +628,7 @@ void Engine::Run()
     {
         mGlobalDirtySet.ReleaseAll();
     }
+    mReportCache.Clear();
 }
 
 bool Engine::MergeOverlappedAttributePath(ClusterInfo & aAttributePath)
@@ -513,26 +650,33 @@ bool Engine::MergeOverlappedAttributePath(ClusterInfo & aAttributePath)
 
 CHIP_ERROR Engine::SetDirty(ClusterInfo & aClusterInfo)
 {
-    for (auto & handler : InteractionModelEngine::GetInstance()->mReadHandlers)
+    InteractionModelEngine * imEngine = InteractionModelEngine::GetInstance();
+    bool intersectsSubscription       = false;
+
+    // Encodings cached so far in this run may hold the old value.
+    mReportCache.Clear();
+
+    auto interestedHandlers = mInterestedPaths.GetInterestedHandlers(aClusterInfo);
+    for (size_t i = 0; i < CHIP_IM_MAX_NUM_READ_HANDLER && interestedHandlers.any(); i++)
     {
+        if (!interestedHandlers.test(i))
+        {
+            continue;
+        }
+        interestedHandlers.reset(i);
+
+        ReadHandler & handler = imEngine->mReadHandlers[i];
         // We call SetDirty for both read interactions and subscribe interactions, since we may sent inconsistent attribute data
         // between two chunks. SetDirty will be ignored automatically by read handlers which is waiting for response to last message
         // chunk for read interactions.
         if (handler.IsGeneratingReports() || handler.IsAwaitingReportResponse())
         {
-            for (auto clusterInfo = handler.GetAttributeClusterInfolist(); clusterInfo != nullptr;
-                 clusterInfo      = clusterInfo->mpNext)
-            {
-                if (aClusterInfo.IsAttributePathSupersetOf(*clusterInfo) || clusterInfo->IsAttributePathSupersetOf(aClusterInfo))
-                {
-                    handler.SetDirty();
-                    break;
-                }
-            }
+            handler.SetDirty();
+            intersectsSubscription = intersectsSubscription || handler.IsSubscriptionType();
         }
     }
-    if (!MergeOverlappedAttributePath(aClusterInfo) &&
-        InteractionModelEngine::GetInstance()->IsOverlappedAttributePath(aClusterInfo))
+
+    if (!MergeOverlappedAttributePath(aClusterInfo) && intersectsSubscription)
     {
         ClusterInfo * clusterInfo = mGlobalDirtySet.CreateObject();
         if (clusterInfo == nullptr)
@@ -545,6 +689,48 @@ CHIP_ERROR Engine::SetDirty(ClusterInfo & aClusterInfo)
     return CHIP_NO_ERROR;
 }
 
+bool Engine::GetReadHandlerIndex(const ReadHandler & aReadHandler, size_t & aIndex) const
+{
+    InteractionModelEngine * imEngine = InteractionModelEngine::GetInstance();
+    for (size_t i = 0; i < CHIP_IM_MAX_NUM_READ_HANDLER; i++)
+    {
+        if (&imEngine->mReadHandlers[i] == &aReadHandler)
+        {
+            aIndex = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+CHIP_ERROR Engine::RegisterReadHandlerPaths(ReadHandler & aReadHandler)
+{
+    size_t handlerIndex = 0;
+    // Handlers outside of the pool (e.g. in unit tests) are not tracked by SetDirty.
+    VerifyOrReturnError(GetReadHandlerIndex(aReadHandler, handlerIndex), CHIP_NO_ERROR);
+
+    for (auto clusterInfo = aReadHandler.GetAttributeClusterInfolist(); clusterInfo != nullptr; clusterInfo = clusterInfo->mpNext)
+    {
+        CHIP_ERROR err = mInterestedPaths.Add(*clusterInfo, handlerIndex);
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(DataManagement, "Attribute path index full, cannot handle more entries!");
+            mInterestedPaths.RemoveHandler(handlerIndex);
+            return err;
+        }
+    }
+    return CHIP_NO_ERROR;
+}
+
+void Engine::UnregisterReadHandlerPaths(ReadHandler & aReadHandler)
+{
+    size_t handlerIndex = 0;
+    if (GetReadHandlerIndex(aReadHandler, handlerIndex))
+    {
+        mInterestedPaths.RemoveHandler(handlerIndex);
+    }
+}
+
 void Engine::UpdateReadHandlerDirty(ReadHandler & aReadHandler)
 {
     if (!aReadHandler.IsDirty())
@@ -25,8 +25,11 @@
 #pragma once
 
 #include <access/AccessControl.h>
+#include <app/ConcreteClusterPath.h>
 #include <app/MessageDef/ReportDataMessage.h>
 #include <app/ReadHandler.h>
+#include <app/reporting/AttributePathIndex.h>
+#include <app/reporting/AttributeReportCache.h>
 #include <app/util/basic-types.h>
 #include <lib/core/CHIPCore.h>
 #include <lib/support/CodeUtils.h>
@@ -89,6 +92,17 @@ public:
      */
     CHIP_ERROR SetDirty(ClusterInfo & aClusterInfo);
 
+    /**
+     * Index the attribute paths of a read handler, so that SetDirty can find the handler without scanning its paths.
+     * Should be called once the handler's attribute path list is complete.
+     */
+    CHIP_ERROR RegisterReadHandlerPaths(ReadHandler & aReadHandler);
+
+    /**
+     * Remove the attribute paths of a read handler from the index. Should be called before the path list is released.
+     */
+    void UnregisterReadHandlerPaths(ReadHandler & aReadHandler);
+
     /**
      * @brief
      *  Schedule the event delivery
@@ -108,10 +122,39 @@ private:
                                                        bool * apHasMoreChunks, bool * apHasEncodedData);
     CHIP_ERROR BuildSingleReportDataEventReports(ReportDataMessage::Builder & reportDataBuilder, ReadHandler * apReadHandler,
                                                  bool * apHasMoreChunks, bool * apHasEncodedData);
+
+    /**
+     * Returns true when the data version filter list has at least one filter for the cluster instance, and the cluster is at
+     * the version of every one of them; its attributes can then be left out of a priming report.
+     */
+    bool IsClusterDataVersionMatch(ClusterInfo * aDataVersionFilterList, const ConcreteClusterPath & aPath);
     CHIP_ERROR RetrieveClusterData(const Access::SubjectDescriptor & aSubjectDescriptor, bool aIsFabricFiltered,
                                    AttributeReportIBs::Builder & aAttributeReportIBs,
                                    const ConcreteReadAttributePath & aClusterInfo,
-                                   AttributeValueEncoder::AttributeEncodeState * apEncoderState);
+                                   AttributeValueEncoder::AttributeEncodeState * apEncoderState,
+                                   const CHIP_ERROR * apAccessCheckResult = nullptr);
+
+    /**
+     * Encode an attribute for a read handler, sharing the encoding with other read handlers that read the same attribute
+     * with the same accessing fabric, fabric filtering and access control result in the current run.
+     *
+     * The attribute is read at most once per call: a cache miss is encoded straight into the report and then copied into the
+     * report cache if it fits. The attribute is only read again when the cached encoding does not fit in the report, so that a
+     * list can still be chunked. The access control check made for the cache key is the one the read uses, and the pre and
+     * post attribute read callbacks run once per call whether or not the encoding comes from the cache.
+     */
+    CHIP_ERROR RetrieveSharedClusterData(ReadHandler & aReadHandler, AttributeReportIBs::Builder & aAttributeReportIBs,
+                                         const ConcreteReadAttributePath & aPath,
+                                         AttributeValueEncoder::AttributeEncodeState * apEncoderState);
+
+    /**
+     * Encode an attribute straight into the report, then copy the encoded AttributeReportIBs into the free space of the report
+     * cache and commit them under aKey when they fit. aAccessCheckResult is the access control check aKey was built from.
+     */
+    CHIP_ERROR EncodeAndCacheClusterData(ReadHandler & aReadHandler, const AttributeReportCacheKey & aKey,
+                                         CHIP_ERROR aAccessCheckResult, AttributeReportIBs::Builder & aAttributeReportIBs,
+                                         const ConcreteReadAttributePath & aPath,
+                                         AttributeValueEncoder::AttributeEncodeState * apEncoderState);
 
     /**
      * Check all active subscription, if the subscription has no paths that intersect with global dirty set,
@@ -143,6 +186,13 @@ private:
      */
     bool MergeOverlappedAttributePath(ClusterInfo & aAttributePath);
 
+    /**
+     * Find the slot of a read handler in the InteractionModelEngine read handler pool.
+     *
+     * Return false if the handler does not belong to the pool.
+     */
+    bool GetReadHandlerIndex(const ReadHandler & aReadHandler, size_t & aIndex) const;
+
     /**
      * Boolean to indicate if ScheduleRun is pending. This flag is used to prevent calling ScheduleRun multiple times
      * within the same execution context to avoid applying too much pressure on platforms that use small, fixed size event queues.
@@ -168,6 +218,21 @@ private:
      */
     BitMapObjectPool<ClusterInfo, CHIP_IM_SERVER_MAX_NUM_DIRTY_SET> mGlobalDirtySet;
 
+    /**
+     *  mInterestedPaths maps the attribute paths of every active read handler to the handlers interested in them, so that
+     *  SetDirty only touches the affected handlers.
+     *
+     */
+    AttributePathIndex<CHIP_IM_SERVER_MAX_NUM_PATH_GROUPS, CHIP_IM_MAX_NUM_READ_HANDLER> mInterestedPaths;
+
+    /**
+     *  mReportCache holds the attribute reports encoded during the current run, so that read handlers interested in the same
+     *  attributes copy the encoded bytes instead of reading and encoding the attributes again. It is cleared at the start and end
+     *  of every run and whenever an attribute is marked dirty.
+     *
+     */
+    AttributeReportCache<CHIP_IM_SERVER_REPORT_CACHE_SIZE, CHIP_IM_SERVER_REPORT_CACHE_ENTRIES> mReportCache;
+
 #if CONFIG_IM_BUILD_FOR_UNIT_TEST
     uint32_t mReservedSize = 0;
 #endif
@@ -116,7 +116,8 @@ CHIP_ERROR Server::Init(AppDelegate * delegate, uint16_t secureServicePort, uint
     err = DeviceLayer::PersistedStorage::KeyValueStoreMgrImpl().Init("chip.store");
     SuccessOrExit(err);
 #elif CHIP_DEVICE_LAYER_TARGET_LINUX
-    DeviceLayer::PersistedStorage::KeyValueStoreMgrImpl().Init(CHIP_CONFIG_KVS_PATH);
+    err = DeviceLayer::PersistedStorage::KeyValueStoreMgrImpl().Init(CHIP_CONFIG_KVS_PATH);
+    SuccessOrExit(err);
 #endif
 
     InitDataModelHandler(&mExchangeMgr);
@@ -124,6 +125,9 @@ CHIP_ERROR Server::Init(AppDelegate * delegate, uint16_t secureServicePort, uint
     err = mFabrics.Init(&mServerStorage);
     SuccessOrExit(err);
 
+    err = mCASESessionCache.Init(&mServerStorage);
+    SuccessOrExit(err);
+
     // Group data provider must be initialized after mServerStorage
     err = mGroupsProvider.Init();
     SuccessOrExit(err);
@@ -166,6 +170,15 @@ CHIP_ERROR Server::Init(AppDelegate * delegate, uint16_t secureServicePort, uint
 
     err = mSessions.Init(&DeviceLayer::SystemLayer(), &mTransports, &mMessageCounterManager);
     SuccessOrExit(err);
+    mSessions.SetSessionIDAllocator(&mSessionIDAllocator);
+
+#if CHIP_CONFIG_GROUP_MESSAGE_DECRYPTION
+    err = mGroupKeyCache.Init(&mGroupsProvider);
+    SuccessOrExit(err);
+    err = mGroupKeyCache.SetFabrics(mFabrics);
+    SuccessOrExit(err);
+    mSessions.SetGroupKeyCache(&mGroupKeyCache);
+#endif
 
     err = mExchangeMgr.Init(&mSessions);
     SuccessOrExit(err);
@@ -233,7 +246,7 @@ CHIP_ERROR Server::Init(AppDelegate * delegate, uint16_t secureServicePort, uint
 #endif
 
     err = mCASEServer.ListenForSessionEstablishment(&mExchangeMgr, &mTransports, chip::DeviceLayer::ConnectivityMgr().GetBleLayer(),
-                                                    &mSessions, &mFabrics, &mSessionIDAllocator);
+                                                    &mSessions, &mFabrics, &mSessionIDAllocator, &mCASESessionCache);
     SuccessOrExit(err);
 
     err = mCASESessionManager.Init();
@@ -256,6 +269,10 @@ void Server::Shutdown()
     chip::app::InteractionModelEngine::GetInstance()->Shutdown();
     mExchangeMgr.Shutdown();
     mSessions.Shutdown();
+#if CHIP_CONFIG_GROUP_MESSAGE_DECRYPTION
+    mSessions.SetGroupKeyCache(nullptr);
+    mGroupKeyCache.Shutdown();
+#endif
     mTransports.Close();
     mCommissioningWindowManager.Shutdown();
     chip::Platform::MemoryShutdown();
@@ -36,6 +36,7 @@
 #include <protocols/secure_channel/PASESession.h>
 #include <protocols/secure_channel/RendezvousParameters.h>
 #include <protocols/user_directed_commissioning/UserDirectedCommissioning.h>
+#include <transport/GroupKeyCache.h>
 #include <transport/SessionManager.h>
 #include <transport/TransportMgr.h>
 #include <transport/TransportMgrBase.h>
@@ -81,6 +82,12 @@ public:
 
     TransportMgrBase & GetTransportManager() { return mTransports; }
 
+    CASESessionCache & GetCASESessionCache() { return mCASESessionCache; }
+
+#if CHIP_CONFIG_GROUP_MESSAGE_DECRYPTION
+    Transport::GroupKeyCache & GetGroupKeyCache() { return mGroupKeyCache; }
+#endif
+
 #if CONFIG_NETWORK_LAYER_BLE
     Ble::BleLayer * getBleLayerObject() { return mBleLayer; }
 #endif
@@ -146,6 +153,7 @@ private:
     ServerTransportMgr mTransports;
     SessionManager mSessions;
     CASEServer mCASEServer;
+    CASESessionCache mCASESessionCache;
 
     CASESessionManager mCASESessionManager;
     CASEClientPool<CHIP_CONFIG_DEVICE_MAX_ACTIVE_CASE_CLIENTS> mCASEClientPool;
@@ -168,6 +176,10 @@ private:
     // (https://github.com/project-chip/connectedhomeip/issues/12174)
     TestPersistentStorageDelegate mGroupsStorage;
     Credentials::GroupDataProviderImpl mGroupsProvider;
+#if CHIP_CONFIG_GROUP_MESSAGE_DECRYPTION
+    // Declared after mGroupsProvider so it is destroyed, and unregisters its listener, first.
+    Transport::GroupKeyCache mGroupKeyCache;
+#endif
     app::DefaultAttributePersistenceProvider mAttributePersister;
 
     // TODO @ceille: Maybe use OperationalServicePort and CommissionableServicePort
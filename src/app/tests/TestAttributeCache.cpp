@@ -24,14 +24,21 @@
 #include "system/TLVPacketBufferBackingStore.h"
 #include <app-common/zap-generated/cluster-objects.h>
 #include <app/AttributeCache.h>
+#include <app/FlatAttributeStore.h>
 #include <app/data-model/DecodableList.h>
 #include <app/data-model/Decode.h>
 #include <app/tests/AppTestContext.h>
 #include <lib/support/UnitTestRegistration.h>
 #include <nlunit-test.h>
 #include <string.h>
+#include <system/SystemClock.h>
 #include <vector>
 
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define TEST_HAS_MALLINFO2 1
+#endif
+
 using TestContext = chip::Test::AppContext;
 using namespace chip::app;
 using namespace chip;
@@ -453,10 +460,13 @@ CacheValidator::CacheValidator(AttributeInstructionListType & instructionList)
 
 void RunAndValidateSequence(AttributeInstructionListType list)
 {
-    CacheValidator client(list);
-    AttributeCache cache(client);
-    DataSeriesGenerator generator(&cache.GetBufferedCallback(), list);
-    generator.Generate();
+    for (auto storageMode : { AttributeCache::StorageMode::kMaps, AttributeCache::StorageMode::kFlatArena })
+    {
+        CacheValidator client(list);
+        AttributeCache cache(client, storageMode);
+        DataSeriesGenerator generator(&cache.GetBufferedCallback(), list);
+        generator.Generate();
+    }
 }
 
 /*
@@ -529,10 +539,237 @@ void TestCache(nlTestSuite * apSuite, void * apContext)
                              AttributeInstruction(AttributeInstruction::kAttributeB, 0, AttributeInstruction::kData) });
 }
 
+CHIP_ERROR SetUInt16(FlatAttributeStore & store, const ConcreteAttributePath & path, uint16_t value)
+{
+    uint8_t buf[16];
+    TLV::TLVWriter writer;
+    TLV::TLVReader reader;
+
+    writer.Init(buf);
+    ReturnErrorOnFailure(writer.Put(TLV::AnonymousTag(), value));
+    ReturnErrorOnFailure(writer.Finalize());
+
+    reader.Init(buf, writer.GetLengthWritten());
+    ReturnErrorOnFailure(reader.Next());
+    return store.SetData(path, reader);
+}
+
+CHIP_ERROR GetUInt16(FlatAttributeStore & store, const ConcreteAttributePath & path, uint16_t & value)
+{
+    TLV::TLVReader reader;
+
+    ReturnErrorOnFailure(store.GetData(path, reader));
+    return reader.Get(value);
+}
+
+void TestFlatAttributeStore(nlTestSuite * apSuite, void * apContext)
+{
+    FlatAttributeStore store;
+    StatusIB status;
+    uint16_t value;
+
+    //
+    // Insert out of order, and check lookups and iteration see the paths sorted.
+    //
+    NL_TEST_ASSERT(apSuite, SetUInt16(store, ConcreteAttributePath(2, 6, 0), 1) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, SetUInt16(store, ConcreteAttributePath(1, 8, 0), 2) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, SetUInt16(store, ConcreteAttributePath(1, 6, 3), 3) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, SetUInt16(store, ConcreteAttributePath(1, 6, 1), 4) == CHIP_NO_ERROR);
+    const StatusIB failure(Protocols::InteractionModel::Status::Failure);
+    NL_TEST_ASSERT(apSuite, store.SetStatus(ConcreteAttributePath(1, 6, 2), failure) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, store.GetAttributeCount() == 5);
+
+    NL_TEST_ASSERT(apSuite, GetUInt16(store, ConcreteAttributePath(1, 6, 1), value) == CHIP_NO_ERROR && value == 4);
+    NL_TEST_ASSERT(apSuite, GetUInt16(store, ConcreteAttributePath(1, 6, 3), value) == CHIP_NO_ERROR && value == 3);
+    NL_TEST_ASSERT(apSuite, GetUInt16(store, ConcreteAttributePath(2, 6, 0), value) == CHIP_NO_ERROR && value == 1);
+    NL_TEST_ASSERT(apSuite, GetUInt16(store, ConcreteAttributePath(1, 6, 2), value) == CHIP_ERROR_IM_STATUS_CODE_RECEIVED);
+    NL_TEST_ASSERT(apSuite, GetUInt16(store, ConcreteAttributePath(1, 6, 4), value) == CHIP_ERROR_KEY_NOT_FOUND);
+    NL_TEST_ASSERT(apSuite, store.GetStatus(ConcreteAttributePath(1, 6, 2), status) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, status.mStatus == Protocols::InteractionModel::Status::Failure);
+    NL_TEST_ASSERT(apSuite, store.GetStatus(ConcreteAttributePath(1, 6, 1), status) == CHIP_ERROR_INVALID_ARGUMENT);
+
+    NL_TEST_ASSERT(apSuite, store.HasEndpoint(1));
+    NL_TEST_ASSERT(apSuite, store.HasEndpoint(2));
+    NL_TEST_ASSERT(apSuite, !store.HasEndpoint(0));
+    NL_TEST_ASSERT(apSuite, !store.HasEndpoint(3));
+
+    std::vector<AttributeId> attributes;
+    NL_TEST_ASSERT(apSuite, store.ForEachAttribute(1, 6, [&attributes](const ConcreteAttributePath & path) {
+        attributes.push_back(path.mAttributeId);
+        return CHIP_NO_ERROR;
+    }) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, attributes == std::vector<AttributeId>({ 1, 2, 3 }));
+    NL_TEST_ASSERT(apSuite, store.ForEachAttribute(2, 8, [](const ConcreteAttributePath & path) {
+        return CHIP_NO_ERROR;
+    }) == CHIP_ERROR_KEY_NOT_FOUND);
+
+    std::vector<EndpointId> endpoints;
+    NL_TEST_ASSERT(apSuite, store.ForEachAttribute(6, [&endpoints](const ConcreteAttributePath & path) {
+        endpoints.push_back(path.mEndpointId);
+        return CHIP_NO_ERROR;
+    }) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, endpoints == std::vector<EndpointId>({ 1, 1, 1, 2 }));
+
+    std::vector<ClusterId> clusters;
+    NL_TEST_ASSERT(apSuite, store.ForEachCluster(1, [&clusters](ClusterId clusterId) {
+        clusters.push_back(clusterId);
+        return CHIP_NO_ERROR;
+    }) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, clusters == std::vector<ClusterId>({ 6, 8 }));
+
+    //
+    // Values of the same encoded size are updated in place.
+    //
+    TLV::TLVReader reader;
+    NL_TEST_ASSERT(apSuite, store.GetData(ConcreteAttributePath(1, 6, 1), reader) == CHIP_NO_ERROR);
+    const uint8_t * data   = reader.GetReadPoint();
+    const size_t allocated = store.GetAllocatedBytes();
+    NL_TEST_ASSERT(apSuite, SetUInt16(store, ConcreteAttributePath(1, 6, 1), 5) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, store.GetData(ConcreteAttributePath(1, 6, 1), reader) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, reader.GetReadPoint() == data);
+    NL_TEST_ASSERT(apSuite, store.GetAllocatedBytes() == allocated);
+    NL_TEST_ASSERT(apSuite, GetUInt16(store, ConcreteAttributePath(1, 6, 1), value) == CHIP_NO_ERROR && value == 5);
+
+    //
+    // Values changing size leave dead space behind, which Compact() gives back.
+    //
+    for (uint16_t i = 0; i < 4000; i++)
+    {
+        NL_TEST_ASSERT(apSuite, SetUInt16(store, ConcreteAttributePath(1, 6, 3), static_cast<uint16_t>(i % 2 ? 1000 : 1)) ==
+                           CHIP_NO_ERROR);
+    }
+    NL_TEST_ASSERT(apSuite, store.GetAllocatedBytes() > allocated + FlatAttributeStore::kArenaChunkSize);
+    store.Compact();
+    NL_TEST_ASSERT(apSuite, store.GetAllocatedBytes() < allocated + FlatAttributeStore::kArenaChunkSize);
+    NL_TEST_ASSERT(apSuite, GetUInt16(store, ConcreteAttributePath(1, 6, 3), value) == CHIP_NO_ERROR && value == 1000);
+    NL_TEST_ASSERT(apSuite, GetUInt16(store, ConcreteAttributePath(1, 8, 0), value) == CHIP_NO_ERROR && value == 2);
+    NL_TEST_ASSERT(apSuite, GetUInt16(store, ConcreteAttributePath(2, 6, 0), value) == CHIP_NO_ERROR && value == 1);
+
+    store.Clear();
+    NL_TEST_ASSERT(apSuite, store.GetAttributeCount() == 0);
+    NL_TEST_ASSERT(apSuite, GetUInt16(store, ConcreteAttributePath(1, 6, 1), value) == CHIP_ERROR_KEY_NOT_FOUND);
+}
+
+//
+// A bridge exposing this many devices, each on its own endpoint.
+//
+constexpr EndpointId kBridgeEndpoints   = 100;
+constexpr ClusterId kBridgeClusters     = 8;
+constexpr AttributeId kBridgeAttributes = 12;
+constexpr uint32_t kBridgeLookupRounds  = 20;
+constexpr size_t kBridgeAttributeCount  = kBridgeEndpoints * kBridgeClusters * kBridgeAttributes;
+
+class NullCacheCallback : public AttributeCache::Callback
+{
+    void OnDone(ReadClient * apReadClient) override {}
+};
+
+void ReportBridgeNode(nlTestSuite * apSuite, ReadClient::Callback & callback, uint16_t value)
+{
+    System::PacketBufferTLVWriter writer;
+    System::PacketBufferTLVReader reader;
+    System::PacketBufferHandle handle;
+    const uint8_t name[] = "Bridged device";
+
+    callback.OnReportBegin(nullptr);
+
+    for (EndpointId endpoint = 1; endpoint <= kBridgeEndpoints; endpoint++)
+    {
+        for (ClusterId cluster = 0; cluster < kBridgeClusters; cluster++)
+        {
+            for (AttributeId attribute = 0; attribute < kBridgeAttributes; attribute++)
+            {
+                writer.Init(System::PacketBufferHandle::New(64));
+
+                //
+                // Mostly numbers, with a few strings.
+                //
+                if (attribute % 4 == 3)
+                {
+                    NL_TEST_ASSERT(apSuite, writer.Put(TLV::AnonymousTag(), ByteSpan(name)) == CHIP_NO_ERROR);
+                }
+                else
+                {
+                    NL_TEST_ASSERT(apSuite, writer.Put(TLV::AnonymousTag(), value) == CHIP_NO_ERROR);
+                }
+
+                NL_TEST_ASSERT(apSuite, writer.Finalize(&handle) == CHIP_NO_ERROR);
+                reader.Init(std::move(handle));
+                NL_TEST_ASSERT(apSuite, reader.Next() == CHIP_NO_ERROR);
+                callback.OnAttributeData(nullptr, ConcreteDataAttributePath(endpoint, cluster, attribute), &reader, StatusIB());
+            }
+        }
+    }
+
+    callback.OnReportEnd(nullptr);
+}
+
+size_t GetHeapInUse()
+{
+#if TEST_HAS_MALLINFO2
+    return mallinfo2().uordblks;
+#else
+    return 0;
+#endif
+}
+
+/*
+ * Compares the memory held by the two storage modes for a bridge-sized node, and how fast they look attributes up.
+ */
+void TestBridgeNodeBenchmark(nlTestSuite * apSuite, void * apContext)
+{
+    NullCacheCallback callback;
+
+    for (auto storageMode : { AttributeCache::StorageMode::kMaps, AttributeCache::StorageMode::kFlatArena })
+    {
+        const size_t heapBefore = GetHeapInUse();
+        AttributeCache cache(callback, storageMode);
+
+        //
+        // Prime the cache, then apply a report changing every number, which the flat arena takes in place.
+        //
+        ReportBridgeNode(apSuite, cache.GetBufferedCallback(), 1);
+        ReportBridgeNode(apSuite, cache.GetBufferedCallback(), 2);
+        const size_t heapUsed = GetHeapInUse() - heapBefore;
+
+        uint32_t found = 0;
+        auto start     = System::SystemClock().GetMonotonicMicroseconds64();
+        for (uint32_t round = 0; round < kBridgeLookupRounds; round++)
+        {
+            for (EndpointId endpoint = 1; endpoint <= kBridgeEndpoints; endpoint++)
+            {
+                for (ClusterId cluster = 0; cluster < kBridgeClusters; cluster++)
+                {
+                    for (AttributeId attribute = 0; attribute < kBridgeAttributes; attribute += 4)
+                    {
+                        TLV::TLVReader reader;
+                        uint16_t value;
+                        if (cache.Get(ConcreteAttributePath(endpoint, cluster, attribute), reader) == CHIP_NO_ERROR &&
+                            reader.Get(value) == CHIP_NO_ERROR && value == 2)
+                        {
+                            found++;
+                        }
+                    }
+                }
+            }
+        }
+        auto elapsed = System::SystemClock().GetMonotonicMicroseconds64() - start;
+
+        NL_TEST_ASSERT(apSuite, found == kBridgeLookupRounds * kBridgeAttributeCount / 4);
+
+        printf("AttributeCache (%s): %u attributes, %llu bytes of heap, %u lookups in %llu us\n",
+               storageMode == AttributeCache::StorageMode::kMaps ? "maps" : "flat arena",
+               static_cast<unsigned>(kBridgeAttributeCount), static_cast<unsigned long long>(heapUsed),
+               static_cast<unsigned>(found), static_cast<unsigned long long>(elapsed.count()));
+    }
+}
+
 // clang-format off
 const nlTest sTests[] =
 {
     NL_TEST_DEF("TestCache", TestCache),
+    NL_TEST_DEF("TestFlatAttributeStore", TestFlatAttributeStore),
+    NL_TEST_DEF("TestBridgeNodeBenchmark", TestBridgeNodeBenchmark),
     NL_TEST_SENTINEL()
 };
 
@@ -0,0 +1,220 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements unit tests and a SetDirty benchmark for the
+ *      reporting engine's AttributePathIndex.
+ *
+ */
+
+#include <app/ClusterInfo.h>
+#include <app/reporting/AttributePathIndex.h>
+#include <lib/support/UnitTestRegistration.h>
+#include <system/SystemClock.h>
+
+#include <nlunit-test.h>
+
+#include <stdio.h>
+
+namespace {
+
+using namespace chip;
+using namespace chip::app;
+using chip::app::reporting::AttributePathIndex;
+
+ClusterInfo MakePath(EndpointId endpoint, ClusterId cluster, AttributeId attribute)
+{
+    ClusterInfo path;
+    path.mEndpointId  = endpoint;
+    path.mClusterId   = cluster;
+    path.mAttributeId = attribute;
+    return path;
+}
+
+void TestConcretePaths(nlTestSuite * apSuite, void * apContext)
+{
+    AttributePathIndex<8, 4> index;
+
+    NL_TEST_ASSERT(apSuite, index.Add(MakePath(1, 6, 0), 0) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, index.Add(MakePath(1, 6, 0), 2) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, index.Add(MakePath(1, 8, 0), 1) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, index.Count() == 2);
+
+    auto handlers = index.GetInterestedHandlers(MakePath(1, 6, 0));
+    NL_TEST_ASSERT(apSuite, handlers.count() == 2 && handlers.test(0) && handlers.test(2));
+
+    handlers = index.GetInterestedHandlers(MakePath(1, 8, 0));
+    NL_TEST_ASSERT(apSuite, handlers.count() == 1 && handlers.test(1));
+
+    NL_TEST_ASSERT(apSuite, index.GetInterestedHandlers(MakePath(2, 6, 0)).none());
+    NL_TEST_ASSERT(apSuite, index.GetInterestedHandlers(MakePath(1, 6, 1)).none());
+
+    NL_TEST_ASSERT(apSuite, index.Add(MakePath(1, 6, 0), 4) == CHIP_ERROR_INVALID_ARGUMENT);
+}
+
+void TestWildcardPaths(nlTestSuite * apSuite, void * apContext)
+{
+    AttributePathIndex<8, 4> index;
+
+    // Handler 0 subscribes to a whole cluster, handler 1 to one attribute on every
+    // endpoint, handler 2 to everything and handler 3 to one concrete attribute.
+    NL_TEST_ASSERT(apSuite, index.Add(MakePath(1, 6, kInvalidAttributeId), 0) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, index.Add(MakePath(kInvalidEndpointId, 8, 0), 1) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, index.Add(ClusterInfo(), 2) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, index.Add(MakePath(2, 6, 0), 3) == CHIP_NO_ERROR);
+
+    auto handlers = index.GetInterestedHandlers(MakePath(1, 6, 5));
+    NL_TEST_ASSERT(apSuite, handlers.count() == 2 && handlers.test(0) && handlers.test(2));
+
+    handlers = index.GetInterestedHandlers(MakePath(3, 8, 0));
+    NL_TEST_ASSERT(apSuite, handlers.count() == 2 && handlers.test(1) && handlers.test(2));
+
+    // A wildcard dirty path intersects both wider and narrower requested paths.
+    handlers = index.GetInterestedHandlers(MakePath(2, kInvalidClusterId, kInvalidAttributeId));
+    NL_TEST_ASSERT(apSuite, handlers.count() == 3 && handlers.test(1) && handlers.test(2) && handlers.test(3));
+
+    handlers = index.GetInterestedHandlers(MakePath(1, 6, kInvalidAttributeId));
+    NL_TEST_ASSERT(apSuite, handlers.count() == 2 && handlers.test(0) && handlers.test(2));
+}
+
+void TestRemoveHandler(nlTestSuite * apSuite, void * apContext)
+{
+    AttributePathIndex<16, 4> index;
+
+    // Churn handlers the way subscriptions come and go; paths shared between
+    // handlers must survive until their last handler is removed.
+    for (uint16_t round = 0; round < 20; round++)
+    {
+        for (uint8_t handler = 0; handler < 4; handler++)
+        {
+            for (AttributeId attribute = 0; attribute < 4; attribute++)
+            {
+                ClusterInfo path = MakePath(static_cast<EndpointId>(round + handler), 6, attribute);
+                NL_TEST_ASSERT(apSuite, index.Add(path, handler) == CHIP_NO_ERROR);
+            }
+        }
+
+        index.RemoveHandler(0);
+        index.RemoveHandler(2);
+        for (uint8_t handler = 0; handler < 4; handler++)
+        {
+            auto handlers = index.GetInterestedHandlers(MakePath(static_cast<EndpointId>(round + handler), 6, 3));
+            NL_TEST_ASSERT(apSuite, handlers.test(0) == false && handlers.test(2) == false);
+            NL_TEST_ASSERT(apSuite, handlers.test(handler) == (handler % 2 == 1));
+        }
+
+        index.RemoveHandler(1);
+        index.RemoveHandler(3);
+        NL_TEST_ASSERT(apSuite, index.Count() == 0);
+    }
+
+    // The index is full once every distinct path is used.
+    for (AttributeId attribute = 0; attribute < 16; attribute++)
+    {
+        NL_TEST_ASSERT(apSuite, index.Add(MakePath(1, 6, attribute), 0) == CHIP_NO_ERROR);
+    }
+    NL_TEST_ASSERT(apSuite, index.Add(MakePath(1, 6, 16), 0) == CHIP_ERROR_NO_MEMORY);
+    NL_TEST_ASSERT(apSuite, index.Add(MakePath(1, 6, 15), 1) == CHIP_NO_ERROR);
+}
+
+void TestSetDirtyBenchmark(nlTestSuite * apSuite, void * apContext)
+{
+    constexpr size_t kSubscribers      = 50;
+    constexpr size_t kPathsPerHandler  = 100;
+    constexpr uint32_t kDirtyPathCount = 20000;
+    constexpr EndpointId kEndpoints    = 20;
+
+    // Each subscriber watches 100 attributes spread over 20 endpoints; subscribers
+    // overlap on half of their paths.
+    static ClusterInfo sPaths[kSubscribers][kPathsPerHandler];
+    static AttributePathIndex<kSubscribers * kPathsPerHandler, 64> sIndex;
+    sIndex.Clear();
+
+    for (size_t handler = 0; handler < kSubscribers; handler++)
+    {
+        for (size_t i = 0; i < kPathsPerHandler; i++)
+        {
+            size_t attribute = (i % 2 == 0) ? i : (handler * kPathsPerHandler + i);
+            sPaths[handler][i] =
+                MakePath(static_cast<EndpointId>(i % kEndpoints), 0x0402, static_cast<AttributeId>(attribute / kEndpoints));
+            sPaths[handler][i].mpNext = (i + 1 < kPathsPerHandler) ? &sPaths[handler][i + 1] : nullptr;
+            NL_TEST_ASSERT(apSuite, sIndex.Add(sPaths[handler][i], handler) == CHIP_NO_ERROR);
+        }
+    }
+
+    // Linear scan, as the engine did before: every path of every handler.
+    size_t scanMatches = 0;
+    auto start         = System::SystemClock().GetMonotonicMicroseconds64();
+    for (uint32_t n = 0; n < kDirtyPathCount; n++)
+    {
+        ClusterInfo dirty = sPaths[n % kSubscribers][n % kPathsPerHandler];
+        for (size_t handler = 0; handler < kSubscribers; handler++)
+        {
+            for (auto path = &sPaths[handler][0]; path != nullptr; path = path->mpNext)
+            {
+                if (dirty.IsAttributePathSupersetOf(*path) || path->IsAttributePathSupersetOf(dirty))
+                {
+                    scanMatches++;
+                    break;
+                }
+            }
+        }
+    }
+    auto scanElapsed = System::SystemClock().GetMonotonicMicroseconds64() - start;
+
+    size_t indexMatches = 0;
+    start               = System::SystemClock().GetMonotonicMicroseconds64();
+    for (uint32_t n = 0; n < kDirtyPathCount; n++)
+    {
+        indexMatches += sIndex.GetInterestedHandlers(sPaths[n % kSubscribers][n % kPathsPerHandler]).count();
+    }
+    auto indexElapsed = System::SystemClock().GetMonotonicMicroseconds64() - start;
+
+    NL_TEST_ASSERT(apSuite, scanMatches == indexMatches);
+    printf("AttributePathIndex: %u subscribers x %u paths, %u SetDirty lookups: scan %llu us, index %llu us\n",
+           static_cast<unsigned>(kSubscribers), static_cast<unsigned>(kPathsPerHandler), static_cast<unsigned>(kDirtyPathCount),
+           static_cast<unsigned long long>(scanElapsed.count()), static_cast<unsigned long long>(indexElapsed.count()));
+
+    for (size_t handler = 0; handler < kSubscribers; handler++)
+    {
+        sIndex.RemoveHandler(handler);
+    }
+    NL_TEST_ASSERT(apSuite, sIndex.Count() == 0);
+}
+
+const nlTest sTests[] = {
+    NL_TEST_DEF("TestConcretePaths", TestConcretePaths),
+    NL_TEST_DEF("TestWildcardPaths", TestWildcardPaths),
+    NL_TEST_DEF("TestRemoveHandler", TestRemoveHandler),
+    NL_TEST_DEF("TestSetDirtyBenchmark", TestSetDirtyBenchmark),
+    NL_TEST_SENTINEL(),
+};
+
+} // namespace
+
+int TestAttributePathIndex()
+{
+    nlTestSuite theSuite = { "AttributePathIndex", &sTests[0], nullptr, nullptr };
+
+    nlTestRunner(&theSuite, nullptr);
+
+    return (nlTestRunnerStats(&theSuite));
+}
+
+CHIP_REGISTER_TEST_SUITE(TestAttributePathIndex)
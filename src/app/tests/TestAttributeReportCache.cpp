@@ -0,0 +1,139 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements unit tests for the reporting engine's AttributeReportCache.
+ *
+ */
+
+#include <app/reporting/AttributeReportCache.h>
+#include <lib/support/UnitTestRegistration.h>
+
+#include <nlunit-test.h>
+
+#include <string.h>
+
+namespace {
+
+using namespace chip;
+using namespace chip::app;
+using namespace chip::app::reporting;
+
+AttributeReportCacheKey MakeKey(AttributeId attribute, FabricIndex fabric)
+{
+    AttributeReportCacheKey key;
+    key.mPath                 = ConcreteAttributePath(1, 6, attribute);
+    key.mAccessingFabricIndex = fabric;
+    key.mIsFabricFiltered     = true;
+    key.mAccessAllowed        = true;
+    return key;
+}
+
+void Store(nlTestSuite * apSuite, AttributeReportCache<16, 2> & cache, const AttributeReportCacheKey & key, uint8_t value,
+           size_t length)
+{
+    MutableByteSpan space = cache.GetFreeSpace();
+    NL_TEST_ASSERT(apSuite, space.size() >= length);
+    memset(space.data(), value, length);
+    NL_TEST_ASSERT(apSuite, cache.Commit(key, length) == CHIP_NO_ERROR);
+}
+
+void TestFindCommitted(nlTestSuite * apSuite, void * apContext)
+{
+    AttributeReportCache<16, 2> cache;
+    ByteSpan encoded;
+
+    NL_TEST_ASSERT(apSuite, !cache.Find(MakeKey(0, 1), encoded));
+
+    Store(apSuite, cache, MakeKey(0, 1), 0xAA, 4);
+    Store(apSuite, cache, MakeKey(0, 2), 0xBB, 6);
+    NL_TEST_ASSERT(apSuite, cache.GetEntryCount() == 2);
+
+    NL_TEST_ASSERT(apSuite, cache.Find(MakeKey(0, 1), encoded));
+    NL_TEST_ASSERT(apSuite, encoded.size() == 4 && encoded.data()[0] == 0xAA && encoded.data()[3] == 0xAA);
+    NL_TEST_ASSERT(apSuite, cache.Find(MakeKey(0, 2), encoded));
+    NL_TEST_ASSERT(apSuite, encoded.size() == 6 && encoded.data()[0] == 0xBB && encoded.data()[5] == 0xBB);
+}
+
+void TestKeyFields(nlTestSuite * apSuite, void * apContext)
+{
+    AttributeReportCache<16, 2> cache;
+    ByteSpan encoded;
+
+    Store(apSuite, cache, MakeKey(0, 1), 0xAA, 4);
+
+    // Every field of the key matters.
+    AttributeReportCacheKey key = MakeKey(1, 1);
+    NL_TEST_ASSERT(apSuite, !cache.Find(key, encoded));
+
+    key = MakeKey(0, 1);
+    key.mPath.mExpanded = true;
+    NL_TEST_ASSERT(apSuite, !cache.Find(key, encoded));
+
+    key                   = MakeKey(0, 1);
+    key.mIsFabricFiltered = false;
+    NL_TEST_ASSERT(apSuite, !cache.Find(key, encoded));
+
+    key                = MakeKey(0, 1);
+    key.mAccessAllowed = false;
+    NL_TEST_ASSERT(apSuite, !cache.Find(key, encoded));
+
+    NL_TEST_ASSERT(apSuite, cache.Find(MakeKey(0, 1), encoded));
+}
+
+void TestCapacity(nlTestSuite * apSuite, void * apContext)
+{
+    AttributeReportCache<16, 2> cache;
+    ByteSpan encoded;
+
+    // The arena bounds the encoded size.
+    NL_TEST_ASSERT(apSuite, cache.Commit(MakeKey(0, 1), 17) == CHIP_ERROR_BUFFER_TOO_SMALL);
+    Store(apSuite, cache, MakeKey(0, 1), 0xAA, 12);
+    NL_TEST_ASSERT(apSuite, cache.GetFreeSpace().size() == 4);
+
+    // The entry table bounds the number of encodings.
+    Store(apSuite, cache, MakeKey(1, 1), 0xBB, 2);
+    NL_TEST_ASSERT(apSuite, cache.GetFreeSpace().empty());
+    NL_TEST_ASSERT(apSuite, cache.Commit(MakeKey(2, 1), 1) == CHIP_ERROR_NO_MEMORY);
+
+    cache.Clear();
+    NL_TEST_ASSERT(apSuite, cache.GetEntryCount() == 0);
+    NL_TEST_ASSERT(apSuite, cache.GetFreeSpace().size() == 16);
+    NL_TEST_ASSERT(apSuite, !cache.Find(MakeKey(0, 1), encoded));
+}
+
+const nlTest sTests[] = {
+    NL_TEST_DEF("TestFindCommitted", TestFindCommitted),
+    NL_TEST_DEF("TestKeyFields", TestKeyFields),
+    NL_TEST_DEF("TestCapacity", TestCapacity),
+    NL_TEST_SENTINEL(),
+};
+
+} // namespace
+
+int TestAttributeReportCache()
+{
+    nlTestSuite theSuite = { "AttributeReportCache", &sTests[0], nullptr, nullptr };
+
+    nlTestRunner(&theSuite, nullptr);
+
+    return (nlTestRunnerStats(&theSuite));
+}
+
+CHIP_REGISTER_TEST_SUITE(TestAttributeReportCache)
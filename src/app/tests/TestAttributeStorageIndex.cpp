@@ -0,0 +1,124 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements unit tests for EndpointLocationIndex.
+ *
+ */
+
+#include <app/util/attribute-storage-index.h>
+#include <lib/support/UnitTestRegistration.h>
+
+#include <nlunit-test.h>
+
+namespace {
+
+using namespace chip;
+using chip::app::EndpointLocationIndex;
+
+void TestInsertFind(nlTestSuite * apSuite, void * apContext)
+{
+    EndpointLocationIndex<8> index;
+
+    NL_TEST_ASSERT(apSuite, index.Find(0) == nullptr);
+    NL_TEST_ASSERT(apSuite, index.FindEndpointIndex(0) == EndpointLocationIndex<8>::kInvalidIndex);
+
+    NL_TEST_ASSERT(apSuite, index.Insert(0, 0, 0));
+    NL_TEST_ASSERT(apSuite, index.Insert(1, 1, 100));
+    NL_TEST_ASSERT(apSuite, index.Insert(0xFFFE, 2, 0));
+
+    // Duplicates are rejected and do not overwrite the existing entry.
+    NL_TEST_ASSERT(apSuite, !index.Insert(1, 5, 7));
+    NL_TEST_ASSERT(apSuite, index.Count() == 3);
+
+    const auto * location = index.Find(1);
+    NL_TEST_ASSERT(apSuite, location != nullptr);
+    NL_TEST_ASSERT(apSuite, location->endpointIndex == 1);
+    NL_TEST_ASSERT(apSuite, location->storageOffset == 100);
+    NL_TEST_ASSERT(apSuite, index.FindEndpointIndex(0xFFFE) == 2);
+    NL_TEST_ASSERT(apSuite, index.Find(2) == nullptr);
+}
+
+void TestCapacity(nlTestSuite * apSuite, void * apContext)
+{
+    EndpointLocationIndex<4> index;
+
+    for (uint16_t i = 0; i < 4; i++)
+    {
+        NL_TEST_ASSERT(apSuite, index.Insert(static_cast<EndpointId>(i * 16), i, 0));
+    }
+    NL_TEST_ASSERT(apSuite, !index.Insert(1000, 4, 0));
+
+    NL_TEST_ASSERT(apSuite, index.Remove(16));
+    NL_TEST_ASSERT(apSuite, index.Insert(1000, 4, 0));
+    NL_TEST_ASSERT(apSuite, index.FindEndpointIndex(1000) == 4);
+}
+
+void TestRemoveKeepsProbeChains(nlTestSuite * apSuite, void * apContext)
+{
+    EndpointLocationIndex<16> index;
+
+    // Churn through many add/remove cycles the way a bridge does with dynamic
+    // endpoints; every remaining entry must stay reachable.
+    for (uint16_t round = 0; round < 50; round++)
+    {
+        for (uint16_t i = 0; i < 16; i++)
+        {
+            EndpointId endpoint = static_cast<EndpointId>(round * 7 + i * 33);
+            NL_TEST_ASSERT(apSuite, index.Insert(endpoint, i, static_cast<uint16_t>(round)));
+        }
+        for (uint16_t i = 0; i < 16; i += 2)
+        {
+            NL_TEST_ASSERT(apSuite, index.Remove(static_cast<EndpointId>(round * 7 + i * 33)));
+        }
+        for (uint16_t i = 0; i < 16; i++)
+        {
+            EndpointId endpoint = static_cast<EndpointId>(round * 7 + i * 33);
+            bool shouldExist    = (i % 2) == 1;
+            NL_TEST_ASSERT(apSuite, (index.Find(endpoint) != nullptr) == shouldExist);
+            if (shouldExist)
+            {
+                NL_TEST_ASSERT(apSuite, index.FindEndpointIndex(endpoint) == i);
+                NL_TEST_ASSERT(apSuite, index.Remove(endpoint));
+            }
+        }
+        NL_TEST_ASSERT(apSuite, index.Count() == 0);
+        NL_TEST_ASSERT(apSuite, !index.Remove(static_cast<EndpointId>(round)));
+    }
+}
+
+const nlTest sTests[] = {
+    NL_TEST_DEF("TestInsertFind", TestInsertFind),
+    NL_TEST_DEF("TestCapacity", TestCapacity),
+    NL_TEST_DEF("TestRemoveKeepsProbeChains", TestRemoveKeepsProbeChains),
+    NL_TEST_SENTINEL(),
+};
+
+} // namespace
+
+int TestAttributeStorageIndex()
+{
+    nlTestSuite theSuite = { "EndpointLocationIndex", &sTests[0], nullptr, nullptr };
+
+    nlTestRunner(&theSuite, nullptr);
+
+    return (nlTestRunnerStats(&theSuite));
+}
+
+CHIP_REGISTER_TEST_SUITE(TestAttributeStorageIndex)
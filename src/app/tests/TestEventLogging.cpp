@@ -55,6 +55,11 @@ static const chip::TLV::Tag kLivenessDeviceStatus = chip::TLV::ContextTag(1);
 static uint8_t gDebugEventBuffer[128];
 static uint8_t gInfoEventBuffer[128];
 static uint8_t gCritEventBuffer[128];
+
+constexpr size_t kLargeEventBufferSize = 8192;
+static uint8_t gLargeDebugEventBuffer[kLargeEventBufferSize];
+static uint8_t gLargeInfoEventBuffer[kLargeEventBufferSize];
+static uint8_t gLargeCritEventBuffer[kLargeEventBufferSize];
 static chip::app::CircularEventBuffer gCircularEventBuffer[3];
 
 class TestContext : public chip::Test::AppContext
@@ -282,12 +287,198 @@ static void CheckLogEventWithDiscardLowEvent(nlTestSuite * apSuite, void * apCon
     NL_TEST_ASSERT(apSuite, err == CHIP_NO_ERROR);
     CheckLogState(apSuite, logMgmt, 3, chip::app::PriorityLevel::Debug);
 }
+
+static size_t FetchEventCount(nlTestSuite * apSuite, chip::app::EventManagement & aLogMgmt, chip::EventNumber aStartingEventNumber,
+                              chip::app::ClusterInfo * apClusterInfo)
+{
+    static uint8_t backingStore[4 * kLargeEventBufferSize];
+    chip::TLV::TLVWriter writer;
+    size_t eventCount = 0;
+
+    writer.Init(backingStore, sizeof(backingStore));
+    CHIP_ERROR err = aLogMgmt.FetchEventsSince(writer, apClusterInfo, aStartingEventNumber, eventCount);
+    NL_TEST_ASSERT(apSuite, err == CHIP_NO_ERROR || err == CHIP_END_OF_TLV);
+    return eventCount;
+}
+
+/**
+ * Fill larger buffers to increasing levels and time how long a subscriber that is a few events behind takes to fetch them,
+ * i.e. the report generation cost that depends on how much of the log is held.
+ */
+static void CheckFetchEventsSinceWithFullBuffers(nlTestSuite * apSuite, void * apContext)
+{
+    constexpr size_t kEventsBehind = 5;
+    constexpr int kFetchCount      = 200;
+    auto * ctx                     = static_cast<TestContext *>(apContext);
+    chip::app::EventOptions options;
+    TestEventGenerator testEventGenerator;
+    chip::EventNumber eventNumber = 0;
+
+    chip::app::EventManagement::DestroyEventManagement();
+    chip::app::LogStorageResources logStorageResources[] = {
+        { &gLargeDebugEventBuffer[0], sizeof(gLargeDebugEventBuffer), chip::app::PriorityLevel::Debug },
+        { &gLargeInfoEventBuffer[0], sizeof(gLargeInfoEventBuffer), chip::app::PriorityLevel::Info },
+        { &gLargeCritEventBuffer[0], sizeof(gLargeCritEventBuffer), chip::app::PriorityLevel::Critical },
+    };
+    chip::app::EventManagement::CreateEventManagement(&ctx->GetExchangeManager(), ArraySize(logStorageResources),
+                                                      gCircularEventBuffer, logStorageResources, nullptr, 0, nullptr);
+    chip::app::EventManagement & logMgmt = chip::app::EventManagement::GetInstance();
+
+    // Info events are never promoted to the critical buffer, so the log holds the latest run of events.
+    options.mPath     = { kTestEndpointId1, kLivenessClusterId, kLivenessChangeEvent };
+    options.mPriority = chip::app::PriorityLevel::Info;
+    chip::app::ClusterInfo clusterInfo;
+    clusterInfo.mNodeId     = kTestDeviceNodeId1;
+    clusterInfo.mEndpointId = kTestEndpointId1;
+    clusterInfo.mClusterId  = kLivenessClusterId;
+
+    const uint32_t capacity = sizeof(gLargeDebugEventBuffer) + sizeof(gLargeInfoEventBuffer);
+    auto usedLength         = []() { return gCircularEventBuffer[0].DataLength() + gCircularEventBuffer[1].DataLength(); };
+    int32_t status          = 0;
+    for (uint32_t fillPercent : { 10u, 25u, 50u, 75u, 100u })
+    {
+        // Buffers never get completely full, so to fill them up keep logging until they have wrapped around a few times.
+        int extraEvents = 1000;
+        do
+        {
+            testEventGenerator.SetStatus(status++);
+            NL_TEST_ASSERT(apSuite, logMgmt.LogEvent(&testEventGenerator, options, eventNumber) == CHIP_NO_ERROR);
+        } while ((fillPercent < 100) ? (usedLength() < capacity * fillPercent / 100) : (--extraEvents > 0));
+
+        size_t storedEvents = 0;
+        chip::TLV::TLVReader reader;
+        chip::app::CircularEventBufferWrapper bufWrapper;
+        NL_TEST_ASSERT(apSuite, logMgmt.GetEventReader(reader, chip::app::PriorityLevel::Critical, &bufWrapper) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(apSuite, chip::TLV::Utilities::Count(reader, storedEvents, false) == CHIP_NO_ERROR);
+
+        // Every starting point finds exactly the stored events from there on
+        for (chip::EventNumber start = eventNumber + 1 - storedEvents; start <= eventNumber + 1; start++)
+        {
+            NL_TEST_ASSERT(apSuite, FetchEventCount(apSuite, logMgmt, start, &clusterInfo) == eventNumber + 1 - start);
+        }
+
+        const uint64_t begin = chip::System::SystemClock().GetMonotonicMicroseconds64().count();
+        for (int i = 0; i < kFetchCount; i++)
+        {
+            size_t eventCount = FetchEventCount(apSuite, logMgmt, eventNumber + 1 - kEventsBehind, &clusterInfo);
+            NL_TEST_ASSERT(apSuite, eventCount == kEventsBehind);
+        }
+        const uint64_t elapsed = chip::System::SystemClock().GetMonotonicMicroseconds64().count() - begin;
+
+        printf("%3u%% full, %4zu events stored: %5.1f us to fetch the last %zu events\n",
+               static_cast<unsigned>(100 * usedLength() / capacity), storedEvents, static_cast<double>(elapsed) / kFetchCount,
+               kEventsBehind);
+    }
+}
+/**
+ * Collect the numbers of all the stored events, oldest first, and return how many there are.
+ */
+static size_t GetStoredEventNumbers(nlTestSuite * apSuite, chip::app::EventManagement & aLogMgmt,
+                                    chip::app::ClusterInfo * apClusterInfo, chip::EventNumber * apEventNumbers, size_t aMaxEvents)
+{
+    static uint8_t backingStore[4 * kLargeEventBufferSize];
+    chip::TLV::TLVWriter writer;
+    chip::TLV::TLVReader reader;
+    chip::EventNumber startingEventNumber = 0;
+    size_t eventCount                     = 0;
+    size_t storedEvents                   = 0;
+
+    writer.Init(backingStore, sizeof(backingStore));
+    CHIP_ERROR err = aLogMgmt.FetchEventsSince(writer, apClusterInfo, startingEventNumber, eventCount);
+    NL_TEST_ASSERT(apSuite, err == CHIP_NO_ERROR || err == CHIP_END_OF_TLV);
+
+    reader.Init(backingStore, writer.GetLengthWritten());
+    while (reader.Next() == CHIP_NO_ERROR && storedEvents < aMaxEvents)
+    {
+        chip::app::EventReportIB::Parser report;
+        chip::app::EventDataIB::Parser data;
+        NL_TEST_ASSERT(apSuite, report.Init(reader) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(apSuite, report.GetEventData(&data) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(apSuite, data.GetEventNumber(&apEventNumbers[storedEvents]) == CHIP_NO_ERROR);
+        storedEvents++;
+    }
+    NL_TEST_ASSERT(apSuite, storedEvents == eventCount);
+    return storedEvents;
+}
+
+/**
+ * Log events of mixed priorities into buffers small enough to wrap around many times, so that critical events are moved
+ * through the info buffer into the critical one, and indexed there as they are copied, while the other events are dropped.
+ * Then fetch from every event number, so that the fetches start in every buffer, both in the middle of one and past all the
+ * events of the critical buffer.
+ */
+static void CheckFetchEventsSinceWithMixedPriorities(nlTestSuite * apSuite, void * apContext)
+{
+    constexpr uint32_t kBufferSize  = 1024;
+    constexpr size_t kMaxEvents     = 512;
+    constexpr int kEventsPerRound   = 60;
+    const chip::app::PriorityLevel kPriorities[] = {
+        chip::app::PriorityLevel::Debug, chip::app::PriorityLevel::Critical, chip::app::PriorityLevel::Info,
+        chip::app::PriorityLevel::Info,  chip::app::PriorityLevel::Critical, chip::app::PriorityLevel::Debug,
+        chip::app::PriorityLevel::Debug, chip::app::PriorityLevel::Critical,
+    };
+    auto * ctx = static_cast<TestContext *>(apContext);
+    chip::app::EventOptions options;
+    TestEventGenerator testEventGenerator;
+    chip::EventNumber eventNumber = 0;
+    static chip::EventNumber storedEventNumbers[kMaxEvents];
+
+    chip::app::EventManagement::DestroyEventManagement();
+    chip::app::LogStorageResources logStorageResources[] = {
+        { &gLargeDebugEventBuffer[0], kBufferSize, chip::app::PriorityLevel::Debug },
+        { &gLargeInfoEventBuffer[0], kBufferSize, chip::app::PriorityLevel::Info },
+        { &gLargeCritEventBuffer[0], kBufferSize, chip::app::PriorityLevel::Critical },
+    };
+    chip::app::EventManagement::CreateEventManagement(&ctx->GetExchangeManager(), ArraySize(logStorageResources),
+                                                      gCircularEventBuffer, logStorageResources, nullptr, 0, nullptr);
+    chip::app::EventManagement & logMgmt = chip::app::EventManagement::GetInstance();
+
+    options.mPath = { kTestEndpointId1, kLivenessClusterId, kLivenessChangeEvent };
+    chip::app::ClusterInfo clusterInfo;
+    clusterInfo.mNodeId     = kTestDeviceNodeId1;
+    clusterInfo.mEndpointId = kTestEndpointId1;
+    clusterInfo.mClusterId  = kLivenessClusterId;
+
+    int32_t status = 0;
+    for (int round = 0; round < 8; round++)
+    {
+        for (int i = 0; i < kEventsPerRound; i++)
+        {
+            options.mPriority = kPriorities[static_cast<size_t>(status) % ArraySize(kPriorities)];
+            testEventGenerator.SetStatus(status++);
+            NL_TEST_ASSERT(apSuite, logMgmt.LogEvent(&testEventGenerator, options, eventNumber) == CHIP_NO_ERROR);
+        }
+
+        const size_t storedEvents = GetStoredEventNumbers(apSuite, logMgmt, &clusterInfo, storedEventNumbers, kMaxEvents);
+        NL_TEST_ASSERT(apSuite, storedEvents > 0 && storedEventNumbers[storedEvents - 1] == eventNumber);
+
+        // Every starting point finds exactly the stored events from there on, including where events were dropped.
+        size_t remainingEvents = storedEvents;
+        for (chip::EventNumber start = 0; start <= eventNumber + 1; start++)
+        {
+            while (remainingEvents > 0 && storedEventNumbers[storedEvents - remainingEvents] < start)
+            {
+                remainingEvents--;
+            }
+            NL_TEST_ASSERT(apSuite, FetchEventCount(apSuite, logMgmt, start, &clusterInfo) == remainingEvents);
+        }
+    }
+
+    // The critical buffer has wrapped around, so fetching its newest events skips part of it, and the newest event, still in
+    // the debug buffer, skips it entirely.
+    NL_TEST_ASSERT(apSuite, gCircularEventBuffer[2].GetSkippableLength(eventNumber) > 0);
+    NL_TEST_ASSERT(apSuite, !gCircularEventBuffer[2].HasEventsSince(eventNumber));
+}
+
 /**
  *   Test Suite. It lists all the test functions.
  */
 
 const nlTest sTests[] = { NL_TEST_DEF("CheckLogEventWithEvictToNextBuffer", CheckLogEventWithEvictToNextBuffer),
-                          NL_TEST_DEF("CheckLogEventWithDiscardLowEvent", CheckLogEventWithDiscardLowEvent), NL_TEST_SENTINEL() };
+                          NL_TEST_DEF("CheckLogEventWithDiscardLowEvent", CheckLogEventWithDiscardLowEvent),
+                          NL_TEST_DEF("CheckFetchEventsSinceWithFullBuffers", CheckFetchEventsSinceWithFullBuffers),
+                          NL_TEST_DEF("CheckFetchEventsSinceWithMixedPriorities", CheckFetchEventsSinceWithMixedPriorities),
+                          NL_TEST_SENTINEL() };
 
 // clang-format off
 nlTestSuite sSuite =
@@ -24,10 +24,12 @@
 
 #include "lib/support/CHIPMem.h"
 #include <app/AttributeAccessInterface.h>
+#include <app/AttributeCache.h>
 #include <app/InteractionModelEngine.h>
 #include <app/MessageDef/AttributeReportIBs.h>
 #include <app/MessageDef/EventDataIB.h>
 #include <app/tests/AppTestContext.h>
+#include <app/util/MatterCallbacks.h>
 #include <app/util/basic-types.h>
 #include <app/util/mock/Constants.h>
 #include <app/util/mock/Functions.h>
@@ -57,6 +59,15 @@ chip::EventId kTestEventIdCritical    = 2;
 uint8_t kTestFieldValue1              = 1;
 chip::TLV::Tag kTestEventTag          = chip::TLV::ContextTag(1);
 
+// Reads of mock attribute 1 and 4 that start encoding from scratch, i.e. that do not continue a chunked list.
+int gNumMockAttribute1Reads = 0;
+int gNumMockAttribute4Reads = 0;
+// Reads of mock attribute 1 that were handed the access control check already made by the reporting engine.
+int gNumMockAttribute1CheckedReads = 0;
+// Pre and post read callbacks for mock attribute 1, which run whether or not its encoding comes from the report cache.
+int gNumMockAttribute1PreReadCallbacks  = 0;
+int gNumMockAttribute1PostReadCallbacks = 0;
+
 class TestContext : public chip::Test::AppContext
 {
 public:
@@ -181,16 +192,54 @@ public:
     uint32_t mNumSubscriptions             = 0;
     chip::app::ReadHandler * mpReadHandler = nullptr;
 };
+
+class DataVersionCacheCallback : public chip::app::AttributeCache::Callback
+{
+public:
+    void OnAttributeData(const chip::app::ReadClient * apReadClient, const chip::app::ConcreteDataAttributePath & aPath,
+                         chip::TLV::TLVReader * apData, const chip::app::StatusIB & status) override
+    {
+        if (status.mStatus == chip::Protocols::InteractionModel::Status::Success)
+        {
+            mNumAttributeResponse++;
+        }
+    }
+
+    void OnError(const chip::app::ReadClient * apReadClient, CHIP_ERROR aError) override { mReadError = true; }
+
+    void OnDone(chip::app::ReadClient * apReadClient) override {}
+
+    int mNumAttributeResponse = 0;
+    bool mReadError           = false;
+};
 } // namespace
 
+void MatterPreAttributeReadCallback(const chip::app::ConcreteAttributePath & attributePath)
+{
+    gNumMockAttribute1PreReadCallbacks += (attributePath.mAttributeId == chip::Test::MockAttributeId(1)) ? 1 : 0;
+}
+
+void MatterPostAttributeReadCallback(const chip::app::ConcreteAttributePath & attributePath)
+{
+    gNumMockAttribute1PostReadCallbacks += (attributePath.mAttributeId == chip::Test::MockAttributeId(1)) ? 1 : 0;
+}
+
 namespace chip {
 namespace app {
 CHIP_ERROR ReadSingleClusterData(const Access::SubjectDescriptor & aSubjectDescriptor, bool aIsFabricFiltered,
                                  const ConcreteReadAttributePath & aPath, AttributeReportIBs::Builder & aAttributeReports,
-                                 AttributeValueEncoder::AttributeEncodeState * apEncoderState)
+                                 AttributeValueEncoder::AttributeEncodeState * apEncoderState,
+                                 const CHIP_ERROR * apAccessCheckResult)
 {
     if (aPath.mClusterId >= Test::kMockEndpointMin)
     {
+        if (apEncoderState == nullptr || !apEncoderState->AllowPartialData())
+        {
+            gNumMockAttribute1Reads += (aPath.mAttributeId == Test::MockAttributeId(1)) ? 1 : 0;
+            gNumMockAttribute4Reads += (aPath.mAttributeId == Test::MockAttributeId(4)) ? 1 : 0;
+            gNumMockAttribute1CheckedReads +=
+                (aPath.mAttributeId == Test::MockAttributeId(1) && apAccessCheckResult != nullptr) ? 1 : 0;
+        }
         return Test::ReadSingleMockClusterData(aSubjectDescriptor.fabricIndex, aPath, aAttributeReports, apEncoderState);
     }
 
@@ -219,6 +268,16 @@ CHIP_ERROR ReadSingleClusterData(const Access::SubjectDescriptor & aSubjectDescr
     return AttributeValueEncoder(aAttributeReports, 0, aPath, 0).Encode(kTestFieldValue1);
 }
 
+bool IsClusterDataVersionEqual(const ConcreteClusterPath & aConcreteClusterPath, DataVersion aRequiredVersion)
+{
+    if (aConcreteClusterPath.mEndpointId >= Test::kMockEndpointMin)
+    {
+        return Test::GetVersion() == aRequiredVersion;
+    }
+
+    return false;
+}
+
 class TestReadInteraction
 {
 public:
@@ -234,6 +293,8 @@ public:
     static void TestReadRoundtrip(nlTestSuite * apSuite, void * apContext);
     static void TestReadWildcard(nlTestSuite * apSuite, void * apContext);
     static void TestReadChunking(nlTestSuite * apSuite, void * apContext);
+    static void TestReadSharedChunking(nlTestSuite * apSuite, void * apContext);
+    static void TestReadDataVersionFilter(nlTestSuite * apSuite, void * apContext);
     static void TestSetDirtyBetweenChunks(nlTestSuite * apSuite, void * apContext);
     static void TestSubscribeRoundtrip(nlTestSuite * apSuite, void * apContext);
     static void TestSubscribeWildcard(nlTestSuite * apSuite, void * apContext);
@@ -795,6 +856,155 @@ void TestReadInteraction::TestReadChunking(nlTestSuite * apSuite, void * apConte
     engine->Shutdown();
 }
 
+// TestReadSharedChunking has two read clients read a small attribute and a large attribute that is split across reports. The
+// small attribute is encoded once, with the access control check made for the report cache, and shared between the two read
+// handlers, each of which still runs the read callbacks; the large one does not fit the report cache, and each read handler
+// encodes it exactly once, chunk by chunk.
+void TestReadInteraction::TestReadSharedChunking(nlTestSuite * apSuite, void * apContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(apContext);
+    CHIP_ERROR err    = CHIP_NO_ERROR;
+
+    Messaging::ReliableMessageMgr * rm = ctx.GetExchangeManager().GetReliableMessageMgr();
+    // Shouldn't have anything in the retransmit table when starting the test.
+    NL_TEST_ASSERT(apSuite, rm->TestGetCountRetransTable() == 0);
+
+    MockInteractionModelApp delegate1;
+    MockInteractionModelApp delegate2;
+    auto * engine = chip::app::InteractionModelEngine::GetInstance();
+    err           = engine->Init(&ctx.GetExchangeManager(), &delegate1);
+    NL_TEST_ASSERT(apSuite, err == CHIP_NO_ERROR);
+
+    chip::app::AttributePathParams attributePathParams[2];
+    attributePathParams[0].mEndpointId  = Test::kMockEndpoint3;
+    attributePathParams[0].mClusterId   = Test::MockClusterId(2);
+    attributePathParams[0].mAttributeId = Test::MockAttributeId(1);
+    // Mock Attribute 4 is a big attribute, with 6 large OCTET_STRING
+    attributePathParams[1].mEndpointId  = Test::kMockEndpoint3;
+    attributePathParams[1].mClusterId   = Test::MockClusterId(2);
+    attributePathParams[1].mAttributeId = Test::MockAttributeId(4);
+
+    ReadPrepareParams readPrepareParams(ctx.GetSessionBobToAlice());
+    readPrepareParams.mpEventPathParamsList        = nullptr;
+    readPrepareParams.mEventPathParamsListSize     = 0;
+    readPrepareParams.mpAttributePathParamsList    = attributePathParams;
+    readPrepareParams.mAttributePathParamsListSize = 2;
+
+    gNumMockAttribute1Reads             = 0;
+    gNumMockAttribute4Reads             = 0;
+    gNumMockAttribute1CheckedReads      = 0;
+    gNumMockAttribute1PreReadCallbacks  = 0;
+    gNumMockAttribute1PostReadCallbacks = 0;
+
+    {
+        app::ReadClient readClient1(chip::app::InteractionModelEngine::GetInstance(), &ctx.GetExchangeManager(), delegate1,
+                                    chip::app::ReadClient::InteractionType::Read);
+        app::ReadClient readClient2(chip::app::InteractionModelEngine::GetInstance(), &ctx.GetExchangeManager(), delegate2,
+                                    chip::app::ReadClient::InteractionType::Read);
+
+        err = readClient1.SendRequest(readPrepareParams);
+        NL_TEST_ASSERT(apSuite, err == CHIP_NO_ERROR);
+        err = readClient2.SendRequest(readPrepareParams);
+        NL_TEST_ASSERT(apSuite, err == CHIP_NO_ERROR);
+
+        for (int i = 0; i < 5; i++)
+        {
+            InteractionModelEngine::GetInstance()->GetReportingEngine().Run();
+        }
+
+        // One boolean, then one empty list with 6 array elements.
+        NL_TEST_ASSERT(apSuite, delegate1.mNumAttributeResponse == 8);
+        NL_TEST_ASSERT(apSuite, delegate2.mNumAttributeResponse == 8);
+        NL_TEST_ASSERT(apSuite, !delegate1.mReadError && !delegate2.mReadError);
+        NL_TEST_ASSERT(apSuite, gNumMockAttribute1Reads == 1);
+        NL_TEST_ASSERT(apSuite, gNumMockAttribute1CheckedReads == 1);
+        NL_TEST_ASSERT(apSuite, gNumMockAttribute1PreReadCallbacks == 2);
+        NL_TEST_ASSERT(apSuite, gNumMockAttribute1PostReadCallbacks == 2);
+        NL_TEST_ASSERT(apSuite, gNumMockAttribute4Reads == 2);
+        // By now we should have closed all exchanges and sent all pending acks, so
+        // there should be no queued-up things in the retransmit table.
+        NL_TEST_ASSERT(apSuite, rm->TestGetCountRetransTable() == 0);
+    }
+
+    NL_TEST_ASSERT(apSuite, engine->GetNumActiveReadClients() == 0);
+    engine->Shutdown();
+}
+
+// TestReadDataVersionFilter reads the same cluster three times through an AttributeCache: the second read sends the version the
+// cache holds, so the server leaves the unchanged cluster out of the report; the third read follows a change of the cluster.
+void TestReadInteraction::TestReadDataVersionFilter(nlTestSuite * apSuite, void * apContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(apContext);
+    CHIP_ERROR err    = CHIP_NO_ERROR;
+
+    Messaging::ReliableMessageMgr * rm = ctx.GetExchangeManager().GetReliableMessageMgr();
+    // Shouldn't have anything in the retransmit table when starting the test.
+    NL_TEST_ASSERT(apSuite, rm->TestGetCountRetransTable() == 0);
+
+    MockInteractionModelApp delegate;
+    auto * engine = chip::app::InteractionModelEngine::GetInstance();
+    err           = engine->Init(&ctx.GetExchangeManager(), &delegate);
+    NL_TEST_ASSERT(apSuite, err == CHIP_NO_ERROR);
+
+    chip::app::AttributePathParams attributePathParams[1];
+    attributePathParams[0].mEndpointId = Test::kMockEndpoint2;
+    attributePathParams[0].mClusterId  = Test::MockClusterId(3);
+
+    ReadPrepareParams readPrepareParams(ctx.GetSessionBobToAlice());
+    readPrepareParams.mpAttributePathParamsList    = attributePathParams;
+    readPrepareParams.mAttributePathParamsListSize = 1;
+
+    DataVersionCacheCallback callback;
+    AttributeCache cache(callback);
+
+    auto doRead = [&]() -> size_t {
+        ctx.GetLoopback().mSentMessageBytes = 0;
+        callback.mNumAttributeResponse      = 0;
+
+        app::ReadClient readClient(chip::app::InteractionModelEngine::GetInstance(), &ctx.GetExchangeManager(),
+                                   cache.GetBufferedCallback(), chip::app::ReadClient::InteractionType::Read);
+
+        err = readClient.SendRequest(readPrepareParams);
+        NL_TEST_ASSERT(apSuite, err == CHIP_NO_ERROR);
+
+        InteractionModelEngine::GetInstance()->GetReportingEngine().Run();
+        NL_TEST_ASSERT(apSuite, !callback.mReadError);
+        // By now we should have closed all exchanges and sent all pending acks, so
+        // there should be no queued-up things in the retransmit table.
+        NL_TEST_ASSERT(apSuite, rm->TestGetCountRetransTable() == 0);
+
+        return ctx.GetLoopback().mSentMessageBytes;
+    };
+
+    size_t coldBytes = doRead();
+    NL_TEST_ASSERT(apSuite, callback.mNumAttributeResponse == 5);
+
+    Optional<DataVersion> version;
+    cache.GetVersion(Test::kMockEndpoint2, Test::MockClusterId(3), version);
+    NL_TEST_ASSERT(apSuite, version.HasValue() && version.Value() == Test::GetVersion());
+
+    size_t warmBytes = doRead();
+    NL_TEST_ASSERT(apSuite, callback.mNumAttributeResponse == 0);
+    NL_TEST_ASSERT(apSuite, warmBytes < coldBytes);
+
+    // The attributes left out of the report are still served from the cache.
+    TLV::TLVReader reader;
+    ConcreteAttributePath cachedPath(Test::kMockEndpoint2, Test::MockClusterId(3), Test::MockAttributeId(1));
+    NL_TEST_ASSERT(apSuite, cache.Get(cachedPath, reader) == CHIP_NO_ERROR);
+
+    Test::BumpVersion();
+
+    size_t changedBytes = doRead();
+    NL_TEST_ASSERT(apSuite, callback.mNumAttributeResponse == 5);
+    NL_TEST_ASSERT(apSuite, changedBytes > warmBytes);
+
+    cache.GetVersion(Test::kMockEndpoint2, Test::MockClusterId(3), version);
+    NL_TEST_ASSERT(apSuite, version.HasValue() && version.Value() == Test::GetVersion());
+
+    NL_TEST_ASSERT(apSuite, engine->GetNumActiveReadClients() == 0);
+    engine->Shutdown();
+}
+
 void TestReadInteraction::TestSetDirtyBetweenChunks(nlTestSuite * apSuite, void * apContext)
 {
     TestContext & ctx = *static_cast<TestContext *>(apContext);
@@ -1438,6 +1648,8 @@ const nlTest sTests[] =
     NL_TEST_DEF("TestReadRoundtrip", chip::app::TestReadInteraction::TestReadRoundtrip),
     NL_TEST_DEF("TestReadWildcard", chip::app::TestReadInteraction::TestReadWildcard),
     NL_TEST_DEF("TestReadChunking", chip::app::TestReadInteraction::TestReadChunking),
+    NL_TEST_DEF("TestReadSharedChunking", chip::app::TestReadInteraction::TestReadSharedChunking),
+    NL_TEST_DEF("TestReadDataVersionFilter", chip::app::TestReadInteraction::TestReadDataVersionFilter),
     NL_TEST_DEF("TestSetDirtyBetweenChunks", chip::app::TestReadInteraction::TestSetDirtyBetweenChunks),
     NL_TEST_DEF("CheckReadClient", chip::app::TestReadInteraction::TestReadClient),
     NL_TEST_DEF("CheckReadHandler", chip::app::TestReadInteraction::TestReadHandler),
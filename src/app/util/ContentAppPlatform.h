@@ -57,7 +57,9 @@ public:
 
     // add and remove apps from the platform.
     // This will assign the app to an endpoint and make it accessible via Matter
-    int AddContentApp(ContentApp * app, EmberAfEndpointType * ep, uint16_t deviceType);
+    // The data version storage must outlive the app's endpoint, see emberAfSetDynamicEndpoint
+    int AddContentApp(ContentApp * app, EmberAfEndpointType * ep, const Span<DataVersion> & dataVersionStorage,
+                      uint16_t deviceType);
     int RemoveContentApp(ContentApp * app);
 
     // load and unload by vendor id
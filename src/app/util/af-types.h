@@ -394,6 +394,11 @@ typedef struct
      * Meta-data about the endpoint
      */
     EmberAfEndpointBitmask bitmask;
+    /**
+     * Data versions of the clusters on this endpoint, one per entry of
+     * endpointType->cluster.
+     */
+    chip::DataVersion * dataVersions;
 } EmberAfDefinedEndpoint;
 
 // Cluster specific types
@@ -0,0 +1,202 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <lib/core/DataModelTypes.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace chip {
+namespace app {
+
+/**
+ * Maps an endpoint id to the index of its emAfEndpoints[] slot and to the
+ * offset of its first attribute inside the attribute storage block.
+ *
+ * Without this, every attribute access has to walk all endpoints in order
+ * (summing up storage sizes along the way), which makes lookups linear in the
+ * number of endpoints. The index is an open-addressed table with linear
+ * probing and backward-shift deletion, so it never accumulates tombstones
+ * no matter how often dynamic endpoints come and go.
+ *
+ * @tparam kMaxEndpoints maximum number of endpoints that can be indexed at once.
+ */
+template <size_t kMaxEndpoints>
+class EndpointLocationIndex
+{
+public:
+    static constexpr uint16_t kInvalidIndex = 0xFFFF;
+
+    struct Location
+    {
+        /// Index of the endpoint in emAfEndpoints[].
+        uint16_t endpointIndex;
+        /// Offset of the endpoint's first attribute in the attribute storage block.
+        uint16_t storageOffset;
+    };
+
+    EndpointLocationIndex() { Clear(); }
+
+    void Clear()
+    {
+        for (auto & bucket : mBuckets)
+        {
+            bucket.used = false;
+        }
+        mCount = 0;
+    }
+
+    /**
+     * Adds an endpoint to the index.
+     *
+     * @return false if the endpoint is already indexed or the index is full. An
+     *         existing entry is never overwritten, so the first endpoint
+     *         registered with a given id wins, matching the ordered scan.
+     */
+    bool Insert(EndpointId endpoint, uint16_t endpointIndex, uint16_t storageOffset)
+    {
+        if (mCount >= kMaxEndpoints)
+        {
+            return false;
+        }
+
+        size_t bucket = HomeBucket(endpoint);
+        while (mBuckets[bucket].used)
+        {
+            if (mBuckets[bucket].endpoint == endpoint)
+            {
+                return false;
+            }
+            bucket = Next(bucket);
+        }
+
+        mBuckets[bucket].used     = true;
+        mBuckets[bucket].endpoint = endpoint;
+        mBuckets[bucket].location = { endpointIndex, storageOffset };
+        mCount++;
+        return true;
+    }
+
+    /**
+     * Removes an endpoint from the index.  Entries that follow it in the same
+     * probe run are shifted back so that lookups never need tombstones.
+     *
+     * @return false if the endpoint was not indexed.
+     */
+    bool Remove(EndpointId endpoint)
+    {
+        size_t hole = 0;
+        if (!FindBucket(endpoint, hole))
+        {
+            return false;
+        }
+
+        size_t bucket = Next(hole);
+        while (mBuckets[bucket].used)
+        {
+            size_t home = HomeBucket(mBuckets[bucket].endpoint);
+            // Move the entry into the hole if its home bucket does not lie in
+            // the cyclic range (hole, bucket].
+            bool homeInRange = (hole <= bucket) ? (hole < home && home <= bucket) : (hole < home || home <= bucket);
+            if (!homeInRange)
+            {
+                mBuckets[hole] = mBuckets[bucket];
+                hole           = bucket;
+            }
+            bucket = Next(bucket);
+        }
+
+        mBuckets[hole].used = false;
+        mCount--;
+        return true;
+    }
+
+    /**
+     * @return the location of the endpoint, or nullptr if it is not indexed.
+     */
+    const Location * Find(EndpointId endpoint) const
+    {
+        size_t bucket = 0;
+        return FindBucket(endpoint, bucket) ? &mBuckets[bucket].location : nullptr;
+    }
+
+    /**
+     * @return the emAfEndpoints[] index of the endpoint, or kInvalidIndex if it is not indexed.
+     */
+    uint16_t FindEndpointIndex(EndpointId endpoint) const
+    {
+        const Location * location = Find(endpoint);
+        return (location == nullptr) ? kInvalidIndex : location->endpointIndex;
+    }
+
+    size_t Count() const { return mCount; }
+
+private:
+    static constexpr size_t ComputeBucketCount(size_t minimum)
+    {
+        size_t count = 1;
+        while (count < minimum)
+        {
+            count <<= 1;
+        }
+        return count;
+    }
+
+    // Keep the load factor at or below 1/2 so probe runs stay short.
+    static constexpr size_t kBucketCount = ComputeBucketCount(2 * kMaxEndpoints + 1);
+    static constexpr size_t kBucketMask  = kBucketCount - 1;
+
+    struct Bucket
+    {
+        Location location;
+        EndpointId endpoint;
+        bool used;
+    };
+
+    static size_t HomeBucket(EndpointId endpoint)
+    {
+        // Multiplying by an odd constant is a bijection modulo a power of two,
+        // so consecutive endpoint ids (the common case) never collide while
+        // strided ids still get spread out.
+        return (static_cast<size_t>(endpoint) * 40503u) & kBucketMask;
+    }
+
+    static size_t Next(size_t bucket) { return (bucket + 1) & kBucketMask; }
+
+    bool FindBucket(EndpointId endpoint, size_t & outBucket) const
+    {
+        size_t bucket = HomeBucket(endpoint);
+        while (mBuckets[bucket].used)
+        {
+            if (mBuckets[bucket].endpoint == endpoint)
+            {
+                outBucket = bucket;
+                return true;
+            }
+            bucket = Next(bucket);
+        }
+        return false;
+    }
+
+    Bucket mBuckets[kBucketCount];
+    size_t mCount = 0;
+};
+
+} // namespace app
+} // namespace chip
@@ -44,7 +44,9 @@
 #include <app/InteractionModelEngine.h>
 #include <app/reporting/reporting.h>
 #include <app/util/af.h>
+#include <app/util/attribute-storage-index.h>
 #include <app/util/attribute-storage.h>
+#include <crypto/RandUtils.h>
 #include <lib/support/CodeUtils.h>
 #include <lib/support/logging/CHIPLogging.h>
 
@@ -80,6 +82,10 @@ uint8_t singletonAttributeData[ACTUAL_SINGLETONS_SIZE];
 
 uint16_t emberEndpointCount = 0;
 
+// Maps endpoint ids to their emAfEndpoints[] slot and attribute storage
+// offset, so attribute lookups do not have to walk every endpoint.
+app::EndpointLocationIndex<MAX_ENDPOINT_COUNT> endpointLocationIndex;
+
 // If we have attributes that are more than 2 bytes, then
 // we need this data block for the defaults
 #if (defined(GENERATED_DEFAULTS) && GENERATED_DEFAULTS_COUNT)
@@ -105,6 +111,21 @@ constexpr const EmberAfEndpointType generatedEmberAfEndpointTypes[] = GENERATED_
 // Added 'Macro' to silence MISRA warning about conflict with synonymous vars.
 #define endpointTypeMacro(x) (EmberAfEndpointType *) &(generatedEmberAfEndpointTypes[fixedEmberAfEndpointTypes[x]])
 #define endpointNetworkIndex(x) fixedNetworks[x]
+
+constexpr const uint8_t fixedEndpointTypesForDataVersions[] = FIXED_ENDPOINT_TYPES;
+
+constexpr uint16_t fixedEndpointClusterCount()
+{
+    uint16_t count = 0;
+    for (uint8_t endpointType : fixedEndpointTypesForDataVersions)
+    {
+        count = static_cast<uint16_t>(count + generatedEmberAfEndpointTypes[endpointType].clusterCount);
+    }
+    return count;
+}
+
+// One data version per cluster instance of the fixed endpoints, handed out in endpoint order.
+DataVersion fixedEndpointDataVersions[fixedEndpointClusterCount() > 0 ? fixedEndpointClusterCount() : 1];
 #endif
 
 app::AttributeAccessInterface * gAttributeAccessOverrides = nullptr;
@@ -116,6 +137,15 @@ app::AttributeAccessInterface * gAttributeAccessOverrides = nullptr;
 // Returns endpoint index within a given cluster
 static uint16_t findClusterEndpointIndex(EndpointId endpoint, ClusterId clusterId, uint8_t mask);
 
+// Data versions start off random, so that a client does not mistake the state of a rebooted device for the one it cached.
+static void initializeDataVersions(DataVersion * dataVersions, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        dataVersions[i] = Crypto::GetRandU32();
+    }
+}
+
 //------------------------------------------------------------------------------
 
 // Initial configuration
@@ -131,6 +161,12 @@ void emberAfEndpointConfigure(void)
     uint8_t fixedNetworks[]             = FIXED_NETWORKS;
 #endif
 
+    uint16_t storageOffset = 0;
+#if !defined(EMBER_SCRIPTED_TEST)
+    DataVersion * currentDataVersions = fixedEndpointDataVersions;
+#endif
+
+    endpointLocationIndex.Clear();
     emberEndpointCount = FIXED_ENDPOINT_COUNT;
     for (ep = 0; ep < FIXED_ENDPOINT_COUNT; ep++)
     {
@@ -140,6 +176,15 @@ void emberAfEndpointConfigure(void)
         emAfEndpoints[ep].endpointType  = endpointTypeMacro(ep);
         emAfEndpoints[ep].networkIndex  = endpointNetworkIndex(ep);
         emAfEndpoints[ep].bitmask       = EMBER_AF_ENDPOINT_ENABLED;
+#if !defined(EMBER_SCRIPTED_TEST)
+        emAfEndpoints[ep].dataVersions = currentDataVersions;
+
+        initializeDataVersions(currentDataVersions, emAfEndpoints[ep].endpointType->clusterCount);
+        currentDataVersions += emAfEndpoints[ep].endpointType->clusterCount;
+#endif
+
+        endpointLocationIndex.Insert(emAfEndpoints[ep].endpoint, ep, storageOffset);
+        storageOffset = static_cast<uint16_t>(storageOffset + emAfEndpoints[ep].endpointType->endpointSize);
     }
 
 #if CHIP_DEVICE_CONFIG_DYNAMIC_ENDPOINT_COUNT
@@ -171,7 +216,8 @@ uint16_t emberAfGetDynamicIndexFromEndpoint(EndpointId id)
     return 0xFFFF;
 }
 
-EmberAfStatus emberAfSetDynamicEndpoint(uint16_t index, EndpointId id, EmberAfEndpointType * ep, uint16_t deviceId,
+EmberAfStatus emberAfSetDynamicEndpoint(uint16_t index, EndpointId id, EmberAfEndpointType * ep,
+                                        const chip::Span<chip::DataVersion> & dataVersionStorage, uint16_t deviceId,
                                         uint8_t deviceVersion)
 {
     auto realIndex = index + FIXED_ENDPOINT_COUNT;
@@ -180,6 +226,10 @@ EmberAfStatus emberAfSetDynamicEndpoint(uint16_t index, EndpointId id, EmberAfEn
     {
         return EMBER_ZCL_STATUS_INSUFFICIENT_SPACE;
     }
+    if (dataVersionStorage.size() < ep->clusterCount)
+    {
+        return EMBER_ZCL_STATUS_INSUFFICIENT_SPACE;
+    }
 
     index = static_cast<uint16_t>(realIndex);
     for (uint16_t i = FIXED_ENDPOINT_COUNT; i < MAX_ENDPOINT_COUNT; i++)
@@ -190,14 +240,26 @@ EmberAfStatus emberAfSetDynamicEndpoint(uint16_t index, EndpointId id, EmberAfEn
         }
     }
 
+    // Drop any stale index entry for an endpoint previously installed in this slot.
+    if (endpointLocationIndex.FindEndpointIndex(emAfEndpoints[index].endpoint) == index)
+    {
+        endpointLocationIndex.Remove(emAfEndpoints[index].endpoint);
+    }
+
     emAfEndpoints[index].endpoint      = id;
     emAfEndpoints[index].deviceId      = deviceId;
     emAfEndpoints[index].deviceVersion = deviceVersion;
     emAfEndpoints[index].endpointType  = ep;
     emAfEndpoints[index].networkIndex  = 0;
+    emAfEndpoints[index].dataVersions  = dataVersionStorage.data();
     // Start the endpoint off as disabled.
     emAfEndpoints[index].bitmask = EMBER_AF_ENDPOINT_DISABLED;
 
+    initializeDataVersions(dataVersionStorage.data(), ep->clusterCount);
+
+    // Dynamic endpoints are external and don't use the attribute storage block.
+    endpointLocationIndex.Insert(id, index, 0);
+
     emberAfSetDynamicEndpointCount(MAX_ENDPOINT_COUNT - FIXED_ENDPOINT_COUNT);
 
     // Now enable the endpoint.
@@ -220,7 +282,12 @@ EndpointId emberAfClearDynamicEndpoint(uint16_t index)
         {
             emberAfSetDeviceEnabled(ep, false);
             emberAfEndpointEnableDisable(ep, false);
-            emAfEndpoints[index].endpoint = 0;
+            if (endpointLocationIndex.FindEndpointIndex(ep) == index)
+            {
+                endpointLocationIndex.Remove(ep);
+            }
+            emAfEndpoints[index].endpoint     = 0;
+            emAfEndpoints[index].dataVersions = nullptr;
         }
     }
 
@@ -506,116 +573,96 @@ bool emAfMatchAttribute(EmberAfCluster * cluster, EmberAfAttributeMetadata * am,
 EmberAfStatus emAfReadOrWriteAttribute(EmberAfAttributeSearchRecord * attRecord, EmberAfAttributeMetadata ** metadata,
                                        uint8_t * buffer, uint16_t readLength, bool write)
 {
-    uint16_t attributeOffsetIndex = 0;
-
-    for (uint8_t ep = 0; ep < emberAfEndpointCount(); ep++)
+    const auto * location = endpointLocationIndex.Find(attRecord->endpoint);
+    if (location == nullptr || location->endpointIndex >= emberAfEndpointCount() ||
+        !emberAfEndpointIndexIsEnabled(location->endpointIndex))
     {
-        // Is this a dynamic endpoint?
-        bool isDynamicEndpoint = (ep >= emberAfFixedEndpointCount());
+        return EMBER_ZCL_STATUS_UNSUPPORTED_ATTRIBUTE; // Sorry, attribute was not found.
+    }
 
-        if (emAfEndpoints[ep].endpoint == attRecord->endpoint)
-        {
-            EmberAfEndpointType * endpointType = emAfEndpoints[ep].endpointType;
-            uint8_t clusterIndex;
-            if (!emberAfEndpointIndexIsEnabled(ep))
-            {
-                continue;
-            }
-            for (clusterIndex = 0; clusterIndex < endpointType->clusterCount; clusterIndex++)
+    uint16_t ep                   = location->endpointIndex;
+    uint16_t attributeOffsetIndex = location->storageOffset;
+
+    // Is this a dynamic endpoint?
+    bool isDynamicEndpoint = (ep >= emberAfFixedEndpointCount());
+
+    EmberAfEndpointType * endpointType = emAfEndpoints[ep].endpointType;
+    uint8_t clusterIndex;
+    for (clusterIndex = 0; clusterIndex < endpointType->clusterCount; clusterIndex++)
+    {
+        EmberAfCluster * cluster = &(endpointType->cluster[clusterIndex]);
+        if (emAfMatchCluster(cluster, attRecord))
+        { // Got the cluster
+            uint16_t attrIndex;
+            for (attrIndex = 0; attrIndex < cluster->attributeCount; attrIndex++)
             {
-                EmberAfCluster * cluster = &(endpointType->cluster[clusterIndex]);
-                if (emAfMatchCluster(cluster, attRecord))
-                { // Got the cluster
-                    uint16_t attrIndex;
-                    for (attrIndex = 0; attrIndex < cluster->attributeCount; attrIndex++)
+                EmberAfAttributeMetadata * am = &(cluster->attributes[attrIndex]);
+                if (emAfMatchAttribute(cluster, am, attRecord))
+                { // Got the attribute
+                    // If passed metadata location is not null, populate
+                    if (metadata != NULL)
                     {
-                        EmberAfAttributeMetadata * am = &(cluster->attributes[attrIndex]);
-                        if (emAfMatchAttribute(cluster, am, attRecord))
-                        { // Got the attribute
-                            // If passed metadata location is not null, populate
-                            if (metadata != NULL)
-                            {
-                                *metadata = am;
-                            }
+                        *metadata = am;
+                    }
 
-                            {
-                                uint8_t * attributeLocation =
-                                    (am->mask & ATTRIBUTE_MASK_SINGLETON ? singletonAttributeLocation(am)
-                                                                         : attributeData + attributeOffsetIndex);
-                                uint8_t *src, *dst;
-                                if (write)
-                                {
-                                    src = buffer;
-                                    dst = attributeLocation;
-                                    if (!emberAfAttributeWriteAccessCallback(attRecord->endpoint, attRecord->clusterId,
-                                                                             am->attributeId))
-                                    {
-                                        return EMBER_ZCL_STATUS_NOT_AUTHORIZED;
-                                    }
-                                }
-                                else
-                                {
-                                    if (buffer == NULL)
-                                    {
-                                        return EMBER_ZCL_STATUS_SUCCESS;
-                                    }
-
-                                    src = attributeLocation;
-                                    dst = buffer;
-                                    if (!emberAfAttributeReadAccessCallback(attRecord->endpoint, attRecord->clusterId,
-                                                                            am->attributeId))
-                                    {
-                                        return EMBER_ZCL_STATUS_NOT_AUTHORIZED;
-                                    }
-                                }
-
-                                // Is the attribute externally stored?
-                                if (am->mask & ATTRIBUTE_MASK_EXTERNAL_STORAGE)
-                                {
-                                    return (write ? emberAfExternalAttributeWriteCallback(attRecord->endpoint, attRecord->clusterId,
-                                                                                          am, buffer)
-                                                  : emberAfExternalAttributeReadCallback(attRecord->endpoint, attRecord->clusterId,
-                                                                                         am, buffer, emberAfAttributeSize(am)));
-                                }
-                                else
-                                {
-                                    // Internal storage is only supported for fixed endpoints
-                                    if (!isDynamicEndpoint)
-                                    {
-                                        return typeSensitiveMemCopy(attRecord->clusterId, dst, src, am, write, readLength);
-                                    }
-                                    else
-                                    {
-                                        return EMBER_ZCL_STATUS_FAILURE;
-                                    }
-                                }
-                            }
+                    uint8_t * attributeLocation = (am->mask & ATTRIBUTE_MASK_SINGLETON ? singletonAttributeLocation(am)
+                                                                                       : attributeData + attributeOffsetIndex);
+                    uint8_t *src, *dst;
+                    if (write)
+                    {
+                        src = buffer;
+                        dst = attributeLocation;
+                        if (!emberAfAttributeWriteAccessCallback(attRecord->endpoint, attRecord->clusterId, am->attributeId))
+                        {
+                            return EMBER_ZCL_STATUS_NOT_AUTHORIZED;
                         }
-                        else
-                        { // Not the attribute we are looking for
-                            // Increase the index if attribute is not externally stored
-                            if (!(am->mask & ATTRIBUTE_MASK_EXTERNAL_STORAGE) && !(am->mask & ATTRIBUTE_MASK_SINGLETON))
-                            {
-                                attributeOffsetIndex = static_cast<uint16_t>(attributeOffsetIndex + emberAfAttributeSize(am));
-                            }
+                    }
+                    else
+                    {
+                        if (buffer == NULL)
+                        {
+                            return EMBER_ZCL_STATUS_SUCCESS;
+                        }
+
+                        src = attributeLocation;
+                        dst = buffer;
+                        if (!emberAfAttributeReadAccessCallback(attRecord->endpoint, attRecord->clusterId, am->attributeId))
+                        {
+                            return EMBER_ZCL_STATUS_NOT_AUTHORIZED;
                         }
                     }
+
+                    // Is the attribute externally stored?
+                    if (am->mask & ATTRIBUTE_MASK_EXTERNAL_STORAGE)
+                    {
+                        return (write ? emberAfExternalAttributeWriteCallback(attRecord->endpoint, attRecord->clusterId, am, buffer)
+                                      : emberAfExternalAttributeReadCallback(attRecord->endpoint, attRecord->clusterId, am, buffer,
+                                                                             emberAfAttributeSize(am)));
+                    }
+
+                    // Internal storage is only supported for fixed endpoints
+                    if (!isDynamicEndpoint)
+                    {
+                        return typeSensitiveMemCopy(attRecord->clusterId, dst, src, am, write, readLength);
+                    }
+
+                    return EMBER_ZCL_STATUS_FAILURE;
                 }
-                else
-                { // Not the cluster we are looking for
-                    attributeOffsetIndex = static_cast<uint16_t>(attributeOffsetIndex + cluster->clusterSize);
+
+                // Not the attribute we are looking for
+                // Increase the index if attribute is not externally stored
+                if (!(am->mask & ATTRIBUTE_MASK_EXTERNAL_STORAGE) && !(am->mask & ATTRIBUTE_MASK_SINGLETON))
+                {
+                    attributeOffsetIndex = static_cast<uint16_t>(attributeOffsetIndex + emberAfAttributeSize(am));
                 }
             }
         }
         else
-        { // Not the endpoint we are looking for
-            // Dynamic endpoints are external and don't factor into storage size
-            if (!isDynamicEndpoint)
-            {
-                attributeOffsetIndex = static_cast<uint16_t>(attributeOffsetIndex + emAfEndpoints[ep].endpointType->endpointSize);
-            }
+        { // Not the cluster we are looking for
+            attributeOffsetIndex = static_cast<uint16_t>(attributeOffsetIndex + cluster->clusterSize);
         }
     }
+
     return EMBER_ZCL_STATUS_UNSUPPORTED_ATTRIBUTE; // Sorry, attribute was not found.
 }
 
@@ -686,6 +733,32 @@ uint8_t emberAfClusterIndex(EndpointId endpoint, ClusterId clusterId, EmberAfClu
     return 0xFF;
 }
 
+DataVersion * emberAfDataVersionStorage(const chip::app::ConcreteClusterPath & aConcreteClusterPath)
+{
+    uint16_t index = emberAfIndexFromEndpoint(aConcreteClusterPath.mEndpointId);
+    if (index == 0xFFFF)
+    {
+        return nullptr;
+    }
+
+    const EmberAfDefinedEndpoint & ep = emAfEndpoints[index];
+    if (ep.dataVersions == nullptr)
+    {
+        return nullptr;
+    }
+
+    for (uint8_t i = 0; i < ep.endpointType->clusterCount; i++)
+    {
+        const EmberAfCluster & cluster = ep.endpointType->cluster[i];
+        if (cluster.clusterId == aConcreteClusterPath.mClusterId && emberAfClusterIsServer(&cluster))
+        {
+            return &ep.dataVersions[i];
+        }
+    }
+
+    return nullptr;
+}
+
 // Returns whether the given endpoint has the client or server of the given
 // cluster on it.
 bool emberAfContainsCluster(EndpointId endpoint, ClusterId clusterId)
@@ -813,16 +886,13 @@ static uint16_t findClusterEndpointIndex(EndpointId endpoint, ClusterId clusterI
 
 static uint16_t findIndexFromEndpoint(EndpointId endpoint, bool ignoreDisabledEndpoints)
 {
-    uint16_t epi;
-    for (epi = 0; epi < emberAfEndpointCount(); epi++)
+    uint16_t epi = endpointLocationIndex.FindEndpointIndex(endpoint);
+    if (epi >= emberAfEndpointCount() ||
+        (ignoreDisabledEndpoints && !(emAfEndpoints[epi].bitmask & EMBER_AF_ENDPOINT_ENABLED)))
     {
-        if (emAfEndpoints[epi].endpoint == endpoint &&
-            (!ignoreDisabledEndpoints || emAfEndpoints[epi].bitmask & EMBER_AF_ENDPOINT_ENABLED))
-        {
-            return epi;
-        }
+        return 0xFFFF;
     }
-    return 0xFFFF;
+    return epi;
 }
 
 bool emberAfEndpointIsEnabled(EndpointId endpoint)
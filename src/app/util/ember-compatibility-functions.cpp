@@ -23,6 +23,7 @@
 
 #include <access/AccessControl.h>
 #include <app/ClusterInfo.h>
+#include <app/ConcreteClusterPath.h>
 #include <app/ConcreteAttributePath.h>
 #include <app/InteractionModelEngine.h>
 #include <app/reporting/Engine.h>
@@ -58,7 +59,6 @@ namespace chip {
 namespace app {
 namespace Compatibility {
 namespace {
-constexpr uint32_t kTemporaryDataVersion = 0;
 // On some apps, ATTRIBUTE_LARGEST can as small as 3, making compiler unhappy since data[kAttributeReadBufferSize] cannot hold
 // uint64_t. Make kAttributeReadBufferSize at least 8 so it can fit all basic types.
 constexpr size_t kAttributeReadBufferSize = (ATTRIBUTE_LARGEST >= 8 ? ATTRIBUTE_LARGEST : 8);
@@ -218,6 +218,22 @@ namespace {
 // Common buffer for ReadSingleClusterData & WriteSingleClusterData
 uint8_t attributeData[kAttributeReadBufferSize];
 
+DataVersion GetClusterDataVersion(const ConcreteClusterPath & aConcreteClusterPath)
+{
+    // Client clusters have no data version; report them at version 0, which is what every attribute carried before.
+    DataVersion * version = emberAfDataVersionStorage(aConcreteClusterPath);
+    return (version != nullptr) ? *version : 0;
+}
+
+void IncreaseClusterDataVersion(const ConcreteClusterPath & aConcreteClusterPath)
+{
+    DataVersion * version = emberAfDataVersionStorage(aConcreteClusterPath);
+    if (version != nullptr)
+    {
+        (*version)++;
+    }
+}
+
 template <typename T>
 CHIP_ERROR attributeBufferToNumericTlvData(TLV::TLVWriter & writer, bool isNullable)
 {
@@ -239,6 +255,12 @@ CHIP_ERROR attributeBufferToNumericTlvData(TLV::TLVWriter & writer, bool isNulla
 
 } // anonymous namespace
 
+bool IsClusterDataVersionEqual(const ConcreteClusterPath & aConcreteClusterPath, DataVersion aRequiredVersion)
+{
+    DataVersion * version = emberAfDataVersionStorage(aConcreteClusterPath);
+    return (version != nullptr) && (*version == aRequiredVersion);
+}
+
 bool ServerClusterCommandExists(const ConcreteCommandPath & aCommandPath)
 {
     // TODO: Currently, we are using cluster catalog from the ember library, this should be modified or replaced after several
@@ -340,8 +362,8 @@ CHIP_ERROR ReadViaAccessInterface(FabricIndex aAccessingFabricIndex, bool aIsFab
     // into status responses, unless our caller already does that.
     AttributeValueEncoder::AttributeEncodeState state =
         (aEncoderState == nullptr ? AttributeValueEncoder::AttributeEncodeState() : *aEncoderState);
-    AttributeValueEncoder valueEncoder(aAttributeReports, aAccessingFabricIndex, aPath, kTemporaryDataVersion, aIsFabricFiltered,
-                                       state);
+    DataVersion version = GetClusterDataVersion(ConcreteClusterPath(aPath.mEndpointId, aPath.mClusterId));
+    AttributeValueEncoder valueEncoder(aAttributeReports, aAccessingFabricIndex, aPath, version, aIsFabricFiltered, state);
     CHIP_ERROR err = aAccessInterface->Read(aPath, valueEncoder);
 
     if (err != CHIP_NO_ERROR)
@@ -363,7 +385,8 @@ CHIP_ERROR ReadViaAccessInterface(FabricIndex aAccessingFabricIndex, bool aIsFab
 
 CHIP_ERROR ReadSingleClusterData(const SubjectDescriptor & aSubjectDescriptor, bool aIsFabricFiltered,
                                  const ConcreteReadAttributePath & aPath, AttributeReportIBs::Builder & aAttributeReports,
-                                 AttributeValueEncoder::AttributeEncodeState * apEncoderState)
+                                 AttributeValueEncoder::AttributeEncodeState * apEncoderState,
+                                 const CHIP_ERROR * apAccessCheckResult)
 {
     ChipLogDetail(DataManagement,
                   "Reading attribute: Cluster=" ChipLogFormatMEI " Endpoint=%" PRIx16 " AttributeId=" ChipLogFormatMEI
@@ -394,13 +417,22 @@ CHIP_ERROR ReadSingleClusterData(const SubjectDescriptor & aSubjectDescriptor, b
     }
 
     // Check access control. A failed check will disallow the operation, and may or may not generate an attribute report
-    // depending on whether the path was expanded.
+    // depending on whether the path was expanded. The check is only made here when the caller has not made it already.
 
     {
-        Access::RequestPath requestPath{ .cluster = aPath.mClusterId, .endpoint = aPath.mEndpointId };
-        Access::Privilege requestPrivilege = Access::Privilege::kView; // TODO: get actual request privilege
-        CHIP_ERROR err                     = Access::GetAccessControl().Check(aSubjectDescriptor, requestPath, requestPrivilege);
-        err                                = CHIP_NO_ERROR; // TODO: remove override
+        CHIP_ERROR err;
+        if (apAccessCheckResult != nullptr)
+        {
+            err = *apAccessCheckResult;
+        }
+        else
+        {
+            Access::RequestPath requestPath{ .cluster = aPath.mClusterId, .endpoint = aPath.mEndpointId };
+            Access::Privilege requestPrivilege = Access::Privilege::kView; // TODO: get actual request privilege
+
+            err = Access::GetAccessControl().Check(aSubjectDescriptor, requestPath, requestPrivilege);
+        }
+        err = CHIP_NO_ERROR; // TODO: remove override
         if (err != CHIP_NO_ERROR)
         {
             ReturnErrorCodeIf(err != CHIP_ERROR_ACCESS_DENIED, err);
@@ -443,7 +475,7 @@ CHIP_ERROR ReadSingleClusterData(const SubjectDescriptor & aSubjectDescriptor, b
     AttributeDataIB::Builder & attributeDataIBBuilder = attributeReport.CreateAttributeData();
     ReturnErrorOnFailure(attributeDataIBBuilder.GetError());
 
-    attributeDataIBBuilder.DataVersion(kTemporaryDataVersion);
+    attributeDataIBBuilder.DataVersion(GetClusterDataVersion(ConcreteClusterPath(aPath.mEndpointId, aPath.mClusterId)));
     ReturnErrorOnFailure(attributeDataIBBuilder.GetError());
 
     AttributePathIB::Builder & attributePathIBBuilder = attributeDataIBBuilder.CreatePath();
@@ -902,6 +934,9 @@ void MatterReportingAttributeChangeCallback(EndpointId endpoint, ClusterId clust
     info.mAttributeId = attributeId;
     info.mEndpointId  = endpoint;
 
+    // Any change to an attribute, whether written by a client or by the application, moves its cluster to a new version.
+    IncreaseClusterDataVersion(ConcreteClusterPath(endpoint, clusterId));
+
     InteractionModelEngine::GetInstance()->GetReportingEngine().SetDirty(info);
 
     // Schedule work to run asynchronously on the CHIP thread. The scheduled work won't execute until the current execution context
@@ -34,5 +34,11 @@ namespace Test {
 CHIP_ERROR ReadSingleMockClusterData(FabricIndex aAccessingFabricIndex, const app::ConcreteAttributePath & aPath,
                                      app::AttributeReportIBs::Builder & aAttributeReports,
                                      app::AttributeValueEncoder::AttributeEncodeState * apEncoderState);
+
+/// Increase the data version of all the mock clusters, as if their attributes had changed.
+void BumpVersion();
+
+/// The data version reported for the mock clusters.
+DataVersion GetVersion();
 } // namespace Test
 } // namespace chip
@@ -96,6 +96,9 @@ uint8_t mockAttribute4[256]  = {
     0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 0xa, 0xb, 0xc, 0xd, 0xe, 0xf, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 0xa, 0xb, 0xc, 0xd, 0xe, 0xf,
 };
 
+// All the mock clusters share one data version.
+DataVersion dataVersion = 0;
+
 } // namespace
 
 uint16_t emberAfEndpointCount(void)
@@ -245,6 +248,16 @@ uint16_t emberAfLongStringLength(const uint8_t * buffer)
 namespace chip {
 namespace Test {
 
+void BumpVersion()
+{
+    dataVersion++;
+}
+
+DataVersion GetVersion()
+{
+    return dataVersion;
+}
+
 CHIP_ERROR ReadSingleMockClusterData(FabricIndex aAccessingFabricIndex, const ConcreteAttributePath & aPath,
                                      AttributeReportIBs::Builder & aAttributeReports,
                                      AttributeValueEncoder::AttributeEncodeState * apEncoderState)
@@ -279,7 +292,7 @@ CHIP_ERROR ReadSingleMockClusterData(FabricIndex aAccessingFabricIndex, const Co
     {
         AttributeValueEncoder::AttributeEncodeState state =
             (apEncoderState == nullptr ? AttributeValueEncoder::AttributeEncodeState() : *apEncoderState);
-        AttributeValueEncoder valueEncoder(aAttributeReports, aAccessingFabricIndex, aPath, 0, false, state);
+        AttributeValueEncoder valueEncoder(aAttributeReports, aAccessingFabricIndex, aPath, dataVersion, false, state);
 
         CHIP_ERROR err = valueEncoder.EncodeList([](const auto & encoder) -> CHIP_ERROR {
             for (int i = 0; i < 6; i++)
@@ -300,7 +313,7 @@ CHIP_ERROR ReadSingleMockClusterData(FabricIndex aAccessingFabricIndex, const Co
     ReturnErrorOnFailure(aAttributeReports.GetError());
     AttributeDataIB::Builder & attributeData = attributeReport.CreateAttributeData();
     ReturnErrorOnFailure(attributeReport.GetError());
-    attributeData.DataVersion(0);
+    attributeData.DataVersion(dataVersion);
     AttributePathIB::Builder & attributePath = attributeData.CreatePath();
     ReturnErrorOnFailure(attributeData.GetError());
     attributePath.Endpoint(aPath.mEndpointId).Cluster(aPath.mClusterId).Attribute(aPath.mAttributeId).EndOfAttributePathIB();
@@ -155,6 +155,7 @@ CHIP_ERROR DeviceController::Init(ControllerInitParams params)
         .clientPool     = &mCASEClientPool,
         .imDelegate     = params.systemState->IMDelegate(),
         .mrpLocalConfig = Optional<ReliableMessageProtocolConfig>::Value(mMRPConfig),
+        .cryptoOffload  = params.caseCryptoOffload,
     };
 
     CASESessionManagerConfig sessionManagerConfig = {
@@ -166,6 +167,7 @@ CHIP_ERROR DeviceController::Init(ControllerInitParams params)
 #else
         .dnsResolver = nullptr,
 #endif
+        .maxConcurrentHandshakes = params.maxConcurrentCASEHandshakes,
     };
 
     mCASESessionManager = chip::Platform::New<CASESessionManager>(sessionManagerConfig);
@@ -222,6 +224,11 @@ CHIP_ERROR DeviceController::ProcessControllerNOCChain(const ControllerInitParam
     ChipLogProgress(Controller, "Joined the fabric at index %d. Compressed fabric ID is: 0x" ChipLogFormatX64, mFabricIndex,
                     ChipLogValueX64(GetCompressedFabricId()));
 
+    if (params.systemState->GroupKeyCache() != nullptr)
+    {
+        ReturnErrorOnFailure(params.systemState->GroupKeyCache()->SetFabric(mFabricIndex, GetCompressedFabricId()));
+    }
+
     return CHIP_NO_ERROR;
 }
 
@@ -235,6 +242,10 @@ CHIP_ERROR DeviceController::Shutdown()
 
     mStorageDelegate = nullptr;
 
+    if (mSystemState->GroupKeyCache() != nullptr)
+    {
+        mSystemState->GroupKeyCache()->RemoveFabric(mFabricIndex);
+    }
     mSystemState->Fabrics()->ReleaseFabricIndex(mFabricIndex);
     mSystemState->Release();
     mSystemState = nullptr;
@@ -116,6 +116,13 @@ struct ControllerInitParams
 
     FabricIndex fabricIndex = kMinValidFabricIndex;
     FabricId fabricId       = kUndefinedFabricId;
+
+    /* Optional: runs the expensive steps of the CASE handshakes with devices off the event loop,
+       e.g. a CASECryptoThreadPool, so that reconnecting to many devices at once is faster */
+    CASECryptoOffload * caseCryptoOffload = nullptr;
+
+    /* How many CASE handshakes with devices may run at once, 0 meaning no limit */
+    uint16_t maxConcurrentCASEHandshakes = CHIP_CONFIG_CASE_MAX_CONCURRENT_HANDSHAKES;
 };
 
 class DLL_EXPORT DevicePairingDelegate
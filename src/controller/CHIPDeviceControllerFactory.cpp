@@ -50,8 +50,9 @@ CHIP_ERROR DeviceControllerFactory::Init(FactoryInitParams params)
         return CHIP_NO_ERROR;
     }
 
-    mListenPort    = params.listenPort;
-    mFabricStorage = params.fabricStorage;
+    mListenPort        = params.listenPort;
+    mFabricStorage     = params.fabricStorage;
+    mGroupDataProvider = params.groupDataProvider;
 
     CHIP_ERROR err = InitSystemState(params);
 
@@ -144,6 +145,17 @@ CHIP_ERROR DeviceControllerFactory::InitSystemState(FactoryInitParams params)
     ReturnErrorOnFailure(stateParams.fabricTable->Init(mFabricStorage));
     ReturnErrorOnFailure(
         stateParams.sessionMgr->Init(stateParams.systemLayer, stateParams.transportMgr, stateParams.messageCounterManager));
+    stateParams.sessionMgr->SetSessionIDAllocator(&mSessionIDAllocator);
+#if CHIP_CONFIG_GROUP_MESSAGE_DECRYPTION
+    if (mGroupDataProvider != nullptr)
+    {
+        stateParams.groupKeyCache = chip::Platform::New<Transport::GroupKeyCache>();
+        VerifyOrReturnError(stateParams.groupKeyCache != nullptr, CHIP_ERROR_NO_MEMORY);
+        ReturnErrorOnFailure(stateParams.groupKeyCache->Init(mGroupDataProvider));
+        ReturnErrorOnFailure(stateParams.groupKeyCache->SetFabrics(*stateParams.fabricTable));
+        stateParams.sessionMgr->SetGroupKeyCache(stateParams.groupKeyCache);
+    }
+#endif
     ReturnErrorOnFailure(stateParams.exchangeMgr->Init(stateParams.sessionMgr));
     ReturnErrorOnFailure(stateParams.messageCounterManager->Init(stateParams.exchangeMgr));
 
@@ -178,6 +190,9 @@ void DeviceControllerFactory::PopulateInitParams(ControllerInitParams & controll
 
     controllerParams.systemState        = mSystemState;
     controllerParams.controllerVendorId = params.controllerVendorId;
+
+    controllerParams.caseCryptoOffload           = params.caseCryptoOffload;
+    controllerParams.maxConcurrentCASEHandshakes = params.maxConcurrentCASEHandshakes;
 }
 
 CHIP_ERROR DeviceControllerFactory::SetupController(SetupParams params, DeviceController & controller)
@@ -292,6 +307,12 @@ CHIP_ERROR DeviceControllerSystemState::Shutdown()
         mSessionMgr = nullptr;
     }
 
+    if (mGroupKeyCache != nullptr)
+    {
+        chip::Platform::Delete(mGroupKeyCache);
+        mGroupKeyCache = nullptr;
+    }
+
     if (mIMDelegate != nullptr)
     {
         chip::Platform::Delete(mIMDelegate);
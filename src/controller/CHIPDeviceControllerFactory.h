@@ -64,6 +64,10 @@ struct SetupParams
     DevicePairingDelegate * pairingDelegate = nullptr;
 
     Credentials::DeviceAttestationVerifier * deviceAttestationVerifier = nullptr;
+
+    // See ControllerInitParams.
+    CASECryptoOffload * caseCryptoOffload = nullptr;
+    uint16_t maxConcurrentCASEHandshakes  = CHIP_CONFIG_CASE_MAX_CONCURRENT_HANDSHAKES;
 };
 
 // TODO everything other than the fabric storage here should be removed.
@@ -75,6 +79,8 @@ struct FactoryInitParams
     Inet::EndPointManager<Inet::TCPEndPoint> * tcpEndPointManager = nullptr;
     Inet::EndPointManager<Inet::UDPEndPoint> * udpEndPointManager = nullptr;
     DeviceControllerInteractionModelDelegate * imDelegate         = nullptr;
+    // Group keys used to decrypt incoming group messages, when CHIP_CONFIG_GROUP_MESSAGE_DECRYPTION is enabled.
+    Credentials::GroupDataProvider * groupDataProvider = nullptr;
 #if CONFIG_NETWORK_LAYER_BLE
     Ble::BleLayer * bleLayer = nullptr;
 #endif
@@ -116,8 +122,10 @@ private:
     CHIP_ERROR InitSystemState();
 
     uint16_t mListenPort;
-    FabricStorage * mFabricStorage             = nullptr;
-    DeviceControllerSystemState * mSystemState = nullptr;
+    FabricStorage * mFabricStorage                     = nullptr;
+    Credentials::GroupDataProvider * mGroupDataProvider = nullptr;
+    DeviceControllerSystemState * mSystemState         = nullptr;
+    SessionIDAllocator mSessionIDAllocator;
 };
 
 } // namespace Controller
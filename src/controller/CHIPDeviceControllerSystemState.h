@@ -32,6 +32,7 @@
 #include <app/DeviceControllerInteractionModelDelegate.h>
 #include <credentials/FabricTable.h>
 #include <protocols/secure_channel/MessageCounterManager.h>
+#include <transport/GroupKeyCache.h>
 #include <transport/TransportMgr.h>
 #include <transport/raw/UDP.h>
 #if CONFIG_DEVICE_LAYER
@@ -74,6 +75,7 @@ struct DeviceControllerSystemStateParams
     secure_channel::MessageCounterManager * messageCounterManager = nullptr;
     FabricTable * fabricTable                                     = nullptr;
     DeviceControllerInteractionModelDelegate * imDelegate         = nullptr;
+    Transport::GroupKeyCache * groupKeyCache                      = nullptr;
 };
 
 // A representation of the internal state maintained by the DeviceControllerFactory
@@ -87,7 +89,7 @@ public:
         mSystemLayer(params.systemLayer), mTCPEndPointManager(params.tcpEndPointManager),
         mUDPEndPointManager(params.udpEndPointManager), mTransportMgr(params.transportMgr), mSessionMgr(params.sessionMgr),
         mExchangeMgr(params.exchangeMgr), mMessageCounterManager(params.messageCounterManager), mFabrics(params.fabricTable),
-        mIMDelegate(params.imDelegate)
+        mIMDelegate(params.imDelegate), mGroupKeyCache(params.groupKeyCache)
     {
 #if CONFIG_NETWORK_LAYER_BLE
         mBleLayer = params.bleLayer;
@@ -131,6 +133,7 @@ public:
     secure_channel::MessageCounterManager * MessageCounterManager() { return mMessageCounterManager; };
     FabricTable * Fabrics() { return mFabrics; };
     DeviceControllerInteractionModelDelegate * IMDelegate() { return mIMDelegate; }
+    Transport::GroupKeyCache * GroupKeyCache() { return mGroupKeyCache; }
 #if CONFIG_NETWORK_LAYER_BLE
     Ble::BleLayer * BleLayer() { return mBleLayer; };
 #endif
@@ -150,6 +153,7 @@ private:
     secure_channel::MessageCounterManager * mMessageCounterManager = nullptr;
     FabricTable * mFabrics                                         = nullptr;
     DeviceControllerInteractionModelDelegate * mIMDelegate         = nullptr;
+    Transport::GroupKeyCache * mGroupKeyCache                      = nullptr;
 
     std::atomic<uint32_t> mRefCount{ 1 };
 
@@ -0,0 +1,174 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file benchmarks the attribute lookups of the ember attribute storage on the dynamic endpoints of a bridge.
+ *
+ */
+
+#include <app-common/zap-generated/ids/Attributes.h>
+#include <app-common/zap-generated/ids/Clusters.h>
+#include <app/tests/AppTestContext.h>
+#include <app/util/DataModelHandler.h>
+#include <app/util/attribute-storage.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/UnitTestRegistration.h>
+#include <system/SystemClock.h>
+
+#include <nlunit-test.h>
+
+#include <stdio.h>
+
+using TestContext = chip::Test::AppContext;
+using namespace chip;
+using namespace chip::app::Clusters;
+
+namespace {
+
+//
+// The generated endpoint_config for the controller app has Endpoint 1
+// already used in the fixed endpoint set of size 1. Consequently, let's use the next
+// number higher than that for our dynamic test endpoints.
+//
+constexpr EndpointId kFirstDynamicEndpointId = 2;
+constexpr uint16_t kDynamicEndpointCount     = CHIP_DEVICE_CONFIG_DYNAMIC_ENDPOINT_COUNT;
+
+#if CHIP_DEVICE_CONFIG_DYNAMIC_ENDPOINT_COUNT > 0
+// A bridged light, as the bridge app declares it.
+//clang-format off
+DECLARE_DYNAMIC_ATTRIBUTE_LIST_BEGIN(onOffAttrs)
+DECLARE_DYNAMIC_ATTRIBUTE(OnOff::Attributes::OnOff::Id, BOOLEAN, 1, 0), DECLARE_DYNAMIC_ATTRIBUTE_LIST_END();
+
+DECLARE_DYNAMIC_ATTRIBUTE_LIST_BEGIN(descriptorAttrs)
+DECLARE_DYNAMIC_ATTRIBUTE(Descriptor::Attributes::DeviceList::Id, ARRAY, 254, 0),
+    DECLARE_DYNAMIC_ATTRIBUTE(Descriptor::Attributes::ServerList::Id, ARRAY, 254, 0),
+    DECLARE_DYNAMIC_ATTRIBUTE(Descriptor::Attributes::ClientList::Id, ARRAY, 254, 0),
+    DECLARE_DYNAMIC_ATTRIBUTE(Descriptor::Attributes::PartsList::Id, ARRAY, 254, 0), DECLARE_DYNAMIC_ATTRIBUTE_LIST_END();
+
+DECLARE_DYNAMIC_ATTRIBUTE_LIST_BEGIN(bridgedDeviceBasicAttrs)
+DECLARE_DYNAMIC_ATTRIBUTE(BridgedDeviceBasic::Attributes::NodeLabel::Id, CHAR_STRING, 32, 0),
+    DECLARE_DYNAMIC_ATTRIBUTE(BridgedDeviceBasic::Attributes::Reachable::Id, BOOLEAN, 1, 0), DECLARE_DYNAMIC_ATTRIBUTE_LIST_END();
+
+DECLARE_DYNAMIC_CLUSTER_LIST_BEGIN(bridgedLightClusters)
+DECLARE_DYNAMIC_CLUSTER(OnOff::Id, onOffAttrs), DECLARE_DYNAMIC_CLUSTER(Descriptor::Id, descriptorAttrs),
+    DECLARE_DYNAMIC_CLUSTER(BridgedDeviceBasic::Id, bridgedDeviceBasicAttrs), DECLARE_DYNAMIC_CLUSTER_LIST_END;
+
+DECLARE_DYNAMIC_ENDPOINT(bridgedLightEndpoint, bridgedLightClusters);
+//clang-format on
+
+DataVersion gDataVersionStorage[kDynamicEndpointCount][ArraySize(bridgedLightClusters)];
+
+// Times emberAfLocateAttributeMetadata, and so emAfReadOrWriteAttribute, on every attribute of the first and of the last of
+// the dynamic endpoints. The lookup goes straight to the endpoint through its index instead of walking the endpoints before
+// it, so both should take about the same time.
+void TestLookupBenchmark(nlTestSuite * apSuite, void * apContext)
+{
+    TestContext & ctx          = *static_cast<TestContext *>(apContext);
+    constexpr uint32_t kRounds = 10000;
+
+    // Initialize the ember side server logic
+    InitDataModelHandler(&ctx.GetExchangeManager());
+
+    for (uint16_t i = 0; i < kDynamicEndpointCount; i++)
+    {
+        NL_TEST_ASSERT(apSuite,
+                       emberAfSetDynamicEndpoint(i, static_cast<EndpointId>(kFirstDynamicEndpointId + i), &bridgedLightEndpoint,
+                                                 Span<DataVersion>(gDataVersionStorage[i]), 0, 0) == EMBER_ZCL_STATUS_SUCCESS);
+    }
+
+    uint32_t attributeCount = 0;
+    for (const EmberAfCluster & cluster : bridgedLightClusters)
+    {
+        attributeCount += cluster.attributeCount;
+    }
+
+    auto timeLookups = [&](EndpointId endpoint) {
+        uint32_t found = 0;
+        auto start     = System::SystemClock().GetMonotonicMicroseconds64();
+        for (uint32_t round = 0; round < kRounds; round++)
+        {
+            for (const EmberAfCluster & cluster : bridgedLightClusters)
+            {
+                for (uint16_t a = 0; a < cluster.attributeCount; a++)
+                {
+                    found += (emberAfLocateAttributeMetadata(endpoint, cluster.clusterId, cluster.attributes[a].attributeId,
+                                                             CLUSTER_MASK_SERVER) != nullptr)
+                        ? 1
+                        : 0;
+                }
+            }
+        }
+        auto elapsed = System::SystemClock().GetMonotonicMicroseconds64() - start;
+        NL_TEST_ASSERT(apSuite, found == kRounds * attributeCount);
+        return elapsed;
+    };
+
+    const EndpointId lastEndpointId = static_cast<EndpointId>(kFirstDynamicEndpointId + kDynamicEndpointCount - 1);
+    auto firstElapsed               = timeLookups(kFirstDynamicEndpointId);
+    auto lastElapsed                = timeLookups(lastEndpointId);
+
+    // Endpoints that are not installed have no attributes.
+    NL_TEST_ASSERT(apSuite,
+                   emberAfLocateAttributeMetadata(static_cast<EndpointId>(lastEndpointId + 1), OnOff::Id,
+                                                  OnOff::Attributes::OnOff::Id, CLUSTER_MASK_SERVER) == nullptr);
+
+    printf("Attribute lookup: %u dynamic endpoints, %u lookups: first endpoint %llu us, last endpoint %llu us\n",
+           static_cast<unsigned>(kDynamicEndpointCount), static_cast<unsigned>(kRounds * attributeCount),
+           static_cast<unsigned long long>(firstElapsed.count()), static_cast<unsigned long long>(lastElapsed.count()));
+
+    for (uint16_t i = 0; i < kDynamicEndpointCount; i++)
+    {
+        emberAfClearDynamicEndpoint(i);
+    }
+    NL_TEST_ASSERT(apSuite,
+                   emberAfLocateAttributeMetadata(kFirstDynamicEndpointId, OnOff::Id, OnOff::Attributes::OnOff::Id,
+                                                  CLUSTER_MASK_SERVER) == nullptr);
+}
+#endif // CHIP_DEVICE_CONFIG_DYNAMIC_ENDPOINT_COUNT > 0
+
+// clang-format off
+const nlTest sTests[] =
+{
+#if CHIP_DEVICE_CONFIG_DYNAMIC_ENDPOINT_COUNT > 0
+    NL_TEST_DEF("TestLookupBenchmark", TestLookupBenchmark),
+#endif
+    NL_TEST_SENTINEL()
+};
+// clang-format on
+
+// clang-format off
+nlTestSuite sSuite =
+{
+    "TestAttributeStorageLookup",
+    &sTests[0],
+    TestContext::InitializeAsync,
+    TestContext::Finalize
+};
+// clang-format on
+
+} // namespace
+
+int TestAttributeStorageLookup()
+{
+    TestContext gContext;
+    nlTestRunner(&sSuite, &gContext);
+    return (nlTestRunnerStats(&sSuite));
+}
+
+CHIP_REGISTER_TEST_SUITE(TestAttributeStorageLookup)
@@ -202,7 +202,8 @@ void TestCommandInteraction::TestChunking(nlTestSuite * apSuite, void * apContex
     InitDataModelHandler(&ctx.GetExchangeManager());
 
     // Register our fake dynamic endpoint.
-    emberAfSetDynamicEndpoint(0, kTestEndpointId, &testEndpoint, 0, 0);
+    DataVersion dataVersionStorage[ArraySize(testEndpointClusters)];
+    emberAfSetDynamicEndpoint(0, kTestEndpointId, &testEndpoint, Span<DataVersion>(dataVersionStorage), 0, 0);
 
     // Register our fake attribute access interface.
     registerAttributeAccessOverride(&testServer);
@@ -261,6 +262,8 @@ void TestCommandInteraction::TestChunking(nlTestSuite * apSuite, void * apContex
             break;
         }
     }
+
+    emberAfClearDynamicEndpoint(0);
 }
 
 // Similar to the test above, but for the list chunking feature.
@@ -275,7 +278,8 @@ void TestCommandInteraction::TestListChunking(nlTestSuite * apSuite, void * apCo
     InitDataModelHandler(&ctx.GetExchangeManager());
 
     // Register our fake dynamic endpoint.
-    emberAfSetDynamicEndpoint(0, kTestEndpointId3, &testEndpoint3, 0, 0);
+    DataVersion dataVersionStorage[ArraySize(testEndpoint3Clusters)];
+    emberAfSetDynamicEndpoint(0, kTestEndpointId3, &testEndpoint3, Span<DataVersion>(dataVersionStorage), 0, 0);
 
     // Register our fake attribute access interface.
     registerAttributeAccessOverride(&testServer);
@@ -335,6 +339,8 @@ void TestCommandInteraction::TestListChunking(nlTestSuite * apSuite, void * apCo
             break;
         }
     }
+
+    emberAfClearDynamicEndpoint(0);
 }
 
 // Read an attribute that can never fit into the buffer. Result in an empty report, server should shutdown the transaction.
@@ -349,7 +355,8 @@ void TestCommandInteraction::TestBadChunking(nlTestSuite * apSuite, void * apCon
     InitDataModelHandler(&ctx.GetExchangeManager());
 
     // Register our fake dynamic endpoint.
-    emberAfSetDynamicEndpoint(0, kTestEndpointId3, &testEndpoint3, 0, 0);
+    DataVersion dataVersionStorage[ArraySize(testEndpoint3Clusters)];
+    emberAfSetDynamicEndpoint(0, kTestEndpointId3, &testEndpoint3, Span<DataVersion>(dataVersionStorage), 0, 0);
 
     // Register our fake attribute access interface.
     registerAttributeAccessOverride(&testServer);
@@ -389,6 +396,8 @@ void TestCommandInteraction::TestBadChunking(nlTestSuite * apSuite, void * apCon
 
     // Sanity check
     NL_TEST_ASSERT(apSuite, ctx.GetExchangeManager().GetNumActiveExchanges() == 0);
+
+    emberAfClearDynamicEndpoint(0);
 }
 
 // clang-format off
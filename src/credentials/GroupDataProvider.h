@@ -159,6 +159,13 @@ public:
          *  @param[in] removed_state  GroupInfo structure of the removed group.
          */
         virtual void OnGroupRemoved(chip::FabricIndex fabric_index, const GroupInfo & old_group) = 0;
+        /**
+         *  Callback invoked when the key sets or group-key mappings of a fabric change,
+         *  so that any derived operational group keys must be recomputed.
+         *
+         *  @param[in] fabric_index  Fabric whose group keys changed.
+         */
+        virtual void OnGroupKeysChanged(chip::FabricIndex fabric_index) {}
     };
 
     /**
@@ -295,6 +302,8 @@ public:
     virtual CHIP_ERROR Decrypt(PacketHeader packetHeader, PayloadHeader & payloadHeader, System::PacketBufferHandle & msg) = 0;
 
     // Listener
+    // A listener that replaces another one should keep the result of GetListener() and forward the callbacks to it.
+    GroupListener * GetListener() const { return mListener; }
     void SetListener(GroupListener * listener) { mListener = listener; };
     void RemoveListener() { mListener = nullptr; };
 
@@ -306,6 +315,13 @@ protected:
             mListener->OnGroupAdded(fabric_index, new_group);
         }
     }
+    void GroupKeysChanged(chip::FabricIndex fabric_index)
+    {
+        if (mListener)
+        {
+            mListener->OnGroupKeysChanged(fabric_index);
+        }
+    }
     const uint16_t mMaxGroupsPerFabric;
     const uint16_t mMaxGroupKeysPerFabric;
     GroupListener * mListener = nullptr;
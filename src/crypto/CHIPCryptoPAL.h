@@ -91,6 +91,12 @@ constexpr size_t kEmitDerIntegerWithoutTagOverhead = 1; // 1 sign stuffer
 constexpr size_t kEmitDerIntegerOverhead           = 3; // Tag + Length byte + 1 sign stuffer
 
 constexpr size_t kMAX_Hash_SHA256_Context_Size = CHIP_CONFIG_SHA256_CONTEXT_SIZE;
+#if CHIP_CRYPTO_OPENSSL
+// The OpenSSL backend only keeps a pointer to a keyed EVP_CIPHER_CTX per direction.
+constexpr size_t kMAX_AES_CCM_Context_Size = 2 * sizeof(void *);
+#else
+constexpr size_t kMAX_AES_CCM_Context_Size = CHIP_CONFIG_AES_CCM_CONTEXT_SIZE;
+#endif
 
 /*
  * Overhead to encode a raw ECDSA signature in X9.62 format in ASN.1 DER
@@ -543,6 +549,88 @@ CHIP_ERROR AES_CCM_decrypt(const uint8_t * ciphertext, size_t ciphertext_length,
                            const uint8_t * tag, size_t tag_length, const uint8_t * key, size_t key_length, const uint8_t * iv,
                            size_t iv_length, uint8_t * plaintext);
 
+struct alignas(size_t) AesCcmOpaqueContext
+{
+    uint8_t mOpaque[kMAX_AES_CCM_Context_Size];
+};
+
+/**
+ * @brief A class that implements AES-CCM with a key set up once for many messages.
+ *
+ * AES_CCM_encrypt() and AES_CCM_decrypt() expand the key for every call. This class keeps the
+ * keyed cipher, so that encrypting or decrypting a message only costs the message itself. The
+ * nonce and tag lengths are fixed by Init() along with the key.
+ *
+ * Plaintext and ciphertext may be the same buffer, for encryption and decryption in place.
+ * The context holds resources of the underlying crypto library and cannot be copied.
+ **/
+class AES_CCM_context
+{
+public:
+    AES_CCM_context();
+    ~AES_CCM_context();
+
+    AES_CCM_context(const AES_CCM_context &) = delete;
+    AES_CCM_context & operator=(const AES_CCM_context &) = delete;
+
+    /**
+     * @brief Set up the cipher for a key, replacing any previous one.
+     *
+     * @param key Encryption key
+     * @param key_length Length of encryption key (in bytes)
+     * @param iv_length Length of the initial vector of every message
+     * @param tag_length Length of the tag of every message
+     * @return CHIP_ERROR_INVALID_ARGUMENT or CHIP_ERROR_UNSUPPORTED_ENCRYPTION_TYPE on invalid arguments,
+     *         CHIP_ERROR_INTERNAL on failure to set up the cipher, CHIP_NO_ERROR otherwise.
+     */
+    CHIP_ERROR Init(const uint8_t * key, size_t key_length, size_t iv_length, size_t tag_length);
+
+    bool IsInitialized() const { return mInitialized; }
+
+    /**
+     * @brief Encrypt a message, as AES_CCM_encrypt() does with the key given to Init().
+     *
+     * @param plaintext Plaintext to encrypt
+     * @param plaintext_length Length of plain_text
+     * @param aad Additional authentication data
+     * @param aad_length Length of additional authentication data
+     * @param iv Initial vector, of the length given to Init()
+     * @param ciphertext Buffer to write ciphertext into, which may be plaintext itself
+     * @param tag Buffer to write the tag into, of the length given to Init()
+     * @return CHIP_ERROR_INCORRECT_STATE if Init() did not succeed, CHIP_ERROR_INVALID_ARGUMENT
+     *         on invalid arguments, CHIP_ERROR_INTERNAL on failure, CHIP_NO_ERROR otherwise.
+     */
+    CHIP_ERROR Encrypt(const uint8_t * plaintext, size_t plaintext_length, const uint8_t * aad, size_t aad_length,
+                       const uint8_t * iv, uint8_t * ciphertext, uint8_t * tag);
+
+    /**
+     * @brief Decrypt and authenticate a message, as AES_CCM_decrypt() does with the key given to Init().
+     *
+     * @param ciphertext Ciphertext to decrypt
+     * @param ciphertext_length Length of ciphertext
+     * @param aad Additional authentication data
+     * @param aad_length Length of additional authentication data
+     * @param tag Tag to verify, of the length given to Init()
+     * @param iv Initial vector, of the length given to Init()
+     * @param plaintext Buffer to write plaintext into, which may be ciphertext itself
+     * @return CHIP_ERROR_INCORRECT_STATE if Init() did not succeed, CHIP_ERROR_INVALID_ARGUMENT
+     *         on invalid arguments, CHIP_ERROR_INTERNAL on failure to authenticate, CHIP_NO_ERROR otherwise.
+     */
+    CHIP_ERROR Decrypt(const uint8_t * ciphertext, size_t ciphertext_length, const uint8_t * aad, size_t aad_length,
+                       const uint8_t * tag, const uint8_t * iv, uint8_t * plaintext);
+
+    /**
+     * @brief Release the key and the underlying cipher. Init() must be called again before further use.
+     */
+    void Clear();
+
+private:
+    AesCcmOpaqueContext mContext;
+    size_t mIVLength  = 0;
+    size_t mTagLength = 0;
+    bool mInitialized = false;
+};
+
 /**
  * @brief Verify the Certificate Signing Request (CSR). If successfully verified, it outputs the public key from the CSR.
  * @param csr CSR in DER format
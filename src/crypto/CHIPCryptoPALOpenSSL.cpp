@@ -344,6 +344,229 @@ exit:
     return error;
 }
 
+// The CCM stream function of some OpenSSL implementations (e.g. AES-NI) depends on the direction the
+// key was set up for, so each direction gets its own keyed cipher context.
+struct AesCcmContexts
+{
+    EVP_CIPHER_CTX * mEncrypt;
+    EVP_CIPHER_CTX * mDecrypt;
+};
+
+static_assert(kMAX_AES_CCM_Context_Size >= sizeof(AesCcmContexts),
+              "kMAX_AES_CCM_Context_Size is too small for the pointers to the underlying EVP_CIPHER_CTX");
+
+static inline AesCcmContexts * to_inner_aes_ccm_context(AesCcmOpaqueContext * context)
+{
+    return SafePointerCast<AesCcmContexts *>(context);
+}
+
+static CHIP_ERROR _initKeyedAesCcmContext(EVP_CIPHER_CTX *& context, const uint8_t * key, size_t key_length, size_t iv_length,
+                                          size_t tag_length, int enc)
+{
+    int result = 1;
+
+    // TODO: Remove support for AES-256 since not in 1.0
+    // Determine crypto type by key length
+    const EVP_CIPHER * type = (key_length == kAES_CCM128_Key_Length) ? EVP_aes_128_ccm() : EVP_aes_256_ccm();
+
+    context = EVP_CIPHER_CTX_new();
+    VerifyOrReturnError(context != nullptr, CHIP_ERROR_INTERNAL);
+
+    // Pass in cipher
+    result = EVP_CipherInit_ex(context, type, nullptr, nullptr, nullptr, enc);
+    VerifyOrReturnError(result == 1, CHIP_ERROR_INTERNAL);
+
+    // Nonce and tag lengths are baked into the CCM state when the key is set, so they come first.
+    // Casts are safe because the caller checked with CanCastTo and _isValidTagLength.
+    result = EVP_CIPHER_CTX_ctrl(context, EVP_CTRL_CCM_SET_IVLEN, static_cast<int>(iv_length), nullptr);
+    VerifyOrReturnError(result == 1, CHIP_ERROR_INTERNAL);
+
+    result = EVP_CIPHER_CTX_ctrl(context, EVP_CTRL_CCM_SET_TAG, static_cast<int>(tag_length), nullptr);
+    VerifyOrReturnError(result == 1, CHIP_ERROR_INTERNAL);
+
+    // Pass in key. Every message then only sets its own iv.
+    result = EVP_CipherInit_ex(context, nullptr, nullptr, Uint8::to_const_uchar(key), nullptr, enc);
+    VerifyOrReturnError(result == 1, CHIP_ERROR_INTERNAL);
+
+    return CHIP_NO_ERROR;
+}
+
+AES_CCM_context::AES_CCM_context()
+{
+    AesCcmContexts * contexts = to_inner_aes_ccm_context(&mContext);
+
+    contexts->mEncrypt = nullptr;
+    contexts->mDecrypt = nullptr;
+}
+
+AES_CCM_context::~AES_CCM_context()
+{
+    Clear();
+}
+
+CHIP_ERROR AES_CCM_context::Init(const uint8_t * key, size_t key_length, size_t iv_length, size_t tag_length)
+{
+    AesCcmContexts * contexts = to_inner_aes_ccm_context(&mContext);
+
+    Clear();
+
+    VerifyOrReturnError(key != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(_isValidKeyLength(key_length), CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(iv_length > 0, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(CanCastTo<int>(iv_length), CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(_isValidTagLength(tag_length), CHIP_ERROR_INVALID_ARGUMENT);
+
+    CHIP_ERROR error = _initKeyedAesCcmContext(contexts->mEncrypt, key, key_length, iv_length, tag_length, 1);
+    if (error == CHIP_NO_ERROR)
+    {
+        error = _initKeyedAesCcmContext(contexts->mDecrypt, key, key_length, iv_length, tag_length, 0);
+    }
+    if (error != CHIP_NO_ERROR)
+    {
+        Clear();
+        return error;
+    }
+
+    mIVLength    = iv_length;
+    mTagLength   = tag_length;
+    mInitialized = true;
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR AES_CCM_context::Encrypt(const uint8_t * plaintext, size_t plaintext_length, const uint8_t * aad, size_t aad_length,
+                                    const uint8_t * iv, uint8_t * ciphertext, uint8_t * tag)
+{
+    EVP_CIPHER_CTX * context = to_inner_aes_ccm_context(&mContext)->mEncrypt;
+    int bytesWritten         = 0;
+    int result               = 1;
+
+    // Placeholders for avoiding null params when the plaintext is empty; EVP_EncryptFinal_ex
+    // also needs a full block to write into.
+    uint8_t placeholder_empty_plaintext = 0;
+    uint8_t placeholder_ciphertext[kAES_CCM256_Block_Length];
+
+    VerifyOrReturnError(mInitialized, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(plaintext != nullptr || plaintext_length == 0, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(ciphertext != nullptr || plaintext_length == 0, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(aad != nullptr || aad_length == 0, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(iv != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(tag != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(CanCastTo<int>(plaintext_length), CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(CanCastTo<int>(aad_length), CHIP_ERROR_INVALID_ARGUMENT);
+
+    if (plaintext_length == 0)
+    {
+        plaintext  = &placeholder_empty_plaintext;
+        ciphertext = &placeholder_ciphertext[0];
+    }
+
+    // Pass in iv, keeping the key schedule
+    result = EVP_EncryptInit_ex(context, nullptr, nullptr, nullptr, Uint8::to_const_uchar(iv));
+    VerifyOrReturnError(result == 1, CHIP_ERROR_INTERNAL);
+
+    // Pass in plain text length
+    result = EVP_EncryptUpdate(context, nullptr, &bytesWritten, nullptr, static_cast<int>(plaintext_length));
+    VerifyOrReturnError(result == 1, CHIP_ERROR_INTERNAL);
+
+    // Pass in AAD
+    if (aad_length > 0)
+    {
+        result = EVP_EncryptUpdate(context, nullptr, &bytesWritten, Uint8::to_const_uchar(aad), static_cast<int>(aad_length));
+        VerifyOrReturnError(result == 1, CHIP_ERROR_INTERNAL);
+    }
+
+    // Encrypt
+    result = EVP_EncryptUpdate(context, Uint8::to_uchar(ciphertext), &bytesWritten, Uint8::to_const_uchar(plaintext),
+                               static_cast<int>(plaintext_length));
+    VerifyOrReturnError(result == 1, CHIP_ERROR_INTERNAL);
+    VerifyOrReturnError(bytesWritten >= 0 && bytesWritten <= static_cast<int>(plaintext_length), CHIP_ERROR_INTERNAL);
+
+    // Finalize encryption
+    result = EVP_EncryptFinal_ex(context, ciphertext + bytesWritten, &bytesWritten);
+    VerifyOrReturnError(result == 1, CHIP_ERROR_INTERNAL);
+
+    // Get tag. Cast is safe because Init checked _isValidTagLength.
+    result = EVP_CIPHER_CTX_ctrl(context, EVP_CTRL_CCM_GET_TAG, static_cast<int>(mTagLength), Uint8::to_uchar(tag));
+    VerifyOrReturnError(result == 1, CHIP_ERROR_INTERNAL);
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR AES_CCM_context::Decrypt(const uint8_t * ciphertext, size_t ciphertext_length, const uint8_t * aad, size_t aad_length,
+                                    const uint8_t * tag, const uint8_t * iv, uint8_t * plaintext)
+{
+    EVP_CIPHER_CTX * context = to_inner_aes_ccm_context(&mContext)->mDecrypt;
+    int bytesOutput          = 0;
+    int result               = 1;
+
+    // Placeholders for avoiding null params when the ciphertext is empty.
+    uint8_t placeholder_empty_ciphertext = 0;
+    uint8_t placeholder_plaintext[kAES_CCM256_Block_Length];
+
+    VerifyOrReturnError(mInitialized, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(ciphertext != nullptr || ciphertext_length == 0, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(plaintext != nullptr || ciphertext_length == 0, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(aad != nullptr || aad_length == 0, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(tag != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(iv != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(CanCastTo<int>(ciphertext_length), CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(CanCastTo<int>(aad_length), CHIP_ERROR_INVALID_ARGUMENT);
+
+    if (ciphertext_length == 0)
+    {
+        ciphertext = &placeholder_empty_ciphertext;
+        plaintext  = &placeholder_plaintext[0];
+    }
+
+    // Pass in iv, keeping the key schedule
+    result = EVP_DecryptInit_ex(context, nullptr, nullptr, nullptr, Uint8::to_const_uchar(iv));
+    VerifyOrReturnError(result == 1, CHIP_ERROR_INTERNAL);
+
+    // Pass in expected tag
+    // Removing "const" from |tag| here should hopefully be safe as
+    // we're writing the tag, not reading.
+    result = EVP_CIPHER_CTX_ctrl(context, EVP_CTRL_CCM_SET_TAG, static_cast<int>(mTagLength),
+                                 const_cast<void *>(static_cast<const void *>(tag)));
+    VerifyOrReturnError(result == 1, CHIP_ERROR_INTERNAL);
+
+    // Pass in cipher text length
+    result = EVP_DecryptUpdate(context, nullptr, &bytesOutput, nullptr, static_cast<int>(ciphertext_length));
+    VerifyOrReturnError(result == 1, CHIP_ERROR_INTERNAL);
+
+    // Pass in aad
+    if (aad_length > 0)
+    {
+        result = EVP_DecryptUpdate(context, nullptr, &bytesOutput, Uint8::to_const_uchar(aad), static_cast<int>(aad_length));
+        VerifyOrReturnError(result == 1, CHIP_ERROR_INTERNAL);
+    }
+
+    // Pass in ciphertext. We wont get anything if validation fails.
+    result = EVP_DecryptUpdate(context, Uint8::to_uchar(plaintext), &bytesOutput, Uint8::to_const_uchar(ciphertext),
+                               static_cast<int>(ciphertext_length));
+    VerifyOrReturnError(result == 1, CHIP_ERROR_INTERNAL);
+
+    return CHIP_NO_ERROR;
+}
+
+void AES_CCM_context::Clear()
+{
+    AesCcmContexts * contexts = to_inner_aes_ccm_context(&mContext);
+
+    for (EVP_CIPHER_CTX ** context : { &contexts->mEncrypt, &contexts->mDecrypt })
+    {
+        if (*context != nullptr)
+        {
+            EVP_CIPHER_CTX_free(*context);
+            *context = nullptr;
+        }
+    }
+
+    mIVLength    = 0;
+    mTagLength   = 0;
+    mInitialized = false;
+}
+
 CHIP_ERROR Hash_SHA256(const uint8_t * data, const size_t data_length, uint8_t * out_buffer)
 {
     // zero data length hash is supported.
@@ -192,6 +192,106 @@ exit:
     return error;
 }
 
+static_assert(kMAX_AES_CCM_Context_Size >= sizeof(mbedtls_ccm_context),
+              "kMAX_AES_CCM_Context_Size is too small for the size of underlying mbedtls_ccm_context");
+
+static inline mbedtls_ccm_context * to_inner_aes_ccm_context(AesCcmOpaqueContext * context)
+{
+    return SafePointerCast<mbedtls_ccm_context *>(context);
+}
+
+AES_CCM_context::AES_CCM_context()
+{
+    mbedtls_ccm_init(to_inner_aes_ccm_context(&mContext));
+}
+
+AES_CCM_context::~AES_CCM_context()
+{
+    Clear();
+}
+
+CHIP_ERROR AES_CCM_context::Init(const uint8_t * key, size_t key_length, size_t iv_length, size_t tag_length)
+{
+    Clear();
+
+    VerifyOrReturnError(key != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(_isValidKeyLength(key_length), CHIP_ERROR_UNSUPPORTED_ENCRYPTION_TYPE);
+    VerifyOrReturnError(iv_length > 0, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(_isValidTagLength(tag_length), CHIP_ERROR_INVALID_ARGUMENT);
+
+    // Size of key = key_length * number of bits in a byte (8)
+    // Cast is safe because we called _isValidKeyLength above.
+    const int result = mbedtls_ccm_setkey(to_inner_aes_ccm_context(&mContext), MBEDTLS_CIPHER_ID_AES, Uint8::to_const_uchar(key),
+                                          static_cast<unsigned int>(key_length * 8));
+    _log_mbedTLS_error(result);
+    if (result != 0)
+    {
+        Clear();
+        return CHIP_ERROR_INTERNAL;
+    }
+
+    mIVLength    = iv_length;
+    mTagLength   = tag_length;
+    mInitialized = true;
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR AES_CCM_context::Encrypt(const uint8_t * plaintext, size_t plaintext_length, const uint8_t * aad, size_t aad_length,
+                                    const uint8_t * iv, uint8_t * ciphertext, uint8_t * tag)
+{
+    VerifyOrReturnError(mInitialized, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(plaintext != nullptr || plaintext_length == 0, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(ciphertext != nullptr || plaintext_length == 0, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(aad != nullptr || aad_length == 0, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(iv != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(tag != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    // Encrypt
+    const int result = mbedtls_ccm_encrypt_and_tag(to_inner_aes_ccm_context(&mContext), plaintext_length, Uint8::to_const_uchar(iv),
+                                                   mIVLength, Uint8::to_const_uchar(aad), aad_length,
+                                                   Uint8::to_const_uchar(plaintext), Uint8::to_uchar(ciphertext),
+                                                   Uint8::to_uchar(tag), mTagLength);
+    _log_mbedTLS_error(result);
+    VerifyOrReturnError(result == 0, CHIP_ERROR_INTERNAL);
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR AES_CCM_context::Decrypt(const uint8_t * ciphertext, size_t ciphertext_length, const uint8_t * aad, size_t aad_length,
+                                    const uint8_t * tag, const uint8_t * iv, uint8_t * plaintext)
+{
+    VerifyOrReturnError(mInitialized, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(ciphertext != nullptr || ciphertext_length == 0, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(plaintext != nullptr || ciphertext_length == 0, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(aad != nullptr || aad_length == 0, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(tag != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(iv != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    // Decrypt
+    const int result = mbedtls_ccm_auth_decrypt(to_inner_aes_ccm_context(&mContext), ciphertext_length, Uint8::to_const_uchar(iv),
+                                                mIVLength, Uint8::to_const_uchar(aad), aad_length,
+                                                Uint8::to_const_uchar(ciphertext), Uint8::to_uchar(plaintext),
+                                                Uint8::to_const_uchar(tag), mTagLength);
+    _log_mbedTLS_error(result);
+    VerifyOrReturnError(result == 0, CHIP_ERROR_INTERNAL);
+
+    return CHIP_NO_ERROR;
+}
+
+void AES_CCM_context::Clear()
+{
+    mbedtls_ccm_context * context = to_inner_aes_ccm_context(&mContext);
+
+    // mbedtls_ccm_free also zeroizes the context.
+    mbedtls_ccm_free(context);
+    mbedtls_ccm_init(context);
+
+    mIVLength    = 0;
+    mTagLength   = 0;
+    mInitialized = false;
+}
+
 CHIP_ERROR Hash_SHA256(const uint8_t * data, const size_t data_length, uint8_t * out_buffer)
 {
     // zero data length hash is supported.
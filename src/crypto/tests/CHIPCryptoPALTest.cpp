@@ -594,6 +594,56 @@ static void TestAES_CCM_128DecryptInvalidIVLen(nlTestSuite * inSuite, void * inC
     NL_TEST_ASSERT(inSuite, numOfTestsRan > 0);
 }
 
+static void TestAES_CCM_128ContextInPlaceTestVectors(nlTestSuite * inSuite, void * inContext)
+{
+    HeapChecker heapChecker(inSuite);
+    int numOfTestVectors = ArraySize(ccm_128_test_vectors);
+    int numOfTestsRan    = 0;
+    for (int vectorIndex = 0; vectorIndex < numOfTestVectors; vectorIndex++)
+    {
+        const ccm_128_test_vector * vector = ccm_128_test_vectors[vectorIndex];
+        if (vector->pt_len > 0)
+        {
+            numOfTestsRan++;
+            AES_CCM_context context;
+            NL_TEST_ASSERT(inSuite, context.Init(vector->key, vector->key_len, vector->iv_len, vector->tag_len) == CHIP_NO_ERROR);
+
+            Platform::ScopedMemoryBuffer<uint8_t> buffer;
+            buffer.Alloc(vector->pt_len);
+            NL_TEST_ASSERT(inSuite, buffer);
+            uint8_t tag[kAES_CCM128_Block_Length];
+
+            if (vector->result == CHIP_NO_ERROR)
+            {
+                // Encrypt, then decrypt with the same keyed context, both in place.
+                memcpy(buffer.Get(), vector->pt, vector->pt_len);
+                CHIP_ERROR err =
+                    context.Encrypt(buffer.Get(), vector->pt_len, vector->aad, vector->aad_len, vector->iv, buffer.Get(), tag);
+                NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+                NL_TEST_ASSERT(inSuite, memcmp(buffer.Get(), vector->ct, vector->ct_len) == 0);
+                NL_TEST_ASSERT(inSuite, memcmp(tag, vector->tag, vector->tag_len) == 0);
+
+                err = context.Decrypt(buffer.Get(), vector->ct_len, vector->aad, vector->aad_len, tag, vector->iv, buffer.Get());
+                NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+                NL_TEST_ASSERT(inSuite, memcmp(buffer.Get(), vector->pt, vector->pt_len) == 0);
+            }
+            else
+            {
+                memcpy(buffer.Get(), vector->ct, vector->ct_len);
+                CHIP_ERROR err = context.Decrypt(buffer.Get(), vector->ct_len, vector->aad, vector->aad_len, vector->tag,
+                                                 vector->iv, buffer.Get());
+                NL_TEST_ASSERT(inSuite, err == vector->result);
+            }
+
+            context.Clear();
+            NL_TEST_ASSERT(inSuite,
+                           context.Encrypt(vector->pt, vector->pt_len, vector->aad, vector->aad_len, vector->iv, buffer.Get(),
+                                           tag) == CHIP_ERROR_INCORRECT_STATE);
+        }
+    }
+    NL_TEST_ASSERT(inSuite, numOfTestsRan > 0);
+}
+
 static void TestAsn1Conversions(nlTestSuite * inSuite, void * inContext)
 {
     HeapChecker heapChecker(inSuite);
@@ -2136,6 +2186,7 @@ static const nlTest sTests[] = {
     NL_TEST_DEF("Test encrypting AES-CCM-128 using invalid tag", TestAES_CCM_128EncryptInvalidTagLen),
     NL_TEST_DEF("Test decrypting AES-CCM-128 invalid key", TestAES_CCM_128DecryptInvalidKey),
     NL_TEST_DEF("Test decrypting AES-CCM-128 invalid IV", TestAES_CCM_128DecryptInvalidIVLen),
+    NL_TEST_DEF("Test AES-CCM-128 keyed context in place", TestAES_CCM_128ContextInPlaceTestVectors),
     NL_TEST_DEF("Test encrypting AES-CCM-256 test vectors", TestAES_CCM_256EncryptTestVectors),
     NL_TEST_DEF("Test decrypting AES-CCM-256 test vectors", TestAES_CCM_256DecryptTestVectors),
     NL_TEST_DEF("Test encrypting AES-CCM-256 using nil key", TestAES_CCM_256EncryptNilKey),
@@ -91,6 +91,16 @@
 #define CHIP_DEVICE_CONFIG_MAX_EVENT_QUEUE_SIZE 100
 #endif
 
+/**
+ * CHIP_DEVICE_CONFIG_POSIX_EVENT_QUEUE_SIZE
+ *
+ * The maximum number of events that can be held in the lock-free event queue of the POSIX platforms.  Must be a power of two.
+ * Events posted while it is full go to a slower, mutex-protected queue on the heap instead.
+ */
+#ifndef CHIP_DEVICE_CONFIG_POSIX_EVENT_QUEUE_SIZE
+#define CHIP_DEVICE_CONFIG_POSIX_EVENT_QUEUE_SIZE 1024
+#endif
+
 /**
  * CHIP_DEVICE_CONFIG_ENABLE_FACTORY_PROVISIONING
  *
@@ -69,6 +69,11 @@ public:
     /// Return maximum supported download block size
     virtual uint16_t GetMaxDownloadBlockSize() { return 1024; }
 
+    /// Return the number of blocks to query ahead of the one being processed during a download. Larger windows hide the round
+    /// trip time on high latency links, but need the OTA Provider to support them and buffer that many blocks. Only used on
+    /// sessions which do not use MRP, as MRP allows a single message in flight.
+    virtual uint8_t GetDownloadWindowSize() { return 1; }
+
     /// Called when an error occurs at any OTA requestor operation
     virtual void HandleError(UpdateFailureState state, CHIP_ERROR error) = 0;
 
@@ -131,20 +131,56 @@ CHIP_ERROR GenericPlatformManagerImpl_POSIX<ImplClass>::_StartChipTimer(System::
 template <class ImplClass>
 CHIP_ERROR GenericPlatformManagerImpl_POSIX<ImplClass>::_PostEvent(const ChipDeviceEvent * event)
 {
-    mChipEventQueue.Push(*event);
+    // Once an event has spilled over, later ones spill too until the event loop has caught up, so that they stay in order.
+    if (mChipEventQueueOverflowing.load() || !mChipEventQueue.Push(*event))
+    {
+        std::lock_guard<std::mutex> lock(mChipEventOverflowLock);
+        mChipEventQueueOverflowing.store(true);
+        mChipEventOverflowQueue.push(*event);
+    }
 
-    SystemLayerSocketsLoop().Signal(); // Trigger wake select on CHIP thread
+    if (!mChipEventQueueWakePending.exchange(true))
+    {
+        SystemLayerSocketsLoop().Signal(); // Trigger wake select on CHIP thread
+    }
     return CHIP_NO_ERROR;
 }
 
 template <class ImplClass>
 void GenericPlatformManagerImpl_POSIX<ImplClass>::ProcessDeviceEvents()
 {
-    while (!mChipEventQueue.Empty())
+    ChipDeviceEvent event;
+
+    // Clear the flag before draining the queue, so that an event posted from here on signals the event loop again.
+    mChipEventQueueWakePending.exchange(false);
+    while (mChipEventQueue.Pop(event))
     {
-        const ChipDeviceEvent event = mChipEventQueue.PopFront();
         Impl()->DispatchEvent(&event);
     }
+
+    while (mChipEventQueueOverflowing.load())
+    {
+        std::queue<ChipDeviceEvent> overflow;
+        {
+            std::lock_guard<std::mutex> lock(mChipEventOverflowLock);
+            if (mChipEventOverflowQueue.empty())
+            {
+                mChipEventQueueOverflowing.store(false);
+                break;
+            }
+            overflow.swap(mChipEventOverflowQueue);
+        }
+
+        // An event that spilled over was posted after whatever its poster had pushed to mChipEventQueue, so drain that first.
+        while (mChipEventQueue.Pop(event))
+        {
+            Impl()->DispatchEvent(&event);
+        }
+        for (; !overflow.empty(); overflow.pop())
+        {
+            Impl()->DispatchEvent(&overflow.front());
+        }
+    }
 }
 
 template <class ImplClass>
@@ -24,7 +24,8 @@
 
 #pragma once
 
-#include <platform/DeviceSafeQueue.h>
+#include <lib/support/BoundedMpscQueue.h>
+#include <platform/CHIPDeviceConfig.h>
 #include <platform/internal/GenericPlatformManagerImpl.h>
 
 #include <fcntl.h>
@@ -33,6 +34,7 @@
 #include <unistd.h>
 
 #include <atomic>
+#include <mutex>
 #include <pthread.h>
 #include <queue>
 
@@ -109,7 +111,15 @@ private:
 
     void ProcessDeviceEvents();
 
-    DeviceSafeQueue mChipEventQueue;
+    BoundedMpscQueue<ChipDeviceEvent, CHIP_DEVICE_CONFIG_POSIX_EVENT_QUEUE_SIZE> mChipEventQueue;
+    // Events posted while mChipEventQueue is full, so that posting never fails.  mChipEventQueueOverflowing is set from the
+    // first such event until the event loop finds mChipEventOverflowQueue empty.
+    std::mutex mChipEventOverflowLock;
+    std::queue<ChipDeviceEvent> mChipEventOverflowQueue;
+    std::atomic<bool> mChipEventQueueOverflowing{ false };
+    // Set by the thread that posts to an idle event loop and wakes it up, cleared by the event loop before it processes the
+    // queued events: only the first event posted after that needs to signal the event loop.
+    std::atomic<bool> mChipEventQueueWakePending{ false };
     std::atomic<bool> mShouldRunEventLoop;
     static void * EventLoopTaskMain(void * arg);
 };
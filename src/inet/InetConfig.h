@@ -250,4 +250,61 @@
 #ifndef INET_CONFIG_IP_MULTICAST_HOP_LIMIT
 #define INET_CONFIG_IP_MULTICAST_HOP_LIMIT                 (64)
 #endif // INET_CONFIG_IP_MULTICAST_HOP_LIMIT
+
+/**
+ *  @def INET_CONFIG_UDP_SOCKET_MMSG
+ *
+ *  @brief
+ *    Defines whether (1) or not (0) the sockets implementation
+ *    of UDP endpoints may use recvmmsg() and sendmmsg() to
+ *    receive and send several datagrams with one system call.
+ *
+ */
+#ifndef INET_CONFIG_UDP_SOCKET_MMSG
+#if defined(__linux__)
+#define INET_CONFIG_UDP_SOCKET_MMSG                        1
+#else
+#define INET_CONFIG_UDP_SOCKET_MMSG                        0
+#endif
+#endif // INET_CONFIG_UDP_SOCKET_MMSG
+
+/**
+ *  @def INET_CONFIG_UDP_SOCKET_RECV_BATCH_SIZE
+ *
+ *  @brief
+ *    The maximum number of datagrams a sockets-based UDP
+ *    endpoint reads with one recvmmsg() call.
+ *
+ *  @details
+ *    When greater than one, a listening endpoint keeps up to
+ *    this many full-size packet buffers ready to receive into,
+ *    so that a burst of datagrams costs one system call rather
+ *    than one per datagram. Each received datagram is still
+ *    delivered through its own OnMessageReceived call.
+ *
+ *    Batching is only enabled by default when packet buffers
+ *    are allocated from the heap, since the idle receive
+ *    buffers would otherwise be taken from the fixed pool.
+ *
+ */
+#ifndef INET_CONFIG_UDP_SOCKET_RECV_BATCH_SIZE
+#if INET_CONFIG_UDP_SOCKET_MMSG && CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SIZE == 0
+#define INET_CONFIG_UDP_SOCKET_RECV_BATCH_SIZE             16
+#else
+#define INET_CONFIG_UDP_SOCKET_RECV_BATCH_SIZE             1
+#endif
+#endif // INET_CONFIG_UDP_SOCKET_RECV_BATCH_SIZE
+
+/**
+ *  @def INET_CONFIG_UDP_SOCKET_SEND_BATCH_SIZE
+ *
+ *  @brief
+ *    The maximum number of destinations a sockets-based UDP
+ *    endpoint sends to with one sendmmsg() call, when a message
+ *    is sent to several destinations with SendMsgToAll().
+ *
+ */
+#ifndef INET_CONFIG_UDP_SOCKET_SEND_BATCH_SIZE
+#define INET_CONFIG_UDP_SOCKET_SEND_BATCH_SIZE             16
+#endif // INET_CONFIG_UDP_SOCKET_SEND_BATCH_SIZE
 // clang-format on
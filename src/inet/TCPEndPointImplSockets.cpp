@@ -30,6 +30,7 @@
 #include <lib/support/logging/CHIPLogging.h>
 #include <system/SystemFaultInjection.h>
 
+#include <algorithm>
 #include <stdio.h>
 #include <string.h>
 #include <utility>
@@ -41,6 +42,7 @@
 #include <sys/ioctl.h>
 #include <sys/select.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 // SOCK_CLOEXEC not defined on all platforms, e.g. iOS/macOS:
@@ -508,9 +510,39 @@ CHIP_ERROR TCPEndPointImplSockets::DriveSendingImpl()
 
     while (!mSendQueue.IsNull())
     {
-        uint16_t bufLen = mSendQueue->DataLength();
+        // Release empty buffers at the head of the queue: nothing would ever be sent from them, so they would never be released
+        // by a send, and a queue of nothing else would be retried forever.
+        while (!mSendQueue.IsNull() && mSendQueue->DataLength() == 0)
+        {
+            mSendQueue.FreeHead();
+        }
+
+        if (mSendQueue.IsNull())
+        {
+            err = static_cast<System::LayerSockets &>(GetSystemLayer()).ClearCallbackOnPendingWrite(mWatch);
+            break;
+        }
+
+        // Gather as many of the queued buffers as fit in one call, so that a message split across buffers, or a burst of small
+        // messages, costs a single system call.
+        struct iovec sendIOV[kMaxSendIOVecs];
+        size_t numIOVecs = 0;
+        size_t queueLen  = 0;
+
+        for (System::PacketBufferHandle buf = mSendQueue.Retain(); !buf.IsNull() && numIOVecs < kMaxSendIOVecs; buf.Advance())
+        {
+            sendIOV[numIOVecs].iov_base = buf->Start();
+            sendIOV[numIOVecs].iov_len  = buf->DataLength();
+            queueLen += buf->DataLength();
+            numIOVecs++;
+        }
+
+        struct msghdr msgHeader;
+        memset(&msgHeader, 0, sizeof(msgHeader));
+        msgHeader.msg_iov    = sendIOV;
+        msgHeader.msg_iovlen = numIOVecs;
 
-        ssize_t lenSentRaw = send(mSocket, mSendQueue->Start(), bufLen, sendFlags);
+        ssize_t lenSentRaw = sendmsg(mSocket, &msgHeader, sendFlags);
 
         if (lenSentRaw == -1)
         {
@@ -521,43 +553,52 @@ CHIP_ERROR TCPEndPointImplSockets::DriveSendingImpl()
             break;
         }
 
-        if (lenSentRaw < 0 || lenSentRaw > bufLen)
+        if (lenSentRaw < 0 || static_cast<size_t>(lenSentRaw) > queueLen)
         {
             err = CHIP_ERROR_INCORRECT_STATE;
             break;
         }
 
-        // Cast is safe because bufLen is uint16_t.
-        uint16_t lenSent = static_cast<uint16_t>(lenSentRaw);
+        size_t lenSent = static_cast<size_t>(lenSentRaw);
 
         // Mark the connection as being active.
         MarkActive();
 
-        if (lenSent < bufLen)
+        // Release the buffers that were sent in full, and consume what was sent of the next one.
+        for (size_t lenLeft = lenSent; lenLeft > 0;)
         {
-            mSendQueue->ConsumeHead(lenSent);
+            uint16_t bufLen = mSendQueue->DataLength();
+            if (lenLeft < bufLen)
+            {
+                mSendQueue->ConsumeHead(static_cast<uint16_t>(lenLeft));
+                break;
+            }
+            mSendQueue.FreeHead();
+            lenLeft -= bufLen;
         }
-        else
+
+        if (mSendQueue.IsNull())
         {
-            mSendQueue.FreeHead();
-            if (mSendQueue.IsNull())
+            // Do not wait for ability to write on this endpoint.
+            err = static_cast<System::LayerSockets &>(GetSystemLayer()).ClearCallbackOnPendingWrite(mWatch);
+            if (err != CHIP_NO_ERROR)
             {
-                // Do not wait for ability to write on this endpoint.
-                err = static_cast<System::LayerSockets &>(GetSystemLayer()).ClearCallbackOnPendingWrite(mWatch);
-                if (err != CHIP_NO_ERROR)
-                {
-                    break;
-                }
+                break;
             }
         }
 
         if (OnDataSent != nullptr)
         {
-            OnDataSent(this, lenSent);
+            for (size_t lenLeft = lenSent; lenLeft > 0;)
+            {
+                uint16_t len = static_cast<uint16_t>(std::min<size_t>(lenLeft, UINT16_MAX));
+                OnDataSent(this, len);
+                lenLeft -= len;
+            }
         }
 
 #if INET_CONFIG_OVERRIDE_SYSTEM_TCP_USER_TIMEOUT
-        mBytesWrittenSinceLastProbe += lenSent;
+        mBytesWrittenSinceLastProbe += static_cast<uint32_t>(lenSent);
 
         bool isProgressing = false;
 
@@ -583,7 +624,7 @@ CHIP_ERROR TCPEndPointImplSockets::DriveSendingImpl()
         }
 #endif // INET_CONFIG_OVERRIDE_SYSTEM_TCP_USER_TIMEOUT
 
-        if (lenSent < bufLen)
+        if (lenSent < queueLen)
         {
             break;
         }
@@ -56,6 +56,9 @@ public:
 #endif // INET_CONFIG_OVERRIDE_SYSTEM_TCP_USER_TIMEOUT
 
 private:
+    // Maximum number of queued buffers written by a single sendmsg() call.
+    constexpr static size_t kMaxSendIOVecs = 16;
+
     // TCPEndPoint overrides.
     CHIP_ERROR BindImpl(IPAddressType addrType, const IPAddress & addr, uint16_t port, bool reuseAddr) override;
     CHIP_ERROR ListenImpl(uint16_t backlog) override;
@@ -121,6 +121,31 @@ CHIP_ERROR UDPEndPoint::SendMsg(const IPPacketInfo * pktInfo, System::PacketBuff
     return CHIP_NO_ERROR;
 }
 
+CHIP_ERROR UDPEndPoint::SendMsgToAll(const IPPacketInfo * pktInfos, size_t count, System::PacketBufferHandle && msg)
+{
+    INET_FAULT_INJECT(FaultInjection::kFault_Send, return INET_ERROR_UNKNOWN_INTERFACE;);
+    INET_FAULT_INJECT(FaultInjection::kFault_SendNonCritical, return CHIP_ERROR_NO_MEMORY;);
+
+    VerifyOrReturnError(count > 0, CHIP_ERROR_INVALID_ARGUMENT);
+    ReturnErrorOnFailure(SendMsgToAllImpl(pktInfos, count, std::move(msg)));
+
+    CHIP_SYSTEM_FAULT_INJECT_ASYNC_EVENT();
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR UDPEndPoint::SendMsgToAllImpl(const IPPacketInfo * pktInfos, size_t count, System::PacketBufferHandle && msg)
+{
+    // SendMsgImpl() takes ownership of the buffer it sends, and may modify it, so every destination but the last gets a copy.
+    for (size_t i = 0; i + 1 < count; i++)
+    {
+        System::PacketBufferHandle copy = msg.CloneData();
+        VerifyOrReturnError(!copy.IsNull(), CHIP_ERROR_NO_MEMORY);
+        ReturnErrorOnFailure(SendMsgImpl(&pktInfos[i], std::move(copy)));
+    }
+    return SendMsgImpl(&pktInfos[count - 1], std::move(msg));
+}
+
 void UDPEndPoint::Close()
 {
     if (mState != State::kClosed)
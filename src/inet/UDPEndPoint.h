@@ -227,6 +227,23 @@ public:
      */
     CHIP_ERROR SendMsg(const IPPacketInfo * pktInfo, chip::System::PacketBufferHandle && msg);
 
+    /**
+     * Send the same UDP message to several destinations.
+     *
+     *  Equivalent to calling \c SendMsg() with a copy of \c msg for each of the \c count entries of \c pktInfos, in order.
+     *  Where the platform supports it, the message is sent to several destinations with one system call and is not copied.
+     *
+     * @param[in]   pktInfos    Source and destination information for each copy of the UDP message.
+     * @param[in]   count       Number of entries in \c pktInfos.
+     * @param[in]   msg         Packet buffer containing the UDP message.
+     *
+     * @retval  CHIP_NO_ERROR                       Success: \c msg is queued for transmit to every destination.
+     * @retval  CHIP_ERROR_INVALID_ARGUMENT         \c count is zero.
+     * @retval  CHIP_ERROR_NO_MEMORY                A copy of \c msg could not be allocated.
+     * @retval  other                               As for \c SendMsg(); \c msg may have been sent to some of the destinations.
+     */
+    CHIP_ERROR SendMsgToAll(const IPPacketInfo * pktInfos, size_t count, chip::System::PacketBufferHandle && msg);
+
     /**
      * Close the endpoint.
      *
@@ -296,6 +313,9 @@ protected:
     virtual CHIP_ERROR ListenImpl()                                                                                           = 0;
     virtual CHIP_ERROR SendMsgImpl(const IPPacketInfo * pktInfo, chip::System::PacketBufferHandle && msg)                     = 0;
     virtual void CloseImpl()                                                                                                  = 0;
+
+    // Sends to each destination in turn with SendMsgImpl(); implementations may override it to batch the sends.
+    virtual CHIP_ERROR SendMsgToAllImpl(const IPPacketInfo * pktInfos, size_t count, chip::System::PacketBufferHandle && msg);
 };
 
 template <>
@@ -34,6 +34,7 @@
 #include <sys/socket.h>
 #endif // HAVE_SYS_SOCKET_H
 
+#include <algorithm>
 #include <cerrno>
 #include <net/if.h>
 #include <netinet/in.h>
@@ -283,7 +284,19 @@ CHIP_ERROR UDPEndPointImplSockets::ListenImpl()
     return layer->RequestCallbackOnPendingRead(mWatch);
 }
 
-CHIP_ERROR UDPEndPointImplSockets::SendMsgImpl(const IPPacketInfo * aPktInfo, System::PacketBufferHandle && msg)
+/**
+ * The message header of one outgoing datagram, with the destination address and control data it points to.
+ */
+struct UDPEndPointImplSockets::OutgoingMsg
+{
+    SockAddr peerSockAddr;
+#if defined(IP_PKTINFO) || defined(IPV6_PKTINFO)
+    uint8_t controlData[256];
+#endif // defined(IP_PKTINFO) || defined(IPV6_PKTINFO)
+    struct msghdr msgHeader;
+};
+
+CHIP_ERROR UDPEndPointImplSockets::PrepareOutgoingMsg(const IPPacketInfo * aPktInfo, struct iovec * aIOV, OutgoingMsg & aMsg)
 {
     // Make sure we have the appropriate type of socket based on the
     // destination address.
@@ -292,25 +305,18 @@ CHIP_ERROR UDPEndPointImplSockets::SendMsgImpl(const IPPacketInfo * aPktInfo, Sy
     // Ensure the destination address type is compatible with the endpoint address type.
     VerifyOrReturnError(mAddrType == aPktInfo->DestAddress.Type(), CHIP_ERROR_INVALID_ARGUMENT);
 
-    // For now the entire message must fit within a single buffer.
-    VerifyOrReturnError(!msg->HasChainedBuffer(), CHIP_ERROR_MESSAGE_TOO_LONG);
-
-    struct iovec msgIOV;
-    msgIOV.iov_base = msg->Start();
-    msgIOV.iov_len  = msg->DataLength();
-
 #if defined(IP_PKTINFO) || defined(IPV6_PKTINFO)
-    uint8_t controlData[256];
-    memset(controlData, 0, sizeof(controlData));
+    uint8_t * const controlData = aMsg.controlData;
+    memset(controlData, 0, sizeof(aMsg.controlData));
 #endif // defined(IP_PKTINFO) || defined(IPV6_PKTINFO)
 
-    struct msghdr msgHeader;
+    struct msghdr & msgHeader = aMsg.msgHeader;
     memset(&msgHeader, 0, sizeof(msgHeader));
-    msgHeader.msg_iov    = &msgIOV;
+    msgHeader.msg_iov    = aIOV;
     msgHeader.msg_iovlen = 1;
 
     // Construct a sockaddr_in/sockaddr_in6 structure containing the destination information.
-    SockAddr peerSockAddr;
+    SockAddr & peerSockAddr = aMsg.peerSockAddr;
     memset(&peerSockAddr, 0, sizeof(peerSockAddr));
     msgHeader.msg_name = &peerSockAddr;
     if (mAddrType == IPAddressType::kIPv6)
@@ -353,7 +359,7 @@ CHIP_ERROR UDPEndPointImplSockets::SendMsgImpl(const IPPacketInfo * aPktInfo, Sy
     {
 #if defined(IP_PKTINFO) || defined(IPV6_PKTINFO)
         msgHeader.msg_control    = controlData;
-        msgHeader.msg_controllen = sizeof(controlData);
+        msgHeader.msg_controllen = sizeof(aMsg.controlData);
 
         struct cmsghdr * controlHdr      = CMSG_FIRSTHDR(&msgHeader);
         InterfaceId::PlatformType intfId = intf.GetPlatformInterface();
@@ -410,8 +416,23 @@ CHIP_ERROR UDPEndPointImplSockets::SendMsgImpl(const IPPacketInfo * aPktInfo, Sy
 #endif // !(defined(IP_PKTINFO) && defined(IPV6_PKTINFO))
     }
 
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR UDPEndPointImplSockets::SendMsgImpl(const IPPacketInfo * aPktInfo, System::PacketBufferHandle && msg)
+{
+    struct iovec msgIOV;
+    OutgoingMsg outgoingMsg;
+    ReturnErrorOnFailure(PrepareOutgoingMsg(aPktInfo, &msgIOV, outgoingMsg));
+
+    // For now the entire message must fit within a single buffer.
+    VerifyOrReturnError(!msg->HasChainedBuffer(), CHIP_ERROR_MESSAGE_TOO_LONG);
+
+    msgIOV.iov_base = msg->Start();
+    msgIOV.iov_len  = msg->DataLength();
+
     // Send IP packet.
-    const ssize_t lenSent = sendmsg(mSocket, &msgHeader, 0);
+    const ssize_t lenSent = sendmsg(mSocket, &outgoingMsg.msgHeader, 0);
     if (lenSent == -1)
     {
         return CHIP_ERROR_POSIX(errno);
@@ -423,6 +444,52 @@ CHIP_ERROR UDPEndPointImplSockets::SendMsgImpl(const IPPacketInfo * aPktInfo, Sy
     return CHIP_NO_ERROR;
 }
 
+#if INET_CONFIG_UDP_SOCKET_MMSG
+CHIP_ERROR UDPEndPointImplSockets::SendMsgToAllImpl(const IPPacketInfo * aPktInfos, size_t aCount,
+                                                    System::PacketBufferHandle && msg)
+{
+    // For now the entire message must fit within a single buffer.
+    VerifyOrReturnError(!msg->HasChainedBuffer(), CHIP_ERROR_MESSAGE_TOO_LONG);
+
+    // All the datagrams share the one buffer; only their destinations differ.
+    struct iovec msgIOV;
+    msgIOV.iov_base = msg->Start();
+    msgIOV.iov_len  = msg->DataLength();
+
+    OutgoingMsg outgoingMsgs[INET_CONFIG_UDP_SOCKET_SEND_BATCH_SIZE];
+    struct mmsghdr msgHeaders[INET_CONFIG_UDP_SOCKET_SEND_BATCH_SIZE];
+
+    while (aCount > 0)
+    {
+        const size_t batchSize = std::min<size_t>(aCount, INET_CONFIG_UDP_SOCKET_SEND_BATCH_SIZE);
+        for (size_t i = 0; i < batchSize; i++)
+        {
+            ReturnErrorOnFailure(PrepareOutgoingMsg(&aPktInfos[i], &msgIOV, outgoingMsgs[i]));
+            msgHeaders[i].msg_hdr = outgoingMsgs[i].msgHeader;
+            msgHeaders[i].msg_len = 0;
+        }
+
+        // Send IP packets. Fewer than batchSize may be sent; the rest go with the next call.
+        const int numSent = sendmmsg(mSocket, msgHeaders, static_cast<unsigned int>(batchSize), 0);
+        if (numSent < 0)
+        {
+            return CHIP_ERROR_POSIX(errno);
+        }
+        for (int i = 0; i < numSent; i++)
+        {
+            if (msgHeaders[i].msg_len != msg->DataLength())
+            {
+                return CHIP_ERROR_OUTBOUND_MESSAGE_TOO_BIG;
+            }
+        }
+
+        aPktInfos += numSent;
+        aCount -= static_cast<size_t>(numSent);
+    }
+    return CHIP_NO_ERROR;
+}
+#endif // INET_CONFIG_UDP_SOCKET_MMSG
+
 void UDPEndPointImplSockets::CloseImpl()
 {
     if (mSocket != kInvalidSocketFd)
@@ -432,6 +499,13 @@ void UDPEndPointImplSockets::CloseImpl()
         mSocket = kInvalidSocketFd;
     }
 
+#if INET_CONFIG_UDP_SOCKET_MMSG && INET_CONFIG_UDP_SOCKET_RECV_BATCH_SIZE > 1
+    for (System::PacketBufferHandle & lBuffer : mReceiveBuffers)
+    {
+        lBuffer = nullptr;
+    }
+#endif // INET_CONFIG_UDP_SOCKET_MMSG && INET_CONFIG_UDP_SOCKET_RECV_BATCH_SIZE > 1
+
 #if CHIP_SYSTEM_CONFIG_USE_DISPATCH
     if (mReadableSource)
     {
@@ -563,6 +637,72 @@ CHIP_ERROR UDPEndPointImplSockets::GetSocket(IPAddressType addressType)
     return CHIP_NO_ERROR;
 }
 
+namespace {
+
+/**
+ * Fill in the source and, when reported by the IP_PKTINFO/IPV6_PKTINFO control messages, the interface and destination
+ * address of a datagram received with the message header @a msgHeader.
+ */
+CHIP_ERROR GetReceivedPacketInfo(struct msghdr & msgHeader, IPPacketInfo & lPacketInfo)
+{
+    const SockAddr & lPeerSockAddr = *static_cast<const SockAddr *>(msgHeader.msg_name);
+
+    if (lPeerSockAddr.any.sa_family == AF_INET6)
+    {
+        lPacketInfo.SrcAddress = IPAddress(lPeerSockAddr.in6.sin6_addr);
+        lPacketInfo.SrcPort    = ntohs(lPeerSockAddr.in6.sin6_port);
+    }
+#if INET_CONFIG_ENABLE_IPV4
+    else if (lPeerSockAddr.any.sa_family == AF_INET)
+    {
+        lPacketInfo.SrcAddress = IPAddress(lPeerSockAddr.in.sin_addr);
+        lPacketInfo.SrcPort    = ntohs(lPeerSockAddr.in.sin_port);
+    }
+#endif // INET_CONFIG_ENABLE_IPV4
+    else
+    {
+        return CHIP_ERROR_INCORRECT_STATE;
+    }
+
+    for (struct cmsghdr * controlHdr = CMSG_FIRSTHDR(&msgHeader); controlHdr != nullptr;
+         controlHdr                  = CMSG_NXTHDR(&msgHeader, controlHdr))
+    {
+#if INET_CONFIG_ENABLE_IPV4
+#ifdef IP_PKTINFO
+        if (controlHdr->cmsg_level == IPPROTO_IP && controlHdr->cmsg_type == IP_PKTINFO)
+        {
+            auto * inPktInfo = reinterpret_cast<struct in_pktinfo *> CMSG_DATA(controlHdr);
+            if (!CanCastTo<InterfaceId::PlatformType>(inPktInfo->ipi_ifindex))
+            {
+                return CHIP_ERROR_INCORRECT_STATE;
+            }
+            lPacketInfo.Interface   = InterfaceId(static_cast<InterfaceId::PlatformType>(inPktInfo->ipi_ifindex));
+            lPacketInfo.DestAddress = IPAddress(inPktInfo->ipi_addr);
+            continue;
+        }
+#endif // defined(IP_PKTINFO)
+#endif // INET_CONFIG_ENABLE_IPV4
+
+#ifdef IPV6_PKTINFO
+        if (controlHdr->cmsg_level == IPPROTO_IPV6 && controlHdr->cmsg_type == IPV6_PKTINFO)
+        {
+            auto * in6PktInfo = reinterpret_cast<struct in6_pktinfo *> CMSG_DATA(controlHdr);
+            if (!CanCastTo<InterfaceId::PlatformType>(in6PktInfo->ipi6_ifindex))
+            {
+                return CHIP_ERROR_INCORRECT_STATE;
+            }
+            lPacketInfo.Interface   = InterfaceId(static_cast<InterfaceId::PlatformType>(in6PktInfo->ipi6_ifindex));
+            lPacketInfo.DestAddress = IPAddress(in6PktInfo->ipi6_addr);
+            continue;
+        }
+#endif // defined(IPV6_PKTINFO)
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+} // anonymous namespace
+
 // static
 void UDPEndPointImplSockets::HandlePendingIO(System::SocketEvents events, intptr_t data)
 {
@@ -576,6 +716,14 @@ void UDPEndPointImplSockets::HandlePendingIO(System::SocketEvents events)
         return;
     }
 
+#if INET_CONFIG_UDP_SOCKET_MMSG && INET_CONFIG_UDP_SOCKET_RECV_BATCH_SIZE > 1
+    if (mReceiveBatchSize > 1)
+    {
+        HandlePendingReadBatch();
+        return;
+    }
+#endif // INET_CONFIG_UDP_SOCKET_MMSG && INET_CONFIG_UDP_SOCKET_RECV_BATCH_SIZE > 1
+
     CHIP_ERROR lStatus = CHIP_NO_ERROR;
     IPPacketInfo lPacketInfo;
     System::PacketBufferHandle lBuffer;
@@ -619,62 +767,7 @@ void UDPEndPointImplSockets::HandlePendingIO(System::SocketEvents events)
         else
         {
             lBuffer->SetDataLength(static_cast<uint16_t>(rcvLen));
-
-            if (lPeerSockAddr.any.sa_family == AF_INET6)
-            {
-                lPacketInfo.SrcAddress = IPAddress(lPeerSockAddr.in6.sin6_addr);
-                lPacketInfo.SrcPort    = ntohs(lPeerSockAddr.in6.sin6_port);
-            }
-#if INET_CONFIG_ENABLE_IPV4
-            else if (lPeerSockAddr.any.sa_family == AF_INET)
-            {
-                lPacketInfo.SrcAddress = IPAddress(lPeerSockAddr.in.sin_addr);
-                lPacketInfo.SrcPort    = ntohs(lPeerSockAddr.in.sin_port);
-            }
-#endif // INET_CONFIG_ENABLE_IPV4
-            else
-            {
-                lStatus = CHIP_ERROR_INCORRECT_STATE;
-            }
-        }
-
-        if (lStatus == CHIP_NO_ERROR)
-        {
-            for (struct cmsghdr * controlHdr = CMSG_FIRSTHDR(&msgHeader); controlHdr != nullptr;
-                 controlHdr                  = CMSG_NXTHDR(&msgHeader, controlHdr))
-            {
-#if INET_CONFIG_ENABLE_IPV4
-#ifdef IP_PKTINFO
-                if (controlHdr->cmsg_level == IPPROTO_IP && controlHdr->cmsg_type == IP_PKTINFO)
-                {
-                    auto * inPktInfo = reinterpret_cast<struct in_pktinfo *> CMSG_DATA(controlHdr);
-                    if (!CanCastTo<InterfaceId::PlatformType>(inPktInfo->ipi_ifindex))
-                    {
-                        lStatus = CHIP_ERROR_INCORRECT_STATE;
-                        break;
-                    }
-                    lPacketInfo.Interface   = InterfaceId(static_cast<InterfaceId::PlatformType>(inPktInfo->ipi_ifindex));
-                    lPacketInfo.DestAddress = IPAddress(inPktInfo->ipi_addr);
-                    continue;
-                }
-#endif // defined(IP_PKTINFO)
-#endif // INET_CONFIG_ENABLE_IPV4
-
-#ifdef IPV6_PKTINFO
-                if (controlHdr->cmsg_level == IPPROTO_IPV6 && controlHdr->cmsg_type == IPV6_PKTINFO)
-                {
-                    auto * in6PktInfo = reinterpret_cast<struct in6_pktinfo *> CMSG_DATA(controlHdr);
-                    if (!CanCastTo<InterfaceId::PlatformType>(in6PktInfo->ipi6_ifindex))
-                    {
-                        lStatus = CHIP_ERROR_INCORRECT_STATE;
-                        break;
-                    }
-                    lPacketInfo.Interface   = InterfaceId(static_cast<InterfaceId::PlatformType>(in6PktInfo->ipi6_ifindex));
-                    lPacketInfo.DestAddress = IPAddress(in6PktInfo->ipi6_addr);
-                    continue;
-                }
-#endif // defined(IPV6_PKTINFO)
-            }
+            lStatus = GetReceivedPacketInfo(msgHeader, lPacketInfo);
         }
     }
     else
@@ -696,6 +789,114 @@ void UDPEndPointImplSockets::HandlePendingIO(System::SocketEvents events)
     }
 }
 
+#if INET_CONFIG_UDP_SOCKET_MMSG && INET_CONFIG_UDP_SOCKET_RECV_BATCH_SIZE > 1
+void UDPEndPointImplSockets::SetReceiveBatchSize(size_t aBatchSize)
+{
+    mReceiveBatchSize = std::min<size_t>(std::max<size_t>(aBatchSize, 1), INET_CONFIG_UDP_SOCKET_RECV_BATCH_SIZE);
+
+    // Release the receive buffers that are no longer used; the single-datagram path allocates its own.
+    for (size_t i = (mReceiveBatchSize > 1) ? mReceiveBatchSize : 0; i < INET_CONFIG_UDP_SOCKET_RECV_BATCH_SIZE; i++)
+    {
+        mReceiveBuffers[i] = nullptr;
+    }
+}
+
+void UDPEndPointImplSockets::HandlePendingReadBatch()
+{
+    struct iovec msgIOVs[INET_CONFIG_UDP_SOCKET_RECV_BATCH_SIZE];
+    SockAddr lPeerSockAddrs[INET_CONFIG_UDP_SOCKET_RECV_BATCH_SIZE];
+    uint8_t controlData[INET_CONFIG_UDP_SOCKET_RECV_BATCH_SIZE][256];
+    struct mmsghdr msgHeaders[INET_CONFIG_UDP_SOCKET_RECV_BATCH_SIZE];
+
+    // Refill the slots whose buffers were dispatched by the previous read. Receiving stops at the first slot that cannot
+    // be refilled, so the datagrams read always land in slots 0 to lNumSlots - 1.
+    size_t lNumSlots = 0;
+    for (; lNumSlots < mReceiveBatchSize; lNumSlots++)
+    {
+        System::PacketBufferHandle & lBuffer = mReceiveBuffers[lNumSlots];
+        if (lBuffer.IsNull())
+        {
+            lBuffer = System::PacketBufferHandle::New(System::PacketBuffer::kMaxSizeWithoutReserve, 0);
+            if (lBuffer.IsNull())
+            {
+                break;
+            }
+        }
+
+        msgIOVs[lNumSlots].iov_base = lBuffer->Start();
+        msgIOVs[lNumSlots].iov_len  = lBuffer->AvailableDataLength();
+
+        memset(&lPeerSockAddrs[lNumSlots], 0, sizeof(lPeerSockAddrs[lNumSlots]));
+
+        struct msghdr & msgHeader = msgHeaders[lNumSlots].msg_hdr;
+        memset(&msgHeader, 0, sizeof(msgHeader));
+
+        msgHeader.msg_name       = &lPeerSockAddrs[lNumSlots];
+        msgHeader.msg_namelen    = sizeof(lPeerSockAddrs[lNumSlots]);
+        msgHeader.msg_iov        = &msgIOVs[lNumSlots];
+        msgHeader.msg_iovlen     = 1;
+        msgHeader.msg_control    = controlData[lNumSlots];
+        msgHeader.msg_controllen = sizeof(controlData[lNumSlots]);
+
+        msgHeaders[lNumSlots].msg_len = 0;
+    }
+
+    if (lNumSlots == 0)
+    {
+        if (OnReceiveError != nullptr)
+        {
+            OnReceiveError(this, CHIP_ERROR_NO_MEMORY, nullptr);
+        }
+        return;
+    }
+
+    const int rcvCount = recvmmsg(mSocket, msgHeaders, static_cast<unsigned int>(lNumSlots), MSG_DONTWAIT, nullptr);
+    if (rcvCount < 0)
+    {
+        const CHIP_ERROR lStatus = CHIP_ERROR_POSIX(errno);
+        if (OnReceiveError != nullptr && lStatus != CHIP_ERROR_POSIX(EAGAIN))
+        {
+            OnReceiveError(this, lStatus, nullptr);
+        }
+        return;
+    }
+
+    // A callback may close or free the endpoint; hold a reference until the batch is done, and stop dispatching once the
+    // endpoint is no longer listening.
+    Retain();
+    for (int i = 0; i < rcvCount && mState == State::kListening && OnMessageReceived != nullptr; i++)
+    {
+        IPPacketInfo lPacketInfo;
+        lPacketInfo.Clear();
+        lPacketInfo.DestPort = mBoundPort;
+
+        CHIP_ERROR lStatus = CHIP_NO_ERROR;
+        if (msgHeaders[i].msg_hdr.msg_flags & MSG_TRUNC)
+        {
+            lStatus = CHIP_ERROR_INBOUND_MESSAGE_TOO_BIG;
+        }
+        else
+        {
+            lStatus = GetReceivedPacketInfo(msgHeaders[i].msg_hdr, lPacketInfo);
+        }
+
+        if (lStatus == CHIP_NO_ERROR)
+        {
+            System::PacketBufferHandle lBuffer = std::move(mReceiveBuffers[i]);
+            lBuffer->SetDataLength(static_cast<uint16_t>(msgHeaders[i].msg_len));
+            lBuffer.RightSize();
+            OnMessageReceived(this, std::move(lBuffer), &lPacketInfo);
+        }
+        else if (OnReceiveError != nullptr)
+        {
+            // The buffer is left in its slot, still empty, for the next read.
+            OnReceiveError(this, lStatus, nullptr);
+        }
+    }
+    Release();
+}
+#endif // INET_CONFIG_UDP_SOCKET_MMSG && INET_CONFIG_UDP_SOCKET_RECV_BATCH_SIZE > 1
+
 #if IP_MULTICAST_LOOP || IPV6_MULTICAST_LOOP
 static CHIP_ERROR SocketsSetMulticastLoopback(int aSocket, bool aLoopback, int aProtocol, int aOption)
 {
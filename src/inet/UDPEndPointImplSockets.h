@@ -46,6 +46,14 @@ public:
     uint16_t GetBoundPort() const override;
     void Free() override;
 
+#if INET_CONFIG_UDP_SOCKET_MMSG && INET_CONFIG_UDP_SOCKET_RECV_BATCH_SIZE > 1
+    /**
+     * Set the maximum number of datagrams read with one system call when the socket is readable, from 1 (one recvmsg()
+     * per datagram) up to INET_CONFIG_UDP_SOCKET_RECV_BATCH_SIZE, which is the default.
+     */
+    void SetReceiveBatchSize(size_t aBatchSize);
+#endif // INET_CONFIG_UDP_SOCKET_MMSG && INET_CONFIG_UDP_SOCKET_RECV_BATCH_SIZE > 1
+
 private:
     // UDPEndPoint overrides.
 #if INET_CONFIG_ENABLE_IPV4
@@ -56,8 +64,14 @@ private:
     CHIP_ERROR BindInterfaceImpl(IPAddressType addressType, InterfaceId interfaceId) override;
     CHIP_ERROR ListenImpl() override;
     CHIP_ERROR SendMsgImpl(const IPPacketInfo * pktInfo, chip::System::PacketBufferHandle && msg) override;
+#if INET_CONFIG_UDP_SOCKET_MMSG
+    CHIP_ERROR SendMsgToAllImpl(const IPPacketInfo * pktInfos, size_t count, chip::System::PacketBufferHandle && msg) override;
+#endif // INET_CONFIG_UDP_SOCKET_MMSG
     void CloseImpl() override;
 
+    struct OutgoingMsg;
+    CHIP_ERROR PrepareOutgoingMsg(const IPPacketInfo * aPktInfo, struct iovec * aIOV, OutgoingMsg & aMsg);
+
     CHIP_ERROR GetSocket(IPAddressType addressType);
     void HandlePendingIO(System::SocketEvents events);
     static void HandlePendingIO(System::SocketEvents events, intptr_t data);
@@ -65,6 +79,14 @@ private:
     InterfaceId mBoundIntfId;
     uint16_t mBoundPort;
 
+#if INET_CONFIG_UDP_SOCKET_MMSG && INET_CONFIG_UDP_SOCKET_RECV_BATCH_SIZE > 1
+    void HandlePendingReadBatch();
+
+    // Buffers ready to receive into; a slot is refilled on the next read after its datagram has been dispatched.
+    System::PacketBufferHandle mReceiveBuffers[INET_CONFIG_UDP_SOCKET_RECV_BATCH_SIZE];
+    size_t mReceiveBatchSize = INET_CONFIG_UDP_SOCKET_RECV_BATCH_SIZE;
+#endif // INET_CONFIG_UDP_SOCKET_MMSG && INET_CONFIG_UDP_SOCKET_RECV_BATCH_SIZE > 1
+
 #if CHIP_SYSTEM_CONFIG_USE_DISPATCH
     dispatch_source_t mReadableSource = nullptr;
 #endif // CHIP_SYSTEM_CONFIG_USE_DISPATCH
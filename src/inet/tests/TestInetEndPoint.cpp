@@ -353,6 +353,98 @@ static void TestInetEndPointInternal(nlTestSuite * inSuite, void * inContext)
     NL_TEST_ASSERT(inSuite, SYSTEM_STATS_TEST_HIGH_WATER_MARK(System::Stats::kInetLayer_NumTCPEps, 1));
 }
 
+#if INET_CONFIG_ENABLE_UDP_ENDPOINT && INET_CONFIG_UDP_SOCKET_MMSG && INET_CONFIG_UDP_SOCKET_RECV_BATCH_SIZE > 1
+static void HandleBenchmarkMessage(UDPEndPoint * endPoint, PacketBufferHandle && msg, const IPPacketInfo * pktInfo)
+{
+    ++*static_cast<size_t *>(endPoint->mAppState);
+}
+
+/**
+ * Send bursts of datagrams over loopback and report the packet rate of each path: one recvmsg() per datagram with one
+ * SendMsg() per destination, then recvmmsg() batches with SendMsgToAll().
+ */
+static void TestInetUDPBatchBenchmark(nlTestSuite * inSuite, void * inContext)
+{
+    constexpr size_t kBurstSize     = 64;
+    constexpr size_t kNumBursts     = 200;
+    constexpr uint16_t kPayloadSize = 100;
+
+    UDPEndPoint * receiver = nullptr;
+    UDPEndPoint * sender   = nullptr;
+    size_t received        = 0;
+    IPAddress loopback;
+    IPPacketInfo destinations[kBurstSize];
+    uint8_t payload[kPayloadSize] = { 0 };
+
+#if INET_CONFIG_ENABLE_IPV4
+    const IPAddressType addressType = IPAddressType::kIPv4;
+    NL_TEST_ASSERT(inSuite, IPAddress::FromString("127.0.0.1", loopback));
+#else
+    const IPAddressType addressType = IPAddressType::kIPv6;
+    NL_TEST_ASSERT(inSuite, IPAddress::FromString("::1", loopback));
+#endif // INET_CONFIG_ENABLE_IPV4
+
+    NL_TEST_ASSERT(inSuite, gUDP.NewEndPoint(&receiver) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, gUDP.NewEndPoint(&sender) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, receiver->Bind(addressType, loopback, 0) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, receiver->Listen(HandleBenchmarkMessage, nullptr, &received) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, sender->Bind(addressType, loopback, 0) == CHIP_NO_ERROR);
+
+    for (IPPacketInfo & destination : destinations)
+    {
+        destination.Clear();
+        destination.DestAddress = loopback;
+        destination.DestPort    = receiver->GetBoundPort();
+    }
+
+    static constexpr size_t kReceiveBatchSizes[] = { 1, INET_CONFIG_UDP_SOCKET_RECV_BATCH_SIZE };
+    for (size_t batchSize : kReceiveBatchSizes)
+    {
+        static_cast<UDPEndPointImpl *>(receiver)->SetReceiveBatchSize(batchSize);
+        received = 0;
+
+        uint64_t sendMicros    = 0;
+        uint64_t receiveMicros = 0;
+        for (size_t burst = 0; burst < kNumBursts; burst++)
+        {
+            auto start = SystemClock().GetMonotonicMicroseconds64();
+            if (batchSize == 1)
+            {
+                for (const IPPacketInfo & destination : destinations)
+                {
+                    sender->SendMsg(&destination, PacketBufferHandle::NewWithData(payload, sizeof(payload)));
+                }
+            }
+            else
+            {
+                sender->SendMsgToAll(destinations, kBurstSize, PacketBufferHandle::NewWithData(payload, sizeof(payload)));
+            }
+            auto sent = SystemClock().GetMonotonicMicroseconds64();
+
+            // Loopback does not drop datagrams while the receive buffer has room for the whole burst.
+            const size_t expected = (burst + 1) * kBurstSize;
+            for (int pass = 0; pass < 1000 && received < expected; pass++)
+            {
+                ServiceEvents(10);
+            }
+            auto done = SystemClock().GetMonotonicMicroseconds64();
+
+            sendMicros += (sent - start).count();
+            receiveMicros += (done - sent).count();
+        }
+
+        const size_t total = kNumBursts * kBurstSize;
+        NL_TEST_ASSERT(inSuite, received == total);
+        printf("    UDP receive batch %u: sent %.0f packets/s, received %.0f packets/s\n", static_cast<unsigned>(batchSize),
+               static_cast<double>(total) * 1e6 / static_cast<double>(sendMicros ? sendMicros : 1),
+               static_cast<double>(total) * 1e6 / static_cast<double>(receiveMicros ? receiveMicros : 1));
+    }
+
+    receiver->Free();
+    sender->Free();
+}
+#endif // INET_CONFIG_ENABLE_UDP_ENDPOINT && INET_CONFIG_UDP_SOCKET_MMSG && INET_CONFIG_UDP_SOCKET_RECV_BATCH_SIZE > 1
+
 #if !CHIP_SYSTEM_CONFIG_POOL_USE_HEAP
 // Test the Inet resource limitations.
 static void TestInetEndPointLimit(nlTestSuite * inSuite, void * inContext)
@@ -444,6 +536,9 @@ static const nlTest sTests[] = { NL_TEST_DEF("InetEndPoint::PreTest", TestInetPr
                                  NL_TEST_DEF("InetEndPoint::TestInetError", TestInetError),
                                  NL_TEST_DEF("InetEndPoint::TestInetInterface", TestInetInterface),
                                  NL_TEST_DEF("InetEndPoint::TestInetEndPoint", TestInetEndPointInternal),
+#if INET_CONFIG_ENABLE_UDP_ENDPOINT && INET_CONFIG_UDP_SOCKET_MMSG && INET_CONFIG_UDP_SOCKET_RECV_BATCH_SIZE > 1
+                                 NL_TEST_DEF("InetEndPoint::TestUDPBatchBenchmark", TestInetUDPBatchBenchmark),
+#endif
 #if !CHIP_SYSTEM_CONFIG_POOL_USE_HEAP
                                  NL_TEST_DEF("InetEndPoint::TestEndPointLimit", TestInetEndPointLimit),
 #endif
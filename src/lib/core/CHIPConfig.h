@@ -885,6 +885,48 @@
 #define CHIP_CONFIG_SHA256_CONTEXT_SIZE ((sizeof(unsigned int) * (8 + 2 + 16 + 2)) + sizeof(uint64_t))
 #endif // CHIP_CONFIG_SHA256_CONTEXT_SIZE
 
+/**
+ *  @def CHIP_CONFIG_AES_CCM_CONTEXT_SIZE
+ *
+ *  @brief
+ *    Size of the statically allocated context for keyed AES-CCM operations in the
+ *    mbedTLS implementation of CryptoPAL
+ *
+ *    The default size fits the mbedtls_ccm_context of mbedTLS 2.x, which only wraps
+ *    an mbedtls_cipher_context_t: seven pointer-sized members, two ints, and the
+ *    16-byte IV and unprocessed data buffers, plus one more pointer-sized member
+ *    for optional fields such as the PSA flag. The AES key schedule itself is
+ *    allocated on the heap by mbedTLS. Targets with a larger context, such as
+ *    mbedTLS 3.x or an alternative CCM implementation, must raise this; a static
+ *    assert will tell us if it is too small.
+ *
+ *    The OpenSSL implementation only keeps two pointers to its cipher contexts and
+ *    sizes its storage for those regardless of this setting.
+ *
+ */
+#ifndef CHIP_CONFIG_AES_CCM_CONTEXT_SIZE
+#define CHIP_CONFIG_AES_CCM_CONTEXT_SIZE ((sizeof(void *) * 8) + (sizeof(int) * 2) + (16 * 2))
+#endif // CHIP_CONFIG_AES_CCM_CONTEXT_SIZE
+
+/**
+ *  @def CHIP_CONFIG_SECURE_SESSION_KEYED_CIPHERS
+ *
+ *  @brief
+ *    Enable (1) or disable (0) keeping one keyed AES-CCM cipher per direction in
+ *    each secure session.
+ *
+ *    When enabled, the session keys are expanded once when the session is
+ *    established, instead of for every message sent or received. This costs two
+ *    Crypto::AES_CCM_context objects per session in the secure session pool and,
+ *    with mbedTLS, two heap-allocated AES key schedules per session. It is
+ *    therefore disabled by default and enabled by platforms where that memory is
+ *    cheap compared to the time spent re-keying.
+ *
+ */
+#ifndef CHIP_CONFIG_SECURE_SESSION_KEYED_CIPHERS
+#define CHIP_CONFIG_SECURE_SESSION_KEYED_CIPHERS 0
+#endif // CHIP_CONFIG_SECURE_SESSION_KEYED_CIPHERS
+
 /**
  *  @name chip key export protocol configuration.
  *
@@ -2326,6 +2368,17 @@
 #define CHIP_CONFIG_PEER_CONNECTION_POOL_SIZE 16
 #endif // CHIP_CONFIG_PEER_CONNECTION_POOL_SIZE
 
+/**
+ * @def CHIP_CONFIG_SESSION_ID_RECYCLE_QUEUE_SIZE
+ *
+ * @brief Define the number of freed session IDs that the session ID
+ * allocator keeps to hand out again. Session IDs freed while the
+ * queue is full are not reused.
+ */
+#ifndef CHIP_CONFIG_SESSION_ID_RECYCLE_QUEUE_SIZE
+#define CHIP_CONFIG_SESSION_ID_RECYCLE_QUEUE_SIZE CHIP_CONFIG_PEER_CONNECTION_POOL_SIZE
+#endif // CHIP_CONFIG_SESSION_ID_RECYCLE_QUEUE_SIZE
+
 /**
  * @def CHIP_PEER_CONNECTION_TIMEOUT_MS
  *
@@ -2423,6 +2476,21 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #ifndef CHIP_CONFIG_MDNS_CACHE_SIZE
 #define CHIP_CONFIG_MDNS_CACHE_SIZE 20
 #endif
+
+/**
+ * @def CHIP_CONFIG_MINMDNS_RECORD_CACHE_SIZE
+ *
+ * @brief
+ *      Define the number of operational nodes whose mDNS records the minimal mDNS resolver caches
+ *
+ *      The cache makes room once it is three quarters full, so a controller should set this above
+ *      the number of nodes it keeps talking to. If CHIP_CONFIG_MINMDNS_RECORD_CACHE_SIZE is 0, no
+ *      records are cached.
+ *
+ */
+#ifndef CHIP_CONFIG_MINMDNS_RECORD_CACHE_SIZE
+#define CHIP_CONFIG_MINMDNS_RECORD_CACHE_SIZE 64
+#endif
 /**
  *  @name Interaction Model object pool configuration.
  *
@@ -2435,6 +2503,8 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
  *      * #CHIP_IM_MAX_REPORTS_IN_FLIGHT
  *      * #CHIP_IM_SERVER_MAX_NUM_PATH_GROUPS
  *      * #CHIP_IM_SERVER_MAX_NUM_DIRTY_SET
+ *      * #CHIP_IM_SERVER_REPORT_CACHE_SIZE
+ *      * #CHIP_IM_SERVER_REPORT_CACHE_ENTRIES
  *      * #CHIP_IM_MAX_NUM_WRITE_HANDLER
  *      * #CHIP_IM_MAX_NUM_WRITE_CLIENT
  *      * #CHIP_IM_MAX_NUM_TIMED_HANDLER
@@ -2487,6 +2557,29 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #define CHIP_IM_SERVER_MAX_NUM_PATH_GROUPS 8
 #endif
 
+/**
+ * @def CHIP_IM_SERVER_MAX_NUM_DATA_VERSION_FILTERS_PER_HANDLER
+ *
+ * @brief Defines the maximum number of data version filters held for a single read or subscribe request, so that one request
+ *        cannot take the filters of the others.  Filters beyond this are dropped, which only costs the full report of their
+ *        clusters.
+ */
+#ifndef CHIP_IM_SERVER_MAX_NUM_DATA_VERSION_FILTERS_PER_HANDLER
+#define CHIP_IM_SERVER_MAX_NUM_DATA_VERSION_FILTERS_PER_HANDLER 8
+#endif
+
+/**
+ * @def CHIP_IM_SERVER_MAX_NUM_DATA_VERSION_FILTERS
+ *
+ * @brief Defines the maximum number of data version filters held across all read and subscribe requests.  By default every read
+ *        handler can hold #CHIP_IM_SERVER_MAX_NUM_DATA_VERSION_FILTERS_PER_HANDLER filters, at a cost of about 40 bytes of RAM
+ *        per filter (1.3 KB with the default 4 read handlers).
+ */
+#ifndef CHIP_IM_SERVER_MAX_NUM_DATA_VERSION_FILTERS
+#define CHIP_IM_SERVER_MAX_NUM_DATA_VERSION_FILTERS                                                                               \
+    (CHIP_IM_MAX_NUM_READ_HANDLER * CHIP_IM_SERVER_MAX_NUM_DATA_VERSION_FILTERS_PER_HANDLER)
+#endif
+
 /**
  * @def CHIP_IM_SERVER_MAX_NUM_DIRTY_SET
  *
@@ -2496,6 +2589,25 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #define CHIP_IM_SERVER_MAX_NUM_DIRTY_SET 8
 #endif
 
+/**
+ * @def CHIP_IM_SERVER_REPORT_CACHE_SIZE
+ *
+ * @brief Defines the size in bytes of the buffer in which the reporting engine keeps encoded attribute reports, so that read
+ *        handlers reading the same attribute in one reporting run can share a single encoding.
+ */
+#ifndef CHIP_IM_SERVER_REPORT_CACHE_SIZE
+#define CHIP_IM_SERVER_REPORT_CACHE_SIZE 512
+#endif
+
+/**
+ * @def CHIP_IM_SERVER_REPORT_CACHE_ENTRIES
+ *
+ * @brief Defines the maximum number of encoded attribute reports kept by the reporting engine in one reporting run.
+ */
+#ifndef CHIP_IM_SERVER_REPORT_CACHE_ENTRIES
+#define CHIP_IM_SERVER_REPORT_CACHE_ENTRIES 16
+#endif
+
 /**
  * @def CHIP_IM_MAX_NUM_WRITE_HANDLER
  *
@@ -2741,6 +2853,65 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
     "Please enable at least one of CHIP_CONFIG_EXAMPLE_ACCESS_CONTROL_FAST_COPY_SUPPORT or CHIP_CONFIG_EXAMPLE_ACCESS_CONTROL_FLEXIBLE_COPY_SUPPORT"
 #endif
 
+/**
+ * @def CHIP_CONFIG_ACCESS_CONTROL_CACHE
+ *
+ * Enable (1) or disable (0) the compiled copy of the access control list
+ * that AccessControl::Check uses instead of iterating the delegate's entries,
+ * and its cache of recent decisions.
+ *
+ * The compiled copy is sized for a full access control list and takes several
+ * kilobytes of RAM, so it is disabled by default and enabled by the platforms
+ * that can afford it.
+ */
+#ifndef CHIP_CONFIG_ACCESS_CONTROL_CACHE
+#define CHIP_CONFIG_ACCESS_CONTROL_CACHE 0
+#endif
+
+/**
+ * @def CHIP_CONFIG_ACCESS_CONTROL_CACHE_MAX_ENTRIES
+ *
+ * Defines the number of access control entries the compiled access control
+ * list can hold. Checks fall back to iterating the delegate's entries while
+ * the access control list is larger.
+ */
+#ifndef CHIP_CONFIG_ACCESS_CONTROL_CACHE_MAX_ENTRIES
+#define CHIP_CONFIG_ACCESS_CONTROL_CACHE_MAX_ENTRIES                                                                               \
+    (CHIP_CONFIG_MAX_DEVICE_ADMINS * CHIP_CONFIG_EXAMPLE_ACCESS_CONTROL_MAX_ENTRIES_PER_FABRIC)
+#endif
+
+/**
+ * @def CHIP_CONFIG_ACCESS_CONTROL_CACHE_MAX_SUBJECTS
+ *
+ * Defines the total number of subjects, over all entries, the compiled access
+ * control list can hold. An entry without subjects takes one.
+ */
+#ifndef CHIP_CONFIG_ACCESS_CONTROL_CACHE_MAX_SUBJECTS
+#define CHIP_CONFIG_ACCESS_CONTROL_CACHE_MAX_SUBJECTS                                                                              \
+    (CHIP_CONFIG_ACCESS_CONTROL_CACHE_MAX_ENTRIES * CHIP_CONFIG_EXAMPLE_ACCESS_CONTROL_MAX_SUBJECTS_PER_ENTRY)
+#endif
+
+/**
+ * @def CHIP_CONFIG_ACCESS_CONTROL_CACHE_MAX_TARGETS
+ *
+ * Defines the total number of targets, over all entries, the compiled access
+ * control list can hold.
+ */
+#ifndef CHIP_CONFIG_ACCESS_CONTROL_CACHE_MAX_TARGETS
+#define CHIP_CONFIG_ACCESS_CONTROL_CACHE_MAX_TARGETS                                                                               \
+    (CHIP_CONFIG_ACCESS_CONTROL_CACHE_MAX_ENTRIES * CHIP_CONFIG_EXAMPLE_ACCESS_CONTROL_MAX_TARGETS_PER_ENTRY)
+#endif
+
+/**
+ * @def CHIP_CONFIG_ACCESS_CONTROL_DECISION_CACHE_SIZE
+ *
+ * Defines the number of recent access control decisions, each for a subject,
+ * request path and privilege, kept by AccessControl::Check.
+ */
+#ifndef CHIP_CONFIG_ACCESS_CONTROL_DECISION_CACHE_SIZE
+#define CHIP_CONFIG_ACCESS_CONTROL_DECISION_CACHE_SIZE 16
+#endif
+
 /**
  * @def CHIP_CONFIG_MAX_SESSION_RELEASE_DELEGATES
  *
@@ -2759,6 +2930,43 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #define CHIP_CONFIG_MAX_SESSION_RECOVERY_DELEGATES 4
 #endif
 
+/**
+ * @def CHIP_CONFIG_GROUP_KEY_CACHE_SIZE
+ *
+ * @brief Defines the number of operational group keys kept in RAM for decrypting
+ *        group messages, across all fabrics.
+ *
+ * Each group-key mapping contributes one entry per epoch key of its key set (up to 3).
+ * The default fits every mapping of every fabric: 3 keys for each of the
+ * CHIP_CONFIG_MAX_GROUP_KEYS_PER_FABRIC mappings of each of the CHIP_CONFIG_MAX_DEVICE_ADMINS
+ * fabrics. Keys that do not fit are not cached, and group messages using them are dropped.
+ */
+#ifndef CHIP_CONFIG_GROUP_KEY_CACHE_SIZE
+#define CHIP_CONFIG_GROUP_KEY_CACHE_SIZE (3 * CHIP_CONFIG_MAX_GROUP_KEYS_PER_FABRIC * CHIP_CONFIG_MAX_DEVICE_ADMINS)
+#endif
+
+/**
+ * @def CHIP_CONFIG_GROUP_MESSAGE_DECRYPTION
+ *
+ * @brief Enables decryption of incoming group messages with the operational group keys
+ *        of the server's and the controller's GroupDataProvider.
+ *
+ * Disabled by default until group messages are also encrypted on send (#11911): with it
+ * enabled, the unencrypted group messages sent today are discarded on receive.
+ */
+#ifndef CHIP_CONFIG_GROUP_MESSAGE_DECRYPTION
+#define CHIP_CONFIG_GROUP_MESSAGE_DECRYPTION 0
+#endif
+
+/**
+ * @def CHIP_CONFIG_MAX_GROUP_DATA_PEERS
+ *
+ * @brief Defines the number of group message senders whose message counters are tracked.
+ */
+#ifndef CHIP_CONFIG_MAX_GROUP_DATA_PEERS
+#define CHIP_CONFIG_MAX_GROUP_DATA_PEERS 15
+#endif
+
 /**
  * @def CHIP_CONFIG_CASE_SESSION_RESUME_CACHE_SIZE
  *
@@ -2769,6 +2977,17 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #define CHIP_CONFIG_CASE_SESSION_RESUME_CACHE_SIZE 4
 #endif
 
+/**
+ * @def CHIP_CONFIG_CASE_MAX_CONCURRENT_HANDSHAKES
+ *
+ * @brief
+ *   Default maximum number of CASE handshakes that a CASESessionManager runs at once.  Further handshakes wait for
+ *   one of those to complete.  0 means no limit.
+ */
+#ifndef CHIP_CONFIG_CASE_MAX_CONCURRENT_HANDSHAKES
+#define CHIP_CONFIG_CASE_MAX_CONCURRENT_HANDSHAKES 0
+#endif
+
 /**
  * @def CHIP_CONFIG_EVENT_LOGGING_BYTE_THRESHOLD
  *
@@ -78,3 +78,17 @@
 #ifndef CHIP_CONFIG_EVENT_LOGGING_EXTERNAL_EVENT_SUPPORT
 #define CHIP_CONFIG_EVENT_LOGGING_EXTERNAL_EVENT_SUPPORT 0
 #endif
+
+/**
+ * @def CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE
+ *
+ * @brief
+ *   The number of entries in the sparse index from event number to
+ *   position kept by each event buffer.  Fetching the events since a
+ *   given event number starts decoding at the closest indexed event
+ *   instead of at the oldest event in the buffer.  Each entry costs
+ *   16 bytes per buffer; must be at least 1.
+ */
+#ifndef CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE
+#define CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE 8
+#endif
@@ -2156,6 +2156,17 @@ public:
      */
     uint32_t GetLengthWritten() const { return mLenWritten; }
 
+    /**
+     * Gets the point in the current output buffer where the writer will write the next byte.
+     *
+     * @note When the writer is backed by a TLVBackingStore, the output buffer may change as the writer
+     * writes, so the bytes between two write points are only contiguous if their distance matches the
+     * difference in GetLengthWritten().
+     *
+     * @return A pointer into the current output buffer that corresponds to the writer's current position.
+     */
+    const uint8_t * GetWritePoint() const { return mWritePoint; }
+
     /**
      * Returns the total remaining number of bytes for current tlv writer
      *
@@ -0,0 +1,174 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "OTAImageHeader.h"
+
+#include <lib/core/CHIPTLV.h>
+#include <lib/support/BufferReader.h>
+#include <lib/support/CodeUtils.h>
+
+#include <string.h>
+
+namespace chip {
+
+namespace {
+
+enum class Tag : uint8_t
+{
+    kVendorId              = 0,
+    kProductId             = 1,
+    kSoftwareVersion       = 2,
+    kSoftwareVersionString = 3,
+    kPayloadSize           = 4,
+    kMinApplicableVersion  = 5,
+    kMaxApplicableVersion  = 6,
+    kReleaseNotesURL       = 7,
+    kImageDigestType       = 8,
+    kImageDigest           = 9,
+};
+
+constexpr TLV::Tag ContextTag(Tag tag)
+{
+    return TLV::ContextTag(to_underlying(tag));
+}
+
+} // namespace
+
+void OTAImageHeaderParser::Init()
+{
+    mState         = State::kFixed;
+    mTotalSize     = 0;
+    mHeaderTlvSize = 0;
+    mBufferOffset  = 0;
+    mBuffer.Free();
+}
+
+void OTAImageHeaderParser::Clear()
+{
+    mState         = State::kNotInitialized;
+    mTotalSize     = 0;
+    mHeaderTlvSize = 0;
+    mBufferOffset  = 0;
+    mBuffer.Free();
+}
+
+CHIP_ERROR OTAImageHeaderParser::AccumulateAndDecode(ByteSpan & buffer, OTAImageHeader & header)
+{
+    if (mState == State::kFixed)
+    {
+        VerifyOrReturnError(Append(buffer, mFixedHeader, kFixedHeaderSize), CHIP_ERROR_BUFFER_TOO_SMALL);
+        ReturnErrorOnFailure(DecodeFixed());
+    }
+
+    if (mState == State::kTLV)
+    {
+        VerifyOrReturnError(Append(buffer, mBuffer.Get(), mHeaderTlvSize), CHIP_ERROR_BUFFER_TOO_SMALL);
+        return DecodeTLV(header);
+    }
+
+    return CHIP_ERROR_INCORRECT_STATE;
+}
+
+bool OTAImageHeaderParser::Append(ByteSpan & buffer, uint8_t * data, size_t size)
+{
+    const size_t numBytes = chip::min(buffer.size(), size - mBufferOffset);
+
+    memcpy(data + mBufferOffset, buffer.data(), numBytes);
+    mBufferOffset += numBytes;
+    buffer = buffer.SubSpan(numBytes);
+
+    return mBufferOffset == size;
+}
+
+CHIP_ERROR OTAImageHeaderParser::DecodeFixed()
+{
+    Encoding::LittleEndian::Reader reader(mFixedHeader, kFixedHeaderSize);
+    uint32_t magic;
+
+    ReturnErrorOnFailure(reader.Read32(&magic).Read64(&mTotalSize).Read32(&mHeaderTlvSize).StatusCode());
+    VerifyOrReturnError(magic == kMagic, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(mHeaderTlvSize > 0 && mHeaderTlvSize <= kMaxHeaderTlvSize, CHIP_ERROR_INVALID_MESSAGE_LENGTH);
+    VerifyOrReturnError(mTotalSize >= kFixedHeaderSize + mHeaderTlvSize, CHIP_ERROR_INVALID_MESSAGE_LENGTH);
+    VerifyOrReturnError(mBuffer.Alloc(mHeaderTlvSize), CHIP_ERROR_NO_MEMORY);
+
+    mState        = State::kTLV;
+    mBufferOffset = 0;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR OTAImageHeaderParser::DecodeTLV(OTAImageHeader & header)
+{
+    TLV::TLVReader tlvReader;
+    TLV::TLVType outerType;
+    uint8_t digestType;
+
+    tlvReader.Init(mBuffer.Get(), mHeaderTlvSize);
+    ReturnErrorOnFailure(tlvReader.Next(TLV::kTLVType_Structure, TLV::AnonymousTag()));
+    ReturnErrorOnFailure(tlvReader.EnterContainer(outerType));
+
+    ReturnErrorOnFailure(tlvReader.Next(ContextTag(Tag::kVendorId)));
+    ReturnErrorOnFailure(tlvReader.Get(header.mVendorId));
+    ReturnErrorOnFailure(tlvReader.Next(ContextTag(Tag::kProductId)));
+    ReturnErrorOnFailure(tlvReader.Get(header.mProductId));
+    ReturnErrorOnFailure(tlvReader.Next(ContextTag(Tag::kSoftwareVersion)));
+    ReturnErrorOnFailure(tlvReader.Get(header.mSoftwareVersion));
+    ReturnErrorOnFailure(tlvReader.Next(ContextTag(Tag::kSoftwareVersionString)));
+    ReturnErrorOnFailure(tlvReader.Get(header.mSoftwareVersionString));
+    ReturnErrorOnFailure(tlvReader.Next(ContextTag(Tag::kPayloadSize)));
+    ReturnErrorOnFailure(tlvReader.Get(header.mPayloadSize));
+    ReturnErrorOnFailure(tlvReader.Next());
+
+    header.mMinApplicableVersion.ClearValue();
+    header.mMaxApplicableVersion.ClearValue();
+    header.mReleaseNotesURL = CharSpan();
+
+    if (tlvReader.GetTag() == ContextTag(Tag::kMinApplicableVersion))
+    {
+        uint32_t version;
+        ReturnErrorOnFailure(tlvReader.Get(version));
+        header.mMinApplicableVersion.SetValue(version);
+        ReturnErrorOnFailure(tlvReader.Next());
+    }
+
+    if (tlvReader.GetTag() == ContextTag(Tag::kMaxApplicableVersion))
+    {
+        uint32_t version;
+        ReturnErrorOnFailure(tlvReader.Get(version));
+        header.mMaxApplicableVersion.SetValue(version);
+        ReturnErrorOnFailure(tlvReader.Next());
+    }
+
+    if (tlvReader.GetTag() == ContextTag(Tag::kReleaseNotesURL))
+    {
+        ReturnErrorOnFailure(tlvReader.Get(header.mReleaseNotesURL));
+        ReturnErrorOnFailure(tlvReader.Next());
+    }
+
+    VerifyOrReturnError(tlvReader.GetTag() == ContextTag(Tag::kImageDigestType), CHIP_ERROR_UNEXPECTED_TLV_ELEMENT);
+    ReturnErrorOnFailure(tlvReader.Get(digestType));
+    header.mImageDigestType = static_cast<OTAImageDigestType>(digestType);
+    ReturnErrorOnFailure(tlvReader.Next(ContextTag(Tag::kImageDigest)));
+    ReturnErrorOnFailure(tlvReader.Get(header.mImageDigest));
+    ReturnErrorOnFailure(tlvReader.ExitContainer(outerType));
+
+    VerifyOrReturnError(mTotalSize == kFixedHeaderSize + mHeaderTlvSize + header.mPayloadSize, CHIP_ERROR_INVALID_MESSAGE_LENGTH);
+
+    mState = State::kComplete;
+    return CHIP_NO_ERROR;
+}
+
+} // namespace chip
@@ -0,0 +1,115 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines the header of Matter OTA images, and a parser that decodes it as the image is being downloaded.
+ *
+ */
+
+#pragma once
+
+#include <lib/core/CHIPError.h>
+#include <lib/core/Optional.h>
+#include <lib/support/ScopedBuffer.h>
+#include <lib/support/Span.h>
+
+#include <stdint.h>
+
+namespace chip {
+
+/**
+ * Digest types an OTA image header may carry, as registered by IANA for Named Information hashes.
+ */
+enum class OTAImageDigestType : uint8_t
+{
+    kSha256 = 1,
+};
+
+struct OTAImageHeader
+{
+    uint16_t mVendorId;
+    uint16_t mProductId;
+    uint32_t mSoftwareVersion;
+    CharSpan mSoftwareVersionString;
+    uint64_t mPayloadSize;
+    Optional<uint32_t> mMinApplicableVersion;
+    Optional<uint32_t> mMaxApplicableVersion;
+    CharSpan mReleaseNotesURL;
+    OTAImageDigestType mImageDigestType;
+    ByteSpan mImageDigest;
+};
+
+/**
+ * Decodes the header of an OTA image from the blocks of the image, in the order they are received.
+ *
+ * An OTA image starts with a fixed size prefix (a magic number, the total size of the image and the size of the header TLV),
+ * followed by the header TLV, and then the payload.
+ */
+class OTAImageHeaderParser
+{
+public:
+    static constexpr uint32_t kMagic            = 0x1BEEF11E;
+    static constexpr size_t kFixedHeaderSize    = 16;
+    static constexpr uint32_t kMaxHeaderTlvSize = 1024;
+
+    /**
+     * Prepare the parser for a new image, dropping any header decoded before.
+     */
+    void Init();
+
+    /**
+     * Release the memory held by the parser, which invalidates the spans of the header it decoded.
+     */
+    void Clear();
+
+    bool IsInitialized() const { return mState != State::kNotInitialized; }
+
+    /**
+     * Consume the header bytes at the start of buffer.
+     *
+     * Returns CHIP_ERROR_BUFFER_TOO_SMALL once all of buffer is consumed, and more bytes are needed to decode the header. Once it
+     * is complete, the header is decoded into header, and buffer is left with the first bytes of the payload it held. The spans of
+     * header stay valid until the parser is cleared or initialized again.
+     */
+    CHIP_ERROR AccumulateAndDecode(ByteSpan & buffer, OTAImageHeader & header);
+
+private:
+    enum class State : uint8_t
+    {
+        kNotInitialized,
+        kFixed,
+        kTLV,
+        kComplete,
+    };
+
+    // Move up to the missing bytes of the current part of the header from the start of buffer to the end of data. Returns
+    // whether that part is now complete.
+    bool Append(ByteSpan & buffer, uint8_t * data, size_t size);
+
+    CHIP_ERROR DecodeFixed();
+    CHIP_ERROR DecodeTLV(OTAImageHeader & header);
+
+    State mState            = State::kNotInitialized;
+    uint64_t mTotalSize     = 0;
+    uint32_t mHeaderTlvSize = 0;
+    size_t mBufferOffset    = 0;
+    uint8_t mFixedHeader[kFixedHeaderSize];
+    Platform::ScopedMemoryBuffer<uint8_t> mBuffer;
+};
+
+} // namespace chip
@@ -0,0 +1,224 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a test for the incremental decoding of OTA image headers.
+ *
+ */
+
+#include <lib/core/CHIPEncoding.h>
+#include <lib/core/CHIPTLV.h>
+#include <lib/core/OTAImageHeader.h>
+#include <lib/support/BufferWriter.h>
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/UnitTestRegistration.h>
+
+#include <nlunit-test.h>
+
+#include <string.h>
+
+using namespace chip;
+
+namespace {
+
+constexpr size_t kPayloadSize = 100;
+constexpr uint8_t kDigest[32] = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10,
+                                  0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20 };
+
+// Encode an image header followed by kPayloadSize payload bytes of 0xAA into buffer, and return the size of the image.
+size_t EncodeImage(MutableByteSpan buffer, bool withOptionalFields, uint32_t magic = OTAImageHeaderParser::kMagic)
+{
+    uint8_t tlv[256];
+    TLV::TLVWriter writer;
+    TLV::TLVType outerType;
+
+    writer.Init(tlv);
+    VerifyOrDie(writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, outerType) == CHIP_NO_ERROR);
+    VerifyOrDie(writer.Put(TLV::ContextTag(0), static_cast<uint16_t>(0xFFF1)) == CHIP_NO_ERROR);
+    VerifyOrDie(writer.Put(TLV::ContextTag(1), static_cast<uint16_t>(0x8001)) == CHIP_NO_ERROR);
+    VerifyOrDie(writer.Put(TLV::ContextTag(2), static_cast<uint32_t>(2)) == CHIP_NO_ERROR);
+    VerifyOrDie(writer.PutString(TLV::ContextTag(3), "2.0") == CHIP_NO_ERROR);
+    VerifyOrDie(writer.Put(TLV::ContextTag(4), static_cast<uint64_t>(kPayloadSize)) == CHIP_NO_ERROR);
+    if (withOptionalFields)
+    {
+        VerifyOrDie(writer.Put(TLV::ContextTag(5), static_cast<uint32_t>(1)) == CHIP_NO_ERROR);
+        VerifyOrDie(writer.Put(TLV::ContextTag(6), static_cast<uint32_t>(1)) == CHIP_NO_ERROR);
+        VerifyOrDie(writer.PutString(TLV::ContextTag(7), "https://example.com/notes") == CHIP_NO_ERROR);
+    }
+    VerifyOrDie(writer.Put(TLV::ContextTag(8), static_cast<uint8_t>(OTAImageDigestType::kSha256)) == CHIP_NO_ERROR);
+    VerifyOrDie(writer.Put(TLV::ContextTag(9), ByteSpan(kDigest)) == CHIP_NO_ERROR);
+    VerifyOrDie(writer.EndContainer(outerType) == CHIP_NO_ERROR);
+
+    const uint32_t tlvSize = writer.GetLengthWritten();
+    Encoding::LittleEndian::BufferWriter image(buffer);
+    image.Put32(magic).Put64(OTAImageHeaderParser::kFixedHeaderSize + tlvSize + kPayloadSize).Put32(tlvSize).Put(tlv, tlvSize);
+    for (size_t i = 0; i < kPayloadSize; i++)
+    {
+        image.Put8(0xAA);
+    }
+    VerifyOrDie(image.Fit());
+
+    return image.Needed();
+}
+
+void CheckHeader(nlTestSuite * inSuite, const OTAImageHeader & header, bool withOptionalFields)
+{
+    NL_TEST_ASSERT(inSuite, header.mVendorId == 0xFFF1);
+    NL_TEST_ASSERT(inSuite, header.mProductId == 0x8001);
+    NL_TEST_ASSERT(inSuite, header.mSoftwareVersion == 2);
+    NL_TEST_ASSERT(inSuite, header.mSoftwareVersionString.data_equal(CharSpan("2.0", 3)));
+    NL_TEST_ASSERT(inSuite, header.mPayloadSize == kPayloadSize);
+    NL_TEST_ASSERT(inSuite, header.mMinApplicableVersion.HasValue() == withOptionalFields);
+    NL_TEST_ASSERT(inSuite, header.mMaxApplicableVersion.HasValue() == withOptionalFields);
+    NL_TEST_ASSERT(inSuite, header.mReleaseNotesURL.empty() != withOptionalFields);
+    NL_TEST_ASSERT(inSuite, header.mImageDigestType == OTAImageDigestType::kSha256);
+    NL_TEST_ASSERT(inSuite, header.mImageDigest.data_equal(ByteSpan(kDigest)));
+}
+
+bool IsPayload(ByteSpan buffer)
+{
+    for (uint8_t byte : buffer)
+    {
+        VerifyOrReturnError(byte == 0xAA, false);
+    }
+    return true;
+}
+
+void TestDecodeAtOnce(nlTestSuite * inSuite, void * inContext)
+{
+    for (bool withOptionalFields : { false, true })
+    {
+        uint8_t image[512];
+        ByteSpan buffer(image, EncodeImage(MutableByteSpan(image), withOptionalFields));
+        OTAImageHeaderParser parser;
+        OTAImageHeader header;
+
+        parser.Init();
+        NL_TEST_ASSERT(inSuite, parser.AccumulateAndDecode(buffer, header) == CHIP_NO_ERROR);
+        CheckHeader(inSuite, header, withOptionalFields);
+        NL_TEST_ASSERT(inSuite, buffer.size() == kPayloadSize);
+        NL_TEST_ASSERT(inSuite, IsPayload(buffer));
+
+        // The header is only decoded once.
+        NL_TEST_ASSERT(inSuite, parser.AccumulateAndDecode(buffer, header) == CHIP_ERROR_INCORRECT_STATE);
+        parser.Clear();
+        NL_TEST_ASSERT(inSuite, !parser.IsInitialized());
+    }
+}
+
+void TestDecodeByBlocks(nlTestSuite * inSuite, void * inContext)
+{
+    uint8_t image[512];
+    const size_t imageSize = EncodeImage(MutableByteSpan(image), true);
+
+    for (size_t blockSize : { 1, 7, 16, 64 })
+    {
+        OTAImageHeaderParser parser;
+        OTAImageHeader header;
+        CHIP_ERROR err = CHIP_ERROR_BUFFER_TOO_SMALL;
+        size_t offset  = 0;
+
+        parser.Init();
+        while (err == CHIP_ERROR_BUFFER_TOO_SMALL && offset < imageSize)
+        {
+            ByteSpan block(&image[offset], chip::min(blockSize, imageSize - offset));
+            const size_t blockEnd = offset + block.size();
+
+            // Only the payload bytes of the block are left in it.
+            err = parser.AccumulateAndDecode(block, header);
+            NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR || block.empty());
+            NL_TEST_ASSERT(inSuite, block.size() == blockEnd - chip::min(blockEnd, imageSize - kPayloadSize));
+            NL_TEST_ASSERT(inSuite, IsPayload(block));
+            offset = blockEnd;
+        }
+
+        NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+        CheckHeader(inSuite, header, true);
+    }
+}
+
+void TestDecodeInvalid(nlTestSuite * inSuite, void * inContext)
+{
+    uint8_t image[512];
+    OTAImageHeaderParser parser;
+    OTAImageHeader header;
+
+    ByteSpan buffer(image, EncodeImage(MutableByteSpan(image), false, 0x12345678));
+    parser.Init();
+    NL_TEST_ASSERT(inSuite, parser.AccumulateAndDecode(buffer, header) == CHIP_ERROR_INVALID_ARGUMENT);
+
+    // A header TLV size beyond the limit of the parser.
+    buffer = ByteSpan(image, EncodeImage(MutableByteSpan(image), false));
+    Encoding::LittleEndian::Put32(&image[12], OTAImageHeaderParser::kMaxHeaderTlvSize + 1);
+    parser.Init();
+    NL_TEST_ASSERT(inSuite, parser.AccumulateAndDecode(buffer, header) == CHIP_ERROR_INVALID_MESSAGE_LENGTH);
+
+    // A total size that does not match the payload size of the header.
+    buffer = ByteSpan(image, EncodeImage(MutableByteSpan(image), false));
+    Encoding::LittleEndian::Put64(&image[4], buffer.size() + 1);
+    parser.Init();
+    NL_TEST_ASSERT(inSuite, parser.AccumulateAndDecode(buffer, header) == CHIP_ERROR_INVALID_MESSAGE_LENGTH);
+}
+
+/**
+ *   Test Suite. It lists all the test functions.
+ */
+
+// clang-format off
+static const nlTest sTests[] =
+{
+    NL_TEST_DEF("OTAImageHeaderDecodeAtOnce", TestDecodeAtOnce),
+    NL_TEST_DEF("OTAImageHeaderDecodeByBlocks", TestDecodeByBlocks),
+    NL_TEST_DEF("OTAImageHeaderDecodeInvalid", TestDecodeInvalid),
+
+    NL_TEST_SENTINEL()
+};
+// clang-format on
+
+int TestOTAImageHeader_Setup(void * inContext)
+{
+    return Platform::MemoryInit() == CHIP_NO_ERROR ? SUCCESS : FAILURE;
+}
+
+int TestOTAImageHeader_Teardown(void * inContext)
+{
+    Platform::MemoryShutdown();
+    return SUCCESS;
+}
+
+} // namespace
+
+int TestOTAImageHeader(void)
+{
+    // clang-format off
+    nlTestSuite theSuite =
+    {
+        "OTAImageHeader",
+        &sTests[0],
+        TestOTAImageHeader_Setup,
+        TestOTAImageHeader_Teardown
+    };
+    // clang-format on
+
+    nlTestRunner(&theSuite, nullptr);
+
+    return (nlTestRunnerStats(&theSuite));
+}
+
+CHIP_REGISTER_TEST_SUITE(TestOTAImageHeader)
@@ -0,0 +1,501 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "MdnsRecordCache.h"
+
+#include <algorithm>
+#include <string.h>
+
+#include <lib/dnssd/ServiceNaming.h>
+#include <lib/dnssd/TxtFields.h>
+#include <lib/dnssd/minimal_mdns/Parser.h>
+#include <lib/dnssd/minimal_mdns/RecordData.h>
+#include <lib/dnssd/minimal_mdns/records/ResourceRecord.h>
+#include <lib/support/CHIPMemString.h>
+#include <lib/support/CodeUtils.h>
+
+namespace chip {
+namespace Dnssd {
+namespace {
+
+using namespace mdns::Minimal;
+
+uint32_t HashPeerId(const PeerId & peerId)
+{
+    uint64_t value = peerId.GetNodeId() ^ (peerId.GetCompressedFabricId() * 0x9E3779B97F4A7C15ull);
+    value ^= value >> 33;
+    value *= 0xFF51AFD7ED558CCDull;
+    value ^= value >> 33;
+    return static_cast<uint32_t>(value);
+}
+
+uint32_t HashHostName(const char * hostName)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (; *hostName != '\0'; hostName++)
+    {
+        hash = (hash ^ static_cast<uint8_t>(*hostName)) * 16777619u;
+    }
+    return hash;
+}
+
+System::Clock::Timestamp ExpiryFor(System::Clock::Timestamp now, uint32_t ttlSeconds)
+{
+    // A TTL of zero announces that the record is going away; RFC 6762 section 10.1 has it deleted one second later.
+    return now + System::Clock::Seconds32((ttlSeconds == 0) ? 1 : ttlSeconds);
+}
+
+bool ParseOperationalInstanceName(SerializedQNameIterator name, PeerId & peerId)
+{
+    if (!name.Next() || ExtractIdFromInstanceName(name.Value(), &peerId) != CHIP_NO_ERROR)
+    {
+        return false;
+    }
+    return name.Next() && strcmp(name.Value(), kOperationalServiceName) == 0 && name.Next() &&
+        strcmp(name.Value(), kOperationalProtocol) == 0;
+}
+
+class TxtFieldsDelegate : public TxtRecordDelegate
+{
+public:
+    explicit TxtFieldsDelegate(ResolvedNodeData & nodeData) : mNodeData(nodeData) {}
+    void OnRecord(const BytesRange & name, const BytesRange & value) override
+    {
+        FillNodeDataFromTxt(ByteSpan(name.Start(), name.Size()), ByteSpan(value.Start(), value.Size()), mNodeData);
+    }
+
+private:
+    ResolvedNodeData & mNodeData;
+};
+
+/// A TXT record carrying the data exactly as it was received, used as a known answer.
+class KnownTxtResourceRecord : public ResourceRecord
+{
+public:
+    KnownTxtResourceRecord(const FullQName & qName, const ByteSpan & data) : ResourceRecord(QType::TXT, qName), mData(data) {}
+
+protected:
+    bool WriteData(RecordWriter & out) const override
+    {
+        return out.Put(BytesRange(mData.data(), mData.data() + mData.size())).Fit();
+    }
+
+private:
+    ByteSpan mData;
+};
+
+class RecordCacheUpdater : public ParserDelegate
+{
+public:
+    enum class Pass
+    {
+        kServices,
+        kAddresses,
+    };
+
+    RecordCacheUpdater(MdnsRecordCache & cache, const BytesRange & packet, Inet::InterfaceId interfaceId, Pass pass) :
+        mCache(cache), mPacket(packet), mInterfaceId(interfaceId), mPass(pass)
+    {}
+
+    bool IsResponse() const { return mIsResponse; }
+
+    // ParserDelegate implementation
+
+    void OnHeader(ConstHeaderRef & header) override { mIsResponse = header.GetFlags().IsResponse(); }
+    void OnQuery(const QueryData & data) override {}
+    void OnResource(ResourceType type, const ResourceData & data) override;
+
+private:
+    MdnsRecordCache & mCache;
+    BytesRange mPacket;
+    Inet::InterfaceId mInterfaceId;
+    Pass mPass;
+    bool mIsResponse = false;
+};
+
+void RecordCacheUpdater::OnResource(ResourceType type, const ResourceData & data)
+{
+    VerifyOrReturn(mIsResponse);
+
+    const uint32_t ttl = static_cast<uint32_t>(data.GetTtlSeconds());
+    PeerId peerId;
+
+    switch (data.GetType())
+    {
+    case QType::SRV: {
+        SrvRecord srv;
+        if (mPass == Pass::kServices && ParseOperationalInstanceName(data.GetName(), peerId) &&
+            srv.Parse(data.GetData(), mPacket))
+        {
+            // Host name is the first part of the qname
+            SerializedQNameIterator hostName = srv.GetName();
+            if (hostName.Next())
+            {
+                mCache.AddService(peerId, hostName.Value(), srv.GetPort(), ttl);
+            }
+        }
+        break;
+    }
+    case QType::TXT:
+        if (mPass == Pass::kServices && ParseOperationalInstanceName(data.GetName(), peerId))
+        {
+            mCache.AddServiceTxt(peerId, ByteSpan(data.GetData().Start(), data.GetData().Size()), ttl);
+        }
+        break;
+    case QType::A:
+    case QType::AAAA: {
+        Inet::IPAddress address;
+        SerializedQNameIterator hostName = data.GetName();
+        if (mPass == Pass::kAddresses && hostName.Next() &&
+            ((data.GetType() == QType::A) ? ParseARecord(data.GetData(), &address)
+                                           : ParseAAAARecord(data.GetData(), &address)))
+        {
+            mCache.AddHostAddress(hostName.Value(), address, mInterfaceId, ttl, data.GetClass() == QClass::IN_FLUSH);
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+} // namespace
+
+void MdnsRecordCache::ServiceEntry::Init(const PeerId & peerId)
+{
+    mPeerId        = peerId;
+    mHostName[0]   = '\0';
+    mPort          = 0;
+    mSrvExpiry     = System::Clock::kZero;
+    mTxtLength     = 0;
+    mTxtTtlSeconds = 0;
+    mTxtExpiry     = System::Clock::kZero;
+}
+
+System::Clock::Timestamp MdnsRecordCache::ServiceEntry::LatestExpiry() const
+{
+    return std::max(mSrvExpiry, mTxtExpiry);
+}
+
+void MdnsRecordCache::HostEntry::Init(const char * hostName)
+{
+    Platform::CopyString(mHostName, hostName);
+    for (Address & address : mAddresses)
+    {
+        address.mExpiry = System::Clock::kZero;
+    }
+    mReferencedUntil = System::Clock::kZero;
+}
+
+bool MdnsRecordCache::HostEntry::Matches(const char * hostName) const
+{
+    return strcmp(mHostName, hostName) == 0;
+}
+
+System::Clock::Timestamp MdnsRecordCache::HostEntry::LatestExpiry() const
+{
+    System::Clock::Timestamp latest = mReferencedUntil;
+    for (const Address & address : mAddresses)
+    {
+        latest = std::max(latest, address.mExpiry);
+    }
+    return latest;
+}
+
+template <typename Entry>
+template <typename Key>
+Entry * MdnsRecordCache::Table<Entry>::Find(const Key & key, uint32_t hash)
+{
+    if (mCapacity == 0)
+    {
+        return nullptr;
+    }
+
+    size_t index = hash % mCapacity;
+    for (size_t probes = 0; probes < mCapacity && mEntries[index].mInUse; probes++, index = Next(index))
+    {
+        if (mEntries[index].mHash == hash && mEntries[index].Matches(key))
+        {
+            return &mEntries[index];
+        }
+    }
+    return nullptr;
+}
+
+template <typename Entry>
+template <typename Key>
+Entry * MdnsRecordCache::Table<Entry>::FindOrAdd(const Key & key, uint32_t hash, System::Clock::Timestamp now)
+{
+    Entry * entry = Find(key, hash);
+    if (entry != nullptr || mCapacity == 0)
+    {
+        return entry;
+    }
+
+    // Keeping a quarter of the slots free keeps probe sequences short, and guarantees the probe below ends.
+    if (mCount >= mCapacity - mCapacity / 4)
+    {
+        MakeRoom(now);
+    }
+
+    size_t index = hash % mCapacity;
+    while (mEntries[index].mInUse)
+    {
+        index = Next(index);
+    }
+
+    entry = &mEntries[index];
+    entry->Init(key);
+    entry->mHash  = hash;
+    entry->mInUse = true;
+    mCount++;
+    return entry;
+}
+
+template <typename Entry>
+void MdnsRecordCache::Table<Entry>::Remove(Entry * entry)
+{
+    size_t hole = static_cast<size_t>(entry - mEntries);
+    mEntries[hole].mInUse = false;
+    mCount--;
+
+    // Shift back the entries of the probe sequence that follows, so that lookups do not stop at the hole.
+    for (size_t index = Next(hole); mEntries[index].mInUse; index = Next(index))
+    {
+        size_t home        = mEntries[index].mHash % mCapacity;
+        bool homeAfterHole = (hole <= index) ? (hole < home && home <= index) : (hole < home || home <= index);
+        if (!homeAfterHole)
+        {
+            mEntries[hole]         = mEntries[index];
+            mEntries[index].mInUse = false;
+            hole                   = index;
+        }
+    }
+}
+
+template <typename Entry>
+void MdnsRecordCache::Table<Entry>::Clear()
+{
+    for (size_t i = 0; i < mCapacity; i++)
+    {
+        mEntries[i].mInUse = false;
+    }
+    mCount = 0;
+}
+
+template <typename Entry>
+void MdnsRecordCache::Table<Entry>::MakeRoom(System::Clock::Timestamp now)
+{
+    size_t index = 0;
+    while (index < mCapacity)
+    {
+        // Removal may move another entry into this slot, so look at it again.
+        if (mEntries[index].mInUse && mEntries[index].LatestExpiry() <= now)
+        {
+            Remove(&mEntries[index]);
+            continue;
+        }
+        index++;
+    }
+
+    if (mCount < mCapacity - mCapacity / 4)
+    {
+        return;
+    }
+
+    Entry * oldest = nullptr;
+    for (size_t i = 0; i < mCapacity; i++)
+    {
+        if (mEntries[i].mInUse && (oldest == nullptr || mEntries[i].LatestExpiry() < oldest->LatestExpiry()))
+        {
+            oldest = &mEntries[i];
+        }
+    }
+    Remove(oldest);
+}
+
+void MdnsRecordCache::OnPacket(const BytesRange & packet, Inet::InterfaceId interfaceId)
+{
+    // Addresses are only kept for hosts of cached services, so take in the SRV records first: a response may list
+    // address records before the SRV record that points at them.
+    RecordCacheUpdater services(*this, packet, interfaceId, RecordCacheUpdater::Pass::kServices);
+    if (!ParsePacket(packet, &services) || !services.IsResponse())
+    {
+        return;
+    }
+
+    RecordCacheUpdater addresses(*this, packet, interfaceId, RecordCacheUpdater::Pass::kAddresses);
+    ParsePacket(packet, &addresses);
+}
+
+void MdnsRecordCache::AddService(const PeerId & peerId, const char * hostName, uint16_t port, uint32_t ttlSeconds)
+{
+    VerifyOrReturn(strlen(hostName) <= kHostNameMaxLength);
+
+    const System::Clock::Timestamp now = System::SystemClock().GetMonotonicTimestamp();
+    ServiceEntry * service             = mServices.FindOrAdd(peerId, HashPeerId(peerId), now);
+    VerifyOrReturn(service != nullptr);
+
+    Platform::CopyString(service->mHostName, hostName);
+    service->mPort      = port;
+    service->mSrvExpiry = ExpiryFor(now, ttlSeconds);
+
+    HostEntry * host = mHosts.FindOrAdd(hostName, HashHostName(hostName), now);
+    VerifyOrReturn(host != nullptr);
+    host->mReferencedUntil = std::max(host->mReferencedUntil, service->mSrvExpiry);
+}
+
+void MdnsRecordCache::AddServiceTxt(const PeerId & peerId, const ByteSpan & txtData, uint32_t ttlSeconds)
+{
+    const System::Clock::Timestamp now = System::SystemClock().GetMonotonicTimestamp();
+    ServiceEntry * service             = mServices.FindOrAdd(peerId, HashPeerId(peerId), now);
+    VerifyOrReturn(service != nullptr);
+
+    if (txtData.size() > kMaxTxtDataSize)
+    {
+        service->mTxtLength = 0;
+        service->mTxtExpiry = System::Clock::kZero;
+        return;
+    }
+
+    memcpy(service->mTxtData, txtData.data(), txtData.size());
+    service->mTxtLength     = static_cast<uint8_t>(txtData.size());
+    service->mTxtTtlSeconds = ttlSeconds;
+    service->mTxtExpiry     = ExpiryFor(now, ttlSeconds);
+}
+
+void MdnsRecordCache::AddHostAddress(const char * hostName, const Inet::IPAddress & address, Inet::InterfaceId interfaceId,
+                                     uint32_t ttlSeconds, bool cacheFlush)
+{
+    VerifyOrReturn(strlen(hostName) <= kHostNameMaxLength);
+
+    HostEntry * host = mHosts.Find(hostName, HashHostName(hostName));
+    VerifyOrReturn(host != nullptr);
+
+    const System::Clock::Timestamp now     = System::SystemClock().GetMonotonicTimestamp();
+    const System::Clock::Timestamp flushAt = now + System::Clock::Seconds16(1);
+    HostEntry::Address * slot              = nullptr;
+
+    for (HostEntry::Address & entry : host->mAddresses)
+    {
+        if (entry.mExpiry <= now)
+        {
+            continue;
+        }
+        if (entry.mAddress == address && entry.mInterfaceId == interfaceId)
+        {
+            slot = &entry;
+        }
+        else if (cacheFlush && entry.mReceived + System::Clock::Seconds16(1) < now)
+        {
+            // The record set is being replaced; RFC 6762 section 10.2 has the older records deleted one second later.
+            entry.mExpiry = std::min(entry.mExpiry, flushAt);
+        }
+    }
+
+    if (slot == nullptr)
+    {
+        // Take an expired slot, or failing that the address that expires first.
+        for (HostEntry::Address & entry : host->mAddresses)
+        {
+            if (slot == nullptr || entry.mExpiry < slot->mExpiry)
+            {
+                slot = &entry;
+            }
+        }
+        slot->mAddress     = address;
+        slot->mInterfaceId = interfaceId;
+    }
+    slot->mReceived = now;
+    slot->mExpiry   = ExpiryFor(now, ttlSeconds);
+}
+
+CHIP_ERROR MdnsRecordCache::Lookup(const PeerId & peerId, ResolvedNodeData & nodeData)
+{
+    const System::Clock::Timestamp now = System::SystemClock().GetMonotonicTimestamp();
+
+    ServiceEntry * service = mServices.Find(peerId, HashPeerId(peerId));
+    VerifyOrReturnError(service != nullptr && service->mSrvExpiry > now, CHIP_ERROR_KEY_NOT_FOUND);
+    HostEntry * host = mHosts.Find(service->mHostName, HashHostName(service->mHostName));
+    VerifyOrReturnError(host != nullptr, CHIP_ERROR_KEY_NOT_FOUND);
+
+    nodeData         = ResolvedNodeData();
+    nodeData.mPeerId = peerId;
+    nodeData.mPort   = service->mPort;
+    Platform::CopyString(nodeData.mHostName, service->mHostName);
+    nodeData.mExpiryTime = service->mSrvExpiry;
+
+    // ResolvedNodeData has a single interface, so report the addresses seen on the same interface as the first one.
+    for (const HostEntry::Address & address : host->mAddresses)
+    {
+        if (address.mExpiry <= now || (nodeData.mNumIPs > 0 && !(address.mInterfaceId == nodeData.mInterfaceId)))
+        {
+            continue;
+        }
+        nodeData.mInterfaceId                 = address.mInterfaceId;
+        nodeData.mAddress[nodeData.mNumIPs++] = address.mAddress;
+        nodeData.mExpiryTime                  = std::min(nodeData.mExpiryTime, address.mExpiry);
+    }
+    VerifyOrReturnError(nodeData.mNumIPs > 0, CHIP_ERROR_KEY_NOT_FOUND);
+
+    if (service->mTxtExpiry > now)
+    {
+        TxtFieldsDelegate delegate(nodeData);
+        ParseTxtRecord(BytesRange(service->mTxtData, service->mTxtData + service->mTxtLength), &delegate);
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+void MdnsRecordCache::AddKnownAnswers(const PeerId & peerId, QueryBuilder & builder)
+{
+    const System::Clock::Timestamp now = System::SystemClock().GetMonotonicTimestamp();
+
+    ServiceEntry * service = mServices.Find(peerId, HashPeerId(peerId));
+    VerifyOrReturn(service != nullptr && service->mTxtLength > 0 && service->mTxtExpiry > now);
+
+    const System::Clock::Milliseconds64 remaining = service->mTxtExpiry - now;
+    VerifyOrReturn(remaining * 2 > System::Clock::Seconds32(service->mTxtTtlSeconds));
+
+    char nameBuffer[kMaxOperationalServiceNameSize] = "";
+    VerifyOrReturn(MakeInstanceName(nameBuffer, sizeof(nameBuffer), peerId) == CHIP_NO_ERROR);
+    const QNamePart instanceQName[] = { nameBuffer, kOperationalServiceName, kOperationalProtocol, kLocalDomain };
+
+    // A known answer carries the TTL the querier has left for it.
+    KnownTxtResourceRecord record(instanceQName, ByteSpan(service->mTxtData, service->mTxtLength));
+    record.SetTtl(static_cast<uint32_t>(std::chrono::duration_cast<System::Clock::Seconds32>(remaining).count()));
+    builder.AddAnswer(record);
+}
+
+void MdnsRecordCache::Remove(const PeerId & peerId)
+{
+    ServiceEntry * service = mServices.Find(peerId, HashPeerId(peerId));
+    if (service != nullptr)
+    {
+        mServices.Remove(service);
+    }
+}
+
+void MdnsRecordCache::Clear()
+{
+    mServices.Clear();
+    mHosts.Clear();
+}
+
+} // namespace Dnssd
+} // namespace chip
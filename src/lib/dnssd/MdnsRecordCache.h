@@ -0,0 +1,184 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <inet/IPAddress.h>
+#include <inet/InetInterface.h>
+#include <lib/core/CHIPError.h>
+#include <lib/core/PeerId.h>
+#include <lib/dnssd/Constants.h>
+#include <lib/dnssd/Resolver.h>
+#include <lib/dnssd/minimal_mdns/QueryBuilder.h>
+#include <lib/dnssd/minimal_mdns/core/BytesRange.h>
+#include <lib/support/Span.h>
+#include <system/SystemClock.h>
+
+namespace chip {
+namespace Dnssd {
+
+/**
+ * Cache of the mDNS records that resolve operational nodes: SRV and TXT records indexed by instance (i.e. by PeerId)
+ * and A/AAAA records indexed by host name.
+ *
+ * Every record expires after its own TTL, and a TTL of zero (a "goodbye") removes it one second later as RFC 6762
+ * section 10.1 asks. Address records with the cache-flush bit replace the addresses of the host received earlier.
+ *
+ * Records are taken from every mDNS response seen, not only those answering our own queries, so that nodes announcing
+ * themselves or answering other controllers can later be resolved without sending a query. To keep unrelated traffic
+ * out, addresses are only cached for hosts that a cached operational SRV record points at.
+ *
+ * Both indexes are open-addressed hash tables in storage provided by MdnsRecordCacheWithStorage. Once a table is
+ * three quarters full, expired entries are dropped, or failing that the entry expiring first.
+ */
+class MdnsRecordCache
+{
+public:
+    /// Largest TXT record kept. Operational TXT records (CRI, CRA, T) fit with room to spare.
+    static constexpr size_t kMaxTxtDataSize = 64;
+
+    struct ServiceEntry
+    {
+        PeerId mPeerId;
+        char mHostName[kHostNameMaxLength + 1];
+        uint16_t mPort;
+        System::Clock::Timestamp mSrvExpiry;
+        uint8_t mTxtData[kMaxTxtDataSize];
+        uint8_t mTxtLength;
+        uint32_t mTxtTtlSeconds;
+        System::Clock::Timestamp mTxtExpiry;
+
+        uint32_t mHash = 0;
+        bool mInUse    = false;
+
+        void Init(const PeerId & peerId);
+        bool Matches(const PeerId & peerId) const { return mPeerId == peerId; }
+        System::Clock::Timestamp LatestExpiry() const;
+    };
+
+    struct HostEntry
+    {
+        struct Address
+        {
+            Inet::IPAddress mAddress;
+            Inet::InterfaceId mInterfaceId;
+            System::Clock::Timestamp mReceived;
+            System::Clock::Timestamp mExpiry;
+        };
+
+        char mHostName[kHostNameMaxLength + 1];
+        Address mAddresses[ResolvedNodeData::kMaxIPAddresses];
+        // Latest expiry of the SRV records pointing at this host; the entry is kept at least that long.
+        System::Clock::Timestamp mReferencedUntil;
+
+        uint32_t mHash = 0;
+        bool mInUse    = false;
+
+        void Init(const char * hostName);
+        bool Matches(const char * hostName) const;
+        System::Clock::Timestamp LatestExpiry() const;
+    };
+
+    MdnsRecordCache(const MdnsRecordCache &) = delete;
+    MdnsRecordCache & operator=(const MdnsRecordCache &) = delete;
+
+    /// Cache the operational records of a received mDNS response.
+    void OnPacket(const mdns::Minimal::BytesRange & packet, Inet::InterfaceId interfaceId);
+
+    void AddService(const PeerId & peerId, const char * hostName, uint16_t port, uint32_t ttlSeconds);
+    void AddServiceTxt(const PeerId & peerId, const ByteSpan & txtData, uint32_t ttlSeconds);
+    void AddHostAddress(const char * hostName, const Inet::IPAddress & address, Inet::InterfaceId interfaceId,
+                        uint32_t ttlSeconds, bool cacheFlush);
+
+    /**
+     * Resolve peerId from the cache.
+     *
+     * Succeeds only if the SRV record of the node and at least one address of its host are still fresh. TXT fields are
+     * filled in if the TXT record is fresh too. nodeData.mExpiryTime is when the first of the records used expires.
+     */
+    CHIP_ERROR Lookup(const PeerId & peerId, ResolvedNodeData & nodeData);
+
+    /**
+     * Append to a resolve query for peerId the cached records the responder need not send again, i.e. those with more
+     * than half of their TTL left (RFC 6762 section 7.1).
+     *
+     * Only the TXT record qualifies: a resolve query is only sent when the SRV record or the addresses are missing, and
+     * responders send addresses as additional records of the SRV answer, so listing the SRV record would suppress the
+     * addresses being asked for.
+     */
+    void AddKnownAnswers(const PeerId & peerId, mdns::Minimal::QueryBuilder & builder);
+
+    /// Forget what is cached for peerId, e.g. once its cached address turned out to be unreachable.
+    void Remove(const PeerId & peerId);
+    void Clear();
+
+    size_t GetServiceCount() const { return mServices.Count(); }
+    size_t GetHostCount() const { return mHosts.Count(); }
+
+protected:
+    MdnsRecordCache(ServiceEntry * services, HostEntry * hosts, size_t capacity) :
+        mServices(services, capacity), mHosts(hosts, capacity)
+    {}
+
+private:
+    /// Open-addressed hash table with linear probing over caller-provided entries.
+    template <typename Entry>
+    class Table
+    {
+    public:
+        // Entries start out unused; they are only constructed after the table, by MdnsRecordCacheWithStorage.
+        Table(Entry * entries, size_t capacity) : mEntries(entries), mCapacity(capacity) {}
+
+        template <typename Key>
+        Entry * Find(const Key & key, uint32_t hash);
+        /// Find the entry for key, adding it if missing. Returns nullptr only if the table has no capacity.
+        template <typename Key>
+        Entry * FindOrAdd(const Key & key, uint32_t hash, System::Clock::Timestamp now);
+        void Remove(Entry * entry);
+        void Clear();
+        size_t Count() const { return mCount; }
+
+    private:
+        size_t Next(size_t index) const { return (index + 1 == mCapacity) ? 0 : index + 1; }
+        void MakeRoom(System::Clock::Timestamp now);
+
+        Entry * mEntries;
+        size_t mCapacity;
+        size_t mCount = 0;
+    };
+
+    Table<ServiceEntry> mServices;
+    Table<HostEntry> mHosts;
+};
+
+template <size_t kCapacity>
+class MdnsRecordCacheWithStorage : public MdnsRecordCache
+{
+public:
+    MdnsRecordCacheWithStorage() : MdnsRecordCache(mServiceStorage, mHostStorage, kCapacity) {}
+
+private:
+    // A capacity of zero disables the cache.
+    ServiceEntry mServiceStorage[kCapacity > 0 ? kCapacity : 1];
+    HostEntry mHostStorage[kCapacity > 0 ? kCapacity : 1];
+};
+
+} // namespace Dnssd
+} // namespace chip
@@ -15,12 +15,12 @@
  *    limitations under the License.
  */
 
-#include "DnssdCache.h"
 #include "Resolver.h"
 
 #include <limits>
 
 #include <lib/core/CHIPConfig.h>
+#include <lib/dnssd/MdnsRecordCache.h>
 #include <lib/dnssd/MinimalMdnsServer.h>
 #include <lib/dnssd/ResolverProxy.h>
 #include <lib/dnssd/ServiceNaming.h>
@@ -31,6 +31,7 @@
 #include <lib/dnssd/minimal_mdns/RecordData.h>
 #include <lib/dnssd/minimal_mdns/core/FlatAllocatedQName.h>
 #include <lib/support/CHIPMemString.h>
+#include <lib/support/CodeUtils.h>
 #include <lib/support/logging/CHIPLogging.h>
 
 // MDNS servers will receive all broadcast packets over the network.
@@ -65,13 +66,12 @@ constexpr size_t kMdnsMaxPacketSize = 1024;
 constexpr uint16_t kMdnsPort        = 5353;
 
 using namespace mdns::Minimal;
-using DnssdCacheType = Dnssd::DnssdCache<CHIP_CONFIG_MDNS_CACHE_SIZE>;
 
 class PacketDataReporter : public ParserDelegate
 {
 public:
     PacketDataReporter(ResolverDelegate * delegate, chip::Inet::InterfaceId interfaceId, DiscoveryType discoveryType,
-                       const BytesRange & packet, DnssdCacheType & mdnsCache) :
+                       const BytesRange & packet) :
         mDelegate(delegate),
         mDiscoveryType(discoveryType), mPacketRange(packet)
     {
@@ -379,19 +379,23 @@ private:
     }
     static constexpr int kMaxQnameSize = 100;
     char qnameStorage[kMaxQnameSize];
-    // should this be static?
-    // original version had:    static Dnssd::IPCache<CHIP_CONFIG_IPCACHE_SIZE, CHIP_CONFIG_TTL_MS> sIPCache;
-    DnssdCacheType sDnssdCache;
+    MdnsRecordCacheWithStorage<CHIP_CONFIG_MINMDNS_RECORD_CACHE_SIZE> mRecordCache;
+
+    void CompletePendingResolvesFromCache();
 };
 
 void MinMdnsResolver::OnMdnsPacketData(const BytesRange & data, const chip::Inet::IPPacketInfo * info)
 {
+    // Cache every response seen, including announcements and answers to other queriers, so later resolves of
+    // those nodes need no query.
+    mRecordCache.OnPacket(data, info->Interface);
+
     if (mDelegate == nullptr)
     {
         return;
     }
 
-    PacketDataReporter reporter(mDelegate, info->Interface, mDiscoveryType, data, sDnssdCache);
+    PacketDataReporter reporter(mDelegate, info->Interface, mDiscoveryType, data);
 
     if (!ParsePacket(data, &reporter))
     {
@@ -400,10 +404,31 @@ void MinMdnsResolver::OnMdnsPacketData(const BytesRange & data, const chip::Inet
     else
     {
         reporter.OnComplete(mActiveResolves);
+        // A resolve may be answered over several packets, e.g. SRV and addresses sent separately.
+        CompletePendingResolvesFromCache();
         ScheduleResolveRetries();
     }
 }
 
+void MinMdnsResolver::CompletePendingResolvesFromCache()
+{
+    PeerId pending[ActiveResolveAttempts::kRetryQueueSize];
+    size_t pendingCount = mActiveResolves.GetPendingPeers(pending, ArraySize(pending));
+
+    for (size_t i = 0; i < pendingCount; i++)
+    {
+        ResolvedNodeData nodeData;
+        if (mRecordCache.Lookup(pending[i], nodeData) != CHIP_NO_ERROR)
+        {
+            continue;
+        }
+
+        mActiveResolves.Complete(pending[i]);
+        nodeData.LogNodeIdResolved();
+        mDelegate->OnNodeIdResolved(nodeData);
+    }
+}
+
 CHIP_ERROR MinMdnsResolver::Init(chip::Inet::EndPointManager<chip::Inet::UDPEndPoint> * udpEndPointManager)
 {
     /// Note: we do not double-check the port as we assume the APP will always use
@@ -508,6 +533,23 @@ CHIP_ERROR MinMdnsResolver::BrowseNodes(DiscoveryType type, DiscoveryFilter filt
 CHIP_ERROR MinMdnsResolver::ResolveNodeId(const PeerId & peerId, Inet::IPAddressType type, Resolver::CacheBypass dnssdCacheBypass)
 {
     mDiscoveryType = DiscoveryType::kOperational;
+
+    if (dnssdCacheBypass == Resolver::CacheBypass::On)
+    {
+        mRecordCache.Remove(peerId);
+    }
+    else if (mDelegate != nullptr)
+    {
+        ResolvedNodeData nodeData;
+        if (mRecordCache.Lookup(peerId, nodeData) == CHIP_NO_ERROR)
+        {
+            ChipLogProgress(Discovery, "Resolved node from mDNS cache");
+            nodeData.LogNodeIdResolved();
+            mDelegate->OnNodeIdResolved(nodeData);
+            return CHIP_NO_ERROR;
+        }
+    }
+
     mActiveResolves.MarkPending(peerId);
 
     return SendPendingResolveQueries();
@@ -579,6 +621,7 @@ CHIP_ERROR MinMdnsResolver::SendPendingResolveQueries()
             // would be needed to resolve the host name to an IP address
 
             builder.AddQuery(query);
+            mRecordCache.AddKnownAnswers(peerId.Value(), builder);
         }
 
         ReturnErrorCodeIf(!builder.Ok(), CHIP_ERROR_INTERNAL);
@@ -184,5 +184,24 @@ Optional<PeerId> ActiveResolveAttempts::NextScheduledPeer()
     return Optional<PeerId>::Missing();
 }
 
+size_t ActiveResolveAttempts::GetPendingPeers(PeerId * peers, size_t maxCount) const
+{
+    size_t count = 0;
+
+    for (auto & entry : mRetryQueue)
+    {
+        if (count == maxCount)
+        {
+            break;
+        }
+        if (entry.peerId.GetNodeId() != kUndefinedNodeId)
+        {
+            peers[count++] = entry.peerId;
+        }
+    }
+
+    return count;
+}
+
 } // namespace Minimal
 } // namespace mdns
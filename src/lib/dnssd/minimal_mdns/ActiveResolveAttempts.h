@@ -70,6 +70,11 @@ public:
     //    any peer that needs a new request sent
     chip::Optional<chip::PeerId> NextScheduledPeer();
 
+    // Get the peer ids of all pending resolutions
+    //
+    // Fills up to maxCount entries of peers and returns how many were filled.
+    size_t GetPendingPeers(chip::PeerId * peers, size_t maxCount) const;
+
 private:
     struct RetryEntry
     {
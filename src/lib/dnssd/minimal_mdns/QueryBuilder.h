@@ -21,6 +21,7 @@
 
 #include <lib/dnssd/minimal_mdns/Query.h>
 #include <lib/dnssd/minimal_mdns/core/DnsHeader.h>
+#include <lib/dnssd/minimal_mdns/records/ResourceRecord.h>
 
 namespace mdns {
 namespace Minimal {
@@ -81,6 +82,32 @@ public:
         return *this;
     }
 
+    /// Add a known answer (RFC 6762 section 7.1): a record the querier already
+    /// holds, which responders need not send again.
+    ///
+    /// Known answers follow all queries in the packet, so call this only
+    /// after every AddQuery.
+    QueryBuilder & AddAnswer(const ResourceRecord & record)
+    {
+        if (!mQueryBuildOk)
+        {
+            return *this;
+        }
+
+        chip::Encoding::BigEndian::BufferWriter out(mPacket->Start() + mPacket->DataLength(), mPacket->AvailableDataLength());
+        RecordWriter writer(&out);
+
+        if (!record.Append(mHeader, ResourceType::kAnswer, writer))
+        {
+            mQueryBuildOk = false;
+        }
+        else
+        {
+            mPacket->SetDataLength(static_cast<uint16_t>(mPacket->DataLength() + out.Needed()));
+        }
+        return *this;
+    }
+
     bool Ok() const { return mQueryBuildOk; }
 
 private:
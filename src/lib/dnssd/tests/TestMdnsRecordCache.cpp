@@ -0,0 +1,402 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <nlunit-test.h>
+
+#include <inet/IPAddress.h>
+#include <inet/IPPacketInfo.h>
+#include <inet/InetInterface.h>
+#include <lib/core/CHIPError.h>
+#include <lib/core/PeerId.h>
+#include <lib/dnssd/MdnsRecordCache.h>
+#include <lib/dnssd/MinimalMdnsServer.h>
+#include <lib/dnssd/Resolver.h>
+#include <lib/dnssd/ServiceNaming.h>
+#include <lib/dnssd/minimal_mdns/Parser.h>
+#include <lib/dnssd/minimal_mdns/QueryBuilder.h>
+#include <lib/dnssd/minimal_mdns/ResponseBuilder.h>
+#include <lib/dnssd/minimal_mdns/core/FlatAllocatedQName.h>
+#include <lib/dnssd/minimal_mdns/records/IP.h>
+#include <lib/dnssd/minimal_mdns/records/Srv.h>
+#include <lib/dnssd/minimal_mdns/records/Txt.h>
+#include <lib/support/CHIPMem.h>
+#include <lib/support/UnitTestRegistration.h>
+#include <system/SystemPacketBuffer.h>
+#include <system/TimeSource.h>
+
+using namespace chip;
+using namespace chip::Dnssd;
+using namespace mdns::Minimal;
+
+namespace {
+
+System::Clock::Internal::MockClock fakeClock;
+System::Clock::ClockBase * realClock;
+
+constexpr uint64_t kFabric      = 0x1122334455667788;
+constexpr uint32_t kHostTtl     = 120;
+constexpr uint32_t kServiceTtl  = 4500;
+constexpr size_t kMaxPacketSize = 1024;
+
+struct NodeRecords
+{
+    PeerId peerId;
+    char hostName[kHostNameMaxLength + 1];
+    uint16_t port;
+    Inet::IPAddress address;
+    uint32_t srvTtl     = kHostTtl;
+    uint32_t txtTtl     = kServiceTtl;
+    uint32_t addressTtl = kHostTtl;
+    bool cacheFlush     = false;
+    bool withTxt        = true;
+
+    NodeRecords(NodeId nodeId, uint16_t nodePort)
+    {
+        peerId.SetCompressedFabricId(kFabric).SetNodeId(nodeId);
+        snprintf(hostName, sizeof(hostName), "00000000%08X", static_cast<unsigned>(nodeId));
+        port = nodePort;
+        char addressString[Inet::IPAddress::kMaxStringLength];
+        snprintf(addressString, sizeof(addressString), "fd00::%x", static_cast<unsigned>(nodeId & 0xFFFF));
+        Inet::IPAddress::FromString(addressString, address);
+    }
+};
+
+/// Build the response a node sends to a resolve query (or announces on its own).
+System::PacketBufferHandle BuildResponse(const NodeRecords & node)
+{
+    char instanceName[kMaxOperationalServiceNameSize];
+    VerifyOrDie(MakeInstanceName(instanceName, sizeof(instanceName), node.peerId) == CHIP_NO_ERROR);
+
+    const QNamePart instanceQName[] = { instanceName, kOperationalServiceName, kOperationalProtocol, kLocalDomain };
+    const QNamePart hostQName[]     = { node.hostName, kLocalDomain };
+    const char * txtEntries[]       = { "CRI=3000", "CRA=4000", "T=1" };
+
+    SrvResourceRecord srv(instanceQName, hostQName, node.port);
+    srv.SetTtl(node.srvTtl);
+    TxtResourceRecord txt(instanceQName, txtEntries);
+    txt.SetTtl(node.txtTtl);
+    IPResourceRecord aaaa(hostQName, node.address);
+    aaaa.SetTtl(node.addressTtl).SetCacheFlush(node.cacheFlush);
+
+    ResponseBuilder builder(System::PacketBufferHandle::New(kMaxPacketSize));
+    builder.AddRecord(ResourceType::kAnswer, srv);
+    if (node.withTxt)
+    {
+        builder.AddRecord(ResourceType::kAnswer, txt);
+    }
+    builder.AddRecord(ResourceType::kAdditional, aaaa);
+    VerifyOrDie(builder.Ok());
+
+    return builder.ReleasePacket();
+}
+
+void Receive(MdnsRecordCache & cache, const System::PacketBufferHandle & packet)
+{
+    cache.OnPacket(BytesRange(packet->Start(), packet->Start() + packet->DataLength()), Inet::InterfaceId::Null());
+}
+
+/// Build the resolve query for peerId, as the resolver does, and return how many known answers it carries.
+uint16_t BuildResolveQuery(MdnsRecordCache & cache, const PeerId & peerId)
+{
+    char instanceName[kMaxOperationalServiceNameSize];
+    VerifyOrDie(MakeInstanceName(instanceName, sizeof(instanceName), peerId) == CHIP_NO_ERROR);
+    const char * instanceQName[] = { instanceName, kOperationalServiceName, kOperationalProtocol, kLocalDomain };
+
+    QueryBuilder builder(System::PacketBufferHandle::New(kMaxPacketSize));
+    Query query(instanceQName);
+    query.SetClass(QClass::IN).SetType(QType::ANY).SetAnswerViaUnicast(true);
+    builder.AddQuery(query);
+    cache.AddKnownAnswers(peerId, builder);
+    VerifyOrDie(builder.Ok());
+
+    return builder.Header().GetAnswerCount();
+}
+
+void TestResolveFromResponse(nlTestSuite * inSuite, void * inContext)
+{
+    MdnsRecordCacheWithStorage<8> cache;
+    NodeRecords node(0x100, 5540);
+    ResolvedNodeData nodeData;
+
+    NL_TEST_ASSERT(inSuite, cache.Lookup(node.peerId, nodeData) == CHIP_ERROR_KEY_NOT_FOUND);
+
+    Receive(cache, BuildResponse(node));
+
+    NL_TEST_ASSERT(inSuite, cache.Lookup(node.peerId, nodeData) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, nodeData.mPeerId == node.peerId);
+    NL_TEST_ASSERT(inSuite, nodeData.mPort == node.port);
+    NL_TEST_ASSERT(inSuite, strcmp(nodeData.mHostName, node.hostName) == 0);
+    NL_TEST_ASSERT(inSuite, nodeData.mNumIPs == 1);
+    NL_TEST_ASSERT(inSuite, nodeData.mAddress[0] == node.address);
+    NL_TEST_ASSERT(inSuite, nodeData.mSupportsTcp);
+    NL_TEST_ASSERT(inSuite, nodeData.GetMrpRetryIntervalIdle().HasValue());
+    NL_TEST_ASSERT(inSuite, nodeData.GetMrpRetryIntervalIdle().Value() == System::Clock::Milliseconds32(3000));
+    NL_TEST_ASSERT(inSuite, nodeData.GetMrpRetryIntervalActive().Value() == System::Clock::Milliseconds32(4000));
+    NL_TEST_ASSERT(inSuite, nodeData.mExpiryTime == fakeClock.GetMonotonicTimestamp() + System::Clock::Seconds32(kHostTtl));
+
+    // Another fabric has the same node id
+    PeerId otherFabric = node.peerId;
+    otherFabric.SetCompressedFabricId(kFabric + 1);
+    NL_TEST_ASSERT(inSuite, cache.Lookup(otherFabric, nodeData) == CHIP_ERROR_KEY_NOT_FOUND);
+
+    cache.Remove(node.peerId);
+    NL_TEST_ASSERT(inSuite, cache.Lookup(node.peerId, nodeData) == CHIP_ERROR_KEY_NOT_FOUND);
+}
+
+void TestExpiry(nlTestSuite * inSuite, void * inContext)
+{
+    MdnsRecordCacheWithStorage<8> cache;
+    NodeRecords node(0x200, 5540);
+    ResolvedNodeData nodeData;
+    const System::Clock::Timestamp start = fakeClock.GetMonotonicTimestamp();
+
+    node.addressTtl = 10;
+    Receive(cache, BuildResponse(node));
+
+    fakeClock.SetMonotonic(start + System::Clock::Seconds16(9));
+    NL_TEST_ASSERT(inSuite, cache.Lookup(node.peerId, nodeData) == CHIP_NO_ERROR);
+
+    // The address expired, while the SRV record is still fresh
+    fakeClock.SetMonotonic(start + System::Clock::Seconds16(10));
+    NL_TEST_ASSERT(inSuite, cache.Lookup(node.peerId, nodeData) == CHIP_ERROR_KEY_NOT_FOUND);
+
+    Receive(cache, BuildResponse(node));
+    NL_TEST_ASSERT(inSuite, cache.Lookup(node.peerId, nodeData) == CHIP_NO_ERROR);
+
+    // A goodbye removes the record one second later
+    node.srvTtl = 0;
+    Receive(cache, BuildResponse(node));
+    NL_TEST_ASSERT(inSuite, cache.Lookup(node.peerId, nodeData) == CHIP_NO_ERROR);
+    fakeClock.SetMonotonic(start + System::Clock::Seconds16(11));
+    NL_TEST_ASSERT(inSuite, cache.Lookup(node.peerId, nodeData) == CHIP_ERROR_KEY_NOT_FOUND);
+}
+
+void TestCacheFlush(nlTestSuite * inSuite, void * inContext)
+{
+    MdnsRecordCacheWithStorage<8> cache;
+    NodeRecords node(0x300, 5540);
+    ResolvedNodeData nodeData;
+    const System::Clock::Timestamp start = fakeClock.GetMonotonicTimestamp();
+    const Inet::IPAddress oldAddress     = node.address;
+
+    Receive(cache, BuildResponse(node));
+
+    // The node moved: its new address comes with the cache-flush bit set
+    fakeClock.SetMonotonic(start + System::Clock::Seconds16(5));
+    Inet::IPAddress::FromString("fd00::1:300", node.address);
+    node.cacheFlush = true;
+    Receive(cache, BuildResponse(node));
+
+    NL_TEST_ASSERT(inSuite, cache.Lookup(node.peerId, nodeData) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, nodeData.mNumIPs == 2);
+
+    fakeClock.SetMonotonic(start + System::Clock::Seconds16(7));
+    NL_TEST_ASSERT(inSuite, cache.Lookup(node.peerId, nodeData) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, nodeData.mNumIPs == 1);
+    NL_TEST_ASSERT(inSuite, nodeData.mAddress[0] == node.address);
+    NL_TEST_ASSERT(inSuite, !(nodeData.mAddress[0] == oldAddress));
+}
+
+void TestIgnoresUnrelatedRecords(nlTestSuite * inSuite, void * inContext)
+{
+    MdnsRecordCacheWithStorage<8> cache;
+    NodeRecords node(0x400, 5540);
+
+    // Addresses of hosts that no cached service points at are not kept
+    cache.AddHostAddress(node.hostName, node.address, Inet::InterfaceId::Null(), kHostTtl, false);
+    NL_TEST_ASSERT(inSuite, cache.GetHostCount() == 0);
+
+    // Nor are queries, even when they carry answers
+    System::PacketBufferHandle packet = BuildResponse(node);
+    HeaderRef(packet->Start()).SetFlags(BitPackedFlags(0).SetQuery());
+    Receive(cache, packet);
+    NL_TEST_ASSERT(inSuite, cache.GetServiceCount() == 0);
+    NL_TEST_ASSERT(inSuite, cache.GetHostCount() == 0);
+}
+
+void TestKnownAnswers(nlTestSuite * inSuite, void * inContext)
+{
+    MdnsRecordCacheWithStorage<8> cache;
+    NodeRecords node(0x500, 5540);
+    const System::Clock::Timestamp start = fakeClock.GetMonotonicTimestamp();
+
+    NL_TEST_ASSERT(inSuite, BuildResolveQuery(cache, node.peerId) == 0);
+
+    Receive(cache, BuildResponse(node));
+    NL_TEST_ASSERT(inSuite, BuildResolveQuery(cache, node.peerId) == 1);
+
+    // Only records with more than half their TTL left are known answers
+    fakeClock.SetMonotonic(start + System::Clock::Seconds32(kServiceTtl / 2));
+    NL_TEST_ASSERT(inSuite, BuildResolveQuery(cache, node.peerId) == 0);
+}
+
+void TestEviction(nlTestSuite * inSuite, void * inContext)
+{
+    MdnsRecordCacheWithStorage<8> cache;
+    const System::Clock::Timestamp start = fakeClock.GetMonotonicTimestamp();
+    ResolvedNodeData nodeData;
+
+    for (NodeId nodeId = 1; nodeId <= 32; nodeId++)
+    {
+        NodeRecords node(nodeId, 5540);
+        node.srvTtl = node.txtTtl = node.addressTtl = static_cast<uint32_t>(100 + nodeId);
+        Receive(cache, BuildResponse(node));
+        NL_TEST_ASSERT(inSuite, cache.GetServiceCount() <= 6);
+        NL_TEST_ASSERT(inSuite, cache.Lookup(node.peerId, nodeData) == CHIP_NO_ERROR);
+    }
+
+    // The entries expiring first made room
+    NL_TEST_ASSERT(inSuite, cache.Lookup(NodeRecords(1, 5540).peerId, nodeData) == CHIP_ERROR_KEY_NOT_FOUND);
+    NL_TEST_ASSERT(inSuite, cache.Lookup(NodeRecords(31, 5540).peerId, nodeData) == CHIP_NO_ERROR);
+
+    // Expired entries are dropped before any fresh one
+    fakeClock.SetMonotonic(start + System::Clock::Seconds16(200));
+    NodeRecords node(100, 5540);
+    Receive(cache, BuildResponse(node));
+    NL_TEST_ASSERT(inSuite, cache.GetServiceCount() == 1);
+    NL_TEST_ASSERT(inSuite, cache.Lookup(node.peerId, nodeData) == CHIP_NO_ERROR);
+}
+
+/// A controller reconnects to 500 nodes, resolving each one first, and counts the mDNS queries it needs to send.
+void TestReconnectQueries(nlTestSuite * inSuite, void * inContext)
+{
+    constexpr size_t kNodeCount = 500;
+
+    auto cache = std::make_unique<MdnsRecordCacheWithStorage<1024>>();
+    size_t queries;
+    size_t knownAnswers;
+    ResolvedNodeData nodeData;
+    const System::Clock::Timestamp start = fakeClock.GetMonotonicTimestamp();
+
+    auto reconnectAll = [&]() {
+        queries      = 0;
+        knownAnswers = 0;
+        for (size_t i = 0; i < kNodeCount; i++)
+        {
+            NodeRecords node(static_cast<NodeId>(0x1000 + i), 5540);
+            if (cache->Lookup(node.peerId, nodeData) == CHIP_NO_ERROR)
+            {
+                continue;
+            }
+            queries++;
+            knownAnswers += BuildResolveQuery(*cache, node.peerId);
+            Receive(*cache, BuildResponse(node));
+        }
+    };
+
+    reconnectAll();
+    printf("cold reconnect: %u queries, %u known answers\n", static_cast<unsigned>(queries), static_cast<unsigned>(knownAnswers));
+    NL_TEST_ASSERT(inSuite, queries == kNodeCount);
+    NL_TEST_ASSERT(inSuite, knownAnswers == 0);
+
+    fakeClock.SetMonotonic(start + System::Clock::Seconds16(60));
+    reconnectAll();
+    printf("warm reconnect: %u queries\n", static_cast<unsigned>(queries));
+    NL_TEST_ASSERT(inSuite, queries == 0);
+
+    // Addresses expired, but the TXT records have most of their TTL left
+    fakeClock.SetMonotonic(start + System::Clock::Seconds16(kHostTtl + 1));
+    reconnectAll();
+    printf("reconnect after address expiry: %u queries, %u known answers\n", static_cast<unsigned>(queries),
+           static_cast<unsigned>(knownAnswers));
+    NL_TEST_ASSERT(inSuite, queries == kNodeCount);
+    NL_TEST_ASSERT(inSuite, knownAnswers == kNodeCount);
+}
+
+class CountingResolverDelegate : public ResolverDelegate
+{
+public:
+    void OnNodeIdResolved(const ResolvedNodeData & nodeData) override { mResolved++; }
+    void OnNodeIdResolutionFailed(const PeerId & peerId, CHIP_ERROR error) override {}
+    void OnNodeDiscoveryComplete(const DiscoveredNodeData & nodeData) override {}
+
+    size_t mResolved = 0;
+};
+
+/// The resolver built into this library, with its configured cache size, keeps every node announced while below three
+/// quarters of CHIP_CONFIG_MINMDNS_RECORD_CACHE_SIZE and resolves them all without a query.
+void TestResolverCapacity(nlTestSuite * inSuite, void * inContext)
+{
+    constexpr size_t kNodeCount = CHIP_CONFIG_MINMDNS_RECORD_CACHE_SIZE * 3 / 4;
+
+    Inet::IPPacketInfo info;
+    info.Clear();
+    for (size_t i = 0; i < kNodeCount; i++)
+    {
+        System::PacketBufferHandle packet = BuildResponse(NodeRecords(static_cast<NodeId>(0x2000 + i), 5540));
+        GlobalMinimalMdnsServer::Instance().OnResponse(BytesRange(packet->Start(), packet->Start() + packet->DataLength()),
+                                                       &info);
+    }
+
+    CountingResolverDelegate delegate;
+    Resolver::Instance().SetResolverDelegate(&delegate);
+    for (size_t i = 0; i < kNodeCount; i++)
+    {
+        NodeRecords node(static_cast<NodeId>(0x2000 + i), 5540);
+        NL_TEST_ASSERT(inSuite,
+                       Resolver::Instance().ResolveNodeId(node.peerId, Inet::IPAddressType::kAny, Resolver::CacheBypass::Off) ==
+                           CHIP_NO_ERROR);
+    }
+    Resolver::Instance().SetResolverDelegate(nullptr);
+
+    NL_TEST_ASSERT(inSuite, delegate.mResolved == kNodeCount);
+}
+
+const nlTest sTests[] = {
+    NL_TEST_DEF("ResolveFromResponse", TestResolveFromResponse),         //
+    NL_TEST_DEF("Expiry", TestExpiry),                                   //
+    NL_TEST_DEF("CacheFlush", TestCacheFlush),                           //
+    NL_TEST_DEF("IgnoresUnrelatedRecords", TestIgnoresUnrelatedRecords), //
+    NL_TEST_DEF("KnownAnswers", TestKnownAnswers),                       //
+    NL_TEST_DEF("Eviction", TestEviction),                               //
+    NL_TEST_DEF("ReconnectQueries", TestReconnectQueries),               //
+    NL_TEST_DEF("ResolverCapacity", TestResolverCapacity),               //
+    NL_TEST_SENTINEL()                                                   //
+};
+
+int TestSetup(void * inContext)
+{
+    if (Platform::MemoryInit() != CHIP_NO_ERROR)
+    {
+        return FAILURE;
+    }
+    realClock = &System::SystemClock();
+    System::Clock::Internal::SetSystemClockForTesting(&fakeClock);
+    return SUCCESS;
+}
+
+int TestTeardown(void * inContext)
+{
+    System::Clock::Internal::SetSystemClockForTesting(realClock);
+    Platform::MemoryShutdown();
+    return SUCCESS;
+}
+
+} // namespace
+
+int TestMdnsRecordCache(void)
+{
+    nlTestSuite theSuite = { "MdnsRecordCache", &sTests[0], TestSetup, TestTeardown };
+    nlTestRunner(&theSuite, nullptr);
+    return nlTestRunnerStats(&theSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestMdnsRecordCache)
@@ -0,0 +1,142 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines a fixed-capacity, lock-free queue that any number
+ *      of threads may push to and a single thread pops from.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+
+namespace chip {
+
+/**
+ * A bounded multi-producer, single-consumer FIFO queue that does not take locks.
+ *
+ * Each slot carries a sequence number telling whether it is free for the producer whose turn it is, or holds a value for the
+ * consumer.  Producers claim slots with a compare-and-swap on the enqueue position; the consumer owns the dequeue position.
+ * Push fails rather than blocks when the queue is full.
+ *
+ * T must be copy-assignable and default-constructible.
+ */
+template <typename T, size_t N>
+class BoundedMpscQueue
+{
+public:
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "The capacity must be a power of two");
+
+    BoundedMpscQueue()
+    {
+        for (size_t i = 0; i < N; i++)
+        {
+            mSlots[i].mSequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedMpscQueue(const BoundedMpscQueue &) = delete;
+    BoundedMpscQueue & operator=(const BoundedMpscQueue &) = delete;
+
+    static constexpr size_t Capacity() { return N; }
+
+    /**
+     * Append value to the queue.  Safe to call from any thread.
+     *
+     * @return false if the queue is full.
+     */
+    bool Push(const T & value)
+    {
+        size_t position = mEnqueuePosition.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            Slot & slot       = mSlots[position & (N - 1)];
+            size_t sequence   = slot.mSequence.load(std::memory_order_acquire);
+            ptrdiff_t pending = static_cast<ptrdiff_t>(sequence - position);
+
+            if (pending == 0)
+            {
+                if (mEnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    slot.mValue = value;
+                    slot.mSequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+                // position was reloaded by the failed compare-and-swap.
+            }
+            else if (pending < 0)
+            {
+                // The slot still holds the value pushed one lap ago.
+                return false;
+            }
+            else
+            {
+                position = mEnqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * Remove the oldest value from the queue.  Must only be called from the consumer thread.
+     *
+     * A value whose producer has claimed its slot but not finished writing it is not available yet, and neither are the values
+     * behind it.
+     *
+     * @return false if no value is available.
+     */
+    bool Pop(T & value)
+    {
+        Slot & slot     = mSlots[mDequeuePosition & (N - 1)];
+        size_t sequence = slot.mSequence.load(std::memory_order_acquire);
+
+        if (sequence != mDequeuePosition + 1)
+        {
+            return false;
+        }
+
+        value = slot.mValue;
+        slot.mSequence.store(mDequeuePosition + N, std::memory_order_release);
+        mDequeuePosition++;
+        return true;
+    }
+
+    /**
+     * Returns whether a value is available to Pop().  Must only be called from the consumer thread.
+     */
+    bool Empty() const
+    {
+        return mSlots[mDequeuePosition & (N - 1)].mSequence.load(std::memory_order_acquire) != mDequeuePosition + 1;
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> mSequence;
+        T mValue;
+    };
+
+    Slot mSlots[N];
+    // Kept on separate cache lines so that producers and the consumer don't contend on them.
+    alignas(64) std::atomic<size_t> mEnqueuePosition{ 0 };
+    alignas(64) size_t mDequeuePosition = 0;
+};
+
+} // namespace chip
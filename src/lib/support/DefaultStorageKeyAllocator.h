@@ -48,6 +48,10 @@ public:
     }
     const char * FabricKeyset(chip::FabricIndex fabric, uint16_t keyset) { return Format("f/%x/k/%x", fabric, keyset); }
 
+    // CASE Session Resumption
+
+    const char * CASESessionResumption(uint16_t index) { return Format("cr/%x", index); }
+
     const char * AttributeValue(const app::ConcreteAttributePath & aPath)
     {
         // Needs at most 24 chars: 4 for "a///", 4 for the endpoint id, 8 each
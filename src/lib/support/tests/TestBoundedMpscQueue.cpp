@@ -0,0 +1,149 @@
+/*
+ *    Copyright (c) 2021 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <lib/support/BoundedMpscQueue.h>
+#include <lib/support/UnitTestRegistration.h>
+#include <system/SystemConfig.h>
+
+#include <nlunit-test.h>
+
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+#include <thread>
+#include <vector>
+#endif
+
+namespace {
+
+using namespace chip;
+
+void TestFifo(nlTestSuite * inSuite, void * inContext)
+{
+    BoundedMpscQueue<int, 4> queue;
+    int value;
+
+    NL_TEST_ASSERT(inSuite, queue.Empty());
+    NL_TEST_ASSERT(inSuite, !queue.Pop(value));
+
+    // Go around the ring a few times.
+    for (int lap = 0; lap < 3; lap++)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            NL_TEST_ASSERT(inSuite, queue.Push(lap * 10 + i));
+        }
+        NL_TEST_ASSERT(inSuite, !queue.Push(-1));
+        NL_TEST_ASSERT(inSuite, !queue.Empty());
+
+        for (int i = 0; i < 4; i++)
+        {
+            NL_TEST_ASSERT(inSuite, queue.Pop(value) && value == lap * 10 + i);
+        }
+        NL_TEST_ASSERT(inSuite, queue.Empty());
+        NL_TEST_ASSERT(inSuite, !queue.Pop(value));
+    }
+
+    // A slot freed by Pop() is available to Push() again.
+    NL_TEST_ASSERT(inSuite, queue.Push(1));
+    NL_TEST_ASSERT(inSuite, queue.Push(2));
+    NL_TEST_ASSERT(inSuite, queue.Pop(value) && value == 1);
+    NL_TEST_ASSERT(inSuite, queue.Push(3));
+    NL_TEST_ASSERT(inSuite, queue.Push(4));
+    NL_TEST_ASSERT(inSuite, queue.Push(5));
+    NL_TEST_ASSERT(inSuite, !queue.Push(6));
+    for (int expected = 2; expected <= 5; expected++)
+    {
+        NL_TEST_ASSERT(inSuite, queue.Pop(value) && value == expected);
+    }
+}
+
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+void TestConcurrentProducers(nlTestSuite * inSuite, void * inContext)
+{
+    constexpr uint32_t kProducers         = 4;
+    constexpr uint32_t kValuesPerProducer = 20000;
+
+    static BoundedMpscQueue<uint32_t, 64> queue;
+    std::vector<std::thread> producers;
+
+    for (uint32_t producer = 0; producer < kProducers; producer++)
+    {
+        producers.emplace_back([producer] {
+            for (uint32_t i = 0; i < kValuesPerProducer; i++)
+            {
+                while (!queue.Push(producer * kValuesPerProducer + i))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // Every value must come out exactly once, and the values of each producer in the order it pushed them.
+    uint32_t next[kProducers] = {};
+    uint32_t received         = 0;
+    bool inOrder              = true;
+    while (received < kProducers * kValuesPerProducer)
+    {
+        uint32_t value;
+        if (!queue.Pop(value))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        uint32_t producer = value / kValuesPerProducer;
+        inOrder           = inOrder && producer < kProducers && value % kValuesPerProducer == next[producer];
+        if (producer < kProducers)
+        {
+            next[producer]++;
+        }
+        received++;
+    }
+
+    for (auto & thread : producers)
+    {
+        thread.join();
+    }
+
+    NL_TEST_ASSERT(inSuite, inOrder);
+    NL_TEST_ASSERT(inSuite, queue.Empty());
+}
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+
+} // namespace
+
+#define NL_TEST_DEF_FN(fn) NL_TEST_DEF("Test " #fn, fn)
+/**
+ *   Test Suite. It lists all the test functions.
+ */
+static const nlTest sTests[] = {
+    NL_TEST_DEF_FN(TestFifo), //
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+    NL_TEST_DEF_FN(TestConcurrentProducers), //
+#endif
+    NL_TEST_SENTINEL(), //
+};
+
+int TestBoundedMpscQueue()
+{
+    nlTestSuite theSuite = { "CHIP BoundedMpscQueue tests", &sTests[0], nullptr, nullptr };
+
+    nlTestRunner(&theSuite, nullptr);
+    return nlTestRunnerStats(&theSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestBoundedMpscQueue);
@@ -133,6 +133,22 @@ public:
      */
     void WillSendMessage() { mFlags.Set(Flags::kFlagWillSendMessage); }
 
+    /**
+     * Determine whether we are expecting our consumer to send a message on
+     * this exchange (i.e. WillSendMessage was called and the message has not
+     * yet been sent).
+     */
+    bool IsSendExpected() const { return mFlags.Has(Flags::kFlagWillSendMessage); }
+
+    /**
+     *  Determine whether a response is currently expected for a message that was sent over
+     *  this exchange.  While this is true, attempts to send other messages that expect a response
+     *  will fail.
+     *
+     *  @return Returns 'true' if response expected, else 'false'.
+     */
+    bool IsResponseExpected() const;
+
     /**
      *  Handle a received CHIP message on this exchange.
      *
@@ -185,22 +201,6 @@ private:
     SessionHolderWithDelegate mSession; // The connection state
     uint16_t mExchangeId;               // Assigned exchange ID.
 
-    /**
-     *  Determine whether a response is currently expected for a message that was sent over
-     *  this exchange.  While this is true, attempts to send other messages that expect a response
-     *  will fail.
-     *
-     *  @return Returns 'true' if response expected, else 'false'.
-     */
-    bool IsResponseExpected() const;
-
-    /**
-     * Determine whether we are expecting our consumer to send a message on
-     * this exchange (i.e. WillSendMessage was called and the message has not
-     * yet been sent).
-     */
-    bool IsSendExpected() const { return mFlags.Has(Flags::kFlagWillSendMessage); }
-
     /**
      *  Track whether we are now expecting a response to a message sent via this exchange (because that
      *  message had the kExpectResponse flag set in its sendFlags).
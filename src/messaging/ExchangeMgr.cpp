@@ -42,6 +42,7 @@
 #include <messaging/ExchangeContext.h>
 #include <messaging/ExchangeMgr.h>
 #include <protocols/Protocols.h>
+#include <trace/trace.h>
 
 using namespace chip::Encoding;
 using namespace chip::Inet;
@@ -188,6 +189,7 @@ void ExchangeManager::OnMessageReceived(const PacketHeader & packetHeader, const
                                         const SessionHandle & session, const Transport::PeerAddress & source,
                                         DuplicateMessage isDuplicate, System::PacketBufferHandle && msgBuf)
 {
+    TRACE_EVENT_SCOPE("OnMessageReceived", "ExchangeManager");
     UnsolicitedMessageHandler * matchingUMH = nullptr;
 
     ChipLogProgress(ExchangeManager,
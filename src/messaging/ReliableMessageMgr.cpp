@@ -34,6 +34,7 @@
 #include <messaging/ExchangeMgr.h>
 #include <messaging/Flags.h>
 #include <messaging/ReliableMessageContext.h>
+#include <trace/trace.h>
 
 using namespace chip::System::Clock::Literals;
 
@@ -97,6 +98,7 @@ void ReliableMessageMgr::TicklessDebugDumpRetransTable(const char * log)
 
 void ReliableMessageMgr::ExecuteActions()
 {
+    TRACE_EVENT_SCOPE("ExecuteActions", "ReliableMessageMgr");
     System::Clock::Timestamp now = System::SystemClock().GetMonotonicTimestamp();
 
 #if defined(RMP_TICKLESS_DEBUG)
@@ -135,6 +137,8 @@ void ReliableMessageMgr::ExecuteActions()
                          " sendCount: %" PRIu8 " max retries: %d",
                          messageCounter, ChipLogValueExchange(&entry->ec.Get()), sendCount, CHIP_CONFIG_RMP_DEFAULT_MAX_RETRANS);
 
+            TRACE_EVENT_INSTANT("RetransmitLimitReached", "ReliableMessageMgr");
+
             // Do not StartTimer, we will schedule the timer at the end of the timer handler.
             mRetransTable.ReleaseObject(entry);
             return Loop::Continue;
@@ -144,6 +148,7 @@ void ReliableMessageMgr::ExecuteActions()
                       "Retransmitting MessageCounter:" ChipLogFormatMessageCounter " on exchange " ChipLogFormatExchange
                       " Send Cnt %d",
                       messageCounter, ChipLogValueExchange(&entry->ec.Get()), entry->sendCount);
+        TRACE_EVENT_INSTANT("Retransmit", "ReliableMessageMgr");
         // TODO: Choose active/idle timeout corresponding to the activity of exchanges of the session.
         entry->nextRetransTime =
             System::SystemClock().GetMonotonicTimestamp() + entry->ec->GetSessionHandle()->GetMRPConfig().mActiveRetransTimeout;
@@ -62,3 +62,4 @@ struct ChipDeviceEvent;
 #define CHIP_SYSTEM_CONFIG_USE_NETWORK_FRAMEWORK 0
 #define CHIP_SYSTEM_CONFIG_POSIX_LOCKING 0
 #define CHIP_CONFIG_MDNS_CACHE_SIZE 4
+#define CHIP_CONFIG_MINMDNS_RECORD_CACHE_SIZE 4
@@ -102,6 +102,14 @@
 #define CHIP_CONFIG_BDX_MAX_NUM_TRANSFERS 1
 #endif // CHIP_CONFIG_BDX_MAX_NUM_TRANSFERS
 
+#ifndef CHIP_CONFIG_ACCESS_CONTROL_CACHE
+#define CHIP_CONFIG_ACCESS_CONTROL_CACHE 1
+#endif // CHIP_CONFIG_ACCESS_CONTROL_CACHE
+
+#ifndef CHIP_CONFIG_SECURE_SESSION_KEYED_CIPHERS
+#define CHIP_CONFIG_SECURE_SESSION_KEYED_CIPHERS 1
+#endif // CHIP_CONFIG_SECURE_SESSION_KEYED_CIPHERS
+
 // TODO - Fine tune MRP default parameters for Darwin platform
 #define CHIP_CONFIG_MRP_DEFAULT_INITIAL_RETRY_INTERVAL (15000)
 #define CHIP_CONFIG_MRP_DEFAULT_ACTIVE_RETRY_INTERVAL (2000_ms32)
@@ -41,6 +41,11 @@
 #define CHIP_DEVICE_CONFIG_ENABLE_CHIPOBLE 0
 #endif
 
+// Back the KeyValueStoreManager with the append-only ChipLinuxStorageLog rather than the INI file.
+#ifndef CHIP_DEVICE_CONFIG_LINUX_KVS_LOG
+#define CHIP_DEVICE_CONFIG_LINUX_KVS_LOG 0
+#endif
+
 #define CHIP_DEVICE_CONFIG_ENABLE_CHIP_TIME_SERVICE_TIME_SYNC 0
 
 #define CHIP_DEVICE_CONFIG_ENABLE_COMMISSIONABLE_DISCOVERY 1
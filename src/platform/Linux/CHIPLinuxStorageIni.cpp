@@ -316,6 +316,22 @@ bool ChipLinuxStorageIni::HasValue(const char * key)
     return it != section.end();
 }
 
+CHIP_ERROR ChipLinuxStorageIni::GetKeys(std::vector<std::string> & keys)
+{
+    std::map<std::string, std::string> section;
+    // Lines that did not parse mean the file is not what it was expected to be, not that it holds fewer keys.
+    VerifyOrReturnError(mConfigStore.errors.empty(), CHIP_ERROR_DECODE_FAILED);
+    ReturnErrorOnFailure(GetDefaultSection(section));
+
+    keys.clear();
+    for (const auto & entry : section)
+    {
+        keys.push_back(entry.first);
+    }
+
+    return CHIP_NO_ERROR;
+}
+
 CHIP_ERROR ChipLinuxStorageIni::AddEntry(const char * key, const char * value)
 {
     CHIP_ERROR retval = CHIP_NO_ERROR;
@@ -29,6 +29,9 @@
 #include <lib/support/ScopedBuffer.h>
 #include <platform/PersistedStorage.h>
 
+#include <string>
+#include <vector>
+
 namespace chip {
 namespace DeviceLayer {
 namespace Internal {
@@ -44,6 +47,7 @@ public:
     CHIP_ERROR GetStringValue(const char * key, char * buf, size_t bufSize, size_t & outLen);
     CHIP_ERROR GetBinaryBlobValue(const char * key, uint8_t * decodedData, size_t bufSize, size_t & decodedDataLen);
     bool HasValue(const char * key);
+    CHIP_ERROR GetKeys(std::vector<std::string> & keys);
 
 protected:
     CHIP_ERROR AddEntry(const char * key, const char * value);
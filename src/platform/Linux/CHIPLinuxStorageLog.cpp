@@ -0,0 +1,657 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *         This file implements the log-structured binary key-value store
+ *         used by the Linux KeyValueStoreManager.
+ *
+ */
+
+#include <platform/Linux/CHIPLinuxStorageLog.h>
+
+#include <algorithm>
+#include <chrono>
+#include <errno.h>
+#include <fcntl.h>
+#include <libgen.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <vector>
+
+#include <lib/core/CHIPEncoding.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+#include <platform/Linux/CHIPLinuxStorageIni.h>
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+namespace {
+
+constexpr uint32_t kRecordMagic   = 0x314B5643; // "CVK1" read as little-endian bytes
+constexpr size_t kRecordHeaderLen = 16;
+// The CRC covers the header from here on, then the key and the value.
+constexpr size_t kRecordCrcStart = 8;
+constexpr uint16_t kFlagTombstone = 0x0001;
+
+// How long the compaction thread waits before retrying after a failed compaction.
+constexpr std::chrono::seconds kCompactionRetryDelay(30);
+
+uint32_t Crc32Update(uint32_t crc, const uint8_t * data, size_t len)
+{
+    static const auto sTable = [] {
+        std::vector<uint32_t> table(256);
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t c = i;
+            for (int bit = 0; bit < 8; bit++)
+            {
+                c = (c & 1) ? (0xEDB88320 ^ (c >> 1)) : (c >> 1);
+            }
+            table[i] = c;
+        }
+        return table;
+    }();
+
+    for (size_t i = 0; i < len; i++)
+    {
+        crc = sTable[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+bool ReadFully(int fd, void * buf, size_t len, off_t offset)
+{
+    uint8_t * p = static_cast<uint8_t *>(buf);
+    while (len > 0)
+    {
+        ssize_t n = pread(fd, p, len, offset);
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n <= 0)
+        {
+            return false;
+        }
+        p += n;
+        len -= static_cast<size_t>(n);
+        offset += n;
+    }
+    return true;
+}
+
+bool WriteFully(int fd, const void * buf, size_t len, off_t offset)
+{
+    const uint8_t * p = static_cast<const uint8_t *>(buf);
+    while (len > 0)
+    {
+        ssize_t n = pwrite(fd, p, len, offset);
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n <= 0)
+        {
+            return false;
+        }
+        p += n;
+        len -= static_cast<size_t>(n);
+        offset += n;
+    }
+    return true;
+}
+
+// Whether the file starts like a log: with the magic of a record, all of it or as much as a crash left, or with bytes
+// that were never written.
+bool StartsLikeLog(int fd, off_t size)
+{
+    uint8_t magic[4];
+    uint8_t start[sizeof(magic)];
+    size_t len = static_cast<size_t>(std::min(size, static_cast<off_t>(sizeof(start))));
+
+    Encoding::LittleEndian::Put32(magic, kRecordMagic);
+    if (!ReadFully(fd, start, len, 0))
+    {
+        return false;
+    }
+    return memcmp(start, magic, len) == 0 || std::all_of(start, start + len, [](uint8_t byte) { return byte == 0; });
+}
+
+// Make a rename within the directory holding path durable.
+void SyncParentDirectory(const std::string & path)
+{
+    std::string dir = path;
+    int fd          = open(dirname(&dir[0]), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd >= 0)
+    {
+        fsync(fd);
+        close(fd);
+    }
+}
+
+} // namespace
+
+ChipLinuxStorageLog::~ChipLinuxStorageLog()
+{
+    Shutdown();
+}
+
+CHIP_ERROR ChipLinuxStorageLog::Init(const char * logFile)
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    VerifyOrReturnError(mFd < 0, CHIP_ERROR_INCORRECT_STATE);
+
+    int fd = open(logFile, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd < 0)
+    {
+        ChipLogError(DeviceLayer, "failed to open kvs log (%s), %s (%d)", logFile, strerror(errno), errno);
+        return CHIP_ERROR_OPEN_FAILED;
+    }
+
+    struct stat st;
+    off_t validEnd = 0;
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    mIndex.clear();
+    mDeadBytes = 0;
+
+    VerifyOrExit(fstat(fd, &st) == 0, err = CHIP_ERROR_OPEN_FAILED);
+    if (!StartsLikeLog(fd, st.st_size))
+    {
+        close(fd);
+        fd = -1;
+        SuccessOrExit(err = MigrateIniFile(logFile, fd));
+        VerifyOrExit(fstat(fd, &st) == 0, err = CHIP_ERROR_OPEN_FAILED);
+    }
+    SuccessOrExit(err = Replay(fd, 0, st.st_size, mIndex, mDeadBytes, validEnd));
+
+    if (validEnd < st.st_size)
+    {
+        if (!IsTornTail(fd, validEnd, st.st_size))
+        {
+            ChipLogError(DeviceLayer, "kvs log (%s) is corrupt at offset %lld", logFile, static_cast<long long>(validEnd));
+            ExitNow(err = CHIP_ERROR_INTEGRITY_CHECK_FAILED);
+        }
+
+        // The last record was being appended when the process stopped; it was never reported as written, so drop it
+        // rather than letting new records land behind it.
+        ChipLogError(DeviceLayer, "discarding %lld bytes at the end of kvs log (%s)",
+                     static_cast<long long>(st.st_size - validEnd), logFile);
+        VerifyOrExit(ftruncate(fd, validEnd) == 0 && fdatasync(fd) == 0, err = CHIP_ERROR_WRITE_FAILED);
+    }
+
+    mLogPath.assign(logFile);
+    mFd               = fd;
+    mEnd              = validEnd;
+    mShutdown         = false;
+    mCompactionThread = std::thread(&ChipLinuxStorageLog::CompactionThreadMain, this);
+
+exit:
+    if (err != CHIP_NO_ERROR)
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        mIndex.clear();
+        mDeadBytes = 0;
+    }
+    return err;
+}
+
+CHIP_ERROR ChipLinuxStorageLog::MigrateIniFile(const char * logFile, int & outFd)
+{
+    ChipLinuxStorageIni ini;
+    std::vector<std::string> keys;
+    if (ini.AddConfig(logFile) != CHIP_NO_ERROR || ini.GetKeys(keys) != CHIP_NO_ERROR)
+    {
+        ChipLogError(DeviceLayer, "kvs file (%s) is neither a kvs log nor an INI file", logFile);
+        return CHIP_ERROR_INTEGRITY_CHECK_FAILED;
+    }
+
+    std::string tmpPath = std::string(logFile) + "-XXXXXX";
+    int tmpFd           = mkstemp(&tmpPath[0]);
+    if (tmpFd < 0)
+    {
+        ChipLogError(DeviceLayer, "failed to create (%s), %s (%d)", tmpPath.c_str(), strerror(errno), errno);
+        return CHIP_ERROR_OPEN_FAILED;
+    }
+
+    // Build the new log with the regular appends; Init() replays it from scratch afterwards.
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    std::vector<uint8_t> value;
+    mFd  = tmpFd;
+    mEnd = 0;
+    for (const auto & key : keys)
+    {
+        size_t valueLen = 0;
+        err             = ini.GetBinaryBlobValue(key.c_str(), nullptr, 0, valueLen);
+        if (err == CHIP_ERROR_BUFFER_TOO_SMALL)
+        {
+            value.resize(valueLen);
+            err = ini.GetBinaryBlobValue(key.c_str(), value.data(), value.size(), valueLen);
+        }
+        SuccessOrExit(err);
+        SuccessOrExit(err = Append(key.c_str(), value.data(), valueLen, false));
+    }
+
+    if (rename(tmpPath.c_str(), logFile) != 0)
+    {
+        ChipLogError(DeviceLayer, "failed to rename (%s), %s (%d)", tmpPath.c_str(), strerror(errno), errno);
+        ExitNow(err = CHIP_ERROR_WRITE_FAILED);
+    }
+    SyncParentDirectory(logFile);
+    ChipLogProgress(DeviceLayer, "migrated %u keys of INI kvs file (%s) to a kvs log", static_cast<unsigned>(keys.size()),
+                    logFile);
+    outFd = tmpFd;
+
+exit:
+    if (err != CHIP_NO_ERROR)
+    {
+        close(tmpFd);
+        unlink(tmpPath.c_str());
+    }
+    mFd  = -1;
+    mEnd = 0;
+    mIndex.clear();
+    mDeadBytes = 0;
+    return err;
+}
+
+void ChipLinuxStorageLog::Shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mShutdown = true;
+    }
+    mCompactionWanted.notify_all();
+    if (mCompactionThread.joinable())
+    {
+        mCompactionThread.join();
+    }
+
+    // Wait for a Compact() running on another thread, which still uses the log.
+    std::lock_guard<std::mutex> compactionLock(mCompactionLock);
+    std::lock_guard<std::mutex> lock(mLock);
+    if (mFd >= 0)
+    {
+        close(mFd);
+        mFd = -1;
+    }
+    mIndex.clear();
+    mEnd       = 0;
+    mDeadBytes = 0;
+}
+
+CHIP_ERROR ChipLinuxStorageLog::ReadValueBin(const char * key, uint8_t * buf, size_t bufSize, size_t & outLen, size_t offset)
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    VerifyOrReturnError(mFd >= 0, CHIP_ERROR_INCORRECT_STATE);
+
+    auto it = mIndex.find(key);
+    VerifyOrReturnError(it != mIndex.end(), CHIP_ERROR_KEY_NOT_FOUND);
+    const Entry & entry = it->second;
+    VerifyOrReturnError(offset <= entry.mValueLength, CHIP_ERROR_INVALID_ARGUMENT);
+
+    size_t remaining = entry.mValueLength - offset;
+    size_t copySize  = std::min(bufSize, remaining);
+    if (copySize > 0)
+    {
+        VerifyOrReturnError(buf != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+        VerifyOrReturnError(ReadFully(mFd, buf, copySize, entry.mValueOffset + static_cast<off_t>(offset)),
+                            CHIP_ERROR_READ_FAILED);
+    }
+    outLen = copySize;
+
+    return (copySize < remaining) ? CHIP_ERROR_BUFFER_TOO_SMALL : CHIP_NO_ERROR;
+}
+
+CHIP_ERROR ChipLinuxStorageLog::WriteValueBin(const char * key, const uint8_t * data, size_t dataLen)
+{
+    VerifyOrReturnError(data != nullptr || dataLen == 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    std::lock_guard<std::mutex> lock(mLock);
+    return Append(key, data, dataLen, false);
+}
+
+CHIP_ERROR ChipLinuxStorageLog::ClearValue(const char * key)
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    VerifyOrReturnError(mIndex.find(key) != mIndex.end(), CHIP_ERROR_KEY_NOT_FOUND);
+    return Append(key, nullptr, 0, true);
+}
+
+bool ChipLinuxStorageLog::HasValue(const char * key)
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    return mIndex.find(key) != mIndex.end();
+}
+
+size_t ChipLinuxStorageLog::GetLogSize()
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    return static_cast<size_t>(mEnd);
+}
+
+size_t ChipLinuxStorageLog::GetDeadBytes()
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    return mDeadBytes;
+}
+
+CHIP_ERROR ChipLinuxStorageLog::Append(const char * key, const uint8_t * data, size_t dataLen, bool tombstone)
+{
+    VerifyOrReturnError(mFd >= 0, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(key != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    size_t keyLen = strlen(key);
+    VerifyOrReturnError(keyLen > 0 && keyLen <= UINT16_MAX, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(dataLen <= UINT32_MAX - kRecordHeaderLen - keyLen, CHIP_ERROR_INVALID_ARGUMENT);
+
+    uint8_t header[kRecordHeaderLen];
+    Encoding::LittleEndian::Put32(&header[0], kRecordMagic);
+    Encoding::LittleEndian::Put16(&header[8], static_cast<uint16_t>(keyLen));
+    Encoding::LittleEndian::Put16(&header[10], tombstone ? kFlagTombstone : 0);
+    Encoding::LittleEndian::Put32(&header[12], static_cast<uint32_t>(dataLen));
+
+    uint32_t crc = 0xFFFFFFFF;
+    crc          = Crc32Update(crc, &header[kRecordCrcStart], kRecordHeaderLen - kRecordCrcStart);
+    crc          = Crc32Update(crc, reinterpret_cast<const uint8_t *>(key), keyLen);
+    crc          = Crc32Update(crc, data, dataLen);
+    Encoding::LittleEndian::Put32(&header[4], ~crc);
+
+    iovec iov[3] = {
+        { header, kRecordHeaderLen },
+        { const_cast<char *>(key), keyLen },
+        { const_cast<uint8_t *>(data), dataLen },
+    };
+    const size_t recordSize = kRecordHeaderLen + keyLen + dataLen;
+
+    // A short write leaves a torn record that replay would discard anyway; cut it off now so the next append does not
+    // land behind it.
+    ssize_t written = pwritev(mFd, iov, (dataLen > 0) ? 3 : 2, mEnd);
+    if (written != static_cast<ssize_t>(recordSize) || fdatasync(mFd) != 0)
+    {
+        ChipLogError(DeviceLayer, "failed to append to kvs log (%s), %s (%d)", mLogPath.c_str(), strerror(errno), errno);
+        (void) ftruncate(mFd, mEnd);
+        return CHIP_ERROR_WRITE_FAILED;
+    }
+
+    auto it = mIndex.find(key);
+    if (it != mIndex.end())
+    {
+        mDeadBytes += it->second.mRecordSize;
+    }
+    if (tombstone)
+    {
+        mIndex.erase(it);
+        mDeadBytes += recordSize;
+    }
+    else
+    {
+        Entry entry = { mEnd + static_cast<off_t>(kRecordHeaderLen + keyLen), static_cast<uint32_t>(dataLen),
+                        static_cast<uint32_t>(recordSize) };
+        if (it != mIndex.end())
+        {
+            it->second = entry;
+        }
+        else
+        {
+            mIndex.emplace(key, entry);
+        }
+    }
+    mEnd += static_cast<off_t>(recordSize);
+
+    if (NeedsCompaction())
+    {
+        mCompactionWanted.notify_one();
+    }
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR ChipLinuxStorageLog::Replay(int fd, off_t start, off_t end, Index & index, size_t & deadBytes, off_t & validEnd)
+{
+    std::vector<uint8_t> body;
+    off_t pos = start;
+
+    while (end - pos >= static_cast<off_t>(kRecordHeaderLen))
+    {
+        uint8_t header[kRecordHeaderLen];
+        VerifyOrReturnError(ReadFully(fd, header, sizeof(header), pos), CHIP_ERROR_READ_FAILED);
+
+        uint32_t magic    = Encoding::LittleEndian::Get32(&header[0]);
+        uint32_t crc      = Encoding::LittleEndian::Get32(&header[4]);
+        uint16_t keyLen   = Encoding::LittleEndian::Get16(&header[8]);
+        uint16_t flags    = Encoding::LittleEndian::Get16(&header[10]);
+        uint32_t valueLen = Encoding::LittleEndian::Get32(&header[12]);
+        size_t bodyLen    = static_cast<size_t>(keyLen) + valueLen;
+
+        if (magic != kRecordMagic || keyLen == 0 || bodyLen > static_cast<size_t>(end - pos) - kRecordHeaderLen)
+        {
+            break;
+        }
+
+        body.resize(bodyLen);
+        VerifyOrReturnError(ReadFully(fd, body.data(), bodyLen, pos + static_cast<off_t>(kRecordHeaderLen)),
+                            CHIP_ERROR_READ_FAILED);
+
+        uint32_t computed = 0xFFFFFFFF;
+        computed          = Crc32Update(computed, &header[kRecordCrcStart], kRecordHeaderLen - kRecordCrcStart);
+        computed          = Crc32Update(computed, body.data(), bodyLen);
+        if (~computed != crc)
+        {
+            break;
+        }
+
+        std::string key(reinterpret_cast<const char *>(body.data()), keyLen);
+        size_t recordSize = kRecordHeaderLen + bodyLen;
+
+        auto it = index.find(key);
+        if (it != index.end())
+        {
+            deadBytes += it->second.mRecordSize;
+        }
+        if (flags & kFlagTombstone)
+        {
+            if (it != index.end())
+            {
+                index.erase(it);
+            }
+            deadBytes += recordSize;
+        }
+        else
+        {
+            index[key] = { pos + static_cast<off_t>(kRecordHeaderLen + keyLen), valueLen, static_cast<uint32_t>(recordSize) };
+        }
+        pos += static_cast<off_t>(recordSize);
+    }
+
+    validEnd = pos;
+    return CHIP_NO_ERROR;
+}
+
+bool ChipLinuxStorageLog::IsTornTail(int fd, off_t start, off_t end)
+{
+    uint8_t header[kRecordHeaderLen];
+
+    // An append writes the header first; one cut short leaves less than a header.
+    if (end - start < static_cast<off_t>(kRecordHeaderLen))
+    {
+        return true;
+    }
+    if (!ReadFully(fd, header, sizeof(header), start))
+    {
+        return false;
+    }
+
+    // A record that reaches the end of the file was the last one appended.
+    if (Encoding::LittleEndian::Get32(&header[0]) == kRecordMagic)
+    {
+        off_t recordSize = static_cast<off_t>(kRecordHeaderLen + Encoding::LittleEndian::Get16(&header[8]) +
+                                              Encoding::LittleEndian::Get32(&header[12]));
+        return recordSize >= end - start;
+    }
+
+    // The file may have been extended over blocks the append never got to write.
+    uint8_t buf[4096];
+    for (off_t pos = start; pos < end;)
+    {
+        size_t chunk = static_cast<size_t>(std::min(end - pos, static_cast<off_t>(sizeof(buf))));
+        if (!ReadFully(fd, buf, chunk, pos) || !std::all_of(buf, buf + chunk, [](uint8_t byte) { return byte == 0; }))
+        {
+            return false;
+        }
+        pos += static_cast<off_t>(chunk);
+    }
+    return true;
+}
+
+CHIP_ERROR ChipLinuxStorageLog::CopyRange(int fromFd, off_t from, off_t length, int toFd, off_t to)
+{
+    uint8_t buf[4096];
+    while (length > 0)
+    {
+        size_t chunk = static_cast<size_t>(std::min(length, static_cast<off_t>(sizeof(buf))));
+        VerifyOrReturnError(ReadFully(fromFd, buf, chunk, from), CHIP_ERROR_READ_FAILED);
+        VerifyOrReturnError(WriteFully(toFd, buf, chunk, to), CHIP_ERROR_WRITE_FAILED);
+        from += static_cast<off_t>(chunk);
+        to += static_cast<off_t>(chunk);
+        length -= static_cast<off_t>(chunk);
+    }
+    return CHIP_NO_ERROR;
+}
+
+bool ChipLinuxStorageLog::NeedsCompaction() const
+{
+    return mDeadBytes >= kCompactionMinDeadBytes && mDeadBytes > static_cast<size_t>(mEnd) / 2;
+}
+
+CHIP_ERROR ChipLinuxStorageLog::Compact()
+{
+    std::lock_guard<std::mutex> compactionLock(mCompactionLock);
+    std::string tmpPath;
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        VerifyOrReturnError(mFd >= 0, CHIP_ERROR_INCORRECT_STATE);
+        tmpPath = mLogPath + "-XXXXXX";
+    }
+
+    int newFd = mkstemp(&tmpPath[0]);
+    if (newFd < 0)
+    {
+        ChipLogError(DeviceLayer, "failed to create (%s), %s (%d)", tmpPath.c_str(), strerror(errno), errno);
+        return CHIP_ERROR_OPEN_FAILED;
+    }
+
+    CHIP_ERROR err = CompactInto(newFd, tmpPath);
+    if (err != CHIP_NO_ERROR)
+    {
+        close(newFd);
+        unlink(tmpPath.c_str());
+    }
+    return err;
+}
+
+CHIP_ERROR ChipLinuxStorageLog::CompactInto(int newFd, const std::string & newPath)
+{
+    // Only this function, under mCompactionLock, replaces mFd, and appends never modify what is already in the log, so
+    // the snapshot can be copied from the old log without holding mLock.
+    Index snapshot;
+    off_t copiedEnd;
+    int oldFd;
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        snapshot  = mIndex;
+        copiedEnd = mEnd;
+        oldFd     = mFd;
+    }
+
+    Index newIndex;
+    off_t newEnd = 0;
+    for (const auto & item : snapshot)
+    {
+        const Entry & entry = item.second;
+        off_t recordStart   = entry.mValueOffset - static_cast<off_t>(kRecordHeaderLen + item.first.size());
+        ReturnErrorOnFailure(CopyRange(oldFd, recordStart, entry.mRecordSize, newFd, newEnd));
+        newIndex.emplace(item.first, Entry{ newEnd + (entry.mValueOffset - recordStart), entry.mValueLength, entry.mRecordSize });
+        newEnd += entry.mRecordSize;
+    }
+    snapshot.clear();
+    VerifyOrReturnError(fdatasync(newFd) == 0, CHIP_ERROR_WRITE_FAILED);
+
+    // Records appended since the snapshot are copied as they are and replayed on top of the compacted ones. Do this under
+    // the lock, so that nothing is appended to the old log between the copy and the switch.
+    std::lock_guard<std::mutex> lock(mLock);
+
+    size_t newDeadBytes = 0;
+    off_t tailLength    = mEnd - copiedEnd;
+    off_t replayedEnd;
+    ReturnErrorOnFailure(CopyRange(oldFd, copiedEnd, tailLength, newFd, newEnd));
+    ReturnErrorOnFailure(Replay(newFd, newEnd, newEnd + tailLength, newIndex, newDeadBytes, replayedEnd));
+    VerifyOrReturnError(replayedEnd == newEnd + tailLength, CHIP_ERROR_INTERNAL);
+    VerifyOrReturnError(fdatasync(newFd) == 0, CHIP_ERROR_WRITE_FAILED);
+
+    if (rename(newPath.c_str(), mLogPath.c_str()) != 0)
+    {
+        ChipLogError(DeviceLayer, "failed to rename (%s), %s (%d)", newPath.c_str(), strerror(errno), errno);
+        return CHIP_ERROR_WRITE_FAILED;
+    }
+    SyncParentDirectory(mLogPath);
+
+    ChipLogProgress(DeviceLayer, "compacted kvs log (%s) from %lld to %lld bytes", mLogPath.c_str(),
+                    static_cast<long long>(mEnd), static_cast<long long>(replayedEnd));
+
+    close(mFd);
+    mFd = newFd;
+    mIndex.swap(newIndex);
+    mEnd       = replayedEnd;
+    mDeadBytes = newDeadBytes;
+    return CHIP_NO_ERROR;
+}
+
+void ChipLinuxStorageLog::CompactionThreadMain()
+{
+    std::unique_lock<std::mutex> lock(mLock);
+    while (!mShutdown)
+    {
+        mCompactionWanted.wait(lock, [this] { return mShutdown || NeedsCompaction(); });
+        if (mShutdown)
+        {
+            break;
+        }
+
+        lock.unlock();
+        CHIP_ERROR err = Compact();
+        lock.lock();
+
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(DeviceLayer, "kvs log compaction failed: %" CHIP_ERROR_FORMAT, err.Format());
+            // Do not spin on a persistent failure such as a full disk.
+            mCompactionWanted.wait_for(lock, kCompactionRetryDelay, [this] { return mShutdown; });
+        }
+    }
+}
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
@@ -0,0 +1,148 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *         This file defines a log-structured binary key-value store for the
+ *         Linux KeyValueStoreManager.
+ *
+ *         Every write appends one record to the log file and syncs it, so a
+ *         put costs one small write instead of rewriting the whole store as
+ *         ChipLinuxStorage::Commit() does. An in-memory index maps each key to
+ *         the location of its latest value. Superseded records are reclaimed
+ *         by compacting the log on a background thread.
+ *
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <sys/types.h>
+#include <thread>
+#include <unordered_map>
+
+#include <lib/core/CHIPError.h>
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+/**
+ * Append-only binary key-value store.
+ *
+ * Each record is a fixed header followed by the key and the value:
+ *
+ *     magic (4) | crc32 (4) | key length (2) | flags (2) | value length (4) | key | value
+ *
+ * all little-endian, with the CRC covering everything after itself. A record with the tombstone flag deletes the key.
+ *
+ * On Init() the log is replayed from the start to rebuild the index. Replay stops at the first record that is
+ * incomplete or fails its CRC. If that record is the last one in the file, or the rest of the file was never written,
+ * it is what a crash in the middle of an append leaves behind, and the file is truncated there so that later appends
+ * follow the last intact record. Anything else is corruption: Init() fails and leaves the file untouched.
+ *
+ * A file that is not a log, such as the INI file that ChipLinuxStorage kept at the same path, is migrated: its entries
+ * are written to a new log that then replaces it. Init() fails if the file is neither.
+ *
+ * Compaction writes the live records to a temporary file and renames it over the log, so a crash during compaction
+ * leaves either the old or the new log in place. It runs on a background thread once superseded records make up
+ * most of the log; writes and reads proceed while it runs and records appended meanwhile are carried over before the
+ * switch.
+ */
+class ChipLinuxStorageLog
+{
+public:
+    ChipLinuxStorageLog() = default;
+    ~ChipLinuxStorageLog();
+
+    ChipLinuxStorageLog(const ChipLinuxStorageLog &) = delete;
+    ChipLinuxStorageLog & operator=(const ChipLinuxStorageLog &) = delete;
+
+    CHIP_ERROR Init(const char * logFile);
+    void Shutdown();
+
+    /**
+     * Read up to bufSize bytes of the value of key, starting offset bytes in.
+     *
+     * @retval CHIP_ERROR_BUFFER_TOO_SMALL  buf was filled but more of the value remains; outLen is bufSize.
+     * @retval CHIP_ERROR_KEY_NOT_FOUND     key is not stored.
+     * @retval CHIP_ERROR_INVALID_ARGUMENT  offset is past the end of the value.
+     */
+    CHIP_ERROR ReadValueBin(const char * key, uint8_t * buf, size_t bufSize, size_t & outLen, size_t offset = 0);
+    CHIP_ERROR WriteValueBin(const char * key, const uint8_t * data, size_t dataLen);
+    CHIP_ERROR ClearValue(const char * key);
+    bool HasValue(const char * key);
+
+    /**
+     * Every write is durable once it returns, so there is nothing left to commit. Kept so the store can stand in for
+     * ChipLinuxStorage.
+     */
+    CHIP_ERROR Commit() { return CHIP_NO_ERROR; }
+
+    /**
+     * Compact the log now, on the calling thread.
+     */
+    CHIP_ERROR Compact();
+
+    size_t GetLogSize();
+    size_t GetDeadBytes();
+
+    // Compaction is started once at least this many bytes are superseded and they outnumber the live bytes.
+    static constexpr size_t kCompactionMinDeadBytes = 64 * 1024;
+
+private:
+    struct Entry
+    {
+        off_t mValueOffset;
+        uint32_t mValueLength;
+        uint32_t mRecordSize;
+    };
+    using Index = std::unordered_map<std::string, Entry>;
+
+    CHIP_ERROR Append(const char * key, const uint8_t * data, size_t dataLen, bool tombstone);
+    static CHIP_ERROR Replay(int fd, off_t start, off_t end, Index & index, size_t & deadBytes, off_t & validEnd);
+    static bool IsTornTail(int fd, off_t start, off_t end);
+    CHIP_ERROR MigrateIniFile(const char * logFile, int & outFd);
+    static CHIP_ERROR CopyRange(int fromFd, off_t from, off_t length, int toFd, off_t to);
+    CHIP_ERROR CompactInto(int newFd, const std::string & newPath);
+    bool NeedsCompaction() const;
+    void CompactionThreadMain();
+
+    std::string mLogPath;
+    int mFd = -1;
+    // End of the last intact record; the next record is appended here.
+    off_t mEnd = 0;
+    // Bytes taken by records that have been superseded, deleted or are themselves tombstones.
+    size_t mDeadBytes = 0;
+    Index mIndex;
+
+    // Guards everything above. Compaction only holds it while taking its snapshot and while switching files.
+    std::mutex mLock;
+    // Serializes compactions, whether started in the background or by Compact().
+    std::mutex mCompactionLock;
+    std::condition_variable mCompactionWanted;
+    std::thread mCompactionThread;
+    bool mShutdown = false;
+};
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
@@ -106,6 +106,14 @@ using CHIP_CONFIG_PERSISTED_STORAGE_KEY_TYPE = const char *;
 #define CHIP_CONFIG_BDX_MAX_NUM_TRANSFERS 1
 #endif // CHIP_CONFIG_BDX_MAX_NUM_TRANSFERS
 
+#ifndef CHIP_CONFIG_ACCESS_CONTROL_CACHE
+#define CHIP_CONFIG_ACCESS_CONTROL_CACHE 1
+#endif // CHIP_CONFIG_ACCESS_CONTROL_CACHE
+
+#ifndef CHIP_CONFIG_SECURE_SESSION_KEYED_CIPHERS
+#define CHIP_CONFIG_SECURE_SESSION_KEYED_CIPHERS 1
+#endif // CHIP_CONFIG_SECURE_SESSION_KEYED_CIPHERS
+
 // ==================== Security Configuration Overrides ====================
 
 #ifndef CHIP_CONFIG_MAX_APPLICATION_GROUPS
@@ -29,6 +29,7 @@
 #include <lib/support/CodeUtils.h>
 #include <lib/support/logging/CHIPLogging.h>
 #include <platform/Linux/CHIPLinuxStorage.h>
+#include <trace/trace.h>
 
 namespace chip {
 namespace DeviceLayer {
@@ -44,6 +45,24 @@ CHIP_ERROR KeyValueStoreManagerImpl::_Get(const char * key, void * value, size_t
     // Copy data into value buffer
     VerifyOrReturnError(value != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
 
+#if CHIP_DEVICE_CONFIG_LINUX_KVS_LOG
+    // The log store reads straight from the requested offset into the caller's buffer. Like the INI store below, a
+    // value that does not fit is returned truncated.
+    CHIP_ERROR err = mStorage.ReadValueBin(key, static_cast<uint8_t *>(value), value_size, read_size, offset_bytes);
+    if (err == CHIP_ERROR_KEY_NOT_FOUND)
+    {
+        return CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND;
+    }
+    else if ((err != CHIP_NO_ERROR) && (err != CHIP_ERROR_BUFFER_TOO_SMALL))
+    {
+        return err;
+    }
+    if (read_bytes_size != nullptr)
+    {
+        *read_bytes_size = read_size;
+    }
+    return CHIP_NO_ERROR;
+#else
     // On linux read first without a buffer which returns the size, and then
     // use a local buffer to read the entire object, which allows partial and
     // offset reads.
@@ -73,10 +92,12 @@ CHIP_ERROR KeyValueStoreManagerImpl::_Get(const char * key, void * value, size_t
     ::memcpy(value, buf.Get() + offset_bytes, copy_size);
 
     return CHIP_NO_ERROR;
+#endif // CHIP_DEVICE_CONFIG_LINUX_KVS_LOG
 }
 
 CHIP_ERROR KeyValueStoreManagerImpl::_Put(const char * key, const void * value, size_t value_size)
 {
+    TRACE_EVENT_SCOPE("Put", "KeyValueStoreManager");
     CHIP_ERROR err = CHIP_NO_ERROR;
 
     err = mStorage.WriteValueBin(key, reinterpret_cast<const uint8_t *>(value), value_size);
@@ -92,6 +113,7 @@ exit:
 
 CHIP_ERROR KeyValueStoreManagerImpl::_Delete(const char * key)
 {
+    TRACE_EVENT_SCOPE("Delete", "KeyValueStoreManager");
     CHIP_ERROR err = CHIP_NO_ERROR;
     err            = mStorage.ClearValue(key);
 
@@ -23,7 +23,9 @@
 
 #pragma once
 
+#include <platform/CHIPDeviceConfig.h>
 #include <platform/Linux/CHIPLinuxStorage.h>
+#include <platform/Linux/CHIPLinuxStorageLog.h>
 
 namespace chip {
 namespace DeviceLayer {
@@ -35,15 +37,21 @@ public:
     /**
      * @brief
      * Initalize the KVS, must be called before using.
+     *
+     * Fails if the file cannot be opened or holds a corrupt store.
      */
-    void Init(const char * file) { mStorage.Init(file); }
+    CHIP_ERROR Init(const char * file) { return mStorage.Init(file); }
 
     CHIP_ERROR _Get(const char * key, void * value, size_t value_size, size_t * read_bytes_size = nullptr, size_t offset = 0);
     CHIP_ERROR _Delete(const char * key);
     CHIP_ERROR _Put(const char * key, const void * value, size_t value_size);
 
 private:
+#if CHIP_DEVICE_CONFIG_LINUX_KVS_LOG
+    DeviceLayer::Internal::ChipLinuxStorageLog mStorage;
+#else
     DeviceLayer::Internal::ChipLinuxStorage mStorage;
+#endif
 
     // ===== Members for internal use by the following friends.
     friend KeyValueStoreManager & KeyValueStoreMgr();
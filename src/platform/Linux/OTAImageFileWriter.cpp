@@ -0,0 +1,389 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *         This file implements the writer that streams a downloaded OTA
+ *         image to a file for the Linux OTAImageProcessorImpl.
+ *
+ */
+
+#include <platform/Linux/OTAImageFileWriter.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+static_assert(OTAImageFileWriter::kBufferSize % OTAImageFileWriter::kAlignment == 0,
+              "Staging buffers must hold a whole number of O_DIRECT blocks");
+
+CHIP_ERROR OTAImageFileWriter::Open(const char * path)
+{
+    VerifyOrReturnError(path != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(mFd < 0, CHIP_ERROR_INCORRECT_STATE);
+    ReturnErrorOnFailure(mDigest.Begin());
+
+    void * buffers = nullptr;
+    VerifyOrReturnError(posix_memalign(&buffers, kAlignment, kNumBuffers * kBufferSize) == 0, CHIP_ERROR_NO_MEMORY);
+    mBuffers = static_cast<uint8_t *>(buffers);
+
+    // Not every file system supports O_DIRECT (tmpfs does not), in which case the payload goes through the page cache.
+    mFd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC | O_DIRECT, 0644);
+    if (mFd < 0 && errno == EINVAL)
+    {
+        mFd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    }
+    if (mFd < 0)
+    {
+        ChipLogError(SoftwareUpdate, "Cannot open %s: %s", path, strerror(errno));
+        free(mBuffers);
+        mBuffers = nullptr;
+        return CHIP_ERROR_OPEN_FAILED;
+    }
+
+    mPath = path;
+    mHeaderParser.Init();
+    mHeaderDecoded = false;
+    mHeaderSize    = 0;
+    mPayloadSize   = 0;
+    mFillIndex     = 0;
+    mFillSize      = 0;
+    mQueued        = 0;
+    mReserveSize   = 0;
+    mFinishing     = false;
+    mStopping      = false;
+    mWriteError    = CHIP_NO_ERROR;
+    mHandler       = nullptr;
+    mReadyHandler  = nullptr;
+
+    mWorker = std::thread(&OTAImageFileWriter::WorkerMain, this);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR OTAImageFileWriter::Write(ByteSpan block)
+{
+    VerifyOrReturnError(mFd >= 0 && !mFinishing, CHIP_ERROR_INCORRECT_STATE);
+
+    if (!mHeaderDecoded)
+    {
+        ReturnErrorOnFailure(DecodeHeader(block));
+        VerifyOrReturnError(mHeaderDecoded, CHIP_NO_ERROR);
+    }
+
+    VerifyOrReturnError(block.size() <= mHeader.mPayloadSize - mPayloadSize, CHIP_ERROR_INVALID_ARGUMENT);
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        ReturnErrorOnFailure(mWriteError);
+        VerifyOrReturnError(block.size() <= FreeSpace(), CHIP_ERROR_NO_MEMORY);
+    }
+    ReturnErrorOnFailure(mDigest.AddData(block));
+    mPayloadSize += block.size();
+
+    return Stage(block);
+}
+
+bool OTAImageFileWriter::IsReady(size_t blockSize, CompletionHandler handler, void * context)
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    if (blockSize <= FreeSpace() || mWriteError != CHIP_NO_ERROR)
+    {
+        return true;
+    }
+
+    mReadySize    = blockSize;
+    mReadyHandler = handler;
+    mReadyContext = context;
+    return false;
+}
+
+size_t OTAImageFileWriter::FreeSpace() const
+{
+    // The buffer being filled is never queued, except when every buffer is, in which case mFillSize is 0.
+    return (kNumBuffers - mQueued) * kBufferSize - mFillSize;
+}
+
+CHIP_ERROR OTAImageFileWriter::DecodeHeader(ByteSpan & block)
+{
+    const size_t blockSize = block.size();
+    CHIP_ERROR err         = mHeaderParser.AccumulateAndDecode(block, mHeader);
+
+    mHeaderSize += blockSize - block.size();
+    VerifyOrReturnError(err != CHIP_ERROR_BUFFER_TOO_SMALL, CHIP_NO_ERROR);
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(SoftwareUpdate, "Cannot decode the OTA image header: %" CHIP_ERROR_FORMAT, err.Format());
+        return CHIP_ERROR_INVALID_ARGUMENT;
+    }
+    if (mHeader.mImageDigestType != OTAImageDigestType::kSha256)
+    {
+        ChipLogError(SoftwareUpdate, "Unsupported OTA image digest type %u", static_cast<unsigned>(mHeader.mImageDigestType));
+        return CHIP_ERROR_NOT_IMPLEMENTED;
+    }
+
+    mHeaderDecoded = true;
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mReserveSize = mHeader.mPayloadSize;
+    }
+    mWakeWorker.notify_one();
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR OTAImageFileWriter::Stage(ByteSpan payload)
+{
+    // Write() checked that the payload fits, so the buffers filled here are not queued any more.
+    while (!payload.empty())
+    {
+        const size_t size = chip::min(payload.size(), kBufferSize - mFillSize);
+        memcpy(mBuffers + mFillIndex * kBufferSize + mFillSize, payload.data(), size);
+        payload = payload.SubSpan(size);
+
+        std::lock_guard<std::mutex> lock(mLock);
+        mFillSize += size;
+        if (mFillSize == kBufferSize)
+        {
+            // Hand the full buffer to the worker thread.
+            mQueued++;
+            mFillIndex = (mFillIndex + 1) % kNumBuffers;
+            mFillSize  = 0;
+            mWakeWorker.notify_one();
+        }
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR OTAImageFileWriter::VerifyPayload()
+{
+    uint8_t digest[Crypto::kSHA256_Hash_Length];
+    MutableByteSpan digestSpan(digest);
+
+    VerifyOrReturnError(mHeaderDecoded && mPayloadSize == mHeader.mPayloadSize, CHIP_ERROR_INVALID_MESSAGE_LENGTH);
+    ReturnErrorOnFailure(mDigest.Finish(digestSpan));
+    VerifyOrReturnError(digestSpan.data_equal(mHeader.mImageDigest), CHIP_ERROR_INTEGRITY_CHECK_FAILED);
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR OTAImageFileWriter::Finish(CompletionHandler handler, void * context)
+{
+    VerifyOrReturnError(mFd >= 0 && !mFinishing, CHIP_ERROR_INCORRECT_STATE);
+
+    CHIP_ERROR err = VerifyPayload();
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(SoftwareUpdate, "OTA image verification failed: %" CHIP_ERROR_FORMAT, err.Format());
+        Abort();
+        return err;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mFinishing      = true;
+        mHandler        = handler;
+        mHandlerContext = context;
+    }
+    mWakeWorker.notify_one();
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR OTAImageFileWriter::Close()
+{
+    VerifyOrReturnError(mFinishing, CHIP_ERROR_INCORRECT_STATE);
+
+    if (mWorker.joinable())
+    {
+        mWorker.join();
+    }
+
+    CHIP_ERROR err = mWriteError;
+    if (mFd >= 0)
+    {
+        if (close(mFd) != 0 && err == CHIP_NO_ERROR)
+        {
+            err = CHIP_ERROR_WRITE_FAILED;
+        }
+        mFd = -1;
+    }
+
+    free(mBuffers);
+    mBuffers = nullptr;
+    return err;
+}
+
+void OTAImageFileWriter::Abort()
+{
+    StopWorker();
+
+    if (mFd >= 0)
+    {
+        close(mFd);
+        mFd = -1;
+        unlink(mPath.c_str());
+    }
+
+    free(mBuffers);
+    mBuffers      = nullptr;
+    mReadyHandler = nullptr;
+    mHeaderParser.Clear();
+    mHeaderDecoded = false;
+    mDigest.Clear();
+}
+
+void OTAImageFileWriter::StopWorker()
+{
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mStopping = true;
+    }
+    mWakeWorker.notify_one();
+
+    if (mWorker.joinable())
+    {
+        mWorker.join();
+    }
+}
+
+void OTAImageFileWriter::WorkerMain()
+{
+    std::unique_lock<std::mutex> lock(mLock);
+    size_t writeIndex = 0;
+    off_t offset      = 0;
+
+    while (true)
+    {
+        mWakeWorker.wait(lock, [this] { return mStopping || mFinishing || mQueued > 0 || mReserveSize > 0; });
+        VerifyOrReturn(!mStopping);
+
+        if (mReserveSize > 0)
+        {
+            const off_t size = static_cast<off_t>(mReserveSize);
+            mReserveSize     = 0;
+            lock.unlock();
+            // Only an optimization: without it, the file grows as it is written.
+            if (fallocate(mFd, 0, 0, size) != 0)
+            {
+                ChipLogDetail(SoftwareUpdate, "Cannot preallocate the OTA image file: %s", strerror(errno));
+            }
+            lock.lock();
+            continue;
+        }
+
+        if (mQueued > 0)
+        {
+            // After a failure, the queued buffers are dropped so that Write() does not wait for them.
+            if (mWriteError == CHIP_NO_ERROR)
+            {
+                lock.unlock();
+                CHIP_ERROR err = WriteBuffer(mBuffers + writeIndex * kBufferSize, kBufferSize, offset);
+                lock.lock();
+                mWriteError = err;
+            }
+            writeIndex = (writeIndex + 1) % kNumBuffers;
+            offset += static_cast<off_t>(kBufferSize);
+            mQueued--;
+
+            // After a failure, the caller is let through so that its next Write() reports the error.
+            CompletionHandler readyHandler = mReadyHandler;
+            if (readyHandler != nullptr && (mReadySize <= FreeSpace() || mWriteError != CHIP_NO_ERROR))
+            {
+                void * readyContext = mReadyContext;
+                mReadyHandler       = nullptr;
+                lock.unlock();
+                readyHandler(readyContext);
+                lock.lock();
+            }
+            continue;
+        }
+
+        // Finishing, and every full buffer is written: what is left of the payload is in the buffer being filled.
+        if (mWriteError == CHIP_NO_ERROR)
+        {
+            const size_t tailSize = mFillSize;
+            lock.unlock();
+            CHIP_ERROR err = CompleteFile(offset, tailSize);
+            lock.lock();
+            mWriteError = err;
+        }
+
+        CompletionHandler handler = mHandler;
+        void * context            = mHandlerContext;
+        lock.unlock();
+        if (handler != nullptr)
+        {
+            handler(context);
+        }
+        return;
+    }
+}
+
+CHIP_ERROR OTAImageFileWriter::WriteBuffer(const uint8_t * data, size_t size, off_t offset)
+{
+    while (size > 0)
+    {
+        ssize_t n = pwrite(mFd, data, size, offset);
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n < 0 && errno == EINVAL && (fcntl(mFd, F_GETFL) & O_DIRECT) != 0)
+        {
+            // Some file systems accept O_DIRECT on open but not on write.
+            VerifyOrReturnError(fcntl(mFd, F_SETFL, fcntl(mFd, F_GETFL) & ~O_DIRECT) == 0, CHIP_ERROR_WRITE_FAILED);
+            continue;
+        }
+        if (n <= 0)
+        {
+            ChipLogError(SoftwareUpdate, "Cannot write the OTA image file: %s", strerror(errno));
+            return CHIP_ERROR_WRITE_FAILED;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+        offset += n;
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR OTAImageFileWriter::CompleteFile(off_t offset, size_t tailSize)
+{
+    if (tailSize > 0)
+    {
+        // O_DIRECT writes must cover whole blocks, so the tail is padded, and the padding cut off the file afterwards.
+        uint8_t * tail      = mBuffers + mFillIndex * kBufferSize;
+        const size_t padded = (tailSize + kAlignment - 1) / kAlignment * kAlignment;
+        memset(tail + tailSize, 0, padded - tailSize);
+        ReturnErrorOnFailure(WriteBuffer(tail, padded, offset));
+    }
+
+    VerifyOrReturnError(ftruncate(mFd, offset + static_cast<off_t>(tailSize)) == 0, CHIP_ERROR_WRITE_FAILED);
+    VerifyOrReturnError(fdatasync(mFd) == 0, CHIP_ERROR_WRITE_FAILED);
+    return CHIP_NO_ERROR;
+}
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
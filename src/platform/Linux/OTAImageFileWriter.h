@@ -0,0 +1,170 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *         This file defines the writer that streams a downloaded OTA image
+ *         to a file for the Linux OTAImageProcessorImpl.
+ *
+ *         The image header is decoded and the payload hashed as the blocks
+ *         arrive, on the calling thread, while the payload is written to
+ *         the file by a worker thread, so that a block can be acknowledged
+ *         as soon as it has been staged. Nothing waits for the disk on the
+ *         calling thread: once the staging buffers are full, the caller is
+ *         told when to send the next block instead.
+ *
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <sys/types.h>
+#include <thread>
+
+#include <crypto/CHIPCryptoPAL.h>
+#include <lib/core/CHIPError.h>
+#include <lib/core/OTAImageHeader.h>
+#include <lib/support/Span.h>
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+/**
+ * Writes the payload of an OTA image to a file as the image is downloaded.
+ *
+ * The payload is staged in kNumBuffers buffers of kBufferSize bytes, aligned for O_DIRECT, and each buffer is written by the
+ * worker thread once it is full. The file is opened with O_DIRECT where the file system supports it, so the image does not go
+ * through the page cache, and is preallocated to the payload size announced by the header.
+ *
+ * Write() never blocks: the caller asks IsReady() before requesting each block, and holds back the request until it is told
+ * that the worker thread has made room. Finish() checks the size and digest of the payload against the header, which is why
+ * the image never needs to be read back.
+ */
+class OTAImageFileWriter
+{
+public:
+    using CompletionHandler = void (*)(void * context);
+
+    static constexpr size_t kBufferSize = 256 * 1024;
+    static constexpr size_t kNumBuffers = 4;
+    static constexpr size_t kAlignment  = 4096;
+
+    OTAImageFileWriter() = default;
+    ~OTAImageFileWriter() { Abort(); }
+
+    OTAImageFileWriter(const OTAImageFileWriter &) = delete;
+    OTAImageFileWriter & operator=(const OTAImageFileWriter &) = delete;
+
+    /**
+     * Create or truncate the file at path and start the worker thread.
+     */
+    CHIP_ERROR Open(const char * path);
+
+    /**
+     * Consume the next block of the image.
+     *
+     * @retval CHIP_ERROR_INVALID_ARGUMENT  The header is malformed, or the image is longer than the header announced.
+     * @retval CHIP_ERROR_NO_MEMORY         The staging buffers have no room for the block; see IsReady().
+     * @retval CHIP_ERROR_NOT_IMPLEMENTED   The header announces a digest type other than SHA-256.
+     * @retval CHIP_ERROR_WRITE_FAILED      Writing the payload to the file failed.
+     */
+    CHIP_ERROR Write(ByteSpan block);
+
+    /**
+     * Returns whether a block of up to blockSize bytes can be written right away. If not, handler is called on the worker
+     * thread as soon as it can, unless Abort() is called first.
+     */
+    bool IsReady(size_t blockSize, CompletionHandler handler, void * context);
+
+    /**
+     * Verify the payload against the header, then have the worker thread write what is left of the payload and sync the file.
+     * handler is called on the worker thread once the file is complete, after which Close() returns the outcome of the writes.
+     * On failure to verify the payload, the file is removed, and handler is not called.
+     */
+    CHIP_ERROR Finish(CompletionHandler handler, void * context);
+
+    /**
+     * Wait for the worker thread and close the file. Returns the first error the worker thread ran into.
+     */
+    CHIP_ERROR Close();
+
+    /**
+     * Stop writing, and remove the file.
+     */
+    void Abort();
+
+    /**
+     * Returns the header of the image, or nullptr until it has been received. The header stays valid until the next call to
+     * Open() or Abort().
+     */
+    const OTAImageHeader * GetHeader() const { return mHeaderDecoded ? &mHeader : nullptr; }
+
+    /**
+     * Returns the size of the whole image, header included, or 0 until the header has been received.
+     */
+    uint64_t GetImageSize() const { return mHeaderDecoded ? mHeaderSize + mHeader.mPayloadSize : 0; }
+
+private:
+    CHIP_ERROR DecodeHeader(ByteSpan & block);
+    CHIP_ERROR Stage(ByteSpan payload);
+    size_t FreeSpace() const;
+    CHIP_ERROR VerifyPayload();
+
+    void WorkerMain();
+    CHIP_ERROR WriteBuffer(const uint8_t * data, size_t size, off_t offset);
+    CHIP_ERROR CompleteFile(off_t offset, size_t tailSize);
+    void StopWorker();
+
+    std::string mPath;
+    int mFd = -1;
+
+    OTAImageHeaderParser mHeaderParser;
+    OTAImageHeader mHeader;
+    bool mHeaderDecoded   = false;
+    uint64_t mHeaderSize  = 0;
+    uint64_t mPayloadSize = 0;
+    Crypto::Hash_SHA256_stream mDigest;
+
+    // Staging buffers, used as a ring: the calling thread fills mBuffers[mFillIndex] while the worker thread writes the
+    // mQueued buffers before it.
+    uint8_t * mBuffers = nullptr;
+    size_t mFillIndex  = 0;
+    size_t mFillSize   = 0;
+
+    // Guards the state shared with the worker thread below.
+    std::mutex mLock;
+    std::condition_variable mWakeWorker;
+    std::thread mWorker;
+    size_t mQueued                  = 0;
+    uint64_t mReserveSize           = 0;
+    bool mFinishing                 = false;
+    bool mStopping                  = false;
+    CHIP_ERROR mWriteError          = CHIP_NO_ERROR;
+    CompletionHandler mHandler      = nullptr;
+    void * mHandlerContext          = nullptr;
+    size_t mReadySize               = 0;
+    CompletionHandler mReadyHandler = nullptr;
+    void * mReadyContext            = nullptr;
+};
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
@@ -17,6 +17,7 @@
  */
 
 #include <app/clusters/ota-requestor/OTADownloader.h>
+#include <lib/support/TypeTraits.h>
 #include <platform/OTARequestorInterface.h>
 
 #include "OTAImageProcessorImpl.h"
@@ -61,9 +62,9 @@ CHIP_ERROR OTAImageProcessorImpl::Abort()
 
 CHIP_ERROR OTAImageProcessorImpl::ProcessBlock(ByteSpan & block)
 {
-    if (!mOfs.is_open() || !mOfs.good())
+    if (mState != ImageState::kDownloading)
     {
-        return CHIP_ERROR_INTERNAL;
+        return CHIP_ERROR_INCORRECT_STATE;
     }
 
     if ((block.data() == nullptr) || block.empty())
@@ -71,11 +72,23 @@ CHIP_ERROR OTAImageProcessorImpl::ProcessBlock(ByteSpan & block)
         return CHIP_ERROR_INVALID_ARGUMENT;
     }
 
-    // Store block data for HandleProcessBlock to access
-    CHIP_ERROR err = SetBlock(block);
-    if (err != CHIP_NO_ERROR)
+    // The writer is done with the block when Write() returns, so the block is not copied to be kept until HandleProcessBlock.
+    mBlockError = mWriter.Write(block);
+    if (mBlockError == CHIP_NO_ERROR)
     {
-        ChipLogError(SoftwareUpdate, "Cannot set block data: %" CHIP_ERROR_FORMAT, err.Format());
+        mParams.downloadedBytes += block.size();
+        if (mParams.totalFileBytes == 0 && mWriter.GetHeader() != nullptr)
+        {
+            SetHeader(*mWriter.GetHeader());
+            mParams.totalFileBytes = mWriter.GetImageSize();
+        }
+
+        // Blocks after this one are no larger. When the staging buffers are full, the next block is only requested once the
+        // writer has made room for it, which keeps the disk from holding up the CHIP thread.
+        if (!mWriter.IsReady(block.size(), OnWriterReady, this))
+        {
+            return CHIP_NO_ERROR;
+        }
     }
 
     DeviceLayer::PlatformMgr().ScheduleWork(HandleProcessBlock, reinterpret_cast<intptr_t>(this));
@@ -96,31 +109,67 @@ void OTAImageProcessorImpl::HandlePrepareDownload(intptr_t context)
         return;
     }
 
-    imageProcessor->mOfs.open(imageProcessor->mParams.imageFile.data(),
-                              std::ofstream::out | std::ofstream::ate | std::ofstream::app);
-    if (!imageProcessor->mOfs.good())
+    // Drop what is left of a previous download, if any.
+    imageProcessor->mWriter.Abort();
+    imageProcessor->mParams.downloadedBytes = 0;
+    imageProcessor->mParams.totalFileBytes  = 0;
+    imageProcessor->mApplyPending           = false;
+    imageProcessor->ClearHeader();
+
+    CHIP_ERROR err         = imageProcessor->mWriter.Open(imageProcessor->mParams.imageFile.data());
+    imageProcessor->mState = (err == CHIP_NO_ERROR) ? ImageState::kDownloading : ImageState::kIdle;
+    imageProcessor->mDownloader->OnPreparedForDownload(err);
+}
+
+void OTAImageProcessorImpl::HandleFinalize(intptr_t context)
+{
+    auto * imageProcessor = reinterpret_cast<OTAImageProcessorImpl *>(context);
+    if (imageProcessor == nullptr || imageProcessor->mState != ImageState::kDownloading)
+    {
+        return;
+    }
+
+    // The payload is verified against the header here; the worker thread of the writer then completes the file.
+    CHIP_ERROR err = imageProcessor->mWriter.Finish(OnImageFileWritten, imageProcessor);
+    if (err != CHIP_NO_ERROR)
     {
-        imageProcessor->mDownloader->OnPreparedForDownload(CHIP_ERROR_OPEN_FAILED);
+        ChipLogError(SoftwareUpdate, "OTA image rejected: %" CHIP_ERROR_FORMAT, err.Format());
+        imageProcessor->mState = ImageState::kInvalid;
         return;
     }
 
-    // TODO: if file already exists and is not empty, erase previous contents
+    imageProcessor->mState = ImageState::kFinalizing;
+}
 
-    imageProcessor->mDownloader->OnPreparedForDownload(CHIP_NO_ERROR);
+void OTAImageProcessorImpl::OnImageFileWritten(void * context)
+{
+    DeviceLayer::PlatformMgr().ScheduleWork(HandleImageFileWritten, reinterpret_cast<intptr_t>(context));
 }
 
-void OTAImageProcessorImpl::HandleFinalize(intptr_t context)
+void OTAImageProcessorImpl::HandleImageFileWritten(intptr_t context)
 {
     auto * imageProcessor = reinterpret_cast<OTAImageProcessorImpl *>(context);
-    if (imageProcessor == nullptr)
+    if (imageProcessor == nullptr || imageProcessor->mState != ImageState::kFinalizing)
     {
         return;
     }
 
-    imageProcessor->mOfs.close();
-    imageProcessor->ReleaseBlock();
+    CHIP_ERROR err = imageProcessor->mWriter.Close();
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(SoftwareUpdate, "Cannot write OTA image to %s: %" CHIP_ERROR_FORMAT, imageProcessor->mParams.imageFile.data(),
+                     err.Format());
+        imageProcessor->mState = ImageState::kInvalid;
+        return;
+    }
 
+    imageProcessor->mState = ImageState::kVerified;
     ChipLogProgress(SoftwareUpdate, "OTA image downloaded to %s", imageProcessor->mParams.imageFile.data());
+
+    if (imageProcessor->mApplyPending)
+    {
+        imageProcessor->ApplyImage();
+    }
 }
 
 void OTAImageProcessorImpl::HandleApply(intptr_t context)
@@ -131,10 +180,18 @@ void OTAImageProcessorImpl::HandleApply(intptr_t context)
         return;
     }
 
-    OTARequestorInterface * requestor = chip::GetRequestorInstance();
-    if (requestor != nullptr)
+    switch (imageProcessor->mState)
     {
-        requestor->NotifyUpdateApplied(imageProcessor->mHeader.softwareVersion);
+    case ImageState::kFinalizing:
+        // The image is verified, and will be applied as soon as the worker thread has written all of it.
+        imageProcessor->mApplyPending = true;
+        break;
+    case ImageState::kVerified:
+        imageProcessor->ApplyImage();
+        break;
+    default:
+        ChipLogError(SoftwareUpdate, "No verified OTA image to apply");
+        break;
     }
 }
 
@@ -146,9 +203,16 @@ void OTAImageProcessorImpl::HandleAbort(intptr_t context)
         return;
     }
 
-    imageProcessor->mOfs.close();
+    imageProcessor->mWriter.Abort();
     remove(imageProcessor->mParams.imageFile.data());
-    imageProcessor->ReleaseBlock();
+    imageProcessor->mState        = ImageState::kIdle;
+    imageProcessor->mApplyPending = false;
+    imageProcessor->ClearHeader();
+}
+
+void OTAImageProcessorImpl::OnWriterReady(void * context)
+{
+    DeviceLayer::PlatformMgr().ScheduleWork(HandleProcessBlock, reinterpret_cast<intptr_t>(context));
 }
 
 void OTAImageProcessorImpl::HandleProcessBlock(intptr_t context)
@@ -159,62 +223,62 @@ void OTAImageProcessorImpl::HandleProcessBlock(intptr_t context)
         ChipLogError(SoftwareUpdate, "ImageProcessor context is null");
         return;
     }
+    else if (imageProcessor->mState != ImageState::kDownloading)
+    {
+        // The download was aborted while the next block was held back.
+        return;
+    }
     else if (imageProcessor->mDownloader == nullptr)
     {
         ChipLogError(SoftwareUpdate, "mDownloader is null");
         return;
     }
 
-    // TODO: Process block header if any
-
-    if (!imageProcessor->mOfs.write(reinterpret_cast<const char *>(imageProcessor->mBlock.data()),
-                                    static_cast<std::streamsize>(imageProcessor->mBlock.size())))
+    if (imageProcessor->mBlockError != CHIP_NO_ERROR)
     {
-        imageProcessor->mDownloader->EndDownload(CHIP_ERROR_WRITE_FAILED);
+        imageProcessor->mDownloader->EndDownload(imageProcessor->mBlockError);
         return;
     }
 
-    imageProcessor->mParams.downloadedBytes += imageProcessor->mBlock.size();
     imageProcessor->mDownloader->FetchNextData();
 }
 
-CHIP_ERROR OTAImageProcessorImpl::SetBlock(ByteSpan & block)
+void OTAImageProcessorImpl::ApplyImage()
 {
-    if ((block.data() == nullptr) || block.empty())
-    {
-        return CHIP_NO_ERROR;
-    }
-
-    // Allocate memory for block data if it has not been done yet
-    if (mBlock.empty())
-    {
-        mBlock = MutableByteSpan(static_cast<uint8_t *>(chip::Platform::MemoryAlloc(block.size())), block.size());
-        if (mBlock.data() == nullptr)
-        {
-            return CHIP_ERROR_NO_MEMORY;
-        }
-    }
+    mApplyPending = false;
 
-    // Store the actual block data
-    CHIP_ERROR err = CopySpanToMutableSpan(block, mBlock);
-    if (err != CHIP_NO_ERROR)
+    OTARequestorInterface * requestor = chip::GetRequestorInstance();
+    if (requestor != nullptr)
     {
-        ChipLogError(SoftwareUpdate, "Cannot copy block data: %" CHIP_ERROR_FORMAT, err.Format());
-        return err;
+        requestor->NotifyUpdateApplied(mHeader.softwareVersion);
     }
-
-    return CHIP_NO_ERROR;
 }
 
-CHIP_ERROR OTAImageProcessorImpl::ReleaseBlock()
+void OTAImageProcessorImpl::SetHeader(const OTAImageHeader & header)
 {
-    if (mBlock.data() != nullptr)
-    {
-        chip::Platform::MemoryFree(mBlock.data());
-    }
+    // The spans of header point into the writer, so what they refer to is copied.
+    mSoftwareVersionString.assign(header.mSoftwareVersionString.data(), header.mSoftwareVersionString.size());
+    mReleaseNotesUrl.assign(header.mReleaseNotesURL.data(), header.mReleaseNotesURL.size());
+    mImageDigest.assign(header.mImageDigest.begin(), header.mImageDigest.end());
+
+    mHeader.vendorId                     = header.mVendorId;
+    mHeader.productId                    = header.mProductId;
+    mHeader.softwareVersion              = header.mSoftwareVersion;
+    mHeader.softwareVersionString        = CharSpan(mSoftwareVersionString.data(), mSoftwareVersionString.size());
+    mHeader.payloadSize                  = header.mPayloadSize;
+    mHeader.minApplicableSoftwareVersion = static_cast<uint16_t>(header.mMinApplicableVersion.ValueOr(0));
+    mHeader.maxApplicableSoftwareVersion = static_cast<uint16_t>(header.mMaxApplicableVersion.ValueOr(UINT16_MAX));
+    mHeader.releaseNotesUrl              = CharSpan(mReleaseNotesUrl.data(), mReleaseNotesUrl.size());
+    mHeader.imageDigestType              = to_underlying(header.mImageDigestType);
+    mHeader.imageDigest                  = ByteSpan(mImageDigest.data(), mImageDigest.size());
+}
 
-    mBlock = MutableByteSpan();
-    return CHIP_NO_ERROR;
+void OTAImageProcessorImpl::ClearHeader()
+{
+    mHeader = OTAImageProcessorHeader();
+    mSoftwareVersionString.clear();
+    mReleaseNotesUrl.clear();
+    mImageDigest.clear();
 }
 
 } // namespace chip
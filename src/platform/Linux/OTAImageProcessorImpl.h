@@ -18,14 +18,20 @@
 
 #pragma once
 
+#include <string>
+#include <vector>
+
 #include <app/clusters/ota-requestor/OTADownloader.h>
 #include <platform/CHIPDeviceLayer.h>
+#include <platform/Linux/OTAImageFileWriter.h>
 #include <platform/OTAImageProcessor.h>
 
-#include <fstream>
-
 namespace chip {
 
+/**
+ * Streams the payload of the downloaded image to mParams.imageFile. The image header is decoded and the payload hashed as the
+ * blocks arrive, so the image is verified as soon as its last block is received (see DeviceLayer::Internal::OTAImageFileWriter).
+ */
 class OTAImageProcessorImpl : public OTAImageProcessorInterface
 {
 public:
@@ -39,6 +45,15 @@ public:
     void SetOTADownloader(OTADownloader * downloader) { mDownloader = downloader; }
 
 private:
+    enum class ImageState : uint8_t
+    {
+        kIdle,
+        kDownloading,
+        kFinalizing,
+        kVerified,
+        kInvalid,
+    };
+
     //////////// Actual handlers for the OTAImageProcessorInterface ///////////////
     static void HandlePrepareDownload(intptr_t context);
     static void HandleFinalize(intptr_t context);
@@ -47,18 +62,30 @@ private:
     static void HandleProcessBlock(intptr_t context);
 
     /**
-     * Called to allocate memory for mBlock if necessary and set it to block
+     * Called on the writer thread once the image file is complete, to finish finalizing on the CHIP thread.
      */
-    CHIP_ERROR SetBlock(ByteSpan & block);
+    static void OnImageFileWritten(void * context);
+    static void HandleImageFileWritten(intptr_t context);
 
     /**
-     * Called to release allocated memory for mBlock
+     * Called on the writer thread once it has room for the next block, to request it on the CHIP thread.
      */
-    CHIP_ERROR ReleaseBlock();
+    static void OnWriterReady(void * context);
+
+    void ApplyImage();
+    void SetHeader(const OTAImageHeader & header);
+    void ClearHeader();
+
+    DeviceLayer::Internal::OTAImageFileWriter mWriter;
+    ImageState mState           = ImageState::kIdle;
+    CHIP_ERROR mBlockError      = CHIP_NO_ERROR;
+    bool mApplyPending          = false;
+    OTADownloader * mDownloader = nullptr;
 
-    std::ofstream mOfs;
-    MutableByteSpan mBlock;
-    OTADownloader * mDownloader;
+    // Copies of the variable-length fields of mHeader, which the writer only keeps until the next download or Abort().
+    std::string mSoftwareVersionString;
+    std::string mReleaseNotesUrl;
+    std::vector<uint8_t> mImageDigest;
 };
 
 } // namespace chip
@@ -56,3 +56,4 @@ struct ChipDeviceEvent;
 #endif // CHIP_SYSTEM_CONFIG_NUM_TIMERS
 
 #define CHIP_CONFIG_MDNS_CACHE_SIZE 4
+#define CHIP_CONFIG_MINMDNS_RECORD_CACHE_SIZE 4
@@ -39,3 +39,4 @@ struct ChipDeviceEvent;
 
 // ========== Platform-specific Configuration Overrides =========
 #define CHIP_CONFIG_MDNS_CACHE_SIZE 4
+#define CHIP_CONFIG_MINMDNS_RECORD_CACHE_SIZE 4
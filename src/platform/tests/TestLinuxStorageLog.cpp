@@ -0,0 +1,420 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a unit test suite for the Linux log-structured
+ *      key-value store, including a put/get latency comparison with the INI
+ *      store at increasing numbers of keys.
+ *
+ */
+
+#include <chrono>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/UnitTestRegistration.h>
+#include <nlunit-test.h>
+
+#include <platform/Linux/CHIPLinuxStorage.h>
+#include <platform/Linux/CHIPLinuxStorageLog.h>
+
+using namespace chip;
+using namespace chip::DeviceLayer::Internal;
+
+namespace {
+
+struct TestContext
+{
+    char mDir[64];
+    std::string mLogPath;
+};
+
+std::string KeyName(size_t index)
+{
+    char key[32];
+    snprintf(key, sizeof(key), "key-%zu", index);
+    return key;
+}
+
+bool ReadEquals(ChipLinuxStorageLog & store, const char * key, const char * expected)
+{
+    uint8_t buf[64];
+    size_t len = 0;
+    return store.ReadValueBin(key, buf, sizeof(buf), len) == CHIP_NO_ERROR && len == strlen(expected) &&
+        memcmp(buf, expected, len) == 0;
+}
+
+CHIP_ERROR Write(ChipLinuxStorageLog & store, const char * key, const char * value)
+{
+    return store.WriteValueBin(key, reinterpret_cast<const uint8_t *>(value), strlen(value));
+}
+
+off_t FileSize(const std::string & path)
+{
+    struct stat st;
+    return (stat(path.c_str(), &st) == 0) ? st.st_size : -1;
+}
+
+void TestPutGetDelete(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(inContext);
+    ChipLinuxStorageLog store;
+    uint8_t buf[8];
+    size_t len;
+
+    NL_TEST_ASSERT(inSuite, store.Init(ctx.mLogPath.c_str()) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, store.ReadValueBin("a", buf, sizeof(buf), len) == CHIP_ERROR_KEY_NOT_FOUND);
+    NL_TEST_ASSERT(inSuite, store.ClearValue("a") == CHIP_ERROR_KEY_NOT_FOUND);
+
+    NL_TEST_ASSERT(inSuite, Write(store, "a", "first") == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, Write(store, "b", "") == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, ReadEquals(store, "a", "first"));
+    NL_TEST_ASSERT(inSuite, ReadEquals(store, "b", ""));
+
+    NL_TEST_ASSERT(inSuite, Write(store, "a", "second value") == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, ReadEquals(store, "a", "second value"));
+
+    // Partial and offset reads.
+    NL_TEST_ASSERT(inSuite, store.ReadValueBin("a", buf, 6, len) == CHIP_ERROR_BUFFER_TOO_SMALL && len == 6);
+    NL_TEST_ASSERT(inSuite, memcmp(buf, "second", 6) == 0);
+    NL_TEST_ASSERT(inSuite, store.ReadValueBin("a", buf, sizeof(buf), len, 7) == CHIP_NO_ERROR && len == 5);
+    NL_TEST_ASSERT(inSuite, memcmp(buf, "value", 5) == 0);
+    NL_TEST_ASSERT(inSuite, store.ReadValueBin("a", buf, sizeof(buf), len, 13) == CHIP_ERROR_INVALID_ARGUMENT);
+
+    NL_TEST_ASSERT(inSuite, store.ClearValue("a") == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, !store.HasValue("a"));
+    NL_TEST_ASSERT(inSuite, store.HasValue("b"));
+
+    store.Shutdown();
+    unlink(ctx.mLogPath.c_str());
+}
+
+void TestReplay(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(inContext);
+    ChipLinuxStorageLog store;
+
+    NL_TEST_ASSERT(inSuite, store.Init(ctx.mLogPath.c_str()) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, Write(store, "a", "1") == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, Write(store, "b", "2") == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, Write(store, "a", "3") == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, store.ClearValue("b") == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, Write(store, "c", "4") == CHIP_NO_ERROR);
+    size_t logSize   = store.GetLogSize();
+    size_t deadBytes = store.GetDeadBytes();
+    store.Shutdown();
+
+    NL_TEST_ASSERT(inSuite, store.Init(ctx.mLogPath.c_str()) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, ReadEquals(store, "a", "3"));
+    NL_TEST_ASSERT(inSuite, !store.HasValue("b"));
+    NL_TEST_ASSERT(inSuite, ReadEquals(store, "c", "4"));
+    NL_TEST_ASSERT(inSuite, store.GetLogSize() == logSize);
+    NL_TEST_ASSERT(inSuite, store.GetDeadBytes() == deadBytes);
+
+    store.Shutdown();
+    unlink(ctx.mLogPath.c_str());
+}
+
+void TestTornTail(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(inContext);
+    ChipLinuxStorageLog store;
+
+    NL_TEST_ASSERT(inSuite, store.Init(ctx.mLogPath.c_str()) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, Write(store, "a", "kept") == CHIP_NO_ERROR);
+    size_t intactSize = store.GetLogSize();
+    NL_TEST_ASSERT(inSuite, Write(store, "b", "torn") == CHIP_NO_ERROR);
+    store.Shutdown();
+
+    // Cut the last record short, as a crash in the middle of its append would.
+    NL_TEST_ASSERT(inSuite, truncate(ctx.mLogPath.c_str(), static_cast<off_t>(FileSize(ctx.mLogPath) - 2)) == 0);
+
+    NL_TEST_ASSERT(inSuite, store.Init(ctx.mLogPath.c_str()) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, ReadEquals(store, "a", "kept"));
+    NL_TEST_ASSERT(inSuite, !store.HasValue("b"));
+    NL_TEST_ASSERT(inSuite, store.GetLogSize() == intactSize);
+    NL_TEST_ASSERT(inSuite, FileSize(ctx.mLogPath) == static_cast<off_t>(intactSize));
+
+    // Later appends follow the last intact record and survive the next replay.
+    NL_TEST_ASSERT(inSuite, Write(store, "b", "again") == CHIP_NO_ERROR);
+    store.Shutdown();
+    NL_TEST_ASSERT(inSuite, store.Init(ctx.mLogPath.c_str()) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, ReadEquals(store, "b", "again"));
+    store.Shutdown();
+
+    // A record whose bytes were not all written fails its CRC and is dropped as well.
+    int fd = open(ctx.mLogPath.c_str(), O_WRONLY);
+    NL_TEST_ASSERT(inSuite, fd >= 0);
+    NL_TEST_ASSERT(inSuite, pwrite(fd, "X", 1, FileSize(ctx.mLogPath) - 1) == 1);
+    close(fd);
+
+    NL_TEST_ASSERT(inSuite, store.Init(ctx.mLogPath.c_str()) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, ReadEquals(store, "a", "kept"));
+    NL_TEST_ASSERT(inSuite, !store.HasValue("b"));
+
+    store.Shutdown();
+    unlink(ctx.mLogPath.c_str());
+}
+
+void TestCorruptRecord(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(inContext);
+    ChipLinuxStorageLog store;
+
+    NL_TEST_ASSERT(inSuite, store.Init(ctx.mLogPath.c_str()) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, Write(store, "a", "first") == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, Write(store, "b", "second") == CHIP_NO_ERROR);
+    store.Shutdown();
+
+    // Damage the first record: the one behind it was written in full, so this is not a torn append.
+    off_t size = FileSize(ctx.mLogPath);
+    int fd     = open(ctx.mLogPath.c_str(), O_WRONLY);
+    NL_TEST_ASSERT(inSuite, fd >= 0);
+    NL_TEST_ASSERT(inSuite, pwrite(fd, "X", 1, 17) == 1);
+    close(fd);
+
+    NL_TEST_ASSERT(inSuite, store.Init(ctx.mLogPath.c_str()) == CHIP_ERROR_INTEGRITY_CHECK_FAILED);
+    NL_TEST_ASSERT(inSuite, FileSize(ctx.mLogPath) == size);
+
+    unlink(ctx.mLogPath.c_str());
+}
+
+void TestIniMigration(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(inContext);
+
+    {
+        ChipLinuxStorage ini;
+        NL_TEST_ASSERT(inSuite, ini.Init(ctx.mLogPath.c_str()) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, ini.WriteValueBin("a", reinterpret_cast<const uint8_t *>("alpha"), 5) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, ini.WriteValueBin("b", reinterpret_cast<const uint8_t *>("beta"), 4) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, ini.Commit() == CHIP_NO_ERROR);
+    }
+
+    // An INI file left at the same path by an older build is carried over rather than replayed as a broken log.
+    ChipLinuxStorageLog store;
+    NL_TEST_ASSERT(inSuite, store.Init(ctx.mLogPath.c_str()) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, ReadEquals(store, "a", "alpha"));
+    NL_TEST_ASSERT(inSuite, ReadEquals(store, "b", "beta"));
+    NL_TEST_ASSERT(inSuite, Write(store, "c", "gamma") == CHIP_NO_ERROR);
+    store.Shutdown();
+
+    NL_TEST_ASSERT(inSuite, store.Init(ctx.mLogPath.c_str()) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, ReadEquals(store, "a", "alpha"));
+    NL_TEST_ASSERT(inSuite, ReadEquals(store, "c", "gamma"));
+    store.Shutdown();
+    unlink(ctx.mLogPath.c_str());
+
+    // A file that is neither is left alone.
+    FILE * file = fopen(ctx.mLogPath.c_str(), "w");
+    NL_TEST_ASSERT(inSuite, file != nullptr);
+    fputs("not a kvs file\n", file);
+    fclose(file);
+    NL_TEST_ASSERT(inSuite, store.Init(ctx.mLogPath.c_str()) == CHIP_ERROR_INTEGRITY_CHECK_FAILED);
+    NL_TEST_ASSERT(inSuite, FileSize(ctx.mLogPath) == static_cast<off_t>(strlen("not a kvs file\n")));
+
+    unlink(ctx.mLogPath.c_str());
+}
+
+void TestCompaction(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(inContext);
+    ChipLinuxStorageLog store;
+    char value[32];
+
+    NL_TEST_ASSERT(inSuite, store.Init(ctx.mLogPath.c_str()) == CHIP_NO_ERROR);
+    for (size_t round = 0; round < 4; round++)
+    {
+        for (size_t i = 0; i < 16; i++)
+        {
+            snprintf(value, sizeof(value), "value-%zu-%zu", i, round);
+            NL_TEST_ASSERT(inSuite, Write(store, KeyName(i).c_str(), value) == CHIP_NO_ERROR);
+        }
+    }
+    NL_TEST_ASSERT(inSuite, store.ClearValue(KeyName(0).c_str()) == CHIP_NO_ERROR);
+
+    size_t before = store.GetLogSize();
+    NL_TEST_ASSERT(inSuite, store.Compact() == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, store.GetDeadBytes() == 0);
+    NL_TEST_ASSERT(inSuite, store.GetLogSize() < before / 3);
+    NL_TEST_ASSERT(inSuite, FileSize(ctx.mLogPath) == static_cast<off_t>(store.GetLogSize()));
+
+    // Appends after compaction go to the new log, and all of it replays.
+    NL_TEST_ASSERT(inSuite, Write(store, KeyName(1).c_str(), "after") == CHIP_NO_ERROR);
+    store.Shutdown();
+    NL_TEST_ASSERT(inSuite, store.Init(ctx.mLogPath.c_str()) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, !store.HasValue(KeyName(0).c_str()));
+    NL_TEST_ASSERT(inSuite, ReadEquals(store, KeyName(1).c_str(), "after"));
+    for (size_t i = 2; i < 16; i++)
+    {
+        snprintf(value, sizeof(value), "value-%zu-3", i);
+        NL_TEST_ASSERT(inSuite, ReadEquals(store, KeyName(i).c_str(), value));
+    }
+
+    store.Shutdown();
+    unlink(ctx.mLogPath.c_str());
+}
+
+void TestBackgroundCompaction(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(inContext);
+    ChipLinuxStorageLog store;
+    uint8_t value[1024];
+
+    // Overwrite a few keys until superseded records far outweigh the live ones.
+    NL_TEST_ASSERT(inSuite, store.Init(ctx.mLogPath.c_str()) == CHIP_NO_ERROR);
+    size_t written = 0;
+    for (uint8_t round = 0; written < 4 * ChipLinuxStorageLog::kCompactionMinDeadBytes; round++)
+    {
+        memset(value, round, sizeof(value));
+        for (size_t i = 0; i < 4; i++)
+        {
+            NL_TEST_ASSERT(inSuite, store.WriteValueBin(KeyName(i).c_str(), value, sizeof(value)) == CHIP_NO_ERROR);
+            written += sizeof(value);
+        }
+    }
+
+    for (int i = 0; i < 200 && store.GetLogSize() >= written / 2; i++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    NL_TEST_ASSERT(inSuite, store.GetLogSize() < written / 2);
+
+    size_t len = 0;
+    NL_TEST_ASSERT(inSuite, store.ReadValueBin(KeyName(3).c_str(), value, sizeof(value), len) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, len == sizeof(value) && value[0] == value[sizeof(value) - 1]);
+
+    store.Shutdown();
+    unlink(ctx.mLogPath.c_str());
+}
+
+/**
+ * Put and get latency of the INI store (ChipLinuxStorage, which rewrites the whole file on every commit) and of the log
+ * store, each holding @a keyCount keys.
+ */
+template <typename Store>
+void MeasureLatency(nlTestSuite * inSuite, const char * name, Store & store, size_t keyCount)
+{
+    constexpr size_t kOperations = 100;
+    uint8_t value[64];
+    size_t len;
+    memset(value, 0x5A, sizeof(value));
+
+    for (size_t i = 0; i < keyCount; i++)
+    {
+        NL_TEST_ASSERT(inSuite, store.WriteValueBin(KeyName(i).c_str(), value, sizeof(value)) == CHIP_NO_ERROR);
+    }
+    NL_TEST_ASSERT(inSuite, store.Commit() == CHIP_NO_ERROR);
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t n = 0; n < kOperations; n++)
+    {
+        value[0] = static_cast<uint8_t>(n);
+        NL_TEST_ASSERT(inSuite, store.WriteValueBin(KeyName((n * 7919) % keyCount).c_str(), value, sizeof(value)) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, store.Commit() == CHIP_NO_ERROR);
+    }
+    auto putTime = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (size_t n = 0; n < kOperations; n++)
+    {
+        NL_TEST_ASSERT(inSuite, store.ReadValueBin(KeyName((n * 104729) % keyCount).c_str(), value, sizeof(value), len) ==
+                           CHIP_NO_ERROR);
+    }
+    auto getTime = std::chrono::steady_clock::now() - start;
+
+    printf("KVS %s: %zu keys: put %.1f us, get %.1f us\n", name, keyCount,
+           std::chrono::duration<double, std::micro>(putTime).count() / kOperations,
+           std::chrono::duration<double, std::micro>(getTime).count() / kOperations);
+}
+
+void TestLatencyBenchmark(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(inContext);
+
+    static constexpr size_t kKeyCounts[] = { 10, 1000, 10000 };
+    for (size_t keyCount : kKeyCounts)
+    {
+        {
+            ChipLinuxStorage ini;
+            NL_TEST_ASSERT(inSuite, ini.Init((ctx.mLogPath + ".ini").c_str()) == CHIP_NO_ERROR);
+            MeasureLatency(inSuite, "ini", ini, keyCount);
+            unlink((ctx.mLogPath + ".ini").c_str());
+        }
+        {
+            ChipLinuxStorageLog log;
+            NL_TEST_ASSERT(inSuite, log.Init(ctx.mLogPath.c_str()) == CHIP_NO_ERROR);
+            MeasureLatency(inSuite, "log", log, keyCount);
+            log.Shutdown();
+            unlink(ctx.mLogPath.c_str());
+        }
+    }
+}
+
+const nlTest sTests[] = {
+    NL_TEST_DEF("Test put, get and delete", TestPutGetDelete),
+    NL_TEST_DEF("Test replay", TestReplay),
+    NL_TEST_DEF("Test torn tail", TestTornTail),
+    NL_TEST_DEF("Test corrupt record", TestCorruptRecord),
+    NL_TEST_DEF("Test INI migration", TestIniMigration),
+    NL_TEST_DEF("Test compaction", TestCompaction),
+    NL_TEST_DEF("Test background compaction", TestBackgroundCompaction),
+    NL_TEST_DEF("Test latency benchmark", TestLatencyBenchmark),
+    NL_TEST_SENTINEL(),
+};
+
+int TestSetup(void * inContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(inContext);
+
+    VerifyOrReturnError(chip::Platform::MemoryInit() == CHIP_NO_ERROR, FAILURE);
+    strcpy(ctx.mDir, "/tmp/chip-kvs-log-XXXXXX");
+    VerifyOrReturnError(mkdtemp(ctx.mDir) != nullptr, FAILURE);
+    ctx.mLogPath = std::string(ctx.mDir) + "/store";
+    return SUCCESS;
+}
+
+int TestTeardown(void * inContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(inContext);
+
+    rmdir(ctx.mDir);
+    chip::Platform::MemoryShutdown();
+    return SUCCESS;
+}
+
+} // namespace
+
+int TestLinuxStorageLog()
+{
+    TestContext context;
+    nlTestSuite theSuite = { "Linux KVS log tests", &sTests[0], TestSetup, TestTeardown };
+
+    nlTestRunner(&theSuite, &context);
+    return nlTestRunnerStats(&theSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestLinuxStorageLog)
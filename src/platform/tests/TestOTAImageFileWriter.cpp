@@ -0,0 +1,330 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a unit test suite for the Linux OTA image file
+ *      writer, including a benchmark of streaming a 16 MB image against
+ *      writing it through an ofstream and hashing it afterwards.
+ *
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <future>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include <crypto/CHIPCryptoPAL.h>
+#include <lib/core/CHIPEncoding.h>
+#include <lib/core/CHIPTLV.h>
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/UnitTestRegistration.h>
+#include <nlunit-test.h>
+
+#include <platform/Linux/OTAImageFileWriter.h>
+
+using namespace chip;
+using namespace chip::DeviceLayer::Internal;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t kBlockSize = 1024;
+
+struct TestContext
+{
+    char mDir[64];
+    std::string mImagePath;
+};
+
+/**
+ * An OTA image with a payload of @a payloadSize bytes, whose header carries the SHA-256 digest of the payload.
+ */
+struct TestImage
+{
+    TestImage(size_t payloadSize)
+    {
+        std::vector<uint8_t> payload(payloadSize);
+        for (size_t i = 0; i < payloadSize; i++)
+        {
+            payload[i] = static_cast<uint8_t>((i * 31) ^ (i >> 8));
+        }
+
+        uint8_t digest[Crypto::kSHA256_Hash_Length];
+        VerifyOrDie(Crypto::Hash_SHA256(payload.data(), payload.size(), digest) == CHIP_NO_ERROR);
+
+        uint8_t tlv[128];
+        TLV::TLVWriter writer;
+        TLV::TLVType outerType;
+        writer.Init(tlv);
+        VerifyOrDie(writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, outerType) == CHIP_NO_ERROR);
+        VerifyOrDie(writer.Put(TLV::ContextTag(0), static_cast<uint16_t>(0xFFF1)) == CHIP_NO_ERROR);
+        VerifyOrDie(writer.Put(TLV::ContextTag(1), static_cast<uint16_t>(0x8001)) == CHIP_NO_ERROR);
+        VerifyOrDie(writer.Put(TLV::ContextTag(2), static_cast<uint32_t>(2)) == CHIP_NO_ERROR);
+        VerifyOrDie(writer.PutString(TLV::ContextTag(3), "2.0") == CHIP_NO_ERROR);
+        VerifyOrDie(writer.Put(TLV::ContextTag(4), static_cast<uint64_t>(payloadSize)) == CHIP_NO_ERROR);
+        VerifyOrDie(writer.Put(TLV::ContextTag(8), static_cast<uint8_t>(OTAImageDigestType::kSha256)) == CHIP_NO_ERROR);
+        VerifyOrDie(writer.Put(TLV::ContextTag(9), ByteSpan(digest)) == CHIP_NO_ERROR);
+        VerifyOrDie(writer.EndContainer(outerType) == CHIP_NO_ERROR);
+
+        const uint32_t tlvSize = writer.GetLengthWritten();
+        mHeaderSize            = OTAImageHeaderParser::kFixedHeaderSize + tlvSize;
+        mData.resize(mHeaderSize);
+        Encoding::LittleEndian::Put32(&mData[0], OTAImageHeaderParser::kMagic);
+        Encoding::LittleEndian::Put64(&mData[4], mHeaderSize + payloadSize);
+        Encoding::LittleEndian::Put32(&mData[12], tlvSize);
+        memcpy(&mData[OTAImageHeaderParser::kFixedHeaderSize], tlv, tlvSize);
+        mData.insert(mData.end(), payload.begin(), payload.end());
+    }
+
+    ByteSpan GetPayload() const { return ByteSpan(&mData[mHeaderSize], mData.size() - mHeaderSize); }
+
+    std::vector<uint8_t> mData;
+    size_t mHeaderSize;
+};
+
+// Feed data to writer in blocks of blockSize bytes, as the BDX downloader would, holding back each block until the writer is
+// ready for it.
+CHIP_ERROR WriteInBlocks(OTAImageFileWriter & writer, const std::vector<uint8_t> & data, size_t blockSize)
+{
+    for (size_t offset = 0; offset < data.size(); offset += blockSize)
+    {
+        std::promise<void> ready;
+        if (!writer.IsReady(blockSize, [](void * context) { static_cast<std::promise<void> *>(context)->set_value(); }, &ready))
+        {
+            ready.get_future().wait();
+        }
+        ReturnErrorOnFailure(writer.Write(ByteSpan(&data[offset], std::min(blockSize, data.size() - offset))));
+    }
+    return CHIP_NO_ERROR;
+}
+
+// Finish writing, and wait for the worker thread to complete the file.
+CHIP_ERROR FinishAndClose(OTAImageFileWriter & writer)
+{
+    std::promise<void> written;
+    ReturnErrorOnFailure(writer.Finish([](void * context) { static_cast<std::promise<void> *>(context)->set_value(); }, &written));
+    written.get_future().wait();
+    return writer.Close();
+}
+
+std::vector<uint8_t> ReadFile(const std::string & path)
+{
+    std::ifstream file(path, std::ifstream::binary | std::ifstream::ate);
+    std::vector<uint8_t> contents(static_cast<size_t>(std::max<std::streamoff>(file.tellg(), 0)));
+    file.seekg(0);
+    file.read(reinterpret_cast<char *>(contents.data()), static_cast<std::streamsize>(contents.size()));
+    return contents;
+}
+
+void TestStreamImage(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(inContext);
+
+    // Payload sizes that end exactly on, and in the middle of, a staging buffer, with blocks that do not divide them.
+    for (size_t payloadSize : { 2 * OTAImageFileWriter::kBufferSize, 5 * OTAImageFileWriter::kBufferSize + 4097 })
+    {
+        TestImage image(payloadSize);
+        OTAImageFileWriter writer;
+
+        NL_TEST_ASSERT(inSuite, writer.Open(ctx.mImagePath.c_str()) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, writer.GetHeader() == nullptr);
+        NL_TEST_ASSERT(inSuite, WriteInBlocks(writer, image.mData, 1000) == CHIP_NO_ERROR);
+
+        const OTAImageHeader * header = writer.GetHeader();
+        NL_TEST_ASSERT(inSuite, header != nullptr);
+        NL_TEST_ASSERT(inSuite, header != nullptr && header->mSoftwareVersion == 2 && header->mPayloadSize == payloadSize);
+        NL_TEST_ASSERT(inSuite, writer.GetImageSize() == image.mData.size());
+        NL_TEST_ASSERT(inSuite, FinishAndClose(writer) == CHIP_NO_ERROR);
+
+        std::vector<uint8_t> contents = ReadFile(ctx.mImagePath);
+        NL_TEST_ASSERT(inSuite, image.GetPayload().data_equal(ByteSpan(contents.data(), contents.size())));
+        unlink(ctx.mImagePath.c_str());
+    }
+}
+
+void TestHoldBackBlocks(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(inContext);
+    constexpr size_t kStagingSize = OTAImageFileWriter::kNumBuffers * OTAImageFileWriter::kBufferSize;
+    TestImage image(4 * kStagingSize);
+    OTAImageFileWriter writer;
+
+    // A block larger than the staging buffers can never be written; Write() refuses it rather than wait for the disk.
+    NL_TEST_ASSERT(inSuite, writer.Open(ctx.mImagePath.c_str()) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, writer.Write(ByteSpan(image.mData.data(), image.mHeaderSize)) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, writer.Write(image.GetPayload().SubSpan(0, kStagingSize + 1)) == CHIP_ERROR_NO_MEMORY);
+    writer.Abort();
+
+    // Large blocks fill the staging buffers quickly, so most of them are held back until the writer makes room.
+    NL_TEST_ASSERT(inSuite, writer.Open(ctx.mImagePath.c_str()) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, WriteInBlocks(writer, image.mData, 64 * 1024) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, FinishAndClose(writer) == CHIP_NO_ERROR);
+
+    std::vector<uint8_t> contents = ReadFile(ctx.mImagePath);
+    NL_TEST_ASSERT(inSuite, image.GetPayload().data_equal(ByteSpan(contents.data(), contents.size())));
+    unlink(ctx.mImagePath.c_str());
+}
+
+void TestRejectImage(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(inContext);
+    TestImage image(OTAImageFileWriter::kBufferSize + 100);
+
+    // A payload that does not match the digest of the header.
+    {
+        OTAImageFileWriter writer;
+        std::vector<uint8_t> data = image.mData;
+        data.back() ^= 0xFF;
+
+        NL_TEST_ASSERT(inSuite, writer.Open(ctx.mImagePath.c_str()) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, WriteInBlocks(writer, data, kBlockSize) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, writer.Finish(nullptr, nullptr) == CHIP_ERROR_INTEGRITY_CHECK_FAILED);
+        NL_TEST_ASSERT(inSuite, access(ctx.mImagePath.c_str(), F_OK) != 0);
+    }
+
+    // A payload shorter, then longer than the header announces.
+    {
+        OTAImageFileWriter writer;
+        std::vector<uint8_t> data(image.mData.begin(), image.mData.end() - 1);
+
+        NL_TEST_ASSERT(inSuite, writer.Open(ctx.mImagePath.c_str()) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, WriteInBlocks(writer, data, kBlockSize) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, writer.Finish(nullptr, nullptr) == CHIP_ERROR_INVALID_MESSAGE_LENGTH);
+
+        data = image.mData;
+        data.push_back(0);
+        NL_TEST_ASSERT(inSuite, writer.Open(ctx.mImagePath.c_str()) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, WriteInBlocks(writer, data, kBlockSize) == CHIP_ERROR_INVALID_ARGUMENT);
+        writer.Abort();
+        NL_TEST_ASSERT(inSuite, access(ctx.mImagePath.c_str(), F_OK) != 0);
+    }
+
+    // Not an OTA image.
+    {
+        OTAImageFileWriter writer;
+        std::vector<uint8_t> data = image.mData;
+        data[0] ^= 0xFF;
+
+        NL_TEST_ASSERT(inSuite, writer.Open(ctx.mImagePath.c_str()) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, WriteInBlocks(writer, data, kBlockSize) == CHIP_ERROR_INVALID_ARGUMENT);
+    }
+}
+
+/**
+ * Download a 16 MB image in 1 KB blocks, through the writer, and as the OTA image processor used to: copying each block, appending
+ * it to an ofstream, and then reading the file back to hash it. The time from the last block to a verified image is what Apply()
+ * waits for.
+ */
+void TestThroughputBenchmark(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(inContext);
+    TestImage image(16 * 1024 * 1024);
+    const double imageMB = static_cast<double>(image.mData.size()) / (1024 * 1024);
+
+    {
+        OTAImageFileWriter writer;
+        auto start = Clock::now();
+        NL_TEST_ASSERT(inSuite, writer.Open(ctx.mImagePath.c_str()) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, WriteInBlocks(writer, image.mData, kBlockSize) == CHIP_NO_ERROR);
+        auto lastBlock = Clock::now();
+        NL_TEST_ASSERT(inSuite, FinishAndClose(writer) == CHIP_NO_ERROR);
+        auto verified = Clock::now();
+
+        printf("OTA image streamed: %.1f MB/s, verified %.1f ms after the last block\n",
+               imageMB / std::chrono::duration<double>(verified - start).count(),
+               std::chrono::duration<double, std::milli>(verified - lastBlock).count());
+        unlink(ctx.mImagePath.c_str());
+    }
+
+    {
+        std::vector<uint8_t> block(kBlockSize);
+        auto start = Clock::now();
+        std::ofstream ofs(ctx.mImagePath, std::ofstream::out | std::ofstream::binary);
+        for (size_t offset = 0; offset < image.mData.size(); offset += kBlockSize)
+        {
+            const size_t size = std::min(kBlockSize, image.mData.size() - offset);
+            memcpy(block.data(), &image.mData[offset], size);
+            ofs.write(reinterpret_cast<const char *>(block.data()), static_cast<std::streamsize>(size));
+        }
+        ofs.close();
+        auto lastBlock = Clock::now();
+
+        std::vector<uint8_t> contents = ReadFile(ctx.mImagePath);
+        uint8_t digest[Crypto::kSHA256_Hash_Length];
+        NL_TEST_ASSERT(inSuite, contents.size() == image.mData.size());
+        NL_TEST_ASSERT(inSuite,
+                       Crypto::Hash_SHA256(&contents[image.mHeaderSize], contents.size() - image.mHeaderSize, digest) ==
+                           CHIP_NO_ERROR);
+        auto verified = Clock::now();
+
+        printf("OTA image through ofstream: %.1f MB/s, verified %.1f ms after the last block\n",
+               imageMB / std::chrono::duration<double>(verified - start).count(),
+               std::chrono::duration<double, std::milli>(verified - lastBlock).count());
+        unlink(ctx.mImagePath.c_str());
+    }
+}
+
+const nlTest sTests[] = {
+    NL_TEST_DEF("Test stream image", TestStreamImage),
+    NL_TEST_DEF("Test hold back blocks", TestHoldBackBlocks),
+    NL_TEST_DEF("Test reject image", TestRejectImage),
+    NL_TEST_DEF("Test throughput benchmark", TestThroughputBenchmark),
+    NL_TEST_SENTINEL(),
+};
+
+int TestSetup(void * inContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(inContext);
+
+    VerifyOrReturnError(chip::Platform::MemoryInit() == CHIP_NO_ERROR, FAILURE);
+    strcpy(ctx.mDir, "/tmp/chip-ota-image-XXXXXX");
+    VerifyOrReturnError(mkdtemp(ctx.mDir) != nullptr, FAILURE);
+    ctx.mImagePath = std::string(ctx.mDir) + "/image.bin";
+    return SUCCESS;
+}
+
+int TestTeardown(void * inContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(inContext);
+
+    unlink(ctx.mImagePath.c_str());
+    rmdir(ctx.mDir);
+    chip::Platform::MemoryShutdown();
+    return SUCCESS;
+}
+
+} // namespace
+
+int TestOTAImageFileWriter()
+{
+    TestContext context;
+    nlTestSuite theSuite = { "Linux OTA image file writer tests", &sTests[0], TestSetup, TestTeardown };
+
+    nlTestRunner(&theSuite, &context);
+    return nlTestRunnerStats(&theSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestOTAImageFileWriter)
@@ -36,6 +36,13 @@
 
 #include <platform/CHIPDeviceLayer.h>
 
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#endif
+
 using namespace chip;
 using namespace chip::Logging;
 using namespace chip::Inet;
@@ -147,6 +154,109 @@ static void TestPlatformMgr_RunEventLoopStopBeforeSleep(nlTestSuite * inSuite, v
     NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
 }
 
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+static constexpr uint32_t kOverflowPosts = 3 * CHIP_DEVICE_CONFIG_POSIX_EVENT_QUEUE_SIZE;
+static uint32_t sNextOverflowPost;
+static bool sOverflowPostsInOrder;
+
+static void CheckOverflowPost(intptr_t arg)
+{
+    sOverflowPostsInOrder = sOverflowPostsInOrder && (static_cast<uint32_t>(arg) == sNextOverflowPost);
+    sNextOverflowPost++;
+}
+
+static void TestPlatformMgr_ScheduleWorkOverflow(nlTestSuite * inSuite, void * inContext)
+{
+    sNextOverflowPost     = 0;
+    sOverflowPostsInOrder = true;
+    stopRan               = false;
+
+    CHIP_ERROR err = PlatformMgr().InitChipStack();
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    // The event loop is not running yet, so all but the first CHIP_DEVICE_CONFIG_POSIX_EVENT_QUEUE_SIZE of these spill over.
+    for (uint32_t i = 0; i < kOverflowPosts; i++)
+    {
+        PlatformMgr().ScheduleWork(CheckOverflowPost, static_cast<intptr_t>(i));
+    }
+    PlatformMgr().ScheduleWork(StopTheLoop);
+
+    PlatformMgr().RunEventLoop();
+    NL_TEST_ASSERT(inSuite, stopRan);
+    NL_TEST_ASSERT(inSuite, sNextOverflowPost == kOverflowPosts);
+    NL_TEST_ASSERT(inSuite, sOverflowPostsInOrder);
+
+    err = PlatformMgr().Shutdown();
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+}
+
+static constexpr uint32_t kPostsPerRun = 160000;
+static std::atomic<uint32_t> sWorkDone;
+static std::atomic<uint32_t> sWorkInFlight;
+
+static void CountWork(intptr_t)
+{
+    sWorkInFlight.fetch_sub(1, std::memory_order_relaxed);
+    sWorkDone.fetch_add(1, std::memory_order_relaxed);
+}
+
+static void TestPlatformMgr_ScheduleWorkThroughput(nlTestSuite * inSuite, void * inContext)
+{
+    // Keep the producers from filling the event queue, so that this measures it rather than the queue events spill over to.
+    constexpr uint32_t kMaxWorkInFlight = CHIP_DEVICE_CONFIG_POSIX_EVENT_QUEUE_SIZE / 2;
+
+    CHIP_ERROR err = PlatformMgr().InitChipStack();
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    err = PlatformMgr().StartEventLoopTask();
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    for (uint32_t producerCount : { 1, 4, 16 })
+    {
+        std::vector<std::thread> producers;
+        sWorkDone     = 0;
+        sWorkInFlight = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < producerCount; i++)
+        {
+            producers.emplace_back([producerCount] {
+                for (uint32_t n = 0; n < kPostsPerRun / producerCount; n++)
+                {
+                    while (sWorkInFlight.fetch_add(1, std::memory_order_relaxed) >= kMaxWorkInFlight)
+                    {
+                        sWorkInFlight.fetch_sub(1, std::memory_order_relaxed);
+                        std::this_thread::yield();
+                    }
+                    PlatformMgr().ScheduleWork(CountWork);
+                }
+            });
+        }
+
+        for (auto & producer : producers)
+        {
+            producer.join();
+        }
+
+        auto deadline = start + std::chrono::seconds(60);
+        while (sWorkDone.load(std::memory_order_relaxed) < kPostsPerRun && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::yield();
+        }
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        NL_TEST_ASSERT(inSuite, sWorkDone == kPostsPerRun);
+        printf("%u producer(s): %u posts in %.3f s, %.0f posts/s\n", producerCount, kPostsPerRun, elapsed, kPostsPerRun / elapsed);
+    }
+
+    err = PlatformMgr().StopEventLoopTask();
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    err = PlatformMgr().Shutdown();
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+}
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+
 static void TestPlatformMgr_TryLockChipStack(nlTestSuite * inSuite, void * inContext)
 {
     bool locked = PlatformMgr().TryLockChipStack();
@@ -222,6 +332,10 @@ static const nlTest sTests[] = {
     NL_TEST_DEF("Test basic PlatformMgr::RunEventLoop", TestPlatformMgr_BasicRunEventLoop),
     NL_TEST_DEF("Test PlatformMgr::RunEventLoop with two tasks", TestPlatformMgr_RunEventLoopTwoTasks),
     NL_TEST_DEF("Test PlatformMgr::RunEventLoop with stop before sleep", TestPlatformMgr_RunEventLoopStopBeforeSleep),
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+    NL_TEST_DEF("Test PlatformMgr::ScheduleWork with a full event queue", TestPlatformMgr_ScheduleWorkOverflow),
+    NL_TEST_DEF("Test PlatformMgr::ScheduleWork throughput", TestPlatformMgr_ScheduleWorkThroughput),
+#endif
     NL_TEST_DEF("Test PlatformMgr::TryLockChipStack", TestPlatformMgr_TryLockChipStack),
     NL_TEST_DEF("Test PlatformMgr::AddEventHandler", TestPlatformMgr_AddEventHandler),
     NL_TEST_DEF("Test mock System::Layer", TestPlatformMgr_MockSystemLayer),
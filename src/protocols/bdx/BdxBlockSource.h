@@ -0,0 +1,88 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines the BlockSource interface, through which a BDX Sender reads the data it transfers, and a BlockSource over
+ *      data held in memory.
+ */
+
+#pragma once
+
+#include <lib/core/CHIPError.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/Span.h>
+
+#include <stdint.h>
+
+namespace chip {
+namespace bdx {
+
+/**
+ * The data sent by a BDX Sender, read one Block at a time.
+ *
+ * A Sender knows which Blocks it will be asked for next, all the more with a window of Blocks in flight (see
+ * TransferSession::SetWindowSize()). It passes them to Prefetch(), so that a source backed by slow storage can start loading them
+ * in the background while the current Block is on its way.
+ */
+class BlockSource
+{
+public:
+    virtual ~BlockSource() = default;
+
+    /**
+     * Returns the number of bytes of data.
+     */
+    virtual uint64_t GetLength() const = 0;
+
+    /**
+     * Get up to maxLength bytes of data, starting at offset. The block is only shorter than maxLength at the end of the data. It
+     * stays valid until the next call to ReadBlock(), or until the source is closed.
+     */
+    virtual CHIP_ERROR ReadBlock(uint64_t offset, size_t maxLength, ByteSpan & block) = 0;
+
+    /**
+     * Hint that the data in [offset, offset + length) is about to be read. Must not wait for the data to be loaded.
+     */
+    virtual void Prefetch(uint64_t offset, uint64_t length) {}
+};
+
+/**
+ * A BlockSource over a buffer that outlives it.
+ */
+class MemoryBlockSource : public BlockSource
+{
+public:
+    MemoryBlockSource(ByteSpan data) : mData(data) {}
+
+    uint64_t GetLength() const override { return mData.size(); }
+
+    CHIP_ERROR ReadBlock(uint64_t offset, size_t maxLength, ByteSpan & block) override
+    {
+        VerifyOrReturnError(offset <= mData.size(), CHIP_ERROR_INVALID_ARGUMENT);
+
+        const size_t start = static_cast<size_t>(offset);
+        block              = mData.SubSpan(start, ::chip::min(maxLength, mData.size() - start));
+        return CHIP_NO_ERROR;
+    }
+
+private:
+    ByteSpan mData;
+};
+
+} // namespace bdx
+} // namespace chip
@@ -0,0 +1,373 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <protocols/bdx/BdxSenderPool.h>
+
+#include <lib/support/BufferWriter.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/TypeTraits.h>
+#include <lib/support/logging/CHIPLogging.h>
+#include <messaging/ExchangeContext.h>
+#include <protocols/Protocols.h>
+#include <protocols/secure_channel/Constants.h>
+#include <protocols/secure_channel/StatusReport.h>
+#include <transport/raw/MessageHeader.h>
+
+#include <inttypes.h>
+
+namespace chip {
+namespace bdx {
+
+void PooledSender::OnResponseTimeout(Messaging::ExchangeContext * ec)
+{
+    ChipLogError(BDX, "%s, ec: " ChipLogFormatExchange, __FUNCTION__, ChipLogValueExchange(ec));
+
+    // The exchange closes itself once this returns.
+    mExchangeCtx = nullptr;
+    Finish(CHIP_ERROR_TIMEOUT);
+}
+
+void PooledSender::OnExchangeClosing(Messaging::ExchangeContext * ec)
+{
+    // The exchange is closed from under the transfer, e.g. because its session went away.
+    VerifyOrReturn(ec == mExchangeCtx);
+    mExchangeCtx = nullptr;
+    Finish(CHIP_ERROR_CONNECTION_ABORTED);
+}
+
+void PooledSender::HandleTransferSessionOutput(TransferSession::OutputEvent & event)
+{
+    switch (event.EventType)
+    {
+    case TransferSession::OutputEventType::kNone:
+        break;
+    case TransferSession::OutputEventType::kMsgToSend: {
+        Messaging::SendFlags sendFlags;
+        Messaging::ExchangeContext * ec = mExchangeCtx;
+        const bool isStatusReport       = event.msgTypeData.HasMessageType(Protocols::SecureChannel::MsgType::StatusReport);
+
+        VerifyOrReturn(ec != nullptr, ChipLogError(BDX, "%s: mExchangeCtx is null", __FUNCTION__));
+        if (!isStatusReport && !ec->IsResponseExpected())
+        {
+            sendFlags.Set(Messaging::SendMessageFlags::kExpectResponse);
+        }
+
+        CHIP_ERROR err =
+            ec->SendMessage(event.msgTypeData.ProtocolId, event.msgTypeData.MessageType, std::move(event.MsgData), sendFlags);
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(BDX, "SendMessage failed: %" CHIP_ERROR_FORMAT, err.Format());
+            Finish(err);
+        }
+        else if (isStatusReport)
+        {
+            // The Sender only sends a StatusReport to end the transfer on an error. The exchange closes itself once a message that
+            // expects no response is sent, unless it still waits for the response to a Block.
+            mExchangeCtx = nullptr;
+            if (ec->IsResponseExpected())
+            {
+                ec->Close();
+            }
+            Finish(CHIP_ERROR_INTERNAL);
+        }
+        break;
+    }
+    case TransferSession::OutputEventType::kInitReceived:
+        HandleInitReceived(event.transferInitData);
+        break;
+    case TransferSession::OutputEventType::kQueryReceived:
+        HandleQueryReceived();
+        break;
+    case TransferSession::OutputEventType::kAckReceived:
+        break;
+    case TransferSession::OutputEventType::kAckEOFReceived:
+        Finish(CHIP_NO_ERROR);
+        break;
+    case TransferSession::OutputEventType::kStatusReceived:
+        ChipLogError(BDX, "Got StatusReport %x", static_cast<uint16_t>(event.statusData.statusCode));
+        Finish(CHIP_ERROR_CONNECTION_ABORTED);
+        break;
+    case TransferSession::OutputEventType::kInternalError:
+        Finish(CHIP_ERROR_INTERNAL);
+        break;
+    case TransferSession::OutputEventType::kTransferTimeout:
+        Finish(CHIP_ERROR_TIMEOUT);
+        break;
+    default:
+        // TransferSession should prevent this case from happening.
+        ChipLogError(BDX, "%s: unsupported event type", __FUNCTION__);
+    }
+}
+
+void PooledSender::HandleInitReceived(const TransferSession::TransferInitData & initData)
+{
+    mSource = mPool.mDelegate->AcquireBlockSource(ByteSpan(initData.FileDesignator, initData.FileDesLength));
+    if (mSource == nullptr)
+    {
+        ChipLogError(BDX, "Unknown file designator %.*s", static_cast<int>(initData.FileDesLength),
+                     reinterpret_cast<const char *>(initData.FileDesignator));
+        mTransfer.AbortTransfer(StatusCode::kFileDesignatorUnknown);
+        return;
+    }
+
+    const uint64_t sourceLength = mSource->GetLength();
+    mOffset                     = mTransfer.GetStartOffset();
+    if (mOffset > sourceLength)
+    {
+        mTransfer.AbortTransfer(StatusCode::kStartOffsetNotSupported);
+        return;
+    }
+
+    mMetrics.bytesTotal = sourceLength - mOffset;
+    if (mTransfer.GetTransferLength() > 0 && mTransfer.GetTransferLength() < mMetrics.bytesTotal)
+    {
+        mMetrics.bytesTotal = mTransfer.GetTransferLength();
+    }
+
+    // MRP only allows one unacknowledged message per exchange, so only offer a window of Blocks on sessions that do not use it.
+    if (mExchangeCtx != nullptr && !mExchangeCtx->GetSessionHandle()->RequireMRP())
+    {
+        mTransfer.SetWindowSize(CHIP_CONFIG_BDX_MAX_WINDOW_SIZE);
+    }
+
+    TransferSession::TransferAcceptData acceptData;
+    acceptData.ControlMode  = TransferControlFlags::kReceiverDrive;
+    acceptData.MaxBlockSize = mTransfer.GetTransferBlockSize();
+    acceptData.StartOffset  = mTransfer.GetStartOffset();
+    acceptData.Length       = mTransfer.GetTransferLength();
+
+    CHIP_ERROR err = mTransfer.AcceptTransfer(acceptData);
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(BDX, "%s: %" CHIP_ERROR_FORMAT, __FUNCTION__, err.Format());
+        Finish(err);
+    }
+}
+
+void PooledSender::HandleQueryReceived()
+{
+    TransferSession::BlockData blockData;
+    ByteSpan block;
+    const uint16_t blockSize = mTransfer.GetTransferBlockSize();
+    const uint64_t remaining = mMetrics.bytesTotal - mMetrics.bytesSent;
+
+    CHIP_ERROR err = mSource->ReadBlock(mOffset, static_cast<size_t>(chip::min<uint64_t>(blockSize, remaining)), block);
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(BDX, "%s: read failed: %" CHIP_ERROR_FORMAT, __FUNCTION__, err.Format());
+        mTransfer.AbortTransfer(StatusCode::kUnknown);
+        return;
+    }
+
+    // Start loading the Blocks the Receiver will query next while this one is being sent.
+    mSource->Prefetch(mOffset + block.size(), static_cast<uint64_t>(mTransfer.GetWindowSize()) * blockSize);
+
+    blockData.Data   = block.data();
+    blockData.Length = block.size();
+    blockData.IsEof  = (block.size() < blockSize) || (mMetrics.bytesSent + block.size() == mMetrics.bytesTotal);
+
+    err = mTransfer.PrepareBlock(blockData);
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(BDX, "%s: PrepareBlock failed: %" CHIP_ERROR_FORMAT, __FUNCTION__, err.Format());
+        Finish(err);
+        return;
+    }
+
+    mOffset += block.size();
+    mMetrics.bytesSent += block.size();
+    mMetrics.blocksSent++;
+    mMetrics.lastBlockTime = System::SystemClock().GetMonotonicTimestamp();
+}
+
+void PooledSender::Finish(CHIP_ERROR result)
+{
+    VerifyOrReturn(!mFinished);
+    mFinished = true;
+
+    mTransfer.Reset();
+    if (mExchangeCtx != nullptr)
+    {
+        // Clear mExchangeCtx first, so that OnExchangeClosing() ignores the closing.
+        Messaging::ExchangeContext * ec = mExchangeCtx;
+        mExchangeCtx                    = nullptr;
+        ec->Close();
+    }
+
+    mPool.OnSenderFinished(*this, result);
+}
+
+CHIP_ERROR SenderPool::Init(System::Layer * systemLayer, Messaging::ExchangeManager * exchangeMgr, Delegate * delegate,
+                            const SenderPoolParams & params)
+{
+    VerifyOrReturnError(mDelegate == nullptr, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(systemLayer != nullptr && exchangeMgr != nullptr && delegate != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    ReturnErrorOnFailure(exchangeMgr->RegisterUnsolicitedMessageHandlerForProtocol(Protocols::BDX::Id, this));
+
+    mSystemLayer = systemLayer;
+    mExchangeMgr = exchangeMgr;
+    mDelegate    = delegate;
+    mParams      = params;
+    mStats       = SenderPoolStats();
+
+    return CHIP_NO_ERROR;
+}
+
+void SenderPool::Shutdown()
+{
+    VerifyOrReturn(mDelegate != nullptr);
+
+    mExchangeMgr->UnregisterUnsolicitedMessageHandlerForProtocol(Protocols::BDX::Id);
+    // Without an exchange manager, OnSenderFinished() leaves the senders aborted below to the ReleaseAll() that follows.
+    mExchangeMgr = nullptr;
+
+    mSenders.ForEachActiveObject([this](PooledSender * sender) {
+        sender->Finish(CHIP_ERROR_CONNECTION_ABORTED);
+        mSystemLayer->CancelTimer(PooledSender::PollTimerHandler, sender);
+        return Loop::Continue;
+    });
+    mSenders.ReleaseAll();
+    mSystemLayer->CancelTimer(ReleaseFinishedSenders, this);
+
+    mSystemLayer = nullptr;
+    mDelegate    = nullptr;
+}
+
+size_t SenderPool::GetTransferCapacity() const
+{
+    size_t capacity = CHIP_CONFIG_BDX_MAX_CONCURRENT_SENDERS;
+
+    if (mParams.maxBytesPerSecond > 0 && mParams.minBytesPerSecondPerTransfer > 0)
+    {
+        capacity = chip::min<size_t>(capacity, mParams.maxBytesPerSecond / mParams.minBytesPerSecondPerTransfer);
+    }
+
+    return capacity;
+}
+
+CHIP_ERROR SenderPool::OnMessageReceived(Messaging::ExchangeContext * ec, const PayloadHeader & payloadHeader,
+                                         System::PacketBufferHandle && payload)
+{
+    // Only the first message of a transfer reaches the pool: the exchange is then handed over to a PooledSender.
+    if (!CanAdmitTransfer())
+    {
+        ChipLogProgress(BDX, "Rejecting transfer, %u transfers in progress", static_cast<unsigned>(mSenders.Allocated()));
+        mStats.transfersRejected++;
+        RejectTransfer(ec);
+        return CHIP_NO_ERROR;
+    }
+
+    PooledSender * sender = mSenders.CreateObject(*this);
+    VerifyOrReturnError(sender != nullptr, CHIP_ERROR_NO_MEMORY);
+
+    BitFlags<TransferControlFlags> flags(TransferControlFlags::kReceiverDrive);
+    CHIP_ERROR err = sender->PrepareForTransfer(mSystemLayer, TransferRole::kSender, flags, mParams.maxBlockSize, mParams.timeout,
+                                                mParams.pollFreq);
+    if (err != CHIP_NO_ERROR)
+    {
+        mSystemLayer->CancelTimer(PooledSender::PollTimerHandler, sender);
+        mSenders.ReleaseObject(sender);
+        return err;
+    }
+
+    sender->mMetrics.peerNodeId = ec->GetSessionHandle()->GetSubjectDescriptor().subject;
+    sender->mMetrics.startTime  = System::SystemClock().GetMonotonicTimestamp();
+
+    ec->SetDelegate(sender);
+    return static_cast<Messaging::ExchangeDelegate *>(sender)->OnMessageReceived(ec, payloadHeader, std::move(payload));
+}
+
+void SenderPool::RejectTransfer(Messaging::ExchangeContext * ec)
+{
+    Protocols::SecureChannel::StatusReport report(Protocols::SecureChannel::GeneralStatusCode::kBusy,
+                                                  Protocols::BDX::Id.ToFullyQualifiedSpecForm(),
+                                                  to_underlying(StatusCode::kTransferFailedUnknownError));
+    size_t msgSize = report.Size();
+    Encoding::LittleEndian::PacketBufferWriter bbuf(MessagePacketBuffer::New(msgSize), msgSize);
+    VerifyOrReturn(!bbuf.IsNull());
+
+    report.WriteToBuffer(bbuf);
+    System::PacketBufferHandle msg = bbuf.Finalize();
+    VerifyOrReturn(!msg.IsNull());
+
+    CHIP_ERROR err = ec->SendMessage(Protocols::SecureChannel::MsgType::StatusReport, std::move(msg));
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(BDX, "Failed to reject transfer: %" CHIP_ERROR_FORMAT, err.Format());
+    }
+}
+
+void SenderPool::OnSenderFinished(PooledSender & sender, CHIP_ERROR result)
+{
+    const TransferMetrics & metrics = sender.GetMetrics();
+
+    if (result == CHIP_NO_ERROR)
+    {
+        mStats.transfersCompleted++;
+    }
+    else
+    {
+        mStats.transfersFailed++;
+    }
+    mStats.bytesSent += metrics.bytesSent;
+
+    ChipLogProgress(BDX, "Transfer to " ChipLogFormatX64 " done: %" PRIu64 "/%" PRIu64 " bytes, %" CHIP_ERROR_FORMAT,
+                    ChipLogValueX64(metrics.peerNodeId), metrics.bytesSent, metrics.bytesTotal, result.Format());
+
+    if (sender.mSource != nullptr)
+    {
+        mDelegate->ReleaseBlockSource(sender.mSource);
+        sender.mSource = nullptr;
+    }
+    mDelegate->OnTransferFinished(metrics, result);
+    VerifyOrReturn(mExchangeMgr != nullptr);
+
+    // The sender may be in the middle of polling its TransferSession: free it once that is over.
+    CHIP_ERROR err = mSystemLayer->ScheduleWork(ReleaseFinishedSenders, this);
+    if (err != CHIP_NO_ERROR)
+    {
+        // Rather than leave the sender taking up a place in the pool for good, free it now.
+        ChipLogError(BDX, "Failed to schedule the release of a transfer: %" CHIP_ERROR_FORMAT, err.Format());
+        ReleaseSender(sender);
+    }
+}
+
+void SenderPool::ReleaseSender(PooledSender & sender)
+{
+    mSystemLayer->CancelTimer(PooledSender::PollTimerHandler, &sender);
+    mSenders.ReleaseObject(&sender);
+}
+
+void SenderPool::ReleaseFinishedSenders(System::Layer * systemLayer, void * appState)
+{
+    SenderPool * pool = static_cast<SenderPool *>(appState);
+
+    // Shutdown() cannot cancel the work on every system layer, and has released all the senders already.
+    VerifyOrReturn(pool->mSystemLayer != nullptr);
+
+    pool->mSenders.ForEachActiveObject([pool](PooledSender * sender) {
+        if (sender->mFinished)
+        {
+            pool->ReleaseSender(*sender);
+        }
+        return Loop::Continue;
+    });
+}
+
+} // namespace bdx
+} // namespace chip
@@ -0,0 +1,207 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines SenderPool, which serves concurrent Receiver-driven BDX transfers, each on its own exchange, from
+ *      BlockSources shared between the transfers.
+ */
+
+#pragma once
+
+#include <lib/core/CHIPError.h>
+#include <lib/core/NodeId.h>
+#include <lib/support/Pool.h>
+#include <lib/support/Span.h>
+#include <messaging/ExchangeDelegate.h>
+#include <messaging/ExchangeMgr.h>
+#include <protocols/bdx/BdxBlockSource.h>
+#include <protocols/bdx/TransferFacilitator.h>
+#include <system/SystemClock.h>
+#include <system/SystemLayer.h>
+
+/**
+ * CHIP_CONFIG_BDX_MAX_CONCURRENT_SENDERS
+ *
+ * The number of transfers a SenderPool serves at the same time.
+ */
+#ifndef CHIP_CONFIG_BDX_MAX_CONCURRENT_SENDERS
+#define CHIP_CONFIG_BDX_MAX_CONCURRENT_SENDERS 8
+#endif
+
+namespace chip {
+namespace bdx {
+
+class SenderPool;
+
+/**
+ * The progress of a transfer served by a SenderPool. bytesTotal counts the bytes to send from the start offset of the transfer.
+ */
+struct TransferMetrics
+{
+    NodeId peerNodeId                      = kUndefinedNodeId;
+    uint64_t bytesSent                     = 0;
+    uint64_t bytesTotal                    = 0;
+    uint32_t blocksSent                    = 0;
+    System::Clock::Timestamp startTime     = System::Clock::kZero;
+    System::Clock::Timestamp lastBlockTime = System::Clock::kZero;
+};
+
+/**
+ * Totals over all the transfers a SenderPool has handled.
+ */
+struct SenderPoolStats
+{
+    uint32_t transfersCompleted = 0;
+    uint32_t transfersFailed    = 0;
+    uint32_t transfersRejected  = 0;
+    uint64_t bytesSent          = 0;
+};
+
+struct SenderPoolParams
+{
+    uint16_t maxBlockSize           = 1024;
+    System::Clock::Timeout timeout  = System::Clock::Seconds16(5 * 60);
+    System::Clock::Timeout pollFreq = System::Clock::Milliseconds32(500);
+
+    // Admission control: a transfer is only admitted while maxBytesPerSecond still leaves at least minBytesPerSecondPerTransfer
+    // to each transfer. A value of 0 for either disables it, leaving CHIP_CONFIG_BDX_MAX_CONCURRENT_SENDERS as the only limit.
+    uint32_t maxBytesPerSecond            = 0;
+    uint32_t minBytesPerSecondPerTransfer = 0;
+};
+
+/**
+ * One transfer of a SenderPool. Only meant to be created by SenderPool.
+ */
+class PooledSender : public Responder
+{
+public:
+    PooledSender(SenderPool & pool) : mPool(pool) {}
+
+    const TransferMetrics & GetMetrics() const { return mMetrics; }
+
+    // Inherited from ExchangeDelegate
+    void OnResponseTimeout(Messaging::ExchangeContext * ec) override;
+    void OnExchangeClosing(Messaging::ExchangeContext * ec) override;
+
+private:
+    friend class SenderPool;
+
+    // Inherited from TransferFacilitator
+    void HandleTransferSessionOutput(TransferSession::OutputEvent & event) override;
+
+    void HandleInitReceived(const TransferSession::TransferInitData & initData);
+    void HandleQueryReceived();
+    void Finish(CHIP_ERROR result);
+
+    SenderPool & mPool;
+    BlockSource * mSource = nullptr;
+    uint64_t mOffset      = 0;
+    bool mFinished        = false;
+    TransferMetrics mMetrics;
+};
+
+/**
+ * Serves Receiver-driven BDX transfers to many peers at once.
+ *
+ * The pool handles the unsolicited BDX messages of an ExchangeManager: each ReceiveInit starts a transfer on its own exchange, as
+ * long as the pool has room for it (see CanAdmitTransfer()), and is otherwise answered with a Busy StatusReport. The Delegate
+ * maps the file designator of a transfer to the BlockSource it reads from, which lets concurrent transfers of the same file share
+ * one copy of it.
+ */
+class SenderPool : public Messaging::ExchangeDelegate
+{
+public:
+    class Delegate
+    {
+    public:
+        virtual ~Delegate() = default;
+
+        /**
+         * Returns the data to send for fileDesignator, or nullptr to reject the transfer. The BlockSource must stay valid until
+         * the matching call to ReleaseBlockSource().
+         */
+        virtual BlockSource * AcquireBlockSource(ByteSpan fileDesignator) = 0;
+        virtual void ReleaseBlockSource(BlockSource * source)             = 0;
+
+        /**
+         * Called once a transfer the pool admitted is over, successfully or not.
+         */
+        virtual void OnTransferFinished(const TransferMetrics & metrics, CHIP_ERROR result) {}
+    };
+
+    ~SenderPool() { Shutdown(); }
+
+    /**
+     * Start handling the BDX transfers requested through exchangeMgr.
+     */
+    CHIP_ERROR Init(System::Layer * systemLayer, Messaging::ExchangeManager * exchangeMgr, Delegate * delegate,
+                    const SenderPoolParams & params = SenderPoolParams());
+
+    /**
+     * Stop handling new transfers, and abort the ones in progress.
+     *
+     * Senders are released from work scheduled on the system layer, which the LwIP system layer cannot cancel: there, the pool
+     * must outlive the event that runs the work, although it may be shut down (or initialized again) before that.
+     */
+    void Shutdown();
+
+    /**
+     * Returns whether a transfer requested now would be admitted.
+     */
+    bool CanAdmitTransfer() const { return mDelegate != nullptr && mSenders.Allocated() < GetTransferCapacity(); }
+
+    /**
+     * Returns the number of transfers served at the same time, given the configured bandwidth.
+     */
+    size_t GetTransferCapacity() const;
+
+    size_t GetActiveTransferCount() const { return mSenders.Allocated(); }
+    const SenderPoolStats & GetStats() const { return mStats; }
+
+    /**
+     * Call function with the TransferMetrics of each transfer in progress.
+     */
+    template <typename Function>
+    Loop ForEachTransfer(Function && function) const
+    {
+        return mSenders.ForEachActiveObject([&](const PooledSender * sender) { return function(sender->GetMetrics()); });
+    }
+
+private:
+    friend class PooledSender;
+
+    // Inherited from ExchangeDelegate
+    CHIP_ERROR OnMessageReceived(Messaging::ExchangeContext * ec, const PayloadHeader & payloadHeader,
+                                 System::PacketBufferHandle && payload) override;
+    void OnResponseTimeout(Messaging::ExchangeContext * ec) override {}
+
+    void RejectTransfer(Messaging::ExchangeContext * ec);
+    void OnSenderFinished(PooledSender & sender, CHIP_ERROR result);
+    void ReleaseSender(PooledSender & sender);
+    static void ReleaseFinishedSenders(System::Layer * systemLayer, void * appState);
+
+    System::Layer * mSystemLayer             = nullptr;
+    Messaging::ExchangeManager * mExchangeMgr = nullptr;
+    Delegate * mDelegate                     = nullptr;
+    SenderPoolParams mParams;
+    SenderPoolStats mStats;
+    ObjectPool<PooledSender, CHIP_CONFIG_BDX_MAX_CONCURRENT_SENDERS> mSenders;
+};
+
+} // namespace bdx
+} // namespace chip
@@ -22,6 +22,9 @@
 namespace {
 constexpr uint8_t kBdxVersion = 0; ///< The version of this implementation of the BDX spec
 
+static_assert(CHIP_CONFIG_BDX_MAX_WINDOW_SIZE >= 1 && CHIP_CONFIG_BDX_MAX_WINDOW_SIZE <= 32,
+              "CHIP_CONFIG_BDX_MAX_WINDOW_SIZE must fit in the 32-bit BlockQuery bitmap");
+
 /**
  * @brief
  *   Allocate a new PacketBuffer and write data from a BDX message struct.
@@ -82,6 +85,11 @@ void TransferSession::PollOutput(OutputEvent & event, System::Clock::Timestamp c
         return;
     }
 
+    if (mPendingOutput == OutputEventType::kNone && IsWindowed())
+    {
+        PrepareWindowedOutput();
+    }
+
     switch (mPendingOutput)
     {
     case OutputEventType::kNone:
@@ -261,15 +269,47 @@ CHIP_ERROR TransferSession::AcceptTransfer(const TransferAcceptData & acceptData
     return CHIP_NO_ERROR;
 }
 
-CHIP_ERROR TransferSession::PrepareBlockQuery()
+CHIP_ERROR TransferSession::SetWindowSize(uint8_t windowSize)
 {
-    const MessageType msgType = MessageType::BlockQuery;
+    VerifyOrReturnError((mState == TransferState::kAwaitingInitMsg) || (mState == TransferState::kAwaitingAccept) ||
+                            (mState == TransferState::kNegotiateTransferParams),
+                        CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(windowSize >= 1 && windowSize <= CHIP_CONFIG_BDX_MAX_WINDOW_SIZE, CHIP_ERROR_INVALID_ARGUMENT);
 
+    mWindowSize = windowSize;
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR TransferSession::PrepareBlockQuery()
+{
     VerifyOrReturnError(mState == TransferState::kTransferInProgress, CHIP_ERROR_INCORRECT_STATE);
     VerifyOrReturnError(mRole == TransferRole::kReceiver, CHIP_ERROR_INCORRECT_STATE);
     VerifyOrReturnError(mPendingOutput == OutputEventType::kNone, CHIP_ERROR_INCORRECT_STATE);
+
+    if (IsWindowed())
+    {
+        VerifyOrReturnError(!mBlockRequested, CHIP_ERROR_INCORRECT_STATE);
+
+        // Only send the BlockQuery if it did not go out ahead of time.
+        if (mNextQueryNum == mNextBlockNum)
+        {
+            ReturnErrorOnFailure(PrepareNextBlockQuery());
+        }
+        mBlockRequested = true;
+
+        return CHIP_NO_ERROR;
+    }
+
     VerifyOrReturnError(!mAwaitingResponse, CHIP_ERROR_INCORRECT_STATE);
 
+    return PrepareNextBlockQuery();
+}
+
+CHIP_ERROR TransferSession::PrepareNextBlockQuery()
+{
+    const MessageType msgType = MessageType::BlockQuery;
+
     BlockQuery queryMsg;
     queryMsg.BlockCounter = mNextQueryNum;
 
@@ -297,6 +337,9 @@ CHIP_ERROR TransferSession::PrepareBlockQueryWithSkip(const uint64_t & bytesToSk
     VerifyOrReturnError(mPendingOutput == OutputEventType::kNone, CHIP_ERROR_INCORRECT_STATE);
     VerifyOrReturnError(!mAwaitingResponse, CHIP_ERROR_INCORRECT_STATE);
 
+    // Skipping moves the start of all the following Blocks, so it can't be done once BlockQuery messages went out ahead of time.
+    VerifyOrReturnError(!IsWindowed() || (mNextQueryNum == mNextBlockNum && !mBlockRequested), CHIP_ERROR_INCORRECT_STATE);
+
     BlockQueryWithSkip queryMsg;
     queryMsg.BlockCounter = mNextQueryNum;
     queryMsg.BytesToSkip  = bytesToSkip;
@@ -310,6 +353,7 @@ CHIP_ERROR TransferSession::PrepareBlockQueryWithSkip(const uint64_t & bytesToSk
 
     mAwaitingResponse = true;
     mLastQueryNum     = mNextQueryNum++;
+    mBlockRequested   = true;
 
     PrepareOutgoingMessageEvent(msgType, mPendingOutput, mMsgTypeData);
 
@@ -345,6 +389,9 @@ CHIP_ERROR TransferSession::PrepareBlock(const BlockData & inData)
         mState = TransferState::kAwaitingEOFAck;
     }
 
+    // Drop the BlockQuery this Block answers. Any BlockQuery received ahead for Blocks past the BlockEOF will never be answered.
+    mQueryBitmap = (msgType == MessageType::BlockEOF) ? 0 : (mQueryBitmap >> 1);
+
     mAwaitingResponse = true;
     mLastBlockNum     = mNextBlockNum++;
 
@@ -360,6 +407,9 @@ CHIP_ERROR TransferSession::PrepareBlockAck()
                         CHIP_ERROR_INCORRECT_STATE);
     VerifyOrReturnError(mPendingOutput == OutputEventType::kNone, CHIP_ERROR_INCORRECT_STATE);
 
+    // A BlockAck would not tell the Sender which of the Blocks in flight it acknowledges.
+    VerifyOrReturnError(!IsWindowed() || mState == TransferState::kReceivedEOF, CHIP_ERROR_INCORRECT_STATE);
+
     CounterMessage ackMsg;
     ackMsg.BlockCounter       = mLastBlockNum;
     const MessageType msgType = (mState == TransferState::kReceivedEOF) ? MessageType::BlockAckEOF : MessageType::BlockAck;
@@ -422,6 +472,16 @@ void TransferSession::Reset()
     mLastQueryNum      = 0;
     mNextQueryNum      = 0;
 
+    mWindowSize        = 1;
+    mNumBlocksBuffered = 0;
+    mBlockRequested    = false;
+    mQueryBitmap       = 0;
+    mBlockCountLimit   = UINT32_MAX;
+    for (System::PacketBufferHandle & block : mBlockWindow)
+    {
+        block = nullptr;
+    }
+
     mTimeout                = System::Clock::kZero;
     mTimeoutStartTime       = System::Clock::kZero;
     mShouldInitTimeoutStart = true;
@@ -455,10 +515,15 @@ CHIP_ERROR TransferSession::HandleMessageReceived(const PayloadHeader & payloadH
 CHIP_ERROR TransferSession::HandleBdxMessage(const PayloadHeader & header, System::PacketBufferHandle msg)
 {
     VerifyOrReturnError(!msg.IsNull(), CHIP_ERROR_INVALID_ARGUMENT);
-    VerifyOrReturnError(mPendingOutput == OutputEventType::kNone, CHIP_ERROR_INCORRECT_STATE);
 
     const MessageType msgType = static_cast<MessageType>(header.GetMessageType());
 
+    // In a windowed transfer, Blocks and BlockQuery messages are held until PollOutput() emits them in order, so they may arrive
+    // while other output is pending.
+    const bool isWindowedMsg =
+        IsWindowed() && (msgType == MessageType::BlockQuery || msgType == MessageType::Block || msgType == MessageType::BlockEOF);
+    VerifyOrReturnError(mPendingOutput == OutputEventType::kNone || isWindowedMsg, CHIP_ERROR_INCORRECT_STATE);
+
 #if CHIP_AUTOMATION_LOGGING
     ChipLogAutomation("Handling received BDX Message");
 #endif // CHIP_AUTOMATION_LOGGING
@@ -643,6 +708,13 @@ void TransferSession::HandleSendAccept(System::PacketBufferHandle msgData)
 void TransferSession::HandleBlockQuery(System::PacketBufferHandle msgData)
 {
     VerifyOrReturn(mRole == TransferRole::kSender, PrepareStatusReport(StatusCode::kUnexpectedMessage));
+
+    if (IsWindowed())
+    {
+        HandleWindowedBlockQuery(std::move(msgData));
+        return;
+    }
+
     VerifyOrReturn(mState == TransferState::kTransferInProgress, PrepareStatusReport(StatusCode::kUnexpectedMessage));
     VerifyOrReturn(mAwaitingResponse, PrepareStatusReport(StatusCode::kUnexpectedMessage));
 
@@ -688,6 +760,13 @@ void TransferSession::HandleBlockQueryWithSkip(System::PacketBufferHandle msgDat
 void TransferSession::HandleBlock(System::PacketBufferHandle msgData)
 {
     VerifyOrReturn(mRole == TransferRole::kReceiver, PrepareStatusReport(StatusCode::kUnexpectedMessage));
+
+    if (IsWindowed())
+    {
+        HandleWindowedBlock(MessageType::Block, std::move(msgData));
+        return;
+    }
+
     VerifyOrReturn(mState == TransferState::kTransferInProgress, PrepareStatusReport(StatusCode::kUnexpectedMessage));
     VerifyOrReturn(mAwaitingResponse, PrepareStatusReport(StatusCode::kUnexpectedMessage));
 
@@ -726,6 +805,13 @@ void TransferSession::HandleBlock(System::PacketBufferHandle msgData)
 void TransferSession::HandleBlockEOF(System::PacketBufferHandle msgData)
 {
     VerifyOrReturn(mRole == TransferRole::kReceiver, PrepareStatusReport(StatusCode::kUnexpectedMessage));
+
+    if (IsWindowed())
+    {
+        HandleWindowedBlock(MessageType::BlockEOF, std::move(msgData));
+        return;
+    }
+
     VerifyOrReturn(mState == TransferState::kTransferInProgress, PrepareStatusReport(StatusCode::kUnexpectedMessage));
     VerifyOrReturn(mAwaitingResponse, PrepareStatusReport(StatusCode::kUnexpectedMessage));
 
@@ -799,6 +885,138 @@ void TransferSession::HandleBlockAckEOF(System::PacketBufferHandle msgData)
 #endif // CHIP_AUTOMATION_LOGGING
 }
 
+void TransferSession::HandleWindowedBlockQuery(System::PacketBufferHandle msgData)
+{
+    VerifyOrReturn((mState == TransferState::kTransferInProgress) || (mState == TransferState::kAwaitingEOFAck),
+                   PrepareStatusReport(StatusCode::kUnexpectedMessage));
+
+    BlockQuery query;
+    const CHIP_ERROR err = query.Parse(std::move(msgData));
+    VerifyOrReturn(err == CHIP_NO_ERROR, PrepareStatusReport(StatusCode::kBadMessageContents));
+
+    // Accept any Block of the window that was not asked for yet
+    const uint32_t queryBit = query.BlockCounter - mNextBlockNum;
+    VerifyOrReturn(queryBit < mWindowSize, PrepareStatusReport(StatusCode::kBadBlockCounter));
+    VerifyOrReturn((mQueryBitmap & (1u << queryBit)) == 0, PrepareStatusReport(StatusCode::kBadBlockCounter));
+
+#if CHIP_AUTOMATION_LOGGING
+    query.LogMessage(MessageType::BlockQuery);
+#endif // CHIP_AUTOMATION_LOGGING
+
+    // The Receiver does not know where the data ends, so it may ask for Blocks past the BlockEOF. Those are left unanswered.
+    VerifyOrReturn(mState == TransferState::kTransferInProgress);
+
+    mQueryBitmap |= (1u << queryBit);
+}
+
+void TransferSession::HandleWindowedBlock(MessageType msgType, System::PacketBufferHandle msgData)
+{
+    VerifyOrReturn(mState == TransferState::kTransferInProgress, PrepareStatusReport(StatusCode::kUnexpectedMessage));
+
+    DataBlock blockMsg;
+    const CHIP_ERROR err = blockMsg.Parse(msgData.Retain());
+    VerifyOrReturn(err == CHIP_NO_ERROR, PrepareStatusReport(StatusCode::kBadMessageContents));
+
+    // Only accept a Block that was asked for, did not arrive yet, and does not follow the BlockEOF
+    const uint32_t counter = blockMsg.BlockCounter;
+    VerifyOrReturn(counter - mNextBlockNum < mNextQueryNum - mNextBlockNum, PrepareStatusReport(StatusCode::kBadBlockCounter));
+    VerifyOrReturn(counter < mBlockCountLimit, PrepareStatusReport(StatusCode::kBadBlockCounter));
+    VerifyOrReturn(mBlockWindow[counter % mWindowSize].IsNull(), PrepareStatusReport(StatusCode::kBadBlockCounter));
+
+    // BlockEOF may contain 0 length data
+    VerifyOrReturn(((blockMsg.DataLength > 0) || (msgType == MessageType::BlockEOF)) &&
+                       (blockMsg.DataLength <= mTransferMaxBlockSize),
+                   PrepareStatusReport(StatusCode::kBadMessageContents));
+
+    if (msgType == MessageType::BlockEOF)
+    {
+        for (uint32_t later = counter + 1; later != mNextQueryNum; later++)
+        {
+            VerifyOrReturn(mBlockWindow[later % mWindowSize].IsNull(), PrepareStatusReport(StatusCode::kBadBlockCounter));
+        }
+        mBlockCountLimit = counter + 1;
+    }
+
+#if CHIP_AUTOMATION_LOGGING
+    blockMsg.LogMessage(msgType);
+#endif // CHIP_AUTOMATION_LOGGING
+
+    mBlockWindow[counter % mWindowSize] = std::move(msgData);
+    mNumBlocksBuffered++;
+
+    // Keep the timeout running while some of the Blocks asked for are still missing. The BlockQuery messages sent past the
+    // BlockEOF will never be answered.
+    const uint32_t queryLimit = ::chip::min(mNextQueryNum, mBlockCountLimit);
+    mAwaitingResponse         = (queryLimit - mNextBlockNum > mNumBlocksBuffered);
+}
+
+void TransferSession::PrepareWindowedOutput()
+{
+    VerifyOrReturn(mState == TransferState::kTransferInProgress);
+
+    if (mRole == TransferRole::kSender)
+    {
+        // Emit the next BlockQuery once the previous one has been answered
+        if (mAwaitingResponse && (mQueryBitmap & 1u))
+        {
+            mPendingOutput    = OutputEventType::kQueryReceived;
+            mAwaitingResponse = false;
+            mLastQueryNum     = mNextBlockNum;
+        }
+        return;
+    }
+
+    if (mBlockRequested && !mBlockWindow[mNextBlockNum % mWindowSize].IsNull())
+    {
+        EmitWindowedBlock();
+    }
+    else if (mNextQueryNum != mNextBlockNum && mNextQueryNum - mNextBlockNum < mWindowSize && mNextQueryNum < mBlockCountLimit)
+    {
+        // Keep the window full while the application is reading. If this fails, retry on the next call.
+        const CHIP_ERROR err = PrepareNextBlockQuery();
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(BDX, "%s: error preparing message: %s", __FUNCTION__, ErrorStr(err));
+        }
+    }
+}
+
+void TransferSession::EmitWindowedBlock()
+{
+    System::PacketBufferHandle msgData = std::move(mBlockWindow[mNextBlockNum % mWindowSize]);
+    mNumBlocksBuffered--;
+
+    // The message was validated when it was received
+    DataBlock blockMsg;
+    const CHIP_ERROR err = blockMsg.Parse(msgData.Retain());
+    VerifyOrReturn(err == CHIP_NO_ERROR, PrepareStatusReport(StatusCode::kBadMessageContents));
+
+    if (IsTransferLengthDefinite())
+    {
+        VerifyOrReturn(mNumBytesProcessed + blockMsg.DataLength <= mTransferLength,
+                       PrepareStatusReport(StatusCode::kLengthMismatch));
+    }
+
+    mBlockEventData.Data         = blockMsg.Data;
+    mBlockEventData.Length       = blockMsg.DataLength;
+    mBlockEventData.IsEof        = (blockMsg.BlockCounter + 1 == mBlockCountLimit);
+    mBlockEventData.BlockCounter = blockMsg.BlockCounter;
+
+    mPendingMsgHandle = std::move(msgData);
+    mPendingOutput    = OutputEventType::kBlockReceived;
+
+    mNumBytesProcessed += blockMsg.DataLength;
+    mLastBlockNum   = blockMsg.BlockCounter;
+    mBlockRequested = false;
+    mNextBlockNum++;
+
+    if (mBlockEventData.IsEof)
+    {
+        mAwaitingResponse = false;
+        mState            = TransferState::kReceivedEOF;
+    }
+}
+
 void TransferSession::ResolveTransferControlOptions(const BitFlags<TransferControlFlags> & proposed)
 {
     // Must specify at least one synchronous option
@@ -14,6 +14,16 @@
 
 #include <type_traits>
 
+/**
+ * CHIP_CONFIG_BDX_MAX_WINDOW_SIZE
+ *
+ * The largest window a TransferSession accepts in TransferSession::SetWindowSize().  A Receiver keeps a PacketBuffer handle per
+ * Block of its window, to hold the Blocks that arrive ahead of the one the application waits for.  At most 32.
+ */
+#ifndef CHIP_CONFIG_BDX_MAX_WINDOW_SIZE
+#define CHIP_CONFIG_BDX_MAX_WINDOW_SIZE 8
+#endif
+
 namespace chip {
 namespace bdx {
 
@@ -209,6 +219,26 @@ public:
      */
     CHIP_ERROR AcceptTransfer(const TransferAcceptData & acceptData);
 
+    /**
+     * @brief
+     *   Set how many Blocks may be in flight at once in a Receiver Drive transfer. The default of 1 is the stop-and-wait exchange
+     *   of the BDX specification.
+     *
+     *   With a larger window, a Receiver sends the BlockQuery messages for the next Blocks without waiting for the previous ones,
+     *   and a Sender accepts BlockQuery messages that many Blocks ahead. Both still emit one kBlockReceived or kQueryReceived
+     *   event at a time, in Block counter order, so the application calls PrepareBlockQuery() and PrepareBlock() as before. BDX
+     *   does not negotiate a window, so a Receiver must only use one with a Sender known to support it. Only one message per
+     *   exchange may await an MRP acknowledgement, so a window is also only usable over sessions that do not use MRP.
+     *
+     *   Must be called after StartTransfer() or WaitForTransfer(), before the transfer is accepted. Reset() restores a window of 1.
+     *
+     * @param windowSize Number of Blocks, between 1 and CHIP_CONFIG_BDX_MAX_WINDOW_SIZE
+     *
+     * @return CHIP_ERROR_INVALID_ARGUMENT if the window size is out of range, CHIP_ERROR_INCORRECT_STATE if the transfer was
+     *         already accepted or the object is not initialized.
+     */
+    CHIP_ERROR SetWindowSize(uint8_t windowSize);
+
     /**
      * @brief
      *   Reject a TransferInit message. Use Reset() to prepare this object for another transfer.
@@ -224,6 +254,9 @@ public:
      * @brief
      *   Prepare a BlockQuery message. The Block counter will be populated automatically.
      *
+     *   With a window larger than 1 (see SetWindowSize()), the BlockQuery for the next Block may already have been sent, in which
+     *   case this only requests PollOutput() to emit the Block once it has arrived.
+     *
      * @return CHIP_ERROR The result of the preparation of a BlockQuery message. May also indicate if the TransferSession object
      *                    is unable to handle this request.
      */
@@ -298,6 +331,7 @@ public:
     uint64_t GetTransferLength() const { return mTransferLength; }
     uint16_t GetTransferBlockSize() const { return mTransferMaxBlockSize; }
     size_t GetNumBytesProcessed() const { return mNumBytesProcessed; }
+    uint8_t GetWindowSize() const { return mWindowSize; }
 
     TransferSession();
 
@@ -327,6 +361,18 @@ private:
     void HandleBlockEOF(System::PacketBufferHandle msgData);
     void HandleBlockAck(System::PacketBufferHandle msgData);
     void HandleBlockAckEOF(System::PacketBufferHandle msgData);
+    void HandleWindowedBlockQuery(System::PacketBufferHandle msgData);
+    void HandleWindowedBlock(MessageType msgType, System::PacketBufferHandle msgData);
+
+    /**
+     * @brief
+     *   Used by PollOutput() in a windowed transfer when there is no other pending output. Emits the next BlockQuery received ahead
+     *   of time (Sender), or the next Block received ahead of time or a BlockQuery that keeps the window full (Receiver).
+     */
+    void PrepareWindowedOutput();
+    void EmitWindowedBlock();
+    CHIP_ERROR PrepareNextBlockQuery();
+    bool IsWindowed() const { return mWindowSize > 1 && mControlMode == TransferControlFlags::kReceiverDrive; }
 
     /**
      * @brief
@@ -375,6 +421,17 @@ private:
     uint32_t mLastQueryNum = 0;
     uint32_t mNextQueryNum = 0;
 
+    // Used to govern a windowed transfer (see SetWindowSize()). In that mode a Receiver uses mNextBlockNum as the counter of the
+    // next Block to emit.
+    uint8_t mWindowSize        = 1;
+    uint8_t mNumBlocksBuffered = 0;
+    bool mBlockRequested       = false;      ///< Receiver: the application waits for Block mNextBlockNum
+    uint32_t mQueryBitmap      = 0;          ///< Sender: bit n is set if the BlockQuery for mNextBlockNum + n was received
+    uint32_t mBlockCountLimit  = UINT32_MAX; ///< Receiver: counter following the BlockEOF, once it was received
+
+    // Receiver: Blocks received ahead of the one the application waits for, indexed by counter modulo the window size
+    System::PacketBufferHandle mBlockWindow[CHIP_CONFIG_BDX_MAX_WINDOW_SIZE];
+
     System::Clock::Timeout mTimeout            = System::Clock::kZero;
     System::Clock::Timestamp mTimeoutStartTime = System::Clock::kZero;
     bool mShouldInitTimeoutStart               = true;
@@ -55,6 +55,10 @@ CHIP_ERROR TransferFacilitator::OnMessageReceived(chip::Messaging::ExchangeConte
     // transfer is finished.
     mExchangeCtx->WillSendMessage();
 
+    // Act on the message right away instead of on the next poll period, which would otherwise bound the transfer to one Block
+    // per period.
+    ScheduleImmediatePoll();
+
     return err;
 }
 
@@ -74,8 +78,17 @@ void TransferFacilitator::PollTimerHandler(chip::System::Layer * systemLayer, vo
 void TransferFacilitator::PollForOutput()
 {
     TransferSession::OutputEvent outEvent;
-    mTransfer.PollOutput(outEvent, System::SystemClock().GetMonotonicTimestamp());
-    HandleTransferSessionOutput(outEvent);
+
+    // Drain the pending output, which may hold several messages to send in a windowed transfer. A TransferSession keeps
+    // emitting an error until it is reset, so stop after the first one.
+    do
+    {
+        mTransfer.PollOutput(outEvent, System::SystemClock().GetMonotonicTimestamp());
+        HandleTransferSessionOutput(outEvent);
+    } while (outEvent.EventType != TransferSession::OutputEventType::kNone &&
+             outEvent.EventType != TransferSession::OutputEventType::kInternalError &&
+             outEvent.EventType != TransferSession::OutputEventType::kStatusReceived &&
+             outEvent.EventType != TransferSession::OutputEventType::kTransferTimeout);
 
     VerifyOrReturn(mSystemLayer != nullptr, ChipLogError(BDX, "%s mSystemLayer is null", __FUNCTION__));
     mSystemLayer->StartTimer(mPollFreq, PollTimerHandler, this);
@@ -38,7 +38,8 @@ namespace bdx {
  *
  * This class does not define any methods for beginning a transfer or initializing the underlying TransferSession object (see
  * Initiator and Responder below).
- * This class contains a repeating timer which regurlaly polls the TransferSession state machine.
+ * This class contains a repeating timer which regurlaly polls the TransferSession state machine, and also polls it right after
+ * each message received.
  * A CHIP node may have many TransferFacilitator instances but only one TransferFacilitator should be used for each BDX transfer.
  */
 class TransferFacilitator : public Messaging::ExchangeDelegate
@@ -0,0 +1,420 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements unit tests for SenderPool: simulated requestors download from the pool over the loopback transport.
+ */
+
+#include <protocols/bdx/BdxBlockSource.h>
+#include <protocols/bdx/BdxSenderPool.h>
+#include <protocols/bdx/TransferFacilitator.h>
+
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/UnitTestRegistration.h>
+#include <messaging/ExchangeContext.h>
+#include <messaging/Flags.h>
+#include <messaging/tests/MessagingContext.h>
+#include <protocols/secure_channel/Constants.h>
+
+#include <nlunit-test.h>
+
+#include <string.h>
+#include <vector>
+
+namespace {
+
+using namespace chip;
+using namespace chip::bdx;
+
+using TestContext = Test::LoopbackMessagingContext<>;
+
+constexpr uint16_t kBlockSize                        = 512;
+constexpr size_t kImageSize                          = 16 * 1024 + 100;
+constexpr char kImageDesignator[]                    = "image.bin";
+constexpr System::Clock::Timeout kRequestorPollFreq = System::Clock::Milliseconds32(10);
+constexpr System::Clock::Timeout kTestTimeout        = System::Clock::Seconds16(20);
+
+TestContext sContext;
+
+class TestImageStore : public SenderPool::Delegate
+{
+public:
+    TestImageStore() : mImage(kImageSize), mSource(ByteSpan(mImage.data(), mImage.size()))
+    {
+        for (size_t i = 0; i < mImage.size(); i++)
+        {
+            mImage[i] = static_cast<uint8_t>(i * 7 + (i >> 9));
+        }
+    }
+
+    BlockSource * AcquireBlockSource(ByteSpan fileDesignator) override
+    {
+        VerifyOrReturnError(fileDesignator.data_equal(ByteSpan(Uint8::from_const_char(kImageDesignator), strlen(kImageDesignator))),
+                            nullptr);
+        mNumAcquired++;
+        return &mSource;
+    }
+
+    void ReleaseBlockSource(BlockSource * source) override
+    {
+        if (source == &mSource)
+        {
+            mNumReleased++;
+        }
+    }
+
+    void OnTransferFinished(const TransferMetrics & metrics, CHIP_ERROR result) override
+    {
+        if (result == CHIP_NO_ERROR && metrics.bytesSent == mImage.size() && metrics.bytesTotal == mImage.size() &&
+            metrics.blocksSent == (mImage.size() + kBlockSize - 1) / kBlockSize)
+        {
+            mNumCompleteMetrics++;
+        }
+    }
+
+    std::vector<uint8_t> mImage;
+    MemoryBlockSource mSource;
+    uint32_t mNumAcquired        = 0;
+    uint32_t mNumReleased        = 0;
+    uint32_t mNumCompleteMetrics = 0;
+};
+
+// Downloads a file from the pool the way an OTA Requestor does.
+class TestRequestor : public Initiator
+{
+public:
+    ~TestRequestor() { Stop(); }
+
+    CHIP_ERROR Start(TestContext & ctx, const char * fileDesignator)
+    {
+        TransferSession::TransferInitData initData;
+        initData.TransferCtlFlags = TransferControlFlags::kReceiverDrive;
+        initData.MaxBlockSize     = kBlockSize;
+        initData.FileDesLength    = static_cast<uint16_t>(strlen(fileDesignator));
+        initData.FileDesignator   = Uint8::from_const_char(fileDesignator);
+
+        mExchangeCtx = ctx.NewExchangeToBob(this);
+        VerifyOrReturnError(mExchangeCtx != nullptr, CHIP_ERROR_NO_MEMORY);
+        return InitiateTransfer(&ctx.GetSystemLayer(), TransferRole::kReceiver, initData, System::Clock::Seconds16(10),
+                                kRequestorPollFreq);
+    }
+
+    void Stop()
+    {
+        if (mSystemLayer != nullptr)
+        {
+            mSystemLayer->CancelTimer(PollTimerHandler, this);
+        }
+        CloseExchange();
+    }
+
+    bool mDone         = false;
+    bool mSucceeded    = false;
+    StatusCode mStatus = StatusCode::kNone;
+    std::vector<uint8_t> mReceived;
+
+private:
+    void HandleTransferSessionOutput(TransferSession::OutputEvent & event) override
+    {
+        switch (event.EventType)
+        {
+        case TransferSession::OutputEventType::kMsgToSend: {
+            Messaging::SendFlags sendFlags;
+            const bool isLastMessage = event.msgTypeData.HasMessageType(MessageType::BlockAckEOF) ||
+                event.msgTypeData.HasMessageType(Protocols::SecureChannel::MsgType::StatusReport);
+
+            VerifyOrReturn(mExchangeCtx != nullptr);
+            if (!isLastMessage && !mExchangeCtx->IsResponseExpected())
+            {
+                sendFlags.Set(Messaging::SendMessageFlags::kExpectResponse);
+            }
+            CHIP_ERROR err = mExchangeCtx->SendMessage(event.msgTypeData.ProtocolId, event.msgTypeData.MessageType,
+                                                       std::move(event.MsgData), sendFlags);
+            if (err == CHIP_NO_ERROR && isLastMessage)
+            {
+                // The exchange closes itself once a message that expects no response is sent.
+                mExchangeCtx = nullptr;
+                mSucceeded   = event.msgTypeData.HasMessageType(MessageType::BlockAckEOF);
+                Done();
+            }
+            else if (err != CHIP_NO_ERROR)
+            {
+                Done();
+            }
+            break;
+        }
+        case TransferSession::OutputEventType::kAcceptReceived:
+            mTransfer.PrepareBlockQuery();
+            break;
+        case TransferSession::OutputEventType::kBlockReceived:
+            mReceived.insert(mReceived.end(), event.blockdata.Data, event.blockdata.Data + event.blockdata.Length);
+            if (event.blockdata.IsEof)
+            {
+                mTransfer.PrepareBlockAck();
+            }
+            else
+            {
+                mTransfer.PrepareBlockQuery();
+            }
+            break;
+        case TransferSession::OutputEventType::kStatusReceived:
+            mStatus = event.statusData.statusCode;
+            Done();
+            break;
+        case TransferSession::OutputEventType::kInternalError:
+        case TransferSession::OutputEventType::kTransferTimeout:
+            Done();
+            break;
+        default:
+            break;
+        }
+    }
+
+    void Done()
+    {
+        mDone = true;
+        mTransfer.Reset();
+        CloseExchange();
+    }
+
+    void CloseExchange()
+    {
+        if (mExchangeCtx != nullptr)
+        {
+            mExchangeCtx->Close();
+            mExchangeCtx = nullptr;
+        }
+    }
+};
+
+// Let the last acknowledgements go through, so that no exchange outlives the test.
+bool Drain(TestContext & ctx)
+{
+    ctx.GetIOContext().DriveIOUntil(kTestTimeout, [&]() {
+        return ctx.GetExchangeManager().GetNumActiveExchanges() == 0 &&
+            ctx.GetExchangeManager().GetReliableMessageMgr()->TestGetCountRetransTable() == 0;
+    });
+    return ctx.GetExchangeManager().GetNumActiveExchanges() == 0;
+}
+
+bool AllDone(const TestRequestor * requestors, size_t count, const SenderPool & pool)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        VerifyOrReturnError(requestors[i].mDone, false);
+    }
+    return pool.GetActiveTransferCount() == 0;
+}
+
+void TestConcurrentTransfers(nlTestSuite * inSuite, void * inContext)
+{
+    constexpr size_t kNumRequestors = CHIP_CONFIG_BDX_MAX_CONCURRENT_SENDERS;
+
+    TestContext & ctx = *static_cast<TestContext *>(inContext);
+    TestImageStore store;
+    SenderPool pool;
+    TestRequestor requestors[kNumRequestors];
+    size_t maxActiveTransfers = 0;
+    bool progressConsistent   = true;
+
+    NL_TEST_ASSERT(inSuite, pool.Init(&ctx.GetSystemLayer(), &ctx.GetExchangeManager(), &store) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, pool.GetTransferCapacity() == CHIP_CONFIG_BDX_MAX_CONCURRENT_SENDERS);
+
+    for (auto & requestor : requestors)
+    {
+        NL_TEST_ASSERT(inSuite, requestor.Start(ctx, kImageDesignator) == CHIP_NO_ERROR);
+    }
+
+    ctx.GetIOContext().DriveIOUntil(kTestTimeout, [&]() {
+        maxActiveTransfers = chip::max(maxActiveTransfers, pool.GetActiveTransferCount());
+        pool.ForEachTransfer([&](const TransferMetrics & metrics) {
+            progressConsistent = progressConsistent && metrics.bytesSent <= metrics.bytesTotal &&
+                metrics.peerNodeId == ctx.GetAliceNodeId();
+            return Loop::Continue;
+        });
+        return AllDone(requestors, kNumRequestors, pool);
+    });
+
+    for (auto & requestor : requestors)
+    {
+        NL_TEST_ASSERT(inSuite, requestor.mDone && requestor.mSucceeded);
+        NL_TEST_ASSERT(inSuite, requestor.mReceived == store.mImage);
+    }
+
+    // The requestors were all served at the same time, from the same source.
+    NL_TEST_ASSERT(inSuite, maxActiveTransfers == kNumRequestors);
+    NL_TEST_ASSERT(inSuite, progressConsistent);
+    NL_TEST_ASSERT(inSuite, store.mNumAcquired == kNumRequestors);
+    NL_TEST_ASSERT(inSuite, store.mNumReleased == kNumRequestors);
+    NL_TEST_ASSERT(inSuite, store.mNumCompleteMetrics == kNumRequestors);
+    NL_TEST_ASSERT(inSuite, pool.GetActiveTransferCount() == 0);
+    NL_TEST_ASSERT(inSuite, pool.GetStats().transfersCompleted == kNumRequestors);
+    NL_TEST_ASSERT(inSuite, pool.GetStats().transfersFailed == 0);
+    NL_TEST_ASSERT(inSuite, pool.GetStats().bytesSent == kNumRequestors * kImageSize);
+
+    pool.Shutdown();
+    NL_TEST_ASSERT(inSuite, Drain(ctx));
+}
+
+void TestAdmissionControl(nlTestSuite * inSuite, void * inContext)
+{
+    constexpr size_t kNumRequestors = 4;
+
+    TestContext & ctx = *static_cast<TestContext *>(inContext);
+    TestImageStore store;
+    SenderPool pool;
+    TestRequestor requestors[kNumRequestors];
+    TestRequestor unknownFileRequestor;
+
+    // Room for 3 transfers of at least 1000 B/s each.
+    SenderPoolParams params;
+    params.maxBytesPerSecond            = 3000;
+    params.minBytesPerSecondPerTransfer = 1000;
+
+    NL_TEST_ASSERT(inSuite, pool.Init(&ctx.GetSystemLayer(), &ctx.GetExchangeManager(), &store, params) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, pool.GetTransferCapacity() == 3);
+    NL_TEST_ASSERT(inSuite, pool.CanAdmitTransfer());
+
+    for (auto & requestor : requestors)
+    {
+        NL_TEST_ASSERT(inSuite, requestor.Start(ctx, kImageDesignator) == CHIP_NO_ERROR);
+    }
+
+    ctx.GetIOContext().DriveIOUntil(kTestTimeout, [&]() { return AllDone(requestors, kNumRequestors, pool); });
+
+    size_t numSucceeded = 0;
+    size_t numBusy      = 0;
+    for (auto & requestor : requestors)
+    {
+        NL_TEST_ASSERT(inSuite, requestor.mDone);
+        if (requestor.mSucceeded)
+        {
+            NL_TEST_ASSERT(inSuite, requestor.mReceived == store.mImage);
+            numSucceeded++;
+        }
+        else if (requestor.mStatus == StatusCode::kTransferFailedUnknownError)
+        {
+            numBusy++;
+        }
+    }
+    NL_TEST_ASSERT(inSuite, numSucceeded == 3);
+    NL_TEST_ASSERT(inSuite, numBusy == 1);
+    NL_TEST_ASSERT(inSuite, pool.GetStats().transfersRejected == 1);
+    NL_TEST_ASSERT(inSuite, pool.CanAdmitTransfer());
+
+    // A transfer of an unknown file is admitted, then aborted.
+    NL_TEST_ASSERT(inSuite, unknownFileRequestor.Start(ctx, "unknown.bin") == CHIP_NO_ERROR);
+    ctx.GetIOContext().DriveIOUntil(kTestTimeout, [&]() { return AllDone(&unknownFileRequestor, 1, pool); });
+
+    NL_TEST_ASSERT(inSuite, unknownFileRequestor.mStatus == StatusCode::kFileDesignatorUnknown);
+    NL_TEST_ASSERT(inSuite, pool.GetStats().transfersFailed == 1);
+    NL_TEST_ASSERT(inSuite, store.mNumAcquired == store.mNumReleased);
+
+    pool.Shutdown();
+    NL_TEST_ASSERT(inSuite, Drain(ctx));
+}
+
+// Shutting the pool down in the middle of transfers aborts them and releases their senders at once, and the pool can then be
+// initialized again.
+void TestShutdownDuringTransfers(nlTestSuite * inSuite, void * inContext)
+{
+    constexpr size_t kNumRequestors = 2;
+
+    TestContext & ctx = *static_cast<TestContext *>(inContext);
+    TestImageStore store;
+    SenderPool pool;
+    TestRequestor requestors[kNumRequestors];
+    TestRequestor lastRequestor;
+
+    NL_TEST_ASSERT(inSuite, pool.Init(&ctx.GetSystemLayer(), &ctx.GetExchangeManager(), &store) == CHIP_NO_ERROR);
+
+    for (auto & requestor : requestors)
+    {
+        NL_TEST_ASSERT(inSuite, requestor.Start(ctx, kImageDesignator) == CHIP_NO_ERROR);
+    }
+
+    auto allSending = [&]() {
+        size_t numSending = 0;
+        pool.ForEachTransfer([&](const TransferMetrics & metrics) {
+            numSending += (metrics.blocksSent > 0) ? 1 : 0;
+            return Loop::Continue;
+        });
+        return numSending == kNumRequestors;
+    };
+    ctx.GetIOContext().DriveIOUntil(kTestTimeout, allSending);
+    NL_TEST_ASSERT(inSuite, allSending());
+
+    pool.Shutdown();
+    NL_TEST_ASSERT(inSuite, pool.GetActiveTransferCount() == 0);
+    NL_TEST_ASSERT(inSuite, store.mNumAcquired == kNumRequestors);
+    NL_TEST_ASSERT(inSuite, store.mNumReleased == kNumRequestors);
+    NL_TEST_ASSERT(inSuite, pool.GetStats().transfersFailed == kNumRequestors);
+
+    for (auto & requestor : requestors)
+    {
+        requestor.Stop();
+    }
+    NL_TEST_ASSERT(inSuite, Drain(ctx));
+
+    NL_TEST_ASSERT(inSuite, pool.Init(&ctx.GetSystemLayer(), &ctx.GetExchangeManager(), &store) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, lastRequestor.Start(ctx, kImageDesignator) == CHIP_NO_ERROR);
+    ctx.GetIOContext().DriveIOUntil(kTestTimeout, [&]() { return AllDone(&lastRequestor, 1, pool); });
+
+    NL_TEST_ASSERT(inSuite, lastRequestor.mDone && lastRequestor.mSucceeded);
+    NL_TEST_ASSERT(inSuite, lastRequestor.mReceived == store.mImage);
+    NL_TEST_ASSERT(inSuite, store.mNumReleased == store.mNumAcquired);
+
+    pool.Shutdown();
+    NL_TEST_ASSERT(inSuite, Drain(ctx));
+}
+
+// clang-format off
+const nlTest sTests[] =
+{
+    NL_TEST_DEF("TestConcurrentTransfers", TestConcurrentTransfers),
+    NL_TEST_DEF("TestAdmissionControl", TestAdmissionControl),
+    NL_TEST_DEF("TestShutdownDuringTransfers", TestShutdownDuringTransfers),
+    NL_TEST_SENTINEL()
+};
+// clang-format on
+
+// clang-format off
+nlTestSuite sSuite =
+{
+    "Test-CHIP-BdxSenderPool",
+    &sTests[0],
+    TestContext::InitializeAsync,
+    TestContext::Finalize
+};
+// clang-format on
+
+} // namespace
+
+/**
+ *  Main
+ */
+int TestBdxSenderPool()
+{
+    // Run test suit against one context
+    nlTestRunner(&sSuite, &sContext);
+
+    return (nlTestRunnerStats(&sSuite));
+}
+
+CHIP_REGISTER_TEST_SUITE(TestBdxSenderPool)
@@ -0,0 +1,319 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      Measures the throughput of a Receiver-driven BDX transfer between two TransferSessions over a simulated link, for several
+ *      round trip times and window sizes. The link runs on a virtual clock, so the results do not depend on the machine.
+ */
+
+#include <protocols/bdx/BdxBlockSource.h>
+#include <protocols/bdx/BdxMessages.h>
+#include <protocols/bdx/BdxTransferSession.h>
+
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/UnitTestRegistration.h>
+#include <system/SystemPacketBuffer.h>
+#include <transport/raw/MessageHeader.h>
+
+#include <nlunit-test.h>
+
+#include <deque>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+using namespace ::chip;
+using namespace ::chip::bdx;
+
+namespace {
+
+constexpr uint16_t kBlockSize         = 1024;
+constexpr size_t kFileSize            = 64 * 1024 + kBlockSize / 2;
+constexpr uint64_t kLinkBitsPerSecond = 1000000;
+constexpr uint64_t kMicrosPerSecond   = 1000000;
+
+struct InFlightMessage
+{
+    uint64_t arrivalMicros;
+    TransferSession::MessageTypeData typeData;
+    System::PacketBufferHandle data;
+};
+
+// One direction of the link: messages are serialized at kLinkBitsPerSecond one after the other, then take half the round trip
+// time to reach the peer.
+class SimulatedLink
+{
+public:
+    SimulatedLink(uint64_t oneWayDelayMicros) : mOneWayDelayMicros(oneWayDelayMicros) {}
+
+    void Send(uint64_t nowMicros, TransferSession::OutputEvent & event)
+    {
+        uint64_t sendMicros = (mFreeAtMicros > nowMicros) ? mFreeAtMicros : nowMicros;
+        mFreeAtMicros       = sendMicros + event.MsgData->DataLength() * 8 * kMicrosPerSecond / kLinkBitsPerSecond;
+        mMessages.push_back({ mFreeAtMicros + mOneWayDelayMicros, event.msgTypeData, std::move(event.MsgData) });
+    }
+
+    bool HasMessage() const { return !mMessages.empty(); }
+    uint64_t NextArrivalMicros() const { return mMessages.front().arrivalMicros; }
+
+    CHIP_ERROR Deliver(TransferSession & peer)
+    {
+        InFlightMessage & message = mMessages.front();
+        PayloadHeader payloadHeader;
+        payloadHeader.SetMessageType(message.typeData.ProtocolId, message.typeData.MessageType);
+
+        CHIP_ERROR err = peer.HandleMessageReceived(payloadHeader, std::move(message.data),
+                                                    System::Clock::Milliseconds64(message.arrivalMicros / 1000));
+        mMessages.pop_front();
+        return err;
+    }
+
+private:
+    uint64_t mOneWayDelayMicros;
+    uint64_t mFreeAtMicros = 0;
+    std::deque<InFlightMessage> mMessages;
+};
+
+// Transfer the whole of source from a responding Sender to an initiating Receiver, and return the time it took in microseconds,
+// or 0 if the transfer failed.
+uint64_t RunTransfer(nlTestSuite * inSuite, BlockSource & source, uint64_t roundTripMicros, uint8_t windowSize,
+                     std::vector<uint8_t> & received)
+{
+    const System::Clock::Timeout timeout = System::Clock::Seconds16(30);
+
+    TransferSession receiver;
+    TransferSession sender;
+    SimulatedLink toSender(roundTripMicros / 2);
+    SimulatedLink toReceiver(roundTripMicros / 2);
+    TransferSession::OutputEvent event;
+    uint64_t nowMicros  = 0;
+    uint64_t doneMicros = 0;
+    uint64_t offset     = 0;
+    bool failed         = false;
+
+    received.clear();
+
+    TransferSession::TransferInitData initData;
+    char fileDesignator[]     = "test.bin";
+    initData.TransferCtlFlags = TransferControlFlags::kReceiverDrive;
+    initData.MaxBlockSize     = kBlockSize;
+    initData.FileDesLength    = static_cast<uint16_t>(strlen(fileDesignator));
+    initData.FileDesignator   = reinterpret_cast<uint8_t *>(fileDesignator);
+
+    BitFlags<TransferControlFlags> senderOpts;
+    senderOpts.Set(TransferControlFlags::kReceiverDrive);
+
+    VerifyOrReturnError(receiver.StartTransfer(TransferRole::kReceiver, initData, timeout) == CHIP_NO_ERROR, 0);
+    VerifyOrReturnError(sender.WaitForTransfer(TransferRole::kSender, senderOpts, kBlockSize, timeout) == CHIP_NO_ERROR, 0);
+    VerifyOrReturnError(receiver.SetWindowSize(windowSize) == CHIP_NO_ERROR, 0);
+    VerifyOrReturnError(sender.SetWindowSize(windowSize) == CHIP_NO_ERROR, 0);
+
+    while (doneMicros == 0 && !failed)
+    {
+        const System::Clock::Timestamp now = System::Clock::Milliseconds64(nowMicros / 1000);
+
+        for (receiver.PollOutput(event, now); event.EventType != TransferSession::OutputEventType::kNone;
+             receiver.PollOutput(event, now))
+        {
+            CHIP_ERROR err = CHIP_NO_ERROR;
+
+            switch (event.EventType)
+            {
+            case TransferSession::OutputEventType::kMsgToSend:
+                toSender.Send(nowMicros, event);
+                break;
+            case TransferSession::OutputEventType::kAcceptReceived:
+                err = receiver.PrepareBlockQuery();
+                break;
+            case TransferSession::OutputEventType::kBlockReceived:
+                received.insert(received.end(), event.blockdata.Data, event.blockdata.Data + event.blockdata.Length);
+                if (event.blockdata.IsEof)
+                {
+                    doneMicros = nowMicros;
+                    err        = receiver.PrepareBlockAck();
+                }
+                else
+                {
+                    err = receiver.PrepareBlockQuery();
+                }
+                break;
+            default:
+                failed = true;
+                break;
+            }
+            failed = failed || (err != CHIP_NO_ERROR);
+        }
+
+        for (sender.PollOutput(event, now); event.EventType != TransferSession::OutputEventType::kNone;
+             sender.PollOutput(event, now))
+        {
+            CHIP_ERROR err = CHIP_NO_ERROR;
+
+            switch (event.EventType)
+            {
+            case TransferSession::OutputEventType::kMsgToSend:
+                toReceiver.Send(nowMicros, event);
+                break;
+            case TransferSession::OutputEventType::kInitReceived: {
+                TransferSession::TransferAcceptData acceptData;
+                acceptData.ControlMode  = TransferControlFlags::kReceiverDrive;
+                acceptData.MaxBlockSize = sender.GetTransferBlockSize();
+                acceptData.StartOffset  = 0;
+                acceptData.Length       = 0;
+                err                     = sender.AcceptTransfer(acceptData);
+                break;
+            }
+            case TransferSession::OutputEventType::kQueryReceived: {
+                ByteSpan block;
+                TransferSession::BlockData blockData;
+
+                const uint16_t blockSize = sender.GetTransferBlockSize();
+
+                err = source.ReadBlock(offset, blockSize, block);
+                source.Prefetch(offset + block.size(), static_cast<uint64_t>(sender.GetWindowSize()) * blockSize);
+                offset += block.size();
+
+                blockData.Data   = block.data();
+                blockData.Length = block.size();
+                blockData.IsEof  = (offset == source.GetLength());
+                err              = (err == CHIP_NO_ERROR) ? sender.PrepareBlock(blockData) : err;
+                break;
+            }
+            default:
+                failed = true;
+                break;
+            }
+            failed = failed || (err != CHIP_NO_ERROR);
+        }
+
+        // Move the clock to the next arrival, and hand the message over.
+        if (toSender.HasMessage() && (!toReceiver.HasMessage() || toSender.NextArrivalMicros() <= toReceiver.NextArrivalMicros()))
+        {
+            nowMicros = toSender.NextArrivalMicros();
+            failed    = failed || (toSender.Deliver(sender) != CHIP_NO_ERROR);
+        }
+        else if (toReceiver.HasMessage())
+        {
+            nowMicros = toReceiver.NextArrivalMicros();
+            failed    = failed || (toReceiver.Deliver(receiver) != CHIP_NO_ERROR);
+        }
+        else if (doneMicros == 0)
+        {
+            // Nothing in flight, and nothing left to send: the transfer is stuck.
+            failed = true;
+        }
+    }
+
+    NL_TEST_ASSERT(inSuite, !failed);
+    return failed ? 0 : doneMicros;
+}
+
+void TestWindowedThroughput(nlTestSuite * inSuite, void * inContext)
+{
+    constexpr uint64_t kRoundTripsMillis[] = { 10, 50, 200 };
+    constexpr uint8_t kWindowSizes[]       = { 1, 2, 4, 8 };
+
+    std::vector<uint8_t> fileData(kFileSize);
+    std::vector<uint8_t> received;
+
+    for (size_t i = 0; i < fileData.size(); i++)
+    {
+        fileData[i] = static_cast<uint8_t>(i * 13 + (i >> 8));
+    }
+    MemoryBlockSource source(ByteSpan(fileData.data(), fileData.size()));
+
+    printf("BDX throughput, %u byte blocks, %u kbit/s link\n", static_cast<unsigned>(kBlockSize),
+           static_cast<unsigned>(kLinkBitsPerSecond / 1000));
+    for (uint64_t roundTripMillis : kRoundTripsMillis)
+    {
+        double kbps[sizeof(kWindowSizes)] = {};
+
+        for (size_t i = 0; i < sizeof(kWindowSizes); i++)
+        {
+            uint64_t elapsedMicros = RunTransfer(inSuite, source, roundTripMillis * 1000, kWindowSizes[i], received);
+
+            NL_TEST_ASSERT(inSuite, elapsedMicros > 0);
+            NL_TEST_ASSERT(inSuite, received == fileData);
+            VerifyOrReturn(elapsedMicros > 0);
+
+            kbps[i] = static_cast<double>(fileData.size()) * 8 * 1000 / static_cast<double>(elapsedMicros);
+            printf("  RTT %3u ms, window %u: %8.1f kbit/s\n", static_cast<unsigned>(roundTripMillis),
+                   static_cast<unsigned>(kWindowSizes[i]), kbps[i]);
+        }
+
+        // A deeper window never slows the transfer down.
+        for (size_t i = 1; i < sizeof(kWindowSizes); i++)
+        {
+            NL_TEST_ASSERT(inSuite, kbps[i] >= kbps[i - 1] * 0.99);
+        }
+
+        // Once the round trip dominates, a window of 4 keeps the link busy for most of it.
+        if (roundTripMillis >= 50)
+        {
+            NL_TEST_ASSERT(inSuite, kbps[2] > kbps[0] * 2.5);
+        }
+    }
+}
+
+int Initialize(void * apSuite)
+{
+    VerifyOrReturnError(Platform::MemoryInit() == CHIP_NO_ERROR, FAILURE);
+    return SUCCESS;
+}
+
+int Finalize(void * aContext)
+{
+    Platform::MemoryShutdown();
+    return SUCCESS;
+}
+
+} // namespace
+
+// Test Suite
+
+/**
+ *  Test Suite that lists all the test functions.
+ */
+// clang-format off
+static const nlTest sTests[] =
+{
+    NL_TEST_DEF("TestWindowedThroughput", TestWindowedThroughput),
+    NL_TEST_SENTINEL()
+};
+// clang-format on
+
+int TestBdxThroughput()
+{
+    // clang-format off
+    nlTestSuite theSuite =
+    {
+        "CHIP-BDX-Throughput",
+        &sTests[0],
+        Initialize,
+        Finalize
+    };
+    // clang-format on
+
+    // Run test suite against one context.
+    nlTestRunner(&theSuite, nullptr);
+
+    return (nlTestRunnerStats(&theSuite));
+}
+
+CHIP_REGISTER_TEST_SUITE(TestBdxThroughput)
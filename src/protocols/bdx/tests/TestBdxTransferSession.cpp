@@ -3,6 +3,7 @@
 #include <protocols/bdx/BdxTransferSession.h>
 
 #include <string.h>
+#include <vector>
 
 #include <nlunit-test.h>
 
@@ -724,6 +725,223 @@ void TestDuplicateBlockError(nlTestSuite * inSuite, void * inContext)
     }
 }
 
+// Helper method for starting a Receiver Drive transfer in which both nodes use the given window.
+void StartWindowedTransfer(nlTestSuite * inSuite, void * inContext, TransferSession & initiatingReceiver,
+                           TransferSession & respondingSender, uint8_t windowSize, uint16_t blockSize)
+{
+    TransferSession::OutputEvent outEvent;
+    System::Clock::Timeout timeout = System::Clock::Seconds16(24);
+    TransferControlFlags driveMode = TransferControlFlags::kReceiverDrive;
+
+    TransferSession::TransferInitData initOptions;
+    initOptions.TransferCtlFlags = driveMode;
+    initOptions.MaxBlockSize     = blockSize;
+    char testFileDes[9]          = { "test.txt" };
+    initOptions.FileDesLength    = static_cast<uint16_t>(strlen(testFileDes));
+    initOptions.FileDesignator   = reinterpret_cast<uint8_t *>(testFileDes);
+
+    BitFlags<TransferControlFlags> senderOpts;
+    senderOpts.Set(driveMode);
+
+    SendAndVerifyTransferInit(inSuite, inContext, outEvent, timeout, initiatingReceiver, TransferRole::kReceiver, initOptions,
+                              respondingSender, senderOpts, blockSize);
+
+    NL_TEST_ASSERT(inSuite, initiatingReceiver.SetWindowSize(0) == CHIP_ERROR_INVALID_ARGUMENT);
+    NL_TEST_ASSERT(inSuite, initiatingReceiver.SetWindowSize(CHIP_CONFIG_BDX_MAX_WINDOW_SIZE + 1) == CHIP_ERROR_INVALID_ARGUMENT);
+    NL_TEST_ASSERT(inSuite, initiatingReceiver.SetWindowSize(windowSize) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, respondingSender.SetWindowSize(windowSize) == CHIP_NO_ERROR);
+
+    TransferSession::TransferAcceptData acceptData;
+    acceptData.ControlMode  = respondingSender.GetControlMode();
+    acceptData.StartOffset  = 0;
+    acceptData.Length       = 0;
+    acceptData.MaxBlockSize = blockSize;
+
+    SendAndVerifyAcceptMsg(inSuite, inContext, outEvent, respondingSender, TransferRole::kSender, acceptData, initiatingReceiver,
+                           initOptions);
+
+    // The window can't change once the transfer is accepted
+    NL_TEST_ASSERT(inSuite, respondingSender.SetWindowSize(1) == CHIP_ERROR_INCORRECT_STATE);
+    NL_TEST_ASSERT(inSuite, initiatingReceiver.GetWindowSize() == windowSize);
+}
+
+// Test a full windowed transfer in which the Blocks of each round trip arrive in reverse order.
+void TestWindowedReceiverDrive(nlTestSuite * inSuite, void * inContext)
+{
+    struct Message
+    {
+        TransferSession::MessageTypeData typeData;
+        System::PacketBufferHandle data;
+    };
+
+    constexpr uint8_t kWindowSize = 4;
+    constexpr uint16_t kBlockSize = 32;
+    constexpr uint32_t kNumBlocks = 10;
+
+    TransferSession::OutputEvent outEvent;
+    TransferSession initiatingReceiver;
+    TransferSession respondingSender;
+    uint8_t fileData[kNumBlocks * kBlockSize - kBlockSize / 2];
+
+    for (size_t i = 0; i < sizeof(fileData); i++)
+    {
+        fileData[i] = static_cast<uint8_t>(i * 7);
+    }
+
+    StartWindowedTransfer(inSuite, inContext, initiatingReceiver, respondingSender, kWindowSize, kBlockSize);
+
+    std::vector<Message> toSender;
+    std::vector<Message> toReceiver;
+    uint32_t numQueriesSent    = 0;
+    uint32_t numBlocksReceived = 0;
+    uint32_t numBlocksSent     = 0;
+    size_t numBytesSent        = 0;
+    bool ackEOFReceived        = false;
+
+    NL_TEST_ASSERT(inSuite, initiatingReceiver.PrepareBlockQuery() == CHIP_NO_ERROR);
+
+    for (int roundTrip = 0; roundTrip < 10 && !ackEOFReceived; roundTrip++)
+    {
+        for (initiatingReceiver.PollOutput(outEvent, kNoAdvanceTime); outEvent.EventType != TransferSession::OutputEventType::kNone;
+             initiatingReceiver.PollOutput(outEvent, kNoAdvanceTime))
+        {
+            if (outEvent.EventType == TransferSession::OutputEventType::kMsgToSend)
+            {
+                if (outEvent.msgTypeData.HasMessageType(MessageType::BlockQuery))
+                {
+                    numQueriesSent++;
+                    NL_TEST_ASSERT(inSuite, numQueriesSent - numBlocksReceived <= kWindowSize);
+                }
+                toSender.push_back({ outEvent.msgTypeData, std::move(outEvent.MsgData) });
+                continue;
+            }
+
+            // Blocks are emitted one at a time, in order, and only once the previous one was consumed
+            NL_TEST_ASSERT(inSuite, outEvent.EventType == TransferSession::OutputEventType::kBlockReceived);
+            VerifyOrReturn(outEvent.EventType == TransferSession::OutputEventType::kBlockReceived);
+            NL_TEST_ASSERT(inSuite, outEvent.blockdata.BlockCounter == numBlocksReceived);
+            NL_TEST_ASSERT(inSuite, !memcmp(outEvent.blockdata.Data, &fileData[numBlocksReceived * kBlockSize],
+                                            outEvent.blockdata.Length));
+            numBlocksReceived++;
+            NL_TEST_ASSERT(inSuite, outEvent.blockdata.IsEof == (numBlocksReceived == kNumBlocks));
+
+            CHIP_ERROR err =
+                outEvent.blockdata.IsEof ? initiatingReceiver.PrepareBlockAck() : initiatingReceiver.PrepareBlockQuery();
+            NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+        }
+
+        for (Message & message : toSender)
+        {
+            NL_TEST_ASSERT(inSuite, AttachHeaderAndSend(message.typeData, std::move(message.data), respondingSender) == CHIP_NO_ERROR);
+        }
+        toSender.clear();
+
+        for (respondingSender.PollOutput(outEvent, kNoAdvanceTime); outEvent.EventType != TransferSession::OutputEventType::kNone;
+             respondingSender.PollOutput(outEvent, kNoAdvanceTime))
+        {
+            if (outEvent.EventType == TransferSession::OutputEventType::kMsgToSend)
+            {
+                toReceiver.push_back({ outEvent.msgTypeData, std::move(outEvent.MsgData) });
+            }
+            else if (outEvent.EventType == TransferSession::OutputEventType::kAckEOFReceived)
+            {
+                ackEOFReceived = true;
+            }
+            else
+            {
+                NL_TEST_ASSERT(inSuite, outEvent.EventType == TransferSession::OutputEventType::kQueryReceived);
+
+                TransferSession::BlockData blockData;
+                blockData.Data   = &fileData[numBytesSent];
+                blockData.Length = ::chip::min<size_t>(kBlockSize, sizeof(fileData) - numBytesSent);
+                blockData.IsEof  = (++numBlocksSent == kNumBlocks);
+                numBytesSent += blockData.Length;
+                NL_TEST_ASSERT(inSuite, respondingSender.PrepareBlock(blockData) == CHIP_NO_ERROR);
+            }
+        }
+
+        for (auto message = toReceiver.rbegin(); message != toReceiver.rend(); ++message)
+        {
+            NL_TEST_ASSERT(inSuite,
+                           AttachHeaderAndSend(message->typeData, std::move(message->data), initiatingReceiver) == CHIP_NO_ERROR);
+        }
+        toReceiver.clear();
+    }
+
+    // The BlockQuery messages sent past the BlockEOF are left unanswered
+    NL_TEST_ASSERT(inSuite, ackEOFReceived);
+    NL_TEST_ASSERT(inSuite, numBlocksSent == kNumBlocks);
+    NL_TEST_ASSERT(inSuite, numQueriesSent > kNumBlocks);
+    NL_TEST_ASSERT(inSuite, initiatingReceiver.GetNumBytesProcessed() == sizeof(fileData));
+    VerifyNoMoreOutput(inSuite, inContext, initiatingReceiver);
+    VerifyNoMoreOutput(inSuite, inContext, respondingSender);
+}
+
+// Test that a windowed Sender rejects a BlockQuery past its window, and a windowed Receiver a Block it already has.
+void TestWindowedBlockCounterErrors(nlTestSuite * inSuite, void * inContext)
+{
+    constexpr uint8_t kWindowSize = 2;
+    constexpr uint16_t kBlockSize = 16;
+
+    TransferSession::OutputEvent outEvent;
+    TransferSession initiatingReceiver;
+    TransferSession respondingSender;
+    uint8_t fakeData[kBlockSize] = { 0 };
+
+    StartWindowedTransfer(inSuite, inContext, initiatingReceiver, respondingSender, kWindowSize, kBlockSize);
+
+    // The Receiver asks for the whole window at once
+    NL_TEST_ASSERT(inSuite, initiatingReceiver.PrepareBlockQuery() == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, initiatingReceiver.PrepareBlockQuery() == CHIP_ERROR_INCORRECT_STATE);
+    for (uint32_t counter = 0; counter < kWindowSize; counter++)
+    {
+        initiatingReceiver.PollOutput(outEvent, kNoAdvanceTime);
+        VerifyBdxMessageToSend(inSuite, inContext, outEvent, MessageType::BlockQuery);
+        NL_TEST_ASSERT(inSuite, AttachHeaderAndSend(outEvent.msgTypeData, std::move(outEvent.MsgData), respondingSender) ==
+                           CHIP_NO_ERROR);
+    }
+    VerifyNoMoreOutput(inSuite, inContext, initiatingReceiver);
+
+    // Answer the first BlockQuery, then hand the Block to the Receiver twice
+    respondingSender.PollOutput(outEvent, kNoAdvanceTime);
+    NL_TEST_ASSERT(inSuite, outEvent.EventType == TransferSession::OutputEventType::kQueryReceived);
+
+    TransferSession::BlockData blockData;
+    blockData.Data   = fakeData;
+    blockData.Length = sizeof(fakeData);
+    NL_TEST_ASSERT(inSuite, respondingSender.PrepareBlock(blockData) == CHIP_NO_ERROR);
+    respondingSender.PollOutput(outEvent, kNoAdvanceTime);
+    VerifyBdxMessageToSend(inSuite, inContext, outEvent, MessageType::Block);
+    System::PacketBufferHandle blockCopy =
+        System::PacketBufferHandle::NewWithData(outEvent.MsgData->Start(), outEvent.MsgData->DataLength());
+    TransferSession::MessageTypeData blockMsgTypeData = outEvent.msgTypeData;
+
+    NL_TEST_ASSERT(inSuite, AttachHeaderAndSend(blockMsgTypeData, std::move(outEvent.MsgData), initiatingReceiver) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, AttachHeaderAndSend(blockMsgTypeData, std::move(blockCopy), initiatingReceiver) == CHIP_NO_ERROR);
+    initiatingReceiver.PollOutput(outEvent, kNoAdvanceTime);
+    NL_TEST_ASSERT(inSuite, outEvent.EventType == TransferSession::OutputEventType::kMsgToSend);
+    VerifyStatusReport(inSuite, inContext, std::move(outEvent.MsgData), StatusCode::kBadBlockCounter);
+
+    // The Sender now waits for the BlockQuery of Block 2, which is past its window of Blocks 1 and 2 only once Block 1 is sent
+    respondingSender.PollOutput(outEvent, kNoAdvanceTime);
+    NL_TEST_ASSERT(inSuite, outEvent.EventType == TransferSession::OutputEventType::kQueryReceived);
+
+    BlockQuery queryMsg;
+    queryMsg.BlockCounter = 1 + kWindowSize;
+    size_t msgSize        = queryMsg.MessageSize();
+    Encoding::LittleEndian::PacketBufferWriter bbuf(System::PacketBufferHandle::New(msgSize), msgSize);
+    NL_TEST_ASSERT(inSuite, !bbuf.IsNull());
+    queryMsg.WriteToBuffer(bbuf);
+
+    TransferSession::MessageTypeData queryMsgTypeData;
+    queryMsgTypeData.ProtocolId  = Protocols::BDX::Id;
+    queryMsgTypeData.MessageType = static_cast<uint8_t>(MessageType::BlockQuery);
+    NL_TEST_ASSERT(inSuite, AttachHeaderAndSend(queryMsgTypeData, bbuf.Finalize(), respondingSender) == CHIP_NO_ERROR);
+    respondingSender.PollOutput(outEvent, kNoAdvanceTime);
+    NL_TEST_ASSERT(inSuite, outEvent.EventType == TransferSession::OutputEventType::kMsgToSend);
+    VerifyStatusReport(inSuite, inContext, std::move(outEvent.MsgData), StatusCode::kBadBlockCounter);
+}
+
 // Test Suite
 
 /**
@@ -737,6 +955,8 @@ static const nlTest sTests[] =
     NL_TEST_DEF("TestBadAcceptMessageFields", TestBadAcceptMessageFields),
     NL_TEST_DEF("TestTimeout", TestTimeout),
     NL_TEST_DEF("TestDuplicateBlockError", TestDuplicateBlockError),
+    NL_TEST_DEF("TestWindowedReceiverDrive", TestWindowedReceiverDrive),
+    NL_TEST_DEF("TestWindowedBlockCounterErrors", TestWindowedBlockCounterErrors),
     NL_TEST_SENTINEL()
 };
 // clang-format on
@@ -0,0 +1,51 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines the interface CASESession uses to run the expensive
+ *      cryptographic steps of a handshake off the CHIP event loop.
+ */
+
+#pragma once
+
+#include <lib/core/CHIPError.h>
+#include <lib/support/DLLUtil.h>
+
+namespace chip {
+
+class DLL_EXPORT CASECryptoOffload
+{
+public:
+    using WorkFunction      = void (*)(void * context);
+    using AfterWorkFunction = void (*)(void * context, CHIP_ERROR error);
+
+    virtual ~CASECryptoOffload() {}
+
+    /**
+     * Run work(context) on some other thread, then afterWork(context, error) back on the CHIP event loop.
+     *
+     * On success, both functions are called exactly once, and afterWork is only called once work has returned and Run has
+     * returned.  error is CHIP_NO_ERROR, or why the offload failed the job after running work (e.g. it could not get back
+     * to the event loop in time), in which case the caller must abandon what work was for.  On failure, neither function is
+     * called.
+     */
+    virtual CHIP_ERROR Run(WorkFunction work, AfterWorkFunction afterWork, void * context) = 0;
+};
+
+} // namespace chip
@@ -0,0 +1,171 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <protocols/secure_channel/CASECryptoThreadPool.h>
+
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+namespace chip {
+
+CHIP_ERROR CASECryptoThreadPool::Init(size_t threadCount, PostFunction post)
+{
+    VerifyOrReturnError(mThreadCount == 0, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(threadCount > 0 && threadCount <= kMaxThreads, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(post != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    mPost         = post;
+    mShuttingDown = false;
+    for (; mThreadCount < threadCount; mThreadCount++)
+    {
+        mThreads[mThreadCount] = std::thread(&CASECryptoThreadPool::ThreadMain, this);
+    }
+    return CHIP_NO_ERROR;
+}
+
+void CASECryptoThreadPool::Shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mShuttingDown = true;
+    }
+    mWakeUp.notify_all();
+
+    for (; mThreadCount > 0; mThreadCount--)
+    {
+        mThreads[mThreadCount - 1].join();
+    }
+
+    while (mUnposted != nullptr)
+    {
+        Job * job = mUnposted;
+        mUnposted = job->mNext;
+        RunAfterWork(reinterpret_cast<intptr_t>(job));
+    }
+}
+
+CHIP_ERROR CASECryptoThreadPool::Run(WorkFunction work, AfterWorkFunction afterWork, void * context)
+{
+    VerifyOrReturnError(work != nullptr && afterWork != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    Job * job = Platform::New<Job>();
+    VerifyOrReturnError(job != nullptr, CHIP_ERROR_NO_MEMORY);
+    job->mWork      = work;
+    job->mAfterWork = afterWork;
+    job->mContext   = context;
+    job->mError     = CHIP_NO_ERROR;
+    job->mNext      = nullptr;
+
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        if (mThreadCount == 0 || mShuttingDown)
+        {
+            Platform::Delete(job);
+            return CHIP_ERROR_INCORRECT_STATE;
+        }
+
+        if (mLast == nullptr)
+        {
+            mFirst = job;
+        }
+        else
+        {
+            mLast->mNext = job;
+        }
+        mLast = job;
+    }
+    mWakeUp.notify_one();
+
+    return CHIP_NO_ERROR;
+}
+
+void CASECryptoThreadPool::RunAfterWork(intptr_t arg)
+{
+    Job * job = reinterpret_cast<Job *>(arg);
+    job->mAfterWork(job->mContext, job->mError);
+    Platform::Delete(job);
+}
+
+void CASECryptoThreadPool::PostAfterWork(Job * job)
+{
+    CHIP_ERROR err = mPost(RunAfterWork, reinterpret_cast<intptr_t>(job));
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(SecureChannel, "Failed to post CASE crypto completion: %" CHIP_ERROR_FORMAT, err.Format());
+        if (job->mError == CHIP_NO_ERROR)
+        {
+            job->mError = err;
+        }
+
+        std::lock_guard<std::mutex> lock(mLock);
+        job->mNext = mUnposted;
+        mUnposted  = job;
+    }
+}
+
+void CASECryptoThreadPool::ThreadMain()
+{
+    std::unique_lock<std::mutex> lock(mLock);
+    while (true)
+    {
+        if (mFirst != nullptr)
+        {
+            Job * job = mFirst;
+            mFirst    = job->mNext;
+            if (mFirst == nullptr)
+            {
+                mLast = nullptr;
+            }
+
+            lock.unlock();
+            job->mWork(job->mContext);
+            PostAfterWork(job);
+            lock.lock();
+        }
+        else if (mShuttingDown)
+        {
+            // Shutdown runs the afterWork of whatever is left in mUnposted.
+            return;
+        }
+        else if (mUnposted == nullptr)
+        {
+            mWakeUp.wait(lock);
+        }
+        else if (mWakeUp.wait_for(lock, kPostRetryInterval) == std::cv_status::timeout)
+        {
+            Job * unposted = mUnposted;
+            mUnposted      = nullptr;
+
+            lock.unlock();
+            while (unposted != nullptr)
+            {
+                Job * job = unposted;
+                unposted  = job->mNext;
+                PostAfterWork(job);
+            }
+            lock.lock();
+        }
+    }
+}
+
+} // namespace chip
+
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
@@ -0,0 +1,101 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines a pool of worker threads that runs the cryptographic
+ *      steps of CASE handshakes, so that many handshakes can progress at once.
+ */
+
+#pragma once
+
+#include <protocols/secure_channel/CASECryptoOffload.h>
+#include <system/SystemConfig.h>
+
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+
+namespace chip {
+
+/**
+ * CASECryptoOffload running work on a fixed set of threads, in the order it was submitted.
+ *
+ * The pool does not know about the event loop: it hands each afterWork to the post function given to Init, which is called
+ * from the worker threads and must get it called on the event loop, e.g. with PlatformManager::ScheduleWork.  When the post
+ * function fails, the job fails with its error: the pool keeps trying to post the afterWork every kPostRetryInterval, and
+ * afterWork gets that error, so that e.g. the CASE handshake is aborted rather than left waiting.
+ *
+ * The crypto backend must be safe to use from several threads at once.
+ */
+class DLL_EXPORT CASECryptoThreadPool : public CASECryptoOffload
+{
+public:
+    using PostFunction = CHIP_ERROR (*)(void (*function)(intptr_t arg), intptr_t arg);
+
+    static constexpr size_t kMaxThreads = 16;
+    static constexpr std::chrono::milliseconds kPostRetryInterval{ 10 };
+
+    ~CASECryptoThreadPool() override { Shutdown(); }
+
+    CHIP_ERROR Init(size_t threadCount, PostFunction post);
+
+    /**
+     * Run the work already submitted, then stop the threads.  The afterWork of that work is still posted, except for the
+     * jobs that failed to post, whose afterWork is called from here: Shutdown must be called on the event loop.
+     */
+    void Shutdown();
+
+    CHIP_ERROR Run(WorkFunction work, AfterWorkFunction afterWork, void * context) override;
+
+private:
+    struct Job
+    {
+        WorkFunction mWork;
+        AfterWorkFunction mAfterWork;
+        void * mContext;
+        CHIP_ERROR mError;
+        Job * mNext;
+    };
+
+    static void RunAfterWork(intptr_t job);
+    // Called without mLock held.
+    void PostAfterWork(Job * job);
+    void ThreadMain();
+
+    std::mutex mLock;
+    std::condition_variable mWakeUp;
+    // Jobs not picked up by a thread yet, oldest first.
+    Job * mFirst       = nullptr;
+    Job * mLast        = nullptr;
+    // Jobs that ran but whose afterWork failed to post, in no particular order.
+    Job * mUnposted    = nullptr;
+    bool mShuttingDown = false;
+
+    std::thread mThreads[kMaxThreads];
+    size_t mThreadCount = 0;
+    PostFunction mPost  = nullptr;
+};
+
+} // namespace chip
+
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
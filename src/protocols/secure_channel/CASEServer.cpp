@@ -31,7 +31,8 @@ namespace chip {
 
 CHIP_ERROR CASEServer::ListenForSessionEstablishment(Messaging::ExchangeManager * exchangeManager, TransportMgrBase * transportMgr,
                                                      Ble::BleLayer * bleLayer, SessionManager * sessionManager,
-                                                     FabricTable * fabrics, SessionIDAllocator * idAllocator)
+                                                     FabricTable * fabrics, SessionIDAllocator * idAllocator,
+                                                     CASESessionCache * sessionCache)
 {
     VerifyOrReturnError(transportMgr != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
     VerifyOrReturnError(exchangeManager != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
@@ -43,6 +44,7 @@ CHIP_ERROR CASEServer::ListenForSessionEstablishment(Messaging::ExchangeManager
     mFabrics         = fabrics;
     mExchangeManager = exchangeManager;
     mIDAllocator     = idAllocator;
+    mSessionCache    = sessionCache;
 
     Cleanup();
     return CHIP_NO_ERROR;
@@ -72,7 +74,7 @@ CHIP_ERROR CASEServer::InitCASEHandshake(Messaging::ExchangeContext * ec)
 
     // Setup CASE state machine using the credentials for the current fabric.
     ReturnErrorOnFailure(GetSession().ListenForSessionEstablishment(
-        mSessionKeyId, mFabrics, this, Optional<ReliableMessageProtocolConfig>::Value(gDefaultMRPConfig)));
+        mSessionKeyId, mFabrics, this, Optional<ReliableMessageProtocolConfig>::Value(gDefaultMRPConfig), mSessionCache));
 
     // Hand over the exchange context to the CASE session.
     ec->SetDelegate(&GetSession());
@@ -136,6 +138,21 @@ void CASEServer::OnSessionEstablished()
         return;
     }
 
+    if (mSessionCache != nullptr)
+    {
+        // Keep the state of the session, so that the peer can resume it later, even after a restart.
+        CASESessionCachable cachableSession;
+        err = GetSession().ToCachable(cachableSession);
+        if (err == CHIP_NO_ERROR)
+        {
+            err = mSessionCache->Add(cachableSession);
+        }
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(Inet, "Failed to cache the CASE session for resumption: err %s", ErrorStr(err));
+        }
+    }
+
     ChipLogProgress(Inet, "CASE secure channel is available now.");
     Cleanup();
 }
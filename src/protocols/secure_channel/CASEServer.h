@@ -21,6 +21,7 @@
 #include <messaging/ExchangeDelegate.h>
 #include <messaging/ExchangeMgr.h>
 #include <protocols/secure_channel/CASESession.h>
+#include <protocols/secure_channel/CASESessionCache.h>
 #include <protocols/secure_channel/SessionIDAllocator.h>
 
 namespace chip {
@@ -39,7 +40,7 @@ public:
 
     CHIP_ERROR ListenForSessionEstablishment(Messaging::ExchangeManager * exchangeManager, TransportMgrBase * transportMgr,
                                              Ble::BleLayer * bleLayer, SessionManager * sessionManager, FabricTable * fabrics,
-                                             SessionIDAllocator * idAllocator);
+                                             SessionIDAllocator * idAllocator, CASESessionCache * sessionCache = nullptr);
 
     //////////// SessionEstablishmentDelegate Implementation ///////////////
     void OnSessionEstablishmentError(CHIP_ERROR error) override;
@@ -61,7 +62,8 @@ private:
     SessionManager * mSessionManager = nullptr;
     Ble::BleLayer * mBleLayer        = nullptr;
 
-    FabricTable * mFabrics = nullptr;
+    FabricTable * mFabrics           = nullptr;
+    CASESessionCache * mSessionCache = nullptr;
 
     CHIP_ERROR InitCASEHandshake(Messaging::ExchangeContext * ec);
 
@@ -36,7 +36,9 @@
 #include <lib/support/ScopedBuffer.h>
 #include <lib/support/TypeTraits.h>
 #include <protocols/Protocols.h>
+#include <protocols/secure_channel/CASESessionCache.h>
 #include <protocols/secure_channel/StatusReport.h>
+#include <system/SystemMutex.h>
 #include <system/TLVPacketBufferBackingStore.h>
 #include <trace/trace.h>
 #include <transport/PairingSession.h>
@@ -89,6 +91,80 @@ using HKDF_sha_crypto = HKDF_sha;
 // The session establishment fails if the response is not received within timeout window.
 static constexpr ExchangeContext::Timeout kSigma_Response_Timeout = System::Clock::Seconds16(30);
 
+// A step of the handshake running with the crypto offload.  Clearing the session cancels it: Cancel waits for the step to
+// return if it is running, and the completion is then skipped.
+class CASESession::CryptoWork
+{
+public:
+    CryptoWork(CASESession & session, CryptoStep step, CryptoStepCompletion completion) :
+        mSession(&session), mStep(step), mCompletion(completion)
+    {}
+
+    CHIP_ERROR Init() { return System::Mutex::Init(mLock); }
+
+    CryptoStepContext & Context() { return mContext; }
+
+    void Cancel()
+    {
+        mLock.Lock();
+        mSession = nullptr;
+        mLock.Unlock();
+    }
+
+    static void Run(void * context)
+    {
+        CryptoWork * work = static_cast<CryptoWork *>(context);
+
+        work->mLock.Lock();
+        if (work->mSession != nullptr)
+        {
+            work->mStepError = (work->mSession->*work->mStep)(work->mContext);
+        }
+        work->mLock.Unlock();
+    }
+
+    static void AfterRun(void * context, CHIP_ERROR offloadError)
+    {
+        CryptoWork * work = static_cast<CryptoWork *>(context);
+
+        // Cancel also runs on the event loop, and the step has returned, so there is no need to lock.  If the offload failed
+        // the step, the completion aborts the handshake with that error.  The work, along with the received message and the
+        // copies of the credentials, is released here on the event loop too.
+        CASESession * session = work->mSession;
+        CHIP_ERROR stepError  = (offloadError != CHIP_NO_ERROR) ? offloadError : work->mStepError;
+
+        if (session == nullptr)
+        {
+            Platform::Delete(work);
+            return;
+        }
+        session->mCryptoWork = nullptr;
+
+        CHIP_ERROR err = (session->*work->mCompletion)(stepError, work->mContext);
+        Platform::Delete(work);
+        if (err != CHIP_NO_ERROR)
+        {
+            // Unlike in OnMessageReceived, the exchange is not handling a message, so let Clear() close it, unless the
+            // completion sent a status report: that send already closed it, since it expects no response.
+            if (session->mExchangeCtxt != nullptr && !session->mExchangeCtxt->IsSendExpected())
+            {
+                session->DiscardExchange();
+            }
+            session->Clear();
+            // Do this last in case the delegate frees us.
+            session->mDelegate->OnSessionEstablishmentError(err);
+        }
+    }
+
+private:
+    System::Mutex mLock;
+    CASESession * mSession;
+    CryptoStep mStep;
+    CryptoStepCompletion mCompletion;
+    CryptoStepContext mContext;
+    CHIP_ERROR mStepError = CHIP_NO_ERROR;
+};
+
 CASESession::CASESession()
 {
     SetSecureSessionType(Transport::SecureSession::Type::kCASE);
@@ -103,10 +179,18 @@ CASESession::~CASESession()
 
 void CASESession::Clear()
 {
+    // Don't clear the state a step running with the crypto offload is using.
+    if (mCryptoWork != nullptr)
+    {
+        mCryptoWork->Cancel();
+        mCryptoWork = nullptr;
+    }
+
     // This function zeroes out and resets the memory used by the object.
     // It's done so that no security related information will be leaked.
     mCommissioningHash.Clear();
     mCASESessionEstablished = false;
+    mCASESessionResumed     = false;
     PairingSession::Clear();
 
     mState = kInitialized;
@@ -148,8 +232,9 @@ CHIP_ERROR CASESession::ToCachable(CASESessionCachable & cachableSession)
     {
         cachableSession.mPeerCATs.values[i] = LittleEndian::HostSwap32(GetPeerCATs().values[i]);
     }
-    // TODO: Get the fabric index
-    cachableSession.mLocalFabricIndex      = 0;
+    cachableSession.mLocalFabricIndex      = (mFabricInfo != nullptr) ? mFabricInfo->GetFabricIndex() : mLocalFabricIndex;
+    cachableSession.mLocalCompressedFabricId =
+        (mFabricInfo != nullptr) ? mFabricInfo->GetPeerId().GetCompressedFabricId() : kUndefinedCompressedFabricId;
     cachableSession.mSessionSetupTimeStamp = LittleEndian::HostSwap64(mSessionSetupTimeStamp);
 
     memcpy(cachableSession.mResumptionId, mResumptionId, sizeof(mResumptionId));
@@ -207,13 +292,14 @@ CHIP_ERROR CASESession::Init(uint16_t localSessionId, SessionEstablishmentDelega
 
 CHIP_ERROR
 CASESession::ListenForSessionEstablishment(uint16_t localSessionId, FabricTable * fabrics, SessionEstablishmentDelegate * delegate,
-                                           Optional<ReliableMessageProtocolConfig> mrpConfig)
+                                           Optional<ReliableMessageProtocolConfig> mrpConfig, CASESessionCache * sessionCache)
 {
     VerifyOrReturnError(fabrics != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
     ReturnErrorOnFailure(Init(localSessionId, delegate));
 
     mFabricsTable   = fabrics;
     mLocalMRPConfig = mrpConfig;
+    mSessionCache   = sessionCache;
 
     mCASESessionEstablished = false;
 
@@ -229,6 +315,10 @@ CHIP_ERROR CASESession::EstablishSession(const Transport::PeerAddress peerAddres
     TRACE_EVENT_SCOPE("EstablishSession", "CASESession");
     CHIP_ERROR err = CHIP_NO_ERROR;
 
+    // Init() clears the state restored by FromCachable, which SendSigma1() needs to ask the peer to resume the session.
+    const bool resumable     = mCASESessionEstablished && GetPeerNodeId() == peerNodeId;
+    const CATValues peerCATs = GetPeerCATs();
+
     // Return early on error here, as we have not initialized any state yet
     ReturnErrorCodeIf(exchangeCtxt == nullptr, CHIP_ERROR_INVALID_ARGUMENT);
     ReturnErrorCodeIf(fabric == nullptr, CHIP_ERROR_INVALID_ARGUMENT);
@@ -249,6 +339,11 @@ CHIP_ERROR CASESession::EstablishSession(const Transport::PeerAddress peerAddres
     mExchangeCtxt->SetResponseTimeout(kSigma_Response_Timeout + mExchangeCtxt->GetSessionHandle()->GetAckTimeout());
     SetPeerAddress(peerAddress);
     SetPeerNodeId(peerNodeId);
+    if (resumable)
+    {
+        SetPeerCATs(peerCATs);
+        mCASESessionEstablished = true;
+    }
 
     err = SendSigma1();
     SuccessOrExit(err);
@@ -284,6 +379,17 @@ CHIP_ERROR CASESession::DeriveSecureSession(CryptoContext & session, CryptoConte
 
     VerifyOrReturnError(mCASESessionEstablished, CHIP_ERROR_INCORRECT_STATE);
 
+    if (mCASESessionResumed)
+    {
+        // The keys of a resumed session derive from the shared secret of the original session, salted with the random of
+        // the initiator and the new resumption ID.
+        uint8_t resumptionSalt[kSigmaParamRandomNumberSize + kCASEResumptionIDSize];
+        memcpy(&resumptionSalt[0], mInitiatorRandom, sizeof(mInitiatorRandom));
+        memcpy(&resumptionSalt[sizeof(mInitiatorRandom)], mResumptionId, sizeof(mResumptionId));
+        return session.InitFromSecret(ByteSpan(mSharedSecret, mSharedSecret.Length()), ByteSpan(resumptionSalt),
+                                      CryptoContext::SessionInfoType::kSessionResumption, role);
+    }
+
     // Generate Salt for Encryption keys
     saltlen = sizeof(mIPK) + kSHA256_Hash_Length;
 
@@ -366,6 +472,9 @@ CHIP_ERROR CASESession::SendSigma1()
                                                     ByteSpan(kResume1MIC_Nonce), resumeMICSpan));
 
         ReturnErrorOnFailure(tlvWriter.Put(TLV::ContextTag(7), resumeMICSpan));
+
+        // The new session is only established once the peer agrees to resume the previous one, or after a full handshake.
+        mCASESessionEstablished = false;
     }
 
     ReturnErrorOnFailure(tlvWriter.EndContainer(outerContainerType));
@@ -423,12 +532,15 @@ CHIP_ERROR CASESession::HandleSigma1(System::PacketBufferHandle && msg)
     ChipLogDetail(SecureChannel, "Peer assigned session key ID %d", initiatorSessionId);
     SetPeerSessionId(initiatorSessionId);
 
-    if (sessionResumptionRequested && resumptionId.data_equal(ByteSpan(mResumptionId)))
+    if (sessionResumptionRequested && RestoreResumableSession(resumptionId))
     {
         // Cross check resume1MIC with the shared secret
         if (ValidateSigmaResumeMIC(resume1MIC, initiatorRandom, resumptionId, ByteSpan(kKDFS1RKeyInfo),
                                    ByteSpan(kResume1MIC_Nonce)) == CHIP_NO_ERROR)
         {
+            memcpy(mInitiatorRandom, initiatorRandom.data(), sizeof(mInitiatorRandom));
+            mCASESessionResumed = true;
+
             // Send Sigma2Resume message to the initiator
             SuccessOrExit(err = SendSigma2Resume(initiatorRandom));
 
@@ -472,6 +584,34 @@ exit:
     return err;
 }
 
+bool CASESession::RestoreResumableSession(const ByteSpan & resumptionId)
+{
+    if (mSessionCache == nullptr)
+    {
+        // Without a cache, only the last session established with this object can be resumed.
+        return resumptionId.data_equal(ByteSpan(mResumptionId));
+    }
+
+    CASESessionCachable cachableSession;
+    VerifyOrReturnError(mFabricsTable != nullptr, false);
+    VerifyOrReturnError(mSessionCache->Get(ResumptionID(resumptionId.data()), cachableSession) == CHIP_NO_ERROR, false);
+    VerifyOrReturnError(FromCachable(cachableSession) == CHIP_NO_ERROR, false);
+
+    mFabricInfo = mFabricsTable->FindFabricWithIndex(cachableSession.mLocalFabricIndex);
+    VerifyOrReturnError(mFabricInfo != nullptr, false);
+    // A session established on a fabric that has since been removed must not be resumed on one that took over its index.
+    if (mFabricInfo->GetPeerId().GetCompressedFabricId() != cachableSession.mLocalCompressedFabricId)
+    {
+        mFabricInfo = nullptr;
+        mSessionCache->Remove(ResumptionID(resumptionId.data()));
+        return false;
+    }
+
+    // The restored session is only established once the initiator acknowledges the resumption.
+    mCASESessionEstablished = false;
+    return true;
+}
+
 CHIP_ERROR CASESession::SendSigma2Resume(const ByteSpan & initiatorRandom)
 {
     TRACE_EVENT_SCOPE("SendSigma2Resume", "CASESession");
@@ -704,6 +844,7 @@ CHIP_ERROR CASESession::HandleSigma2Resume(System::PacketBufferHandle && msg)
     // on running out of session contexts.
 
     mCASESessionEstablished = true;
+    mCASESessionResumed     = true;
 
     // Discard the exchange so that Clear() doesn't try closing it.  The
     // exchange will handle that.
@@ -724,22 +865,94 @@ exit:
 CHIP_ERROR CASESession::HandleSigma2_and_SendSigma3(System::PacketBufferHandle && msg)
 {
     TRACE_EVENT_SCOPE("HandleSigma2_and_SendSigma3", "CASESession");
-    ReturnErrorOnFailure(HandleSigma2(std::move(msg)));
-    ReturnErrorOnFailure(SendSigma3());
+    return RunCryptoStep(&CASESession::HandleSigma2_and_ConstructSigma3, &CASESession::SendSigma3, std::move(msg));
+}
+
+CHIP_ERROR CASESession::HandleSigma2_and_ConstructSigma3(CryptoStepContext & context)
+{
+    ReturnErrorOnFailure(HandleSigma2(context));
+    return ConstructSigma3(context);
+}
 
+CHIP_ERROR CASESession::PrepareCryptoStep(CryptoStepContext & context, System::PacketBufferHandle && msg)
+{
+    ByteSpan cert;
+
+    VerifyOrReturnError(mFabricInfo != nullptr, CHIP_ERROR_INCORRECT_STATE);
+    // The step reads the message where it lies, so it must be in a single buffer.
+    VerifyOrReturnError(!msg.IsNull() && !msg->HasChainedBuffer(), CHIP_ERROR_MESSAGE_INCOMPLETE);
+
+    ReturnErrorOnFailure(mFabricInfo->GetRootCert(cert));
+    ReturnErrorOnFailure(context.mFabric.SetRootCert(cert));
+    ReturnErrorOnFailure(mFabricInfo->GetICACert(cert));
+    ReturnErrorOnFailure(context.mFabric.SetICACert(cert));
+    ReturnErrorOnFailure(mFabricInfo->GetNOCCert(cert));
+    ReturnErrorOnFailure(context.mFabric.SetNOCCert(cert));
+
+    // The operational key is not copied, as it may live in a secure element: the step signs with the fabric's own key.
+    context.mOperationalKey = mFabricInfo->GetOperationalKey();
+    VerifyOrReturnError(context.mOperationalKey != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    context.mMessage = std::move(msg);
     return CHIP_NO_ERROR;
 }
 
-CHIP_ERROR CASESession::HandleSigma2(System::PacketBufferHandle && msg)
+CHIP_ERROR CASESession::RunCryptoStep(CryptoStep step, CryptoStepCompletion completion, System::PacketBufferHandle && msg)
+{
+    if (mCryptoOffload == nullptr)
+    {
+        CryptoStepContext context;
+        CHIP_ERROR stepError = PrepareCryptoStep(context, std::move(msg));
+        if (stepError == CHIP_NO_ERROR)
+        {
+            stepError = (this->*step)(context);
+        }
+        return (this->*completion)(stepError, context);
+    }
+
+    CryptoWork * work = Platform::New<CryptoWork>(*this, step, completion);
+    VerifyOrReturnError(work != nullptr, CHIP_ERROR_NO_MEMORY);
+
+    CHIP_ERROR err = PrepareCryptoStep(work->Context(), std::move(msg));
+    if (err != CHIP_NO_ERROR)
+    {
+        // Fail the step as it would fail without the offload.
+        err = (this->*completion)(err, work->Context());
+        Platform::Delete(work);
+        return err;
+    }
+
+    err = work->Init();
+    if (err == CHIP_NO_ERROR)
+    {
+        err = mCryptoOffload->Run(CryptoWork::Run, CryptoWork::AfterRun, work);
+    }
+    if (err != CHIP_NO_ERROR)
+    {
+        Platform::Delete(work);
+        return err;
+    }
+
+    // Keep the exchange open for the message the completion sends.
+    if (mExchangeCtxt != nullptr)
+    {
+        mExchangeCtxt->WillSendMessage();
+    }
+
+    mCryptoWork = work;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR CASESession::HandleSigma2(CryptoStepContext & context)
 {
     TRACE_EVENT_SCOPE("HandleSigma2", "CASESession");
     CHIP_ERROR err = CHIP_NO_ERROR;
-    System::PacketBufferTLVReader tlvReader;
+    TLV::ContiguousBufferTLVReader tlvReader;
     TLV::TLVReader decryptedDataTlvReader;
     TLV::TLVType containerType = TLV::kTLVType_Structure;
 
-    const uint8_t * buf = msg->Start();
-    size_t buflen       = msg->DataLength();
+    const uint8_t * buf = context.mMessage->Start();
+    size_t buflen       = context.mMessage->DataLength();
 
     uint8_t msg_salt[kIPKSize + kSigmaParamRandomNumberSize + kP256_PublicKey_Length + kSHA256_Hash_Length];
 
@@ -768,7 +981,7 @@ CHIP_ERROR CASESession::HandleSigma2(System::PacketBufferHandle && msg)
 
     ChipLogDetail(SecureChannel, "Received Sigma2 msg");
 
-    tlvReader.Init(std::move(msg));
+    tlvReader.Init(buf, buflen);
     SuccessOrExit(err = tlvReader.Next(containerType, TLV::AnonymousTag()));
     SuccessOrExit(err = tlvReader.EnterContainer(containerType));
 
@@ -839,7 +1052,7 @@ CHIP_ERROR CASESession::HandleSigma2(System::PacketBufferHandle && msg)
 
     // Validate responder identity located in msg_r2_encrypted
     // Constructing responder identity
-    SuccessOrExit(err = Validate_and_RetrieveResponderID(responderNOC, responderICAC, remoteCredential));
+    SuccessOrExit(err = Validate_and_RetrieveResponderID(context.mFabric, responderNOC, responderICAC, remoteCredential));
 
     // Construct msg_R2_Signed and validate the signature in msg_r2_encrypted
     msg_r2_signed_len = TLV::EstimateStructOverhead(sizeof(uint16_t), responderNOC.size(), responderICAC.size(),
@@ -877,23 +1090,15 @@ CHIP_ERROR CASESession::HandleSigma2(System::PacketBufferHandle && msg)
     }
 
 exit:
-    if (err != CHIP_NO_ERROR)
-    {
-        SendStatusReport(mExchangeCtxt, kProtocolCodeInvalidParam);
-    }
     return err;
 }
 
-CHIP_ERROR CASESession::SendSigma3()
+CHIP_ERROR CASESession::ConstructSigma3(CryptoStepContext & context)
 {
-    TRACE_EVENT_SCOPE("SendSigma3", "CASESession");
+    TRACE_EVENT_SCOPE("ConstructSigma3", "CASESession");
     CHIP_ERROR err = CHIP_NO_ERROR;
 
-    MutableByteSpan messageDigestSpan(mMessageDigest);
-    System::PacketBufferHandle msg_R3;
-    size_t data_len;
-
-    chip::Platform::ScopedMemoryBuffer<uint8_t> msg_R3_Encrypted;
+    chip::Platform::ScopedMemoryBuffer<uint8_t> & msg_R3_Encrypted = context.mOutput;
     size_t msg_r3_encrypted_len;
 
     uint8_t msg_salt[kIPKSize + kSHA256_Hash_Length];
@@ -905,17 +1110,13 @@ CHIP_ERROR CASESession::SendSigma3()
 
     P256ECDSASignature tbsData3Signature;
 
-    ChipLogDetail(SecureChannel, "Sending Sigma3");
-
     ByteSpan icaCert;
     ByteSpan nocCert;
 
-    VerifyOrExit(mFabricInfo != nullptr, err = CHIP_ERROR_INCORRECT_STATE);
+    SuccessOrExit(err = context.mFabric.GetICACert(icaCert));
+    SuccessOrExit(err = context.mFabric.GetNOCCert(nocCert));
 
-    SuccessOrExit(err = mFabricInfo->GetICACert(icaCert));
-    SuccessOrExit(err = mFabricInfo->GetNOCCert(nocCert));
-
-    SuccessOrExit(err = mFabricInfo->GetTrustedRootId(mTrustedRootId));
+    SuccessOrExit(err = context.mFabric.GetTrustedRootId(mTrustedRootId));
     VerifyOrExit(!mTrustedRootId.empty(), err = CHIP_ERROR_INTERNAL);
 
     // Prepare Sigma3 TBS Data Blob
@@ -927,8 +1128,7 @@ CHIP_ERROR CASESession::SendSigma3()
                                          ByteSpan(mRemotePubKey, mRemotePubKey.Length()), msg_R3_Signed.Get(), msg_r3_signed_len));
 
     // Generate a signature
-    VerifyOrExit(mFabricInfo->GetOperationalKey() != nullptr, err = CHIP_ERROR_INCORRECT_STATE);
-    err = mFabricInfo->GetOperationalKey()->ECDSA_sign_msg(msg_R3_Signed.Get(), msg_r3_signed_len, tbsData3Signature);
+    err = context.mOperationalKey->ECDSA_sign_msg(msg_R3_Signed.Get(), msg_r3_signed_len, tbsData3Signature);
     SuccessOrExit(err);
 
     // Prepare Sigma3 TBE Data Blob
@@ -972,10 +1172,25 @@ CHIP_ERROR CASESession::SendSigma3()
                           msg_R3_Encrypted.Get() + msg_r3_encrypted_len, CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES);
     SuccessOrExit(err);
 
-    // Generate Sigma3 Msg
-    data_len = TLV::EstimateStructOverhead(CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES, msg_r3_encrypted_len);
+    // The Sigma3 message itself is built by SendSigma3, on the event loop.
+    context.mOutputLength = msg_r3_encrypted_len + CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES;
 
-    msg_R3 = System::PacketBufferHandle::New(data_len);
+exit:
+    return err;
+}
+
+CHIP_ERROR CASESession::SendSigma3(CHIP_ERROR constructError, CryptoStepContext & context)
+{
+    TRACE_EVENT_SCOPE("SendSigma3", "CASESession");
+    CHIP_ERROR err = constructError;
+
+    MutableByteSpan messageDigestSpan(mMessageDigest);
+    System::PacketBufferHandle msg_R3;
+
+    SuccessOrExit(err);
+
+    // Generate Sigma3 Msg
+    msg_R3 = System::PacketBufferHandle::New(TLV::EstimateStructOverhead(context.mOutputLength));
     VerifyOrExit(!msg_R3.IsNull(), err = CHIP_ERROR_NO_MEMORY);
 
     {
@@ -985,8 +1200,7 @@ CHIP_ERROR CASESession::SendSigma3()
         tlvWriter.Init(std::move(msg_R3));
         err = tlvWriter.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, outerContainerType);
         SuccessOrExit(err);
-        err = tlvWriter.PutBytes(TLV::ContextTag(1), msg_R3_Encrypted.Get(),
-                                 static_cast<uint32_t>(msg_r3_encrypted_len + CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES));
+        err = tlvWriter.PutBytes(TLV::ContextTag(1), context.mOutput.Get(), static_cast<uint32_t>(context.mOutputLength));
         SuccessOrExit(err);
         err = tlvWriter.EndContainer(outerContainerType);
         SuccessOrExit(err);
@@ -994,6 +1208,8 @@ CHIP_ERROR CASESession::SendSigma3()
         SuccessOrExit(err);
     }
 
+    ChipLogDetail(SecureChannel, "Sending Sigma3");
+
     err = mCommissioningHash.AddData(ByteSpan{ msg_R3->Start(), msg_R3->DataLength() });
     SuccessOrExit(err);
 
@@ -1104,7 +1320,8 @@ CHIP_ERROR CASESession::HandleSigma3(System::PacketBufferHandle && msg)
     // Step 5/6
     // Validate initiator identity located in msg->Start()
     // Constructing responder identity
-    SuccessOrExit(err = Validate_and_RetrieveResponderID(initiatorNOC, initiatorICAC, remoteCredential));
+    VerifyOrExit(mFabricInfo != nullptr, err = CHIP_ERROR_INCORRECT_STATE);
+    SuccessOrExit(err = Validate_and_RetrieveResponderID(*mFabricInfo, initiatorNOC, initiatorICAC, remoteCredential));
 
     // Step 4 - Construct Sigma3 TBS Data
     msg_r3_signed_len = TLV::EstimateStructOverhead(sizeof(uint16_t), initiatorNOC.size(), initiatorICAC.size(),
@@ -1257,17 +1474,14 @@ CHIP_ERROR CASESession::ValidateSigmaResumeMIC(const ByteSpan & resumeMIC, const
     return CHIP_NO_ERROR;
 }
 
-CHIP_ERROR CASESession::Validate_and_RetrieveResponderID(const ByteSpan & responderNOC, const ByteSpan & responderICAC,
-                                                         Crypto::P256PublicKey & responderID)
+CHIP_ERROR CASESession::Validate_and_RetrieveResponderID(const FabricInfo & fabric, const ByteSpan & responderNOC,
+                                                         const ByteSpan & responderICAC, Crypto::P256PublicKey & responderID)
 {
-    ReturnErrorCodeIf(mFabricInfo == nullptr, CHIP_ERROR_INCORRECT_STATE);
-
     ReturnErrorOnFailure(SetEffectiveTime());
 
     PeerId peerId;
     FabricId rawFabricId;
-    ReturnErrorOnFailure(
-        mFabricInfo->VerifyCredentials(responderNOC, responderICAC, mValidContext, peerId, rawFabricId, responderID));
+    ReturnErrorOnFailure(fabric.VerifyCredentials(responderNOC, responderICAC, mValidContext, peerId, rawFabricId, responderID));
 
     SetPeerNodeId(peerId.GetNodeId());
 
@@ -1503,6 +1717,9 @@ CHIP_ERROR CASESession::OnMessageReceived(ExchangeContext * ec, const PayloadHea
     Protocols::SecureChannel::MsgType msgType = static_cast<Protocols::SecureChannel::MsgType>(payloadHeader.GetMessageType());
     SuccessOrExit(err);
 
+    // Messages are handled in order, so none can be handled before the step running with the crypto offload completes.
+    VerifyOrExit(mCryptoWork == nullptr, err = CHIP_ERROR_INCORRECT_STATE);
+
     // By default, CHIP_ERROR_INVALID_MESSAGE_TYPE is returned if in the current state
     // a message handler is not defined for the received message type.
     err = CHIP_ERROR_INVALID_MESSAGE_TYPE;
@@ -33,8 +33,10 @@
 #include <credentials/FabricTable.h>
 #include <lib/core/CHIPTLV.h>
 #include <lib/support/Base64.h>
+#include <lib/support/ScopedBuffer.h>
 #include <messaging/ExchangeContext.h>
 #include <messaging/ExchangeDelegate.h>
+#include <protocols/secure_channel/CASECryptoOffload.h>
 #include <protocols/secure_channel/Constants.h>
 #include <protocols/secure_channel/SessionEstablishmentDelegate.h>
 #include <protocols/secure_channel/SessionEstablishmentExchangeDispatch.h>
@@ -58,12 +60,16 @@ constexpr size_t kCASEResumptionIDSize = 16;
 #define CASE_EPHEMERAL_KEY 0xCA5EECD0
 #endif
 
+class CASESessionCache;
+
 struct CASESessionCachable
 {
     uint16_t mSharedSecretLen                              = 0;
     uint8_t mSharedSecret[Crypto::kMax_ECDH_Secret_Length] = { 0 };
     FabricIndex mLocalFabricIndex                          = 0;
-    NodeId mPeerNodeId                                     = kUndefinedNodeId;
+    // Identifies the fabric the session was established on, in case its index is reused for another fabric.
+    CompressedFabricId mLocalCompressedFabricId = kUndefinedCompressedFabricId;
+    NodeId mPeerNodeId                          = kUndefinedNodeId;
     CATValues mPeerCATs;
     uint8_t mResumptionId[kCASEResumptionIDSize] = { 0 };
     uint64_t mSessionSetupTimeStamp              = 0;
@@ -87,17 +93,22 @@ public:
      * @param mySessionId                   Session ID to be assigned to the secure session on the peer node
      * @param fabrics                       Table of fabrics that are currently configured on the device
      * @param delegate                      Callback object
+     * @param mrpConfig                     MRP parameters to advertise to the peer
+     * @param sessionCache                  Sessions the peer may ask to resume, if any
      *
      * @return CHIP_ERROR     The result of initialization
      */
     CHIP_ERROR ListenForSessionEstablishment(
         uint16_t mySessionId, FabricTable * fabrics, SessionEstablishmentDelegate * delegate,
-        Optional<ReliableMessageProtocolConfig> mrpConfig = Optional<ReliableMessageProtocolConfig>::Missing());
+        Optional<ReliableMessageProtocolConfig> mrpConfig = Optional<ReliableMessageProtocolConfig>::Missing(),
+        CASESessionCache * sessionCache = nullptr);
 
     /**
      * @brief
      *   Create and send session establishment request using device's operational credentials.
      *
+     *   If the state of a previous session with the peer was restored with FromCachable, the peer is asked to resume it.
+     *
      * @param peerAddress                   Address of peer with which to establish a session.
      * @param fabric                        The fabric that should be used for connecting with the peer
      * @param peerNodeId                    Node id of the peer node
@@ -164,6 +175,13 @@ public:
 
     FabricIndex GetFabricIndex() const { return mFabricInfo != nullptr ? mFabricInfo->GetFabricIndex() : kUndefinedFabricIndex; }
 
+    /**
+     * @brief
+     *   Run the expensive steps of the handshake (checking the responder's Sigma2 and signing Sigma3) with cryptoOffload,
+     *   rather than on the event loop.  Other messages are not handled while such a step runs.
+     **/
+    void SetCryptoOffload(CASECryptoOffload * cryptoOffload) { mCryptoOffload = cryptoOffload; }
+
     // TODO: remove Clear, we should create a new instance instead reset the old instance.
     /** @brief This function zeroes out and resets the memory used by the object.
      **/
@@ -191,17 +209,16 @@ private:
     CHIP_ERROR HandleSigma1(System::PacketBufferHandle && msg);
     CHIP_ERROR SendSigma2();
     CHIP_ERROR HandleSigma2_and_SendSigma3(System::PacketBufferHandle && msg);
-    CHIP_ERROR HandleSigma2(System::PacketBufferHandle && msg);
     CHIP_ERROR HandleSigma2Resume(System::PacketBufferHandle && msg);
-    CHIP_ERROR SendSigma3();
     CHIP_ERROR HandleSigma3(System::PacketBufferHandle && msg);
 
     CHIP_ERROR SendSigma2Resume(const ByteSpan & initiatorRandom);
+    bool RestoreResumableSession(const ByteSpan & resumptionId);
 
     CHIP_ERROR ConstructSaltSigma2(const ByteSpan & rand, const Crypto::P256PublicKey & pubkey, const ByteSpan & ipk,
                                    MutableByteSpan & salt);
-    CHIP_ERROR Validate_and_RetrieveResponderID(const ByteSpan & responderNOC, const ByteSpan & responderICAC,
-                                                Crypto::P256PublicKey & responderID);
+    CHIP_ERROR Validate_and_RetrieveResponderID(const FabricInfo & fabric, const ByteSpan & responderNOC,
+                                                const ByteSpan & responderICAC, Crypto::P256PublicKey & responderID);
     CHIP_ERROR ConstructTBSData(const ByteSpan & senderNOC, const ByteSpan & senderICAC, const ByteSpan & senderPubKey,
                                 const ByteSpan & receiverPubKey, uint8_t * tbsData, size_t & tbsDataLen);
     CHIP_ERROR ConstructSaltSigma3(const ByteSpan & ipk, MutableByteSpan & salt);
@@ -215,6 +232,32 @@ private:
     CHIP_ERROR ValidateSigmaResumeMIC(const ByteSpan & resumeMIC, const ByteSpan & initiatorRandom, const ByteSpan & resumptionID,
                                       const ByteSpan & skInfo, const ByteSpan & nonce);
 
+    class CryptoWork;
+
+    // What a step of the handshake running with mCryptoOffload may use besides the session's own handshake state.  The
+    // step runs without the stack lock, so RunCryptoStep copies the fabric's credentials and takes its operational key
+    // on the event loop beforehand, and the step only reads mMessage.  It leaves the payload of the message to send next
+    // in mOutput, which the completion puts into a packet buffer on the event loop.
+    struct CryptoStepContext
+    {
+        FabricInfo mFabric;
+        Crypto::P256Keypair * mOperationalKey = nullptr;
+        System::PacketBufferHandle mMessage;
+        Platform::ScopedMemoryBuffer<uint8_t> mOutput;
+        size_t mOutputLength = 0;
+    };
+
+    using CryptoStep           = CHIP_ERROR (CASESession::*)(CryptoStepContext & context);
+    using CryptoStepCompletion = CHIP_ERROR (CASESession::*)(CHIP_ERROR stepError, CryptoStepContext & context);
+
+    CHIP_ERROR RunCryptoStep(CryptoStep step, CryptoStepCompletion completion, System::PacketBufferHandle && msg);
+    CHIP_ERROR PrepareCryptoStep(CryptoStepContext & context, System::PacketBufferHandle && msg);
+
+    CHIP_ERROR HandleSigma2_and_ConstructSigma3(CryptoStepContext & context);
+    CHIP_ERROR HandleSigma2(CryptoStepContext & context);
+    CHIP_ERROR ConstructSigma3(CryptoStepContext & context);
+    CHIP_ERROR SendSigma3(CHIP_ERROR constructError, CryptoStepContext & context);
+
     void OnSuccessStatusReport() override;
     CHIP_ERROR OnFailureStatusReport(Protocols::SecureChannel::GeneralStatusCode generalCode, uint16_t protocolCode) override;
 
@@ -251,8 +294,9 @@ private:
 
     Messaging::ExchangeContext * mExchangeCtxt = nullptr;
 
-    FabricTable * mFabricsTable = nullptr;
-    FabricInfo * mFabricInfo    = nullptr;
+    FabricTable * mFabricsTable      = nullptr;
+    FabricInfo * mFabricInfo         = nullptr;
+    CASESessionCache * mSessionCache = nullptr;
 
     uint8_t mResumptionId[kCASEResumptionIDSize];
     // Sigma1 initiator random, maintained to be reused post-Sigma1, such as when generating Sigma2 S2RK key
@@ -265,8 +309,14 @@ private:
 
     Optional<ReliableMessageProtocolConfig> mLocalMRPConfig;
 
+    CASECryptoOffload * mCryptoOffload = nullptr;
+    // The step running with mCryptoOffload, if any.
+    CryptoWork * mCryptoWork = nullptr;
+
 protected:
     bool mCASESessionEstablished = false;
+    // Whether the session was established by resuming a previous one rather than with a full handshake.
+    bool mCASESessionResumed = false;
 
     virtual ByteSpan * GetIPKList() const
     {
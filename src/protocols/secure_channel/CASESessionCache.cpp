@@ -17,89 +17,434 @@
 
 #include <protocols/secure_channel/CASESessionCache.h>
 
+#include <crypto/CHIPCryptoPAL.h>
+#include <lib/core/CHIPEncoding.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/DefaultStorageKeyAllocator.h>
+#include <lib/support/logging/CHIPLogging.h>
+
 namespace chip {
 
-CASESessionCache::CASESessionCache() {}
+namespace {
+
+constexpr TLV::Tag kTagFabricIndex           = TLV::ContextTag(1);
+constexpr TLV::Tag kTagPeerNodeId            = TLV::ContextTag(2);
+constexpr TLV::Tag kTagPeerCATs              = TLV::ContextTag(3);
+constexpr TLV::Tag kTagResumptionId          = TLV::ContextTag(4);
+constexpr TLV::Tag kTagSharedSecret          = TLV::ContextTag(5);
+constexpr TLV::Tag kTagSessionSetupTimeStamp = TLV::ContextTag(6);
+constexpr TLV::Tag kTagSequence              = TLV::ContextTag(7);
+constexpr TLV::Tag kTagCompressedFabricId    = TLV::ContextTag(8);
+
+constexpr size_t kPersistedSessionSize =
+    TLV::EstimateStructOverhead(sizeof(FabricIndex), sizeof(NodeId), CATValues::size() * (1 + sizeof(CASEAuthTag)) + 2,
+                                kCASEResumptionIDSize, Crypto::kMax_ECDH_Secret_Length, sizeof(uint64_t), sizeof(uint32_t),
+                                sizeof(CompressedFabricId));
+
+} // namespace
+
+CASESessionCache::CASESessionCache()
+{
+    for (uint16_t index = 0; index < kCapacity; index++)
+    {
+        mEntries[index].mNext = static_cast<uint16_t>(index + 1 < kCapacity ? index + 1 : kNone);
+    }
+    mFree = (kCapacity > 0) ? 0 : kNone;
+
+    for (uint16_t bucket = 0; bucket < kBucketCount; bucket++)
+    {
+        mByResumptionId[bucket] = kNone;
+        mByPeer[bucket]         = kNone;
+    }
+}
 
 CASESessionCache::~CASESessionCache()
 {
-    mCachePool.ForEachActiveObject([&](auto * ec) {
-        mCachePool.ReleaseObject(ec);
-        return Loop::Continue;
-    });
+    for (auto & entry : mEntries)
+    {
+        Crypto::ClearSecretData(entry.mSession.mSharedSecret, sizeof(entry.mSession.mSharedSecret));
+    }
 }
 
-CASESessionCachable * CASESessionCache::GetLRUSession()
+CHIP_ERROR CASESessionCache::Init(PersistentStorageDelegate * storage)
 {
-    uint64_t minTimeStamp            = UINT64_MAX;
-    CASESessionCachable * lruSession = nullptr;
-    mCachePool.ForEachActiveObject([&](auto * ec) {
-        if (minTimeStamp > ec->mSessionSetupTimeStamp)
+    VerifyOrReturnError(mCount == 0, CHIP_ERROR_INCORRECT_STATE);
+
+    mStorage = storage;
+    VerifyOrReturnError(mStorage != nullptr, CHIP_NO_ERROR);
+
+    // Read back every slot, keeping the slots loaded sorted from the oldest session to the newest.
+    uint16_t loaded[kCapacity > 0 ? kCapacity : 1];
+    uint16_t loadedCount = 0;
+    for (uint16_t index = 0; index < kCapacity; index++)
+    {
+        CHIP_ERROR err = Load(index);
+        if (err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND)
         {
-            minTimeStamp = ec->mSessionSetupTimeStamp;
-            lruSession   = ec;
+            continue;
         }
-        return Loop::Continue;
-    });
-    return lruSession;
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(SecureChannel, "Dropping unreadable CASE resumption state %u: %" CHIP_ERROR_FORMAT, index, err.Format());
+            DefaultStorageKeyAllocator key;
+            mStorage->SyncDeleteKeyValue(key.CASESessionResumption(index));
+            continue;
+        }
+
+        uint16_t position = loadedCount++;
+        for (; position > 0 && mEntries[loaded[position - 1]].mSequence > mEntries[index].mSequence; position--)
+        {
+            loaded[position] = loaded[position - 1];
+        }
+        loaded[position] = index;
+    }
+
+    mFree = kNone;
+    for (uint16_t index = kCapacity; index-- > 0;)
+    {
+        if (!mEntries[index].mInUse)
+        {
+            mEntries[index].mNext = mFree;
+            mFree                 = index;
+        }
+    }
+
+    for (uint16_t position = 0; position < loadedCount; position++)
+    {
+        const uint16_t index = loaded[position];
+        // Only the newest session with a peer may have survived an interrupted update.
+        ReturnErrorOnFailure(ReleaseSuperseded(mEntries[index].mSession));
+        Link(index);
+        mSequence = mEntries[index].mSequence + 1;
+    }
+
+    return CHIP_NO_ERROR;
 }
 
 CHIP_ERROR CASESessionCache::Add(CASESessionCachable & cachableSession)
 {
     // It's not an error if a device doesn't have cache for storing the sessions.
-    VerifyOrReturnError(mCachePool.Capacity() > 0, CHIP_NO_ERROR);
+    VerifyOrReturnError(kCapacity > 0, CHIP_NO_ERROR);
+
+    ReturnErrorOnFailure(ReleaseSuperseded(cachableSession));
 
-    // If the cache is full, get the least recently used session index and release that.
-    if (mCachePool.Exhausted())
+    // If the cache is full, release the oldest session.
+    if (mFree == kNone)
     {
-        mCachePool.ReleaseObject(GetLRUSession());
+        ReturnErrorOnFailure(Release(mOldest));
     }
 
-    mCachePool.CreateObject(cachableSession);
-    return CHIP_NO_ERROR;
+    const uint16_t index = mFree;
+    Entry & entry        = mEntries[index];
+    mFree                = entry.mNext;
+    entry.mSession       = cachableSession;
+    entry.mSequence      = mSequence++;
+    Link(index);
+
+    return Save(index);
 }
 
 CHIP_ERROR CASESessionCache::Remove(ResumptionID resumptionID)
+{
+    const uint16_t index = FindByResumptionId(resumptionID.data());
+    VerifyOrReturnError(index != kNone, CHIP_NO_ERROR);
+    return Release(index);
+}
+
+CHIP_ERROR CASESessionCache::RemoveFabric(FabricIndex fabricIndex)
 {
     CHIP_ERROR err = CHIP_NO_ERROR;
-    CASESession session;
-    mCachePool.ForEachActiveObject([&](auto * ec) {
-        if (resumptionID.data_equal(ResumptionID(ec->mResumptionId)))
+    for (uint16_t index = mOldest; index != kNone;)
+    {
+        const uint16_t next = mEntries[index].mNext;
+        if (mEntries[index].mSession.mLocalFabricIndex == fabricIndex)
         {
-            mCachePool.ReleaseObject(ec);
+            // Keep going so that a storage failure does not leave the other sessions of the fabric behind.
+            CHIP_ERROR releaseErr = Release(index);
+            err                   = (err == CHIP_NO_ERROR) ? releaseErr : err;
         }
-        return Loop::Continue;
-    });
-
+        index = next;
+    }
     return err;
 }
 
 CHIP_ERROR CASESessionCache::Get(ResumptionID resumptionID, CASESessionCachable & outSessionCachable)
 {
-    CHIP_ERROR err = CHIP_NO_ERROR;
-    bool found     = false;
-    mCachePool.ForEachActiveObject([&](auto * ec) {
-        if (resumptionID.data_equal(ResumptionID(ec->mResumptionId)))
+    const uint16_t index = FindByResumptionId(resumptionID.data());
+    VerifyOrReturnError(index != kNone, CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND);
+    outSessionCachable = mEntries[index].mSession;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR CASESessionCache::Get(FabricIndex fabricIndex, NodeId peerNodeId, CASESessionCachable & outSessionCachable)
+{
+    // Cached sessions hold the peer node ID in little-endian order, see CASESession::ToCachable.
+    const uint16_t index = FindByPeer(fabricIndex, Encoding::LittleEndian::HostSwap64(peerNodeId));
+    VerifyOrReturnError(index != kNone, CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND);
+    outSessionCachable = mEntries[index].mSession;
+    return CHIP_NO_ERROR;
+}
+
+uint32_t CASESessionCache::HashResumptionId(const uint8_t * resumptionId)
+{
+    // Resumption IDs are random.
+    return Encoding::LittleEndian::Get32(resumptionId);
+}
+
+uint32_t CASESessionCache::HashPeer(FabricIndex fabricIndex, NodeId peerNodeId)
+{
+    const uint64_t hash = (peerNodeId ^ (static_cast<uint64_t>(fabricIndex) << 56)) * UINT64_C(0x9E3779B97F4A7C15);
+    return static_cast<uint32_t>(hash >> 32);
+}
+
+uint32_t CASESessionCache::ResumptionIdHashOf(const CASESessionCachable & session)
+{
+    return HashResumptionId(session.mResumptionId);
+}
+
+uint32_t CASESessionCache::PeerHashOf(const CASESessionCachable & session)
+{
+    return HashPeer(session.mLocalFabricIndex, session.mPeerNodeId);
+}
+
+template <typename Matches>
+uint16_t CASESessionCache::FindBucket(const uint16_t * buckets, uint32_t hash, Matches matches) const
+{
+    // The tables are never full, so probing stops at an empty bucket if no entry matches.
+    uint16_t bucket = static_cast<uint16_t>(hash % kBucketCount);
+    while (buckets[bucket] != kNone && !matches(buckets[bucket]))
+    {
+        bucket = static_cast<uint16_t>((bucket + 1) % kBucketCount);
+    }
+    return bucket;
+}
+
+void CASESessionCache::RemoveBucket(uint16_t * buckets, uint16_t bucket, HashFunction hashFunction)
+{
+    // Shift back the entries that follow in the probe sequence, so that lookups need no tombstones.
+    uint16_t hole = bucket;
+    uint16_t next = static_cast<uint16_t>((hole + 1) % kBucketCount);
+    for (; buckets[next] != kNone; next = static_cast<uint16_t>((next + 1) % kBucketCount))
+    {
+        const uint16_t home = static_cast<uint16_t>(hashFunction(mEntries[buckets[next]].mSession) % kBucketCount);
+        // An entry stays put if its home bucket lies cyclically in (hole, next].
+        const bool stays = (hole < next) ? (hole < home && home <= next) : (hole < home || home <= next);
+        if (!stays)
         {
-            found              = true;
-            outSessionCachable = *ec;
-            return Loop::Break;
+            buckets[hole] = buckets[next];
+            hole          = next;
         }
-        return Loop::Continue;
+    }
+    buckets[hole] = kNone;
+}
+
+uint16_t CASESessionCache::FindByResumptionId(const uint8_t * resumptionId) const
+{
+    const uint16_t bucket = FindBucket(mByResumptionId, HashResumptionId(resumptionId), [&](uint16_t index) {
+        return memcmp(mEntries[index].mSession.mResumptionId, resumptionId, kCASEResumptionIDSize) == 0;
+    });
+    return mByResumptionId[bucket];
+}
+
+uint16_t CASESessionCache::FindByPeer(FabricIndex fabricIndex, NodeId peerNodeId) const
+{
+    const uint16_t bucket = FindBucket(mByPeer, HashPeer(fabricIndex, peerNodeId), [&](uint16_t index) {
+        return mEntries[index].mSession.mLocalFabricIndex == fabricIndex && mEntries[index].mSession.mPeerNodeId == peerNodeId;
     });
+    return mByPeer[bucket];
+}
 
-    if (!found)
+void CASESessionCache::Link(uint16_t index)
+{
+    Entry & entry = mEntries[index];
+    entry.mInUse  = true;
+    entry.mPrev   = mNewest;
+    entry.mNext   = kNone;
+    if (mNewest != kNone)
     {
-        err = CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND;
+        mEntries[mNewest].mNext = index;
     }
+    else
+    {
+        mOldest = index;
+    }
+    mNewest = index;
 
-    return err;
+    auto none = [](uint16_t) { return false; };
+    mByResumptionId[FindBucket(mByResumptionId, ResumptionIdHashOf(entry.mSession), none)] = index;
+    mByPeer[FindBucket(mByPeer, PeerHashOf(entry.mSession), none)]                          = index;
+    mCount++;
 }
 
-CHIP_ERROR CASESessionCache::Get(const PeerId & peer, CASESessionCachable & outSessionCachable)
+CHIP_ERROR CASESessionCache::Release(uint16_t index)
 {
-    // TODO: Implement this based on peer id
+    Entry & entry = mEntries[index];
+    auto self     = [&](uint16_t other) { return other == index; };
+    RemoveBucket(mByResumptionId, FindBucket(mByResumptionId, ResumptionIdHashOf(entry.mSession), self), ResumptionIdHashOf);
+    RemoveBucket(mByPeer, FindBucket(mByPeer, PeerHashOf(entry.mSession), self), PeerHashOf);
+
+    if (entry.mPrev != kNone)
+    {
+        mEntries[entry.mPrev].mNext = entry.mNext;
+    }
+    else
+    {
+        mOldest = entry.mNext;
+    }
+    if (entry.mNext != kNone)
+    {
+        mEntries[entry.mNext].mPrev = entry.mPrev;
+    }
+    else
+    {
+        mNewest = entry.mPrev;
+    }
+
+    Crypto::ClearSecretData(entry.mSession.mSharedSecret, sizeof(entry.mSession.mSharedSecret));
+    entry.mInUse = false;
+    entry.mPrev  = kNone;
+    entry.mNext  = mFree;
+    mFree        = index;
+    mCount--;
+
+    VerifyOrReturnError(mStorage != nullptr, CHIP_NO_ERROR);
+    DefaultStorageKeyAllocator key;
+    CHIP_ERROR err = mStorage->SyncDeleteKeyValue(key.CASESessionResumption(index));
+    return (err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND) ? CHIP_NO_ERROR : err;
+}
+
+CHIP_ERROR CASESessionCache::ReleaseSuperseded(const CASESessionCachable & session)
+{
+    uint16_t index = FindByPeer(session.mLocalFabricIndex, session.mPeerNodeId);
+    if (index != kNone)
+    {
+        ReturnErrorOnFailure(Release(index));
+    }
+
+    index = FindByResumptionId(session.mResumptionId);
+    if (index != kNone)
+    {
+        ReturnErrorOnFailure(Release(index));
+    }
+
     return CHIP_NO_ERROR;
 }
 
+CHIP_ERROR CASESessionCache::Save(uint16_t index)
+{
+    VerifyOrReturnError(mStorage != nullptr, CHIP_NO_ERROR);
+
+    uint8_t buffer[kPersistedSessionSize];
+    TLV::TLVWriter writer;
+    writer.Init(buffer);
+    CHIP_ERROR err = Serialize(mEntries[index], writer);
+
+    DefaultStorageKeyAllocator key;
+    if (err == CHIP_NO_ERROR)
+    {
+        err = mStorage->SyncSetKeyValue(key.CASESessionResumption(index), buffer,
+                                        static_cast<uint16_t>(writer.GetLengthWritten()));
+    }
+    Crypto::ClearSecretData(buffer, sizeof(buffer));
+    return err;
+}
+
+CHIP_ERROR CASESessionCache::Load(uint16_t index)
+{
+    uint8_t buffer[kPersistedSessionSize];
+    uint16_t size = sizeof(buffer);
+    DefaultStorageKeyAllocator key;
+    CHIP_ERROR err = mStorage->SyncGetKeyValue(key.CASESessionResumption(index), buffer, size);
+
+    if (err == CHIP_NO_ERROR)
+    {
+        TLV::TLVReader reader;
+        reader.Init(buffer, size);
+        err = Deserialize(reader, mEntries[index]);
+        mEntries[index].mInUse = (err == CHIP_NO_ERROR);
+    }
+    Crypto::ClearSecretData(buffer, sizeof(buffer));
+    return err;
+}
+
+CHIP_ERROR CASESessionCache::Serialize(const Entry & entry, TLV::TLVWriter & writer)
+{
+    const CASESessionCachable & session = entry.mSession;
+    const uint16_t sharedSecretLength   = Encoding::LittleEndian::HostSwap16(session.mSharedSecretLen);
+    VerifyOrReturnError(sharedSecretLength <= sizeof(session.mSharedSecret), CHIP_ERROR_INVALID_ARGUMENT);
+
+    TLV::TLVType outerType;
+    TLV::TLVType catsType;
+    ReturnErrorOnFailure(writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, outerType));
+    ReturnErrorOnFailure(writer.Put(kTagFabricIndex, session.mLocalFabricIndex));
+    ReturnErrorOnFailure(writer.Put(kTagPeerNodeId, Encoding::LittleEndian::HostSwap64(session.mPeerNodeId)));
+    ReturnErrorOnFailure(writer.StartContainer(kTagPeerCATs, TLV::kTLVType_Array, catsType));
+    for (CASEAuthTag cat : session.mPeerCATs.values)
+    {
+        ReturnErrorOnFailure(writer.Put(TLV::AnonymousTag(), Encoding::LittleEndian::HostSwap32(cat)));
+    }
+    ReturnErrorOnFailure(writer.EndContainer(catsType));
+    ReturnErrorOnFailure(writer.Put(kTagResumptionId, ByteSpan(session.mResumptionId)));
+    ReturnErrorOnFailure(writer.Put(kTagSharedSecret, ByteSpan(session.mSharedSecret, sharedSecretLength)));
+    ReturnErrorOnFailure(
+        writer.Put(kTagSessionSetupTimeStamp, Encoding::LittleEndian::HostSwap64(session.mSessionSetupTimeStamp)));
+    ReturnErrorOnFailure(writer.Put(kTagSequence, entry.mSequence));
+    ReturnErrorOnFailure(writer.Put(kTagCompressedFabricId, session.mLocalCompressedFabricId));
+    ReturnErrorOnFailure(writer.EndContainer(outerType));
+    return writer.Finalize();
+}
+
+CHIP_ERROR CASESessionCache::Deserialize(TLV::TLVReader & reader, Entry & entry)
+{
+    CASESessionCachable & session = entry.mSession;
+    TLV::TLVType outerType;
+    TLV::TLVType catsType;
+    NodeId peerNodeId;
+    uint64_t sessionSetupTimeStamp;
+    ByteSpan bytes;
+
+    ReturnErrorOnFailure(reader.Next(TLV::kTLVType_Structure, TLV::AnonymousTag()));
+    ReturnErrorOnFailure(reader.EnterContainer(outerType));
+
+    ReturnErrorOnFailure(reader.Next(kTagFabricIndex));
+    ReturnErrorOnFailure(reader.Get(session.mLocalFabricIndex));
+
+    ReturnErrorOnFailure(reader.Next(kTagPeerNodeId));
+    ReturnErrorOnFailure(reader.Get(peerNodeId));
+    session.mPeerNodeId = Encoding::LittleEndian::HostSwap64(peerNodeId);
+
+    ReturnErrorOnFailure(reader.Next(TLV::kTLVType_Array, kTagPeerCATs));
+    ReturnErrorOnFailure(reader.EnterContainer(catsType));
+    for (CASEAuthTag & cat : session.mPeerCATs.values)
+    {
+        ReturnErrorOnFailure(reader.Next(TLV::AnonymousTag()));
+        ReturnErrorOnFailure(reader.Get(cat));
+        cat = Encoding::LittleEndian::HostSwap32(cat);
+    }
+    ReturnErrorOnFailure(reader.ExitContainer(catsType));
+
+    ReturnErrorOnFailure(reader.Next(kTagResumptionId));
+    ReturnErrorOnFailure(reader.Get(bytes));
+    VerifyOrReturnError(bytes.size() == sizeof(session.mResumptionId), CHIP_ERROR_INVALID_TLV_ELEMENT);
+    memcpy(session.mResumptionId, bytes.data(), bytes.size());
+
+    ReturnErrorOnFailure(reader.Next(kTagSharedSecret));
+    ReturnErrorOnFailure(reader.Get(bytes));
+    VerifyOrReturnError(bytes.size() <= sizeof(session.mSharedSecret), CHIP_ERROR_INVALID_TLV_ELEMENT);
+    memcpy(session.mSharedSecret, bytes.data(), bytes.size());
+    session.mSharedSecretLen = Encoding::LittleEndian::HostSwap16(static_cast<uint16_t>(bytes.size()));
+
+    ReturnErrorOnFailure(reader.Next(kTagSessionSetupTimeStamp));
+    ReturnErrorOnFailure(reader.Get(sessionSetupTimeStamp));
+    session.mSessionSetupTimeStamp = Encoding::LittleEndian::HostSwap64(sessionSetupTimeStamp);
+
+    ReturnErrorOnFailure(reader.Next(kTagSequence));
+    ReturnErrorOnFailure(reader.Get(entry.mSequence));
+
+    ReturnErrorOnFailure(reader.Next(kTagCompressedFabricId));
+    ReturnErrorOnFailure(reader.Get(session.mLocalCompressedFabricId));
+
+    return reader.ExitContainer(outerType);
+}
+
 } // namespace chip
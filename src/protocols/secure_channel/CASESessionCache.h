@@ -18,6 +18,8 @@
 #pragma once
 
 #include <lib/core/CHIPError.h>
+#include <lib/core/CHIPPersistentStorageDelegate.h>
+#include <lib/core/CHIPTLV.h>
 #include <lib/core/PeerId.h>
 #include <protocols/secure_channel/CASESession.h>
 
@@ -25,20 +27,93 @@ namespace chip {
 
 using ResumptionID = FixedByteSpan<kCASEResumptionIDSize>;
 
+/**
+ * Store of the state needed to resume CASE sessions, looked up by resumption ID when a peer asks to resume and by peer when
+ * resuming a session with it.
+ *
+ * Both lookups go through hash tables, and sessions are kept in the order they were added so that, once the store is full,
+ * adding a session evicts the oldest one without scanning.  A peer has at most one session stored: adding a session with a
+ * peer replaces the previous one, whose resumption ID the new session superseded.
+ *
+ * With storage (see Init), every session is also persisted under its own key, so the store uses at most
+ * CHIP_CONFIG_CASE_SESSION_RESUME_CACHE_SIZE keys, and sessions can be resumed after a restart.
+ */
 class CASESessionCache
 {
 public:
     CASESessionCache();
     virtual ~CASESessionCache();
 
+    /**
+     * Load the sessions persisted in storage, and from then on persist the sessions added.  Without storage, which is the
+     * default, sessions are only kept in memory.
+     */
+    CHIP_ERROR Init(PersistentStorageDelegate * storage);
+
     CHIP_ERROR Add(CASESessionCachable & cachableSession);
     CHIP_ERROR Remove(ResumptionID resumptionID);
+    /**
+     * Remove every session established on the fabric, from memory and from storage.
+     */
+    CHIP_ERROR RemoveFabric(FabricIndex fabricIndex);
     CHIP_ERROR Get(ResumptionID resumptionID, CASESessionCachable & outCachableSession);
-    CHIP_ERROR Get(const PeerId & peer, CASESessionCachable & outCachableSession);
+    CHIP_ERROR Get(FabricIndex fabricIndex, NodeId peerNodeId, CASESessionCachable & outCachableSession);
+
+    size_t Count() const { return mCount; }
 
 private:
-    BitMapObjectPool<CASESessionCachable, CHIP_CONFIG_CASE_SESSION_RESUME_CACHE_SIZE> mCachePool;
-    CASESessionCachable * GetLRUSession();
+    static constexpr uint16_t kCapacity = CHIP_CONFIG_CASE_SESSION_RESUME_CACHE_SIZE;
+    // Keep the hash tables at most half full so that probe sequences stay short.
+    static constexpr uint16_t kBucketCount = 2 * kCapacity + 1;
+    static constexpr uint16_t kNone        = UINT16_MAX;
+
+    static_assert(kCapacity < kNone / 2, "CHIP_CONFIG_CASE_SESSION_RESUME_CACHE_SIZE is too large");
+
+    struct Entry
+    {
+        CASESessionCachable mSession;
+        // Order in which the sessions were added, persisted so that it survives a restart.
+        uint32_t mSequence = 0;
+        // Links of the list of sessions from the oldest to the newest, or of the free list.
+        uint16_t mPrev = kNone;
+        uint16_t mNext = kNone;
+        bool mInUse    = false;
+    };
+
+    using HashFunction = uint32_t (*)(const CASESessionCachable & session);
+
+    static uint32_t HashResumptionId(const uint8_t * resumptionId);
+    static uint32_t HashPeer(FabricIndex fabricIndex, NodeId peerNodeId);
+    static uint32_t ResumptionIdHashOf(const CASESessionCachable & session);
+    static uint32_t PeerHashOf(const CASESessionCachable & session);
+
+    template <typename Matches>
+    uint16_t FindBucket(const uint16_t * buckets, uint32_t hash, Matches matches) const;
+    void RemoveBucket(uint16_t * buckets, uint16_t bucket, HashFunction hashFunction);
+    uint16_t FindByResumptionId(const uint8_t * resumptionId) const;
+    uint16_t FindByPeer(FabricIndex fabricIndex, NodeId peerNodeId) const;
+
+    void Link(uint16_t index);
+    CHIP_ERROR Release(uint16_t index);
+    CHIP_ERROR ReleaseSuperseded(const CASESessionCachable & session);
+
+    CHIP_ERROR Save(uint16_t index);
+    CHIP_ERROR Load(uint16_t index);
+    static CHIP_ERROR Serialize(const Entry & entry, TLV::TLVWriter & writer);
+    static CHIP_ERROR Deserialize(TLV::TLVReader & reader, Entry & entry);
+
+    // A capacity of zero disables the cache.
+    Entry mEntries[kCapacity > 0 ? kCapacity : 1];
+    uint16_t mByResumptionId[kBucketCount];
+    uint16_t mByPeer[kBucketCount];
+
+    uint16_t mOldest   = kNone;
+    uint16_t mNewest   = kNone;
+    uint16_t mFree     = kNone;
+    uint16_t mCount    = 0;
+    uint32_t mSequence = 0;
+
+    PersistentStorageDelegate * mStorage = nullptr;
 };
 
 } // namespace chip
@@ -22,14 +22,23 @@
 namespace chip {
 
 uint16_t SessionIDAllocator::sNextAvailable = 1;
+size_t SessionIDAllocator::sRecycleHead     = 0;
+size_t SessionIDAllocator::sRecycleCount    = 0;
+uint16_t SessionIDAllocator::sRecycleQueue[kRecycleQueueSize];
 
 CHIP_ERROR SessionIDAllocator::Allocate(uint16_t & id)
 {
+    if (sRecycleCount > 0)
+    {
+        id           = sRecycleQueue[sRecycleHead];
+        sRecycleHead = (sRecycleHead + 1) % kRecycleQueueSize;
+        sRecycleCount--;
+        return CHIP_NO_ERROR;
+    }
+
     VerifyOrReturnError(sNextAvailable < kMaxSessionID, CHIP_ERROR_NO_MEMORY);
     VerifyOrReturnError(sNextAvailable > kUnsecuredSessionId, CHIP_ERROR_INTERNAL);
     id = sNextAvailable;
-
-    // TODO - Update SessionID allocator to use freed session IDs
     sNextAvailable++;
 
     return CHIP_NO_ERROR;
@@ -38,10 +47,19 @@ CHIP_ERROR SessionIDAllocator::Allocate(uint16_t & id)
 void SessionIDAllocator::Free(uint16_t id)
 {
     // As per spec 4.4.1.3 Session ID of 0 is reserved for Unsecure communication
-    if (sNextAvailable > (kUnsecuredSessionId + 1) && (sNextAvailable - 1) == id)
+    VerifyOrReturn(id > kUnsecuredSessionId && id < sNextAvailable);
+    VerifyOrReturn(!IsQueuedForRecycling(id));
+
+    if ((sNextAvailable - 1) == id)
     {
         sNextAvailable--;
+        return;
     }
+
+    // When the queue is full, the ID is leaked, as it was before IDs were recycled.
+    VerifyOrReturn(sRecycleCount < kRecycleQueueSize);
+    sRecycleQueue[(sRecycleHead + sRecycleCount) % kRecycleQueueSize] = id;
+    sRecycleCount++;
 }
 
 CHIP_ERROR SessionIDAllocator::Reserve(uint16_t id)
@@ -52,8 +70,7 @@ CHIP_ERROR SessionIDAllocator::Reserve(uint16_t id)
         sNextAvailable = id;
         sNextAvailable++;
     }
-
-    // TODO - Check if ID is already allocated in SessionIDAllocator::Reserve()
+    RemoveFromRecycleQueue(id, id);
 
     return CHIP_NO_ERROR;
 }
@@ -66,11 +83,7 @@ CHIP_ERROR SessionIDAllocator::ReserveUpTo(uint16_t id)
         sNextAvailable = id;
         sNextAvailable++;
     }
-
-    // TODO - Update ReserveUpTo to mark all IDs in use
-    // Current SessionIDAllocator only tracks the smallest unused session ID.
-    // If/when we change it to track all in use IDs, we should also update ReserveUpTo
-    // to reserve all individual session IDs, instead of just setting the sNextAvailable.
+    RemoveFromRecycleQueue(kUnsecuredSessionId + 1, id);
 
     return CHIP_NO_ERROR;
 }
@@ -80,4 +93,32 @@ uint16_t SessionIDAllocator::Peek()
     return sNextAvailable;
 }
 
+bool SessionIDAllocator::IsQueuedForRecycling(uint16_t id)
+{
+    for (size_t i = 0; i < sRecycleCount; i++)
+    {
+        if (sRecycleQueue[(sRecycleHead + i) % kRecycleQueueSize] == id)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void SessionIDAllocator::RemoveFromRecycleQueue(uint16_t lowestId, uint16_t highestId)
+{
+    // Compact the queue in place, keeping the order of the IDs that remain.
+    size_t kept = 0;
+    for (size_t i = 0; i < sRecycleCount; i++)
+    {
+        const uint16_t queuedId = sRecycleQueue[(sRecycleHead + i) % kRecycleQueueSize];
+        if (queuedId < lowestId || queuedId > highestId)
+        {
+            sRecycleQueue[(sRecycleHead + kept) % kRecycleQueueSize] = queuedId;
+            kept++;
+        }
+    }
+    sRecycleCount = kept;
+}
+
 } // namespace chip
@@ -17,7 +17,9 @@
 
 #pragma once
 
+#include <lib/core/CHIPConfig.h>
 #include <lib/core/CHIPError.h>
+#include <stddef.h>
 #include <stdint.h>
 
 // Spec 4.4.1.3
@@ -30,6 +32,10 @@
 //
 // The Session ID is allocated from a global numerical space shared across all fabrics and nodes on the resident process instance.
 //
+// Freed session IDs below the highest allocated one are kept in a bounded queue, sized by
+// CHIP_CONFIG_SESSION_ID_RECYCLE_QUEUE_SIZE, and handed out again before any new ID. The queue is first in, first out, so that
+// a freed ID stays unused for as long as possible.
+//
 
 namespace chip {
 
@@ -49,7 +55,17 @@ private:
     static constexpr uint16_t kMaxSessionID       = UINT16_MAX;
     static constexpr uint16_t kUnsecuredSessionId = 0;
 
+    static constexpr size_t kRecycleQueueSize = CHIP_CONFIG_SESSION_ID_RECYCLE_QUEUE_SIZE;
+
+    static bool IsQueuedForRecycling(uint16_t id);
+    static void RemoveFromRecycleQueue(uint16_t lowestId, uint16_t highestId);
+
     static uint16_t sNextAvailable;
+
+    // Ring buffer of the freed IDs, oldest first.
+    static uint16_t sRecycleQueue[kRecycleQueueSize];
+    static size_t sRecycleHead;
+    static size_t sRecycleCount;
 };
 
 } // namespace chip
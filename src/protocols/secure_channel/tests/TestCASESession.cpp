@@ -30,15 +30,25 @@
 #include <lib/support/CHIPMem.h>
 #include <lib/support/CodeUtils.h>
 #include <lib/support/ScopedBuffer.h>
+#include <lib/support/TestPersistentStorageDelegate.h>
 #include <lib/support/UnitTestRegistration.h>
 #include <messaging/tests/MessagingContext.h>
+#include <protocols/secure_channel/CASECryptoThreadPool.h>
 #include <protocols/secure_channel/CASEServer.h>
 #include <protocols/secure_channel/CASESession.h>
+#include <protocols/secure_channel/CASESessionCache.h>
 #include <stdarg.h>
+#include <system/SystemConfig.h>
 #include <transport/raw/tests/NetworkTestHelpers.h>
 
 #include "credentials/tests/CHIPCert_test_vectors.h"
 
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+#endif
+
 using namespace chip;
 using namespace Credentials;
 using namespace TestCerts;
@@ -260,10 +270,10 @@ void CASE_SecurePairingHandshakeTest(nlTestSuite * inSuite, void * inContext)
     CASE_SecurePairingHandshakeTestCommon(inSuite, inContext, pairingCommissioner, delegateCommissioner);
 }
 
-class TestPersistentStorageDelegate : public PersistentStorageDelegate, public FabricStorage
+class TestFabricStorageDelegate : public PersistentStorageDelegate, public FabricStorage
 {
 public:
-    TestPersistentStorageDelegate()
+    TestFabricStorageDelegate()
     {
         memset(keys, 0, sizeof(keys));
         memset(keysize, 0, sizeof(keysize));
@@ -271,7 +281,7 @@ public:
         memset(valuesize, 0, sizeof(valuesize));
     }
 
-    ~TestPersistentStorageDelegate() { Cleanup(); }
+    ~TestFabricStorageDelegate() { Cleanup(); }
 
     void Cleanup()
     {
@@ -347,8 +357,8 @@ private:
     uint16_t valuesize[16];
 };
 
-TestPersistentStorageDelegate gCommissionerStorageDelegate;
-TestPersistentStorageDelegate gDeviceStorageDelegate;
+TestFabricStorageDelegate gCommissionerStorageDelegate;
+TestFabricStorageDelegate gDeviceStorageDelegate;
 
 TestCASEServerIPK gPairingServer;
 
@@ -394,6 +404,330 @@ void CASE_SecurePairingHandshakeServerTest(nlTestSuite * inSuite, void * inConte
     chip::Platform::Delete(pairingCommissioner1);
 }
 
+constexpr size_t kReconnectCount = 16;
+
+// Connect to gPairingServer count times and return the time it took in microseconds.  With cachableSession, each connection
+// asks to resume the previous session, if any, and the session established is kept for the next one.
+uint64_t CASE_ConnectToServer(nlTestSuite * inSuite, TestContext & ctx, size_t count, CASESessionCachable * cachableSession,
+                              uint32_t expectedMessageCount)
+{
+    FabricInfo * fabric = gCommissionerFabrics.FindFabricWithIndex(gCommissionerFabricIndex);
+    NL_TEST_ASSERT(inSuite, fabric != nullptr);
+
+    const uint64_t begin = System::SystemClock().GetMonotonicMicroseconds64().count();
+    for (size_t i = 0; i < count; i++)
+    {
+        TestCASESecurePairingDelegate delegateCommissioner;
+        TestCASESessionIPK pairingCommissioner;
+        if (cachableSession != nullptr && cachableSession->mSharedSecretLen != 0)
+        {
+            NL_TEST_ASSERT(inSuite, pairingCommissioner.FromCachable(*cachableSession) == CHIP_NO_ERROR);
+        }
+
+        gLoopback.mSentMessageCount           = 0;
+        ExchangeContext * contextCommissioner = ctx.NewUnauthenticatedExchangeToBob(&pairingCommissioner);
+        NL_TEST_ASSERT(inSuite,
+                       pairingCommissioner.EstablishSession(Transport::PeerAddress(Transport::Type::kBle), fabric, Node01_01, 0,
+                                                            contextCommissioner, &delegateCommissioner) == CHIP_NO_ERROR);
+        ctx.DrainAndServiceIO();
+
+        NL_TEST_ASSERT(inSuite, gLoopback.mSentMessageCount == expectedMessageCount);
+        NL_TEST_ASSERT(inSuite, delegateCommissioner.mNumPairingComplete == 1);
+
+        if (cachableSession != nullptr)
+        {
+            NL_TEST_ASSERT(inSuite, pairingCommissioner.ToCachable(*cachableSession) == CHIP_NO_ERROR);
+        }
+    }
+    return System::SystemClock().GetMonotonicMicroseconds64().count() - begin;
+}
+
+void CASE_SessionResumptionServerTest(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+
+    // Sigma1, Sigma2, Sigma3, the status report and its ack for a full handshake, Sigma1, Sigma2Resume, the status report
+    // and its ack for a resumed session.
+    constexpr uint32_t kHandshakeMessageCount = 5;
+    constexpr uint32_t kResumedMessageCount   = 4;
+
+    SessionIDAllocator idAllocator;
+    TestPersistentStorageDelegate storage;
+    CASESessionCachable cachableSession;
+
+    // Without the store, every reconnection goes through a full handshake.
+    NL_TEST_ASSERT(inSuite,
+                   gPairingServer.ListenForSessionEstablishment(&ctx.GetExchangeManager(), &ctx.GetTransportMgr(), nullptr,
+                                                                &ctx.GetSecureSessionManager(), &gDeviceFabrics,
+                                                                &idAllocator) == CHIP_NO_ERROR);
+    const uint64_t handshakeTime = CASE_ConnectToServer(inSuite, ctx, kReconnectCount, nullptr, kHandshakeMessageCount);
+
+    {
+        CASESessionCache sessionCache;
+        NL_TEST_ASSERT(inSuite, sessionCache.Init(&storage) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite,
+                       gPairingServer.ListenForSessionEstablishment(&ctx.GetExchangeManager(), &ctx.GetTransportMgr(), nullptr,
+                                                                    &ctx.GetSecureSessionManager(), &gDeviceFabrics, &idAllocator,
+                                                                    &sessionCache) == CHIP_NO_ERROR);
+        CASE_ConnectToServer(inSuite, ctx, 1, &cachableSession, kHandshakeMessageCount);
+        NL_TEST_ASSERT(inSuite, sessionCache.Count() == 1);
+    }
+
+    // With the store, the sessions are resumed, even after a restart of the server.
+    CASESessionCache sessionCache;
+    NL_TEST_ASSERT(inSuite, sessionCache.Init(&storage) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, sessionCache.Count() == 1);
+    NL_TEST_ASSERT(inSuite,
+                   gPairingServer.ListenForSessionEstablishment(&ctx.GetExchangeManager(), &ctx.GetTransportMgr(), nullptr,
+                                                                &ctx.GetSecureSessionManager(), &gDeviceFabrics, &idAllocator,
+                                                                &sessionCache) == CHIP_NO_ERROR);
+    const uint64_t resumedTime = CASE_ConnectToServer(inSuite, ctx, kReconnectCount, &cachableSession, kResumedMessageCount);
+
+    // Every resumption superseded the session it resumed.
+    NL_TEST_ASSERT(inSuite, sessionCache.Count() == 1);
+
+    // A session stored for another fabric that held the same index is not resumed, and is dropped from the store.
+    CASESessionCachable storedSession;
+    NL_TEST_ASSERT(inSuite, sessionCache.Get(ResumptionID(cachableSession.mResumptionId), storedSession) == CHIP_NO_ERROR);
+    storedSession.mLocalCompressedFabricId ^= 1;
+    NL_TEST_ASSERT(inSuite, sessionCache.Add(storedSession) == CHIP_NO_ERROR);
+    CASE_ConnectToServer(inSuite, ctx, 1, &cachableSession, kHandshakeMessageCount);
+    NL_TEST_ASSERT(inSuite, sessionCache.Count() == 1);
+    NL_TEST_ASSERT(inSuite,
+                   sessionCache.Get(ResumptionID(storedSession.mResumptionId), storedSession) ==
+                       CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND);
+
+    printf("%u reconnects: full handshake %u us, resumed after restart %u us\n", static_cast<unsigned>(kReconnectCount),
+           static_cast<unsigned>(handshakeTime), static_cast<unsigned>(resumedTime));
+
+    NL_TEST_ASSERT(inSuite,
+                   gPairingServer.ListenForSessionEstablishment(&ctx.GetExchangeManager(), &ctx.GetTransportMgr(), nullptr,
+                                                                &ctx.GetSecureSessionManager(), &gDeviceFabrics,
+                                                                &idAllocator) == CHIP_NO_ERROR);
+}
+
+constexpr size_t kConcurrentSessionCount = 24;
+// The loopback context has room for the exchanges of this many handshakes at once.
+constexpr size_t kMaxConcurrentHandshakes = 4;
+
+// Hands each Sigma1 to a session of its own, so that handshakes run concurrently.
+class TestCASEAccessories : public ExchangeDelegate
+{
+public:
+    CHIP_ERROR Listen()
+    {
+        for (auto & session : mSessions)
+        {
+            ReturnErrorOnFailure(session.ListenForSessionEstablishment(0, &gDeviceFabrics, &mDelegate));
+        }
+        return CHIP_NO_ERROR;
+    }
+
+    CHIP_ERROR OnMessageReceived(ExchangeContext * ec, const PayloadHeader & payloadHeader,
+                                 System::PacketBufferHandle && payload) override
+    {
+        VerifyOrReturnError(mNextSession < kConcurrentSessionCount, CHIP_ERROR_NO_MEMORY);
+        TestCASESessionIPK & session = mSessions[mNextSession++];
+        ec->SetDelegate(&session);
+        return session.OnMessageReceived(ec, payloadHeader, std::move(payload));
+    }
+
+    void OnResponseTimeout(ExchangeContext * ec) override {}
+
+    ExchangeMessageDispatch & GetMessageDispatch() override { return SessionEstablishmentExchangeDispatch::Instance(); }
+
+    TestCASESecurePairingDelegate mDelegate;
+
+private:
+    TestCASESessionIPK mSessions[kConcurrentSessionCount];
+    size_t mNextSession = 0;
+};
+
+struct TestCASECommissioners
+{
+    TestCASESecurePairingDelegate mDelegate;
+    TestCASESessionIPK mSessions[kConcurrentSessionCount];
+};
+
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+
+// Stands in for PlatformManager::ScheduleWork: the crypto thread pool posts the completions of the steps it ran here, and
+// RunPostedCryptoCompletions runs them on the test thread.
+std::mutex gCryptoCompletionsLock;
+std::condition_variable gCryptoCompletionPosted;
+std::vector<std::pair<void (*)(intptr_t), intptr_t>> gCryptoCompletions;
+// How many of the next posts fail, as if the event queue were full.
+size_t gFailedCryptoCompletionPosts = 0;
+
+CHIP_ERROR PostCryptoCompletion(void (*function)(intptr_t arg), intptr_t arg)
+{
+    {
+        std::lock_guard<std::mutex> lock(gCryptoCompletionsLock);
+        if (gFailedCryptoCompletionPosts > 0)
+        {
+            gFailedCryptoCompletionPosts--;
+            return CHIP_ERROR_NO_MEMORY;
+        }
+        gCryptoCompletions.emplace_back(function, arg);
+    }
+    gCryptoCompletionPosted.notify_one();
+    return CHIP_NO_ERROR;
+}
+
+void RunPostedCryptoCompletions()
+{
+    std::vector<std::pair<void (*)(intptr_t), intptr_t>> completions;
+    {
+        std::unique_lock<std::mutex> lock(gCryptoCompletionsLock);
+        gCryptoCompletionPosted.wait_for(lock, std::chrono::milliseconds(1), [] { return !gCryptoCompletions.empty(); });
+        completions.swap(gCryptoCompletions);
+    }
+    for (auto & completion : completions)
+    {
+        completion.first(completion.second);
+    }
+}
+
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+
+// Establish kConcurrentSessionCount sessions, kMaxConcurrentHandshakes at a time, and return the time it took in microseconds.
+uint64_t CASE_EstablishConcurrentSessions(nlTestSuite * inSuite, TestContext & ctx, CASECryptoOffload * cryptoOffload)
+{
+    FabricInfo * fabric = gCommissionerFabrics.FindFabricWithIndex(gCommissionerFabricIndex);
+    NL_TEST_ASSERT(inSuite, fabric != nullptr);
+
+    auto * accessories   = chip::Platform::New<TestCASEAccessories>();
+    auto * commissioners = chip::Platform::New<TestCASECommissioners>();
+    NL_TEST_ASSERT(inSuite, accessories != nullptr && commissioners != nullptr);
+
+    NL_TEST_ASSERT(inSuite, accessories->Listen() == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite,
+                   ctx.GetExchangeManager().RegisterUnsolicitedMessageHandlerForType(Protocols::SecureChannel::MsgType::CASE_Sigma1,
+                                                                                     accessories) == CHIP_NO_ERROR);
+
+    TestCASESecurePairingDelegate & commissionerDelegate = commissioners->mDelegate;
+    TestCASESecurePairingDelegate & accessoryDelegate    = accessories->mDelegate;
+    size_t started                                       = 0;
+
+    const uint64_t begin    = System::SystemClock().GetMonotonicMicroseconds64().count();
+    const uint64_t deadline = begin + 30 * 1000 * 1000;
+    while ((commissionerDelegate.mNumPairingComplete + commissionerDelegate.mNumPairingErrors < kConcurrentSessionCount ||
+            accessoryDelegate.mNumPairingComplete + accessoryDelegate.mNumPairingErrors < kConcurrentSessionCount) &&
+           System::SystemClock().GetMonotonicMicroseconds64().count() < deadline)
+    {
+        const size_t done = accessoryDelegate.mNumPairingComplete + accessoryDelegate.mNumPairingErrors;
+        for (; started < kConcurrentSessionCount && started - done < kMaxConcurrentHandshakes; started++)
+        {
+            TestCASESessionIPK & session = commissioners->mSessions[started];
+            session.SetCryptoOffload(cryptoOffload);
+            ExchangeContext * exchange = ctx.NewUnauthenticatedExchangeToBob(&session);
+            NL_TEST_ASSERT(inSuite,
+                           session.EstablishSession(Transport::PeerAddress(Transport::Type::kBle), fabric, Node01_01, 0, exchange,
+                                                    &commissionerDelegate) == CHIP_NO_ERROR);
+        }
+
+        ctx.DrainAndServiceIO();
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+        if (cryptoOffload != nullptr)
+        {
+            RunPostedCryptoCompletions();
+        }
+#endif
+    }
+    const uint64_t elapsed = System::SystemClock().GetMonotonicMicroseconds64().count() - begin;
+
+    NL_TEST_ASSERT(inSuite, commissionerDelegate.mNumPairingComplete == kConcurrentSessionCount);
+    NL_TEST_ASSERT(inSuite, accessoryDelegate.mNumPairingComplete == kConcurrentSessionCount);
+
+    ctx.GetExchangeManager().UnregisterUnsolicitedMessageHandlerForType(Protocols::SecureChannel::MsgType::CASE_Sigma1);
+    chip::Platform::Delete(commissioners);
+    chip::Platform::Delete(accessories);
+    ctx.DrainAndServiceIO();
+
+    return elapsed;
+}
+
+void CASE_ConcurrentSessionsTest(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+
+    const uint64_t inlineTime = CASE_EstablishConcurrentSessions(inSuite, ctx, nullptr);
+
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+    constexpr size_t kThreadCount = 4;
+
+    CASECryptoThreadPool threadPool;
+    NL_TEST_ASSERT(inSuite, threadPool.Init(kThreadCount, PostCryptoCompletion) == CHIP_NO_ERROR);
+    const uint64_t offloadedTime = CASE_EstablishConcurrentSessions(inSuite, ctx, &threadPool);
+    threadPool.Shutdown();
+
+    printf("%u sessions, %u at a time: crypto on the event loop %u us, initiator crypto on %u threads %u us\n",
+           static_cast<unsigned>(kConcurrentSessionCount), static_cast<unsigned>(kMaxConcurrentHandshakes),
+           static_cast<unsigned>(inlineTime), static_cast<unsigned>(kThreadCount), static_cast<unsigned>(offloadedTime));
+#else
+    printf("%u sessions, %u at a time: %u us\n", static_cast<unsigned>(kConcurrentSessionCount),
+           static_cast<unsigned>(kMaxConcurrentHandshakes), static_cast<unsigned>(inlineTime));
+#endif
+}
+
+void CASE_CryptoCompletionPostFailureTest(nlTestSuite * inSuite, void * inContext)
+{
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+
+    FabricInfo * fabric = gCommissionerFabrics.FindFabricWithIndex(gCommissionerFabricIndex);
+    NL_TEST_ASSERT(inSuite, fabric != nullptr);
+
+    auto * accessories   = chip::Platform::New<TestCASEAccessories>();
+    auto * commissioners = chip::Platform::New<TestCASECommissioners>();
+    NL_TEST_ASSERT(inSuite, accessories != nullptr && commissioners != nullptr);
+
+    NL_TEST_ASSERT(inSuite, accessories->Listen() == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite,
+                   ctx.GetExchangeManager().RegisterUnsolicitedMessageHandlerForType(Protocols::SecureChannel::MsgType::CASE_Sigma1,
+                                                                                     accessories) == CHIP_NO_ERROR);
+
+    CASECryptoThreadPool threadPool;
+    NL_TEST_ASSERT(inSuite, threadPool.Init(1, PostCryptoCompletion) == CHIP_NO_ERROR);
+    {
+        std::lock_guard<std::mutex> lock(gCryptoCompletionsLock);
+        gFailedCryptoCompletionPosts = 1;
+    }
+
+    // The completion of the Sigma3 step fails to post once, so the handshake must be aborted on both sides rather than
+    // completed or left waiting for it.
+    TestCASESecurePairingDelegate & commissionerDelegate = commissioners->mDelegate;
+    TestCASESecurePairingDelegate & accessoryDelegate    = accessories->mDelegate;
+    TestCASESessionIPK & session                         = commissioners->mSessions[0];
+    session.SetCryptoOffload(&threadPool);
+    ExchangeContext * exchange = ctx.NewUnauthenticatedExchangeToBob(&session);
+    NL_TEST_ASSERT(inSuite,
+                   session.EstablishSession(Transport::PeerAddress(Transport::Type::kBle), fabric, Node01_01, 0, exchange,
+                                            &commissionerDelegate) == CHIP_NO_ERROR);
+
+    const uint64_t deadline = System::SystemClock().GetMonotonicMicroseconds64().count() + 10 * 1000 * 1000;
+    while ((commissionerDelegate.mNumPairingComplete + commissionerDelegate.mNumPairingErrors == 0 ||
+            accessoryDelegate.mNumPairingComplete + accessoryDelegate.mNumPairingErrors == 0) &&
+           System::SystemClock().GetMonotonicMicroseconds64().count() < deadline)
+    {
+        ctx.DrainAndServiceIO();
+        RunPostedCryptoCompletions();
+    }
+    threadPool.Shutdown();
+
+    NL_TEST_ASSERT(inSuite, gFailedCryptoCompletionPosts == 0);
+    NL_TEST_ASSERT(inSuite, commissionerDelegate.mNumPairingErrors == 1);
+    NL_TEST_ASSERT(inSuite, commissionerDelegate.mNumPairingComplete == 0);
+    NL_TEST_ASSERT(inSuite, accessoryDelegate.mNumPairingErrors == 1);
+    NL_TEST_ASSERT(inSuite, accessoryDelegate.mNumPairingComplete == 0);
+
+    ctx.GetExchangeManager().UnregisterUnsolicitedMessageHandlerForType(Protocols::SecureChannel::MsgType::CASE_Sigma1);
+    chip::Platform::Delete(commissioners);
+    chip::Platform::Delete(accessories);
+    ctx.DrainAndServiceIO();
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+}
+
 struct Sigma1Params
 {
     // Purposefully not using constants like kSigmaParamRandomNumberSize that
@@ -621,6 +955,9 @@ static const nlTest sTests[] =
     NL_TEST_DEF("Start",       CASE_SecurePairingStartTest),
     NL_TEST_DEF("Handshake",   CASE_SecurePairingHandshakeTest),
     NL_TEST_DEF("ServerHandshake", CASE_SecurePairingHandshakeServerTest),
+    NL_TEST_DEF("ServerResumption", CASE_SessionResumptionServerTest),
+    NL_TEST_DEF("ConcurrentSessions", CASE_ConcurrentSessionsTest),
+    NL_TEST_DEF("CryptoCompletionPostFailure", CASE_CryptoCompletionPostFailureTest),
     NL_TEST_DEF("Sigma1Parsing", CASE_Sigma1ParsingTest),
 
     NL_TEST_SENTINEL()
@@ -25,6 +25,8 @@
 #include <nlunit-test.h>
 
 #include <lib/core/CHIPConfig.h>
+#include <lib/core/CHIPEncoding.h>
+#include <lib/support/TestPersistentStorageDelegate.h>
 #include <lib/support/UnitTestRegistration.h>
 #include <messaging/tests/MessagingContext.h>
 #include <protocols/secure_channel/CASESession.h>
@@ -43,6 +45,31 @@ uint8_t sTest_SharedSecret[] = {
 
 uint8_t sTest_ResumptionId[kCASEResumptionIDSize] = { 0 };
 
+constexpr FabricIndex sTest_FabricIndex = 1;
+constexpr uint16_t kCacheSize           = CHIP_CONFIG_CASE_SESSION_RESUME_CACHE_SIZE;
+
+// Session with the given peer, whose resumption ID is made of the given byte.
+CASESessionCachable MakeCachable(NodeId peerNodeId, uint8_t resumptionIdByte)
+{
+    CASESessionCachable cachableSession;
+    cachableSession.mSharedSecretLen = Encoding::LittleEndian::HostSwap16(static_cast<uint16_t>(sizeof(sTest_SharedSecret)));
+    memcpy(cachableSession.mSharedSecret, sTest_SharedSecret, sizeof(sTest_SharedSecret));
+    cachableSession.mPeerNodeId = Encoding::LittleEndian::HostSwap64(peerNodeId);
+    memset(cachableSession.mResumptionId, resumptionIdByte, kCASEResumptionIDSize);
+    cachableSession.mLocalFabricIndex      = sTest_FabricIndex;
+    cachableSession.mSessionSetupTimeStamp = Encoding::LittleEndian::HostSwap64(resumptionIdByte);
+    return cachableSession;
+}
+
+bool IsCached(CASESessionCache & cache, uint8_t resumptionIdByte)
+{
+    uint8_t resumptionId[kCASEResumptionIDSize];
+    memset(resumptionId, resumptionIdByte, kCASEResumptionIDSize);
+    CASESessionCachable outCachableSession;
+    return cache.Get(ResumptionID(resumptionId), outCachableSession) == CHIP_NO_ERROR &&
+        ByteSpan(outCachableSession.mResumptionId).data_equal(ByteSpan(resumptionId));
+}
+
 } // namespace
 
 class CASESessionTest : public CASESession
@@ -160,6 +187,134 @@ static void CASESessionCache_Remove_Test(nlTestSuite * inSuite, void * inContext
     }
 }
 
+static void CASESessionCache_Get_By_Peer_Test(nlTestSuite * inSuite, void * inContext)
+{
+    CASESessionCache cache;
+    for (uint8_t i = 0; i < kCacheSize; i++)
+    {
+        CASESessionCachable cachableSession = MakeCachable(sTest_PeerId + i, static_cast<uint8_t>(i + 1));
+        NL_TEST_ASSERT(inSuite, cache.Add(cachableSession) == CHIP_NO_ERROR);
+    }
+
+    for (uint8_t i = 0; i < kCacheSize; i++)
+    {
+        CASESessionCachable outCachableSession;
+        NL_TEST_ASSERT(inSuite, cache.Get(sTest_FabricIndex, sTest_PeerId + i, outCachableSession) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, outCachableSession.mResumptionId[0] == i + 1);
+        NL_TEST_ASSERT(inSuite, Encoding::LittleEndian::HostSwap64(outCachableSession.mPeerNodeId) == sTest_PeerId + i);
+    }
+
+    CASESessionCachable outCachableSession;
+    NL_TEST_ASSERT(inSuite,
+                   cache.Get(sTest_FabricIndex, sTest_PeerId + kCacheSize, outCachableSession) ==
+                       CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND);
+    NL_TEST_ASSERT(inSuite,
+                   cache.Get(static_cast<FabricIndex>(sTest_FabricIndex + 1), sTest_PeerId, outCachableSession) ==
+                       CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND);
+}
+
+static void CASESessionCache_Add_Same_Peer_Test(nlTestSuite * inSuite, void * inContext)
+{
+    CASESessionCache cache;
+    CASESessionCachable first  = MakeCachable(sTest_PeerId, 1);
+    CASESessionCachable second = MakeCachable(sTest_PeerId, 2);
+
+    NL_TEST_ASSERT(inSuite, cache.Add(first) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, cache.Add(second) == CHIP_NO_ERROR);
+
+    // The resumption ID of the new session supersedes the previous one.
+    NL_TEST_ASSERT(inSuite, cache.Count() == 1);
+    NL_TEST_ASSERT(inSuite, !IsCached(cache, 1));
+    NL_TEST_ASSERT(inSuite, IsCached(cache, 2));
+
+    CASESessionCachable outCachableSession;
+    NL_TEST_ASSERT(inSuite, cache.Get(sTest_FabricIndex, sTest_PeerId, outCachableSession) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, outCachableSession.mResumptionId[0] == 2);
+}
+
+static void CASESessionCache_Persist_Test(nlTestSuite * inSuite, void * inContext)
+{
+    TestPersistentStorageDelegate storage;
+
+    {
+        CASESessionCache cache;
+        NL_TEST_ASSERT(inSuite, cache.Init(&storage) == CHIP_NO_ERROR);
+        for (uint8_t i = 0; i < 2 * kCacheSize; i++)
+        {
+            CASESessionCachable cachableSession = MakeCachable(sTest_PeerId + i, static_cast<uint8_t>(i + 1));
+            NL_TEST_ASSERT(inSuite, cache.Add(cachableSession) == CHIP_NO_ERROR);
+        }
+        NL_TEST_ASSERT(inSuite, cache.Count() == kCacheSize);
+
+        uint8_t resumptionId[kCASEResumptionIDSize];
+        memset(resumptionId, 2 * kCacheSize, kCASEResumptionIDSize);
+        NL_TEST_ASSERT(inSuite, cache.Remove(ResumptionID(resumptionId)) == CHIP_NO_ERROR);
+    }
+
+    // Only the newest sessions, less the one removed, survive the restart.
+    CASESessionCache cache;
+    NL_TEST_ASSERT(inSuite, cache.Init(&storage) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, cache.Count() == kCacheSize - 1);
+    for (uint8_t i = 0; i < 2 * kCacheSize; i++)
+    {
+        NL_TEST_ASSERT(inSuite, IsCached(cache, static_cast<uint8_t>(i + 1)) == (i >= kCacheSize && i + 1 < 2 * kCacheSize));
+    }
+
+    CASESessionCachable outCachableSession;
+    NL_TEST_ASSERT(inSuite,
+                   cache.Get(sTest_FabricIndex, sTest_PeerId + kCacheSize, outCachableSession) == CHIP_NO_ERROR &&
+                       Encoding::LittleEndian::HostSwap64(outCachableSession.mPeerNodeId) == sTest_PeerId + kCacheSize);
+
+    // The order in which the sessions were added survives the restart too: the oldest one is evicted first.
+    for (uint8_t i = 2 * kCacheSize; i < 2 * kCacheSize + 2; i++)
+    {
+        CASESessionCachable cachableSession = MakeCachable(sTest_PeerId + i, static_cast<uint8_t>(i + 1));
+        NL_TEST_ASSERT(inSuite, cache.Add(cachableSession) == CHIP_NO_ERROR);
+    }
+    NL_TEST_ASSERT(inSuite, cache.Count() == kCacheSize);
+    NL_TEST_ASSERT(inSuite, !IsCached(cache, kCacheSize + 1));
+    NL_TEST_ASSERT(inSuite, kCacheSize < 2 || IsCached(cache, kCacheSize + 2));
+    NL_TEST_ASSERT(inSuite, IsCached(cache, 2 * kCacheSize + 2));
+}
+
+static void CASESessionCache_Remove_Fabric_Test(nlTestSuite * inSuite, void * inContext)
+{
+    constexpr FabricIndex kOtherFabricIndex = static_cast<FabricIndex>(sTest_FabricIndex + 1);
+    TestPersistentStorageDelegate storage;
+
+    {
+        CASESessionCache cache;
+        NL_TEST_ASSERT(inSuite, cache.Init(&storage) == CHIP_NO_ERROR);
+        for (uint8_t i = 0; i < kCacheSize; i++)
+        {
+            CASESessionCachable cachableSession = MakeCachable(sTest_PeerId + i, static_cast<uint8_t>(i + 1));
+            cachableSession.mLocalFabricIndex        = (i % 2 == 0) ? sTest_FabricIndex : kOtherFabricIndex;
+            cachableSession.mLocalCompressedFabricId = 0x1000 + cachableSession.mLocalFabricIndex;
+            NL_TEST_ASSERT(inSuite, cache.Add(cachableSession) == CHIP_NO_ERROR);
+        }
+
+        NL_TEST_ASSERT(inSuite, cache.RemoveFabric(sTest_FabricIndex) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, cache.Count() == kCacheSize / 2);
+    }
+
+    // The sessions of the removed fabric are gone from storage as well, and the others keep the fabric they belong to.
+    CASESessionCache cache;
+    NL_TEST_ASSERT(inSuite, cache.Init(&storage) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, cache.Count() == kCacheSize / 2);
+    for (uint8_t i = 0; i < kCacheSize; i++)
+    {
+        NL_TEST_ASSERT(inSuite, IsCached(cache, static_cast<uint8_t>(i + 1)) == (i % 2 != 0));
+    }
+
+    CASESessionCachable outCachableSession;
+    NL_TEST_ASSERT(inSuite, cache.Get(sTest_FabricIndex, sTest_PeerId, outCachableSession) != CHIP_NO_ERROR);
+    if (kCacheSize > 1)
+    {
+        NL_TEST_ASSERT(inSuite, cache.Get(kOtherFabricIndex, sTest_PeerId + 1, outCachableSession) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, outCachableSession.mLocalCompressedFabricId == 0x1000 + kOtherFabricIndex);
+    }
+}
+
 // Test Suite
 
 /**
@@ -173,6 +328,10 @@ static const nlTest sTests[] =
     NL_TEST_DEF("Get",   CASESessionCache_Get_Test),
     NL_TEST_DEF("AddWhenFull", CASESessionCache_Add_When_Full_Test),
     NL_TEST_DEF("Remove", CASESessionCache_Remove_Test),
+    NL_TEST_DEF("GetByPeer", CASESessionCache_Get_By_Peer_Test),
+    NL_TEST_DEF("AddSamePeer", CASESessionCache_Add_Same_Peer_Test),
+    NL_TEST_DEF("Persist", CASESessionCache_Persist_Test),
+    NL_TEST_DEF("RemoveFabric", CASESessionCache_Remove_Fabric_Test),
 
     NL_TEST_SENTINEL()
 };
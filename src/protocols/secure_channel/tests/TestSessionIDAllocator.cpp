@@ -50,6 +50,49 @@ void TestSessionIDAllocator_Free(nlTestSuite * inSuite, void * inContext)
     // Free some random unallocated ID
     allocator.Free(100);
     NL_TEST_ASSERT(inSuite, allocator.Peek() == static_cast<uint16_t>(i + 16));
+
+    // The intermediate ID is allocated again before any new ID
+    NL_TEST_ASSERT(inSuite, allocator.Allocate(id) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, id == 10);
+    NL_TEST_ASSERT(inSuite, allocator.Peek() == static_cast<uint16_t>(i + 16));
+}
+
+void TestSessionIDAllocator_Recycle(nlTestSuite * inSuite, void * inContext)
+{
+    SessionIDAllocator allocator;
+    uint16_t i = allocator.Peek();
+    uint16_t id;
+
+    for (uint16_t j = 0; j < 4; j++)
+    {
+        NL_TEST_ASSERT(inSuite, allocator.Allocate(id) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, id == static_cast<uint16_t>(i + j));
+    }
+
+    // Freed IDs are allocated again in the order they were freed, and only once
+    allocator.Free(static_cast<uint16_t>(i + 1));
+    allocator.Free(i);
+    allocator.Free(static_cast<uint16_t>(i + 1));
+    NL_TEST_ASSERT(inSuite, allocator.Peek() == static_cast<uint16_t>(i + 4));
+
+    NL_TEST_ASSERT(inSuite, allocator.Allocate(id) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, id == static_cast<uint16_t>(i + 1));
+    NL_TEST_ASSERT(inSuite, allocator.Allocate(id) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, id == i);
+    NL_TEST_ASSERT(inSuite, allocator.Allocate(id) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, id == static_cast<uint16_t>(i + 4));
+
+    // A reserved ID is not allocated again
+    allocator.Free(static_cast<uint16_t>(i + 2));
+    NL_TEST_ASSERT(inSuite, allocator.Reserve(static_cast<uint16_t>(i + 2)) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, allocator.Allocate(id) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, id == static_cast<uint16_t>(i + 5));
+
+    allocator.Free(i);
+    allocator.Free(static_cast<uint16_t>(i + 3));
+    NL_TEST_ASSERT(inSuite, allocator.ReserveUpTo(static_cast<uint16_t>(i + 5)) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, allocator.Allocate(id) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, id == static_cast<uint16_t>(i + 6));
 }
 
 void TestSessionIDAllocator_Reserve(nlTestSuite * inSuite, void * inContext)
@@ -90,6 +133,7 @@ void TestSessionIDAllocator_ReserveUpTo(nlTestSuite * inSuite, void * inContext)
 static const nlTest sTests[] =
 {
     NL_TEST_DEF("SessionIDAllocator_Free", TestSessionIDAllocator_Free),
+    NL_TEST_DEF("SessionIDAllocator_Recycle", TestSessionIDAllocator_Recycle),
     NL_TEST_DEF("SessionIDAllocator_Reserve", TestSessionIDAllocator_Reserve),
     NL_TEST_DEF("SessionIDAllocator_ReserveUpTo", TestSessionIDAllocator_ReserveUpTo),
 
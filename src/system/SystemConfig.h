@@ -320,6 +320,67 @@
 #define CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SIZE 15
 #endif /* CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SIZE */
 
+/**
+ *  @def CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_SIZE
+ *
+ *  @brief
+ *      This is the number of small packet buffers, each with room for #CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_CAPACITY
+ *      octets, kept in addition to the #CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SIZE full-size ones for the BSD sockets
+ *      configuration.
+ *
+ *      \c PacketBufferHandle::New() takes a buffer from the smallest size class that fits the request and still has one free,
+ *      so that short messages such as acknowledgements and status responses do not each hold a full-size buffer.
+ *
+ *      The small buffers take RAM on top of the full-size ones, so this defaults to zero (0), which disables the small size
+ *      class, except in test builds (see #CHIP_SYSTEM_CONFIG_TEST), which keep half as many as the full-size buffers.
+ */
+#ifndef CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_SIZE
+#if CHIP_SYSTEM_CONFIG_TEST
+#define CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_SIZE (CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SIZE / 2)
+#else
+#define CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_SIZE 0
+#endif
+#endif /* CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_SIZE */
+
+/**
+ *  @def CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_CAPACITY
+ *
+ *  @brief
+ *      The size, including the protocol header reserve, of the small packet buffers.
+ */
+#ifndef CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_CAPACITY
+#define CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_CAPACITY 128
+#endif /* CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_CAPACITY */
+
+/**
+ *  @def CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_MEDIUM_SIZE
+ *
+ *  @brief
+ *      This is the number of medium packet buffers, each with room for #CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_MEDIUM_CAPACITY
+ *      octets, kept in addition to the full-size ones for the BSD sockets configuration.
+ *
+ *      Like the small size class, this defaults to zero (0), which disables the medium size class, except in test builds,
+ *      which keep a quarter as many as the full-size buffers.
+ */
+#ifndef CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_MEDIUM_SIZE
+#if CHIP_SYSTEM_CONFIG_TEST
+#define CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_MEDIUM_SIZE (CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SIZE / 4)
+#else
+#define CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_MEDIUM_SIZE 0
+#endif
+#endif /* CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_MEDIUM_SIZE */
+
+/**
+ *  @def CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_MEDIUM_CAPACITY
+ *
+ *  @brief
+ *      The size, including the protocol header reserve, of the medium packet buffers. It must be larger than
+ *      #CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_CAPACITY and smaller than #CHIP_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MAX.
+ */
+#ifndef CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_MEDIUM_CAPACITY
+#define CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_MEDIUM_CAPACITY 512
+#endif /* CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_MEDIUM_CAPACITY */
+
 /**
  *  @def CHIP_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MAX
  *
@@ -439,6 +500,56 @@ struct LwIPEvent;
 #define CHIP_SYSTEM_CONFIG_NUM_TIMERS 32
 #endif /* CHIP_SYSTEM_CONFIG_NUM_TIMERS */
 
+/**
+ *  @def CHIP_SYSTEM_CONFIG_USE_TIMER_WHEEL
+ *
+ *  @brief
+ *      Use a hierarchical timing wheel (chip::System::TimerWheel) rather than a sorted list (chip::System::TimerList)
+ *      to hold the timers of the System::Layer implementations. Starting and cancelling a timer is then O(1) instead of
+ *      linear in the number of timers, at the cost of a few kilobytes of fixed state.
+ */
+#ifndef CHIP_SYSTEM_CONFIG_USE_TIMER_WHEEL
+#define CHIP_SYSTEM_CONFIG_USE_TIMER_WHEEL 0
+#endif /* CHIP_SYSTEM_CONFIG_USE_TIMER_WHEEL */
+
+/**
+ *  @def CHIP_SYSTEM_CONFIG_TIMER_WHEEL_INDEX_BUCKETS
+ *
+ *  @brief
+ *      The number of buckets of the chip::System::TimerWheel index used to cancel a timer by callback and
+ *      application state. Cancelling costs one bucket walk, so this should be
+ *      at least the number of timers expected to be pending at once.
+ */
+#ifndef CHIP_SYSTEM_CONFIG_TIMER_WHEEL_INDEX_BUCKETS
+#define CHIP_SYSTEM_CONFIG_TIMER_WHEEL_INDEX_BUCKETS CHIP_SYSTEM_CONFIG_NUM_TIMERS
+#endif /* CHIP_SYSTEM_CONFIG_TIMER_WHEEL_INDEX_BUCKETS */
+
+/**
+ *  @def CHIP_SYSTEM_CONFIG_USE_EPOLL
+ *
+ *  @brief
+ *      Use chip::System::LayerImplEpoll, the epoll event loop of Linux, as chip::System::LayerImpl in place of
+ *      chip::System::LayerImplSelect. This requires CHIP_SYSTEM_CONFIG_USE_SOCKETS.
+ */
+#ifndef CHIP_SYSTEM_CONFIG_USE_EPOLL
+#define CHIP_SYSTEM_CONFIG_USE_EPOLL 0
+#endif /* CHIP_SYSTEM_CONFIG_USE_EPOLL */
+
+#if CHIP_SYSTEM_CONFIG_USE_EPOLL && !CHIP_SYSTEM_CONFIG_USE_SOCKETS
+#error "REQUIRED: CHIP_SYSTEM_CONFIG_USE_SOCKETS when CHIP_SYSTEM_CONFIG_USE_EPOLL"
+#endif // CHIP_SYSTEM_CONFIG_USE_EPOLL && !CHIP_SYSTEM_CONFIG_USE_SOCKETS
+
+/**
+ *  @def CHIP_SYSTEM_CONFIG_SELECT_AND_EPOLL
+ *
+ *  @brief
+ *      Set by the build when both chip::System::LayerImplSelect and chip::System::LayerImplEpoll are built, whichever of
+ *      them CHIP_SYSTEM_CONFIG_USE_EPOLL makes chip::System::LayerImpl.
+ */
+#ifndef CHIP_SYSTEM_CONFIG_SELECT_AND_EPOLL
+#define CHIP_SYSTEM_CONFIG_SELECT_AND_EPOLL 0
+#endif /* CHIP_SYSTEM_CONFIG_SELECT_AND_EPOLL */
+
 /**
  *  @def CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
  *
@@ -29,4 +29,3 @@
 #else // CHIP_SYSTEM_LAYER_IMPL_CONFIG_FILE
 #include <system/SystemLayerImplSelect.h>
 #endif // CHIP_SYSTEM_LAYER_IMPL_CONFIG_FILE
-#undef INCLUDING_CHIP_SYSTEM_LAYER_IMPL_CONFIG_FILE
@@ -0,0 +1,412 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements Layer using Linux epoll.
+ */
+
+#include <lib/support/CodeUtils.h>
+#include <platform/LockTracker.h>
+#include <system/SystemFaultInjection.h>
+#include <system/SystemLayer.h>
+#include <system/SystemLayerImplEpoll.h>
+
+#include <errno.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+// Choose an approximation of PTHREAD_NULL if pthread.h doesn't define one.
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING && !defined(PTHREAD_NULL)
+#define PTHREAD_NULL 0
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING && !defined(PTHREAD_NULL)
+
+namespace chip {
+namespace System {
+
+CHIP_ERROR LayerImplEpoll::Init()
+{
+    VerifyOrReturnError(mLayerState.SetInitializing(), CHIP_ERROR_INCORRECT_STATE);
+
+    RegisterPOSIXErrorFormatter();
+
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+    mHandleSelectThread = PTHREAD_NULL;
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+
+    mEpollFd = epoll_create1(EPOLL_CLOEXEC);
+    VerifyOrReturnError(mEpollFd >= 0, CHIP_ERROR_POSIX(errno));
+
+    mTimerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    VerifyOrReturnError(mTimerFd >= 0, CHIP_ERROR_POSIX(errno));
+    mTimerFdAwakenTime = Clock::kZero;
+
+    // The timerfd is told apart from socket watches by its data pointer.
+    epoll_event event = {};
+    event.events      = EPOLLIN;
+    event.data.ptr    = &mTimerFd;
+    VerifyOrReturnError(epoll_ctl(mEpollFd, EPOLL_CTL_ADD, mTimerFd, &event) == 0, CHIP_ERROR_POSIX(errno));
+
+    mEventCount = 0;
+    mEventIndex = 0;
+
+    // Create an event to allow an arbitrary thread to wake the thread in the epoll loop.
+    ReturnErrorOnFailure(mWakeEvent.Open(*this));
+
+    VerifyOrReturnError(mLayerState.SetInitialized(), CHIP_ERROR_INCORRECT_STATE);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR LayerImplEpoll::Shutdown()
+{
+    VerifyOrReturnError(mLayerState.SetShuttingDown(), CHIP_ERROR_INCORRECT_STATE);
+
+    mTimerList.Clear();
+    mTimerPool.ReleaseAll();
+
+    mWakeEvent.Close(*this);
+    mSocketWatchPool.ReleaseAll();
+    mEventCount = 0;
+
+    close(mTimerFd);
+    mTimerFd = -1;
+    close(mEpollFd);
+    mEpollFd = -1;
+
+    mLayerState.ResetFromShuttingDown(); // Return to uninitialized state to permit re-initialization.
+    return CHIP_NO_ERROR;
+}
+
+void LayerImplEpoll::Signal()
+{
+    /*
+     * Wake up the I/O thread by writing a single byte to the wake pipe.
+     *
+     * If this is being called from within an I/O event callback, then writing to the wake pipe can be skipped,
+     * since the I/O thread is already awake.
+     */
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+    if (pthread_equal(mHandleSelectThread, pthread_self()))
+    {
+        return;
+    }
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+
+    CHIP_ERROR status = mWakeEvent.Notify();
+    if (status != CHIP_NO_ERROR)
+    {
+        ChipLogError(chipSystemLayer, "System wake event notify failed: %" CHIP_ERROR_FORMAT, status.Format());
+    }
+}
+
+CHIP_ERROR LayerImplEpoll::StartTimer(Clock::Timeout delay, TimerCompleteCallback onComplete, void * appState)
+{
+    VerifyOrReturnError(mLayerState.IsInitialized(), CHIP_ERROR_INCORRECT_STATE);
+
+    CHIP_SYSTEM_FAULT_INJECT(FaultInjection::kFault_TimeoutImmediate, delay = System::Clock::kZero);
+
+    CancelTimer(onComplete, appState);
+
+    TimerList::Node * timer = mTimerPool.Create(*this, SystemClock().GetMonotonicTimestamp() + delay, onComplete, appState);
+    VerifyOrReturnError(timer != nullptr, CHIP_ERROR_NO_MEMORY);
+
+    if (mTimerList.Add(timer) == timer)
+    {
+        // The new timer is the earliest, so the timerfd has to be re-armed.
+        Signal();
+    }
+    return CHIP_NO_ERROR;
+}
+
+void LayerImplEpoll::CancelTimer(TimerCompleteCallback onComplete, void * appState)
+{
+    VerifyOrReturn(mLayerState.IsInitialized());
+
+    TimerList::Node * timer = mTimerList.Remove(onComplete, appState);
+    VerifyOrReturn(timer != nullptr);
+
+    // An early timerfd expiration is harmless: PrepareEvents() re-arms it for the new earliest timer, so there is no need
+    // to wake the loop here.
+    mTimerPool.Release(timer);
+}
+
+CHIP_ERROR LayerImplEpoll::ScheduleWork(TimerCompleteCallback onComplete, void * appState)
+{
+    VerifyOrReturnError(mLayerState.IsInitialized(), CHIP_ERROR_INCORRECT_STATE);
+
+    CancelTimer(onComplete, appState);
+
+    TimerList::Node * timer = mTimerPool.Create(*this, SystemClock().GetMonotonicTimestamp(), onComplete, appState);
+    VerifyOrReturnError(timer != nullptr, CHIP_ERROR_NO_MEMORY);
+
+    if (mTimerList.Add(timer) == timer)
+    {
+        // The new timer is the earliest, so the time until the next event has probably changed.
+        Signal();
+    }
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR LayerImplEpoll::StartWatchingSocket(int fd, SocketWatchToken * tokenOut)
+{
+    // Duplicate registration is an error.
+    bool duplicate = false;
+    mSocketWatchPool.ForEachActiveObject([&](SocketWatch * w) {
+        duplicate = (w->mFD == fd);
+        return duplicate ? Loop::Break : Loop::Continue;
+    });
+    VerifyOrReturnError(!duplicate, CHIP_ERROR_INVALID_ARGUMENT);
+
+    SocketWatch * watch = mSocketWatchPool.CreateObject(fd);
+    VerifyOrReturnError(watch != nullptr, CHIP_ERROR_ENDPOINT_POOL_FULL);
+
+    *tokenOut = reinterpret_cast<SocketWatchToken>(watch);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR LayerImplEpoll::SetCallback(SocketWatchToken token, SocketWatchCallback callback, intptr_t data)
+{
+    SocketWatch * watch = reinterpret_cast<SocketWatch *>(token);
+    VerifyOrReturnError(watch != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    watch->mCallback     = callback;
+    watch->mCallbackData = data;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR LayerImplEpoll::RequestCallbackOnPendingRead(SocketWatchToken token)
+{
+    SocketWatch * watch = reinterpret_cast<SocketWatch *>(token);
+    VerifyOrReturnError(watch != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    return UpdateInterest(watch, SocketEvents(watch->mPendingIO).Set(SocketEventFlags::kRead));
+}
+
+CHIP_ERROR LayerImplEpoll::RequestCallbackOnPendingWrite(SocketWatchToken token)
+{
+    SocketWatch * watch = reinterpret_cast<SocketWatch *>(token);
+    VerifyOrReturnError(watch != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    return UpdateInterest(watch, SocketEvents(watch->mPendingIO).Set(SocketEventFlags::kWrite));
+}
+
+CHIP_ERROR LayerImplEpoll::ClearCallbackOnPendingRead(SocketWatchToken token)
+{
+    SocketWatch * watch = reinterpret_cast<SocketWatch *>(token);
+    VerifyOrReturnError(watch != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    return UpdateInterest(watch, SocketEvents(watch->mPendingIO).Clear(SocketEventFlags::kRead));
+}
+
+CHIP_ERROR LayerImplEpoll::ClearCallbackOnPendingWrite(SocketWatchToken token)
+{
+    SocketWatch * watch = reinterpret_cast<SocketWatch *>(token);
+    VerifyOrReturnError(watch != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    return UpdateInterest(watch, SocketEvents(watch->mPendingIO).Clear(SocketEventFlags::kWrite));
+}
+
+CHIP_ERROR LayerImplEpoll::StopWatchingSocket(SocketWatchToken * tokenInOut)
+{
+    SocketWatch * watch = reinterpret_cast<SocketWatch *>(*tokenInOut);
+    *tokenInOut         = InvalidSocketWatchToken();
+
+    VerifyOrReturnError(watch != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    if (watch->mRegistered)
+    {
+        // This fails harmlessly if the socket has already been closed, which also removes it from the interest list.
+        (void) epoll_ctl(mEpollFd, EPOLL_CTL_DEL, watch->mFD, nullptr);
+    }
+
+    // The watch may still have an event waiting to be dispatched by HandleEvents(); drop it before the watch is freed.
+    for (int i = mEventIndex; i < mEventCount; i++)
+    {
+        if (mEvents[i].data.ptr == watch)
+        {
+            mEvents[i].data.ptr = nullptr;
+        }
+    }
+
+    mSocketWatchPool.ReleaseObject(watch);
+    return CHIP_NO_ERROR;
+}
+
+/**
+ *  Bring the epoll interest list in line with the events a watch wants callbacks for.
+ *
+ *  A socket without any requested event is left out of the interest list entirely: epoll always reports
+ *  hang-ups and errors, which would otherwise wake a level-triggered loop continuously.
+ */
+CHIP_ERROR LayerImplEpoll::UpdateInterest(SocketWatch * watch, SocketEvents pendingIO)
+{
+    VerifyOrReturnError(pendingIO.Raw() != watch->mPendingIO.Raw(), CHIP_NO_ERROR);
+
+    if (!pendingIO.HasAny())
+    {
+        if (watch->mRegistered)
+        {
+            VerifyOrReturnError(epoll_ctl(mEpollFd, EPOLL_CTL_DEL, watch->mFD, nullptr) == 0, CHIP_ERROR_POSIX(errno));
+            watch->mRegistered = false;
+        }
+        watch->mPendingIO = pendingIO;
+        return CHIP_NO_ERROR;
+    }
+
+    epoll_event event = {};
+    event.events      = (pendingIO.Has(SocketEventFlags::kRead) ? EPOLLIN : 0u) |
+        (pendingIO.Has(SocketEventFlags::kWrite) ? EPOLLOUT : 0u);
+    event.data.ptr = watch;
+
+    const int op = watch->mRegistered ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+    VerifyOrReturnError(epoll_ctl(mEpollFd, op, watch->mFD, &event) == 0, CHIP_ERROR_POSIX(errno));
+    watch->mRegistered = true;
+    watch->mPendingIO  = pendingIO;
+    return CHIP_NO_ERROR;
+}
+
+/**
+ *  Translate the events reported by epoll into the requested SocketEvents.
+ *
+ *  As with select(), a hang-up or error makes the socket both readable and writable, so that the callback
+ *  observes the condition on its next read or write.
+ */
+SocketEvents LayerImplEpoll::SocketEventsFromEpoll(uint32_t epollEvents, SocketEvents pendingIO)
+{
+    SocketEvents res;
+
+    if ((epollEvents & (EPOLLIN | EPOLLHUP | EPOLLERR)) && pendingIO.Has(SocketEventFlags::kRead))
+    {
+        res.Set(SocketEventFlags::kRead);
+    }
+    if ((epollEvents & (EPOLLOUT | EPOLLHUP | EPOLLERR)) && pendingIO.Has(SocketEventFlags::kWrite))
+    {
+        res.Set(SocketEventFlags::kWrite);
+    }
+
+    return res;
+}
+
+void LayerImplEpoll::PrepareEvents()
+{
+    assertChipStackLockedByCurrentThread();
+
+    const Clock::Timestamp currentTime = SystemClock().GetMonotonicTimestamp();
+    TimerList::Node * timer            = mTimerList.Earliest();
+
+    if (timer != nullptr && timer->AwakenTime() <= currentTime)
+    {
+        mWaitTimeout = 0;
+        return;
+    }
+
+    mWaitTimeout = -1;
+
+    // Only touch the timerfd when the earliest timer has changed since it was last armed.
+    const Clock::Timestamp awakenTime = (timer != nullptr) ? timer->AwakenTime() : Clock::kZero;
+    if (awakenTime == mTimerFdAwakenTime)
+    {
+        return;
+    }
+
+    // A zero it_value disarms the timerfd when there is no timer left.
+    itimerspec spec = {};
+    if (timer != nullptr)
+    {
+        const Clock::Milliseconds64 sleepTime = awakenTime - currentTime;
+        spec.it_value.tv_sec                  = static_cast<time_t>(sleepTime.count() / 1000);
+        spec.it_value.tv_nsec                 = static_cast<long>((sleepTime.count() % 1000) * 1000000);
+    }
+
+    if (timerfd_settime(mTimerFd, 0, &spec, nullptr) == 0)
+    {
+        mTimerFdAwakenTime = awakenTime;
+    }
+    else
+    {
+        // Fall back to polling rather than sleeping past the timer.
+        ChipLogError(chipSystemLayer, "timerfd_settime failed: %s", ErrorStr(CHIP_ERROR_POSIX(errno)));
+        mWaitTimeout       = 0;
+        mTimerFdAwakenTime = Clock::kZero;
+    }
+}
+
+void LayerImplEpoll::WaitForEvents()
+{
+    mEventIndex = 0;
+    mEventCount = epoll_wait(mEpollFd, mEvents, kMaxEventsPerWait, mWaitTimeout);
+}
+
+void LayerImplEpoll::HandleEvents()
+{
+    assertChipStackLockedByCurrentThread();
+
+    if (!IsSelectResultValid())
+    {
+        ChipLogError(DeviceLayer, "epoll_wait failed: %s\n", ErrorStr(CHIP_ERROR_POSIX(errno)));
+        mEventCount = 0;
+        return;
+    }
+
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+    mHandleSelectThread = pthread_self();
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+
+    // Obtain the list of currently expired timers. Any new timers added by timer callback are NOT handled on this pass,
+    // since that could result in infinite handling of new timers blocking any other progress.
+    TimerList expiredTimers = mTimerList.ExtractEarlier(Clock::Timeout(1) + SystemClock().GetMonotonicTimestamp());
+    TimerList::Node * timer = nullptr;
+    while ((timer = expiredTimers.PopEarliest()) != nullptr)
+    {
+        mTimerPool.Invoke(timer);
+    }
+
+    for (mEventIndex = 0; mEventIndex < mEventCount; mEventIndex++)
+    {
+        const epoll_event & event = mEvents[mEventIndex];
+        if (event.data.ptr == &mTimerFd)
+        {
+            // The timerfd has expired and disarmed itself; consume the expiration so it stops being readable.
+            uint64_t expirations;
+            (void) read(mTimerFd, &expirations, sizeof(expirations));
+            mTimerFdAwakenTime = Clock::kZero;
+            continue;
+        }
+
+        // A null pointer marks an event whose watch was stopped by an earlier callback.
+        SocketWatch * watch = static_cast<SocketWatch *>(event.data.ptr);
+        if (watch == nullptr)
+        {
+            continue;
+        }
+
+        SocketEvents events = SocketEventsFromEpoll(event.events, watch->mPendingIO);
+        if (events.HasAny() && watch->mCallback != nullptr)
+        {
+            watch->mCallback(events, watch->mCallbackData);
+        }
+    }
+    mEventCount = 0;
+    mEventIndex = 0;
+
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+    mHandleSelectThread = PTHREAD_NULL;
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+}
+
+} // namespace System
+} // namespace chip
@@ -0,0 +1,138 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file declares an implementation of System::Layer using Linux epoll.
+ */
+
+#pragma once
+
+#include <sys/epoll.h>
+
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+#include <atomic>
+#include <pthread.h>
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+
+#include <lib/support/ObjectLifeCycle.h>
+#include <lib/support/Pool.h>
+#include <system/SystemLayer.h>
+#include <system/SystemTimer.h>
+#include <system/WakeEvent.h>
+
+namespace chip {
+namespace System {
+
+/**
+ * An event loop that keeps its sockets registered with an epoll instance, so that the cost of waiting for and dispatching
+ * events depends on the number of ready sockets rather than on the number of watched ones.
+ *
+ * A socket is in the epoll interest list only while a read or write callback is requested for it; interest changes are
+ * applied with epoll_ctl() as they are requested. Notification is level-triggered, like select(), so a callback that does
+ * not drain its socket is simply called again on the next pass.
+ *
+ * Timers are kept in a TimerQueue as in LayerImplSelect. The earliest one arms a timerfd that is itself registered with the
+ * epoll instance, so the wait itself never times out and the timerfd is only re-armed when the earliest timer changes.
+ */
+class LayerImplEpoll : public LayerSocketsLoop
+{
+public:
+    LayerImplEpoll() = default;
+    ~LayerImplEpoll() { VerifyOrDie(mLayerState.Destroy()); }
+
+    // Layer overrides.
+    CHIP_ERROR Init() override;
+    CHIP_ERROR Shutdown() override;
+    bool IsInitialized() const override { return mLayerState.IsInitialized(); }
+    CHIP_ERROR StartTimer(Clock::Timeout delay, TimerCompleteCallback onComplete, void * appState) override;
+    void CancelTimer(TimerCompleteCallback onComplete, void * appState) override;
+    CHIP_ERROR ScheduleWork(TimerCompleteCallback onComplete, void * appState) override;
+
+    // LayerSocket overrides.
+    CHIP_ERROR StartWatchingSocket(int fd, SocketWatchToken * tokenOut) override;
+    CHIP_ERROR SetCallback(SocketWatchToken token, SocketWatchCallback callback, intptr_t data) override;
+    CHIP_ERROR RequestCallbackOnPendingRead(SocketWatchToken token) override;
+    CHIP_ERROR RequestCallbackOnPendingWrite(SocketWatchToken token) override;
+    CHIP_ERROR ClearCallbackOnPendingRead(SocketWatchToken token) override;
+    CHIP_ERROR ClearCallbackOnPendingWrite(SocketWatchToken token) override;
+    CHIP_ERROR StopWatchingSocket(SocketWatchToken * tokenInOut) override;
+    SocketWatchToken InvalidSocketWatchToken() override { return reinterpret_cast<SocketWatchToken>(nullptr); }
+
+    // LayerSocketLoop overrides.
+    void Signal() override;
+    void EventLoopBegins() override {}
+    void PrepareEvents() override;
+    void WaitForEvents() override;
+    void HandleEvents() override;
+    void EventLoopEnds() override {}
+
+    // Expose the result of WaitForEvents() for non-blocking socket implementations.
+    bool IsSelectResultValid() const { return mEventCount >= 0; }
+
+protected:
+    // Only sizes the static pool; on platforms where pools are heap-backed the number of watched sockets is not bounded.
+    static constexpr int kSocketWatchMax = (INET_CONFIG_ENABLE_TCP_ENDPOINT ? INET_CONFIG_NUM_TCP_ENDPOINTS : 0) +
+        (INET_CONFIG_ENABLE_UDP_ENDPOINT ? INET_CONFIG_NUM_UDP_ENDPOINTS : 0);
+
+    // Number of ready descriptors collected by one epoll_wait().
+    static constexpr int kMaxEventsPerWait = 64;
+
+    struct SocketWatch
+    {
+        SocketWatch(int fd) : mFD(fd), mCallback(nullptr), mCallbackData(0), mRegistered(false) {}
+        int mFD;
+        SocketEvents mPendingIO;
+        SocketWatchCallback mCallback;
+        intptr_t mCallbackData;
+        bool mRegistered; ///< Whether mFD is in the epoll interest list.
+    };
+    CHIP_ERROR UpdateInterest(SocketWatch * watch, SocketEvents pendingIO);
+    static SocketEvents SocketEventsFromEpoll(uint32_t epollEvents, SocketEvents pendingIO);
+
+    ObjectPool<SocketWatch, kSocketWatchMax> mSocketWatchPool;
+
+    TimerPool<TimerList::Node> mTimerPool;
+    TimerQueue mTimerList;
+
+    int mEpollFd = -1;
+    int mTimerFd = -1;
+    // Expiration time the timerfd is armed for, so that it is only re-armed when the earliest timer changes.
+    Clock::Timestamp mTimerFdAwakenTime;
+    // Timeout passed to epoll_wait(): 0 when a timer has already expired, otherwise -1 and the timerfd wakes the loop.
+    int mWaitTimeout;
+
+    // Result of epoll_wait(), carried between WaitForEvents() and HandleEvents().
+    epoll_event mEvents[kMaxEventsPerWait];
+    int mEventCount = 0;
+    // Index of the event being dispatched, so StopWatchingSocket() can drop events not yet dispatched for the same watch.
+    int mEventIndex = 0;
+
+    ObjectLifeCycle mLayerState;
+    WakeEvent mWakeEvent;
+
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+    std::atomic<pthread_t> mHandleSelectThread;
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+};
+
+#if CHIP_SYSTEM_CONFIG_USE_EPOLL
+using LayerImpl = LayerImplEpoll;
+#endif // CHIP_SYSTEM_CONFIG_USE_EPOLL
+
+} // namespace System
+} // namespace chip
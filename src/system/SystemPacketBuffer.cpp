@@ -66,7 +66,35 @@ namespace System {
 
 PacketBuffer::BufferPoolElement PacketBuffer::sBufferPool[CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SIZE];
 
-PacketBuffer * PacketBuffer::sFreeList = PacketBuffer::BuildFreeList();
+#if CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_SIZE
+PacketBuffer::SizedBufferPoolElement<CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_CAPACITY>
+    PacketBuffer::sSmallBufferPool[CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_SIZE];
+#endif
+#if CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_MEDIUM_SIZE
+PacketBuffer::SizedBufferPoolElement<CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_MEDIUM_CAPACITY>
+    PacketBuffer::sMediumBufferPool[CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_MEDIUM_SIZE];
+#endif
+static_assert(CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_CAPACITY < CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_MEDIUM_CAPACITY,
+              "Small packet buffers must be smaller than medium ones");
+static_assert(CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_MEDIUM_CAPACITY < PacketBuffer::kMaxSizeWithoutReserve,
+              "Medium packet buffers must be smaller than full-size ones");
+
+// The free lists are built by InitBufferPool(), which runs as a dynamic initializer after this table is constant-initialized.
+PacketBuffer::BufferPoolClass PacketBuffer::sBufferPoolClasses[PacketBuffer::kNumBufferPoolClasses] = {
+#if CHIP_SYSTEM_PACKETBUFFER_POOL_HAS_SIZE_CLASSES
+#if CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_SIZE
+    { CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_CAPACITY, nullptr, chip::System::Stats::kSystemLayer_NumSmallPacketBufs },
+#endif
+#if CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_MEDIUM_SIZE
+    { CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_MEDIUM_CAPACITY, nullptr, chip::System::Stats::kSystemLayer_NumMediumPacketBufs },
+#endif
+    { PacketBuffer::kMaxSizeWithoutReserve, nullptr, chip::System::Stats::kSystemLayer_NumLargePacketBufs },
+#else
+    { PacketBuffer::kMaxSizeWithoutReserve, nullptr },
+#endif // CHIP_SYSTEM_PACKETBUFFER_POOL_HAS_SIZE_CLASSES
+};
+
+bool PacketBuffer::sBufferPoolInitialized = PacketBuffer::InitBufferPool();
 
 #if !CHIP_SYSTEM_CONFIG_NO_LOCKING
 static Mutex sBufferPoolMutex;
@@ -83,23 +111,40 @@ static Mutex sBufferPoolMutex;
     } while (0)
 #endif // !CHIP_SYSTEM_CONFIG_NO_LOCKING
 
-PacketBuffer * PacketBuffer::BuildFreeList()
+template <uint16_t kAllocSize, size_t N>
+PacketBuffer * PacketBuffer::BuildFreeList(SizedBufferPoolElement<kAllocSize> (&aPool)[N])
 {
     pbuf * lHead = nullptr;
 
-    for (int i = 0; i < CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SIZE; i++)
+    for (size_t i = 0; i < N; i++)
     {
-        pbuf * lCursor = &sBufferPool[i].Header;
-        lCursor->next  = lHead;
-        lCursor->ref   = 0;
-        lHead          = lCursor;
+        pbuf * lCursor      = &aPool[i].Header;
+        lCursor->next       = lHead;
+        lCursor->ref        = 0;
+        lCursor->alloc_size = kAllocSize;
+        lHead               = lCursor;
     }
 
+    return static_cast<PacketBuffer *>(lHead);
+}
+
+bool PacketBuffer::InitBufferPool()
+{
+    BufferPoolClass * lClass = sBufferPoolClasses;
+
+#if CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_SIZE
+    (lClass++)->mFreeList = BuildFreeList(sSmallBufferPool);
+#endif
+#if CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_MEDIUM_SIZE
+    (lClass++)->mFreeList = BuildFreeList(sMediumBufferPool);
+#endif
+    lClass->mFreeList = BuildFreeList(sBufferPool);
+
 #if !CHIP_SYSTEM_CONFIG_NO_LOCKING
     Mutex::Init(sBufferPoolMutex);
 #endif // !CHIP_SYSTEM_CONFIG_NO_LOCKING
 
-    return static_cast<PacketBuffer *>(lHead);
+    return true;
 }
 
 #elif CHIP_SYSTEM_PACKETBUFFER_STORE == CHIP_SYSTEM_PACKETBUFFER_STORE_CHIP_HEAP
@@ -471,13 +516,23 @@ PacketBufferHandle PacketBufferHandle::New(size_t aAvailableSize, uint16_t aRese
 
     static_cast<void>(lBlockSize);
 
+    lPacket = nullptr;
+
     LOCK_BUF_POOL();
 
-    lPacket = PacketBuffer::sFreeList;
-    if (lPacket != nullptr)
+    // Take a buffer from the smallest size class that fits, falling back to larger classes when it is exhausted.
+    for (PacketBuffer::BufferPoolClass & lClass : PacketBuffer::sBufferPoolClasses)
     {
-        PacketBuffer::sFreeList = lPacket->ChainedBuffer();
-        SYSTEM_STATS_INCREMENT(chip::System::Stats::kSystemLayer_NumPacketBufs);
+        if (lClass.mAllocSize >= lAllocSize && lClass.mFreeList != nullptr)
+        {
+            lPacket          = lClass.mFreeList;
+            lClass.mFreeList = lPacket->ChainedBuffer();
+            SYSTEM_STATS_INCREMENT(chip::System::Stats::kSystemLayer_NumPacketBufs);
+#if CHIP_SYSTEM_PACKETBUFFER_POOL_HAS_SIZE_CLASSES
+            SYSTEM_STATS_INCREMENT(lClass.mStatsEntry);
+#endif
+            break;
+        }
     }
 
     UNLOCK_BUF_POOL();
@@ -568,8 +623,18 @@ void PacketBuffer::Free(PacketBuffer * aPacket)
 #endif
             aPacket->Clear();
 #if CHIP_SYSTEM_PACKETBUFFER_STORE == CHIP_SYSTEM_PACKETBUFFER_STORE_CHIP_POOL
-            aPacket->next = sFreeList;
-            sFreeList     = aPacket;
+            for (BufferPoolClass & lClass : sBufferPoolClasses)
+            {
+                if (lClass.mAllocSize == aPacket->alloc_size)
+                {
+#if CHIP_SYSTEM_PACKETBUFFER_POOL_HAS_SIZE_CLASSES
+                    SYSTEM_STATS_DECREMENT(lClass.mStatsEntry);
+#endif
+                    aPacket->next    = lClass.mFreeList;
+                    lClass.mFreeList = aPacket;
+                    break;
+                }
+            }
 #elif CHIP_SYSTEM_PACKETBUFFER_STORE == CHIP_SYSTEM_PACKETBUFFER_STORE_CHIP_HEAP
             chip::Platform::MemoryFree(aPacket);
 #endif // CHIP_SYSTEM_PACKETBUFFER_STORE
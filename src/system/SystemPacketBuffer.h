@@ -59,27 +59,33 @@ class PacketBufferTest;
 #define CHIP_SYSTEM_PACKETBUFFER_STORE_CHIP_POOL 3   //   Internal fixed pool
 #define CHIP_SYSTEM_PACKETBUFFER_STORE_CHIP_HEAP 4   //   Platform::MemoryAlloc
 
-#undef CHIP_SYSTEM_PACKETBUFFER_HAS_RIGHT_SIZE // True if RightSize() has a nontrivial implementation
-#undef CHIP_SYSTEM_PACKETBUFFER_HAS_CHECK      // True if Check() has a nontrivial implementation
+#undef CHIP_SYSTEM_PACKETBUFFER_HAS_RIGHT_SIZE        // True if RightSize() has a nontrivial implementation
+#undef CHIP_SYSTEM_PACKETBUFFER_HAS_CHECK             // True if Check() has a nontrivial implementation
+#undef CHIP_SYSTEM_PACKETBUFFER_POOL_HAS_SIZE_CLASSES // True if the internal pool also has buffers smaller than full size
 #if CHIP_SYSTEM_CONFIG_USE_LWIP
 #if LWIP_PBUF_FROM_CUSTOM_POOLS
 #define CHIP_SYSTEM_PACKETBUFFER_STORE CHIP_SYSTEM_PACKETBUFFER_STORE_LWIP_CUSTOM
 #define CHIP_SYSTEM_PACKETBUFFER_HAS_RIGHT_SIZE 1
 #define CHIP_SYSTEM_PACKETBUFFER_HAS_CHECK 0
+#define CHIP_SYSTEM_PACKETBUFFER_POOL_HAS_SIZE_CLASSES 0
 #else
 #define CHIP_SYSTEM_PACKETBUFFER_STORE CHIP_SYSTEM_PACKETBUFFER_STORE_LWIP_POOL
 #define CHIP_SYSTEM_PACKETBUFFER_HAS_RIGHT_SIZE 0
 #define CHIP_SYSTEM_PACKETBUFFER_HAS_CHECK 0
+#define CHIP_SYSTEM_PACKETBUFFER_POOL_HAS_SIZE_CLASSES 0
 #endif
 #else
 #if CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SIZE
 #define CHIP_SYSTEM_PACKETBUFFER_STORE CHIP_SYSTEM_PACKETBUFFER_STORE_CHIP_POOL
 #define CHIP_SYSTEM_PACKETBUFFER_HAS_RIGHT_SIZE 0
 #define CHIP_SYSTEM_PACKETBUFFER_HAS_CHECK 0
+#define CHIP_SYSTEM_PACKETBUFFER_POOL_HAS_SIZE_CLASSES                                                                             \
+    (CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_SIZE || CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_MEDIUM_SIZE)
 #else
 #define CHIP_SYSTEM_PACKETBUFFER_STORE CHIP_SYSTEM_PACKETBUFFER_STORE_CHIP_HEAP
 #define CHIP_SYSTEM_PACKETBUFFER_HAS_RIGHT_SIZE 1
 #define CHIP_SYSTEM_PACKETBUFFER_HAS_CHECK CHIP_CONFIG_MEMORY_DEBUG_CHECKS
+#define CHIP_SYSTEM_PACKETBUFFER_POOL_HAS_SIZE_CLASSES 0
 #endif
 #endif
 
@@ -96,7 +102,8 @@ struct pbuf
     uint16_t tot_len;
     uint16_t len;
     uint16_t ref;
-#if CHIP_SYSTEM_PACKETBUFFER_STORE == CHIP_SYSTEM_PACKETBUFFER_STORE_CHIP_HEAP
+#if CHIP_SYSTEM_PACKETBUFFER_STORE == CHIP_SYSTEM_PACKETBUFFER_STORE_CHIP_HEAP ||                                                  \
+    CHIP_SYSTEM_PACKETBUFFER_STORE == CHIP_SYSTEM_PACKETBUFFER_STORE_CHIP_POOL
     uint16_t alloc_size;
 #endif
 };
@@ -122,7 +129,8 @@ struct pbuf
  *
  *      New objects of PacketBuffer class are initialized at the beginning of an allocation of memory obtained from the underlying
  *      environment, e.g. from LwIP pbuf target pools, from the standard C library heap, from an internal buffer pool. In the
- *      simple pool case, the size of the data buffer is PacketBuffer::kBlockSize.
+ *      simple pool case, the size of the data buffer is PacketBuffer::kBlockSize; when the pool is configured with smaller size
+ *      classes, the buffer comes from the smallest class that fits the requested size.
  *
  *      PacketBuffer objects may be chained to accommodate larger payloads.  Chaining, however, is not transparent, and users of the
  *      class must explicitly decide to support chaining.  Examples of classes written with chaining support are as follows:
@@ -187,10 +195,10 @@ public:
      */
     uint16_t AllocSize() const
     {
-#if CHIP_SYSTEM_PACKETBUFFER_STORE == CHIP_SYSTEM_PACKETBUFFER_STORE_LWIP_POOL ||                                                  \
-    CHIP_SYSTEM_PACKETBUFFER_STORE == CHIP_SYSTEM_PACKETBUFFER_STORE_CHIP_POOL
+#if CHIP_SYSTEM_PACKETBUFFER_STORE == CHIP_SYSTEM_PACKETBUFFER_STORE_LWIP_POOL
         return kMaxSizeWithoutReserve;
-#elif CHIP_SYSTEM_PACKETBUFFER_STORE == CHIP_SYSTEM_PACKETBUFFER_STORE_CHIP_HEAP
+#elif CHIP_SYSTEM_PACKETBUFFER_STORE == CHIP_SYSTEM_PACKETBUFFER_STORE_CHIP_POOL ||                                                \
+    CHIP_SYSTEM_PACKETBUFFER_STORE == CHIP_SYSTEM_PACKETBUFFER_STORE_CHIP_HEAP
         return this->alloc_size;
 #elif CHIP_SYSTEM_PACKETBUFFER_STORE == CHIP_SYSTEM_PACKETBUFFER_STORE_LWIP_CUSTOM
         // Temporary workaround for custom pbufs by assuming size to be PBUF_POOL_BUFSIZE
@@ -397,14 +405,41 @@ private:
 
     // Note: this condition includes DOXYGEN to work around a Doxygen error. DOXYGEN is never defined in any actual build.
 #if CHIP_SYSTEM_PACKETBUFFER_STORE == CHIP_SYSTEM_PACKETBUFFER_STORE_CHIP_POOL || defined(DOXYGEN)
-    typedef union
+    // Pool storage for a PacketBuffer of kAllocSize octets.
+    template <uint16_t kAllocSize>
+    union SizedBufferPoolElement
     {
         pbuf Header;
-        uint8_t Block[PacketBuffer::kBlockSize];
-    } BufferPoolElement;
+        uint8_t Block[PacketBuffer::kStructureSize + kAllocSize];
+    };
+    using BufferPoolElement = SizedBufferPoolElement<PacketBuffer::kMaxSizeWithoutReserve>;
     static BufferPoolElement sBufferPool[CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SIZE];
-    static PacketBuffer * sFreeList;
-    static PacketBuffer * BuildFreeList();
+#if CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_SIZE
+    static SizedBufferPoolElement<CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_CAPACITY>
+        sSmallBufferPool[CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_SIZE];
+#endif
+#if CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_MEDIUM_SIZE
+    static SizedBufferPoolElement<CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_MEDIUM_CAPACITY>
+        sMediumBufferPool[CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_MEDIUM_SIZE];
+#endif
+
+    // The free buffers of one size class.
+    struct BufferPoolClass
+    {
+        uint16_t mAllocSize;
+        PacketBuffer * mFreeList;
+#if CHIP_SYSTEM_PACKETBUFFER_POOL_HAS_SIZE_CLASSES
+        int mStatsEntry;
+#endif
+    };
+    static constexpr size_t kNumBufferPoolClasses =
+        1 + (CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_SIZE ? 1 : 0) + (CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_MEDIUM_SIZE ? 1 : 0);
+    // Ordered by increasing mAllocSize; the last class holds the full-size buffers of sBufferPool.
+    static BufferPoolClass sBufferPoolClasses[kNumBufferPoolClasses];
+    static bool sBufferPoolInitialized;
+    static bool InitBufferPool();
+    template <uint16_t kAllocSize, size_t N>
+    static PacketBuffer * BuildFreeList(SizedBufferPoolElement<kAllocSize> (&aPool)[N]);
 #endif // CHIP_SYSTEM_PACKETBUFFER_STORE == CHIP_SYSTEM_PACKETBUFFER_STORE_CHIP_POOL || defined(DOXYGEN)
 
 #if CHIP_SYSTEM_PACKETBUFFER_HAS_CHECK
@@ -43,6 +43,12 @@ static const Label sStatsStrings[chip::System::Stats::kNumEntries] = {
 #undef LWIP_PBUF_MEMPOOL
 #else
     "SystemLayer_NumPacketBufs",
+#if !CHIP_SYSTEM_CONFIG_USE_LWIP && CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SIZE &&                                                   \
+    (CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_SIZE || CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_MEDIUM_SIZE)
+    "SystemLayer_NumSmallPacketBufs",
+    "SystemLayer_NumMediumPacketBufs",
+    "SystemLayer_NumLargePacketBufs",
+#endif
 #endif
     "SystemLayer_NumTimersInUse",
 #if INET_CONFIG_NUM_TCP_ENDPOINTS
@@ -58,6 +58,13 @@ enum
 #undef LWIP_PBUF_MEMPOOL
 #else
     kSystemLayer_NumPacketBufs,
+#if !CHIP_SYSTEM_CONFIG_USE_LWIP && CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SIZE &&                                                   \
+    (CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_SIZE || CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_MEDIUM_SIZE)
+    // Per size class of the internal packet buffer pool; kSystemLayer_NumPacketBufs counts all of them.
+    kSystemLayer_NumSmallPacketBufs,
+    kSystemLayer_NumMediumPacketBufs,
+    kSystemLayer_NumLargePacketBufs,
+#endif
 #endif
     kSystemLayer_NumTimers,
 #if INET_CONFIG_NUM_TCP_ENDPOINTS
@@ -160,5 +160,425 @@ TimerList TimerList::ExtractEarlier(Clock::Timestamp t)
     return out;
 }
 
+#if CHIP_SYSTEM_CONFIG_USE_TIMER_WHEEL || CHIP_SYSTEM_CONFIG_TEST
+
+namespace {
+
+unsigned LowestSetBit(uint64_t bits)
+{
+    unsigned index = 0;
+    while ((bits & 1) == 0)
+    {
+        bits >>= 1;
+        index++;
+    }
+    return index;
+}
+
+} // namespace
+
+void TimerWheel::Clear()
+{
+    for (auto & slot : mSlots)
+    {
+        slot = nullptr;
+    }
+    for (auto & occupied : mOccupied)
+    {
+        occupied = 0;
+    }
+    for (auto & bucket : mBuckets)
+    {
+        bucket = nullptr;
+    }
+    mNow           = 0;
+    mCount         = 0;
+    mEarliest      = nullptr;
+    mEarliestValid = true;
+}
+
+size_t TimerWheel::HashBucket(TimerCompleteCallback onComplete, void * appState)
+{
+    uint64_t hash = reinterpret_cast<uintptr_t>(onComplete) ^ (static_cast<uint64_t>(reinterpret_cast<uintptr_t>(appState)) << 1);
+    hash *= 0x9E3779B97F4A7C15ull;
+    return static_cast<size_t>((hash >> 32) % kHashBuckets);
+}
+
+TimerWheel::Node * TimerWheel::Add(Node * timer)
+{
+    Place(timer);
+
+    const Node::Callback & callback = timer->GetCallback();
+    Node *& bucket                  = mBuckets[HashBucket(callback.GetOnComplete(), callback.GetAppState())];
+    timer->mNextInBucket            = bucket;
+    timer->mPrevInBucket            = &bucket;
+    if (bucket != nullptr)
+    {
+        bucket->mPrevInBucket = &timer->mNextInBucket;
+    }
+    bucket = timer;
+    mCount++;
+
+    if (mEarliestValid && (mEarliest == nullptr || timer->AwakenTime() < mEarliest->AwakenTime()))
+    {
+        mEarliest = timer;
+    }
+    return Earliest();
+}
+
+TimerWheel::Node * TimerWheel::Remove(Node * remove)
+{
+    if (remove != nullptr && remove->mWheelSlot != kNotQueued)
+    {
+        Unlink(remove);
+    }
+    return Earliest();
+}
+
+TimerWheel::Node * TimerWheel::Remove(TimerCompleteCallback onComplete, void * appState)
+{
+    for (Node * timer = mBuckets[HashBucket(onComplete, appState)]; timer != nullptr; timer = timer->mNextInBucket)
+    {
+        if (timer->GetCallback().GetOnComplete() == onComplete && timer->GetCallback().GetAppState() == appState)
+        {
+            Unlink(timer);
+            return timer;
+        }
+    }
+    return nullptr;
+}
+
+TimerWheel::Node * TimerWheel::PopEarliest()
+{
+    Node * earliest = Earliest();
+    if (earliest != nullptr)
+    {
+        Unlink(earliest);
+    }
+    return earliest;
+}
+
+TimerWheel::Node * TimerWheel::PopIfEarlier(Clock::Timestamp t)
+{
+    Node * earliest = Earliest();
+    if (earliest == nullptr)
+    {
+        return nullptr;
+    }
+
+    // Nothing expires before the earlier of t and the earliest timer, so the wheel time can move up to it.
+    const bool expired = earliest->AwakenTime() < t;
+    Advance((expired ? earliest->AwakenTime() : t).count());
+    if (!expired)
+    {
+        return nullptr;
+    }
+    Unlink(earliest);
+    return earliest;
+}
+
+TimerWheel::Node * TimerWheel::Earliest() const
+{
+    if (!mEarliestValid)
+    {
+        mEarliest      = FindEarliest();
+        mEarliestValid = true;
+    }
+    return mEarliest;
+}
+
+TimerList TimerWheel::ExtractEarlier(Clock::Timestamp t)
+{
+    TimerList out;
+    Node * tail = nullptr;
+    auto moveToOut = [&](Node * timer) {
+        Unlink(timer);
+        if (tail == nullptr)
+        {
+            out.mEarliestTimer = timer;
+        }
+        else
+        {
+            tail->mNextTimer = timer;
+        }
+        tail = timer;
+    };
+
+    // Late timers expire before anything in the levels, and are already sorted.
+    while (mSlots[kLateSlot] != nullptr && mSlots[kLateSlot]->AwakenTime() < t)
+    {
+        moveToOut(mSlots[kLateSlot]);
+    }
+
+    const uint64_t target = t.count();
+    while (mNow < target)
+    {
+        // Every timer in the current level 0 slot expires exactly now, in the order the timers were added.
+        const uint16_t slot = static_cast<uint16_t>(mNow & (kSlotsPerLevel - 1));
+        while (mSlots[slot] != nullptr)
+        {
+            moveToOut(mSlots[slot]);
+        }
+
+        uint64_t next = NextEventTime(mNow);
+        mNow          = (next < target) ? next : target;
+        Cascade(mNow);
+    }
+
+    return out;
+}
+
+void TimerWheel::Place(Node * timer)
+{
+    const uint64_t awaken = timer->AwakenTime().count();
+    if (awaken < mNow)
+    {
+        InsertLate(timer);
+        return;
+    }
+
+    // The level is that of the highest group of kSlotBits bits in which the expiration time differs from
+    // the wheel time, so a timer is only ever placed in a slot the wheel has not reached yet at that level.
+    const uint64_t diff = awaken ^ mNow;
+    unsigned level      = 0;
+    while (level < kLevels && (diff >> (kSlotBits * (level + 1))) != 0)
+    {
+        level++;
+    }
+
+    if (level == kLevels)
+    {
+        Append(kOverflowSlot, timer);
+        return;
+    }
+
+    const unsigned index = static_cast<unsigned>((awaken >> (kSlotBits * level)) & (kSlotsPerLevel - 1));
+    Append(static_cast<uint16_t>(level * kSlotsPerLevel + index), timer);
+    mOccupied[level] |= (uint64_t(1) << index);
+}
+
+void TimerWheel::Append(uint16_t slot, Node * timer)
+{
+    Node *& head      = mSlots[slot];
+    timer->mWheelSlot = slot;
+    timer->mNextTimer = nullptr;
+    if (head == nullptr)
+    {
+        timer->mPrevTimer = timer;
+        head              = timer;
+    }
+    else
+    {
+        Node * tail       = head->mPrevTimer;
+        tail->mNextTimer  = timer;
+        timer->mPrevTimer = tail;
+        head->mPrevTimer  = timer;
+    }
+}
+
+void TimerWheel::InsertLate(Node * timer)
+{
+    // Keep the late list sorted, with timers of equal expiration time in the order they were added.
+    Node *& head = mSlots[kLateSlot];
+    Node * after = nullptr;
+    for (Node * node = head; node != nullptr && !(timer->AwakenTime() < node->AwakenTime()); node = node->mNextTimer)
+    {
+        after = node;
+    }
+
+    if (after == nullptr && head != nullptr)
+    {
+        // New head of a non-empty list.
+        timer->mWheelSlot = kLateSlot;
+        timer->mNextTimer = head;
+        timer->mPrevTimer = head->mPrevTimer;
+        head->mPrevTimer  = timer;
+        head              = timer;
+        return;
+    }
+    if (after == nullptr || after->mNextTimer == nullptr)
+    {
+        Append(kLateSlot, timer);
+        return;
+    }
+
+    timer->mWheelSlot             = kLateSlot;
+    timer->mNextTimer             = after->mNextTimer;
+    timer->mPrevTimer             = after;
+    after->mNextTimer->mPrevTimer = timer;
+    after->mNextTimer             = timer;
+}
+
+void TimerWheel::Unlink(Node * timer)
+{
+    const uint16_t slot = timer->mWheelSlot;
+    Node *& head        = mSlots[slot];
+
+    if (timer == head)
+    {
+        head = timer->mNextTimer;
+        if (head != nullptr)
+        {
+            head->mPrevTimer = timer->mPrevTimer;
+        }
+    }
+    else
+    {
+        timer->mPrevTimer->mNextTimer = timer->mNextTimer;
+        if (timer->mNextTimer != nullptr)
+        {
+            timer->mNextTimer->mPrevTimer = timer->mPrevTimer;
+        }
+        else
+        {
+            head->mPrevTimer = timer->mPrevTimer;
+        }
+    }
+
+    if (head == nullptr && slot < kLateSlot)
+    {
+        mOccupied[slot / kSlotsPerLevel] &= ~(uint64_t(1) << (slot % kSlotsPerLevel));
+    }
+
+    *timer->mPrevInBucket = timer->mNextInBucket;
+    if (timer->mNextInBucket != nullptr)
+    {
+        timer->mNextInBucket->mPrevInBucket = timer->mPrevInBucket;
+    }
+
+    timer->mNextTimer    = nullptr;
+    timer->mPrevTimer    = nullptr;
+    timer->mNextInBucket = nullptr;
+    timer->mPrevInBucket = nullptr;
+    timer->mWheelSlot    = kNotQueued;
+    mCount--;
+
+    if (timer == mEarliest)
+    {
+        mEarliestValid = false;
+    }
+}
+
+void TimerWheel::Cascade(uint64_t now)
+{
+    // Find the highest level whose slot boundary the wheel time is on.
+    unsigned level = 0;
+    while (level < kLevels && (now & ((uint64_t(1) << (kSlotBits * (level + 1))) - 1)) == 0)
+    {
+        level++;
+    }
+
+    // Cascade from the top down, since timers cascaded from one level may land in the current slot of the next.
+    for (; level >= 1; level--)
+    {
+        const uint16_t slot = (level == kLevels)
+            ? kOverflowSlot
+            : static_cast<uint16_t>(level * kSlotsPerLevel + ((now >> (kSlotBits * level)) & (kSlotsPerLevel - 1)));
+
+        Node * timer = mSlots[slot];
+        mSlots[slot] = nullptr;
+        if (level < kLevels)
+        {
+            mOccupied[level] &= ~(uint64_t(1) << (slot % kSlotsPerLevel));
+        }
+
+        while (timer != nullptr)
+        {
+            Node * next = timer->mNextTimer;
+            Place(timer);
+            timer = next;
+        }
+    }
+}
+
+void TimerWheel::Advance(uint64_t target)
+{
+    // Like ExtractEarlier(), but for a target no later than every queued timer: the level 0 slots passed on the
+    // way are all empty.
+    while (mNow < target)
+    {
+        uint64_t next = NextEventTime(mNow);
+        mNow          = (next < target) ? next : target;
+        Cascade(mNow);
+    }
+}
+
+uint64_t TimerWheel::NextEventTime(uint64_t now) const
+{
+    // The next non-empty level 0 slot after the current one.
+    unsigned index = static_cast<unsigned>(now & (kSlotsPerLevel - 1));
+    uint64_t later = (index + 1 < kSlotsPerLevel) ? (mOccupied[0] & (~uint64_t(0) << (index + 1))) : 0;
+    if (later != 0)
+    {
+        return (now & ~uint64_t(kSlotsPerLevel - 1)) + LowestSetBit(later);
+    }
+
+    // Otherwise the start of the next non-empty slot of the lowest level that has one.
+    for (unsigned level = 1; level < kLevels; level++)
+    {
+        const unsigned shift = kSlotBits * level;
+        index                = static_cast<unsigned>((now >> shift) & (kSlotsPerLevel - 1));
+        later                = (index + 1 < kSlotsPerLevel) ? (mOccupied[level] & (~uint64_t(0) << (index + 1))) : 0;
+        if (later != 0)
+        {
+            return ((now >> (shift + kSlotBits)) << (shift + kSlotBits)) + (uint64_t(LowestSetBit(later)) << shift);
+        }
+    }
+
+    // Overflow timers are reconsidered each time the top level wraps around.
+    if (mSlots[kOverflowSlot] != nullptr)
+    {
+        const unsigned shift = kSlotBits * kLevels;
+        return ((now >> shift) + 1) << shift;
+    }
+
+    return UINT64_MAX;
+}
+
+TimerWheel::Node * TimerWheel::FindEarliest() const
+{
+    if (mSlots[kLateSlot] != nullptr)
+    {
+        return mSlots[kLateSlot];
+    }
+
+    // Level 0 slots each hold a single expiration time.
+    const unsigned index = static_cast<unsigned>(mNow & (kSlotsPerLevel - 1));
+    const uint64_t due   = mOccupied[0] & (~uint64_t(0) << index);
+    if (due != 0)
+    {
+        return mSlots[LowestSetBit(due)];
+    }
+
+    // Any timer in a lower level expires before every timer in a higher one, but higher level slots are not
+    // sorted. Scan the first non-empty one, keeping the first of equal expiration times.
+    const Node * list = nullptr;
+    for (unsigned level = 1; level < kLevels && list == nullptr; level++)
+    {
+        const unsigned levelIndex = static_cast<unsigned>((mNow >> (kSlotBits * level)) & (kSlotsPerLevel - 1));
+        const uint64_t later = (levelIndex + 1 < kSlotsPerLevel) ? (mOccupied[level] & (~uint64_t(0) << (levelIndex + 1))) : 0;
+        if (later != 0)
+        {
+            list = mSlots[level * kSlotsPerLevel + LowestSetBit(later)];
+        }
+    }
+    if (list == nullptr)
+    {
+        list = mSlots[kOverflowSlot];
+    }
+
+    const Node * earliest = list;
+    for (const Node * timer = list; timer != nullptr; timer = timer->mNextTimer)
+    {
+        if (timer->AwakenTime() < earliest->AwakenTime())
+        {
+            earliest = timer;
+        }
+    }
+    return const_cast<Node *>(earliest);
+}
+
+#endif // CHIP_SYSTEM_CONFIG_USE_TIMER_WHEEL || CHIP_SYSTEM_CONFIG_TEST
+
 } // namespace System
 } // namespace chip
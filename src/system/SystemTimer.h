@@ -45,6 +45,7 @@ namespace System {
 
 class Layer;
 class TestTimer;
+class TimerWheel;
 
 /**
  * Basic Timer information: time and callback.
@@ -111,6 +112,16 @@ public:
             TimerData(systemLayer, awakenTime, onComplete, appState), mNextTimer(nullptr)
         {}
         Node * mNextTimer;
+
+#if CHIP_SYSTEM_CONFIG_USE_TIMER_WHEEL || CHIP_SYSTEM_CONFIG_TEST
+    private:
+        friend class TimerWheel;
+        // Bookkeeping for TimerWheel, which keeps nodes in doubly linked slot lists and doubly linked index buckets.
+        Node * mPrevTimer     = nullptr;
+        Node * mNextInBucket  = nullptr;
+        Node ** mPrevInBucket = nullptr;
+        uint16_t mWheelSlot   = UINT16_MAX;
+#endif // CHIP_SYSTEM_CONFIG_USE_TIMER_WHEEL || CHIP_SYSTEM_CONFIG_TEST
     };
 
     TimerList() : mEarliestTimer(nullptr) {}
@@ -174,9 +185,141 @@ public:
     void Clear() { mEarliestTimer = nullptr; }
 
 private:
+    friend class TimerWheel;
     Node * mEarliestTimer;
 };
 
+// TimerWheel is also built in test builds, so that its tests run whichever container the layers use.
+#if CHIP_SYSTEM_CONFIG_USE_TIMER_WHEEL || CHIP_SYSTEM_CONFIG_TEST
+
+/**
+ * Hierarchical timing wheel with the same interface and the same firing order as `TimerList`.
+ *
+ * Timers are hashed by expiration time into kLevels levels of kSlotsPerLevel slots. Level 0 has one slot per
+ * millisecond; each further level has slots kSlotsPerLevel times as wide. When the wheel time enters a slot
+ * of a higher level, the timers in that slot are cascaded into lower levels, so they reach level 0 by the
+ * time they expire. Timers further out than the top level are kept in an overflow list, and timers added
+ * with an expiration time the wheel has already passed are kept in a short sorted list.
+ *
+ * `Add()` and `Remove(Node *)` are O(1). `Remove(onComplete, appState)` is O(1) on average through a hash
+ * index of CHIP_SYSTEM_CONFIG_TIMER_WHEEL_INDEX_BUCKETS buckets; unlike `TimerList`, it assumes there is at
+ * most one timer per (onComplete, appState), which the System::Layer implementations guarantee by cancelling
+ * a timer before starting it again.
+ *
+ * The wheel time advances, skipping over empty slots, in `ExtractEarlier()` and in `PopIfEarlier()`, so the
+ * layers that only pop expired timers one at a time keep their timers in the lower levels too.
+ */
+class TimerWheel
+{
+public:
+    using Node = TimerList::Node;
+
+    TimerWheel() { Clear(); }
+
+    /**
+     * Add a timer to the wheel
+     *
+     * @return  The new earliest timer in the wheel.
+     */
+    Node * Add(Node * timer);
+
+    /**
+     * Remove the given timer from the wheel, if present. It is not an error for the timer not to be present.
+     *
+     * @return  The new earliest timer in the wheel, or nullptr if the wheel is empty.
+     */
+    Node * Remove(Node * remove);
+
+    /**
+     * Remove the timer with the given properties, if present. It is not an error for no such timer to be present.
+     *
+     * @return  The removed timer, or nullptr if the wheel contains no matching timer.
+     */
+    Node * Remove(TimerCompleteCallback onComplete, void * appState);
+
+    /**
+     * Remove and return the earliest timer in the wheel.
+     *
+     * @return  The earliest timer, or nullptr if the wheel is empty.
+     */
+    Node * PopEarliest();
+
+    /**
+     * Remove and return the earliest timer in the wheel, provided it expires earlier than the given time @a t.
+     *
+     * @return  The earliest timer expiring before @a t, or nullptr if there is no such timer.
+     */
+    Node * PopIfEarlier(Clock::Timestamp t);
+
+    /**
+     * Get the earliest timer in the wheel.
+     *
+     * @return  The earliest timer, or nullptr if there are no timers.
+     */
+    Node * Earliest() const;
+
+    /**
+     * Test whether there are any timers.
+     */
+    bool Empty() const { return mCount == 0; }
+
+    /**
+     * Remove and return all timers that expire before the given time @a t, in firing order.
+     */
+    TimerList ExtractEarlier(Clock::Timestamp t);
+
+    /**
+     * Remove all timers.
+     */
+    void Clear();
+
+private:
+    static constexpr unsigned kSlotBits      = 6;
+    static constexpr unsigned kSlotsPerLevel = 1u << kSlotBits;
+    static constexpr unsigned kLevels        = 5;
+    static constexpr uint16_t kLateSlot      = kLevels * kSlotsPerLevel;
+    static constexpr uint16_t kOverflowSlot  = kLateSlot + 1;
+    static constexpr uint16_t kSlotCount     = kOverflowSlot + 1;
+    static constexpr uint16_t kNotQueued     = UINT16_MAX;
+    static constexpr size_t kHashBuckets     = CHIP_SYSTEM_CONFIG_TIMER_WHEEL_INDEX_BUCKETS;
+
+    static_assert(kHashBuckets > 0, "The timer wheel index needs at least one bucket");
+
+    void Place(Node * timer);
+    void Append(uint16_t slot, Node * timer);
+    void InsertLate(Node * timer);
+    void Unlink(Node * timer);
+    void Cascade(uint64_t now);
+    void Advance(uint64_t target);
+    uint64_t NextEventTime(uint64_t now) const;
+    Node * FindEarliest() const;
+    static size_t HashBucket(TimerCompleteCallback onComplete, void * appState);
+
+    // Slot lists are doubly linked through mNextTimer and mPrevTimer; the head's mPrevTimer points at the tail.
+    Node * mSlots[kSlotCount];
+    // Per level, one bit per non-empty slot.
+    uint64_t mOccupied[kLevels];
+    Node * mBuckets[kHashBuckets];
+    // Every timer in the levels or the overflow list expires at or after this time.
+    uint64_t mNow;
+    size_t mCount;
+    mutable Node * mEarliest;
+    mutable bool mEarliestValid;
+
+    friend class TestTimer;
+};
+
+#endif // CHIP_SYSTEM_CONFIG_USE_TIMER_WHEEL || CHIP_SYSTEM_CONFIG_TEST
+
+/**
+ * The timer container used by the System::Layer implementations, selected by CHIP_SYSTEM_CONFIG_USE_TIMER_WHEEL.
+ */
+#if CHIP_SYSTEM_CONFIG_USE_TIMER_WHEEL
+using TimerQueue = TimerWheel;
+#else  // CHIP_SYSTEM_CONFIG_USE_TIMER_WHEEL
+using TimerQueue = TimerList;
+#endif // CHIP_SYSTEM_CONFIG_USE_TIMER_WHEEL
+
 /**
  * ObjectPool wrapper that keeps System Timer statistics.
  */
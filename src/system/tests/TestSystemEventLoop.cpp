@@ -0,0 +1,337 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This is a unit test suite for the socket event loop of the configured
+ *      <tt>chip::System::LayerImpl</tt> (select or epoll), including a dispatch
+ *      latency benchmark over increasing numbers of watched sockets, which
+ *      compares the select and epoll event loops where both are built.
+ *
+ */
+
+#include <system/SystemConfig.h>
+
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/UnitTestRegistration.h>
+#include <nlunit-test.h>
+#include <system/SystemLayerImpl.h>
+
+#if CHIP_SYSTEM_CONFIG_SELECT_AND_EPOLL
+#include <system/SystemLayerImplEpoll.h>
+#include <system/SystemLayerImplSelect.h>
+#endif // CHIP_SYSTEM_CONFIG_SELECT_AND_EPOLL
+
+#include <errno.h>
+#include <stdio.h>
+
+#if CHIP_SYSTEM_CONFIG_USE_SOCKETS
+#include <sys/resource.h>
+#include <unistd.h>
+#endif // CHIP_SYSTEM_CONFIG_USE_SOCKETS
+
+using namespace chip::System;
+
+#if CHIP_SYSTEM_CONFIG_USE_SOCKETS
+
+namespace {
+
+void ServiceEvents(LayerSocketsLoop & layer)
+{
+    layer.PrepareEvents();
+    layer.WaitForEvents();
+    layer.HandleEvents();
+}
+
+struct TestContext
+{
+    LayerImpl mSystemLayer;
+
+    void ServiceEvents() { ::ServiceEvents(mSystemLayer); }
+};
+
+/**
+ * A pipe whose read end is watched by the system layer.
+ */
+struct WatchedPipe
+{
+    int mFds[2]                = { -1, -1 };
+    SocketWatchToken mWatch    = 0;
+    WatchedPipe ** mStopTarget = nullptr;
+    LayerSocketsLoop * mLayer  = nullptr;
+    uint32_t mCallbackCount    = 0;
+
+    CHIP_ERROR Open(LayerSocketsLoop & layer)
+    {
+        VerifyOrReturnError(pipe(mFds) == 0, CHIP_ERROR_POSIX(errno));
+        mLayer = &layer;
+        ReturnErrorOnFailure(layer.StartWatchingSocket(mFds[0], &mWatch));
+        ReturnErrorOnFailure(layer.SetCallback(mWatch, OnReadable, reinterpret_cast<intptr_t>(this)));
+        return layer.RequestCallbackOnPendingRead(mWatch);
+    }
+
+    void Close()
+    {
+        if (mLayer != nullptr && mWatch != mLayer->InvalidSocketWatchToken())
+        {
+            mLayer->StopWatchingSocket(&mWatch);
+        }
+        for (int & fd : mFds)
+        {
+            if (fd >= 0)
+            {
+                close(fd);
+                fd = -1;
+            }
+        }
+    }
+
+    bool Notify()
+    {
+        uint8_t byte = 0;
+        return write(mFds[1], &byte, sizeof(byte)) == sizeof(byte);
+    }
+
+    static void OnReadable(SocketEvents events, intptr_t data)
+    {
+        WatchedPipe * self = reinterpret_cast<WatchedPipe *>(data);
+        uint8_t byte;
+        (void) read(self->mFds[0], &byte, sizeof(byte));
+        self->mCallbackCount++;
+
+        // Optionally stop watching another pipe from within the callback, as endpoints closed by a callback do.
+        if (self->mStopTarget != nullptr && *self->mStopTarget != nullptr)
+        {
+            (*self->mStopTarget)->Close();
+            *self->mStopTarget = nullptr;
+        }
+    }
+};
+
+void TestReadCallback(nlTestSuite * inSuite, void * aContext)
+{
+    TestContext & lContext = *static_cast<TestContext *>(aContext);
+    WatchedPipe watched;
+
+    NL_TEST_ASSERT(inSuite, watched.Open(lContext.mSystemLayer) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, watched.Notify());
+    lContext.ServiceEvents();
+    NL_TEST_ASSERT(inSuite, watched.mCallbackCount == 1);
+
+    // No callback once the read interest is cleared, even though data is pending.
+    NL_TEST_ASSERT(inSuite, lContext.mSystemLayer.ClearCallbackOnPendingRead(watched.mWatch) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, watched.Notify());
+    NL_TEST_ASSERT(inSuite, lContext.mSystemLayer.StartTimer(Clock::Milliseconds32(10), [](Layer *, void *) {}, nullptr) ==
+                       CHIP_NO_ERROR);
+    lContext.ServiceEvents();
+    NL_TEST_ASSERT(inSuite, watched.mCallbackCount == 1);
+
+    // Requesting it again delivers the data that is already waiting.
+    NL_TEST_ASSERT(inSuite, lContext.mSystemLayer.RequestCallbackOnPendingRead(watched.mWatch) == CHIP_NO_ERROR);
+    lContext.ServiceEvents();
+    NL_TEST_ASSERT(inSuite, watched.mCallbackCount == 2);
+
+    // Watching the same descriptor twice is an error.
+    SocketWatchToken duplicate;
+    NL_TEST_ASSERT(inSuite, lContext.mSystemLayer.StartWatchingSocket(watched.mFds[0], &duplicate) == CHIP_ERROR_INVALID_ARGUMENT);
+
+    watched.Close();
+}
+
+void TestStopWatchingFromCallback(nlTestSuite * inSuite, void * aContext)
+{
+    TestContext & lContext = *static_cast<TestContext *>(aContext);
+    WatchedPipe first;
+    WatchedPipe second;
+    WatchedPipe * stillWatched = &first;
+    WatchedPipe * otherWatched = &second;
+
+    NL_TEST_ASSERT(inSuite, first.Open(lContext.mSystemLayer) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, second.Open(lContext.mSystemLayer) == CHIP_NO_ERROR);
+
+    // Both pipes are ready in the same pass; whichever is dispatched first stops watching the other one, whose pending
+    // event must then be dropped rather than delivered.
+    first.mStopTarget  = &otherWatched;
+    second.mStopTarget = &stillWatched;
+    NL_TEST_ASSERT(inSuite, first.Notify() && second.Notify());
+    lContext.ServiceEvents();
+    NL_TEST_ASSERT(inSuite, first.mCallbackCount + second.mCallbackCount == 1);
+
+    first.Close();
+    second.Close();
+}
+
+void TestTimerWakesWait(nlTestSuite * inSuite, void * aContext)
+{
+    TestContext & lContext = *static_cast<TestContext *>(aContext);
+    bool fired             = false;
+
+    NL_TEST_ASSERT(inSuite,
+                   lContext.mSystemLayer.StartTimer(
+                       Clock::Milliseconds32(20), [](Layer *, void * state) { *static_cast<bool *>(state) = true; }, &fired) ==
+                       CHIP_NO_ERROR);
+
+    const Clock::Timestamp start = SystemClock().GetMonotonicTimestamp();
+    for (int i = 0; i < 100 && !fired; i++)
+    {
+        lContext.ServiceEvents();
+    }
+    NL_TEST_ASSERT(inSuite, fired);
+    NL_TEST_ASSERT(inSuite, SystemClock().GetMonotonicTimestamp() - start >= Clock::Milliseconds64(19));
+}
+
+/**
+ * Measure the time from a pipe becoming readable to its callback running, with @a count sockets watched of which only
+ * one is ready at a time. The select() backend scans every watch on every pass; the epoll backend only touches ready ones.
+ */
+void MeasureDispatchLatency(nlTestSuite * inSuite, LayerSocketsLoop & layer, const char * name, size_t count)
+{
+    constexpr uint32_t kIterations = 2000;
+
+    WatchedPipe * pipes = new WatchedPipe[count];
+    size_t opened       = 0;
+    CHIP_ERROR err      = CHIP_NO_ERROR;
+    while (opened < count && err == CHIP_NO_ERROR)
+    {
+        err = pipes[opened++].Open(layer);
+    }
+
+    if (err != CHIP_NO_ERROR)
+    {
+        // Either the descriptor limit or the backend's socket watch pool is exhausted.
+        printf("EventLoop %s: %u sockets: not supported (%" CHIP_ERROR_FORMAT ")\n", name, static_cast<unsigned>(count),
+               err.Format());
+    }
+    else
+    {
+        uint32_t dispatched = 0;
+        auto start          = SystemClock().GetMonotonicMicroseconds64();
+        for (uint32_t n = 0; n < kIterations; n++)
+        {
+            WatchedPipe & ready = pipes[(n * 7919u) % count];
+            uint32_t before     = ready.mCallbackCount;
+            ready.Notify();
+            ServiceEvents(layer);
+            dispatched += ready.mCallbackCount - before;
+        }
+        auto elapsed = SystemClock().GetMonotonicMicroseconds64() - start;
+
+        NL_TEST_ASSERT(inSuite, dispatched == kIterations);
+        printf("EventLoop %s: %u sockets: %.2f us per dispatched event\n", name, static_cast<unsigned>(count),
+               static_cast<double>(elapsed.count()) / kIterations);
+    }
+
+    for (size_t i = 0; i < opened; i++)
+    {
+        pipes[i].Close();
+    }
+    delete[] pipes;
+}
+
+void TestDispatchLatencyBenchmark(nlTestSuite * inSuite, void * aContext)
+{
+    // Each watched pipe takes two descriptors.
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max)
+    {
+        limit.rlim_cur = limit.rlim_max;
+        (void) setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    // The select() backend cannot watch more sockets than there are inet endpoints, 64 on Linux.
+    static constexpr size_t kSocketCounts[] = { 16, 48, 256, 1024 };
+
+#if CHIP_SYSTEM_CONFIG_SELECT_AND_EPOLL
+    // Run the benchmark against both event loops, whichever of them is configured.
+    static LayerImplSelect sSelectLayer;
+    static LayerImplEpoll sEpollLayer;
+    NL_TEST_ASSERT(inSuite, sSelectLayer.Init() == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, sEpollLayer.Init() == CHIP_NO_ERROR);
+    for (size_t count : kSocketCounts)
+    {
+        MeasureDispatchLatency(inSuite, sSelectLayer, "select", count);
+        MeasureDispatchLatency(inSuite, sEpollLayer, "epoll", count);
+    }
+    sSelectLayer.Shutdown();
+    sEpollLayer.Shutdown();
+#else
+    TestContext & lContext = *static_cast<TestContext *>(aContext);
+    for (size_t count : kSocketCounts)
+    {
+        MeasureDispatchLatency(inSuite, lContext.mSystemLayer, "configured", count);
+    }
+#endif // CHIP_SYSTEM_CONFIG_SELECT_AND_EPOLL
+}
+
+} // namespace
+
+// Test Suite
+
+/**
+ *   Test Suite. It lists all the test functions.
+ */
+// clang-format off
+static const nlTest sTests[] =
+{
+    NL_TEST_DEF("EventLoop::TestReadCallback",              TestReadCallback),
+    NL_TEST_DEF("EventLoop::TestStopWatchingFromCallback",  TestStopWatchingFromCallback),
+    NL_TEST_DEF("EventLoop::TestTimerWakesWait",            TestTimerWakesWait),
+    NL_TEST_DEF("EventLoop::TestDispatchLatencyBenchmark",  TestDispatchLatencyBenchmark),
+    NL_TEST_SENTINEL()
+};
+// clang-format on
+
+static int TestSetup(void * aContext)
+{
+    TestContext & lContext = *static_cast<TestContext *>(aContext);
+
+    if (::chip::Platform::MemoryInit() != CHIP_NO_ERROR)
+    {
+        return FAILURE;
+    }
+
+    return (lContext.mSystemLayer.Init() == CHIP_NO_ERROR) ? SUCCESS : FAILURE;
+}
+
+static int TestTeardown(void * aContext)
+{
+    TestContext & lContext = *static_cast<TestContext *>(aContext);
+
+    lContext.mSystemLayer.Shutdown();
+    ::chip::Platform::MemoryShutdown();
+    return (SUCCESS);
+}
+
+static nlTestSuite kTheSuite = { "chip-system-event-loop", sTests, TestSetup, TestTeardown };
+
+int TestSystemEventLoop(void)
+{
+    static TestContext context;
+
+    nlTestRunner(&kTheSuite, &context);
+
+    return nlTestRunnerStats(&kTheSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestSystemEventLoop)
+#else  // CHIP_SYSTEM_CONFIG_USE_SOCKETS
+int TestSystemEventLoop(void)
+{
+    return SUCCESS;
+}
+#endif // CHIP_SYSTEM_CONFIG_USE_SOCKETS
@@ -39,6 +39,7 @@
 #include <lib/support/UnitTestRegistration.h>
 #include <platform/CHIPDeviceLayer.h>
 #include <system/SystemPacketBuffer.h>
+#include <system/SystemStats.h>
 
 #if CHIP_SYSTEM_CONFIG_USE_LWIP
 #include <lwip/init.h>
@@ -132,6 +133,7 @@ public:
     static void CheckHandleRightSize(nlTestSuite * inSuite, void * inContext);
     static void CheckHandleCloneData(nlTestSuite * inSuite, void * inContext);
     static void CheckPacketBufferWriter(nlTestSuite * inSuite, void * inContext);
+    static void CheckPoolSizeClasses(nlTestSuite * inSuite, void * inContext);
     static void CheckBuildFreeList(nlTestSuite * inSuite, void * inContext);
 
     static void PrintHandle(const char * tag, const PacketBuffer * buffer)
@@ -1962,6 +1964,71 @@ void PacketBufferTest::CheckPacketBufferWriter(nlTestSuite * inSuite, void * inC
     NL_TEST_ASSERT(inSuite, memcmp(yayBuffer->Start(), kPayload, sizeof kPayload) == 0);
 }
 
+/**
+ *  Test the size classes of the internal buffer pool.
+ *
+ *  Description: Allocate buffers for short exchange messages until the pool is exhausted, and check that at least as many
+ *               are in flight as the pool memory would hold as full-size buffers (strictly more when smaller size classes
+ *               are configured). Then check that a full-size request is still served once a full-size buffer is freed.
+ */
+void PacketBufferTest::CheckPoolSizeClasses(nlTestSuite * inSuite, void * inContext)
+{
+    struct TestContext * const theContext = static_cast<struct TestContext *>(inContext);
+    PacketBufferTest * const test         = theContext->test;
+    NL_TEST_ASSERT(inSuite, test->mContext == theContext);
+
+#if CHIP_SYSTEM_PACKETBUFFER_STORE == CHIP_SYSTEM_PACKETBUFFER_STORE_CHIP_POOL
+    // Typical size of an acknowledgement or status response, with the default header reserve.
+    constexpr size_t kExchangeMessageSize = 64;
+
+    size_t lPoolBytes = sizeof(PacketBuffer::sBufferPool);
+#if CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_SIZE
+    lPoolBytes += sizeof(PacketBuffer::sSmallBufferPool);
+#endif
+#if CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_MEDIUM_SIZE
+    lPoolBytes += sizeof(PacketBuffer::sMediumBufferPool);
+#endif
+    const size_t lFullSizeCapacity = lPoolBytes / sizeof(PacketBuffer::BufferPoolElement);
+
+    std::vector<PacketBufferHandle> inFlight;
+    for (;;)
+    {
+        PacketBufferHandle buffer = PacketBufferHandle::New(kExchangeMessageSize);
+        if (buffer.IsNull())
+        {
+            break;
+        }
+        NL_TEST_ASSERT(inSuite, buffer->AvailableDataLength() >= kExchangeMessageSize);
+        inFlight.push_back(std::move(buffer));
+    }
+
+    printf("PacketBuffer: %zu in-flight messages in %zu pool bytes (%zu full-size buffers)\n", inFlight.size(), lPoolBytes,
+           lFullSizeCapacity);
+    NL_TEST_ASSERT(inSuite, inFlight.size() >= lFullSizeCapacity);
+#if CHIP_SYSTEM_PACKETBUFFER_POOL_HAS_SIZE_CLASSES
+    NL_TEST_ASSERT(inSuite, inFlight.size() > lFullSizeCapacity);
+#if CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
+    const chip::System::Stats::count_t * const lHighWatermarks = chip::System::Stats::GetHighWatermarks();
+    NL_TEST_ASSERT(inSuite,
+                   lHighWatermarks[chip::System::Stats::kSystemLayer_NumSmallPacketBufs] >=
+                       CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_SIZE);
+    NL_TEST_ASSERT(inSuite,
+                   lHighWatermarks[chip::System::Stats::kSystemLayer_NumMediumPacketBufs] >=
+                       CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_MEDIUM_SIZE);
+    NL_TEST_ASSERT(inSuite,
+                   lHighWatermarks[chip::System::Stats::kSystemLayer_NumLargePacketBufs] >=
+                       CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SIZE);
+#endif // CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
+#endif // CHIP_SYSTEM_PACKETBUFFER_POOL_HAS_SIZE_CLASSES
+
+    // Buffers are allocated smallest class first, so the last one is full size; freeing it makes room for a full-size request.
+    NL_TEST_ASSERT(inSuite, !inFlight.empty() && inFlight.back()->AllocSize() == PacketBuffer::kMaxSizeWithoutReserve);
+    NL_TEST_ASSERT(inSuite, PacketBufferHandle::New(PacketBuffer::kMaxSize).IsNull());
+    inFlight.pop_back();
+    NL_TEST_ASSERT(inSuite, !PacketBufferHandle::New(PacketBuffer::kMaxSize).IsNull());
+#endif // CHIP_SYSTEM_PACKETBUFFER_STORE == CHIP_SYSTEM_PACKETBUFFER_STORE_CHIP_POOL
+}
+
 /**
  *   Test Suite. It lists all the test functions.
  */
@@ -2002,6 +2069,7 @@ const nlTest sTests[] =
     NL_TEST_DEF("PacketBuffer::HandleRightSize",        PacketBufferTest::CheckHandleRightSize),
     NL_TEST_DEF("PacketBuffer::HandleCloneData",        PacketBufferTest::CheckHandleCloneData),
     NL_TEST_DEF("PacketBuffer::PacketBufferWriter",     PacketBufferTest::CheckPacketBufferWriter),
+    NL_TEST_DEF("PacketBuffer::PoolSizeClasses",        PacketBufferTest::CheckPoolSizeClasses),
 
     NL_TEST_SENTINEL()
 };
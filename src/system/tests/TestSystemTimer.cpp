@@ -263,6 +263,9 @@ class TestTimer
 {
 public:
     static void CheckTimerPool(nlTestSuite * inSuite, void * aContext);
+#if CHIP_SYSTEM_CONFIG_USE_TIMER_WHEEL || CHIP_SYSTEM_CONFIG_TEST
+    static void CheckTimerWheelPopIfEarlier(nlTestSuite * inSuite, void * aContext);
+#endif // CHIP_SYSTEM_CONFIG_USE_TIMER_WHEEL || CHIP_SYSTEM_CONFIG_TEST
 };
 } // namespace System
 } // namespace chip
@@ -404,6 +407,210 @@ void chip::System::TestTimer::CheckTimerPool(nlTestSuite * inSuite, void * aCont
     NL_TEST_ASSERT(suite, SYSTEM_STATS_TEST_HIGH_WATER_MARK(Stats::kSystemLayer_NumTimers, 4));
 }
 
+#if CHIP_SYSTEM_CONFIG_USE_TIMER_WHEEL || CHIP_SYSTEM_CONFIG_TEST
+
+// Run the same random sequence of operations against a TimerList and a TimerWheel and check that both
+// always agree on which timer is earliest and on the order in which timers expire.
+void CheckTimerWheelOrder(nlTestSuite * inSuite, void * aContext)
+{
+    TestContext & testContext = *static_cast<TestContext *>(aContext);
+    Layer & systemLayer       = *testContext.mLayer;
+
+    constexpr size_t kTimers      = 200;
+    constexpr uint32_t kSteps     = 20000;
+    constexpr uint64_t kStartTime = 1234567;
+
+    struct TestState
+    {
+        static void Fire(Layer * layer, void * state) {}
+    };
+    // Each timer pair shares an app state, so Remove(onComplete, appState) can be compared too.
+    static uint8_t sAppStates[kTimers];
+
+    static TimerList::Node * sListTimers[kTimers];
+    static TimerList::Node * sWheelTimers[kTimers];
+    static bool sQueued[kTimers];
+
+    uint32_t random = 12345;
+    auto next       = [&random](uint32_t bound) {
+        random = random * 1103515245u + 12345u;
+        return (random >> 8) % bound;
+    };
+    auto indexOf = [](TimerList::Node * timer) -> size_t {
+        if (timer == nullptr)
+        {
+            return kTimers;
+        }
+        return static_cast<size_t>(static_cast<uint8_t *>(timer->GetCallback().GetAppState()) - sAppStates);
+    };
+
+    TimerList list;
+    TimerWheel wheel;
+    uint64_t now = kStartTime;
+
+    for (size_t i = 0; i < kTimers; i++)
+    {
+        sListTimers[i]  = nullptr;
+        sWheelTimers[i] = nullptr;
+        sQueued[i]      = false;
+    }
+
+    // Establish the wheel time, as the layers do on every pass.
+    (void) wheel.ExtractEarlier(Clock::Timestamp(now));
+
+    for (uint32_t step = 0; step < kSteps; step++)
+    {
+        const size_t i = next(kTimers);
+        switch (next(8))
+        {
+        case 0:
+        case 1:
+        case 2: {
+            if (sQueued[i])
+            {
+                break;
+            }
+            // Mostly short delays with many equal expiration times, some far enough out to reach the upper
+            // levels or the overflow list, and some already in the past.
+            uint64_t awaken;
+            switch (next(8))
+            {
+            case 0:
+                awaken = now - next(50);
+                break;
+            case 1:
+                awaken = now + next(1u << 24);
+                break;
+            case 2:
+                awaken = now + (uint64_t(1) << 30) + next(1u << 30);
+                break;
+            default:
+                awaken = now + next(300) / 10 * 10;
+                break;
+            }
+            delete sListTimers[i];
+            delete sWheelTimers[i];
+            sListTimers[i]  = new TimerList::Node(systemLayer, Clock::Timestamp(awaken), TestState::Fire, &sAppStates[i]);
+            sWheelTimers[i] = new TimerList::Node(systemLayer, Clock::Timestamp(awaken), TestState::Fire, &sAppStates[i]);
+            sQueued[i]      = true;
+            NL_TEST_ASSERT(inSuite, indexOf(list.Add(sListTimers[i])) == indexOf(wheel.Add(sWheelTimers[i])));
+            break;
+        }
+        case 3:
+            if (sQueued[i])
+            {
+                NL_TEST_ASSERT(inSuite, indexOf(list.Remove(sListTimers[i])) == indexOf(wheel.Remove(sWheelTimers[i])));
+                sQueued[i] = false;
+            }
+            break;
+        case 4: {
+            TimerList::Node * fromList  = list.Remove(TestState::Fire, &sAppStates[i]);
+            TimerList::Node * fromWheel = wheel.Remove(TestState::Fire, &sAppStates[i]);
+            NL_TEST_ASSERT(inSuite, indexOf(fromList) == indexOf(fromWheel));
+            sQueued[i] = false;
+            break;
+        }
+        case 5: {
+            TimerList::Node * fromList  = list.PopIfEarlier(Clock::Timestamp(now));
+            TimerList::Node * fromWheel = wheel.PopIfEarlier(Clock::Timestamp(now));
+            NL_TEST_ASSERT(inSuite, indexOf(fromList) == indexOf(fromWheel));
+            if (fromList != nullptr)
+            {
+                sQueued[indexOf(fromList)] = false;
+            }
+            break;
+        }
+        default: {
+            // Advance time, occasionally by a lot, and compare the expired timers.
+            now += (next(64) == 0) ? next(1u << 28) : next(40);
+            TimerList fromList  = list.ExtractEarlier(Clock::Timestamp(now));
+            TimerList fromWheel = wheel.ExtractEarlier(Clock::Timestamp(now));
+            TimerList::Node * timer;
+            while ((timer = fromList.PopEarliest()) != nullptr)
+            {
+                NL_TEST_ASSERT(inSuite, indexOf(timer) == indexOf(fromWheel.PopEarliest()));
+                sQueued[indexOf(timer)] = false;
+            }
+            NL_TEST_ASSERT(inSuite, fromWheel.Empty());
+            break;
+        }
+        }
+
+        NL_TEST_ASSERT(inSuite, indexOf(list.Earliest()) == indexOf(wheel.Earliest()));
+        NL_TEST_ASSERT(inSuite, list.Empty() == wheel.Empty());
+    }
+
+    // Drain what is left and compare the final order.
+    TimerList::Node * timer;
+    while ((timer = list.PopEarliest()) != nullptr)
+    {
+        NL_TEST_ASSERT(inSuite, indexOf(timer) == indexOf(wheel.PopEarliest()));
+    }
+    NL_TEST_ASSERT(inSuite, wheel.Empty());
+
+    for (size_t i = 0; i < kTimers; i++)
+    {
+        delete sListTimers[i];
+        delete sWheelTimers[i];
+    }
+}
+
+// Drive a TimerWheel the way the LwIP layer does, with PopIfEarlier() only, and check that the wheel time follows
+// so that timers do not pile up in the overflow list.
+void chip::System::TestTimer::CheckTimerWheelPopIfEarlier(nlTestSuite * inSuite, void * aContext)
+{
+    TestContext & testContext = *static_cast<TestContext *>(aContext);
+    Layer & systemLayer       = *testContext.mLayer;
+
+    constexpr size_t kTimers      = 16;
+    constexpr uint64_t kStartTime = uint64_t(1) << 40;
+
+    struct TestState
+    {
+        static void Fire(Layer * layer, void * state) {}
+    };
+    static uint8_t sAppStates[kTimers];
+
+    TimerWheel wheel;
+    TimerList::Node * timers[kTimers];
+    for (size_t i = 0; i < kTimers; i++)
+    {
+        const uint64_t awaken = kStartTime + 100 * (kTimers - i);
+        timers[i]             = new TimerList::Node(systemLayer, Clock::Timestamp(awaken), TestState::Fire, &sAppStates[i]);
+        (void) wheel.Add(timers[i]);
+    }
+    NL_TEST_ASSERT(inSuite, wheel.mSlots[TimerWheel::kOverflowSlot] != nullptr);
+
+    // Nothing has expired yet, but the wheel time moves up to the current time.
+    NL_TEST_ASSERT(inSuite, wheel.PopIfEarlier(Clock::Timestamp(kStartTime)) == nullptr);
+    NL_TEST_ASSERT(inSuite, wheel.mNow == kStartTime);
+    NL_TEST_ASSERT(inSuite, wheel.mSlots[TimerWheel::kOverflowSlot] == nullptr);
+
+    // Timers expire in order, each moving the wheel time up to its expiration time.
+    for (size_t i = kTimers; i-- > 0;)
+    {
+        TimerList::Node * timer = wheel.PopIfEarlier(Clock::Timestamp(kStartTime + 100 * kTimers + 1));
+        NL_TEST_ASSERT(inSuite, timer == timers[i]);
+        NL_TEST_ASSERT(inSuite, wheel.mNow == timers[i]->AwakenTime().count());
+    }
+    NL_TEST_ASSERT(inSuite, wheel.Empty());
+
+    // A timer started after a long idle period is still placed relative to the current time.
+    NL_TEST_ASSERT(inSuite, wheel.PopIfEarlier(Clock::Timestamp(kStartTime + 100000)) == nullptr);
+    delete timers[0];
+    timers[0] = new TimerList::Node(systemLayer, Clock::Timestamp(kStartTime + 100010), TestState::Fire, &sAppStates[0]);
+    (void) wheel.Add(timers[0]);
+    NL_TEST_ASSERT(inSuite, wheel.mSlots[TimerWheel::kOverflowSlot] == nullptr);
+    NL_TEST_ASSERT(inSuite, wheel.PopIfEarlier(Clock::Timestamp(kStartTime + 100011)) == timers[0]);
+
+    for (auto timer : timers)
+    {
+        delete timer;
+    }
+}
+
+#endif // CHIP_SYSTEM_CONFIG_USE_TIMER_WHEEL || CHIP_SYSTEM_CONFIG_TEST
+
 // Test Suite
 
 /**
@@ -416,6 +623,10 @@ static const nlTest sTests[] =
     NL_TEST_DEF("Timer::TestTimerStarvation",      CheckStarvation),
     NL_TEST_DEF("Timer::TestTimerOrder",           CheckOrder),
     NL_TEST_DEF("Timer::TestTimerPool",            chip::System::TestTimer::CheckTimerPool),
+#if CHIP_SYSTEM_CONFIG_USE_TIMER_WHEEL || CHIP_SYSTEM_CONFIG_TEST
+    NL_TEST_DEF("Timer::TestTimerWheelOrder",      CheckTimerWheelOrder),
+    NL_TEST_DEF("Timer::TestTimerWheelPopIfEarlier", chip::System::TestTimer::CheckTimerWheelPopIfEarlier),
+#endif // CHIP_SYSTEM_CONFIG_USE_TIMER_WHEEL || CHIP_SYSTEM_CONFIG_TEST
     NL_TEST_SENTINEL()
 };
 // clang-format on
@@ -0,0 +1,224 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <trace/TraceRecorder.h>
+
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+#include <system/SystemClock.h>
+
+#include <inttypes.h>
+#include <mutex>
+
+namespace chip {
+namespace trace {
+
+namespace Internal {
+std::atomic<bool> gTraceEnabled{ false };
+} // namespace Internal
+
+namespace {
+
+static_assert((CHIP_CONFIG_TRACE_BUFFER_EVENTS & (CHIP_CONFIG_TRACE_BUFFER_EVENTS - 1)) == 0,
+              "CHIP_CONFIG_TRACE_BUFFER_EVENTS must be a power of two");
+
+//
+// The fields of an event are atomics so that ExportChromeTrace() can read them while the owner thread overwrites them; the
+// relaxed accesses compile to plain loads and stores.
+//
+struct TraceEvent
+{
+    std::atomic<const char *> mLabel;
+    std::atomic<const char *> mGroup;
+    std::atomic<uint64_t> mTimestamp;
+    std::atomic<uint64_t> mDurationAndPhase;
+};
+
+//
+// A ring written by a single thread.  The writer bumps mStarted before it overwrites an event and mWritten once it is done,
+// which lets a reader tell the events it may have read half-written.
+//
+struct ThreadTraceBuffer
+{
+    std::atomic<uint64_t> mStarted{ 0 };
+    std::atomic<uint64_t> mWritten{ 0 };
+    std::atomic<uint64_t> mClearedAt{ 0 };
+    TraceEvent mEvents[CHIP_CONFIG_TRACE_BUFFER_EVENTS];
+};
+
+std::mutex sBuffersLock;
+ThreadTraceBuffer * sBuffers[CHIP_CONFIG_TRACE_MAX_THREADS];
+std::atomic<size_t> sBufferCount{ 0 };
+std::atomic<uint64_t> sDroppedEvents{ 0 };
+
+thread_local ThreadTraceBuffer * tBuffer = nullptr;
+thread_local bool tBufferUnavailable     = false;
+
+ThreadTraceBuffer * GetThreadBuffer()
+{
+    if (tBuffer == nullptr && !tBufferUnavailable)
+    {
+        std::lock_guard<std::mutex> lock(sBuffersLock);
+        size_t count = sBufferCount.load(std::memory_order_relaxed);
+
+        if (count < CHIP_CONFIG_TRACE_MAX_THREADS)
+        {
+            tBuffer = Platform::New<ThreadTraceBuffer>();
+        }
+
+        if (tBuffer != nullptr)
+        {
+            // The buffers outlive their threads, so that the events of short-lived threads still get exported.
+            sBuffers[count] = tBuffer;
+            sBufferCount.store(count + 1, std::memory_order_release);
+        }
+        else
+        {
+            tBufferUnavailable = true;
+        }
+    }
+
+    return tBuffer;
+}
+
+void WriteJsonString(FILE * file, const char * string)
+{
+    putc('"', file);
+    for (; *string != '\0'; string++)
+    {
+        if (*string == '"' || *string == '\\')
+        {
+            putc('\\', file);
+        }
+        putc(*string, file);
+    }
+    putc('"', file);
+}
+
+} // namespace
+
+void SetTraceEnabled(bool enabled)
+{
+    Internal::gTraceEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+uint64_t GetTraceTimestamp()
+{
+    return System::SystemClock().GetMonotonicMicroseconds64().count();
+}
+
+void RecordTraceEvent(TracePhase phase, const char * label, const char * group, uint64_t timestamp, uint32_t duration)
+{
+    ThreadTraceBuffer * buffer = GetThreadBuffer();
+
+    if (buffer == nullptr)
+    {
+        sDroppedEvents.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    uint64_t index     = buffer->mWritten.load(std::memory_order_relaxed);
+    TraceEvent & event = buffer->mEvents[index & (CHIP_CONFIG_TRACE_BUFFER_EVENTS - 1)];
+
+    buffer->mStarted.store(index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    event.mLabel.store(label, std::memory_order_relaxed);
+    event.mGroup.store(group, std::memory_order_relaxed);
+    event.mTimestamp.store(timestamp, std::memory_order_relaxed);
+    event.mDurationAndPhase.store((static_cast<uint64_t>(duration) << 8) | static_cast<uint8_t>(phase), std::memory_order_relaxed);
+
+    buffer->mWritten.store(index + 1, std::memory_order_release);
+}
+
+CHIP_ERROR ExportChromeTrace(FILE * file)
+{
+    VerifyOrReturnError(file != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    const size_t bufferCount = sBufferCount.load(std::memory_order_acquire);
+    bool first               = true;
+
+    fputs("{\"traceEvents\":[", file);
+    for (size_t thread = 0; thread < bufferCount; thread++)
+    {
+        ThreadTraceBuffer & buffer = *sBuffers[thread];
+        const uint64_t written     = buffer.mWritten.load(std::memory_order_acquire);
+        uint64_t begin             = buffer.mClearedAt.load(std::memory_order_relaxed);
+
+        if (written > CHIP_CONFIG_TRACE_BUFFER_EVENTS && written - CHIP_CONFIG_TRACE_BUFFER_EVENTS > begin)
+        {
+            begin = written - CHIP_CONFIG_TRACE_BUFFER_EVENTS;
+        }
+
+        for (uint64_t index = begin; index < written; index++)
+        {
+            const TraceEvent & event  = buffer.mEvents[index & (CHIP_CONFIG_TRACE_BUFFER_EVENTS - 1)];
+            const char * label        = event.mLabel.load(std::memory_order_relaxed);
+            const char * group        = event.mGroup.load(std::memory_order_relaxed);
+            uint64_t timestamp        = event.mTimestamp.load(std::memory_order_relaxed);
+            uint64_t durationAndPhase = event.mDurationAndPhase.load(std::memory_order_relaxed);
+
+            // Skip the event if the writer may have started overwriting it while it was being read.
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (buffer.mStarted.load(std::memory_order_relaxed) > index + CHIP_CONFIG_TRACE_BUFFER_EVENTS)
+            {
+                continue;
+            }
+
+            const char phase = static_cast<char>(durationAndPhase & 0xff);
+
+            fputs(first ? "\n{\"name\":" : ",\n{\"name\":", file);
+            WriteJsonString(file, label);
+            fputs(",\"cat\":", file);
+            WriteJsonString(file, group);
+            fprintf(file, ",\"ph\":\"%c\",\"ts\":%" PRIu64 ",\"pid\":1,\"tid\":%u", phase, timestamp,
+                    static_cast<unsigned>(thread + 1));
+            if (phase == static_cast<char>(TracePhase::kComplete))
+            {
+                fprintf(file, ",\"dur\":%" PRIu64, durationAndPhase >> 8);
+            }
+            else if (phase == static_cast<char>(TracePhase::kInstant))
+            {
+                fputs(",\"s\":\"t\"", file);
+            }
+            putc('}', file);
+            first = false;
+        }
+    }
+    fputs("\n],\"displayTimeUnit\":\"ms\"}\n", file);
+
+    return ferror(file) ? CHIP_ERROR_WRITE_FAILED : CHIP_NO_ERROR;
+}
+
+void ClearTrace()
+{
+    const size_t bufferCount = sBufferCount.load(std::memory_order_acquire);
+
+    for (size_t thread = 0; thread < bufferCount; thread++)
+    {
+        sBuffers[thread]->mClearedAt.store(sBuffers[thread]->mWritten.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    sDroppedEvents.store(0, std::memory_order_relaxed);
+}
+
+uint64_t GetDroppedTraceEventCount()
+{
+    return sDroppedEvents.load(std::memory_order_relaxed);
+}
+
+} // namespace trace
+} // namespace chip
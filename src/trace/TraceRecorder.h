@@ -0,0 +1,158 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      Built-in backend for the TRACE_EVENT_* macros: records spans and
+ *      instant events into per-thread ring buffers, and exports them in the
+ *      Chrome trace event format, which Perfetto and chrome://tracing open.
+ */
+
+#pragma once
+
+#include <lib/core/CHIPError.h>
+
+#include <atomic>
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * CHIP_CONFIG_TRACE_BUFFER_EVENTS
+ *
+ * The number of events kept per thread; older events are overwritten.  Must be a power of two.
+ */
+#ifndef CHIP_CONFIG_TRACE_BUFFER_EVENTS
+#define CHIP_CONFIG_TRACE_BUFFER_EVENTS 4096
+#endif
+
+/**
+ * CHIP_CONFIG_TRACE_MAX_THREADS
+ *
+ * The number of threads that can record events.  Events from further threads are dropped.
+ */
+#ifndef CHIP_CONFIG_TRACE_MAX_THREADS
+#define CHIP_CONFIG_TRACE_MAX_THREADS 32
+#endif
+
+namespace chip {
+namespace trace {
+
+enum class TracePhase : uint8_t
+{
+    kComplete = 'X',
+    kBegin    = 'B',
+    kEnd      = 'E',
+    kInstant  = 'i',
+};
+
+namespace Internal {
+extern std::atomic<bool> gTraceEnabled;
+} // namespace Internal
+
+/**
+ * Returns whether events are being recorded.  Recording is off until SetTraceEnabled(true) is called, and costs a load and a
+ * branch per trace macro while off.
+ */
+inline bool IsTraceEnabled()
+{
+    return Internal::gTraceEnabled.load(std::memory_order_relaxed);
+}
+
+void SetTraceEnabled(bool enabled);
+
+/**
+ * Returns the current trace timestamp, in microseconds.
+ */
+uint64_t GetTraceTimestamp();
+
+/**
+ * Record an event on the buffer of the calling thread, regardless of IsTraceEnabled().  label and group must outlive the
+ * recorder: they are kept as pointers, and are meant to be string literals.
+ */
+void RecordTraceEvent(TracePhase phase, const char * label, const char * group, uint64_t timestamp, uint32_t duration = 0);
+
+inline void TraceInstant(const char * label, const char * group = "", uint32_t traceId = 0)
+{
+    if (IsTraceEnabled())
+    {
+        RecordTraceEvent(TracePhase::kInstant, label, group, GetTraceTimestamp());
+    }
+}
+
+inline void TraceBegin(const char * label, const char * group = "", uint32_t traceId = 0)
+{
+    if (IsTraceEnabled())
+    {
+        RecordTraceEvent(TracePhase::kBegin, label, group, GetTraceTimestamp());
+    }
+}
+
+inline void TraceEnd(const char * label, const char * group = "", uint32_t traceId = 0)
+{
+    if (IsTraceEnabled())
+    {
+        RecordTraceEvent(TracePhase::kEnd, label, group, GetTraceTimestamp());
+    }
+}
+
+/**
+ * Records the lifetime of the object as one complete event, if recording was enabled when it was constructed.
+ */
+class ScopedTraceSpan
+{
+public:
+    ScopedTraceSpan(const char * label, const char * group = "", uint32_t traceId = 0) :
+        mLabel(label), mGroup(group), mStart(IsTraceEnabled() ? GetTraceTimestamp() : 0)
+    {}
+
+    ~ScopedTraceSpan()
+    {
+        if (mStart != 0)
+        {
+            uint64_t duration = GetTraceTimestamp() - mStart;
+            RecordTraceEvent(TracePhase::kComplete, mLabel, mGroup, mStart,
+                             static_cast<uint32_t>(duration > UINT32_MAX ? UINT32_MAX : duration));
+        }
+    }
+
+    ScopedTraceSpan(const ScopedTraceSpan &) = delete;
+    ScopedTraceSpan & operator=(const ScopedTraceSpan &) = delete;
+
+private:
+    const char * mLabel;
+    const char * mGroup;
+    uint64_t mStart;
+};
+
+/**
+ * Write the events held in the buffers of all the threads to file, as a Chrome trace event JSON document.  Safe to call while
+ * other threads record events; an event overwritten while it is being read is left out.
+ */
+CHIP_ERROR ExportChromeTrace(FILE * file);
+
+/**
+ * Forget the events recorded so far.
+ */
+void ClearTrace();
+
+/**
+ * Returns the number of events dropped because more than CHIP_CONFIG_TRACE_MAX_THREADS threads recorded events.
+ */
+uint64_t GetDroppedTraceEventCount();
+
+} // namespace trace
+} // namespace chip
@@ -0,0 +1,260 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <trace/TraceRecorder.h>
+#include <trace/trace.h>
+
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/UnitTestRegistration.h>
+
+#include <nlunit-test.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace chip;
+using namespace chip::trace;
+
+std::string Export()
+{
+    std::string json;
+    FILE * file = tmpfile();
+
+    if (file != nullptr)
+    {
+        if (ExportChromeTrace(file) == CHIP_NO_ERROR)
+        {
+            char chunk[512];
+            size_t length;
+
+            rewind(file);
+            while ((length = fread(chunk, 1, sizeof(chunk), file)) > 0)
+            {
+                json.append(chunk, length);
+            }
+        }
+        fclose(file);
+    }
+
+    return json;
+}
+
+size_t CountOccurrences(const std::string & json, const char * pattern)
+{
+    size_t count = 0;
+
+    for (size_t pos = json.find(pattern); pos != std::string::npos; pos = json.find(pattern, pos + 1))
+    {
+        count++;
+    }
+
+    return count;
+}
+
+void TracedFunction()
+{
+    TRACE_EVENT_SCOPE("TracedFunction", "Test");
+    TRACE_EVENT_INSTANT("Instant", "Test");
+}
+
+void TestDisabledByDefault(nlTestSuite * inSuite, void * inContext)
+{
+    ClearTrace();
+
+    NL_TEST_ASSERT(inSuite, !IsTraceEnabled());
+    TracedFunction();
+    TRACE_EVENT_START("Begin", "Test");
+    TRACE_EVENT_END("Begin", "Test");
+
+    NL_TEST_ASSERT(inSuite, CountOccurrences(Export(), "\"name\":") == 0);
+}
+
+void TestRecordEvents(nlTestSuite * inSuite, void * inContext)
+{
+    ClearTrace();
+    SetTraceEnabled(true);
+
+    TracedFunction();
+    TRACE_EVENT_START("Begin", "Test");
+    TRACE_EVENT_END("Begin", "Test");
+    {
+        // A span that was opened while recording was on is recorded even if recording is turned off before it closes.
+        TRACE_EVENT_SCOPE("Quoted \"span\"", "Test");
+        SetTraceEnabled(false);
+    }
+    TracedFunction();
+
+    std::string json = Export();
+
+    NL_TEST_ASSERT(inSuite, json.compare(0, 16, "{\"traceEvents\":[") == 0);
+    NL_TEST_ASSERT(inSuite, CountOccurrences(json, "\"name\":") == 5);
+    NL_TEST_ASSERT(inSuite, CountOccurrences(json, "\"name\":\"TracedFunction\",\"cat\":\"Test\",\"ph\":\"X\"") == 1);
+    NL_TEST_ASSERT(inSuite, CountOccurrences(json, "\"name\":\"Instant\",\"cat\":\"Test\",\"ph\":\"i\"") == 1);
+    NL_TEST_ASSERT(inSuite, CountOccurrences(json, "\"name\":\"Begin\",\"cat\":\"Test\",\"ph\":\"B\"") == 1);
+    NL_TEST_ASSERT(inSuite, CountOccurrences(json, "\"name\":\"Begin\",\"cat\":\"Test\",\"ph\":\"E\"") == 1);
+    NL_TEST_ASSERT(inSuite, CountOccurrences(json, "\"name\":\"Quoted \\\"span\\\"\"") == 1);
+    NL_TEST_ASSERT(inSuite, CountOccurrences(json, "\"dur\":") == 2);
+
+    // The instant event is recorded while the span around it is open, but the span is recorded when it closes.
+    NL_TEST_ASSERT(inSuite, json.find("\"Instant\"") < json.find("\"TracedFunction\""));
+
+    ClearTrace();
+    NL_TEST_ASSERT(inSuite, CountOccurrences(Export(), "\"name\":") == 0);
+}
+
+void TestRingWraps(nlTestSuite * inSuite, void * inContext)
+{
+    constexpr uint64_t kExtraEvents = 10;
+
+    ClearTrace();
+
+    for (uint64_t i = 0; i < CHIP_CONFIG_TRACE_BUFFER_EVENTS + kExtraEvents; i++)
+    {
+        RecordTraceEvent(TracePhase::kInstant, "Event", "Test", i);
+    }
+
+    // Only the newest events are kept.
+    std::string json          = Export();
+    std::string oldestKept    = "\"ts\":" + std::to_string(kExtraEvents) + ",";
+    std::string newestDropped = "\"ts\":" + std::to_string(kExtraEvents - 1) + ",";
+
+    NL_TEST_ASSERT(inSuite, CountOccurrences(json, "\"name\":\"Event\"") == CHIP_CONFIG_TRACE_BUFFER_EVENTS);
+    NL_TEST_ASSERT(inSuite, CountOccurrences(json, oldestKept.c_str()) == 1);
+    NL_TEST_ASSERT(inSuite, CountOccurrences(json, newestDropped.c_str()) == 0);
+
+    ClearTrace();
+}
+
+void TestThreads(nlTestSuite * inSuite, void * inContext)
+{
+    constexpr size_t kThreads         = 4;
+    constexpr size_t kEventsPerThread = 100;
+
+    std::atomic<bool> stop{ false };
+    std::vector<std::thread> threads;
+
+    ClearTrace();
+    SetTraceEnabled(true);
+
+    for (size_t i = 0; i < kThreads; i++)
+    {
+        threads.emplace_back([] {
+            for (size_t j = 0; j < kEventsPerThread; j++)
+            {
+                TRACE_EVENT_SCOPE("Worker", "Test");
+            }
+        });
+    }
+
+    // Export while another thread keeps overwriting its ring.
+    std::thread spinner([&stop] {
+        while (!stop.load())
+        {
+            TRACE_EVENT_INSTANT("Spinner", "Test");
+        }
+    });
+    for (int i = 0; i < 5; i++)
+    {
+        NL_TEST_ASSERT(inSuite, Export().compare(0, 16, "{\"traceEvents\":[") == 0);
+    }
+    stop.store(true);
+    spinner.join();
+
+    for (auto & thread : threads)
+    {
+        thread.join();
+    }
+
+    SetTraceEnabled(false);
+
+    // The events of the threads that exited are still exported.
+    std::string json = Export();
+    NL_TEST_ASSERT(inSuite, CountOccurrences(json, "\"name\":\"Worker\"") == kThreads * kEventsPerThread);
+    NL_TEST_ASSERT(inSuite, GetDroppedTraceEventCount() == 0);
+
+    ClearTrace();
+}
+
+void TestOverhead(nlTestSuite * inSuite, void * inContext)
+{
+    constexpr uint32_t kIterations = 1000000;
+
+    using Clock = std::chrono::steady_clock;
+
+    auto measure = [](bool enabled) {
+        SetTraceEnabled(enabled);
+        auto start = Clock::now();
+        for (uint32_t i = 0; i < kIterations; i++)
+        {
+            TRACE_EVENT_SCOPE("Overhead", "Test");
+        }
+        auto elapsed = Clock::now() - start;
+        SetTraceEnabled(false);
+        return std::chrono::duration<double, std::nano>(elapsed).count() / kIterations;
+    };
+
+    ClearTrace();
+    double disabled = measure(false);
+    double enabled  = measure(true);
+    ClearTrace();
+
+    printf("Trace span cost: %.1f ns disabled, %.1f ns enabled\n", disabled, enabled);
+    NL_TEST_ASSERT(inSuite, disabled <= enabled);
+}
+
+int Initialize(void * apSuite)
+{
+    VerifyOrReturnError(Platform::MemoryInit() == CHIP_NO_ERROR, FAILURE);
+    return SUCCESS;
+}
+
+int Finalize(void * aContext)
+{
+    Platform::MemoryShutdown();
+    return SUCCESS;
+}
+
+} // namespace
+
+#define NL_TEST_DEF_FN(fn) NL_TEST_DEF("Test " #fn, fn)
+/**
+ *   Test Suite. It lists all the test functions.
+ */
+static const nlTest sTests[] = {
+    NL_TEST_DEF_FN(TestDisabledByDefault), //
+    NL_TEST_DEF_FN(TestRecordEvents),      //
+    NL_TEST_DEF_FN(TestRingWraps),         //
+    NL_TEST_DEF_FN(TestThreads),           //
+    NL_TEST_DEF_FN(TestOverhead),          //
+    NL_TEST_SENTINEL(),                    //
+};
+
+int TestTraceRecorder()
+{
+    nlTestSuite theSuite = { "CHIP TraceRecorder tests", &sTests[0], Initialize, Finalize };
+
+    nlTestRunner(&theSuite, nullptr);
+    return nlTestRunnerStats(&theSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestTraceRecorder);
@@ -38,6 +38,36 @@
 #define TRACE_EVENT_FUNCTION(...) PW_TRACE_FUNCTION(__VA_ARGS__)
 #define TRACE_EVENT_FUNCTION_FLAG(...) PW_TRACE_FUNCTION_FLAG(__VA_ARGS__)
 
+#elif defined(CHIP_TRACE_BUILTIN_BACKEND) && CHIP_TRACE_BUILTIN_BACKEND
+
+#include <trace/TraceRecorder.h>
+
+#define _TRACE_EVENT_CONCAT_IMPL(a, b) a##b
+#define _TRACE_EVENT_CONCAT(a, b) _TRACE_EVENT_CONCAT_IMPL(a, b)
+
+// The arguments follow the pw_trace macros: (label[, group[, trace_id]]), with an extra leading flag for the _FLAG variants.
+// The _DATA variants record their label only.
+#define _TRACE_EVENT_FLAG_DROPPED(flag, ...) (__VA_ARGS__)
+#define _TRACE_EVENT_DATA_DROPPED(label, ...) (label)
+
+#define TRACE_EVENT_INSTANT(...) ::chip::trace::TraceInstant(__VA_ARGS__)
+#define TRACE_EVENT_INSTANT_FLAG(...) ::chip::trace::TraceInstant _TRACE_EVENT_FLAG_DROPPED(__VA_ARGS__)
+#define TRACE_EVENT_INSTANT_DATA(...) ::chip::trace::TraceInstant _TRACE_EVENT_DATA_DROPPED(__VA_ARGS__)
+#define TRACE_EVENT_INSTANT_DATA_FLAG(flag, ...) ::chip::trace::TraceInstant _TRACE_EVENT_DATA_DROPPED(__VA_ARGS__)
+#define TRACE_EVENT_START(...) ::chip::trace::TraceBegin(__VA_ARGS__)
+#define TRACE_EVENT_START_FLAG(...) ::chip::trace::TraceBegin _TRACE_EVENT_FLAG_DROPPED(__VA_ARGS__)
+#define TRACE_EVENT_START_DATA(...) ::chip::trace::TraceBegin _TRACE_EVENT_DATA_DROPPED(__VA_ARGS__)
+#define TRACE_EVENT_START_DATA_FLAG(flag, ...) ::chip::trace::TraceBegin _TRACE_EVENT_DATA_DROPPED(__VA_ARGS__)
+#define TRACE_EVENT_END(...) ::chip::trace::TraceEnd(__VA_ARGS__)
+#define TRACE_EVENT_END_FLAG(...) ::chip::trace::TraceEnd _TRACE_EVENT_FLAG_DROPPED(__VA_ARGS__)
+#define TRACE_EVENT_END_DATA(...) ::chip::trace::TraceEnd _TRACE_EVENT_DATA_DROPPED(__VA_ARGS__)
+#define TRACE_EVENT_END_DATA_FLAG(flag, ...) ::chip::trace::TraceEnd _TRACE_EVENT_DATA_DROPPED(__VA_ARGS__)
+#define TRACE_EVENT_SCOPE(...) ::chip::trace::ScopedTraceSpan _TRACE_EVENT_CONCAT(_trace_event_scope_, __LINE__)(__VA_ARGS__)
+#define TRACE_EVENT_SCOPE_FLAG(flag, ...) TRACE_EVENT_SCOPE(__VA_ARGS__)
+#define TRACE_EVENT_FUNCTION(...)                                                                                                  \
+    ::chip::trace::ScopedTraceSpan _TRACE_EVENT_CONCAT(_trace_event_scope_, __LINE__)(__func__, ##__VA_ARGS__)
+#define TRACE_EVENT_FUNCTION_FLAG(flag, ...) TRACE_EVENT_FUNCTION(__VA_ARGS__)
+
 #else // defined(PW_TRACE_BACKEND_SET) && PW_TRACE_BACKEND_SET
 
 #define _TRACE_EVENT_DISABLE(...)                                                                                                  \
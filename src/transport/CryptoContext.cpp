@@ -37,9 +37,6 @@ namespace chip {
 
 namespace {
 
-constexpr size_t kAESCCMIVLen = 13;
-constexpr size_t kMaxAADLen   = 128;
-
 /* Session Establish Key Info */
 constexpr uint8_t SEKeysInfo[] = { 0x53, 0x65, 0x73, 0x73, 0x69, 0x6f, 0x6e, 0x4b, 0x65, 0x79, 0x73 };
 
@@ -111,6 +108,16 @@ CHIP_ERROR CryptoContext::InitFromSecret(const ByteSpan & secret, const ByteSpan
 
 #endif
 
+#if CHIP_CONFIG_SECURE_SESSION_KEYED_CIPHERS
+    // Messages we send are encrypted with the key of our role, and those we receive with the key of the peer's.
+    const KeyUsage sendKey    = (role == SessionRole::kInitiator) ? kI2RKey : kR2IKey;
+    const KeyUsage receiveKey = (role == SessionRole::kInitiator) ? kR2IKey : kI2RKey;
+    ReturnErrorOnFailure(mEncryptionCipher.Init(mKeys[sendKey], Crypto::kAES_CCM128_Key_Length, kAESCCMIVLen,
+                                                Crypto::CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES));
+    ReturnErrorOnFailure(mDecryptionCipher.Init(mKeys[receiveKey], Crypto::kAES_CCM128_Key_Length, kAESCCMIVLen,
+                                                Crypto::CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES));
+#endif
+
     mKeyAvailable = true;
     mSessionRole  = role;
 
@@ -161,7 +168,18 @@ CHIP_ERROR CryptoContext::GetAdditionalAuthData(const PacketHeader & header, uin
 }
 
 CHIP_ERROR CryptoContext::Encrypt(const uint8_t * input, size_t input_length, uint8_t * output, PacketHeader & header,
-                                  MessageAuthenticationCode & mac) const
+                                  MessageAuthenticationCode & mac)
+{
+    uint8_t AAD[kMaxAADLen];
+    uint16_t aadLen = sizeof(AAD);
+
+    ReturnErrorOnFailure(GetAdditionalAuthData(header, AAD, aadLen));
+
+    return Encrypt(input, input_length, output, header, ByteSpan(AAD, aadLen), mac);
+}
+
+CHIP_ERROR CryptoContext::Encrypt(const uint8_t * input, size_t input_length, uint8_t * output, PacketHeader & header,
+                                  const ByteSpan & aad, MessageAuthenticationCode & mac)
 {
 
     const size_t taglen = header.MICTagLength();
@@ -172,27 +190,23 @@ CHIP_ERROR CryptoContext::Encrypt(const uint8_t * input, size_t input_length, ui
     VerifyOrReturnError(input != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
     VerifyOrReturnError(input_length > 0, CHIP_ERROR_INVALID_ARGUMENT);
     VerifyOrReturnError(output != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(taglen == Crypto::CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES, CHIP_ERROR_INVALID_ARGUMENT);
 
-    uint8_t AAD[kMaxAADLen];
     uint8_t IV[kAESCCMIVLen];
-    uint16_t aadLen = sizeof(AAD);
     uint8_t tag[kMaxTagLen];
 
     ReturnErrorOnFailure(GetIV(header, IV, sizeof(IV)));
-    ReturnErrorOnFailure(GetAdditionalAuthData(header, AAD, aadLen));
-
-    KeyUsage usage = kR2IKey;
 
     // Message is encrypted before sending. If the secure session was created by session
-    // initiator, we'll use I2R key to encrypt the message that's being transmitted.
-    // Otherwise, we'll use R2I key, as the responder is sending the message.
-    if (mSessionRole == SessionRole::kInitiator)
-    {
-        usage = kI2RKey;
-    }
-
-    ReturnErrorOnFailure(AES_CCM_encrypt(input, input_length, AAD, aadLen, mKeys[usage], Crypto::kAES_CCM128_Key_Length, IV,
-                                         sizeof(IV), output, tag, taglen));
+    // initiator, the I2R key is used to encrypt the message that's being transmitted.
+    // Otherwise, the R2I key, as the responder is sending the message.
+#if CHIP_CONFIG_SECURE_SESSION_KEYED_CIPHERS
+    ReturnErrorOnFailure(mEncryptionCipher.Encrypt(input, input_length, aad.data(), aad.size(), IV, output, tag));
+#else
+    KeyUsage usage = (mSessionRole == SessionRole::kInitiator) ? kI2RKey : kR2IKey;
+    ReturnErrorOnFailure(AES_CCM_encrypt(input, input_length, aad.data(), aad.size(), mKeys[usage], Crypto::kAES_CCM128_Key_Length,
+                                         IV, sizeof(IV), output, tag, taglen));
+#endif
 
     mac.SetTag(&header, tag, taglen);
 
@@ -200,34 +214,41 @@ CHIP_ERROR CryptoContext::Encrypt(const uint8_t * input, size_t input_length, ui
 }
 
 CHIP_ERROR CryptoContext::Decrypt(const uint8_t * input, size_t input_length, uint8_t * output, const PacketHeader & header,
-                                  const MessageAuthenticationCode & mac) const
+                                  const MessageAuthenticationCode & mac)
+{
+    uint8_t AAD[kMaxAADLen];
+    uint16_t aadLen = sizeof(AAD);
+
+    ReturnErrorOnFailure(GetAdditionalAuthData(header, AAD, aadLen));
+
+    return Decrypt(input, input_length, output, header, ByteSpan(AAD, aadLen), mac);
+}
+
+CHIP_ERROR CryptoContext::Decrypt(const uint8_t * input, size_t input_length, uint8_t * output, const PacketHeader & header,
+                                  const ByteSpan & aad, const MessageAuthenticationCode & mac)
 {
     const size_t taglen = header.MICTagLength();
     const uint8_t * tag = mac.GetTag();
     uint8_t IV[kAESCCMIVLen];
-    uint8_t AAD[kMaxAADLen];
-    uint16_t aadLen = sizeof(AAD);
 
     VerifyOrReturnError(mKeyAvailable, CHIP_ERROR_INVALID_USE_OF_SESSION_KEY);
     VerifyOrReturnError(input != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
     VerifyOrReturnError(input_length > 0, CHIP_ERROR_INVALID_ARGUMENT);
     VerifyOrReturnError(output != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(taglen == Crypto::CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES, CHIP_ERROR_INVALID_ARGUMENT);
 
     ReturnErrorOnFailure(GetIV(header, IV, sizeof(IV)));
-    ReturnErrorOnFailure(GetAdditionalAuthData(header, AAD, aadLen));
-
-    KeyUsage usage = kI2RKey;
 
     // Message is decrypted on receive. If the secure session was created by session
-    // initiator, we'll use R2I key to decrypt the message (as it was sent by responder).
-    // Otherwise, we'll use I2R key, as the responder is sending the message.
-    if (mSessionRole == SessionRole::kInitiator)
-    {
-        usage = kR2IKey;
-    }
-
-    return AES_CCM_decrypt(input, input_length, AAD, aadLen, tag, taglen, mKeys[usage], Crypto::kAES_CCM128_Key_Length, IV,
-                           sizeof(IV), output);
+    // initiator, the R2I key is used to decrypt the message (as it was sent by responder).
+    // Otherwise, the I2R key, as the initiator is sending the message.
+#if CHIP_CONFIG_SECURE_SESSION_KEYED_CIPHERS
+    return mDecryptionCipher.Decrypt(input, input_length, aad.data(), aad.size(), tag, IV, output);
+#else
+    KeyUsage usage = (mSessionRole == SessionRole::kInitiator) ? kR2IKey : kI2RKey;
+    return AES_CCM_decrypt(input, input_length, aad.data(), aad.size(), tag, taglen, mKeys[usage], Crypto::kAES_CCM128_Key_Length,
+                           IV, sizeof(IV), output);
+#endif
 }
 
 } // namespace chip
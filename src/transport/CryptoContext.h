@@ -37,10 +37,13 @@ class DLL_EXPORT CryptoContext
 public:
     CryptoContext();
     ~CryptoContext();
-    CryptoContext(CryptoContext &&)      = default;
-    CryptoContext(const CryptoContext &) = default;
-    CryptoContext & operator=(const CryptoContext &) = default;
-    CryptoContext & operator=(CryptoContext &&) = default;
+    CryptoContext(CryptoContext &&)      = delete;
+    CryptoContext(const CryptoContext &) = delete;
+    CryptoContext & operator=(const CryptoContext &) = delete;
+    CryptoContext & operator=(CryptoContext &&) = delete;
+
+    static constexpr size_t kAESCCMIVLen = 13;
+    static constexpr size_t kMaxAADLen   = 128;
 
     /**
      *    Whether the current node initiated the session, or it is responded to a session request.
@@ -98,7 +101,24 @@ public:
      * @return CHIP_ERROR The result of encryption
      */
     CHIP_ERROR Encrypt(const uint8_t * input, size_t input_length, uint8_t * output, PacketHeader & header,
-                       MessageAuthenticationCode & mac) const;
+                       MessageAuthenticationCode & mac);
+
+    /**
+     * @brief
+     *   Encrypt the input data using keys established in the secure channel, authenticating the
+     *   given encoding of the message header instead of encoding it again.
+     *
+     * @param input Unencrypted input data
+     * @param input_length Length of the input data
+     * @param output Output buffer for encrypted data, which may be input itself
+     * @param header message header structure
+     * @param aad The encoded message header
+     * @param mac - output the resulting mac
+     *
+     * @return CHIP_ERROR The result of encryption
+     */
+    CHIP_ERROR Encrypt(const uint8_t * input, size_t input_length, uint8_t * output, PacketHeader & header, const ByteSpan & aad,
+                       MessageAuthenticationCode & mac);
 
     /**
      * @brief
@@ -112,7 +132,23 @@ public:
      * @param mac Input mac
      */
     CHIP_ERROR Decrypt(const uint8_t * input, size_t input_length, uint8_t * output, const PacketHeader & header,
-                       const MessageAuthenticationCode & mac) const;
+                       const MessageAuthenticationCode & mac);
+
+    /**
+     * @brief
+     *   Decrypt the input data using keys established in the secure channel, authenticating the
+     *   message header as it was received instead of encoding it again.
+     *
+     * @param input Encrypted input data
+     * @param input_length Length of the input data
+     * @param output Output buffer for decrypted data, which may be input itself
+     * @param header message header structure
+     * @param aad The message header as received
+     * @param mac Input mac
+     * @return CHIP_ERROR The result of decryption
+     */
+    CHIP_ERROR Decrypt(const uint8_t * input, size_t input_length, uint8_t * output, const PacketHeader & header,
+                       const ByteSpan & aad, const MessageAuthenticationCode & mac);
 
     ByteSpan GetAttestationChallenge() const { return ByteSpan(mKeys[kAttestationChallengeKey], Crypto::kAES_CCM128_Key_Length); }
 
@@ -125,6 +161,14 @@ public:
      */
     size_t EncryptionOverhead();
 
+    // Build the AES-CCM nonce for a message from its security flags, counter and source node id.
+    static CHIP_ERROR GetIV(const PacketHeader & header, uint8_t * iv, size_t len);
+
+    // Use unencrypted header as additional authenticated data (AAD) during encryption and decryption.
+    // The encryption operations includes AAD when message authentication tag is generated. This tag
+    // is used at the time of decryption to integrity check the received data.
+    static CHIP_ERROR GetAdditionalAuthData(const PacketHeader & header, uint8_t * aad, uint16_t & len);
+
 private:
     typedef uint8_t CryptoKey[Crypto::kAES_CCM128_Key_Length];
 
@@ -141,12 +185,11 @@ private:
     bool mKeyAvailable;
     CryptoKey mKeys[KeyUsage::kNumCryptoKeys];
 
-    static CHIP_ERROR GetIV(const PacketHeader & header, uint8_t * iv, size_t len);
-
-    // Use unencrypted header as additional authenticated data (AAD) during encryption and decryption.
-    // The encryption operations includes AAD when message authentication tag is generated. This tag
-    // is used at the time of decryption to integrity check the received data.
-    static CHIP_ERROR GetAdditionalAuthData(const PacketHeader & header, uint8_t * aad, uint16_t & len);
+#if CHIP_CONFIG_SECURE_SESSION_KEYED_CIPHERS
+    // Ciphers keyed once with the keys for the messages we send and receive.
+    Crypto::AES_CCM_context mEncryptionCipher;
+    Crypto::AES_CCM_context mDecryptionCipher;
+#endif
 };
 
 } // namespace chip
@@ -0,0 +1,404 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements the operational group key cache used to decrypt
+ *      incoming group messages.
+ *
+ */
+
+#include <transport/GroupKeyCache.h>
+
+#include <lib/core/CHIPEncoding.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/SafeInt.h>
+#include <lib/support/logging/CHIPLogging.h>
+#include <transport/CryptoContext.h>
+
+#include <string.h>
+
+namespace chip {
+namespace Transport {
+
+namespace {
+
+/* "GroupKey v1.0" */
+constexpr uint8_t kGroupKeyInfo[] = { 0x47, 0x72, 0x6f, 0x75, 0x70, 0x4b, 0x65, 0x79, 0x20, 0x76, 0x31, 0x2e, 0x30 };
+
+/* "GroupKeyHash" */
+constexpr uint8_t kGroupKeyHashInfo[] = { 0x47, 0x72, 0x6f, 0x75, 0x70, 0x4b, 0x65, 0x79, 0x48, 0x61, 0x73, 0x68 };
+
+} // namespace
+
+using namespace Crypto;
+using GroupDataProvider = Credentials::GroupDataProvider;
+
+constexpr size_t GroupKeyCache::kKeyLength;
+
+CHIP_ERROR GroupKeyCache::Init(Credentials::GroupDataProvider * provider)
+{
+    VerifyOrReturnError(provider != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(mProvider == nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    mProvider     = provider;
+    mNextListener = provider->GetListener();
+    mProvider->SetListener(this);
+    return CHIP_NO_ERROR;
+}
+
+void GroupKeyCache::Shutdown()
+{
+    if (mProvider != nullptr)
+    {
+        // Hand the provider back to the listener we replaced, unless someone else replaced us in turn.
+        if (mProvider->GetListener() == this)
+        {
+            mProvider->SetListener(mNextListener);
+        }
+        mProvider     = nullptr;
+        mNextListener = nullptr;
+    }
+
+    for (auto & state : mFabrics)
+    {
+        state = FabricState();
+    }
+    for (size_t i = 0; i < mEntryCount; i++)
+    {
+        ClearSecretData(mEntries[i].key, sizeof(mEntries[i].key));
+    }
+    mEntryCount      = 0;
+    mHasStaleFabrics = false;
+}
+
+CHIP_ERROR GroupKeyCache::SetFabric(FabricIndex fabric, CompressedFabricId compressedFabricId)
+{
+    VerifyOrReturnError(fabric != kUndefinedFabricIndex, CHIP_ERROR_INVALID_ARGUMENT);
+
+    FabricState * state = FindFabric(fabric);
+    if (state == nullptr)
+    {
+        state = FindFabric(kUndefinedFabricIndex);
+        VerifyOrReturnError(state != nullptr, CHIP_ERROR_NO_MEMORY);
+        state->fabric = fabric;
+    }
+
+    state->compressedFabricId = compressedFabricId;
+    state->stale              = true;
+    mHasStaleFabrics          = true;
+    return CHIP_NO_ERROR;
+}
+
+void GroupKeyCache::RemoveFabric(FabricIndex fabric)
+{
+    FabricState * state = FindFabric(fabric);
+    VerifyOrReturn(state != nullptr);
+
+    RemoveEntries(fabric);
+    *state = FabricState();
+}
+
+CHIP_ERROR GroupKeyCache::SetFabrics(const FabricTable & fabrics)
+{
+    for (const auto & fabricInfo : fabrics)
+    {
+        ReturnErrorOnFailure(SetFabric(fabricInfo.GetFabricIndex(), fabricInfo.GetPeerId().GetCompressedFabricId()));
+    }
+    return CHIP_NO_ERROR;
+}
+
+void GroupKeyCache::Invalidate(FabricIndex fabric)
+{
+    FabricState * state = FindFabric(fabric);
+    VerifyOrReturn(state != nullptr);
+
+    state->stale     = true;
+    mHasStaleFabrics = true;
+}
+
+void GroupKeyCache::OnGroupAdded(FabricIndex fabric_index, const GroupDataProvider::GroupInfo & new_group)
+{
+    if (mNextListener != nullptr)
+    {
+        mNextListener->OnGroupAdded(fabric_index, new_group);
+    }
+}
+
+void GroupKeyCache::OnGroupRemoved(FabricIndex fabric_index, const GroupDataProvider::GroupInfo & old_group)
+{
+    if (mNextListener != nullptr)
+    {
+        mNextListener->OnGroupRemoved(fabric_index, old_group);
+    }
+}
+
+void GroupKeyCache::OnGroupKeysChanged(FabricIndex fabric_index)
+{
+    Invalidate(fabric_index);
+    if (mNextListener != nullptr)
+    {
+        mNextListener->OnGroupKeysChanged(fabric_index);
+    }
+}
+
+size_t GroupKeyCache::GetEntryCount()
+{
+    RefreshStaleFabrics();
+    return mEntryCount;
+}
+
+CHIP_ERROR GroupKeyCache::DecryptMessage(const PacketHeader & packetHeader, System::PacketBufferHandle & msg,
+                                         FabricIndex & outFabric)
+{
+    VerifyOrReturnError(!msg.IsNull(), CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(!msg->HasChainedBuffer(), CHIP_ERROR_INVALID_MESSAGE_LENGTH);
+    VerifyOrReturnError(packetHeader.GetDestinationGroupId().HasValue(), CHIP_ERROR_INVALID_ARGUMENT);
+
+    RefreshStaleFabrics();
+
+    const GroupId groupId    = packetHeader.GetDestinationGroupId().Value();
+    const uint16_t sessionId = packetHeader.GetSessionId();
+
+    // Count the candidates first: if there is a single one (by far the common
+    // case) it can be tried directly in place, otherwise the ciphertext needs to
+    // be preserved across failed attempts.
+    size_t first      = LowerBound(sessionId);
+    size_t candidates = 0;
+    for (size_t i = first; i < mEntryCount && mEntries[i].sessionId == sessionId; i++)
+    {
+        candidates += (mEntries[i].groupId == groupId) ? 1 : 0;
+    }
+    VerifyOrReturnError(candidates > 0, CHIP_ERROR_KEY_NOT_FOUND);
+
+    uint8_t * data     = msg->Start();
+    uint16_t len       = msg->DataLength();
+    uint16_t footerLen = packetHeader.MICTagLength();
+    VerifyOrReturnError(footerLen <= len, CHIP_ERROR_INVALID_MESSAGE_LENGTH);
+
+    uint16_t taglen = 0;
+    MessageAuthenticationCode mac;
+    ReturnErrorOnFailure(mac.Decode(packetHeader, &data[len - footerLen], footerLen, &taglen));
+    VerifyOrReturnError(taglen == footerLen, CHIP_ERROR_INTERNAL);
+    len = static_cast<uint16_t>(len - taglen);
+
+    uint8_t iv[CryptoContext::kAESCCMIVLen];
+    uint8_t aad[CryptoContext::kMaxAADLen];
+    uint16_t aadLen = sizeof(aad);
+    ReturnErrorOnFailure(CryptoContext::GetIV(packetHeader, iv, sizeof(iv)));
+    ReturnErrorOnFailure(CryptoContext::GetAdditionalAuthData(packetHeader, aad, aadLen));
+
+    System::PacketBufferHandle scratch;
+    if (candidates > 1)
+    {
+        scratch = System::PacketBufferHandle::New(len, 0);
+        VerifyOrReturnError(!scratch.IsNull(), CHIP_ERROR_NO_MEMORY);
+    }
+
+    for (size_t i = first; i < mEntryCount && mEntries[i].sessionId == sessionId; i++)
+    {
+        const Entry & entry = mEntries[i];
+        if (entry.groupId != groupId)
+        {
+            continue;
+        }
+
+        uint8_t * output = scratch.IsNull() ? data : scratch->Start();
+        if (AES_CCM_decrypt(data, len, aad, aadLen, mac.GetTag(), taglen, entry.key, sizeof(entry.key), iv, sizeof(iv), output) !=
+            CHIP_NO_ERROR)
+        {
+            continue;
+        }
+
+        if (output != data)
+        {
+            memcpy(data, output, len);
+        }
+        msg->SetDataLength(len);
+        outFabric = entry.fabric;
+        return CHIP_NO_ERROR;
+    }
+
+    return CHIP_ERROR_INTEGRITY_CHECK_FAILED;
+}
+
+CHIP_ERROR GroupKeyCache::DeriveOperationalKey(const ByteSpan & epochKey, CompressedFabricId compressedFabricId,
+                                               MutableByteSpan & outKey)
+{
+    VerifyOrReturnError(epochKey.size() == kKeyLength, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(outKey.size() >= kKeyLength, CHIP_ERROR_BUFFER_TOO_SMALL);
+
+    uint8_t salt[sizeof(CompressedFabricId)];
+    Encoding::BigEndian::Put64(salt, compressedFabricId);
+
+    HKDF_sha hkdf;
+    ReturnErrorOnFailure(hkdf.HKDF_SHA256(epochKey.data(), epochKey.size(), salt, sizeof(salt), kGroupKeyInfo,
+                                          sizeof(kGroupKeyInfo), outKey.data(), kKeyLength));
+    outKey.reduce_size(kKeyLength);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR GroupKeyCache::DeriveGroupSessionId(const ByteSpan & operationalKey, uint16_t & outSessionId)
+{
+    VerifyOrReturnError(operationalKey.size() == kKeyLength, CHIP_ERROR_INVALID_ARGUMENT);
+
+    uint8_t hash[sizeof(uint16_t)];
+    HKDF_sha hkdf;
+    ReturnErrorOnFailure(hkdf.HKDF_SHA256(operationalKey.data(), operationalKey.size(), nullptr, 0, kGroupKeyHashInfo,
+                                          sizeof(kGroupKeyHashInfo), hash, sizeof(hash)));
+    outSessionId = Encoding::BigEndian::Get16(hash);
+    return CHIP_NO_ERROR;
+}
+
+GroupKeyCache::FabricState * GroupKeyCache::FindFabric(FabricIndex fabric)
+{
+    for (auto & state : mFabrics)
+    {
+        if (state.fabric == fabric)
+        {
+            return &state;
+        }
+    }
+    return nullptr;
+}
+
+void GroupKeyCache::RemoveEntries(FabricIndex fabric)
+{
+    size_t kept = 0;
+    for (size_t i = 0; i < mEntryCount; i++)
+    {
+        if (mEntries[i].fabric == fabric)
+        {
+            continue;
+        }
+        if (kept != i)
+        {
+            mEntries[kept] = mEntries[i];
+        }
+        kept++;
+    }
+    for (size_t i = kept; i < mEntryCount; i++)
+    {
+        ClearSecretData(mEntries[i].key, sizeof(mEntries[i].key));
+    }
+    mEntryCount = kept;
+}
+
+void GroupKeyCache::RefreshStaleFabrics()
+{
+    VerifyOrReturn(mHasStaleFabrics);
+    mHasStaleFabrics = false;
+
+    for (auto & state : mFabrics)
+    {
+        if (state.fabric == kUndefinedFabricIndex || !state.stale)
+        {
+            continue;
+        }
+
+        RemoveEntries(state.fabric);
+        state.stale    = false;
+        CHIP_ERROR err = LoadFabric(state);
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(SecureChannel, "Failed to load group keys for fabric %u: %" CHIP_ERROR_FORMAT,
+                         static_cast<unsigned>(state.fabric), err.Format());
+        }
+    }
+}
+
+CHIP_ERROR GroupKeyCache::LoadFabric(const FabricState & state)
+{
+    VerifyOrReturnError(mProvider != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    GroupDataProvider::GroupKeyIterator * iterator = mProvider->IterateGroupKeys(state.fabric);
+    VerifyOrReturnError(iterator != nullptr, CHIP_ERROR_NO_MEMORY);
+
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    GroupDataProvider::GroupKey mapping;
+    GroupDataProvider::KeySet keyset;
+    while (err == CHIP_NO_ERROR && iterator->Next(mapping))
+    {
+        if (mProvider->GetKeySet(state.fabric, mapping.keyset_id, keyset) != CHIP_NO_ERROR)
+        {
+            // Mappings may reference key sets that have not been written yet.
+            continue;
+        }
+
+        for (size_t i = 0; i < keyset.num_keys_used && i < ArraySize(keyset.epoch_keys) && err == CHIP_NO_ERROR; i++)
+        {
+            uint8_t key[kKeyLength];
+            MutableByteSpan keySpan(key);
+            uint16_t sessionId = 0;
+
+            err = DeriveOperationalKey(ByteSpan(keyset.epoch_keys[i].key), state.compressedFabricId, keySpan);
+            if (err == CHIP_NO_ERROR)
+            {
+                err = DeriveGroupSessionId(keySpan, sessionId);
+            }
+            if (err == CHIP_NO_ERROR)
+            {
+                err = AddEntry(state.fabric, mapping.group_id, key, sessionId);
+            }
+            ClearSecretData(key, sizeof(key));
+        }
+    }
+    iterator->Release();
+
+    ClearSecretData(reinterpret_cast<uint8_t *>(keyset.epoch_keys), sizeof(keyset.epoch_keys));
+    return err;
+}
+
+size_t GroupKeyCache::LowerBound(uint16_t sessionId) const
+{
+    size_t low  = 0;
+    size_t high = mEntryCount;
+    while (low < high)
+    {
+        size_t mid = low + (high - low) / 2;
+        if (mEntries[mid].sessionId < sessionId)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+CHIP_ERROR GroupKeyCache::AddEntry(FabricIndex fabric, GroupId group, const uint8_t * key, uint16_t sessionId)
+{
+    VerifyOrReturnError(mEntryCount < kMaxEntries, CHIP_ERROR_NO_MEMORY);
+
+    // Keep entries sorted by session id so candidates are contiguous.
+    size_t position = LowerBound(sessionId);
+    memmove(&mEntries[position + 1], &mEntries[position], (mEntryCount - position) * sizeof(Entry));
+
+    Entry & entry   = mEntries[position];
+    entry.groupId   = group;
+    entry.sessionId = sessionId;
+    entry.fabric    = fabric;
+    memcpy(entry.key, key, sizeof(entry.key));
+    mEntryCount++;
+    return CHIP_NO_ERROR;
+}
+
+} // namespace Transport
+} // namespace chip
@@ -0,0 +1,153 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines an in-RAM cache of operational group keys, indexed
+ *      by group session id, used to decrypt incoming group messages.
+ *
+ */
+
+#pragma once
+
+#include <credentials/FabricTable.h>
+#include <credentials/GroupDataProvider.h>
+#include <crypto/CHIPCryptoPAL.h>
+#include <lib/core/CHIPError.h>
+#include <lib/core/DataModelTypes.h>
+#include <lib/core/NodeId.h>
+#include <lib/core/PeerId.h>
+#include <lib/support/Span.h>
+#include <system/SystemPacketBuffer.h>
+#include <transport/raw/MessageHeader.h>
+
+namespace chip {
+namespace Transport {
+
+/**
+ * Keeps the operational group keys of every fabric, derived from the epoch keys
+ * held by a GroupDataProvider, sorted by group session id.
+ *
+ * The storage-backed GroupDataProvider walks linked lists in persistent storage
+ * for every lookup, and would also need to re-derive keys, which is far too slow
+ * to do per received packet. This cache derives the keys once, and lets the
+ * receive path try only the keys whose group session id and group id match the
+ * incoming message.
+ *
+ * The cache registers itself as the provider's GroupListener, forwarding every
+ * callback to the listener it replaced, and rebuilds a fabric's entries lazily,
+ * on the next lookup after that fabric's key sets or group-key mappings change.
+ */
+class GroupKeyCache : public Credentials::GroupDataProvider::GroupListener
+{
+public:
+    static constexpr size_t kKeyLength = Crypto::CHIP_CRYPTO_SYMMETRIC_KEY_LENGTH_BYTES;
+
+    GroupKeyCache() = default;
+    ~GroupKeyCache() override { Shutdown(); }
+
+    GroupKeyCache(const GroupKeyCache &) = delete;
+    GroupKeyCache & operator=(const GroupKeyCache &) = delete;
+
+    CHIP_ERROR Init(Credentials::GroupDataProvider * provider);
+    void Shutdown();
+
+    /**
+     * Register a fabric, or update its compressed fabric id. The fabric's keys
+     * are (re)derived on the next lookup.
+     */
+    CHIP_ERROR SetFabric(FabricIndex fabric, CompressedFabricId compressedFabricId);
+
+    /**
+     * Unregister a fabric and drop all of its keys.
+     */
+    void RemoveFabric(FabricIndex fabric);
+
+    /**
+     * Register every initialized fabric of a fabric table, e.g. once it has been loaded from storage.
+     */
+    CHIP_ERROR SetFabrics(const FabricTable & fabrics);
+
+    /**
+     * Mark the keys of a fabric as stale so they are re-derived on the next lookup.
+     */
+    void Invalidate(FabricIndex fabric);
+
+    /**
+     * Trial-decrypt a group message in place, using only the cached keys whose group
+     * session id and group id match the packet header.
+     *
+     * On success, the MIC is stripped from msg and outFabric is set to the fabric
+     * whose key authenticated the message.
+     *
+     * @retval CHIP_ERROR_KEY_NOT_FOUND if no candidate key exists for the message.
+     * @retval CHIP_ERROR_INTEGRITY_CHECK_FAILED if no candidate key authenticated the message.
+     */
+    CHIP_ERROR DecryptMessage(const PacketHeader & packetHeader, System::PacketBufferHandle & msg, FabricIndex & outFabric);
+
+    /**
+     * Number of (fabric, group, epoch key) entries currently cached.
+     */
+    size_t GetEntryCount();
+
+    // Operational group key derivation (spec 4.15.2).
+    static CHIP_ERROR DeriveOperationalKey(const ByteSpan & epochKey, CompressedFabricId compressedFabricId,
+                                           MutableByteSpan & outKey);
+    static CHIP_ERROR DeriveGroupSessionId(const ByteSpan & operationalKey, uint16_t & outSessionId);
+
+    // GroupDataProvider::GroupListener
+    void OnGroupAdded(FabricIndex fabric_index, const Credentials::GroupDataProvider::GroupInfo & new_group) override;
+    void OnGroupRemoved(FabricIndex fabric_index, const Credentials::GroupDataProvider::GroupInfo & old_group) override;
+    void OnGroupKeysChanged(FabricIndex fabric_index) override;
+
+private:
+    struct Entry
+    {
+        uint8_t key[kKeyLength];
+        GroupId groupId;
+        uint16_t sessionId;
+        FabricIndex fabric;
+    };
+
+    struct FabricState
+    {
+        CompressedFabricId compressedFabricId = 0;
+        FabricIndex fabric                    = kUndefinedFabricIndex;
+        bool stale                            = false;
+    };
+
+    static constexpr size_t kMaxEntries = CHIP_CONFIG_GROUP_KEY_CACHE_SIZE;
+    static constexpr size_t kMaxFabrics = CHIP_CONFIG_MAX_DEVICE_ADMINS;
+
+    FabricState * FindFabric(FabricIndex fabric);
+    void RemoveEntries(FabricIndex fabric);
+    CHIP_ERROR LoadFabric(const FabricState & state);
+    void RefreshStaleFabrics();
+    size_t LowerBound(uint16_t sessionId) const;
+    CHIP_ERROR AddEntry(FabricIndex fabric, GroupId group, const uint8_t * key, uint16_t sessionId);
+
+    Credentials::GroupDataProvider * mProvider                    = nullptr;
+    Credentials::GroupDataProvider::GroupListener * mNextListener = nullptr;
+    FabricState mFabrics[kMaxFabrics];
+    Entry mEntries[kMaxEntries];
+    size_t mEntryCount    = 0;
+    bool mHasStaleFabrics = false;
+};
+
+} // namespace Transport
+} // namespace chip
@@ -0,0 +1,126 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines the table of message counters kept for the
+ *      senders of group messages.
+ *
+ */
+#pragma once
+
+#include <lib/core/CHIPError.h>
+#include <lib/core/DataModelTypes.h>
+#include <lib/core/NodeId.h>
+#include <transport/PeerMessageCounter.h>
+
+namespace chip {
+namespace Transport {
+
+/**
+ * Tracks the group data message counter of each (fabric, source node) pair
+ * that sent us a group message (spec 4.5.1.2 / 4.7.3).
+ *
+ * Group senders are not known in advance, so the first message from a peer is
+ * trusted and establishes its counter. When the table is full the least
+ * recently used peer is evicted.
+ */
+template <size_t kMaxPeerCount>
+class GroupPeerMessageCounterTable
+{
+public:
+    /**
+     * Verify the counter of a decrypted group message.
+     *
+     * @retval CHIP_NO_ERROR                          the message is new; call Commit() once it is accepted.
+     * @retval CHIP_ERROR_DUPLICATE_MESSAGE_RECEIVED  the message was already received.
+     * @retval CHIP_ERROR_MESSAGE_COUNTER_OUT_OF_WINDOW the counter is too far behind to be verified.
+     */
+    CHIP_ERROR Verify(FabricIndex fabric, NodeId sourceNodeId, uint32_t counter)
+    {
+        return FindOrAllocate(fabric, sourceNodeId).counter.VerifyOrTrustFirstGroup(counter);
+    }
+
+    /**
+     * Record a message counter previously accepted by Verify().
+     */
+    void Commit(FabricIndex fabric, NodeId sourceNodeId, uint32_t counter)
+    {
+        FindOrAllocate(fabric, sourceNodeId).counter.Commit(counter);
+    }
+
+    /**
+     * Forget all counters for a fabric, e.g. when the fabric is removed.
+     */
+    void RemoveFabric(FabricIndex fabric)
+    {
+        for (auto & entry : mEntries)
+        {
+            if (entry.fabric == fabric)
+            {
+                entry.counter.Reset();
+                entry.fabric = kUndefinedFabricIndex;
+            }
+        }
+    }
+
+private:
+    struct Entry
+    {
+        PeerMessageCounter counter;
+        NodeId nodeId      = kUndefinedNodeId;
+        uint32_t lastUsed  = 0;
+        FabricIndex fabric = kUndefinedFabricIndex;
+    };
+
+    Entry & FindOrAllocate(FabricIndex fabric, NodeId nodeId)
+    {
+        Entry * victim = &mEntries[0];
+        for (auto & entry : mEntries)
+        {
+            if (entry.fabric == fabric && entry.nodeId == nodeId)
+            {
+                entry.lastUsed = ++mUseCounter;
+                return entry;
+            }
+            if (entry.fabric == kUndefinedFabricIndex)
+            {
+                if (victim->fabric != kUndefinedFabricIndex)
+                {
+                    victim = &entry;
+                }
+            }
+            else if (victim->fabric != kUndefinedFabricIndex && entry.lastUsed < victim->lastUsed)
+            {
+                victim = &entry;
+            }
+        }
+
+        victim->counter.Reset();
+        victim->fabric   = fabric;
+        victim->nodeId   = nodeId;
+        victim->lastUsed = ++mUseCounter;
+        return *victim;
+    }
+
+    Entry mEntries[kMaxPeerCount];
+    uint32_t mUseCounter = 0;
+};
+
+} // namespace Transport
+} // namespace chip
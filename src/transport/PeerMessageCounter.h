@@ -135,6 +135,21 @@ public:
         }
     }
 
+    /**
+     * @brief
+     *    Verify the counter of a group message. The first counter received from a group peer is trusted, but unlike
+     *    VerifyOrTrustFirst() counters that fall behind the window are rejected rather than trusted (spec 4.5.1.2).
+     */
+    CHIP_ERROR VerifyOrTrustFirstGroup(uint32_t counter)
+    {
+        if (mStatus == Status::NotSynced)
+        {
+            SetCounter(counter);
+            return CHIP_NO_ERROR;
+        }
+        return Verify(counter);
+    }
+
     /**
      * @brief
      *    With the counter verified and the packet MIC also verified by the secure key, we can trust the packet and adjust
@@ -51,14 +51,19 @@ CHIP_ERROR Encrypt(Transport::SecureSession * session, PayloadHeader & payloadHe
     uint8_t * data    = msgBuf->Start();
     uint16_t totalLen = msgBuf->TotalLength();
 
+    // Encode the packet header ahead of the payload first, so that the bytes being sent are
+    // authenticated as they are, without encoding the header again into a separate buffer.
+    ReturnErrorOnFailure(packetHeader.EncodeBeforeData(msgBuf));
+    const ByteSpan aad(msgBuf->Start(), static_cast<size_t>(data - msgBuf->Start()));
+
     MessageAuthenticationCode mac;
-    ReturnErrorOnFailure(session->EncryptBeforeSend(data, totalLen, data, packetHeader, mac));
+    ReturnErrorOnFailure(session->EncryptBeforeSend(data, totalLen, data, packetHeader, aad, mac));
 
     uint16_t taglen = 0;
     ReturnErrorOnFailure(mac.Encode(packetHeader, &data[totalLen], msgBuf->AvailableDataLength(), &taglen));
 
-    VerifyOrReturnError(CanCastTo<uint16_t>(totalLen + taglen), CHIP_ERROR_INTERNAL);
-    msgBuf->SetDataLength(static_cast<uint16_t>(totalLen + taglen));
+    VerifyOrReturnError(CanCastTo<uint16_t>(aad.size() + totalLen + taglen), CHIP_ERROR_INTERNAL);
+    msgBuf->SetDataLength(static_cast<uint16_t>(aad.size() + totalLen + taglen));
 
     return CHIP_NO_ERROR;
 }
@@ -71,6 +76,11 @@ CHIP_ERROR Decrypt(Transport::SecureSession * session, PayloadHeader & payloadHe
     uint8_t * data = msg->Start();
     uint16_t len   = msg->DataLength();
 
+    // The packet header that was consumed from the message is still in front of it.
+    const uint16_t headerLen = packetHeader.EncodeSizeBytes();
+    VerifyOrReturnError(msg->ReservedSize() >= headerLen, CHIP_ERROR_INVALID_ARGUMENT);
+    const ByteSpan aad(data - headerLen, headerLen);
+
     PacketBufferHandle origMsg;
 #if CHIP_SYSTEM_CONFIG_USE_LWIP
     /* This is a workaround for the case where PacketBuffer payload is not
@@ -93,7 +103,7 @@ CHIP_ERROR Decrypt(Transport::SecureSession * session, PayloadHeader & payloadHe
     msg->SetDataLength(len);
 
     uint8_t * plainText = msg->Start();
-    ReturnErrorOnFailure(session->DecryptOnReceive(data, len, plainText, packetHeader, mac));
+    ReturnErrorOnFailure(session->DecryptOnReceive(data, len, plainText, packetHeader, aad, mac));
 
     ReturnErrorOnFailure(payloadHeader.DecodeAndConsume(msg));
     return CHIP_NO_ERROR;
@@ -35,8 +35,9 @@ namespace SecureMessageCodec {
 
 /**
  * @brief
- *  Attach payload header to the message and encrypt the message buffer using
- *  key from the secure session.
+ *  Attach payload and packet headers to the message and encrypt the message buffer
+ *  in place using key from the secure session. The packet header is authenticated
+ *  as encoded in the buffer.
  *
  * @param session       The secure session context with the peer node
  * @param payloadHeader Reference to the payload header that should be inserted in
@@ -45,7 +46,7 @@ namespace SecureMessageCodec {
  *                      portion of the message header
  * @param msgBuf        The message buffer that contains the unencrypted message. If
  *                      the operation is successful, this buffer will be mutated to contain
- *                      the encrypted message.
+ *                      the encoded packet header followed by the encrypted message.
  * @return A CHIP_ERROR value consistent with the result of the encryption operation
  */
 CHIP_ERROR Encrypt(Transport::SecureSession * session, PayloadHeader & payloadHeader, PacketHeader & packetHeader,
@@ -53,8 +54,11 @@ CHIP_ERROR Encrypt(Transport::SecureSession * session, PayloadHeader & payloadHe
 
 /**
  * @brief
- *  Decrypt the message, perform message integrity check, and decode the payload header,
- *  consuming the header from the packet in doing so.
+ *  Decrypt the message in place, perform message integrity check, and decode the payload
+ *  header, consuming the header from the packet in doing so.
+ *
+ *  The packet header is authenticated as it was received, so the message buffer must
+ *  start right after the encoded packet header, as PacketHeader::DecodeAndConsume leaves it.
  *
  * @param session       The secure session context with the peer node
  * @param payloadHeader Reference to the payload header that will be recovered from the message
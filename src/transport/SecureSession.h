@@ -137,15 +137,15 @@ public:
     CryptoContext & GetCryptoContext() { return mCryptoContext; }
 
     CHIP_ERROR EncryptBeforeSend(const uint8_t * input, size_t input_length, uint8_t * output, PacketHeader & header,
-                                 MessageAuthenticationCode & mac) const
+                                 const ByteSpan & aad, MessageAuthenticationCode & mac)
     {
-        return mCryptoContext.Encrypt(input, input_length, output, header, mac);
+        return mCryptoContext.Encrypt(input, input_length, output, header, aad, mac);
     }
 
     CHIP_ERROR DecryptOnReceive(const uint8_t * input, size_t input_length, uint8_t * output, const PacketHeader & header,
-                                const MessageAuthenticationCode & mac) const
+                                const ByteSpan & aad, const MessageAuthenticationCode & mac)
     {
-        return mCryptoContext.Decrypt(input, input_length, output, header, mac);
+        return mCryptoContext.Decrypt(input, input_length, output, header, aad, mac);
     }
 
     SessionMessageCounter & GetSessionMessageCounter() { return mSessionMessageCounter; }
@@ -19,6 +19,7 @@
 #include <lib/core/CHIPError.h>
 #include <lib/support/CodeUtils.h>
 #include <lib/support/Pool.h>
+#include <protocols/secure_channel/SessionIDAllocator.h>
 #include <system/TimeSource.h>
 #include <transport/SecureSession.h>
 
@@ -36,6 +37,9 @@ constexpr const uint16_t kAnyKeyId = 0xffff;
  * Intended for:
  *   - handle session active time and expiration
  *   - allocate and free space for sessions.
+ *
+ * Sessions are indexed by local session ID in an open-addressed hash table, so that the session of an incoming message is
+ * found without scanning the whole pool.
  */
 template <size_t kMaxSessionCount>
 class SecureSessionTable
@@ -43,6 +47,12 @@ class SecureSessionTable
 public:
     ~SecureSessionTable() { mEntries.ReleaseAll(); }
 
+    /**
+     * Set the allocator the local session IDs of the sessions come from. A session holds its local session ID for as long
+     * as it is in the table, and gives it back to the allocator once it is released or expires.
+     */
+    void SetSessionIDAllocator(SessionIDAllocator * idAllocator) { mIDAllocator = idAllocator; }
+
     /**
      * Allocates a new secure session out of the internal resource pool.
      *
@@ -64,12 +74,35 @@ public:
                                                    NodeId peerNodeId, CATValues peerCATs, uint16_t peerSessionId,
                                                    FabricIndex fabric, const ReliableMessageProtocolConfig & config)
     {
+        // The session may take over the ID of one that was just released, which gave it back to the allocator.
+        if (mIDAllocator != nullptr && mIDAllocator->Reserve(localSessionId) != CHIP_NO_ERROR)
+        {
+            return Optional<SessionHandle>::Missing();
+        }
+
         SecureSession * result =
             mEntries.CreateObject(secureSessionType, localSessionId, peerNodeId, peerCATs, peerSessionId, fabric, config);
-        return result != nullptr ? MakeOptional<SessionHandle>(*result) : Optional<SessionHandle>::Missing();
+        if (result == nullptr)
+        {
+            return Optional<SessionHandle>::Missing();
+        }
+
+        AddToIndex(result);
+        return MakeOptional<SessionHandle>(*result);
     }
 
-    void ReleaseSession(SecureSession * session) { mEntries.ReleaseObject(session); }
+    void ReleaseSession(SecureSession * session)
+    {
+        const uint16_t localSessionId = session->GetLocalSessionId();
+
+        // Free the ID only once the session can no longer be found by it.
+        RemoveFromIndex(session);
+        mEntries.ReleaseObject(session);
+        if (mIDAllocator != nullptr)
+        {
+            mIDAllocator->Free(localSessionId);
+        }
+    }
 
     template <typename Function>
     Loop ForEachSession(Function && function)
@@ -87,16 +120,14 @@ public:
     CHECK_RETURN_VALUE
     Optional<SessionHandle> FindSecureSessionByLocalKey(uint16_t localSessionId)
     {
-        SecureSession * result = nullptr;
-        mEntries.ForEachActiveObject([&](auto session) {
-            if (session->GetLocalSessionId() == localSessionId)
+        for (size_t slot = IndexSlot(localSessionId); mIndex[slot].session != nullptr; slot = NextIndexSlot(slot))
+        {
+            if (mIndex[slot].localSessionId == localSessionId)
             {
-                result = session;
-                return Loop::Break;
+                return MakeOptional<SessionHandle>(*mIndex[slot].session);
             }
-            return Loop::Continue;
-        });
-        return result != nullptr ? MakeOptional<SessionHandle>(*result) : Optional<SessionHandle>::Missing();
+        }
+        return Optional<SessionHandle>::Missing();
     }
 
     /**
@@ -119,7 +150,65 @@ public:
     }
 
 private:
+    struct IndexEntry
+    {
+        SecureSession * session = nullptr;
+        uint16_t localSessionId = 0;
+    };
+
+    static constexpr size_t IndexSizeFor(size_t sessionCount)
+    {
+        return sessionCount <= 1 ? 2 : 2 * IndexSizeFor((sessionCount + 1) / 2);
+    }
+
+    // The index has at least twice as many slots as the pool, so that probe sequences stay short and always end on an empty slot.
+    // Local session IDs are handed out sequentially, which spreads them evenly over the slots given by their low bits.
+    static constexpr size_t kIndexSize = IndexSizeFor(kMaxSessionCount);
+    static_assert((kIndexSize & (kIndexSize - 1)) == 0 && kIndexSize >= 2 * kMaxSessionCount, "Invalid session index size");
+
+    static size_t IndexSlot(uint16_t localSessionId) { return localSessionId & (kIndexSize - 1); }
+    static size_t NextIndexSlot(size_t slot) { return (slot + 1) & (kIndexSize - 1); }
+
+    void AddToIndex(SecureSession * session)
+    {
+        const uint16_t localSessionId = session->GetLocalSessionId();
+        size_t slot                   = IndexSlot(localSessionId);
+
+        // A session reusing the local session ID of another one replaces it in the index.
+        while (mIndex[slot].session != nullptr && mIndex[slot].localSessionId != localSessionId)
+        {
+            slot = NextIndexSlot(slot);
+        }
+        mIndex[slot].session        = session;
+        mIndex[slot].localSessionId = localSessionId;
+    }
+
+    void RemoveFromIndex(SecureSession * session)
+    {
+        size_t slot = IndexSlot(session->GetLocalSessionId());
+
+        while (mIndex[slot].session != session)
+        {
+            VerifyOrReturn(mIndex[slot].session != nullptr);
+            slot = NextIndexSlot(slot);
+        }
+
+        // Move back the entries of the probe sequence that follows, so that it does not break at the freed slot.
+        for (size_t next = NextIndexSlot(slot); mIndex[next].session != nullptr; next = NextIndexSlot(next))
+        {
+            const size_t home = IndexSlot(mIndex[next].localSessionId);
+            if (((next - home) & (kIndexSize - 1)) >= ((next - slot) & (kIndexSize - 1)))
+            {
+                mIndex[slot] = mIndex[next];
+                slot         = next;
+            }
+        }
+        mIndex[slot] = IndexEntry();
+    }
+
     BitMapObjectPool<SecureSession, kMaxSessionCount> mEntries;
+    IndexEntry mIndex[kIndexSize];
+    SessionIDAllocator * mIDAllocator = nullptr;
 };
 
 } // namespace Transport
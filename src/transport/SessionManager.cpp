@@ -38,6 +38,7 @@
 #include <lib/support/logging/CHIPLogging.h>
 #include <platform/CHIPDeviceLayer.h>
 #include <protocols/secure_channel/Constants.h>
+#include <trace/trace.h>
 #include <transport/GroupSession.h>
 #include <transport/PairingSession.h>
 #include <transport/SecureMessageCodec.h>
@@ -110,6 +111,7 @@ void SessionManager::Shutdown()
 CHIP_ERROR SessionManager::PrepareMessage(const SessionHandle & sessionHandle, PayloadHeader & payloadHeader,
                                           System::PacketBufferHandle && message, EncryptedPacketBufferHandle & preparedMessage)
 {
+    TRACE_EVENT_SCOPE("PrepareMessage", "SessionManager");
     PacketHeader packetHeader;
     if (IsControlMessage(payloadHeader))
     {
@@ -142,6 +144,7 @@ CHIP_ERROR SessionManager::PrepareMessage(const SessionHandle & sessionHandle, P
 
         // TODO #11911 Update SecureMessageCodec::Encrypt for Group
         ReturnErrorOnFailure(payloadHeader.EncodeBeforeData(message));
+        ReturnErrorOnFailure(packetHeader.EncodeBeforeData(message));
 
 #if CHIP_PROGRESS_LOGGING
         destination = kUndefinedNodeId;
@@ -166,6 +169,7 @@ CHIP_ERROR SessionManager::PrepareMessage(const SessionHandle & sessionHandle, P
         // Trace before any encryption
         CHIP_TRACE_MESSAGE_SENT(payloadHeader, packetHeader, message->Start(), message->TotalLength());
 
+        // Also encodes the packet header, which is authenticated as encoded.
         ReturnErrorOnFailure(SecureMessageCodec::Encrypt(session, payloadHeader, packetHeader, message));
         ReturnErrorOnFailure(counter.Advance());
 
@@ -185,6 +189,7 @@ CHIP_ERROR SessionManager::PrepareMessage(const SessionHandle & sessionHandle, P
         CHIP_TRACE_MESSAGE_SENT(payloadHeader, packetHeader, message->Start(), message->TotalLength());
 
         ReturnErrorOnFailure(payloadHeader.EncodeBeforeData(message));
+        ReturnErrorOnFailure(packetHeader.EncodeBeforeData(message));
 
 #if CHIP_PROGRESS_LOGGING
         destination = kUndefinedNodeId;
@@ -204,7 +209,6 @@ CHIP_ERROR SessionManager::PrepareMessage(const SessionHandle & sessionHandle, P
                     payloadHeader.GetMessageType(), ChipLogValueProtocolId(payloadHeader.GetProtocolID()),
                     ChipLogValueExchangeIdFromSentHeader(payloadHeader), packetHeader.GetMessageCounter());
 
-    ReturnErrorOnFailure(packetHeader.EncodeBeforeData(message));
     preparedMessage = EncryptedPacketBufferHandle::MarkEncrypted(std::move(message));
 
     return CHIP_NO_ERROR;
@@ -311,6 +315,7 @@ void SessionManager::ExpireAllPairingsForFabric(FabricIndex fabric)
         }
         return Loop::Continue;
     });
+    mGroupPeerMessageCounters.RemoveFabric(fabric);
 }
 
 CHIP_ERROR SessionManager::NewPairing(SessionHolder & sessionHolder, const Optional<Transport::PeerAddress> & peerAddr,
@@ -475,6 +480,7 @@ void SessionManager::MessageDispatch(const PacketHeader & packetHeader, const Tr
 void SessionManager::SecureUnicastMessageDispatch(const PacketHeader & packetHeader, const Transport::PeerAddress & peerAddress,
                                                   System::PacketBufferHandle && msg)
 {
+    TRACE_EVENT_SCOPE("SecureUnicastMessageDispatch", "SessionManager");
     CHIP_ERROR err = CHIP_NO_ERROR;
 
     Optional<SessionHandle> session = mSecureSessions.FindSecureSessionByLocalKey(packetHeader.GetSessionId());
@@ -553,7 +559,7 @@ void SessionManager::SecureGroupMessageDispatch(const PacketHeader & packetHeade
 {
     PayloadHeader payloadHeader;
     SessionMessageDelegate::DuplicateMessage isDuplicate = SessionMessageDelegate::DuplicateMessage::No;
-    // Credentials::GroupDataProvider * groups = Credentials::GetGroupDataProvider();
+    FabricIndex fabricIndex                              = kUndefinedFabricIndex;
 
     if (!packetHeader.GetDestinationGroupId().HasValue())
     {
@@ -573,10 +579,17 @@ void SessionManager::SecureGroupMessageDispatch(const PacketHeader & packetHeade
         return;
     }
 
-    // Trial decryption with GroupDataProvider. TODO: Implement the GroupDataProvider Class
-    // TODO retrieve also the fabricIndex with the GroupDataProvider.
-    // VerifyOrExit(CHIP_NO_ERROR == groups->DecryptMessage(packetHeader, payloadHeader, msg),
-    //     ChipLogError(Inet, "Secure transport received group message, but failed to decode it, discarding"));
+    // Trial decryption, restricted to the cached operational group keys matching the group session id.
+    if (mGroupKeyCache != nullptr)
+    {
+        CHIP_ERROR err = mGroupKeyCache->DecryptMessage(packetHeader, msg, fabricIndex);
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(Inet, "Secure transport received group message, but failed to decode it, discarding: %" CHIP_ERROR_FORMAT,
+                         err.Format());
+            return;
+        }
+    }
 
     ReturnOnFailure(payloadHeader.DecodeAndConsume(msg));
 
@@ -599,8 +612,22 @@ void SessionManager::SecureGroupMessageDispatch(const PacketHeader & packetHeade
         return;
     }
 
-    // TODO: Handle Group message counter here spec 4.7.3
-    // spec 4.5.1.2 for msg counter
+    // Group message counter check, spec 4.7.3 and 4.5.1.2. Only authenticated group messages
+    // carry a meaningful counter.
+    const NodeId sourceNodeId = packetHeader.GetSourceNodeId().Value();
+    if (mGroupKeyCache != nullptr)
+    {
+        CHIP_ERROR err = mGroupPeerMessageCounters.Verify(fabricIndex, sourceNodeId, packetHeader.GetMessageCounter());
+        if (err == CHIP_ERROR_DUPLICATE_MESSAGE_RECEIVED)
+        {
+            isDuplicate = SessionMessageDelegate::DuplicateMessage::Yes;
+        }
+        else if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(Inet, "Message counter verify failed, err = %" CHIP_ERROR_FORMAT, err.Format());
+            return;
+        }
+    }
 
     if (isDuplicate == SessionMessageDelegate::DuplicateMessage::Yes)
     {
@@ -613,11 +640,14 @@ void SessionManager::SecureGroupMessageDispatch(const PacketHeader & packetHeade
         return;
     }
 
-    // TODO: Commit Group Message Counter
+    if (mGroupKeyCache != nullptr)
+    {
+        mGroupPeerMessageCounters.Commit(fabricIndex, sourceNodeId, packetHeader.GetMessageCounter());
+    }
 
     if (mCB != nullptr)
     {
-        Optional<SessionHandle> session = CreateGroupSession(packetHeader.GetDestinationGroupId().Value());
+        Optional<SessionHandle> session = CreateGroupSession(packetHeader.GetDestinationGroupId().Value(), fabricIndex);
         VerifyOrReturn(session.HasValue(), ChipLogError(Inet, "Error when creating group session handle."));
         Transport::GroupSession * groupSession = session.Value()->AsGroupSession();
 
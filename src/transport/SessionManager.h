@@ -34,6 +34,8 @@
 #include <messaging/ReliableMessageProtocolConfig.h>
 #include <protocols/secure_channel/Constants.h>
 #include <transport/CryptoContext.h>
+#include <transport/GroupKeyCache.h>
+#include <transport/GroupPeerMessageCounter.h>
 #include <transport/GroupSession.h>
 #include <transport/MessageCounterManagerInterface.h>
 #include <transport/SecureSessionTable.h>
@@ -211,6 +213,10 @@ public:
 
     // TODO: implements group sessions
     Optional<SessionHandle> CreateGroupSession(GroupId group) { return mGroupSessions.AllocEntry(group, kUndefinedFabricIndex); }
+    Optional<SessionHandle> CreateGroupSession(GroupId group, FabricIndex fabric)
+    {
+        return mGroupSessions.AllocEntry(group, fabric);
+    }
     Optional<SessionHandle> FindGroupSession(GroupId group) { return mGroupSessions.FindEntry(group, kUndefinedFabricIndex); }
     void RemoveGroupSession(Transport::GroupSession * session) { mGroupSessions.DeleteEntry(session); }
 
@@ -218,6 +224,24 @@ public:
     // and tv-casting-app that uses the TV's node ID to find the associated secure session
     SessionHandle FindSecureSessionForNode(NodeId peerNodeId);
 
+    /**
+     * @brief
+     *   Set the cache of operational group keys used to authenticate and decrypt incoming
+     *   group messages. Once set, group messages that cannot be decrypted with one of its
+     *   keys, or that fail the group message counter check, are dropped.
+     *
+     *   Without a cache, group messages are delivered as received (group message
+     *   encryption is not yet wired on the sending side, see #11911).
+     */
+    void SetGroupKeyCache(Transport::GroupKeyCache * groupKeyCache) { mGroupKeyCache = groupKeyCache; }
+
+    /**
+     * @brief
+     *   Set the allocator the local session IDs of secure sessions come from. The ID of a secure
+     *   session is given back to it when the session is expired.
+     */
+    void SetSessionIDAllocator(SessionIDAllocator * idAllocator) { mSecureSessions.SetSessionIDAllocator(idAllocator); }
+
     using SessionHandleCallback = bool (*)(void * context, SessionHandle & sessionHandle);
     CHIP_ERROR ForEachSessionHandle(void * context, SessionHandleCallback callback);
 
@@ -241,6 +265,8 @@ private:
     Transport::UnauthenticatedSessionTable<CHIP_CONFIG_UNAUTHENTICATED_CONNECTION_POOL_SIZE> mUnauthenticatedSessions;
     Transport::SecureSessionTable<CHIP_CONFIG_PEER_CONNECTION_POOL_SIZE> mSecureSessions;
     Transport::GroupSessionTable<CHIP_CONFIG_GROUP_CONNECTION_POOL_SIZE> mGroupSessions;
+    Transport::GroupPeerMessageCounterTable<CHIP_CONFIG_MAX_GROUP_DATA_PEERS> mGroupPeerMessageCounters;
+    Transport::GroupKeyCache * mGroupKeyCache = nullptr;
     State mState; // < Initialization state of the object
 
     SessionMessageDelegate * mCB = nullptr;
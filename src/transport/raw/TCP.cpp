@@ -78,6 +78,10 @@ CHIP_ERROR TCPBase::Init(TcpListenParameters & params)
     CHIP_ERROR err = CHIP_NO_ERROR;
 
     VerifyOrExit(mState == State::kNotReady, err = CHIP_ERROR_INCORRECT_STATE);
+#if INET_TCP_IDLE_CHECK_INTERVAL <= 0
+    // Endpoints can only close idle connections when they check for idleness.
+    VerifyOrExit(params.GetIdleTimeout() == System::Clock::kZero, err = CHIP_ERROR_UNSUPPORTED_CHIP_FEATURE);
+#endif // INET_TCP_IDLE_CHECK_INTERVAL <= 0
 
 #if INET_CONFIG_ENABLE_TCP_ENDPOINT
     err = params.GetEndPointManager()->NewEndPoint(&mListenSocket);
@@ -100,6 +104,7 @@ CHIP_ERROR TCPBase::Init(TcpListenParameters & params)
     mListenSocket->OnConnectionReceived = OnConnectionReceived;
     mListenSocket->OnAcceptError        = OnAcceptError;
     mEndpointType                       = params.GetAddressType();
+    mIdleTimeout                        = params.GetIdleTimeout();
 
     mState = State::kInitialized;
 
@@ -140,11 +145,9 @@ TCPBase::ActiveConnectionState * TCPBase::FindActiveConnection(const PeerAddress
         {
             continue;
         }
-        Inet::IPAddress addr;
-        uint16_t port;
-        mActiveConnections[i].mEndPoint->GetPeerInfo(&addr, &port);
+        const PeerAddress & peerAddress = mActiveConnections[i].mPeerAddress;
 
-        if ((addr == address.GetIPAddress()) && (port == address.GetPort()))
+        if ((peerAddress.GetIPAddress() == address.GetIPAddress()) && (peerAddress.GetPort() == address.GetPort()))
         {
             return &mActiveConnections[i];
         }
@@ -165,6 +168,56 @@ TCPBase::ActiveConnectionState * TCPBase::FindActiveConnection(const Inet::TCPEn
     return nullptr;
 }
 
+CHIP_ERROR TCPBase::ReserveConnection()
+{
+    if (mUsedEndPointCount < mActiveConnectionsSize)
+    {
+        return CHIP_NO_ERROR;
+    }
+
+    // Connections still being established are not in mActiveConnections, so they are never picked.
+    ActiveConnectionState * leastRecentlyUsed = nullptr;
+    for (size_t i = 0; i < mActiveConnectionsSize; i++)
+    {
+        ActiveConnectionState & connection = mActiveConnections[i];
+        if (connection.IsIdle() && (leastRecentlyUsed == nullptr || connection.mLastActivity < leastRecentlyUsed->mLastActivity))
+        {
+            leastRecentlyUsed = &connection;
+        }
+    }
+    VerifyOrReturnError(leastRecentlyUsed != nullptr, CHIP_ERROR_NO_MEMORY);
+
+    ChipLogProgress(Inet, "Closing least recently used idle connection.");
+    leastRecentlyUsed->Free();
+    mUsedEndPointCount--;
+
+    return CHIP_NO_ERROR;
+}
+
+TCPBase::ActiveConnectionState * TCPBase::StoreConnection(Inet::TCPEndPoint * endPoint, const PeerAddress & peerAddress)
+{
+    for (size_t i = 0; i < mActiveConnectionsSize; i++)
+    {
+        if (!mActiveConnections[i].InUse())
+        {
+            mActiveConnections[i].Init(endPoint, peerAddress);
+
+            // Queued messages are written together with a gather send, so there is nothing to gain from Nagle's algorithm
+            // holding back the last segment of a message until the previous one is acknowledged.
+            LogErrorOnFailure(endPoint->EnableNoDelay());
+#if INET_TCP_IDLE_CHECK_INTERVAL > 0
+            if (mIdleTimeout > System::Clock::kZero)
+            {
+                endPoint->SetIdleTimeout(mIdleTimeout.count());
+            }
+#endif // INET_TCP_IDLE_CHECK_INTERVAL > 0
+            return &mActiveConnections[i];
+        }
+    }
+
+    return nullptr;
+}
+
 CHIP_ERROR TCPBase::SendMessage(const Transport::PeerAddress & address, System::PacketBufferHandle && msgBuf)
 {
     // Sent buffer data format is:
@@ -190,6 +243,7 @@ CHIP_ERROR TCPBase::SendMessage(const Transport::PeerAddress & address, System::
 
     if (connection != nullptr)
     {
+        connection->MarkActive();
         return connection->mEndPoint->Send(std::move(msgBuf));
     }
     else
@@ -224,7 +278,7 @@ CHIP_ERROR TCPBase::SendAfterConnect(const PeerAddress & addr, System::PacketBuf
     }
 
     // Ensures sufficient active connections size exist
-    VerifyOrReturnError(mUsedEndPointCount < mActiveConnectionsSize, CHIP_ERROR_NO_MEMORY);
+    ReturnErrorOnFailure(ReserveConnection());
 
     Inet::TCPEndPoint * endPoint = nullptr;
 #if INET_CONFIG_ENABLE_TCP_ENDPOINT
@@ -262,6 +316,7 @@ CHIP_ERROR TCPBase::ProcessReceivedBuffer(Inet::TCPEndPoint * endPoint, const Pe
     ActiveConnectionState * state = FindActiveConnection(endPoint);
     VerifyOrReturnError(state != nullptr, CHIP_ERROR_INTERNAL);
     state->mReceived.AddToEnd(std::move(buffer));
+    state->MarkActive();
 
     while (!state->mReceived.IsNull())
     {
@@ -301,17 +356,49 @@ CHIP_ERROR TCPBase::ProcessSingleMessage(const PeerAddress & peerAddress, Active
     // `state->mReceived->Start()` currently points to the message data.
     // On exit, `state->mReceived` will have had `messageSize` bytes consumed, no matter what.
     System::PacketBufferHandle message;
-    if (state->mReceived->DataLength() == messageSize)
+    const uint16_t headLength = state->mReceived->DataLength();
+    if (headLength == messageSize)
     {
         // In this case, the head packet buffer contains exactly the message.
         // This is common because typical messages fit in a network packet, and are delivered as such.
         // Peel off the head to pass upstream, which effectively consumes it from `state->mReceived`.
         message = state->mReceived.PopHead();
     }
+    else if (headLength > messageSize && headLength - messageSize <= messageSize)
+    {
+        // The head buffer contains the message followed by the start of the next one(s). The upper layers must not share the
+        // head with us, so copy the smaller side: move the data after the message to a fresh buffer, and pass the head upstream.
+        const uint16_t remainderLength       = static_cast<uint16_t>(headLength - messageSize);
+        System::PacketBufferHandle remainder = System::PacketBufferHandle::New(remainderLength, 0);
+        if (remainder.IsNull())
+        {
+            return CHIP_ERROR_NO_MEMORY;
+        }
+        memcpy(remainder->Start(), state->mReceived->Start() + messageSize, remainderLength);
+        remainder->SetDataLength(remainderLength);
+
+        message = state->mReceived.PopHead();
+        message->SetDataLength(messageSize);
+        if (!state->mReceived.IsNull())
+        {
+            remainder->AddToEnd(std::move(state->mReceived));
+        }
+        state->mReceived = std::move(remainder);
+    }
+    else if (headLength < messageSize && state->mReceived->AvailableDataLength() >= messageSize - headLength)
+    {
+        // The message continues in the following buffer(s), and the rest of it fits after the data of the head buffer.
+        // Append it there and pass the head upstream, so only the continuation is copied.
+        const uint16_t continuationLength = static_cast<uint16_t>(messageSize - headLength);
+        message                           = state->mReceived.PopHead();
+        CHIP_ERROR err                    = state->mReceived->Read(message->Start() + headLength, continuationLength);
+        state->mReceived.Consume(continuationLength);
+        ReturnErrorOnFailure(err);
+        message->SetDataLength(messageSize);
+    }
     else
     {
-        // The message is either longer or shorter than the head buffer.
-        // In either case, copy the message to a fresh linear buffer to pass upstream. We always copy, rather than provide
+        // Otherwise, copy the message to a fresh linear buffer to pass upstream. We always copy, rather than provide
         // a shared reference to the current buffer, in case upper layers manipulate the buffer in ways that would affect
         // our use, e.g. chaining it elsewhere or reusing space beyond the current message.
         message = System::PacketBufferHandle::New(messageSize, 0);
@@ -331,16 +418,12 @@ CHIP_ERROR TCPBase::ProcessSingleMessage(const PeerAddress & peerAddress, Active
 
 CHIP_ERROR TCPBase::OnTcpReceive(Inet::TCPEndPoint * endPoint, System::PacketBufferHandle && buffer)
 {
-    Inet::IPAddress ipAddress;
-    uint16_t port;
-    Inet::InterfaceId interfaceId;
-
-    endPoint->GetPeerInfo(&ipAddress, &port);
-    endPoint->GetInterfaceId(&interfaceId);
-    PeerAddress peerAddress = PeerAddress::TCP(ipAddress, port, interfaceId);
+    TCPBase * tcp                 = reinterpret_cast<TCPBase *>(endPoint->mAppState);
+    ActiveConnectionState * state = tcp->FindActiveConnection(endPoint);
 
-    TCPBase * tcp  = reinterpret_cast<TCPBase *>(endPoint->mAppState);
-    CHIP_ERROR err = tcp->ProcessReceivedBuffer(endPoint, peerAddress, std::move(buffer));
+    // Copy the address of the peer, since the connection may be closed while its messages are processed.
+    PeerAddress peerAddress = (state != nullptr) ? state->mPeerAddress : PeerAddress::Uninitialized();
+    CHIP_ERROR err          = tcp->ProcessReceivedBuffer(endPoint, peerAddress, std::move(buffer));
 
     if (err != CHIP_NO_ERROR)
     {
@@ -402,20 +485,9 @@ void TCPBase::OnConnectionComplete(Inet::TCPEndPoint * endPoint, CHIP_ERROR inet
     }
     else
     {
-        bool connectionStored = false;
-        for (size_t i = 0; i < tcp->mActiveConnectionsSize; i++)
-        {
-            if (!tcp->mActiveConnections[i].InUse())
-            {
-                tcp->mActiveConnections[i].Init(endPoint);
-                connectionStored = true;
-                break;
-            }
-        }
-
         // since we track end points counts, we always expect to store the
         // connection.
-        if (!connectionStored)
+        if (tcp->StoreConnection(endPoint, addr) == nullptr)
         {
             endPoint->Free();
             ChipLogError(Inet, "Internal logic error: insufficient space to store active connection");
@@ -445,17 +517,14 @@ void TCPBase::OnConnectionReceived(Inet::TCPEndPoint * listenEndPoint, Inet::TCP
 {
     TCPBase * tcp = reinterpret_cast<TCPBase *>(listenEndPoint->mAppState);
 
-    if (tcp->mUsedEndPointCount < tcp->mActiveConnectionsSize)
+    // have space to use one more (even if considering pending connections), closing an idle connection if needed
+    if (tcp->ReserveConnection() == CHIP_NO_ERROR)
     {
-        // have space to use one more (even if considering pending connections)
-        for (size_t i = 0; i < tcp->mActiveConnectionsSize; i++)
-        {
-            if (!tcp->mActiveConnections[i].InUse())
-            {
-                tcp->mActiveConnections[i].Init(endPoint);
-                break;
-            }
-        }
+        Inet::InterfaceId interfaceId;
+        endPoint->GetInterfaceId(&interfaceId);
+
+        tcp->StoreConnection(endPoint, PeerAddress::TCP(peerAddress, peerPort, interfaceId));
+        tcp->mUsedEndPointCount++;
 
         endPoint->mAppState            = listenEndPoint->mAppState;
         endPoint->OnDataReceived       = OnTcpReceive;
@@ -482,22 +551,13 @@ void TCPBase::Disconnect(const PeerAddress & address)
     // Closes an existing connection
     for (size_t i = 0; i < mActiveConnectionsSize; i++)
     {
-        if (mActiveConnections[i].InUse())
+        if (mActiveConnections[i].InUse() && (address == mActiveConnections[i].mPeerAddress))
         {
-            Inet::IPAddress ipAddress;
-            uint16_t port;
-            Inet::InterfaceId interfaceId;
-
-            mActiveConnections[i].mEndPoint->GetPeerInfo(&ipAddress, &port);
-            mActiveConnections[i].mEndPoint->GetInterfaceId(&interfaceId);
-            if (address == PeerAddress::TCP(ipAddress, port, interfaceId))
-            {
-                // NOTE: this leaves the socket in TIME_WAIT.
-                // Calling Abort() would clean it since SO_LINGER would be set to 0,
-                // however this seems not to be useful.
-                mActiveConnections[i].Free();
-                mUsedEndPointCount--;
-            }
+            // NOTE: this leaves the socket in TIME_WAIT.
+            // Calling Abort() would clean it since SO_LINGER would be set to 0,
+            // however this seems not to be useful.
+            mActiveConnections[i].Free();
+            mUsedEndPointCount--;
         }
     }
 }
@@ -34,6 +34,7 @@
 #include <lib/core/CHIPCore.h>
 #include <lib/support/CodeUtils.h>
 #include <lib/support/PoolWrapper.h>
+#include <system/SystemClock.h>
 #include <transport/raw/Base.h>
 
 namespace chip {
@@ -73,11 +74,20 @@ public:
         return *this;
     }
 
+    System::Clock::Milliseconds32 GetIdleTimeout() const { return mIdleTimeout; }
+    TcpListenParameters & SetIdleTimeout(System::Clock::Milliseconds32 timeout)
+    {
+        mIdleTimeout = timeout;
+
+        return *this;
+    }
+
 private:
-    Inet::EndPointManager<Inet::TCPEndPoint> * mEndPointManager;   ///< Associated endpoint factory
-    Inet::IPAddressType mAddressType = Inet::IPAddressType::kIPv6; ///< type of listening socket
-    uint16_t mListenPort             = CHIP_PORT;                  ///< TCP listen port
-    Inet::InterfaceId mInterfaceId   = Inet::InterfaceId::Null();  ///< Interface to listen on
+    Inet::EndPointManager<Inet::TCPEndPoint> * mEndPointManager;             ///< Associated endpoint factory
+    Inet::IPAddressType mAddressType           = Inet::IPAddressType::kIPv6; ///< type of listening socket
+    uint16_t mListenPort                       = CHIP_PORT;                  ///< TCP listen port
+    Inet::InterfaceId mInterfaceId             = Inet::InterfaceId::Null();  ///< Interface to listen on
+    System::Clock::Milliseconds32 mIdleTimeout = System::Clock::kZero;       ///< Idle time after which connections are closed
 };
 
 /**
@@ -111,10 +121,12 @@ protected:
      */
     struct ActiveConnectionState
     {
-        void Init(Inet::TCPEndPoint * endPoint)
+        void Init(Inet::TCPEndPoint * endPoint, const PeerAddress & peerAddress)
         {
-            mEndPoint = endPoint;
-            mReceived = nullptr;
+            mEndPoint     = endPoint;
+            mPeerAddress  = peerAddress;
+            mReceived     = nullptr;
+            mLastActivity = System::SystemClock().GetMonotonicTimestamp();
         }
 
         void Free()
@@ -125,11 +137,22 @@ protected:
         }
         bool InUse() const { return mEndPoint != nullptr; }
 
+        // Whether the connection can be closed without losing data: nothing is waiting to be sent or to be processed.
+        bool IsIdle() const { return InUse() && mReceived.IsNull() && mEndPoint->PendingSendLength() == 0; }
+
+        void MarkActive() { mLastActivity = System::SystemClock().GetMonotonicTimestamp(); }
+
         // Associated endpoint.
         Inet::TCPEndPoint * mEndPoint;
 
+        // Address of the peer, kept so that looking up a connection does not need to query the socket.
+        PeerAddress mPeerAddress;
+
         // Buffers received but not yet consumed.
         System::PacketBufferHandle mReceived;
+
+        // Time of the last message sent or received on the connection.
+        System::Clock::Timestamp mLastActivity;
     };
 
 public:
@@ -190,6 +213,19 @@ private:
     ActiveConnectionState * FindActiveConnection(const PeerAddress & addr);
     ActiveConnectionState * FindActiveConnection(const Inet::TCPEndPoint * endPoint);
 
+    /**
+     * Make room for a new connection when all the connections are in use, by closing the idle connection that was used least
+     * recently.
+     *
+     * @retval CHIP_ERROR_NO_MEMORY if all the connections are in use and none of them is idle.
+     */
+    CHIP_ERROR ReserveConnection();
+
+    /**
+     * Store a newly established connection in a free connection slot.
+     */
+    ActiveConnectionState * StoreConnection(Inet::TCPEndPoint * endPoint, const PeerAddress & peerAddress);
+
     /**
      * Sends the specified message once a connection has been established.
      *
@@ -254,6 +290,9 @@ private:
     Inet::IPAddressType mEndpointType = Inet::IPAddressType::kUnknown; ///< Socket listening type
     State mState                      = State::kNotReady;              ///< State of the TCP transport
 
+    // Idle time after which connections are closed, or zero to keep them open.
+    System::Clock::Milliseconds32 mIdleTimeout = System::Clock::kZero;
+
     // Number of active and 'pending connection' endpoints
     size_t mUsedEndPointCount = 0;
 
@@ -273,7 +312,7 @@ public:
     {
         for (size_t i = 0; i < kActiveConnectionsSize; ++i)
         {
-            mConnectionsBuffer[i].Init(nullptr);
+            mConnectionsBuffer[i].Init(nullptr, PeerAddress::Uninitialized());
         }
     }
     ~TCP() { mPendingPackets.ReleaseAll(); }
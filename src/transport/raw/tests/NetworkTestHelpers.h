@@ -97,6 +97,7 @@ public:
     {
         ReturnErrorOnFailure(mMessageSendError);
         mSentMessageCount++;
+        mSentMessageBytes += msgBuf->TotalLength();
 
         if (mNumMessagesToDrop == 0)
         {
@@ -129,6 +130,7 @@ public:
         mNumMessagesToDrop   = 0;
         mDroppedMessageCount = 0;
         mSentMessageCount    = 0;
+        mSentMessageBytes    = 0;
         mMessageSendError    = CHIP_NO_ERROR;
     }
 
@@ -152,6 +154,7 @@ public:
     uint32_t mNumMessagesToDrop   = 0;
     uint32_t mDroppedMessageCount = 0;
     uint32_t mSentMessageCount    = 0;
+    size_t mSentMessageBytes      = 0;
     CHIP_ERROR mMessageSendError  = CHIP_NO_ERROR;
 };
 
@@ -35,10 +35,13 @@
 #include <nlbyteorder.h>
 #include <nlunit-test.h>
 
+#include <algorithm>
 #include <errno.h>
+#include <inttypes.h>
 #include <stdlib.h>
 #include <string.h>
 #include <utility>
+#include <vector>
 
 using namespace chip;
 using namespace chip::Inet;
@@ -52,6 +55,7 @@ class TCPTest
 {
 public:
     static void CheckProcessReceivedBuffer(nlTestSuite * inSuite, void * inContext);
+    static void CheckEmptySendBuffers(nlTestSuite * inSuite, void * inContext);
 };
 } // namespace Transport
 } // namespace chip
@@ -104,9 +108,13 @@ public:
         mReceiveHandlerCallCount++;
     }
 
-    void InitializeMessageTest(TCPImpl & tcp, const IPAddress & addr)
+    void InitializeMessageTest(Transport::TCPBase & tcp, const IPAddress & addr, uint16_t port = CHIP_PORT,
+                               System::Clock::Milliseconds32 idleTimeout = System::Clock::kZero)
     {
-        CHIP_ERROR err = tcp.Init(Transport::TcpListenParameters(mContext.GetTCPEndPointManager()).SetAddressType(addr.Type()));
+        CHIP_ERROR err = tcp.Init(Transport::TcpListenParameters(mContext.GetTCPEndPointManager())
+                                      .SetAddressType(addr.Type())
+                                      .SetListenPort(port)
+                                      .SetIdleTimeout(idleTimeout));
         NL_TEST_ASSERT(mSuite, err == CHIP_NO_ERROR);
 
         mTransportMgrBase.SetSessionManager(this);
@@ -115,7 +123,7 @@ public:
         mReceiveHandlerCallCount = 0;
     }
 
-    void SingleMessageTest(TCPImpl & tcp, const IPAddress & addr)
+    void SingleMessageTest(Transport::TCPBase & tcp, const IPAddress & addr, uint16_t port = CHIP_PORT)
     {
         chip::System::PacketBufferHandle buffer = chip::System::PacketBufferHandle::NewWithData(PAYLOAD, sizeof(PAYLOAD));
         NL_TEST_ASSERT(mSuite, !buffer.IsNull());
@@ -130,7 +138,7 @@ public:
         NL_TEST_ASSERT(mSuite, err == CHIP_NO_ERROR);
 
         // Should be able to send a message to itself by just calling send.
-        err = tcp.SendMessage(Transport::PeerAddress::TCP(addr), std::move(buffer));
+        err = tcp.SendMessage(Transport::PeerAddress::TCP(addr, port), std::move(buffer));
         NL_TEST_ASSERT(mSuite, err == CHIP_NO_ERROR);
 
         mContext.DriveIOUntil(chip::System::Clock::Seconds16(5), [this]() { return mReceiveHandlerCallCount != 0; });
@@ -139,10 +147,10 @@ public:
         SetCallback(nullptr);
     }
 
-    void FinalizeMessageTest(TCPImpl & tcp, const IPAddress & addr)
+    void FinalizeMessageTest(Transport::TCPBase & tcp, const IPAddress & addr, uint16_t port = CHIP_PORT)
     {
         // Disconnect and wait for seeing peer close
-        tcp.Disconnect(Transport::PeerAddress::TCP(addr));
+        tcp.Disconnect(Transport::PeerAddress::TCP(addr, port));
         mContext.DriveIOUntil(chip::System::Clock::Seconds16(5), [&tcp]() { return !tcp.HasActiveConnections(); });
     }
 
@@ -210,6 +218,147 @@ void CheckMessageTest6(nlTestSuite * inSuite, void * inContext)
     CheckMessageTest(inSuite, inContext, addr);
 }
 
+/////////////////////////// Connection pool tests
+
+void CheckConnectionEvictionTest(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+
+    IPAddress addr;
+    IPAddress::FromString("::1", addr);
+    constexpr uint16_t kFirstPort  = CHIP_PORT + 1;
+    constexpr uint16_t kSecondPort = CHIP_PORT + 2;
+
+    // Only room for a single connection.
+    Transport::TCP<1, kMaxTcpPendingPackets> tcp;
+    MockTransportMgrDelegate gMockTransportMgrDelegate(inSuite, ctx);
+    gMockTransportMgrDelegate.InitializeMessageTest(tcp, addr);
+
+    TCPImpl firstTcp;
+    MockTransportMgrDelegate firstMockTransportMgrDelegate(inSuite, ctx);
+    firstMockTransportMgrDelegate.InitializeMessageTest(firstTcp, addr, kFirstPort);
+
+    TCPImpl secondTcp;
+    MockTransportMgrDelegate secondMockTransportMgrDelegate(inSuite, ctx);
+    secondMockTransportMgrDelegate.InitializeMessageTest(secondTcp, addr, kSecondPort);
+
+    firstMockTransportMgrDelegate.SingleMessageTest(tcp, addr, kFirstPort);
+
+    // The connection to the first transport is idle, so it is closed to connect to the second one.
+    secondMockTransportMgrDelegate.SingleMessageTest(tcp, addr, kSecondPort);
+    ctx.DriveIOUntil(chip::System::Clock::Seconds16(5), [&firstTcp]() { return !firstTcp.HasActiveConnections(); });
+    NL_TEST_ASSERT(inSuite, !firstTcp.HasActiveConnections());
+
+    gMockTransportMgrDelegate.FinalizeMessageTest(tcp, addr, kSecondPort);
+    firstMockTransportMgrDelegate.FinalizeMessageTest(firstTcp, addr);
+    secondMockTransportMgrDelegate.FinalizeMessageTest(secondTcp, addr);
+    NL_TEST_ASSERT(inSuite, !tcp.HasActiveConnections());
+    NL_TEST_ASSERT(inSuite, !firstTcp.HasActiveConnections());
+    NL_TEST_ASSERT(inSuite, !secondTcp.HasActiveConnections());
+}
+
+#if INET_TCP_IDLE_CHECK_INTERVAL > 0
+void CheckIdleConnectionTest(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+
+    IPAddress addr;
+    IPAddress::FromString("::1", addr);
+    constexpr uint16_t kServerPort = CHIP_PORT + 1;
+
+    TCPImpl tcp;
+    MockTransportMgrDelegate gMockTransportMgrDelegate(inSuite, ctx);
+    gMockTransportMgrDelegate.InitializeMessageTest(tcp, addr, CHIP_PORT, System::Clock::Milliseconds32(100));
+
+    TCPImpl serverTcp;
+    MockTransportMgrDelegate serverMockTransportMgrDelegate(inSuite, ctx);
+    serverMockTransportMgrDelegate.InitializeMessageTest(serverTcp, addr, kServerPort);
+
+    serverMockTransportMgrDelegate.SingleMessageTest(tcp, addr, kServerPort);
+    NL_TEST_ASSERT(inSuite, tcp.HasActiveConnections());
+
+    // The connection is closed once it has been idle for long enough, and the server sees the peer close it.
+    ctx.DriveIOUntil(chip::System::Clock::Seconds16(5),
+                     [&tcp, &serverTcp]() { return !tcp.HasActiveConnections() && !serverTcp.HasActiveConnections(); });
+    NL_TEST_ASSERT(inSuite, !tcp.HasActiveConnections());
+    NL_TEST_ASSERT(inSuite, !serverTcp.HasActiveConnections());
+}
+#endif // INET_TCP_IDLE_CHECK_INTERVAL > 0
+
+/////////////////////////// Loopback benchmark
+
+constexpr size_t kBenchmarkMessageCount     = 2000;
+constexpr size_t kBenchmarkMessagesInFlight = 32;
+constexpr size_t kBenchmarkLatencySamples   = 500;
+constexpr size_t kBenchmarkPayloadSize      = 1024;
+
+System::PacketBufferHandle NewBenchmarkMessage()
+{
+    static const uint8_t sPayload[kBenchmarkPayloadSize] = { 0 };
+
+    PacketHeader header;
+    header.SetSourceNodeId(kSourceNodeId).SetDestinationNodeId(kDestinationNodeId).SetMessageCounter(kMessageCounter);
+
+    System::PacketBufferHandle buffer = System::PacketBufferHandle::NewWithData(sPayload, sizeof(sPayload));
+    VerifyOrDie(!buffer.IsNull() && header.EncodeBeforeData(buffer) == CHIP_NO_ERROR);
+    return buffer;
+}
+
+// Measures how many messages per second a transport sends to itself over loopback, keeping a few messages in flight, and the
+// 99th percentile of the time a single message takes to be delivered.
+void CheckLoopbackBenchmark(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+    TCPImpl tcp;
+
+    IPAddress addr;
+    IPAddress::FromString("::1", addr);
+    const Transport::PeerAddress peerAddress = Transport::PeerAddress::TCP(addr);
+
+    MockTransportMgrDelegate gMockTransportMgrDelegate(inSuite, ctx);
+    gMockTransportMgrDelegate.InitializeMessageTest(tcp, addr);
+    gMockTransportMgrDelegate.SingleMessageTest(tcp, addr);
+
+    size_t sent   = 0;
+    auto received = [&]() { return static_cast<size_t>(gMockTransportMgrDelegate.mReceiveHandlerCallCount); };
+
+    // Send messages until kBenchmarkMessagesInFlight of them are waiting to be received.
+    auto fillWindow = [&]() {
+        for (; sent < kBenchmarkMessageCount && sent < received() + kBenchmarkMessagesInFlight; sent++)
+        {
+            NL_TEST_ASSERT(inSuite, tcp.SendMessage(peerAddress, NewBenchmarkMessage()) == CHIP_NO_ERROR);
+        }
+    };
+    gMockTransportMgrDelegate.mReceiveHandlerCallCount = 0;
+
+    System::Clock::Microseconds64 start = System::SystemClock().GetMonotonicMicroseconds64();
+    fillWindow();
+    ctx.DriveIOUntil(chip::System::Clock::Seconds16(30), [&]() {
+        fillWindow();
+        return received() == kBenchmarkMessageCount;
+    });
+    System::Clock::Microseconds64 elapsed = System::SystemClock().GetMonotonicMicroseconds64() - start;
+    NL_TEST_ASSERT(inSuite, received() == kBenchmarkMessageCount);
+
+    std::vector<uint64_t> latencies;
+    for (size_t i = 0; i < kBenchmarkLatencySamples; i++)
+    {
+        gMockTransportMgrDelegate.mReceiveHandlerCallCount = 0;
+        start                                              = System::SystemClock().GetMonotonicMicroseconds64();
+        NL_TEST_ASSERT(inSuite, tcp.SendMessage(peerAddress, NewBenchmarkMessage()) == CHIP_NO_ERROR);
+        ctx.DriveIOUntil(chip::System::Clock::Seconds16(5), [&]() { return received() != 0; });
+        latencies.push_back((System::SystemClock().GetMonotonicMicroseconds64() - start).count());
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    printf("TCP loopback: %u messages of %u bytes in %" PRIu64 " us (%" PRIu64 " messages/s), p99 latency %" PRIu64 " us\n",
+           static_cast<unsigned>(kBenchmarkMessageCount), static_cast<unsigned>(kBenchmarkPayloadSize), elapsed.count(),
+           kBenchmarkMessageCount * 1000000 / std::max<uint64_t>(elapsed.count(), 1),
+           latencies[latencies.size() * 99 / 100]);
+
+    gMockTransportMgrDelegate.FinalizeMessageTest(tcp, addr);
+}
+
 // Generates a packet buffer or a chain of packet buffers for a single message.
 struct TestData
 {
@@ -418,6 +567,32 @@ void chip::Transport::TCPTest::CheckProcessReceivedBuffer(nlTestSuite * inSuite,
     NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
     NL_TEST_ASSERT(inSuite, gMockTransportMgrDelegate.mReceiveHandlerCallCount == 2);
 
+    // Test two messages in a single packet buffer, the second one shorter than the first.
+    gMockTransportMgrDelegate.mReceiveHandlerCallCount = 0;
+    NL_TEST_ASSERT(inSuite, testData[0].Init((const uint16_t[]){ 151, 0 }));
+    NL_TEST_ASSERT(inSuite, testData[1].Init((const uint16_t[]){ 52, 0 }));
+    System::PacketBufferHandle buffer = System::PacketBufferHandle::NewWithData(
+        testData[0].mPayload, testData[0].mTotalLength, static_cast<uint16_t>(testData[1].mTotalLength), 0 /* reserve */);
+    NL_TEST_ASSERT(inSuite, !buffer.IsNull());
+    memcpy(buffer->Start() + buffer->DataLength(), testData[1].mPayload, testData[1].mTotalLength);
+    buffer->SetDataLength(static_cast<uint16_t>(testData[0].mTotalLength + testData[1].mTotalLength));
+    err = tcp.ProcessReceivedBuffer(lEndPoint, lPeerAddress, std::move(buffer));
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, gMockTransportMgrDelegate.mReceiveHandlerCallCount == 2);
+
+    // Test a message split across two packet buffers, where the first one has room for the rest of the message.
+    gMockTransportMgrDelegate.mReceiveHandlerCallCount = 0;
+    NL_TEST_ASSERT(inSuite, testData[0].Init((const uint16_t[]){ 161, 0 }));
+    const size_t splitOffset = 60;
+    const auto restLength    = static_cast<uint16_t>(testData[0].mTotalLength - splitOffset);
+
+    buffer = System::PacketBufferHandle::NewWithData(testData[0].mPayload, splitOffset, restLength, 0 /* reserve */);
+    NL_TEST_ASSERT(inSuite, !buffer.IsNull());
+    buffer->AddToEnd(System::PacketBufferHandle::NewWithData(testData[0].mPayload + splitOffset, restLength, 0, 0 /* reserve */));
+    err = tcp.ProcessReceivedBuffer(lEndPoint, lPeerAddress, std::move(buffer));
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, gMockTransportMgrDelegate.mReceiveHandlerCallCount == 1);
+
     // Test a message that is too large to coalesce into a single packet buffer.
     gMockTransportMgrDelegate.mReceiveHandlerCallCount = 0;
     gMockTransportMgrDelegate.SetCallback(TestDataCallbackCheck, &testData[1]);
@@ -431,6 +606,38 @@ void chip::Transport::TCPTest::CheckProcessReceivedBuffer(nlTestSuite * inSuite,
     gMockTransportMgrDelegate.FinalizeMessageTest(tcp, addr);
 }
 
+void chip::Transport::TCPTest::CheckEmptySendBuffers(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+    TCPImpl tcp;
+
+    IPAddress addr;
+    IPAddress::FromString("::1", addr);
+
+    MockTransportMgrDelegate gMockTransportMgrDelegate(inSuite, ctx);
+    gMockTransportMgrDelegate.InitializeMessageTest(tcp, addr);
+    gMockTransportMgrDelegate.SingleMessageTest(tcp, addr);
+
+    TCPBase::ActiveConnectionState * state = tcp.FindActiveConnection(Transport::PeerAddress::TCP(addr));
+    NL_TEST_ASSERT(inSuite, state != nullptr);
+    Inet::TCPEndPoint * lEndPoint = state->mEndPoint;
+    NL_TEST_ASSERT(inSuite, lEndPoint != nullptr);
+
+    // A send queue of nothing but empty buffers is released, rather than sent again and again.
+    System::PacketBufferHandle empty = System::PacketBufferHandle::New(0);
+    NL_TEST_ASSERT(inSuite, !empty.IsNull());
+    empty->AddToEnd(System::PacketBufferHandle::New(0));
+    NL_TEST_ASSERT(inSuite, lEndPoint->Send(std::move(empty)) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, lEndPoint->PendingSendLength() == 0);
+
+    // An empty buffer queued ahead of a message does not hold it back.
+    NL_TEST_ASSERT(inSuite, lEndPoint->Send(System::PacketBufferHandle::New(0), false) == CHIP_NO_ERROR);
+    gMockTransportMgrDelegate.mReceiveHandlerCallCount = 0;
+    gMockTransportMgrDelegate.SingleMessageTest(tcp, addr);
+
+    gMockTransportMgrDelegate.FinalizeMessageTest(tcp, addr);
+}
+
 // Test Suite
 /**
  *  Test Suite that lists all the test functions.
@@ -446,6 +653,12 @@ static const nlTest sTests[] =
     NL_TEST_DEF("Simple Init Test IPV6",        CheckSimpleInitTest6),
     NL_TEST_DEF("Message Self Test IPV6",       CheckMessageTest6),
     NL_TEST_DEF("ProcessReceivedBuffer Test",   chip::Transport::TCPTest::CheckProcessReceivedBuffer),
+    NL_TEST_DEF("Empty Send Buffers Test",      chip::Transport::TCPTest::CheckEmptySendBuffers),
+    NL_TEST_DEF("Connection Eviction Test",     CheckConnectionEvictionTest),
+#if INET_TCP_IDLE_CHECK_INTERVAL > 0
+    NL_TEST_DEF("Idle Connection Test",         CheckIdleConnectionTest),
+#endif
+    NL_TEST_DEF("Loopback Benchmark",           CheckLoopbackBenchmark),
 
     NL_TEST_SENTINEL()
 };
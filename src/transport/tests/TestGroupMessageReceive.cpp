@@ -0,0 +1,382 @@
+/*
+ *
+ *    Copyright (c) 2022 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements unit tests for the group message receive path:
+ *      the operational group key cache and the group message counters.
+ */
+
+#include <credentials/GroupDataProviderImpl.h>
+#include <crypto/CHIPCryptoPAL.h>
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/TestPersistentStorageDelegate.h>
+#include <lib/support/UnitTestRegistration.h>
+#include <system/SystemClock.h>
+#include <transport/CryptoContext.h>
+#include <transport/GroupKeyCache.h>
+#include <transport/GroupPeerMessageCounter.h>
+
+#include <nlunit-test.h>
+
+#include <stdio.h>
+
+using namespace chip;
+using namespace chip::Credentials;
+using namespace chip::Transport;
+
+namespace {
+
+using KeySet   = GroupDataProvider::KeySet;
+using GroupKey = GroupDataProvider::GroupKey;
+
+constexpr FabricIndex kFabric1                = 1;
+constexpr FabricIndex kFabric2                = 2;
+constexpr CompressedFabricId kCompressedId1   = 0x87e1b004e235a130;
+constexpr CompressedFabricId kCompressedId2   = 0x1122334455667788;
+constexpr GroupId kGroup1                     = 0x0101;
+constexpr GroupId kGroup2                     = 0x0102;
+constexpr NodeId kSourceNodeId                = 0x0000000011223344;
+constexpr KeysetId kKeySet1                   = 0x0111;
+constexpr uint8_t kPayload[]                  = { 0x05, 0x64, 0xee, 0x0e, 0x20, 0x7d, 0x10, 0x00, 0x00, 0x01, 0x02, 0x03 };
+constexpr uint16_t kMaxGroupKeysPerFabricTest = 1;
+
+void FillKeySet(KeySet & keyset, KeysetId id, uint8_t seed)
+{
+    keyset = KeySet(id, KeySet::SecurityPolicy::kStandard, 3);
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        keyset.epoch_keys[i].start_time = 1000u * i;
+        memset(keyset.epoch_keys[i].key, seed + i, sizeof(keyset.epoch_keys[i].key));
+    }
+}
+
+// Build the group message a sender holding `epochKey` would emit, leaving `msg`
+// positioned right after the packet header, as SessionManager sees it.
+CHIP_ERROR EncryptGroupMessage(const uint8_t * epochKey, CompressedFabricId compressedFabricId, GroupId group, uint32_t counter,
+                               PacketHeader & header, System::PacketBufferHandle & msg)
+{
+    uint8_t key[GroupKeyCache::kKeyLength];
+    MutableByteSpan keySpan(key);
+    uint16_t sessionId = 0;
+    ReturnErrorOnFailure(
+        GroupKeyCache::DeriveOperationalKey(ByteSpan(epochKey, GroupKeyCache::kKeyLength), compressedFabricId, keySpan));
+    ReturnErrorOnFailure(GroupKeyCache::DeriveGroupSessionId(keySpan, sessionId));
+
+    header = PacketHeader();
+    header.SetSessionType(Header::SessionType::kGroupSession)
+        .SetSessionId(sessionId)
+        .SetSourceNodeId(kSourceNodeId)
+        .SetDestinationGroupId(group)
+        .SetMessageCounter(counter);
+
+    msg = System::PacketBufferHandle::NewWithData(kPayload, sizeof(kPayload), kMaxTagLen);
+    VerifyOrReturnError(!msg.IsNull(), CHIP_ERROR_NO_MEMORY);
+
+    uint8_t iv[CryptoContext::kAESCCMIVLen];
+    uint8_t aad[CryptoContext::kMaxAADLen];
+    uint16_t aadLen = sizeof(aad);
+    uint8_t tag[kMaxTagLen];
+    ReturnErrorOnFailure(CryptoContext::GetIV(header, iv, sizeof(iv)));
+    ReturnErrorOnFailure(CryptoContext::GetAdditionalAuthData(header, aad, aadLen));
+    ReturnErrorOnFailure(Crypto::AES_CCM_encrypt(msg->Start(), msg->DataLength(), aad, aadLen, key, sizeof(key), iv, sizeof(iv),
+                                                 msg->Start(), tag, header.MICTagLength()));
+
+    MessageAuthenticationCode mac;
+    uint16_t tagLen = 0;
+    mac.SetTag(&header, tag, header.MICTagLength());
+    ReturnErrorOnFailure(mac.Encode(header, msg->Start() + msg->DataLength(), msg->AvailableDataLength(), &tagLen));
+    msg->SetDataLength(static_cast<uint16_t>(msg->DataLength() + tagLen));
+    return CHIP_NO_ERROR;
+}
+
+struct TestContext
+{
+    TestPersistentStorageDelegate storage;
+    GroupDataProviderImpl provider{ storage, 2, kMaxGroupKeysPerFabricTest };
+    GroupKeyCache cache;
+};
+
+void TestDecrypt(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext ctx;
+    NL_TEST_ASSERT(inSuite, ctx.provider.Init() == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, ctx.cache.Init(&ctx.provider) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, ctx.cache.SetFabric(kFabric1, kCompressedId1) == CHIP_NO_ERROR);
+
+    KeySet keyset;
+    FillKeySet(keyset, kKeySet1, 0x10);
+    NL_TEST_ASSERT(inSuite, ctx.provider.SetKeySet(kFabric1, keyset) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, ctx.provider.SetGroupKeyAt(kFabric1, 0, GroupKey(kGroup1, kKeySet1)) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, ctx.cache.GetEntryCount() == 3);
+
+    // Every epoch key of the key set is usable.
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        PacketHeader header;
+        System::PacketBufferHandle msg;
+        FabricIndex fabric = kUndefinedFabricIndex;
+        CHIP_ERROR err     = EncryptGroupMessage(keyset.epoch_keys[i].key, kCompressedId1, kGroup1, 10u + i, header, msg);
+        NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, ctx.cache.DecryptMessage(header, msg, fabric) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, fabric == kFabric1);
+        NL_TEST_ASSERT(inSuite, msg->DataLength() == sizeof(kPayload));
+        NL_TEST_ASSERT(inSuite, memcmp(msg->Start(), kPayload, sizeof(kPayload)) == 0);
+    }
+
+    // Wrong group: no candidate.
+    {
+        PacketHeader header;
+        System::PacketBufferHandle msg;
+        FabricIndex fabric = kUndefinedFabricIndex;
+        NL_TEST_ASSERT(inSuite,
+                       EncryptGroupMessage(keyset.epoch_keys[0].key, kCompressedId1, kGroup2, 20, header, msg) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, ctx.cache.DecryptMessage(header, msg, fabric) == CHIP_ERROR_KEY_NOT_FOUND);
+    }
+
+    // Tampered ciphertext fails authentication.
+    {
+        PacketHeader header;
+        System::PacketBufferHandle msg;
+        FabricIndex fabric = kUndefinedFabricIndex;
+        NL_TEST_ASSERT(inSuite,
+                       EncryptGroupMessage(keyset.epoch_keys[0].key, kCompressedId1, kGroup1, 21, header, msg) == CHIP_NO_ERROR);
+        msg->Start()[0] ^= 0x01;
+        NL_TEST_ASSERT(inSuite, ctx.cache.DecryptMessage(header, msg, fabric) == CHIP_ERROR_INTEGRITY_CHECK_FAILED);
+    }
+
+    ctx.cache.Shutdown();
+    ctx.provider.Finish();
+}
+
+void TestInvalidation(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext ctx;
+    NL_TEST_ASSERT(inSuite, ctx.provider.Init() == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, ctx.cache.Init(&ctx.provider) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, ctx.cache.SetFabric(kFabric1, kCompressedId1) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, ctx.cache.SetFabric(kFabric2, kCompressedId2) == CHIP_NO_ERROR);
+
+    KeySet keyset;
+    FillKeySet(keyset, kKeySet1, 0x20);
+    NL_TEST_ASSERT(inSuite, ctx.provider.SetKeySet(kFabric1, keyset) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, ctx.provider.SetGroupKeyAt(kFabric1, 0, GroupKey(kGroup1, kKeySet1)) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, ctx.provider.SetKeySet(kFabric2, keyset) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, ctx.provider.SetGroupKeyAt(kFabric2, 0, GroupKey(kGroup1, kKeySet1)) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, ctx.cache.GetEntryCount() == 6);
+
+    // The same epoch key yields a different operational key on each fabric.
+    PacketHeader header;
+    System::PacketBufferHandle msg;
+    FabricIndex fabric = kUndefinedFabricIndex;
+    NL_TEST_ASSERT(inSuite,
+                   EncryptGroupMessage(keyset.epoch_keys[1].key, kCompressedId2, kGroup1, 1, header, msg) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, ctx.cache.DecryptMessage(header, msg, fabric) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, fabric == kFabric2);
+
+    // Rotating the key set through the provider drops the old keys.
+    KeySet rotated;
+    FillKeySet(rotated, kKeySet1, 0x40);
+    NL_TEST_ASSERT(inSuite, ctx.provider.SetKeySet(kFabric2, rotated) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite,
+                   EncryptGroupMessage(keyset.epoch_keys[1].key, kCompressedId2, kGroup1, 2, header, msg) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, ctx.cache.DecryptMessage(header, msg, fabric) != CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite,
+                   EncryptGroupMessage(rotated.epoch_keys[1].key, kCompressedId2, kGroup1, 3, header, msg) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, ctx.cache.DecryptMessage(header, msg, fabric) == CHIP_NO_ERROR);
+
+    // Removing the mapping removes the fabric's keys.
+    NL_TEST_ASSERT(inSuite, ctx.provider.RemoveGroupKeys(kFabric2) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, ctx.cache.GetEntryCount() == 3);
+
+    ctx.cache.RemoveFabric(kFabric1);
+    NL_TEST_ASSERT(inSuite, ctx.cache.GetEntryCount() == 0);
+
+    ctx.cache.Shutdown();
+    ctx.provider.Finish();
+}
+
+class CountingListener : public GroupDataProvider::GroupListener
+{
+public:
+    void OnGroupAdded(FabricIndex fabric_index, const GroupDataProvider::GroupInfo & new_group) override {}
+    void OnGroupRemoved(FabricIndex fabric_index, const GroupDataProvider::GroupInfo & old_group) override {}
+    void OnGroupKeysChanged(FabricIndex fabric_index) override { mKeysChanged++; }
+
+    uint32_t mKeysChanged = 0;
+};
+
+void TestListenerChaining(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext ctx;
+    CountingListener listener;
+    NL_TEST_ASSERT(inSuite, ctx.provider.Init() == CHIP_NO_ERROR);
+    ctx.provider.SetListener(&listener);
+    NL_TEST_ASSERT(inSuite, ctx.cache.Init(&ctx.provider) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, ctx.cache.SetFabric(kFabric1, kCompressedId1) == CHIP_NO_ERROR);
+
+    // The cache sees the change and still forwards it to the listener it replaced.
+    KeySet keyset;
+    FillKeySet(keyset, kKeySet1, 0x10);
+    NL_TEST_ASSERT(inSuite, ctx.provider.SetKeySet(kFabric1, keyset) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, ctx.provider.SetGroupKeyAt(kFabric1, 0, GroupKey(kGroup1, kKeySet1)) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, ctx.cache.GetEntryCount() == 3);
+    NL_TEST_ASSERT(inSuite, listener.mKeysChanged > 0);
+
+    // Shutting the cache down restores the original listener.
+    ctx.cache.Shutdown();
+    NL_TEST_ASSERT(inSuite, ctx.provider.GetListener() == &listener);
+
+    ctx.provider.RemoveListener();
+    ctx.provider.Finish();
+}
+
+void TestGroupMessageCounters(nlTestSuite * inSuite, void * inContext)
+{
+    GroupPeerMessageCounterTable<2> counters;
+
+    // First message from a peer is trusted.
+    NL_TEST_ASSERT(inSuite, counters.Verify(kFabric1, kSourceNodeId, 100) == CHIP_NO_ERROR);
+    counters.Commit(kFabric1, kSourceNodeId, 100);
+    NL_TEST_ASSERT(inSuite, counters.Verify(kFabric1, kSourceNodeId, 100) == CHIP_ERROR_DUPLICATE_MESSAGE_RECEIVED);
+    NL_TEST_ASSERT(inSuite, counters.Verify(kFabric1, kSourceNodeId, 101) == CHIP_NO_ERROR);
+    counters.Commit(kFabric1, kSourceNodeId, 101);
+    NL_TEST_ASSERT(inSuite, counters.Verify(kFabric1, kSourceNodeId, 99) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, counters.Verify(kFabric1, kSourceNodeId, 101 - CHIP_CONFIG_MESSAGE_COUNTER_WINDOW_SIZE) ==
+                       CHIP_ERROR_MESSAGE_COUNTER_OUT_OF_WINDOW);
+
+    // Counters are tracked per fabric.
+    NL_TEST_ASSERT(inSuite, counters.Verify(kFabric2, kSourceNodeId, 100) == CHIP_NO_ERROR);
+    counters.Commit(kFabric2, kSourceNodeId, 100);
+    NL_TEST_ASSERT(inSuite, counters.Verify(kFabric1, kSourceNodeId, 101) == CHIP_ERROR_DUPLICATE_MESSAGE_RECEIVED);
+
+    counters.RemoveFabric(kFabric1);
+    NL_TEST_ASSERT(inSuite, counters.Verify(kFabric1, kSourceNodeId, 101) == CHIP_NO_ERROR);
+}
+
+void TestDecryptThroughput(nlTestSuite * inSuite, void * inContext)
+{
+    constexpr uint32_t kIterations       = 2048;
+    constexpr uint32_t kBatchSize        = 16;
+    constexpr uint16_t kKeySetsPerFabric = CHIP_CONFIG_MAX_GROUP_KEYS_PER_FABRIC;
+    constexpr size_t kKeySets            = CHIP_CONFIG_GROUP_KEY_CACHE_SIZE / 3;
+    constexpr FabricIndex kFabricCount   = static_cast<FabricIndex>((kKeySets + kKeySetsPerFabric - 1) / kKeySetsPerFabric);
+    static_assert(kFabricCount <= CHIP_CONFIG_MAX_DEVICE_ADMINS, "The cache holds more keys than the fabrics can map");
+
+    TestPersistentStorageDelegate storage;
+    GroupDataProviderImpl provider{ storage, kKeySetsPerFabric, kKeySetsPerFabric };
+    GroupKeyCache cache;
+    NL_TEST_ASSERT(inSuite, provider.Init() == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, cache.Init(&provider) == CHIP_NO_ERROR);
+
+    // Fill the cache with key sets that use the maximum number of epoch keys, each mapped to a group of its own.
+    KeySet keyset;
+    size_t installed = 0;
+    for (FabricIndex fabric = 1; fabric <= kFabricCount; fabric++)
+    {
+        NL_TEST_ASSERT(inSuite, cache.SetFabric(fabric, kCompressedId1 + fabric) == CHIP_NO_ERROR);
+        for (uint16_t i = 0; i < kKeySetsPerFabric && installed < kKeySets; i++, installed++)
+        {
+            FillKeySet(keyset, static_cast<KeysetId>(kKeySet1 + i), static_cast<uint8_t>(installed * 3));
+            NL_TEST_ASSERT(inSuite, provider.SetKeySet(fabric, keyset) == CHIP_NO_ERROR);
+            NL_TEST_ASSERT(inSuite,
+                           provider.SetGroupKeyAt(fabric, i, GroupKey(static_cast<GroupId>(kGroup1 + i), keyset.keyset_id)) ==
+                               CHIP_NO_ERROR);
+        }
+    }
+    size_t entries = cache.GetEntryCount();
+    NL_TEST_ASSERT(inSuite, entries == kKeySets * 3u);
+
+    // Encrypt each batch of messages ahead of time, cycling through every cached key, and only time their decryption.
+    uint32_t decrypted = 0;
+    System::Clock::Microseconds64 elapsed(0);
+    for (uint32_t batch = 0; batch < kIterations; batch += kBatchSize)
+    {
+        PacketHeader headers[kBatchSize];
+        System::PacketBufferHandle msgs[kBatchSize];
+        for (uint32_t n = 0; n < kBatchSize; n++)
+        {
+            uint32_t counter        = batch + n;
+            size_t keysetIndex      = (counter / 3) % kKeySets;
+            FabricIndex fabric      = static_cast<FabricIndex>(1 + keysetIndex / kKeySetsPerFabric);
+            uint16_t keysetOfFabric = static_cast<uint16_t>(keysetIndex % kKeySetsPerFabric);
+            FillKeySet(keyset, static_cast<KeysetId>(kKeySet1 + keysetOfFabric), static_cast<uint8_t>(keysetIndex * 3));
+            NL_TEST_ASSERT(inSuite,
+                           EncryptGroupMessage(keyset.epoch_keys[counter % 3].key, kCompressedId1 + fabric,
+                                               static_cast<GroupId>(kGroup1 + keysetOfFabric), counter, headers[n],
+                                               msgs[n]) == CHIP_NO_ERROR);
+        }
+
+        auto start = System::SystemClock().GetMonotonicMicroseconds64();
+        for (uint32_t n = 0; n < kBatchSize; n++)
+        {
+            FabricIndex fabric = kUndefinedFabricIndex;
+            if (cache.DecryptMessage(headers[n], msgs[n], fabric) == CHIP_NO_ERROR)
+            {
+                decrypted++;
+            }
+        }
+        elapsed += System::SystemClock().GetMonotonicMicroseconds64() - start;
+    }
+
+    NL_TEST_ASSERT(inSuite, decrypted == kIterations);
+    printf("GroupKeyCache: %u keys cached, %u messages decrypted in %llu us\n", static_cast<unsigned>(entries),
+           static_cast<unsigned>(kIterations), static_cast<unsigned long long>(elapsed.count()));
+
+    cache.Shutdown();
+    provider.Finish();
+}
+
+int Setup(void * inContext)
+{
+    VerifyOrReturnError(chip::Platform::MemoryInit() == CHIP_NO_ERROR, FAILURE);
+    return SUCCESS;
+}
+
+int Teardown(void * inContext)
+{
+    chip::Platform::MemoryShutdown();
+    return SUCCESS;
+}
+
+// clang-format off
+const nlTest sTests[] =
+{
+    NL_TEST_DEF("Decrypt",               TestDecrypt),
+    NL_TEST_DEF("Invalidation",          TestInvalidation),
+    NL_TEST_DEF("ListenerChaining",      TestListenerChaining),
+    NL_TEST_DEF("GroupMessageCounters",  TestGroupMessageCounters),
+    NL_TEST_DEF("DecryptThroughput",     TestDecryptThroughput),
+
+    NL_TEST_SENTINEL()
+};
+// clang-format on
+
+} // namespace
+
+int TestGroupMessageReceive()
+{
+    nlTestSuite theSuite = { "Test-CHIP-GroupMessageReceive", &sTests[0], Setup, Teardown };
+
+    nlTestRunner(&theSuite, nullptr);
+
+    return (nlTestRunnerStats(&theSuite));
+}
+
+CHIP_REGISTER_TEST_SUITE(TestGroupMessageReceive)
@@ -29,6 +29,8 @@
 
 #include <nlunit-test.h>
 
+#include <stdio.h>
+
 namespace {
 
 using namespace chip;
@@ -228,6 +230,186 @@ void TestExpireConnections(nlTestSuite * inSuite, void * inContext)
     System::Clock::Internal::SetSystemClockForTesting(realClock);
 }
 
+void TestExpiredSessionIdReused(nlTestSuite * inSuite, void * inContext)
+{
+    SessionIDAllocator idAllocator;
+    SecureSessionTable<2> connections;
+    connections.SetSessionIDAllocator(&idAllocator);
+
+    System::Clock::Internal::MockClock clock;
+    System::Clock::ClockBase * realClock = &System::SystemClock();
+    System::Clock::Internal::SetSystemClockForTesting(&clock);
+
+    uint16_t expiringId = 0;
+    uint16_t activeId   = 0;
+    NL_TEST_ASSERT(inSuite, idAllocator.Allocate(expiringId) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, idAllocator.Allocate(activeId) == CHIP_NO_ERROR);
+
+    clock.SetMonotonic(100_ms64);
+    NL_TEST_ASSERT(inSuite,
+                   connections
+                       .CreateNewSecureSession(kPeer1SessionType, expiringId, kPeer1NodeId, kPeer1CATs, 1, 0 /* fabricIndex */,
+                                               gDefaultMRPConfig)
+                       .HasValue());
+    clock.SetMonotonic(200_ms64);
+    NL_TEST_ASSERT(inSuite,
+                   connections
+                       .CreateNewSecureSession(kPeer2SessionType, activeId, kPeer2NodeId, kPeer2CATs, 3, 0 /* fabricIndex */,
+                                               gDefaultMRPConfig)
+                       .HasValue());
+
+    // The session of peer 1 expires and gives its local session ID back.
+    clock.SetMonotonic(300_ms64);
+    int expiredCount = 0;
+    connections.ExpireInactiveSessions(150_ms64, [&expiredCount](const SecureSession & state) { expiredCount++; });
+    NL_TEST_ASSERT(inSuite, expiredCount == 1);
+    NL_TEST_ASSERT(inSuite, !connections.FindSecureSessionByLocalKey(expiringId).HasValue());
+
+    uint16_t reusedId = 0;
+    NL_TEST_ASSERT(inSuite, idAllocator.Allocate(reusedId) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, reusedId == expiringId);
+
+    auto optionalSession = connections.CreateNewSecureSession(kPeer3SessionType, reusedId, kPeer3NodeId, kPeer3CATs, 5,
+                                                              0 /* fabricIndex */, gDefaultMRPConfig);
+    NL_TEST_ASSERT(inSuite, optionalSession.HasValue());
+    optionalSession = connections.FindSecureSessionByLocalKey(reusedId);
+    NL_TEST_ASSERT(inSuite, optionalSession.HasValue());
+    NL_TEST_ASSERT(inSuite, optionalSession.Value()->AsSecureSession()->GetPeerNodeId() == kPeer3NodeId);
+    optionalSession = connections.FindSecureSessionByLocalKey(activeId);
+    NL_TEST_ASSERT(inSuite, optionalSession.HasValue());
+    NL_TEST_ASSERT(inSuite, optionalSession.Value()->AsSecureSession()->GetPeerNodeId() == kPeer2NodeId);
+
+    // Neither ID in use is handed out again.
+    uint16_t nextId = 0;
+    NL_TEST_ASSERT(inSuite, idAllocator.Allocate(nextId) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, nextId != reusedId && nextId != activeId);
+    idAllocator.Free(nextId);
+
+    // Releasing the sessions gives both IDs back.
+    connections.ReleaseSession(connections.FindSecureSessionByLocalKey(reusedId).Value()->AsSecureSession());
+    connections.ReleaseSession(connections.FindSecureSessionByLocalKey(activeId).Value()->AsSecureSession());
+    NL_TEST_ASSERT(inSuite, idAllocator.Allocate(reusedId) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, reusedId == expiringId);
+    NL_TEST_ASSERT(inSuite, idAllocator.Allocate(nextId) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, nextId == activeId);
+
+    System::Clock::Internal::SetSystemClockForTesting(realClock);
+}
+
+void TestFindWithCollidingKeyIds(nlTestSuite * inSuite, void * inContext)
+{
+    // A table of 4 sessions is indexed by 8 slots, so local keys 1, 9 and 17 share a slot, and 7 and 15 wrap around.
+    SecureSessionTable<4> connections;
+    CATValues peerCATs;
+    auto createSession = [&](uint16_t localKey) {
+        return connections
+            .CreateNewSecureSession(kPeer1SessionType, localKey, kPeer1NodeId, peerCATs, 1, 0 /* fabricIndex */, gDefaultMRPConfig)
+            .HasValue();
+    };
+
+    const uint16_t localKeys[] = { 1, 9, 17, 2 };
+    for (uint16_t localKey : localKeys)
+    {
+        NL_TEST_ASSERT(inSuite, createSession(localKey));
+    }
+    for (uint16_t localKey : localKeys)
+    {
+        auto optionalSession = connections.FindSecureSessionByLocalKey(localKey);
+        NL_TEST_ASSERT(inSuite, optionalSession.HasValue());
+        NL_TEST_ASSERT(inSuite, optionalSession.Value()->AsSecureSession()->GetLocalSessionId() == localKey);
+    }
+    NL_TEST_ASSERT(inSuite, !connections.FindSecureSessionByLocalKey(25).HasValue());
+
+    // Releasing a session in the middle of a probe sequence keeps the sessions after it reachable.
+    connections.ReleaseSession(connections.FindSecureSessionByLocalKey(9).Value()->AsSecureSession());
+    NL_TEST_ASSERT(inSuite, !connections.FindSecureSessionByLocalKey(9).HasValue());
+    NL_TEST_ASSERT(inSuite, connections.FindSecureSessionByLocalKey(1).HasValue());
+    NL_TEST_ASSERT(inSuite, connections.FindSecureSessionByLocalKey(17).HasValue());
+    NL_TEST_ASSERT(inSuite, connections.FindSecureSessionByLocalKey(2).HasValue());
+
+    connections.ReleaseSession(connections.FindSecureSessionByLocalKey(1).Value()->AsSecureSession());
+    connections.ReleaseSession(connections.FindSecureSessionByLocalKey(2).Value()->AsSecureSession());
+    NL_TEST_ASSERT(inSuite, connections.FindSecureSessionByLocalKey(17).HasValue());
+
+    const uint16_t wrappingKeys[] = { 7, 15, 23 };
+    for (uint16_t localKey : wrappingKeys)
+    {
+        NL_TEST_ASSERT(inSuite, createSession(localKey));
+    }
+    connections.ReleaseSession(connections.FindSecureSessionByLocalKey(7).Value()->AsSecureSession());
+    NL_TEST_ASSERT(inSuite, connections.FindSecureSessionByLocalKey(15).HasValue());
+    NL_TEST_ASSERT(inSuite, connections.FindSecureSessionByLocalKey(23).HasValue());
+    NL_TEST_ASSERT(inSuite, connections.FindSecureSessionByLocalKey(17).HasValue());
+    NL_TEST_ASSERT(inSuite, !connections.FindSecureSessionByLocalKey(7).HasValue());
+
+    int count = 0;
+    connections.ForEachSession([&](auto session) {
+        count++;
+        return Loop::Continue;
+    });
+    NL_TEST_ASSERT(inSuite, count == 3);
+}
+
+template <size_t kSessionCount>
+void BenchmarkDispatch(nlTestSuite * inSuite)
+{
+    constexpr uint32_t kLookupCount = 200000;
+
+    static SecureSessionTable<kSessionCount> sConnections;
+    CATValues peerCATs;
+
+    // Local keys are allocated sequentially, as SessionIDAllocator does.
+    for (size_t i = 0; i < kSessionCount; i++)
+    {
+        auto optionalSession = sConnections.CreateNewSecureSession(kPeer1SessionType, static_cast<uint16_t>(i + 1), kPeer1NodeId,
+                                                                   peerCATs, 1, 0 /* fabricIndex */, gDefaultMRPConfig);
+        NL_TEST_ASSERT(inSuite, optionalSession.HasValue());
+    }
+
+    // Linear scan, as the table did before: every active session until the local key matches.
+    size_t scanFound = 0;
+    auto start       = System::SystemClock().GetMonotonicMicroseconds64();
+    for (uint32_t n = 0; n < kLookupCount; n++)
+    {
+        const uint16_t localKey = static_cast<uint16_t>((n * 2654435761u) % kSessionCount + 1);
+        sConnections.ForEachSession([&](auto session) {
+            if (session->GetLocalSessionId() == localKey)
+            {
+                scanFound++;
+                return Loop::Break;
+            }
+            return Loop::Continue;
+        });
+    }
+    auto scanElapsed = System::SystemClock().GetMonotonicMicroseconds64() - start;
+
+    size_t indexFound = 0;
+    start             = System::SystemClock().GetMonotonicMicroseconds64();
+    for (uint32_t n = 0; n < kLookupCount; n++)
+    {
+        const uint16_t localKey = static_cast<uint16_t>((n * 2654435761u) % kSessionCount + 1);
+        indexFound += sConnections.FindSecureSessionByLocalKey(localKey).HasValue() ? 1 : 0;
+    }
+    auto indexElapsed = System::SystemClock().GetMonotonicMicroseconds64() - start;
+
+    NL_TEST_ASSERT(inSuite, scanFound == kLookupCount);
+    NL_TEST_ASSERT(inSuite, indexFound == kLookupCount);
+    printf("SecureSessionTable: %u sessions, %u dispatch lookups: scan %llu us, index %llu us\n",
+           static_cast<unsigned>(kSessionCount), static_cast<unsigned>(kLookupCount),
+           static_cast<unsigned long long>(scanElapsed.count()), static_cast<unsigned long long>(indexElapsed.count()));
+
+    sConnections.ForEachSession([&](auto session) {
+        sConnections.ReleaseSession(session);
+        return Loop::Continue;
+    });
+}
+
+void TestDispatchBenchmark(nlTestSuite * inSuite, void * inContext)
+{
+    BenchmarkDispatch<16>(inSuite);
+    BenchmarkDispatch<4096>(inSuite);
+}
+
 } // namespace
 
 // clang-format off
@@ -236,6 +418,9 @@ static const nlTest sTests[] =
     NL_TEST_DEF("BasicFunctionality", TestBasicFunctionality),
     NL_TEST_DEF("FindByKeyId", TestFindByKeyId),
     NL_TEST_DEF("ExpireConnections", TestExpireConnections),
+    NL_TEST_DEF("ExpiredSessionIdReused", TestExpiredSessionIdReused),
+    NL_TEST_DEF("FindWithCollidingKeyIds", TestFindWithCollidingKeyIds),
+    NL_TEST_DEF("DispatchBenchmark", TestDispatchBenchmark),
     NL_TEST_SENTINEL()
 };
 // clang-format on
@@ -29,11 +29,48 @@
 
 #include <lib/support/CodeUtils.h>
 #include <lib/support/UnitTestRegistration.h>
+#include <system/SystemClock.h>
+
 #include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
 
 using namespace chip;
 using namespace Crypto;
 
+namespace {
+
+// Derive a pair of matching channels, as both ends of a session would.
+void InitChannelPair(nlTestSuite * inSuite, CryptoContext & initiator, CryptoContext & responder)
+{
+    const char * salt = "Test Salt";
+
+    P256Keypair keypair;
+    NL_TEST_ASSERT(inSuite, keypair.Initialize() == CHIP_NO_ERROR);
+
+    P256Keypair keypair2;
+    NL_TEST_ASSERT(inSuite, keypair2.Initialize() == CHIP_NO_ERROR);
+
+    NL_TEST_ASSERT(inSuite,
+                   initiator.InitFromKeyPair(keypair, keypair2.Pubkey(), ByteSpan((const uint8_t *) salt, sizeof(salt)),
+                                             CryptoContext::SessionInfoType::kSessionEstablishment,
+                                             CryptoContext::SessionRole::kInitiator) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite,
+                   responder.InitFromKeyPair(keypair2, keypair.Pubkey(), ByteSpan((const uint8_t *) salt, sizeof(salt)),
+                                             CryptoContext::SessionInfoType::kSessionEstablishment,
+                                             CryptoContext::SessionRole::kResponder) == CHIP_NO_ERROR);
+}
+
+// Encode a header for a message, as SecureMessageCodec does ahead of the payload.
+uint16_t EncodeHeader(PacketHeader & packetHeader, uint32_t messageCounter, uint8_t * buffer, uint16_t bufferSize)
+{
+    uint16_t headerSize = 0;
+    packetHeader.SetSessionId(1).SetMessageCounter(messageCounter);
+    return packetHeader.Encode(buffer, bufferSize, &headerSize) == CHIP_NO_ERROR ? headerSize : 0;
+}
+
+} // namespace
+
 void SecureChannelInitTest(nlTestSuite * inSuite, void * inContext)
 {
     CryptoContext channel;
@@ -159,6 +196,125 @@ void SecureChannelDecryptTest(nlTestSuite * inSuite, void * inContext)
     NL_TEST_ASSERT(inSuite, memcmp(plain_text, output, sizeof(plain_text)) == 0);
 }
 
+void SecureChannelInPlaceTest(nlTestSuite * inSuite, void * inContext)
+{
+    CryptoContext channel;
+    CryptoContext channel2;
+    const uint8_t plain_text[] = { 0x86, 0x74, 0x64, 0xe5, 0x0b, 0xd4, 0x0d, 0x90, 0xe1, 0x17, 0xa3, 0x2d, 0x4b, 0xd4, 0xe1, 0xe6 };
+    uint8_t message[128];
+    PacketHeader packetHeader;
+    MessageAuthenticationCode mac;
+
+    InitChannelPair(inSuite, channel, channel2);
+
+    uint16_t headerSize = EncodeHeader(packetHeader, 12345, message, sizeof(message));
+    NL_TEST_ASSERT(inSuite, headerSize > 0);
+    const ByteSpan aad(message, headerSize);
+    uint8_t * payload = &message[headerSize];
+    memcpy(payload, plain_text, sizeof(plain_text));
+
+    NL_TEST_ASSERT(inSuite, channel.Encrypt(payload, sizeof(plain_text), payload, packetHeader, aad, mac) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, memcmp(payload, plain_text, sizeof(plain_text)) != 0);
+
+    // Authenticating the encoded header is the same as encoding it again.
+    uint8_t output[128];
+    NL_TEST_ASSERT(inSuite, channel2.Decrypt(payload, sizeof(plain_text), output, packetHeader, mac) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, memcmp(plain_text, output, sizeof(plain_text)) == 0);
+
+    // Any change to the authenticated header fails decryption. A failed decryption may clear its output,
+    // so this one is not done in place.
+    message[0] ^= 0x01;
+    NL_TEST_ASSERT(inSuite, channel2.Decrypt(payload, sizeof(plain_text), output, packetHeader, aad, mac) != CHIP_NO_ERROR);
+    message[0] ^= 0x01;
+
+    NL_TEST_ASSERT(inSuite, channel2.Decrypt(payload, sizeof(plain_text), payload, packetHeader, aad, mac) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, memcmp(plain_text, payload, sizeof(plain_text)) == 0);
+}
+
+// Encrypt and decrypt a message with the header encoded again as AAD and AES-CCM re-keyed each time,
+// as CryptoContext used to.
+CHIP_ERROR RoundTripReKeyed(const PacketHeader & packetHeader, const uint8_t * key, uint8_t * payload, size_t payloadSize)
+{
+    uint8_t IV[CryptoContext::kAESCCMIVLen];
+    uint8_t AAD[CryptoContext::kMaxAADLen];
+    uint16_t aadLen = sizeof(AAD);
+    uint8_t tag[kMaxTagLen];
+
+    ReturnErrorOnFailure(CryptoContext::GetIV(packetHeader, IV, sizeof(IV)));
+    ReturnErrorOnFailure(CryptoContext::GetAdditionalAuthData(packetHeader, AAD, aadLen));
+    ReturnErrorOnFailure(AES_CCM_encrypt(payload, payloadSize, AAD, aadLen, key, kAES_CCM128_Key_Length, IV, sizeof(IV), payload,
+                                         tag, packetHeader.MICTagLength()));
+
+    aadLen = sizeof(AAD);
+    ReturnErrorOnFailure(CryptoContext::GetIV(packetHeader, IV, sizeof(IV)));
+    ReturnErrorOnFailure(CryptoContext::GetAdditionalAuthData(packetHeader, AAD, aadLen));
+    return AES_CCM_decrypt(payload, payloadSize, AAD, aadLen, tag, packetHeader.MICTagLength(), key, kAES_CCM128_Key_Length, IV,
+                           sizeof(IV), payload);
+}
+
+// Encrypt and decrypt a message in place through the channels, with the encoded header as AAD. The channels only
+// use keyed ciphers when CHIP_CONFIG_SECURE_SESSION_KEYED_CIPHERS is enabled.
+CHIP_ERROR RoundTripInPlace(PacketHeader & packetHeader, const ByteSpan & aad, CryptoContext & sender,
+                            CryptoContext & receiver, uint8_t * payload, size_t payloadSize)
+{
+    MessageAuthenticationCode mac;
+
+    ReturnErrorOnFailure(sender.Encrypt(payload, payloadSize, payload, packetHeader, aad, mac));
+    return receiver.Decrypt(payload, payloadSize, payload, packetHeader, aad, mac);
+}
+
+/**
+ * Compare the time to encrypt and decrypt a message in place with keyed ciphers against re-keying
+ * AES-CCM and encoding the header again for every message.
+ */
+void SecureChannelThroughputBenchmark(nlTestSuite * inSuite, void * inContext)
+{
+    constexpr uint32_t kIterations          = 2000;
+    static constexpr size_t kPayloadSizes[] = { 64, 256, 1024 };
+
+    CryptoContext channel;
+    CryptoContext channel2;
+    InitChannelPair(inSuite, channel, channel2);
+
+    uint8_t key[kAES_CCM128_Key_Length];
+    NL_TEST_ASSERT(inSuite, DRBG_get_bytes(key, sizeof(key)) == CHIP_NO_ERROR);
+
+    uint8_t message[CryptoContext::kMaxAADLen + 1024];
+    for (size_t i = 0; i < sizeof(message); i++)
+    {
+        message[i] = static_cast<uint8_t>(i);
+    }
+
+    for (size_t payloadSize : kPayloadSizes)
+    {
+        PacketHeader packetHeader;
+        CHIP_ERROR err = CHIP_NO_ERROR;
+
+        auto start = System::SystemClock().GetMonotonicMicroseconds64();
+        for (uint32_t n = 0; n < kIterations && err == CHIP_NO_ERROR; n++)
+        {
+            uint16_t headerSize = EncodeHeader(packetHeader, n, message, sizeof(message));
+            err                 = RoundTripReKeyed(packetHeader, key, &message[headerSize], payloadSize);
+        }
+        auto reKeyed = System::SystemClock().GetMonotonicMicroseconds64() - start;
+        NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+        start = System::SystemClock().GetMonotonicMicroseconds64();
+        for (uint32_t n = 0; n < kIterations && err == CHIP_NO_ERROR; n++)
+        {
+            uint16_t headerSize = EncodeHeader(packetHeader, n, message, sizeof(message));
+            const ByteSpan aad(message, headerSize);
+            err = RoundTripInPlace(packetHeader, aad, channel, channel2, &message[headerSize], payloadSize);
+        }
+        auto inPlace = System::SystemClock().GetMonotonicMicroseconds64() - start;
+        NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+        printf("SecureChannel: %4u byte payloads: %.2f us per message re-keyed, %.2f us per message in place\n",
+               static_cast<unsigned>(payloadSize), static_cast<double>(reKeyed.count()) / kIterations,
+               static_cast<double>(inPlace.count()) / kIterations);
+    }
+}
+
 // Test Suite
 
 /**
@@ -170,6 +326,8 @@ static const nlTest sTests[] =
     NL_TEST_DEF("Init",    SecureChannelInitTest),
     NL_TEST_DEF("Encrypt", SecureChannelEncryptTest),
     NL_TEST_DEF("Decrypt", SecureChannelDecryptTest),
+    NL_TEST_DEF("InPlace", SecureChannelInPlaceTest),
+    NL_TEST_DEF("ThroughputBenchmark", SecureChannelThroughputBenchmark),
 
     NL_TEST_SENTINEL()
 };